@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <stdalign.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -130,3 +131,129 @@ struct gr_api_event {
 };
 
 int gr_api_client_event_recv(const struct gr_api_client *, struct gr_api_event **);
+
+// Shared memory request ring.
+//
+// High rate clients (e.g. routing daemons) can queue requests in a ring shared
+// with grout instead of sending them one by one over the API socket. Requests
+// are only processed when the client sends a GR_MAIN_RING_KICK message. One
+// completion with the request status is written back for each processed
+// request. Response payloads are discarded and streaming requests are not
+// supported. This is meant for route and nexthop programming.
+//
+// Memory layout (all indexes are free running and wrap around 2^32):
+//
+//     struct gr_api_ring
+//     struct gr_api_ring_req reqs[n_slots]
+//     struct gr_api_ring_cpl cpls[n_slots]
+
+#define GR_API_RING_SLOT_SIZE 256
+#define GR_API_RING_MAX_SLOTS (1 << 16)
+
+struct gr_api_ring_req {
+	uint32_t id;
+	uint32_t type;
+	uint32_t payload_len;
+	uint32_t __reserved;
+	uint8_t payload[GR_API_RING_SLOT_SIZE - 4 * sizeof(uint32_t)];
+};
+
+struct gr_api_ring_cpl {
+	uint32_t for_id; // matches gr_api_ring_req.id
+	uint32_t status; // uses errno values
+};
+
+struct gr_api_ring {
+	uint32_t n_slots;
+	// next request slot to be written, updated by the client
+	alignas(64) uint32_t req_head;
+	// next request slot to be processed, updated by grout
+	alignas(64) uint32_t req_tail;
+	// next completion slot to be written, updated by grout
+	alignas(64) uint32_t cpl_head;
+	// next completion slot to be read, updated by the client
+	alignas(64) uint32_t cpl_tail;
+	alignas(64) struct gr_api_ring_req reqs[];
+};
+
+static inline size_t gr_api_ring_size(uint32_t n_slots) {
+	return sizeof(struct gr_api_ring)
+		+ n_slots * (sizeof(struct gr_api_ring_req) + sizeof(struct gr_api_ring_cpl));
+}
+
+static inline struct gr_api_ring_cpl *gr_api_ring_cpls(struct gr_api_ring *r, uint32_t n_slots) {
+	return (struct gr_api_ring_cpl *)&r->reqs[n_slots];
+}
+
+#define GR_MAIN_RING_OPEN REQUEST_TYPE(GR_MAIN_MODULE, 0x0001)
+struct gr_api_ring_open_req {
+	uint32_t n_slots; // power of 2, up to GR_API_RING_MAX_SLOTS
+};
+struct gr_api_ring_open_resp {
+	char shm_name[64]; // to be opened with shm_open()
+	uint32_t n_slots;
+};
+
+#define GR_MAIN_RING_KICK REQUEST_TYPE(GR_MAIN_MODULE, 0x0002)
+// struct gr_api_ring_kick_req { };
+struct gr_api_ring_kick_resp {
+	uint32_t processed;
+};
+
+// Allocate a request ring shared with grout. There can be only one per client.
+int gr_api_client_ring_open(struct gr_api_client *, uint32_t n_slots);
+
+// Queue a request in the shared ring.
+//
+// Returns the request ID. Returns -ENOBUFS if the ring is full or if the
+// payload does not fit in a ring slot.
+long int gr_api_client_ring_send(
+	struct gr_api_client *,
+	uint32_t req_type,
+	size_t tx_len,
+	const void *tx_data
+);
+
+// Ask grout to process all queued requests. Returns the number of processed
+// requests. Some requests may remain queued if there is no room left for their
+// completions.
+int gr_api_client_ring_kick(struct gr_api_client *);
+
+// Get the next completion. Returns 1 if one was available, 0 otherwise.
+int gr_api_client_ring_complete(struct gr_api_client *, uint32_t *for_id, uint32_t *status);
+
+// API request latency statistics.
+//
+// Durations are recorded in microseconds for each request type in power of
+// two buckets. Bucket 0 counts durations below 1us, bucket N counts durations
+// in [2^(N-1), 2^N) us. The last bucket counts everything above.
+#define GR_API_LATENCY_BUCKETS 24
+
+struct gr_api_latency {
+	uint64_t count;
+	uint64_t total_us;
+	uint64_t max_us;
+	uint32_t buckets[GR_API_LATENCY_BUCKETS];
+};
+
+struct gr_api_stat {
+	uint32_t req_type;
+	char name[32];
+	uint64_t errors; // requests that returned a non-zero status
+	// from the complete request header being received to the handler start
+	struct gr_api_latency queue;
+	// handler execution time
+	struct gr_api_latency handler;
+	// from the handler end until all datapath workers have gone through
+	// a quiescent state, only for successful non-background requests
+	struct gr_api_latency visible;
+};
+
+#define GR_MAIN_API_STATS_GET REQUEST_TYPE(GR_MAIN_MODULE, 0x0003)
+struct gr_api_stats_get_req {
+	bool reset; // reset all statistics after reading them
+};
+struct gr_api_stats_get_resp {
+	uint16_t n_stats;
+	struct gr_api_stat stats[/* n_stats */];
+};
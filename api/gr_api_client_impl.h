@@ -17,8 +17,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/queue.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/un.h>
 #include <unistd.h>
 
@@ -31,6 +34,8 @@ struct response {
 struct gr_api_client {
 	int sock_fd;
 	STAILQ_HEAD(, response) responses;
+	struct gr_api_ring *ring;
+	uint32_t ring_slots;
 };
 
 struct gr_api_client *gr_api_client_connect(const char *sock_path) {
@@ -70,6 +75,8 @@ err:
 int gr_api_client_disconnect(struct gr_api_client *client) {
 	if (client == NULL)
 		return 0;
+	if (client->ring != NULL)
+		munmap(client->ring, gr_api_ring_size(client->ring_slots));
 	int ret = close(client->sock_fd);
 	while (!STAILQ_EMPTY(&client->responses)) {
 		struct response *resp = STAILQ_FIRST(&client->responses);
@@ -124,13 +131,14 @@ static ssize_t recv_all(const struct gr_api_client *c, void *buf, size_t len) {
 	return len;
 }
 
+static uint32_t message_id;
+
 long int gr_api_client_send(
 	struct gr_api_client *client,
 	uint32_t req_type,
 	size_t tx_len,
 	const void *tx_data
 ) {
-	static uint32_t message_id;
 
 	if (client == NULL || (tx_len == 0 && tx_data != NULL) || (tx_len > 0 && tx_data == NULL))
 		return errno_set(EINVAL);
@@ -242,3 +250,117 @@ err:
 	*event = NULL;
 	return -errno;
 }
+
+int gr_api_client_ring_open(struct gr_api_client *client, uint32_t n_slots) {
+	struct gr_api_ring_open_req req = {.n_slots = n_slots};
+	struct gr_api_ring_open_resp *resp = NULL;
+	struct gr_api_ring *ring;
+	struct stat st;
+	int ret, fd;
+
+	if (client == NULL)
+		return errno_set(EINVAL);
+	if (client->ring != NULL)
+		return errno_set(EBUSY);
+
+	ret = gr_api_client_send_recv(client, GR_MAIN_RING_OPEN, sizeof(req), &req, (void **)&resp);
+	if (ret < 0)
+		return ret;
+
+	resp->shm_name[sizeof(resp->shm_name) - 1] = '\0';
+	if ((fd = shm_open(resp->shm_name, O_RDWR | O_CLOEXEC, 0)) < 0)
+		goto err;
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size != gr_api_ring_size(resp->n_slots)) {
+		close(fd);
+		errno = EBADMSG;
+		goto err;
+	}
+	ring = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (ring == MAP_FAILED)
+		goto err;
+
+	client->ring = ring;
+	client->ring_slots = resp->n_slots;
+	free(resp);
+
+	// let grout know that the shared memory object can be unlinked
+	return gr_api_client_ring_kick(client) < 0 ? -errno : 0;
+err:
+	free(resp);
+	return -errno;
+}
+
+long int gr_api_client_ring_send(
+	struct gr_api_client *client,
+	uint32_t req_type,
+	size_t tx_len,
+	const void *tx_data
+) {
+	struct gr_api_ring_req *req;
+	struct gr_api_ring *ring;
+	uint32_t head, tail;
+
+	if (client == NULL || client->ring == NULL || (tx_len == 0 && tx_data != NULL)
+	    || (tx_len > 0 && tx_data == NULL))
+		return errno_set(EINVAL);
+	if (tx_len > MEMBER_SIZE(struct gr_api_ring_req, payload))
+		return errno_set(ENOBUFS);
+
+	ring = client->ring;
+	head = ring->req_head;
+	tail = __atomic_load_n(&ring->req_tail, __ATOMIC_ACQUIRE);
+	if (head - tail >= client->ring_slots)
+		return errno_set(ENOBUFS);
+
+	req = &ring->reqs[head & (client->ring_slots - 1)];
+	req->id = ++message_id;
+	req->type = req_type;
+	req->payload_len = tx_len;
+	if (tx_len > 0)
+		memcpy(req->payload, tx_data, tx_len);
+
+	__atomic_store_n(&ring->req_head, head + 1, __ATOMIC_RELEASE);
+
+	return req->id;
+}
+
+int gr_api_client_ring_kick(struct gr_api_client *client) {
+	struct gr_api_ring_kick_resp *resp = NULL;
+	int ret;
+
+	if (client == NULL || client->ring == NULL)
+		return errno_set(EINVAL);
+
+	ret = gr_api_client_send_recv(client, GR_MAIN_RING_KICK, 0, NULL, (void **)&resp);
+	if (ret < 0)
+		return ret;
+
+	ret = resp->processed;
+	free(resp);
+
+	return ret;
+}
+
+int gr_api_client_ring_complete(struct gr_api_client *client, uint32_t *for_id, uint32_t *status) {
+	struct gr_api_ring_cpl *cpl;
+	struct gr_api_ring *ring;
+	uint32_t head, tail;
+
+	if (client == NULL || client->ring == NULL)
+		return errno_set(EINVAL);
+
+	ring = client->ring;
+	tail = ring->cpl_tail;
+	head = __atomic_load_n(&ring->cpl_head, __ATOMIC_ACQUIRE);
+	if (head == tail)
+		return 0;
+
+	cpl = &gr_api_ring_cpls(ring, client->ring_slots)[tail & (client->ring_slots - 1)];
+	*for_id = cpl->for_id;
+	*status = cpl->status;
+
+	__atomic_store_n(&ring->cpl_tail, tail + 1, __ATOMIC_RELEASE);
+
+	return 1;
+}
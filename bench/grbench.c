@@ -0,0 +1,831 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+// Control plane API benchmarks. They must be run against a grout instance
+// started in test mode (grout -t) with no configuration. A null port is created
+// to attach nexthops to. All objects created by the benchmarks are removed
+// before exiting.
+//
+// Results are printed on standard output, one JSON object per line, so that
+// they can be easily compared between commits.
+
+#include <gr_api.h>
+#include <gr_api_client_impl.h>
+#include <gr_clock.h>
+#include <gr_infra.h>
+#include <gr_ip4.h>
+#include <gr_ip6.h>
+#include <gr_nexthop.h>
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Base nexthop ID of all nexthops created by the benchmarks.
+#define NH_ID_BASE UINT32_C(0xbe000000)
+#define NH_ID_GW4 (NH_ID_BASE + 0x0001)
+#define NH_ID_GW6 (NH_ID_BASE + 0x0002)
+#define NH_ID_GROUP4 (NH_ID_BASE + 0x0010)
+#define NH_ID_GROUP6 (NH_ID_BASE + 0x0011)
+#define NH_ID_MEMBER4 (NH_ID_BASE + 0x0100)
+#define NH_ID_MEMBER6 (NH_ID_BASE + 0x0200)
+#define NH_ID_CHURN (NH_ID_BASE + 0x10000)
+
+#define ECMP_MAX_MEMBERS 64
+
+static struct {
+	const char *sock_path;
+	unsigned routes;
+	unsigned nexthops;
+	unsigned ecmp;
+	unsigned round_trips;
+	unsigned events;
+	unsigned subscribers;
+	unsigned ring_slots;
+} opts = {
+	.routes = 100000,
+	.nexthops = 10000,
+	.ecmp = 8,
+	.round_trips = 10000,
+	.events = 10000,
+	.subscribers = 4,
+	.ring_slots = 1024,
+};
+
+static struct gr_api_client *client;
+static uint16_t iface_id;
+
+static uint64_t now_ns(void) {
+	struct timespec tp = gr_clock_raw();
+	return tp.tv_sec * UINT64_C(1000000000) + tp.tv_nsec;
+}
+
+struct bench {
+	const char *name;
+	uint64_t ops;
+	uint64_t start;
+	uint64_t elapsed;
+	// per operation latencies, NULL if not measured
+	uint64_t *lat;
+	uint64_t max_ops;
+};
+
+static int bench_start(struct bench *b, const char *name, uint64_t max_ops) {
+	memset(b, 0, sizeof(*b));
+	b->name = name;
+	if (max_ops > 0) {
+		if ((b->lat = calloc(max_ops, sizeof(*b->lat))) == NULL)
+			return -errno;
+		b->max_ops = max_ops;
+	}
+	b->start = now_ns();
+	return 0;
+}
+
+static inline void bench_op(struct bench *b, uint64_t start) {
+	if (b->ops < b->max_ops)
+		b->lat[b->ops] = now_ns() - start;
+	b->ops++;
+}
+
+static int lat_order(const void *a, const void *b) {
+	uint64_t la = *(const uint64_t *)a;
+	uint64_t lb = *(const uint64_t *)b;
+	return la < lb ? -1 : la > lb;
+}
+
+static void bench_report(struct bench *b) {
+	uint64_t n_lat = b->ops < b->max_ops ? b->ops : b->max_ops;
+	double us, rate;
+
+	b->elapsed = now_ns() - b->start;
+	us = (double)b->elapsed / 1000.0;
+	rate = b->elapsed ? (double)b->ops * 1e9 / (double)b->elapsed : 0;
+
+	printf("{\"bench\": \"%s\", \"ops\": %" PRIu64 ", \"elapsed_us\": %.1f"
+	       ", \"ops_per_sec\": %.1f",
+	       b->name,
+	       b->ops,
+	       us,
+	       rate);
+
+	if (n_lat > 0) {
+		uint64_t total = 0;
+
+		qsort(b->lat, n_lat, sizeof(*b->lat), lat_order);
+		for (uint64_t i = 0; i < n_lat; i++)
+			total += b->lat[i];
+
+		printf(", \"lat_avg_us\": %.2f, \"lat_p50_us\": %.2f"
+		       ", \"lat_p99_us\": %.2f, \"lat_max_us\": %.2f",
+		       (double)total / (double)n_lat / 1000.0,
+		       (double)b->lat[n_lat / 2] / 1000.0,
+		       (double)b->lat[n_lat * 99 / 100] / 1000.0,
+		       (double)b->lat[n_lat - 1] / 1000.0);
+	}
+	printf("}\n");
+	fflush(stdout);
+
+	free(b->lat);
+	b->lat = NULL;
+}
+
+static void bench_abort(struct bench *b, const char *what) {
+	fprintf(stderr, "error: %s: %s: %s\n", b->name, what, strerror(errno));
+	free(b->lat);
+	b->lat = NULL;
+}
+
+// Destination prefixes are allocated sequentially from 16.0.0.0/4 and 2001:db8::/32.
+static struct ip4_net route4_dest(unsigned i) {
+	return (struct ip4_net) {
+		.ip = htonl(UINT32_C(0x10000000) + (i << 8)),
+		.prefixlen = 24,
+	};
+}
+
+static struct ip6_net route6_dest(unsigned i) {
+	struct ip6_net net = {.ip = {{0x20, 0x01, 0x0d, 0xb8}}, .prefixlen = 64};
+	net.ip.a[4] = i >> 24;
+	net.ip.a[5] = i >> 16;
+	net.ip.a[6] = i >> 8;
+	net.ip.a[7] = i;
+	return net;
+}
+
+static int nh_l3_add(uint32_t nh_id, addr_family_t af, unsigned i) {
+	struct gr_nexthop_info_l3 *l3;
+	struct gr_nh_add_req *req;
+	size_t len;
+	int ret;
+
+	len = sizeof(*req) + sizeof(*l3);
+	if ((req = calloc(1, len)) == NULL)
+		return -errno;
+
+	req->nh.type = GR_NH_T_L3;
+	req->nh.origin = GR_NH_ORIGIN_USER;
+	req->nh.iface_id = iface_id;
+	req->nh.nh_id = nh_id;
+	l3 = (struct gr_nexthop_info_l3 *)req->nh.info;
+	l3->af = af;
+	if (af == GR_AF_IP4) {
+		l3->ipv4 = htonl(UINT32_C(0x0a000000) + i + 1);
+	} else {
+		l3->ipv6 = (struct rte_ipv6_addr) {{0xfd, 0x00, 0x0b, 0xe0}};
+		l3->ipv6.a[12] = (i + 1) >> 24;
+		l3->ipv6.a[13] = (i + 1) >> 16;
+		l3->ipv6.a[14] = (i + 1) >> 8;
+		l3->ipv6.a[15] = (i + 1);
+	}
+
+	ret = gr_api_client_send_recv(client, GR_NH_ADD, len, req, NULL);
+	free(req);
+
+	return ret;
+}
+
+static int nh_group_add(uint32_t nh_id, uint32_t member_base, unsigned n_members) {
+	struct gr_nexthop_info_group *group;
+	struct gr_nh_add_req *req;
+	size_t len;
+	int ret;
+
+	len = sizeof(*req) + sizeof(*group) + n_members * sizeof(group->members[0]);
+	if ((req = calloc(1, len)) == NULL)
+		return -errno;
+
+	req->nh.type = GR_NH_T_GROUP;
+	req->nh.origin = GR_NH_ORIGIN_USER;
+	req->nh.nh_id = nh_id;
+	group = (struct gr_nexthop_info_group *)req->nh.info;
+	group->n_members = n_members;
+	for (unsigned i = 0; i < n_members; i++) {
+		group->members[i].nh_id = member_base + i;
+		group->members[i].weight = 1;
+	}
+
+	ret = gr_api_client_send_recv(client, GR_NH_ADD, len, req, NULL);
+	free(req);
+
+	return ret;
+}
+
+static int nh_del(uint32_t nh_id) {
+	struct gr_nh_del_req req = {.nh_id = nh_id, .missing_ok = true};
+	return gr_api_client_send_recv(client, GR_NH_DEL, sizeof(req), &req, NULL);
+}
+
+static int setup(void) {
+	struct gr_infra_iface_add_req *req;
+	struct gr_iface_info_port *port;
+	struct gr_infra_iface_add_resp *resp;
+	void *resp_ptr = NULL;
+	size_t len;
+	int ret;
+
+	len = sizeof(*req) + sizeof(*port);
+	if ((req = calloc(1, len)) == NULL)
+		return -errno;
+
+	req->iface.type = GR_IFACE_TYPE_PORT;
+	req->iface.flags = GR_IFACE_F_UP;
+	snprintf(req->iface.name, sizeof(req->iface.name), "grbench0");
+	port = (struct gr_iface_info_port *)req->iface.info;
+	snprintf(port->devargs, sizeof(port->devargs), "net_null_grbench0,no-rx=1");
+
+	ret = gr_api_client_send_recv(client, GR_INFRA_IFACE_ADD, len, req, &resp_ptr);
+	free(req);
+	if (ret < 0) {
+		fprintf(stderr, "error: cannot create port: %s\n", strerror(errno));
+		return ret;
+	}
+	resp = resp_ptr;
+	iface_id = resp->iface_id;
+	free(resp_ptr);
+
+	if (nh_l3_add(NH_ID_GW4, GR_AF_IP4, 0) < 0 || nh_l3_add(NH_ID_GW6, GR_AF_IP6, 0) < 0) {
+		fprintf(stderr, "error: cannot create nexthops: %s\n", strerror(errno));
+		return -errno;
+	}
+	for (unsigned i = 0; i < opts.ecmp; i++) {
+		if (nh_l3_add(NH_ID_MEMBER4 + i, GR_AF_IP4, i + 1) < 0
+		    || nh_l3_add(NH_ID_MEMBER6 + i, GR_AF_IP6, i + 1) < 0) {
+			fprintf(stderr, "error: cannot create nexthops: %s\n", strerror(errno));
+			return -errno;
+		}
+	}
+	if (nh_group_add(NH_ID_GROUP4, NH_ID_MEMBER4, opts.ecmp) < 0
+	    || nh_group_add(NH_ID_GROUP6, NH_ID_MEMBER6, opts.ecmp) < 0) {
+		fprintf(stderr, "error: cannot create nexthop groups: %s\n", strerror(errno));
+		return -errno;
+	}
+
+	return 0;
+}
+
+static void teardown(void) {
+	struct gr_infra_iface_del_req req = {.iface_id = iface_id};
+
+	nh_del(NH_ID_GROUP4);
+	nh_del(NH_ID_GROUP6);
+	for (unsigned i = 0; i < opts.ecmp; i++) {
+		nh_del(NH_ID_MEMBER4 + i);
+		nh_del(NH_ID_MEMBER6 + i);
+	}
+	nh_del(NH_ID_GW4);
+	nh_del(NH_ID_GW6);
+
+	if (iface_id != GR_IFACE_ID_UNDEF)
+		gr_api_client_send_recv(client, GR_INFRA_IFACE_DEL, sizeof(req), &req, NULL);
+}
+
+static int bench_rtt(void) {
+	struct gr_hello_req req = {.version = GROUT_VERSION};
+	struct bench b;
+	uint64_t t;
+
+	if (bench_start(&b, "api_rtt", opts.round_trips) < 0)
+		return -errno;
+
+	for (unsigned i = 0; i < opts.round_trips; i++) {
+		t = now_ns();
+		if (gr_api_client_send_recv(client, GR_MAIN_HELLO, sizeof(req), &req, NULL) < 0)
+			goto err;
+		bench_op(&b, t);
+	}
+	bench_report(&b);
+
+	return 0;
+err:
+	bench_abort(&b, "hello");
+	return -errno;
+}
+
+static int bench_nexthop(void) {
+	struct bench b;
+	uint64_t t;
+
+	if (bench_start(&b, "nh_add", opts.nexthops) < 0)
+		return -errno;
+	for (unsigned i = 0; i < opts.nexthops; i++) {
+		t = now_ns();
+		if (nh_l3_add(NH_ID_CHURN + i, GR_AF_IP4, ECMP_MAX_MEMBERS + i) < 0)
+			goto err;
+		bench_op(&b, t);
+	}
+	bench_report(&b);
+
+	if (bench_start(&b, "nh_list", 0) < 0)
+		return -errno;
+	struct gr_nh_list_req req = {.vrf_id = GR_VRF_ID_ALL, .type = GR_NH_T_ALL};
+	const struct gr_nexthop *nh;
+	int ret;
+	gr_api_client_stream_foreach (nh, ret, client, GR_NH_LIST, sizeof(req), &req) {
+		(void)nh;
+		b.ops++;
+	}
+	if (ret < 0)
+		goto err;
+	bench_report(&b);
+
+	if (bench_start(&b, "nh_del", opts.nexthops) < 0)
+		return -errno;
+	for (unsigned i = 0; i < opts.nexthops; i++) {
+		t = now_ns();
+		if (nh_del(NH_ID_CHURN + i) < 0)
+			goto err;
+		bench_op(&b, t);
+	}
+	bench_report(&b);
+
+	return 0;
+err:
+	bench_abort(&b, "nexthop");
+	for (unsigned i = 0; i < opts.nexthops; i++)
+		nh_del(NH_ID_CHURN + i);
+	return -errno;
+}
+
+static int route4_add(unsigned i, uint32_t nh_id) {
+	struct gr_ip4_route_add_req req = {
+		.dest = route4_dest(i),
+		.nh_id = nh_id,
+		.origin = GR_NH_ORIGIN_USER,
+	};
+	return gr_api_client_send_recv(client, GR_IP4_ROUTE_ADD, sizeof(req), &req, NULL);
+}
+
+static int route4_del(unsigned i) {
+	struct gr_ip4_route_del_req req = {.dest = route4_dest(i), .missing_ok = true};
+	return gr_api_client_send_recv(client, GR_IP4_ROUTE_DEL, sizeof(req), &req, NULL);
+}
+
+static int route6_add(unsigned i, uint32_t nh_id) {
+	struct gr_ip6_route_add_req req = {
+		.dest = route6_dest(i),
+		.nh_id = nh_id,
+		.origin = GR_NH_ORIGIN_USER,
+	};
+	return gr_api_client_send_recv(client, GR_IP6_ROUTE_ADD, sizeof(req), &req, NULL);
+}
+
+static int route6_del(unsigned i) {
+	struct gr_ip6_route_del_req req = {.dest = route6_dest(i), .missing_ok = true};
+	return gr_api_client_send_recv(client, GR_IP6_ROUTE_DEL, sizeof(req), &req, NULL);
+}
+
+static int route_list(const char *name, bool ip6) {
+	struct gr_ip4_route_list_req req4 = {.vrf_id = GR_VRF_ID_ALL};
+	struct gr_ip6_route_list_req req6 = {.vrf_id = GR_VRF_ID_ALL};
+	const struct gr_ip4_route *r4;
+	const struct gr_ip6_route *r6;
+	struct bench b;
+	int ret;
+
+	if (bench_start(&b, name, 0) < 0)
+		return -errno;
+
+	if (ip6) {
+		gr_api_client_stream_foreach (
+			r6, ret, client, GR_IP6_ROUTE_LIST, sizeof(req6), &req6
+		) {
+			(void)r6;
+			b.ops++;
+		}
+	} else {
+		gr_api_client_stream_foreach (
+			r4, ret, client, GR_IP4_ROUTE_LIST, sizeof(req4), &req4
+		) {
+			(void)r4;
+			b.ops++;
+		}
+	}
+	if (ret < 0) {
+		bench_abort(&b, "list");
+		return ret;
+	}
+	bench_report(&b);
+
+	return 0;
+}
+
+// Add all routes, list them and delete them.
+static int bench_routes(bool ip6, bool ecmp) {
+	char add_name[32], del_name[32], list_name[32];
+	const char *af = ip6 ? "ip6" : "ip4";
+	const char *suffix = ecmp ? "_ecmp" : "";
+	uint32_t nh_id;
+	struct bench b;
+	uint64_t t;
+	int ret;
+
+	if (ip6)
+		nh_id = ecmp ? NH_ID_GROUP6 : NH_ID_GW6;
+	else
+		nh_id = ecmp ? NH_ID_GROUP4 : NH_ID_GW4;
+
+	snprintf(add_name, sizeof(add_name), "%s_route_add%s", af, suffix);
+	snprintf(del_name, sizeof(del_name), "%s_route_del%s", af, suffix);
+	snprintf(list_name, sizeof(list_name), "%s_route_list%s", af, suffix);
+
+	if (bench_start(&b, add_name, opts.routes) < 0)
+		return -errno;
+	for (unsigned i = 0; i < opts.routes; i++) {
+		t = now_ns();
+		ret = ip6 ? route6_add(i, nh_id) : route4_add(i, nh_id);
+		if (ret < 0)
+			goto err;
+		bench_op(&b, t);
+	}
+	bench_report(&b);
+
+	if ((ret = route_list(list_name, ip6)) < 0)
+		goto cleanup;
+
+	if (bench_start(&b, del_name, opts.routes) < 0)
+		return -errno;
+	for (unsigned i = 0; i < opts.routes; i++) {
+		t = now_ns();
+		ret = ip6 ? route6_del(i) : route4_del(i);
+		if (ret < 0)
+			goto err;
+		bench_op(&b, t);
+	}
+	bench_report(&b);
+
+	return 0;
+err:
+	bench_abort(&b, "route");
+cleanup:
+	ret = -errno;
+	for (unsigned i = 0; i < opts.routes; i++)
+		ip6 ? route6_del(i) : route4_del(i);
+	return ret;
+}
+
+// Wait for completions of all requests queued in the shared memory ring.
+static int ring_drain(uint32_t *pending) {
+	uint32_t id, status;
+	int ret;
+
+	while (*pending > 0) {
+		if ((ret = gr_api_client_ring_kick(client)) < 0)
+			return ret;
+		while ((ret = gr_api_client_ring_complete(client, &id, &status)) > 0) {
+			if (status != 0)
+				return errno_set(status);
+			(*pending)--;
+		}
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+// Same as the single path IPv4 route benchmark using the shared memory
+// request ring. Individual latencies are not measured.
+static int bench_ring(void) {
+	uint32_t pending = 0;
+	struct bench b;
+	long int ret;
+
+	if (gr_api_client_ring_open(client, opts.ring_slots) < 0) {
+		fprintf(stderr, "error: ring open: %s\n", strerror(errno));
+		return -errno;
+	}
+
+	if (bench_start(&b, "ip4_route_add_ring", 0) < 0)
+		return -errno;
+	for (unsigned i = 0; i < opts.routes; i++) {
+		struct gr_ip4_route_add_req req = {
+			.dest = route4_dest(i),
+			.nh_id = NH_ID_GW4,
+			.origin = GR_NH_ORIGIN_USER,
+		};
+		while ((ret = gr_api_client_ring_send(client, GR_IP4_ROUTE_ADD, sizeof(req), &req))
+		       == -ENOBUFS) {
+			if (ring_drain(&pending) < 0)
+				goto err;
+		}
+		if (ret < 0)
+			goto err;
+		pending++;
+		b.ops++;
+	}
+	if (ring_drain(&pending) < 0)
+		goto err;
+	bench_report(&b);
+
+	if (bench_start(&b, "ip4_route_del_ring", 0) < 0)
+		return -errno;
+	for (unsigned i = 0; i < opts.routes; i++) {
+		struct gr_ip4_route_del_req req = {.dest = route4_dest(i), .missing_ok = true};
+		while ((ret = gr_api_client_ring_send(client, GR_IP4_ROUTE_DEL, sizeof(req), &req))
+		       == -ENOBUFS) {
+			if (ring_drain(&pending) < 0)
+				goto err;
+		}
+		if (ret < 0)
+			goto err;
+		pending++;
+		b.ops++;
+	}
+	if (ring_drain(&pending) < 0)
+		goto err;
+	bench_report(&b);
+
+	return 0;
+err:
+	ret = -errno;
+	bench_abort(&b, "ring");
+	for (unsigned i = 0; i < opts.routes; i++)
+		route4_del(i);
+	return ret;
+}
+
+struct subscriber {
+	pthread_t thread;
+	struct gr_api_client *client;
+	uint64_t last_ns;
+	unsigned received;
+	int err;
+};
+
+static void *subscriber_main(void *priv) {
+	struct subscriber *s = priv;
+	struct gr_api_event *e;
+
+	while (s->received < opts.events) {
+		if (gr_api_client_event_recv(s->client, &e) < 0 || e == NULL) {
+			s->err = errno;
+			break;
+		}
+		if (e->ev_type == GR_EVENT_IP_ROUTE_ADD) {
+			s->received++;
+			s->last_ns = now_ns();
+		}
+		free(e);
+	}
+
+	return NULL;
+}
+
+// Time taken to deliver route events to all subscribers.
+static int bench_events(void) {
+	struct gr_event_subscribe_req req = {.ev_type = GR_EVENT_IP_ROUTE_ADD};
+	struct subscriber *subs;
+	uint64_t last_ns = 0;
+	struct bench b;
+	int ret = 0;
+
+	if ((subs = calloc(opts.subscribers, sizeof(*subs))) == NULL)
+		return -errno;
+
+	for (unsigned i = 0; i < opts.subscribers; i++) {
+		subs[i].client = gr_api_client_connect(opts.sock_path);
+		if (subs[i].client == NULL
+		    || gr_api_client_send_recv(
+			       subs[i].client, GR_MAIN_EVENT_SUBSCRIBE, sizeof(req), &req, NULL
+		       ) < 0) {
+			fprintf(stderr, "error: subscribe: %s\n", strerror(errno));
+			ret = -errno;
+			goto out;
+		}
+	}
+	for (unsigned i = 0; i < opts.subscribers; i++) {
+		if ((ret = pthread_create(&subs[i].thread, NULL, subscriber_main, &subs[i])) != 0) {
+			fprintf(stderr, "error: pthread_create: %s\n", strerror(ret));
+			ret = -ret;
+			goto out;
+		}
+	}
+
+	if (bench_start(&b, "event_fanout", 0) < 0) {
+		ret = -errno;
+		goto out;
+	}
+	for (unsigned i = 0; i < opts.events; i++) {
+		if (route4_add(i, NH_ID_GW4) < 0) {
+			ret = -errno;
+			bench_abort(&b, "route");
+			goto out;
+		}
+	}
+	for (unsigned i = 0; i < opts.subscribers; i++) {
+		pthread_join(subs[i].thread, NULL);
+		subs[i].thread = 0;
+		if (subs[i].err != 0) {
+			fprintf(stderr, "error: event recv: %s\n", strerror(subs[i].err));
+			ret = -subs[i].err;
+			goto out;
+		}
+		b.ops += subs[i].received;
+		if (subs[i].last_ns > last_ns)
+			last_ns = subs[i].last_ns;
+	}
+	// Report the time at which the last event was received.
+	b.start += now_ns() - last_ns;
+	bench_report(&b);
+
+out:
+	for (unsigned i = 0; i < opts.subscribers; i++) {
+		// Disconnecting unblocks the subscriber thread on error.
+		if (subs[i].client != NULL)
+			shutdown(subs[i].client->sock_fd, SHUT_RDWR);
+		if (subs[i].thread != 0)
+			pthread_join(subs[i].thread, NULL);
+		gr_api_client_disconnect(subs[i].client);
+	}
+	free(subs);
+	for (unsigned i = 0; i < opts.events; i++)
+		route4_del(i);
+
+	return ret;
+}
+
+static int bench_ip4(void) {
+	return bench_routes(false, false);
+}
+
+static int bench_ip6(void) {
+	return bench_routes(true, false);
+}
+
+static int bench_ecmp(void) {
+	int ret = bench_routes(false, true);
+	if (ret < 0)
+		return ret;
+	return bench_routes(true, true);
+}
+
+static const struct {
+	const char *name;
+	int (*run)(void);
+} benchmarks[] = {
+	{"rtt", bench_rtt},
+	{"nexthop", bench_nexthop},
+	{"ip4", bench_ip4},
+	{"ip6", bench_ip6},
+	{"ecmp", bench_ecmp},
+	{"ring", bench_ring},
+	{"events", bench_events},
+};
+
+static int run(const char *name) {
+	for (unsigned i = 0; i < ARRAY_DIM(benchmarks); i++) {
+		if (strcmp(benchmarks[i].name, name) == 0)
+			return benchmarks[i].run();
+	}
+	fprintf(stderr, "error: %s: unknown benchmark\n", name);
+	return -ENOENT;
+}
+
+static void usage(void) {
+	puts("Usage: grbench [-h] [-s PATH] [-n ROUTES] [-N NEXTHOPS] [-e MEMBERS]");
+	puts("               [-r ROUND_TRIPS] [-E EVENTS] [-S SUBSCRIBERS] [-R SLOTS]");
+	puts("               [rtt|nexthop|ip4|ip6|ecmp|ring|events]...");
+	puts("");
+	puts("  Benchmark the grout control plane API. Must be run against grout");
+	puts("  started in test mode. Results are printed as JSON lines.");
+	puts("");
+	puts("options:");
+	puts("  -h, --help                     Display this help message and exit.");
+	puts("  -s PATH, --socket PATH         Path to the control plane API socket.");
+	puts("                                 Default: GROUT_SOCK_PATH from env or");
+	printf("                                 %s).\n", GR_DEFAULT_SOCK_PATH);
+	puts("  -n ROUTES, --routes ROUTES     Number of routes (default 100000).");
+	puts("  -N NEXTHOPS, --nexthops NEXTHOPS");
+	puts("                                 Number of nexthops (default 10000).");
+	puts("  -e MEMBERS, --ecmp MEMBERS     Members of ECMP groups (default 8).");
+	puts("  -r COUNT, --round-trips COUNT  Number of API round trips (default 10000).");
+	puts("  -E EVENTS, --events EVENTS     Number of events (default 10000).");
+	puts("  -S COUNT, --subscribers COUNT  Number of event subscribers (default 4).");
+	puts("  -R SLOTS, --ring-slots SLOTS   Size of the request ring (default 1024).");
+}
+
+static int parse_uint(const char *arg, const char *opt, unsigned min, unsigned max, unsigned *v) {
+	unsigned long val;
+	char *end;
+
+	errno = 0;
+	val = strtoul(arg, &end, 10);
+	if (errno != 0 || *end != '\0' || val < min || val > max) {
+		fprintf(stderr, "error: %s: invalid value\n", opt);
+		return -1;
+	}
+	*v = val;
+
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	int ret = EXIT_FAILURE;
+	int c;
+
+	static struct option long_options[] = {
+		{"ecmp", required_argument, NULL, 'e'},
+		{"events", required_argument, NULL, 'E'},
+		{"help", no_argument, NULL, 'h'},
+		{"nexthops", required_argument, NULL, 'N'},
+		{"ring-slots", required_argument, NULL, 'R'},
+		{"round-trips", required_argument, NULL, 'r'},
+		{"routes", required_argument, NULL, 'n'},
+		{"socket", required_argument, NULL, 's'},
+		{"subscribers", required_argument, NULL, 'S'},
+		{0},
+	};
+
+	opts.sock_path = getenv("GROUT_SOCK_PATH");
+	if (opts.sock_path == NULL)
+		opts.sock_path = GR_DEFAULT_SOCK_PATH;
+
+	while ((c = getopt_long(argc, argv, "e:E:hn:N:r:R:s:S:", long_options, NULL)) != -1) {
+		switch (c) {
+		case 'e':
+			if (parse_uint(optarg, "--ecmp", 1, ECMP_MAX_MEMBERS, &opts.ecmp) < 0)
+				return EXIT_FAILURE;
+			break;
+		case 'E':
+			if (parse_uint(optarg, "--events", 1, 1 << 20, &opts.events) < 0)
+				return EXIT_FAILURE;
+			break;
+		case 'h':
+			usage();
+			return EXIT_SUCCESS;
+		case 'n':
+			if (parse_uint(optarg, "--routes", 1, 1 << 20, &opts.routes) < 0)
+				return EXIT_FAILURE;
+			break;
+		case 'N':
+			if (parse_uint(optarg, "--nexthops", 1, 1 << 20, &opts.nexthops) < 0)
+				return EXIT_FAILURE;
+			break;
+		case 'r':
+			if (parse_uint(optarg, "--round-trips", 1, UINT32_MAX, &opts.round_trips)
+			    < 0)
+				return EXIT_FAILURE;
+			break;
+		case 'R':
+			if (parse_uint(optarg, "--ring-slots", 1, UINT32_MAX, &opts.ring_slots) < 0)
+				return EXIT_FAILURE;
+			if (opts.ring_slots > GR_API_RING_MAX_SLOTS
+			    || (opts.ring_slots & (opts.ring_slots - 1))) {
+				fprintf(stderr, "error: --ring-slots: invalid value\n");
+				return EXIT_FAILURE;
+			}
+			break;
+		case 's':
+			opts.sock_path = optarg;
+			break;
+		case 'S':
+			if (parse_uint(optarg, "--subscribers", 1, 1024, &opts.subscribers) < 0)
+				return EXIT_FAILURE;
+			break;
+		default:
+			usage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if ((client = gr_api_client_connect(opts.sock_path)) == NULL) {
+		fprintf(stderr, "error: %s: %s\n", opts.sock_path, strerror(errno));
+		return EXIT_FAILURE;
+	}
+	if (setup() < 0)
+		goto out;
+
+	printf("{\"bench\": \"info\", \"version\": \"%s\", \"routes\": %u, \"nexthops\": %u"
+	       ", \"ecmp\": %u, \"events\": %u, \"subscribers\": %u}\n",
+	       GROUT_VERSION,
+	       opts.routes,
+	       opts.nexthops,
+	       opts.ecmp,
+	       opts.events,
+	       opts.subscribers);
+
+	if (optind == argc) {
+		for (unsigned i = 0; i < ARRAY_DIM(benchmarks); i++) {
+			if (run(benchmarks[i].name) < 0)
+				goto out;
+		}
+	} else {
+		for (int i = optind; i < argc; i++) {
+			if (run(argv[i]) < 0)
+				goto out;
+		}
+	}
+
+	ret = EXIT_SUCCESS;
+out:
+	teardown();
+	gr_api_client_disconnect(client);
+
+	return ret;
+}
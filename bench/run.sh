@@ -0,0 +1,25 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+# Start grout in test mode and run control plane API benchmarks against it.
+# Results are printed on standard output as JSON lines.
+#
+# Usage: bench/run.sh BUILDDIR [GRBENCH_ARGS...]
+
+set -e
+
+builddir=${1?BUILDDIR}
+shift
+
+tmp=$(mktemp -d)
+trap "kill %1 2>/dev/null; wait; rm -rf $tmp" EXIT
+export GROUT_SOCK_PATH=$tmp/grout.sock
+
+$builddir/grout -t > $tmp/grout.log 2>&1 &
+socat FILE:/dev/null UNIX-CONNECT:$GROUT_SOCK_PATH,retry=10
+
+if ! $builddir/grbench "$@"; then
+	cat $tmp/grout.log >&2
+	exit 1
+fi
@@ -39,6 +39,10 @@ class Iface:
         "GR_IFACE_TYPE_PORT": "struct __gr_iface_info_port_base",
         "GR_IFACE_TYPE_VLAN": "struct gr_iface_info_vlan",
         "GR_IFACE_TYPE_IPIP": "struct gr_iface_info_ipip",
+        "GR_IFACE_TYPE_VXLAN": "struct gr_iface_info_vxlan",
+        "GR_IFACE_TYPE_GRE": "struct gr_iface_info_gre",
+        "GR_IFACE_TYPE_BRIDGE": "struct gr_iface_info_bridge",
+        "GR_IFACE_TYPE_VHOST": "struct gr_iface_info_vhost",
     }
 
     def __init__(self, val):
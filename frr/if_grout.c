@@ -8,9 +8,12 @@
 #include "if_grout.h"
 #include "log_grout.h"
 
+#include <gr_bridge.h>
 #include <gr_ip4.h>
 #include <gr_ip6.h>
 #include <gr_srv6.h>
+#include <gr_vhost.h>
+#include <gr_vxlan.h>
 
 #include <linux/if.h>
 #include <net/if.h>
@@ -45,6 +48,9 @@ void grout_link_change(struct gr_iface *gr_if, bool new, bool startup) {
 	struct zebra_dplane_ctx *ctx = dplane_ctx_alloc();
 	enum zebra_link_type link_type = ZEBRA_LLT_UNKNOWN;
 	enum zebra_iftype zif_type = ZEBRA_IF_OTHER;
+	const struct gr_iface_info_bridge *gr_bridge = NULL;
+	const struct gr_iface_info_vhost *gr_vhost = NULL;
+	const struct gr_iface_info_vxlan *gr_vxlan = NULL;
 	const struct gr_iface_info_vlan *gr_vlan = NULL;
 	const struct gr_iface_info_port *gr_port = NULL;
 	ifindex_t link_ifindex = IFINDEX_INTERNAL;
@@ -68,6 +74,25 @@ void grout_link_change(struct gr_iface *gr_if, bool new, bool startup) {
 	case GR_IFACE_TYPE_IPIP:
 		link_type = ZEBRA_LLT_IPIP;
 		break;
+	case GR_IFACE_TYPE_GRE:
+		link_type = ZEBRA_LLT_GRE;
+		break;
+	case GR_IFACE_TYPE_VXLAN:
+		gr_vxlan = (const struct gr_iface_info_vxlan *)&gr_if->info;
+		mac = &gr_vxlan->mac;
+		link_type = ZEBRA_LLT_ETHER;
+		break;
+	case GR_IFACE_TYPE_BRIDGE:
+		gr_bridge = (const struct gr_iface_info_bridge *)&gr_if->info;
+		mac = &gr_bridge->mac;
+		zif_type = ZEBRA_IF_BRIDGE;
+		link_type = ZEBRA_LLT_ETHER;
+		break;
+	case GR_IFACE_TYPE_VHOST:
+		gr_vhost = (const struct gr_iface_info_vhost *)&gr_if->info;
+		mac = &gr_vhost->mac;
+		link_type = ZEBRA_LLT_ETHER;
+		break;
 	case GR_IFACE_TYPE_LOOPBACK:
 		link_type = ZEBRA_LLT_LOOPBACK;
 		if (gr_if->base.vrf_id)
@@ -101,17 +126,23 @@ void grout_link_change(struct gr_iface *gr_if, bool new, bool startup) {
 		dplane_ctx_set_status(ctx, ZEBRA_DPLANE_REQUEST_QUEUED);
 		dplane_ctx_set_ifp_mtu(ctx, gr_if->base.mtu);
 
-		// no bond/bridge support in grout
-		dplane_ctx_set_ifp_zif_slave_type(ctx, ZEBRA_IF_SLAVE_NONE);
-		dplane_ctx_set_ifp_master_ifindex(ctx, IFINDEX_INTERNAL);
-		dplane_ctx_set_ifp_bridge_ifindex(ctx, IFINDEX_INTERNAL);
+		// no bond support in grout
+		if (gr_if->base.mode == GR_IFACE_MODE_L2_BRIDGE) {
+			dplane_ctx_set_ifp_zif_slave_type(ctx, ZEBRA_IF_SLAVE_BRIDGE);
+			dplane_ctx_set_ifp_master_ifindex(ctx, gr_if->base.domain_id);
+			dplane_ctx_set_ifp_bridge_ifindex(ctx, gr_if->base.domain_id);
+		} else {
+			dplane_ctx_set_ifp_zif_slave_type(ctx, ZEBRA_IF_SLAVE_NONE);
+			dplane_ctx_set_ifp_master_ifindex(ctx, IFINDEX_INTERNAL);
+			dplane_ctx_set_ifp_bridge_ifindex(ctx, IFINDEX_INTERNAL);
+		}
 		dplane_ctx_set_ifp_bond_ifindex(ctx, IFINDEX_INTERNAL);
 		dplane_ctx_set_ifp_bypass(ctx, 0);
 		dplane_ctx_set_ifp_zltype(ctx, link_type);
 		dplane_ctx_set_ifp_flags(ctx, gr_if_flags_to_netlink(gr_if, link_type));
 		dplane_ctx_set_ifp_protodown_set(ctx, false);
 
-		if (gr_if->base.vrf_id != 0) {
+		if (gr_if->base.mode == GR_IFACE_MODE_L3 && gr_if->base.vrf_id != 0) {
 			dplane_ctx_set_ifp_table_id(ctx, gr_if->base.vrf_id);
 
 			// In Linux, vrf_id equals the interface index; in Grout we model a VRF
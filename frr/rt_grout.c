@@ -4,11 +4,15 @@
 #include "log_grout.h"
 #include "rt_grout.h"
 
+#include <gr_mpls.h>
+#include <gr_pbr.h>
 #include <gr_srv6.h>
 
+#include <lib/pbr.h>
 #include <lib/srv6.h>
 #include <zebra/rib.h>
 #include <zebra/table_manager.h>
+#include <zebra/zebra_mpls.h>
 #include <zebra_dplane_grout.h>
 
 static inline bool is_selfroute(gr_nh_origin_t origin) {
@@ -248,6 +252,11 @@ static int grout_gr_nexthop_to_frr_nexthop(
 			SET_SRV6_FLV_OP(ctx.flv.flv_ops, ZEBRA_SEG6_LOCAL_FLV_OP_PSP);
 		if (sr6->flags & GR_SR_FL_FLAVOR_USD)
 			SET_SRV6_FLV_OP(ctx.flv.flv_ops, ZEBRA_SEG6_LOCAL_FLV_OP_USD);
+		if (sr6->flags & GR_SR_FL_FLAVOR_NEXT_CSID) {
+			SET_SRV6_FLV_OP(ctx.flv.flv_ops, ZEBRA_SEG6_LOCAL_FLV_OP_NEXT_CSID);
+			ctx.flv.lcblock_len = sr6->csid_block_bits;
+			ctx.flv.lcnode_func_len = sr6->csid_bits;
+		}
 
 		switch (sr6->behavior) {
 		case SR_BEHAVIOR_END:
@@ -265,6 +274,15 @@ static int grout_gr_nexthop_to_frr_nexthop(
 		case SR_BEHAVIOR_END_DT46:
 			action = ZEBRA_SEG6_LOCAL_ACTION_END_DT46;
 			break;
+		case SR_BEHAVIOR_END_X:
+		case SR_BEHAVIOR_END_DX2:
+		case SR_BEHAVIOR_END_DX4:
+		case SR_BEHAVIOR_END_DX6:
+			gr_log_debug(
+				"srv6 local behavior %s, nexthop not sync",
+				gr_srv6_behavior_name(sr6->behavior)
+			);
+			return -1;
 		}
 
 		ctx.table = sr6->out_vrf_id;
@@ -284,11 +302,41 @@ static int grout_gr_nexthop_to_frr_nexthop(
 		case SR_H_ENCAPS_RED:
 			encap_behavior = SRV6_HEADEND_BEHAVIOR_H_ENCAPS_RED;
 			break;
+		case SR_H_ENCAPS_L2:
+			gr_log_debug("srv6 encap behavior h.encaps.l2, nexthop not sync");
+			return -1;
 		}
 
 		nexthop_add_srv6_seg6(nh, (void *)sr6->seglist, sr6->n_seglist, encap_behavior);
 		break;
 	}
+	case GR_NH_T_MPLS: {
+		const struct gr_nexthop_info_mpls *mpls;
+		mpls_label_t labels[GR_MPLS_LABEL_STACK_MAX];
+
+		mpls = (const struct gr_nexthop_info_mpls *)gr_nh->info;
+
+		switch (mpls->af) {
+		case GR_AF_IP4:
+			nh->type = NEXTHOP_TYPE_IPV4_IFINDEX;
+			*nh_family = AF_INET;
+			memcpy(&nh->gate.ipv4, &mpls->ipv4, sizeof(nh->gate.ipv4));
+			break;
+		case GR_AF_IP6:
+			nh->type = NEXTHOP_TYPE_IPV6_IFINDEX;
+			*nh_family = AF_INET6;
+			memcpy(&nh->gate.ipv6, &mpls->ipv6, sizeof(nh->gate.ipv6));
+			break;
+		default:
+			gr_log_debug("inval mpls nexthop family %u, nexthop not sync", mpls->af);
+			return -1;
+		}
+
+		for (uint8_t i = 0; i < mpls->n_labels; i++)
+			labels[i] = mpls->labels[i];
+		nexthop_add_labels(nh, ZEBRA_LSP_STATIC, mpls->n_labels, labels);
+		break;
+	}
 	case GR_NH_T_GROUP:
 		nh->ifindex = gr_nh->iface_id;
 		nh->vrf_id = gr_nh->vrf_id;
@@ -619,11 +667,44 @@ static enum zebra_dplane_result grout_del_nexthop(uint32_t nh_id) {
 	return ZEBRA_DPLANE_REQUEST_SUCCESS;
 }
 
+static int mpls_nexthop_to_gr(const struct nexthop *nh, struct gr_nexthop_info_mpls *mpls) {
+	switch (nh->type) {
+	case NEXTHOP_TYPE_IPV4:
+	case NEXTHOP_TYPE_IPV4_IFINDEX:
+		mpls->af = GR_AF_IP4;
+		memcpy(&mpls->ipv4, &nh->gate.ipv4, sizeof(mpls->ipv4));
+		break;
+	case NEXTHOP_TYPE_IPV6:
+	case NEXTHOP_TYPE_IPV6_IFINDEX:
+		mpls->af = GR_AF_IP6;
+		memcpy(&mpls->ipv6, &nh->gate.ipv6, sizeof(mpls->ipv6));
+		break;
+	default:
+		gr_log_err("mpls nexthop type %u not supported by grout", nh->type);
+		return -1;
+	}
+
+	if (nh->nh_label == NULL)
+		return 0;
+
+	if (nh->nh_label->num_labels > GR_MPLS_LABEL_STACK_MAX) {
+		gr_log_err("too many mpls labels: %u", nh->nh_label->num_labels);
+		return -1;
+	}
+
+	mpls->n_labels = nh->nh_label->num_labels;
+	for (unsigned i = 0; i < nh->nh_label->num_labels; i++)
+		mpls->labels[i] = nh->nh_label->label[i];
+
+	return 0;
+}
+
 static enum zebra_dplane_result
 grout_add_nexthop(uint32_t nh_id, gr_nh_origin_t origin, const struct nexthop *nh) {
 	enum zebra_dplane_result ret = ZEBRA_DPLANE_REQUEST_FAILURE;
 	struct gr_nexthop_info_srv6_local *sr6_local;
 	struct gr_nexthop_info_srv6 *sr6;
+	struct gr_nexthop_info_mpls *mpls;
 	struct gr_nh_add_req *req = NULL;
 	struct gr_nexthop_info_l3 *l3;
 	size_t len = sizeof(*req);
@@ -644,6 +725,10 @@ grout_add_nexthop(uint32_t nh_id, gr_nh_origin_t origin, const struct nexthop *n
 			len += sizeof(*sr6)
 				+ nh->nh_srv6->seg6_segs->num_segs * sizeof(sr6->seglist[0]);
 			type = GR_NH_T_SR6_OUTPUT;
+		} else if (nh->nh_label != NULL && nh->nh_label->num_labels > 0
+			   && nh->type != NEXTHOP_TYPE_IFINDEX) {
+			len += sizeof(*mpls);
+			type = GR_NH_T_MPLS;
 		} else {
 			len += sizeof(*l3);
 			type = GR_NH_T_L3;
@@ -733,8 +818,25 @@ grout_add_nexthop(uint32_t nh_id, gr_nh_origin_t origin, const struct nexthop *n
 			gr_log_debug("USP is always configured");
 		if (CHECK_SRV6_FLV_OP(flv, ZEBRA_SEG6_LOCAL_FLV_OP_USD))
 			sr6_local->flags |= GR_SR_FL_FLAVOR_USD;
-		if (CHECK_SRV6_FLV_OP(flv, ZEBRA_SEG6_LOCAL_FLV_OP_NEXT_CSID))
-			gr_log_debug("not supported next-c-sid for srv6 local");
+		if (CHECK_SRV6_FLV_OP(flv, ZEBRA_SEG6_LOCAL_FLV_OP_NEXT_CSID)) {
+			const struct seg6local_flavors_info *flv_info;
+
+			flv_info = &nh->nh_srv6->seg6local_ctx.flv;
+			switch (sr6_local->behavior) {
+			case SR_BEHAVIOR_END:
+			case SR_BEHAVIOR_END_T:
+				sr6_local->flags |= GR_SR_FL_FLAVOR_NEXT_CSID;
+				sr6_local->csid_block_bits = flv_info->lcblock_len;
+				sr6_local->csid_bits = flv_info->lcnode_func_len;
+				break;
+			default:
+				gr_log_debug(
+					"not supported next-c-sid for srv6 local behavior %s",
+					gr_srv6_behavior_name(sr6_local->behavior)
+				);
+				break;
+			}
+		}
 
 		break;
 	case GR_NH_T_SR6_OUTPUT:
@@ -764,6 +866,11 @@ grout_add_nexthop(uint32_t nh_id, gr_nh_origin_t origin, const struct nexthop *n
 			       sizeof(sr6->seglist[i]));
 
 		break;
+	case GR_NH_T_MPLS:
+		mpls = (struct gr_nexthop_info_mpls *)req->nh.info;
+		if (mpls_nexthop_to_gr(nh, mpls) < 0)
+			goto out;
+		break;
 	case GR_NH_T_BLACKHOLE:
 	case GR_NH_T_REJECT:
 		req->nh.iface_id = GR_IFACE_ID_UNDEF;
@@ -809,6 +916,170 @@ enum zebra_dplane_result grout_add_del_nexthop(struct zebra_dplane_ctx *ctx) {
 	return grout_add_nexthop(nh_id, origin, dplane_ctx_get_nhe_ng(ctx)->nexthop);
 }
 
+enum zebra_dplane_result grout_add_del_lsp(struct zebra_dplane_ctx *ctx) {
+	struct gr_mpls_route_add_req req = {.exist_ok = true};
+	const struct zebra_nhlfe *nhlfe;
+	struct gr_mpls_route *r;
+
+	if (dplane_ctx_get_op(ctx) == DPLANE_OP_LSP_DELETE) {
+		struct gr_mpls_route_del_req del = {
+			.in_label = dplane_ctx_get_in_label(ctx),
+			.missing_ok = true,
+		};
+
+		if (grout_client_send_recv(GR_MPLS_ROUTE_DEL, sizeof(del), &del, NULL) < 0)
+			return ZEBRA_DPLANE_REQUEST_FAILURE;
+		return ZEBRA_DPLANE_REQUEST_SUCCESS;
+	}
+
+	// grout does not support multipath LSPs, only install the best NHLFE.
+	nhlfe = dplane_ctx_get_best_nhlfe(ctx);
+	if (nhlfe == NULL || nhlfe->nexthop == NULL) {
+		gr_log_err("no nhlfe for in label %u", dplane_ctx_get_in_label(ctx));
+		return ZEBRA_DPLANE_REQUEST_FAILURE;
+	}
+
+	r = &req.route;
+	r->in_label = dplane_ctx_get_in_label(ctx);
+	r->origin = zebra2origin(re_type_from_lsp_type(nhlfe->type));
+	r->vrf_id = nhlfe->nexthop->vrf_id;
+	r->iface_id = nhlfe->nexthop->ifindex;
+
+	if (mpls_nexthop_to_gr(nhlfe->nexthop, &r->nh) < 0)
+		return ZEBRA_DPLANE_REQUEST_FAILURE;
+
+	gr_log_debug("add lsp in label %u", r->in_label);
+
+	if (grout_client_send_recv(GR_MPLS_ROUTE_ADD, sizeof(req), &req, NULL) < 0)
+		return ZEBRA_DPLANE_REQUEST_FAILURE;
+
+	return ZEBRA_DPLANE_REQUEST_SUCCESS;
+}
+
+static int rule_prefix_to_gr(const struct prefix *p, struct gr_pbr_rule *r, void *net) {
+	struct ip4_net *n4 = net;
+	struct ip6_net *n6 = net;
+
+	switch (p->family) {
+	case AF_INET:
+		if (r->af == GR_AF_IP6)
+			return -1;
+		r->af = GR_AF_IP4;
+		n4->ip = p->u.prefix4.s_addr;
+		n4->prefixlen = p->prefixlen;
+		return 0;
+	case AF_INET6:
+		if (r->af == GR_AF_IP4)
+			return -1;
+		r->af = GR_AF_IP6;
+		memcpy(&n6->ip, &p->u.prefix6, sizeof(n6->ip));
+		n6->prefixlen = p->prefixlen;
+		return 0;
+	}
+	return -1;
+}
+
+static enum zebra_dplane_result grout_del_rule(uint16_t iface_id, uint32_t seq) {
+	struct gr_pbr_rule_del_req req = {.iface_id = iface_id, .seq = seq, .missing_ok = true};
+
+	gr_log_debug("del rule iface %u seq %u", iface_id, seq);
+
+	if (grout_client_send_recv(GR_PBR_RULE_DEL, sizeof(req), &req, NULL) < 0)
+		return ZEBRA_DPLANE_REQUEST_FAILURE;
+
+	return ZEBRA_DPLANE_REQUEST_SUCCESS;
+}
+
+enum zebra_dplane_result grout_add_del_rule(struct zebra_dplane_ctx *ctx) {
+	size_t len = sizeof(struct gr_pbr_rule_add_req) + sizeof(struct gr_pbr_rule);
+	// FRR interface indexes are grout interface IDs.
+	uint16_t iface_id = dplane_ctx_rule_get_ifindex(ctx);
+	uint32_t filter = dplane_ctx_rule_get_filter_bm(ctx);
+	uint32_t table = dplane_ctx_rule_get_table(ctx);
+	struct gr_pbr_rule_add_req *req;
+	enum zebra_dplane_result ret;
+	struct gr_pbr_rule *r;
+
+	switch (dplane_ctx_get_op(ctx)) {
+	case DPLANE_OP_RULE_DELETE:
+		return grout_del_rule(iface_id, dplane_ctx_rule_get_priority(ctx));
+	case DPLANE_OP_RULE_UPDATE:
+		if (dplane_ctx_rule_get_old_priority(ctx) != dplane_ctx_rule_get_priority(ctx)) {
+			ret = grout_del_rule(iface_id, dplane_ctx_rule_get_old_priority(ctx));
+			if (ret != ZEBRA_DPLANE_REQUEST_SUCCESS)
+				return ret;
+		}
+		break;
+	default:
+		break;
+	}
+
+	if (filter & ~(PBR_FILTER_SRC_IP | PBR_FILTER_DST_IP | PBR_FILTER_SRC_PORT
+		       | PBR_FILTER_DST_PORT | PBR_FILTER_IP_PROTOCOL | PBR_FILTER_DSCP)) {
+		gr_log_err("unsupported rule filter 0x%x", filter);
+		return ZEBRA_DPLANE_REQUEST_FAILURE;
+	}
+	// pbrd installs the routes of each policy in a dedicated table. grout
+	// only supports steering packets into another VRF routing table.
+	if (table >= GR_MAX_VRFS) {
+		gr_log_err("rule table %u is not a valid grout vrf", table);
+		return ZEBRA_DPLANE_REQUEST_FAILURE;
+	}
+
+	req = calloc(1, len);
+	if (req == NULL) {
+		gr_log_err("cannot allocate memory");
+		return ZEBRA_DPLANE_REQUEST_FAILURE;
+	}
+	ret = ZEBRA_DPLANE_REQUEST_FAILURE;
+
+	req->iface_id = iface_id;
+	req->exist_ok = true;
+	req->n_rules = 1;
+	r = &req->rules[0];
+	r->seq = dplane_ctx_rule_get_priority(ctx);
+	r->action = GR_PBR_ACTION_VRF;
+	r->vrf_id = table;
+	r->dscp = GR_ACL_DSCP_ANY;
+	r->sport_max = UINT16_MAX;
+	r->dport_max = UINT16_MAX;
+
+	if (filter & PBR_FILTER_SRC_IP
+	    && rule_prefix_to_gr(dplane_ctx_rule_get_src_ip(ctx), r, &r->src) < 0) {
+		gr_log_err("unsupported rule source prefix");
+		goto out;
+	}
+	if (filter & PBR_FILTER_DST_IP
+	    && rule_prefix_to_gr(dplane_ctx_rule_get_dst_ip(ctx), r, &r->dst) < 0) {
+		gr_log_err("unsupported rule destination prefix");
+		goto out;
+	}
+	if (r->af == GR_AF_UNSPEC)
+		r->af = dplane_ctx_rule_get_family(ctx) == AF_INET6 ? GR_AF_IP6 : GR_AF_IP4;
+	if (filter & PBR_FILTER_IP_PROTOCOL)
+		r->proto = dplane_ctx_rule_get_ipproto(ctx);
+	if (filter & PBR_FILTER_SRC_PORT) {
+		r->sport_min = dplane_ctx_rule_get_src_port(ctx);
+		r->sport_max = r->sport_min;
+	}
+	if (filter & PBR_FILTER_DST_PORT) {
+		r->dport_min = dplane_ctx_rule_get_dst_port(ctx);
+		r->dport_max = r->dport_min;
+	}
+	if (filter & PBR_FILTER_DSCP)
+		r->dscp = (dplane_ctx_rule_get_dsfield(ctx) & PBR_DSFIELD_DSCP) >> 2;
+
+	gr_log_debug("add rule iface %u seq %u vrf %u", iface_id, r->seq, r->vrf_id);
+
+	if (grout_client_send_recv(GR_PBR_RULE_ADD, len, req, NULL) < 0)
+		goto out;
+
+	ret = ZEBRA_DPLANE_REQUEST_SUCCESS;
+out:
+	free(req);
+	return ret;
+}
+
 void grout_nexthop_change(bool new, struct gr_nexthop *gr_nh, bool startup) {
 	struct nexthop *nh = NULL;
 	afi_t afi = AFI_UNSPEC;
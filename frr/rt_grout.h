@@ -12,4 +12,6 @@ void grout_route4_change(bool new, struct gr_ip4_route *gr_r4);
 void grout_route6_change(bool new, struct gr_ip6_route *gr_r6);
 enum zebra_dplane_result grout_add_del_route(struct zebra_dplane_ctx *ctx);
 enum zebra_dplane_result grout_add_del_nexthop(struct zebra_dplane_ctx *ctx);
+enum zebra_dplane_result grout_add_del_lsp(struct zebra_dplane_ctx *ctx);
+enum zebra_dplane_result grout_add_del_rule(struct zebra_dplane_ctx *ctx);
 void grout_nexthop_change(bool new, struct gr_nexthop *gr_nh, bool startup);
@@ -7,6 +7,9 @@
 #include "rt_grout.h"
 
 #include <gr_api_client_impl.h>
+#include <gr_clock.h>
+#include <gr_mpls.h>
+#include <gr_pbr.h>
 #include <gr_srv6.h>
 
 #include <lib/frr_pthread.h>
@@ -29,6 +32,14 @@ struct grout_ctx_t {
 	// Event/'thread' pointer for queued updates
 	struct event *dg_t_zebra_update;
 	struct event *dg_t_dplane_update;
+
+	// Dataplane contexts handed over by zebra, only accessed from the
+	// dplane pthread. Latencies cover the whole grout API round trip.
+	uint64_t processed;
+	// batches that reached the work limit, leaving contexts queued
+	uint64_t backlogged;
+	uint64_t total_us;
+	uint64_t max_us;
 };
 
 static struct grout_ctx_t grout_ctx = {0};
@@ -315,6 +326,14 @@ static const char *gr_req_type_to_str(uint32_t e) {
 		return TOSTRING(GR_NH_ADD);
 	case GR_NH_DEL:
 		return TOSTRING(GR_NH_DEL);
+	case GR_MPLS_ROUTE_ADD:
+		return TOSTRING(GR_MPLS_ROUTE_ADD);
+	case GR_MPLS_ROUTE_DEL:
+		return TOSTRING(GR_MPLS_ROUTE_DEL);
+	case GR_PBR_RULE_ADD:
+		return TOSTRING(GR_PBR_RULE_ADD);
+	case GR_PBR_RULE_DEL:
+		return TOSTRING(GR_PBR_RULE_DEL);
 	case GR_INFRA_IFACE_LIST:
 		return TOSTRING(GR_INFRA_IFACE_LIST);
 	case GR_IP4_ADDR_LIST:
@@ -596,6 +615,16 @@ static enum zebra_dplane_result zd_grout_process_update(struct zebra_dplane_ctx
 	case DPLANE_OP_NH_DELETE:
 		return grout_add_del_nexthop(ctx);
 
+	case DPLANE_OP_LSP_INSTALL:
+	case DPLANE_OP_LSP_UPDATE:
+	case DPLANE_OP_LSP_DELETE:
+		return grout_add_del_lsp(ctx);
+
+	case DPLANE_OP_RULE_ADD:
+	case DPLANE_OP_RULE_UPDATE:
+	case DPLANE_OP_RULE_DELETE:
+		return grout_add_del_rule(ctx);
+
 	case DPLANE_OP_SRV6_ENCAP_SRCADDR_SET:
 		return grout_set_sr_tunsrc(ctx);
 
@@ -608,22 +637,54 @@ static enum zebra_dplane_result zd_grout_process_update(struct zebra_dplane_ctx
 }
 
 static int zd_grout_process(struct zebra_dplane_provider *prov) {
+	clock_t start_us, ctx_start_us, us;
 	struct zebra_dplane_ctx *ctx;
 	enum zebra_dplane_result ret;
+	uint64_t batch_max_us = 0;
 	int counter, limit;
 
 	gr_log_debug("processing %s", dplane_provider_get_name(prov));
 
+	start_us = gr_clock_us();
 	limit = dplane_provider_get_work_limit(prov);
 	for (counter = 0; counter < limit; counter++) {
 		ctx = dplane_provider_dequeue_in_ctx(prov);
 		if (!ctx)
 			break;
 
+		ctx_start_us = gr_clock_us();
 		ret = zd_grout_process_update(ctx);
+		us = gr_clock_us() - ctx_start_us;
 		dplane_ctx_set_status(ctx, ret);
 		dplane_ctx_set_skip_kernel(ctx);
 		dplane_provider_enqueue_out_ctx(prov, ctx);
+
+		grout_ctx.processed++;
+		grout_ctx.total_us += us;
+		if ((uint64_t)us > grout_ctx.max_us)
+			grout_ctx.max_us = us;
+		if ((uint64_t)us > batch_max_us)
+			batch_max_us = us;
+	}
+
+	if (counter == limit)
+		grout_ctx.backlogged++;
+
+	if (counter > 0) {
+		gr_log_debug(
+			"processed %d ctx in %ldus (max %luus)%s",
+			counter,
+			(long)(gr_clock_us() - start_us),
+			batch_max_us,
+			counter == limit ? ", more queued" : ""
+		);
+		gr_log_debug(
+			"total %lu ctx, avg %luus, max %luus, %lu backlogged batches",
+			grout_ctx.processed,
+			grout_ctx.total_us / grout_ctx.processed,
+			grout_ctx.max_us,
+			grout_ctx.backlogged
+		);
 	}
 
 	return 0;
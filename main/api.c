@@ -5,11 +5,13 @@
 #include "module.h"
 
 #include <gr_api.h>
+#include <gr_clock.h>
 #include <gr_config.h>
 #include <gr_event.h>
 #include <gr_log.h>
 #include <gr_macro.h>
 #include <gr_queue.h>
+#include <gr_rcu.h>
 #include <gr_vec.h>
 #include <gr_version.h>
 
@@ -17,22 +19,35 @@
 #include <event2/bufferevent.h>
 #include <event2/event.h>
 #include <event2/listener.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_rcu_qsbr.h>
 
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/un.h>
 #include <unistd.h>
 
+static int socket_cred(int fd, struct ucred *cred) {
+	socklen_t len = sizeof(*cred);
+
+	if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, cred, &len) == -1)
+		return errno_log(errno, "getsockopt(SO_PEERCRED)");
+
+	return 0;
+}
+
 static pid_t socket_pid(int fd) {
 	struct ucred cred;
-	socklen_t len;
+	int ret;
 
-	len = sizeof(cred);
-	if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == -1)
-		return errno_log(errno, "getsockopt(SO_PEERCRED)");
+	if ((ret = socket_cred(fd, &cred)) < 0)
+		return ret;
 
 	return cred.pid;
 }
@@ -226,15 +241,432 @@ static struct gr_api_handler hello_handler = {
 	.name = "hello"
 };
 
+// Latency statistics of all request types handled so far. Only accessed from
+// the main event loop.
+static gr_vec struct gr_api_stat *api_stats;
+
+static unsigned api_stat_index(const struct gr_api_handler *handler) {
+	struct gr_api_stat stat = {.req_type = handler->request_type};
+
+	for (unsigned i = 0; i < gr_vec_len(api_stats); i++) {
+		if (api_stats[i].req_type == handler->request_type)
+			return i;
+	}
+	memccpy(stat.name, handler->name, 0, sizeof(stat.name));
+	stat.name[sizeof(stat.name) - 1] = '\0';
+	gr_vec_add(api_stats, stat);
+
+	return gr_vec_len(api_stats) - 1;
+}
+
+static void latency_add(struct gr_api_latency *l, clock_t start_us, clock_t end_us) {
+	uint64_t us = end_us > start_us ? (uint64_t)(end_us - start_us) : 0;
+	unsigned bucket = us == 0 ? 0 : 64 - __builtin_clzll(us);
+
+	l->count++;
+	l->total_us += us;
+	if (us > l->max_us)
+		l->max_us = us;
+	l->buckets[RTE_MIN(bucket, GR_API_LATENCY_BUCKETS - 1)]++;
+}
+
+struct api_visible {
+	unsigned stat;
+	clock_t end_us;
+	uint64_t token;
+};
+
+// Successful requests waiting for all datapath workers to report a quiescent
+// state. RCU tokens are monotonic, they complete in order.
+static gr_vec struct api_visible *visible_pending;
+static struct event *visible_ev;
+
+#define API_VISIBLE_POLL_US 100
+
+static void visible_poll(void) {
+	struct timeval tv = {.tv_sec = 0, .tv_usec = API_VISIBLE_POLL_US};
+	evtimer_add(visible_ev, &tv);
+}
+
+static void visible_cb(evutil_socket_t, short, void *) {
+	struct rte_rcu_qsbr *rcu = gr_datapath_rcu();
+	clock_t now = gr_clock_us();
+	const struct api_visible *v;
+	unsigned n = 0;
+
+	gr_vec_foreach_ref (v, visible_pending) {
+		if (rte_rcu_qsbr_check(rcu, v->token, false) != 1)
+			break;
+		latency_add(&api_stats[v->stat].visible, v->end_us, now);
+		n++;
+	}
+	gr_vec_del_n(visible_pending, 0, n);
+
+	if (gr_vec_len(visible_pending) > 0)
+		visible_poll();
+}
+
+static void api_stats_add(
+	const struct gr_api_handler *handler,
+	uint32_t status,
+	clock_t recv_us,
+	clock_t start_us,
+	clock_t end_us
+) {
+	unsigned i = api_stat_index(handler);
+	struct gr_api_stat *s = &api_stats[i];
+
+	latency_add(&s->queue, recv_us, start_us);
+	latency_add(&s->handler, start_us, end_us);
+	if (status != 0) {
+		s->errors++;
+		return;
+	}
+	// Background requests are read-only, there is nothing to propagate.
+	if (handler->background || visible_ev == NULL)
+		return;
+
+	struct api_visible v = {
+		.stat = i,
+		.end_us = end_us,
+		.token = rte_rcu_qsbr_start(gr_datapath_rcu()),
+	};
+	gr_vec_add(visible_pending, v);
+	if (gr_vec_len(visible_pending) == 1)
+		visible_poll();
+}
+
+static struct api_out api_stats_get(const void *request, struct api_ctx *) {
+	const struct gr_api_stats_get_req *req = request;
+	struct gr_api_stats_get_resp *resp;
+	uint16_t n = gr_vec_len(api_stats);
+	size_t len = sizeof(*resp) + n * sizeof(*resp->stats);
+	struct gr_api_stat *s;
+
+	if ((resp = malloc(len)) == NULL)
+		return api_out(ENOMEM, 0, NULL);
+
+	resp->n_stats = n;
+	if (n > 0)
+		memcpy(resp->stats, api_stats, n * sizeof(*resp->stats));
+
+	if (req->reset) {
+		gr_vec_foreach_ref (s, api_stats)
+			memset(&s->errors, 0, sizeof(*s) - offsetof(struct gr_api_stat, errors));
+	}
+
+	return api_out(0, len, resp);
+}
+
+static struct gr_api_handler api_stats_get_handler = {
+	.request_type = GR_MAIN_API_STATS_GET,
+	.callback = api_stats_get,
+	.name = "api stats get"
+};
+
+struct api_ring {
+	struct gr_api_ring *shm;
+	size_t size;
+	// Private copies, the shared memory cannot be trusted.
+	uint32_t n_slots;
+	uint32_t req_tail;
+	uint32_t cpl_head;
+	// set while processing requests from the ring
+	bool active;
+	// shared memory object name, unlinked once the client has mapped it
+	char name[MEMBER_SIZE(struct gr_api_ring_open_resp, shm_name)];
+};
+
+static void ring_free(struct api_ring *ring) {
+	if (ring == NULL)
+		return;
+	if (ring->name[0] != '\0')
+		shm_unlink(ring->name);
+	if (ring->shm != NULL)
+		munmap(ring->shm, ring->size);
+	free(ring);
+}
+
+static struct api_out ring_open(const void *request, struct api_ctx *ctx) {
+	const struct gr_api_ring_open_req *req = request;
+	struct gr_api_ring_open_resp *resp = NULL;
+	static unsigned ring_count;
+	struct api_ring *ring;
+	struct ucred cred;
+	int fd = -1;
+	int ret;
+
+	if (ctx->ring != NULL)
+		return api_out(EBUSY, 0, NULL);
+	if (req->n_slots == 0 || req->n_slots > GR_API_RING_MAX_SLOTS
+	    || (req->n_slots & (req->n_slots - 1)) != 0)
+		return api_out(EINVAL, 0, NULL);
+	if (socket_cred(bufferevent_getfd(ctx->bev), &cred) < 0)
+		return api_out(errno, 0, NULL);
+
+	if ((ring = calloc(1, sizeof(*ring))) == NULL)
+		return api_out(ENOMEM, 0, NULL);
+
+	ring->n_slots = req->n_slots;
+	ring->size = gr_api_ring_size(req->n_slots);
+	snprintf(ring->name, sizeof(ring->name), "/grout-ring-%d-%u", ctx->pid, ++ring_count);
+
+	fd = shm_open(ring->name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	if (fd < 0) {
+		ring->name[0] = '\0';
+		goto err;
+	}
+	// The client may not be running as the same user.
+	if (fchown(fd, cred.uid, cred.gid) < 0)
+		goto err;
+	if (ftruncate(fd, ring->size) < 0)
+		goto err;
+	ring->shm = mmap(NULL, ring->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (ring->shm == MAP_FAILED) {
+		ring->shm = NULL;
+		goto err;
+	}
+	close(fd);
+	fd = -1;
+
+	ring->shm->n_slots = ring->n_slots;
+
+	if ((resp = calloc(1, sizeof(*resp))) == NULL)
+		goto err;
+	memccpy(resp->shm_name, ring->name, 0, sizeof(resp->shm_name));
+	resp->n_slots = ring->n_slots;
+	ctx->ring = ring;
+
+	LOG(INFO,
+	    "client pid=%d opened request ring %s (%u slots)",
+	    ctx->pid,
+	    ring->name,
+	    ring->n_slots);
+
+	return api_out(0, sizeof(*resp), resp);
+err:
+	ret = errno;
+	if (fd >= 0)
+		close(fd);
+	ring_free(ring);
+	return api_out(ret, 0, NULL);
+}
+
+static struct gr_api_handler ring_open_handler = {
+	.request_type = GR_MAIN_RING_OPEN,
+	.callback = ring_open,
+	.name = "ring open"
+};
+
+static uint32_t ring_dispatch(struct api_ctx *ctx, const struct gr_api_ring_req *req) {
+	const struct gr_api_handler *handler;
+	struct gr_api_request header = {
+		.id = req->id,
+		.type = req->type,
+		.payload_len = req->payload_len,
+	};
+	clock_t start_us;
+	struct api_out out;
+
+	if (req->payload_len > sizeof(req->payload))
+		return EMSGSIZE;
+	// Ring management requests cannot be nested.
+	if (((req->type >> 16) & 0xffff) == GR_MAIN_MODULE)
+		return ENOTSUP;
+	if ((handler = lookup_api_handler(&header)) == NULL)
+		return ENOTSUP;
+
+	start_us = gr_clock_us();
+	out = handler->callback(req->payload_len > 0 ? req->payload : NULL, ctx);
+	free(out.payload);
+	// Queue time is measured from the reception of the kick message.
+	api_stats_add(handler, out.status, ctx->recv_us, start_us, gr_clock_us());
+
+	LOG(DEBUG,
+	    "pid=%d ring id=%u req_type=0x%08x (%s) req_len=%u status=%d (%s)",
+	    ctx->pid,
+	    req->id,
+	    req->type,
+	    handler->name,
+	    req->payload_len,
+	    out.status,
+	    strerror(out.status));
+
+	return out.status;
+}
+
+static struct api_out ring_kick(const void * /*request*/, struct api_ctx *ctx) {
+	struct gr_api_ring_kick_resp *resp;
+	struct api_ring *ring = ctx->ring;
+	struct gr_api_ring_cpl *cpls;
+	uint32_t head, cpl_tail, mask;
+	struct gr_api_ring_req req;
+	struct gr_api_ring *shm;
+	uint32_t processed = 0;
+
+	if (ring == NULL)
+		return api_out(ENOTCONN, 0, NULL);
+
+	if (ring->name[0] != '\0') {
+		// The client has mapped the ring, it is not needed anymore.
+		shm_unlink(ring->name);
+		ring->name[0] = '\0';
+	}
+
+	if ((resp = malloc(sizeof(*resp))) == NULL)
+		return api_out(ENOMEM, 0, NULL);
+
+	shm = ring->shm;
+	cpls = gr_api_ring_cpls(shm, ring->n_slots);
+	mask = ring->n_slots - 1;
+	head = __atomic_load_n(&shm->req_head, __ATOMIC_ACQUIRE);
+	cpl_tail = __atomic_load_n(&shm->cpl_tail, __ATOMIC_ACQUIRE);
+
+	if (head - ring->req_tail > ring->n_slots || ring->cpl_head - cpl_tail > ring->n_slots) {
+		free(resp);
+		return api_out(EBADMSG, 0, NULL);
+	}
+
+	ring->active = true;
+	while (ring->req_tail != head && ring->cpl_head - cpl_tail < ring->n_slots) {
+		// Copy the request, the client may modify the shared memory at any time.
+		memcpy(&req, &shm->reqs[ring->req_tail & mask], sizeof(req));
+		cpls[ring->cpl_head & mask] = (struct gr_api_ring_cpl) {
+			.for_id = req.id,
+			.status = ring_dispatch(ctx, &req),
+		};
+		ring->req_tail++;
+		ring->cpl_head++;
+		processed++;
+	}
+	ring->active = false;
+
+	__atomic_store_n(&shm->req_tail, ring->req_tail, __ATOMIC_RELEASE);
+	__atomic_store_n(&shm->cpl_head, ring->cpl_head, __ATOMIC_RELEASE);
+
+	resp->processed = processed;
+
+	return api_out(0, sizeof(*resp), resp);
+}
+
+static struct gr_api_handler ring_kick_handler = {
+	.request_type = GR_MAIN_RING_KICK,
+	.callback = ring_kick,
+	.name = "ring kick"
+};
+
+// Number of control threads that process background requests.
+#define API_BG_THREADS 2
+
+struct api_job {
+	STAILQ_ENTRY(api_job) next;
+	struct api_ctx *ctx;
+	const struct gr_api_handler *handler;
+	void *req_payload;
+	struct api_out out;
+	clock_t start_us;
+	clock_t end_us;
+};
+
+STAILQ_HEAD(api_jobs, api_job);
+
+static pthread_mutex_t bg_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t bg_cond = PTHREAD_COND_INITIALIZER;
+static struct api_jobs bg_pending = STAILQ_HEAD_INITIALIZER(bg_pending);
+static struct api_jobs bg_done = STAILQ_HEAD_INITIALIZER(bg_done);
+static pthread_t bg_threads[API_BG_THREADS];
+static unsigned bg_threads_count;
+static struct event *bg_done_ev;
+static bool bg_shutdown;
+static __thread bool bg_thread;
+
+void api_quiescent(void) {
+	if (bg_thread)
+		rte_rcu_qsbr_quiescent(gr_datapath_rcu(), rte_lcore_id());
+}
+
+static void *bg_thread_main(void *) {
+	struct rte_rcu_qsbr *rcu = gr_datapath_rcu();
+	struct api_job *job;
+
+	pthread_setname_np(pthread_self(), "grout:api-bg");
+
+	if (rte_thread_register() < 0) {
+		LOG(ERR, "rte_thread_register: %s", rte_strerror(rte_errno));
+		return NULL;
+	}
+	rte_rcu_qsbr_thread_register(rcu, rte_lcore_id());
+	bg_thread = true;
+
+	pthread_mutex_lock(&bg_lock);
+	for (;;) {
+		while (!bg_shutdown && STAILQ_EMPTY(&bg_pending))
+			pthread_cond_wait(&bg_cond, &bg_lock);
+		if (bg_shutdown)
+			break;
+		job = STAILQ_FIRST(&bg_pending);
+		STAILQ_REMOVE_HEAD(&bg_pending, next);
+		pthread_mutex_unlock(&bg_lock);
+
+		// Control plane objects are only freed after all online readers
+		// have reported a quiescent state.
+		rte_rcu_qsbr_thread_online(rcu, rte_lcore_id());
+		job->start_us = gr_clock_us();
+		job->out = job->handler->callback(job->req_payload, job->ctx);
+		job->end_us = gr_clock_us();
+		rte_rcu_qsbr_thread_offline(rcu, rte_lcore_id());
+
+		pthread_mutex_lock(&bg_lock);
+		STAILQ_INSERT_TAIL(&bg_done, job, next);
+		event_active(bg_done_ev, 0, 0);
+	}
+	pthread_mutex_unlock(&bg_lock);
+
+	rte_rcu_qsbr_thread_unregister(rcu, rte_lcore_id());
+	rte_thread_unregister();
+
+	return NULL;
+}
+
+static void bg_submit(struct api_ctx *ctx, const struct gr_api_handler *handler, void *payload) {
+	struct api_job *job = calloc(1, sizeof(*job));
+	if (job == NULL)
+		ABORT("calloc(api_job)");
+
+	job->ctx = ctx;
+	job->handler = handler;
+	job->req_payload = payload;
+	ctx->job = job;
+
+	// Responses must not be interleaved, stop reading requests from this
+	// client until the background request is complete.
+	bufferevent_disable(ctx->bev, EV_READ);
+
+	pthread_mutex_lock(&bg_lock);
+	STAILQ_INSERT_TAIL(&bg_pending, job, next);
+	pthread_cond_signal(&bg_cond);
+	pthread_mutex_unlock(&bg_lock);
+}
+
 static void disconnect_client(struct api_ctx *ctx) {
 	assert(ctx != NULL);
 	assert(ctx->bev != NULL);
 
-	LIST_REMOVE(ctx, next);
-
-	LOG(DEBUG, "client pid=%d disconnected", ctx->pid);
+	if (!ctx->closing) {
+		LIST_REMOVE(ctx, next);
+		LOG(DEBUG, "client pid=%d disconnected", ctx->pid);
+		unsubscribe(NULL, ctx);
+		ring_free(ctx->ring);
+		ctx->ring = NULL;
+	}
+	if (ctx->job != NULL) {
+		// A background thread may still be writing to the buffer event.
+		// It is freed when the request completes.
+		bufferevent_disable(ctx->bev, EV_READ | EV_WRITE);
+		ctx->closing = true;
+		return;
+	}
 
-	unsubscribe(NULL, ctx);
 	bufferevent_free(ctx->bev);
 	free(ctx);
 }
@@ -244,6 +676,11 @@ void api_send(struct api_ctx *ctx, uint32_t len, const void *payload) {
 	assert(len != 0);
 	assert(payload != NULL);
 
+	if (ctx->ring != NULL && ctx->ring->active) {
+		LOG(ERR, "pid=%d streaming responses are not supported in request rings", ctx->pid);
+		return;
+	}
+
 	LOG(DEBUG, "pid=%d for_id=%u len=%u", ctx->pid, ctx->header.id, len);
 
 	struct gr_api_response resp = {
@@ -257,10 +694,82 @@ void api_send(struct api_ctx *ctx, uint32_t len, const void *payload) {
 		LOG(ERR, "pid=%d cannot write payload", ctx->pid);
 }
 
+static void api_respond(
+	struct api_ctx *ctx,
+	const struct gr_api_handler *handler,
+	struct api_out out
+) {
+	struct evbuffer *input = bufferevent_get_input(ctx->bev);
+
+	LOG(DEBUG,
+	    "pid=%d id=%u req_type=0x%08x (%s) req_len=%u status=%d (%s) resp_len=%u",
+	    ctx->pid,
+	    ctx->header.id,
+	    ctx->header.type,
+	    handler ? handler->name : "?",
+	    ctx->header.payload_len,
+	    out.status,
+	    strerror(out.status),
+	    out.len);
+
+	struct gr_api_response resp = {
+		.for_id = ctx->header.id,
+		.status = out.status,
+		.payload_len = out.len,
+	};
+
+	if (bufferevent_write(ctx->bev, &resp, sizeof(resp)) < 0)
+		LOG(ERR, "failed to write header");
+	if (out.len > 0) {
+		assert(out.payload != NULL);
+		if (bufferevent_write(ctx->bev, out.payload, out.len) < 0)
+			LOG(ERR, "failed to write payload");
+	}
+
+	bufferevent_flush(ctx->bev, EV_WRITE, BEV_FLUSH);
+
+	free(out.payload);
+
+	if (evbuffer_get_length(input) >= sizeof(ctx->header)) {
+		// More data is available in the input buffer.
+		// Force read_cb to be invoked again when possible.
+		bufferevent_flush(ctx->bev, EV_READ, BEV_NORMAL);
+	}
+}
+
+static void bg_done_cb(evutil_socket_t, short, void *) {
+	struct api_jobs done = STAILQ_HEAD_INITIALIZER(done);
+	struct api_ctx *ctx;
+	struct api_job *job;
+
+	pthread_mutex_lock(&bg_lock);
+	STAILQ_CONCAT(&done, &bg_done);
+	pthread_mutex_unlock(&bg_lock);
+
+	while ((job = STAILQ_FIRST(&done)) != NULL) {
+		STAILQ_REMOVE_HEAD(&done, next);
+		ctx = job->ctx;
+		ctx->job = NULL;
+		api_stats_add(
+			job->handler, job->out.status, ctx->recv_us, job->start_us, job->end_us
+		);
+		if (ctx->closing) {
+			free(job->out.payload);
+			disconnect_client(ctx);
+		} else {
+			bufferevent_enable(ctx->bev, EV_READ);
+			api_respond(ctx, job->handler, job->out);
+		}
+		free(job->req_payload);
+		free(job);
+	}
+}
+
 static void read_cb(struct bufferevent *bev, void *priv) {
 	struct evbuffer *input = bufferevent_get_input(bev);
 	struct api_ctx *ctx = priv;
 	void *req_payload = NULL;
+	clock_t start_us;
 
 	assert(ctx != NULL);
 
@@ -280,6 +789,7 @@ static void read_cb(struct bufferevent *bev, void *priv) {
 			goto close;
 		}
 
+		ctx->recv_us = gr_clock_us();
 		ctx->header_complete = true;
 	}
 
@@ -313,46 +823,20 @@ static void read_cb(struct bufferevent *bev, void *priv) {
 		goto send;
 	}
 
+	if (handler->background) {
+		bg_submit(ctx, handler, req_payload);
+		return;
+	}
+
 	cur_req_pid = ctx->pid;
+	start_us = gr_clock_us();
 	out = handler->callback(req_payload, ctx);
+	api_stats_add(handler, out.status, ctx->recv_us, start_us, gr_clock_us());
 	cur_req_pid = 0;
 
 send:
-	LOG(DEBUG,
-	    "pid=%d id=%u req_type=0x%08x (%s) req_len=%u status=%d (%s) resp_len=%u",
-	    ctx->pid,
-	    ctx->header.id,
-	    ctx->header.type,
-	    handler ? handler->name : "?",
-	    ctx->header.payload_len,
-	    out.status,
-	    strerror(out.status),
-	    out.len);
-
-	struct gr_api_response resp = {
-		.for_id = ctx->header.id,
-		.status = out.status,
-		.payload_len = out.len,
-	};
-
-	if (bufferevent_write(bev, &resp, sizeof(resp)) < 0)
-		LOG(ERR, "failed to write header");
-	if (out.len > 0) {
-		assert(out.payload != NULL);
-		if (bufferevent_write(bev, out.payload, out.len) < 0)
-			LOG(ERR, "failed to write payload");
-	}
-
-	bufferevent_flush(bev, EV_WRITE, BEV_FLUSH);
-
+	api_respond(ctx, handler, out);
 	free(req_payload);
-	free(out.payload);
-
-	if (evbuffer_get_length(input) >= sizeof(ctx->header)) {
-		// More data is available in the input buffer.
-		// Force read_cb to be invoked again when possible.
-		bufferevent_flush(bev, EV_READ, BEV_NORMAL);
-	}
 	return;
 
 close:
@@ -385,7 +869,8 @@ static void accept_conn_cb(
 	struct bufferevent *bev;
 	struct api_ctx *ctx;
 
-	bev = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE);
+	// Background requests stream their responses from other threads.
+	bev = bufferevent_socket_new(base, fd, BEV_OPT_CLOSE_ON_FREE | BEV_OPT_THREADSAFE);
 	if (bev == NULL) {
 		LOG(ERR, "failed to create bufferevent for fd=%d", fd);
 		close(fd);
@@ -482,6 +967,20 @@ int api_socket_start(struct event_base *base) {
 
 	LOG(INFO, "listening on API socket %s", path);
 
+	bg_done_ev = event_new(base, -1, EV_PERSIST | EV_FINALIZE, bg_done_cb, NULL);
+	if (bg_done_ev == NULL)
+		return errno_log(errno, "event_new");
+
+	visible_ev = evtimer_new(base, visible_cb, NULL);
+	if (visible_ev == NULL)
+		return errno_log(errno, "evtimer_new");
+
+	for (bg_threads_count = 0; bg_threads_count < API_BG_THREADS; bg_threads_count++) {
+		ret = pthread_create(&bg_threads[bg_threads_count], NULL, bg_thread_main, NULL);
+		if (ret != 0)
+			return errno_log(ret, "pthread_create");
+	}
+
 	return 0;
 }
 
@@ -492,6 +991,37 @@ void api_socket_stop(struct event_base *) {
 		listener = NULL;
 	}
 
+	// Wait for background requests to complete.
+	pthread_mutex_lock(&bg_lock);
+	bg_shutdown = true;
+	pthread_cond_broadcast(&bg_cond);
+	pthread_mutex_unlock(&bg_lock);
+	for (unsigned i = 0; i < bg_threads_count; i++)
+		pthread_join(bg_threads[i], NULL);
+	bg_threads_count = 0;
+
+	struct api_job *job;
+	STAILQ_CONCAT(&bg_done, &bg_pending);
+	while ((job = STAILQ_FIRST(&bg_done)) != NULL) {
+		STAILQ_REMOVE_HEAD(&bg_done, next);
+		job->ctx->job = NULL;
+		if (job->ctx->closing)
+			disconnect_client(job->ctx);
+		free(job->out.payload);
+		free(job->req_payload);
+		free(job);
+	}
+	if (bg_done_ev != NULL) {
+		event_free(bg_done_ev);
+		bg_done_ev = NULL;
+	}
+	if (visible_ev != NULL) {
+		event_free(visible_ev);
+		visible_ev = NULL;
+	}
+	gr_vec_free(visible_pending);
+	gr_vec_free(api_stats);
+
 	// Gracefully disconnect all clients.
 	struct api_ctx *ctx, *tmp;
 	LIST_FOREACH_SAFE (ctx, &clients, next, tmp)
@@ -509,4 +1039,7 @@ RTE_INIT(init) {
 	gr_register_api_handler(&subscribe_handler);
 	gr_register_api_handler(&unsubscribe_handler);
 	gr_register_api_handler(&hello_handler);
+	gr_register_api_handler(&ring_open_handler);
+	gr_register_api_handler(&ring_kick_handler);
+	gr_register_api_handler(&api_stats_get_handler);
 }
@@ -141,6 +141,8 @@ int dpdk_init(void) {
 	gr_vec_add(eal_args, "0000:00:00.0");
 
 	if (gr_config.test_mode) {
+		if (gr_config.file_prefix != NULL)
+			LOG(WARNING, "--file-prefix is ignored in test mode");
 		gr_vec_add(eal_args, "--no-shconf");
 		gr_vec_add(eal_args, "--no-huge");
 		gr_vec_add(eal_args, "-m");
@@ -148,6 +150,11 @@ int dpdk_init(void) {
 			gr_vec_add(eal_args, "4096");
 		else
 			gr_vec_add(eal_args, "2048");
+	} else if (gr_config.file_prefix != NULL) {
+		// Keep the runtime config and hugepage files so that secondary
+		// processes can attach to the exported memory zones.
+		gr_vec_add(eal_args, "--file-prefix");
+		gr_vec_add(eal_args, (char *)gr_config.file_prefix);
 	} else {
 		gr_vec_add(eal_args, "--in-memory");
 	}
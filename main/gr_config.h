@@ -15,8 +15,10 @@ struct gr_config {
 	uid_t api_sock_uid;
 	gid_t api_sock_gid;
 	mode_t api_sock_mode;
+	const char *file_prefix; //!< NULL if memory is not shared with secondary processes
 	unsigned log_level;
 	unsigned max_mtu;
+	unsigned mbuf_leak_timeout; //!< seconds, 0 if mbuf leak detection is disabled
 	bool test_mode;
 	bool poll_mode;
 	bool log_syslog;
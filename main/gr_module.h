@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <sys/queue.h>
+#include <time.h>
 
 struct api_out {
 	uint32_t status;
@@ -22,22 +23,42 @@ static inline struct api_out api_out(uint32_t status, uint32_t len, void *payloa
 	return out;
 }
 
+struct api_ring;
+struct api_job;
+
 struct api_ctx {
 	struct gr_api_request header;
 	bool header_complete;
+	// time at which the request header was received, in microseconds
+	clock_t recv_us;
 	struct bufferevent *bev;
 	pid_t pid;
+	// shared memory request ring, NULL if not opened by the client
+	struct api_ring *ring;
+	// background request in progress, NULL if none
+	struct api_job *job;
+	// disconnected while a background request was in progress
+	bool closing;
 	LIST_ENTRY(api_ctx) next;
 };
 
 void api_send(struct api_ctx *, uint32_t len, const void *payload);
 
+// Report a quiescent state from a background API handler. The caller must not
+// hold references to RCU protected objects. No-op on the main event loop.
+void api_quiescent(void);
+
 typedef struct api_out (*gr_api_handler_func)(const void *request, struct api_ctx *);
 
 struct gr_api_handler {
 	const char *name;
 	uint32_t request_type;
 	gr_api_handler_func callback;
+	// Run the callback on a background control thread instead of the main
+	// event loop. Only for long running read-only requests. The callback is
+	// invoked as a datapath RCU reader and may call api_send() to stream its
+	// response. It must not modify any control plane state.
+	bool background;
 	STAILQ_ENTRY(gr_api_handler) next;
 };
 
@@ -35,6 +35,7 @@ static void usage(void) {
 	printf("Usage: grout");
 	printf(" [-B SIZE]");
 	printf(" [-D PATH]");
+	printf(" [-F PREFIX]");
 	printf(" [-L TYPE:LEVEL]");
 	printf(" [-M MODE]");
 	printf(" [-S]");
@@ -42,6 +43,7 @@ static void usage(void) {
 	printf(" [-V]");
 	printf(" [-h]");
 	printf("\n            ");
+	printf(" [-l SECONDS]");
 	printf(" [-m PERMISSIONS]");
 	printf(" [-o USER:GROUP]");
 	printf(" [-p]");
@@ -57,12 +59,14 @@ static void usage(void) {
 	puts("options:");
 	puts("  -B, --trace-bufsz SIZE         Maximum size of allocated memory for trace output.");
 	puts("  -D, --trace-dir PATH           Change path for trace output.");
+	puts("  -F, --file-prefix PREFIX       Share memory with secondary processes.");
 	puts("  -L, --log-level TYPE:LEVEL     Specify log level for a specific component.");
 	puts("  -M, --trace-mode MODE          Specify the mode of update of trace output file.");
 	puts("  -S, --syslog                   Redirect logs to syslog.");
 	puts("  -T, --trace REGEXO             Enable trace matching the regular expression.");
 	puts("  -V, --version                  Print version and exit.");
 	puts("  -h, --help                     Display this help message and exit.");
+	puts("  -l, --mbuf-leak-timeout SECS   Report packets held longer than SECS (debug).");
 	puts("  -m, --socket-mode PERMISSIONS  API socket file permissions (Default: 0660).");
 	puts("  -o, --socket-owner USER:GROUP  API socket file ownership");
 	puts("  -p, --poll-mode                Disable automatic micro-sleep.");
@@ -144,11 +148,13 @@ static int parse_sock_owner(char *user_group_str) {
 static int parse_args(int argc, char **argv) {
 	int c;
 
-#define FLAGS ":B:D:L:M:T:Vhm:o:pSs:tu:vx"
+#define FLAGS ":B:D:F:L:M:T:Vhl:m:o:pSs:tu:vx"
 	static struct option long_options[] = {
+		{"file-prefix", required_argument, NULL, 'F'},
 		{"help", no_argument, NULL, 'h'},
 		{"log-level", required_argument, NULL, 'L'},
 		{"max-mtu", required_argument, NULL, 'u'},
+		{"mbuf-leak-timeout", required_argument, NULL, 'l'},
 		{"poll-mode", no_argument, NULL, 'p'},
 		{"socket", required_argument, NULL, 's'},
 		{"socket-mode", required_argument, NULL, 'm'},
@@ -179,6 +185,9 @@ static int parse_args(int argc, char **argv) {
 
 	while ((c = getopt_long(argc, argv, FLAGS, long_options, NULL)) != -1) {
 		switch (c) {
+		case 'F':
+			gr_config.file_prefix = optarg;
+			break;
 		case 'h':
 			usage();
 			exit(EXIT_SUCCESS);
@@ -187,6 +196,10 @@ static int parse_args(int argc, char **argv) {
 			gr_vec_add(gr_config.eal_extra_args, "--log-level");
 			gr_vec_add(gr_config.eal_extra_args, optarg);
 			break;
+		case 'l':
+			if (parse_uint(&gr_config.mbuf_leak_timeout, optarg, 10, 1, 3600) < 0)
+				return perr("--mbuf-leak-timeout: %s", strerror(errno));
+			break;
 		case 'm':
 			if (parse_uint(&gr_config.api_sock_mode, optarg, 8, 0, 07777) < 0)
 				return perr("--socket-mode: %s", strerror(errno));
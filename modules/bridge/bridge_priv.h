@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_bridge.h>
+#include <gr_clock.h>
+#include <gr_iface.h>
+#include <gr_macro.h>
+
+#include <rte_ether.h>
+#include <rte_hash.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Member interfaces used by the datapath for flooding. The whole object is
+// replaced by the control plane and freed after an RCU grace period.
+struct bridge_members {
+	uint16_t count;
+	const struct iface *ifaces[GR_BRIDGE_MAX_MEMBERS];
+};
+
+GR_IFACE_INFO(GR_IFACE_TYPE_BRIDGE, iface_info_bridge, {
+	BASE(gr_iface_info_bridge);
+
+	_Atomic(const struct bridge_members *) flood;
+});
+
+struct fdb_key {
+	uint16_t bridge_id;
+	struct rte_ether_addr mac;
+};
+
+struct fdb_entry {
+	// GR_IFACE_ID_UNDEF while the slot is not in use.
+	_Atomic(uint16_t) iface_id;
+	gr_fdb_flags_t flags;
+	_Atomic(clock_t) last_seen;
+};
+
+// Forwarding database shared by all bridges.
+//
+// Entries are stored in a lock-free hash which is written concurrently by all
+// datapath workers when learning source addresses. The hash does not store any
+// data. The key position returned by the hash is used as index in the entries
+// array. Two workers learning the same address at the same time get the same
+// position and no object is leaked.
+//
+// Key positions are only recycled by the control plane after an RCU grace
+// period. This allows ageing and flushing entries in bulk with only one RCU
+// synchronization.
+struct fdb {
+	struct rte_hash *hash;
+	uint32_t max_count;
+	uint32_t n_entries;
+	struct fdb_entry entries[/* n_entries */];
+};
+
+extern _Atomic(struct fdb *) bridge_fdb;
+
+// Learned entries are refreshed at most once per second to avoid bouncing
+// cache lines between workers.
+#define FDB_REFRESH_PERIOD CLOCKS_PER_SEC
+
+static inline void fdb_learn(
+	struct fdb *fdb,
+	const struct fdb_key *key,
+	int32_t pos,
+	uint16_t iface_id,
+	clock_t now
+) {
+	uint16_t cur_id = GR_IFACE_ID_UNDEF;
+	struct fdb_entry *e;
+
+	if (pos < 0) {
+		// Unknown source address, learn it.
+		pos = rte_hash_add_key(fdb->hash, key);
+		if (unlikely(pos < 0))
+			return; // table full
+		e = &fdb->entries[pos];
+		atomic_store_explicit(&e->last_seen, now, memory_order_relaxed);
+		// Another worker or the control plane may have won the race.
+		atomic_compare_exchange_strong_explicit(
+			&e->iface_id, &cur_id, iface_id, memory_order_release, memory_order_relaxed
+		);
+		return;
+	}
+
+	e = &fdb->entries[pos];
+	if (e->flags & GR_FDB_F_STATIC)
+		return;
+	if (atomic_load_explicit(&e->iface_id, memory_order_relaxed) != iface_id) {
+		// Address moved to another port.
+		atomic_store_explicit(&e->iface_id, iface_id, memory_order_release);
+	}
+	if (now - atomic_load_explicit(&e->last_seen, memory_order_relaxed) > FDB_REFRESH_PERIOD)
+		atomic_store_explicit(&e->last_seen, now, memory_order_relaxed);
+}
+
+// Return the interface associated to a lookup result or NULL if unknown.
+static inline const struct iface *fdb_iface(struct fdb *fdb, int32_t pos) {
+	uint16_t iface_id;
+
+	if (pos < 0)
+		return NULL;
+
+	iface_id = atomic_load_explicit(&fdb->entries[pos].iface_id, memory_order_acquire);
+
+	return iface_from_id(iface_id);
+}
+
+// Remove all learned entries of a bridge and/or interface.
+void fdb_flush(uint16_t bridge_id, uint16_t iface_id);
+
+// Update the member list of all bridges.
+// Must be called whenever an interface is attached or detached from a bridge.
+void bridge_members_update(const struct iface *removed);
+
+struct trace_bridge_data {
+	uint16_t bridge_id;
+	uint16_t iface_id;
+};
+
+int trace_bridge_format(char *buf, size_t len, const void *data, size_t data_len);
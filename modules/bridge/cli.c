@@ -0,0 +1,419 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_bridge.h>
+#include <gr_cli.h>
+#include <gr_cli_iface.h>
+#include <gr_clock.h>
+#include <gr_net_types.h>
+#include <gr_table.h>
+
+#include <ecoli.h>
+#include <libsmartcols.h>
+
+#include <errno.h>
+
+static void bridge_show(struct gr_api_client *c, const struct gr_iface *iface) {
+	const struct gr_iface_info_bridge *br = (const struct gr_iface_info_bridge *)iface->info;
+
+	printf("mac: " ETH_F "\n", &br->mac);
+	printf("ageing_time: %u\n", br->ageing_time);
+	printf("members:");
+	for (uint16_t i = 0; i < br->n_members; i++) {
+		struct gr_iface *member = iface_from_id(c, br->members[i]);
+		if (member != NULL)
+			printf(" %s", member->name);
+		else
+			printf(" %u", br->members[i]);
+		free(member);
+	}
+	printf("\n");
+}
+
+static void
+bridge_list_info(struct gr_api_client *, const struct gr_iface *iface, char *buf, size_t len) {
+	const struct gr_iface_info_bridge *br = (const struct gr_iface_info_bridge *)iface->info;
+
+	snprintf(buf, len, "mac=" ETH_F " members=%u", &br->mac, br->n_members);
+}
+
+static struct cli_iface_type bridge_type = {
+	.type_id = GR_IFACE_TYPE_BRIDGE,
+	.show = bridge_show,
+	.list_info = bridge_list_info,
+};
+
+static uint64_t parse_bridge_args(
+	struct gr_api_client *c,
+	const struct ec_pnode *p,
+	struct gr_iface *iface,
+	bool update
+) {
+	struct gr_iface_info_bridge *br;
+	uint64_t set_attrs;
+
+	set_attrs = parse_iface_args(c, p, iface, sizeof(*br), update);
+
+	br = (struct gr_iface_info_bridge *)iface->info;
+
+	if (arg_u16(p, "AGEING", &br->ageing_time) < 0) {
+		if (errno != ENOENT)
+			return 0;
+	} else {
+		set_attrs |= GR_BRIDGE_SET_AGEING_TIME;
+	}
+
+	if (arg_eth_addr(p, "MAC", &br->mac) < 0) {
+		if (errno != ENOENT)
+			return 0;
+	} else {
+		set_attrs |= GR_BRIDGE_SET_MAC;
+	}
+
+	if (set_attrs == 0)
+		errno = EINVAL;
+	return set_attrs;
+}
+
+static cmd_status_t bridge_add(struct gr_api_client *c, const struct ec_pnode *p) {
+	const struct gr_infra_iface_add_resp *resp;
+	struct gr_infra_iface_add_req *req = NULL;
+	void *resp_ptr = NULL;
+	size_t len;
+
+	len = sizeof(*req) + sizeof(struct gr_iface_info_bridge);
+	if ((req = calloc(1, len)) == NULL)
+		goto err;
+
+	req->iface.type = GR_IFACE_TYPE_BRIDGE;
+	req->iface.flags = GR_IFACE_F_UP;
+
+	if (parse_bridge_args(c, p, &req->iface, false) == 0)
+		goto err;
+
+	if (gr_api_client_send_recv(c, GR_INFRA_IFACE_ADD, len, req, &resp_ptr) < 0)
+		goto err;
+
+	free(req);
+	resp = resp_ptr;
+	printf("Created interface %u\n", resp->iface_id);
+	free(resp_ptr);
+	return CMD_SUCCESS;
+err:
+	free(req);
+	return CMD_ERROR;
+}
+
+static cmd_status_t bridge_set(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_infra_iface_set_req *req = NULL;
+	cmd_status_t ret = CMD_ERROR;
+	size_t len;
+
+	len = sizeof(*req) + sizeof(struct gr_iface_info_bridge);
+	if ((req = calloc(1, len)) == NULL)
+		goto out;
+
+	if ((req->set_attrs = parse_bridge_args(c, p, &req->iface, true)) == 0)
+		goto out;
+
+	if (gr_api_client_send_recv(c, GR_INFRA_IFACE_SET, len, req, NULL) < 0)
+		goto out;
+
+	ret = CMD_SUCCESS;
+out:
+	free(req);
+	return ret;
+}
+
+static cmd_status_t fdb_add(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_bridge_fdb_add_req req = {.exist_ok = true};
+	struct gr_iface *iface;
+
+	if (arg_eth_addr(p, "MAC", &req.fdb.mac) < 0)
+		return CMD_ERROR;
+	if ((iface = iface_from_name(c, arg_str(p, "IFACE"))) == NULL)
+		return CMD_ERROR;
+	req.fdb.iface_id = iface->id;
+	free(iface);
+
+	if (gr_api_client_send_recv(c, GR_BRIDGE_FDB_ADD, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t fdb_del(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_bridge_fdb_del_req req = {.missing_ok = true};
+	struct gr_iface *bridge;
+
+	if (arg_eth_addr(p, "MAC", &req.mac) < 0)
+		return CMD_ERROR;
+	if ((bridge = iface_from_name(c, arg_str(p, "BRIDGE"))) == NULL)
+		return CMD_ERROR;
+	req.bridge_id = bridge->id;
+	free(bridge);
+
+	if (gr_api_client_send_recv(c, GR_BRIDGE_FDB_DEL, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static int parse_fdb_filter(
+	struct gr_api_client *c,
+	const struct ec_pnode *p,
+	uint16_t *bridge_id,
+	uint16_t *iface_id
+) {
+	struct gr_iface *iface;
+
+	*bridge_id = GR_IFACE_ID_UNDEF;
+	if (arg_str(p, "BRIDGE") != NULL) {
+		if ((iface = iface_from_name(c, arg_str(p, "BRIDGE"))) == NULL)
+			return -errno;
+		*bridge_id = iface->id;
+		free(iface);
+	}
+	if (iface_id == NULL)
+		return 0;
+
+	*iface_id = GR_IFACE_ID_UNDEF;
+	if (arg_str(p, "IFACE") != NULL) {
+		if ((iface = iface_from_name(c, arg_str(p, "IFACE"))) == NULL)
+			return -errno;
+		*iface_id = iface->id;
+		free(iface);
+	}
+
+	return 0;
+}
+
+static cmd_status_t fdb_list(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_bridge_fdb_list_req req;
+	const struct gr_fdb_entry *fdb;
+	struct libscols_table *table;
+	struct gr_iface *iface;
+	clock_t now;
+	int ret;
+
+	if (parse_fdb_filter(c, p, &req.bridge_id, NULL) < 0)
+		return CMD_ERROR;
+
+	table = scols_new_table();
+	scols_table_new_column(table, "BRIDGE", 0, 0);
+	scols_table_new_column(table, "MAC", 0, 0);
+	scols_table_new_column(table, "IFACE", 0, 0);
+	scols_table_new_column(table, "FLAGS", 0, 0);
+	scols_table_new_column(table, "AGE", 0, SCOLS_FL_RIGHT);
+	scols_table_set_column_separator(table, "  ");
+
+	now = gr_clock_us();
+
+	gr_api_client_stream_foreach (fdb, ret, c, GR_BRIDGE_FDB_LIST, sizeof(req), &req) {
+		struct libscols_line *line = scols_table_new_line(table, NULL);
+
+		if ((iface = iface_from_id(c, fdb->bridge_id)) != NULL)
+			scols_line_sprintf(line, 0, "%s", iface->name);
+		else
+			scols_line_sprintf(line, 0, "%u", fdb->bridge_id);
+		free(iface);
+
+		scols_line_sprintf(line, 1, ETH_F, &fdb->mac);
+
+		if ((iface = iface_from_id(c, fdb->iface_id)) != NULL)
+			scols_line_sprintf(line, 2, "%s", iface->name);
+		else
+			scols_line_sprintf(line, 2, "%u", fdb->iface_id);
+		free(iface);
+
+		if (fdb->flags & GR_FDB_F_STATIC) {
+			scols_line_set_data(line, 3, "static");
+		} else {
+			scols_line_set_data(line, 3, "learned");
+			scols_line_sprintf(line, 4, "%lu", (now - fdb->last_seen) / CLOCKS_PER_SEC);
+		}
+	}
+
+	scols_print_table(table);
+	scols_unref_table(table);
+
+	return ret < 0 ? CMD_ERROR : CMD_SUCCESS;
+}
+
+static cmd_status_t fdb_flush(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_bridge_fdb_flush_req req;
+
+	if (parse_fdb_filter(c, p, &req.bridge_id, &req.iface_id) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_BRIDGE_FDB_FLUSH, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t config_show(struct gr_api_client *c, const struct ec_pnode *) {
+	const struct gr_bridge_fdb_config_get_resp *resp;
+	void *resp_ptr = NULL;
+
+	if (gr_api_client_send_recv(c, GR_BRIDGE_FDB_CONFIG_GET, 0, NULL, &resp_ptr) < 0)
+		return CMD_ERROR;
+
+	resp = resp_ptr;
+	printf("used %u (%.01f%%)\n",
+	       resp->used_count,
+	       (100.0 * (float)resp->used_count) / (float)resp->max_count);
+	printf("max %u\n", resp->max_count);
+
+	free(resp_ptr);
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t config_set(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_bridge_fdb_config_set_req req = {0};
+
+	if (arg_u32(p, "MAX", &req.max_count) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_BRIDGE_FDB_CONFIG_SET, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+#define BRIDGE_ATTRS_CMD IFACE_ATTRS_CMD ",(ageing_time AGEING),(mac MAC)"
+
+#define BRIDGE_ATTRS_ARGS                                                                          \
+	IFACE_ATTRS_ARGS,                                                                          \
+		with_help(                                                                         \
+			"Seconds before learned addresses expire.",                                \
+			ec_node_uint("AGEING", 1, UINT16_MAX, 10)                                  \
+		),                                                                                 \
+		with_help("Set the ethernet address.", ec_node_re("MAC", ETH_ADDR_RE))
+
+#define BRIDGE_ARG CTX_ARG("bridge", "L2 bridge domains.")
+#define FDB_CTX(root) CLI_CONTEXT(root, BRIDGE_ARG, CTX_ARG("fdb", "Forwarding database."))
+#define FDB_CONFIG_CTX(root)                                                                       \
+	CLI_CONTEXT(                                                                               \
+		root,                                                                              \
+		BRIDGE_ARG,                                                                        \
+		CTX_ARG("fdb", "Forwarding database."),                                            \
+		CTX_ARG("config", "Forwarding database configuration.")                            \
+	)
+
+static int ctx_init(struct ec_node *root) {
+	int ret;
+
+	ret = CLI_COMMAND(
+		INTERFACE_ADD_CTX(root),
+		"bridge NAME [" BRIDGE_ATTRS_CMD "]",
+		bridge_add,
+		"Create a new L2 bridge interface.",
+		with_help("Interface name.", ec_node("any", "NAME")),
+		BRIDGE_ATTRS_ARGS
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		INTERFACE_SET_CTX(root),
+		"bridge NAME (name NEW_NAME)," BRIDGE_ATTRS_CMD,
+		bridge_set,
+		"Modify bridge parameters.",
+		with_help(
+			"Interface name.",
+			ec_node_dyn("NAME", complete_iface_names, INT2PTR(GR_IFACE_TYPE_BRIDGE))
+		),
+		with_help("New interface name.", ec_node("any", "NEW_NAME")),
+		BRIDGE_ATTRS_ARGS
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		FDB_CTX(root),
+		"add MAC iface IFACE",
+		fdb_add,
+		"Add a static forwarding database entry.",
+		with_help("Destination ethernet address.", ec_node_re("MAC", ETH_ADDR_RE)),
+		with_help(
+			"Bridge member port.",
+			ec_node_dyn("IFACE", complete_iface_names, INT2PTR(GR_IFACE_TYPE_PORT))
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		FDB_CTX(root),
+		"del MAC bridge BRIDGE",
+		fdb_del,
+		"Delete a forwarding database entry.",
+		with_help("Destination ethernet address.", ec_node_re("MAC", ETH_ADDR_RE)),
+		with_help(
+			"Bridge interface.",
+			ec_node_dyn("BRIDGE", complete_iface_names, INT2PTR(GR_IFACE_TYPE_BRIDGE))
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		FDB_CTX(root),
+		"flush [(bridge BRIDGE),(iface IFACE)]",
+		fdb_flush,
+		"Flush learned forwarding database entries.",
+		with_help(
+			"Only flush entries of this bridge.",
+			ec_node_dyn("BRIDGE", complete_iface_names, INT2PTR(GR_IFACE_TYPE_BRIDGE))
+		),
+		with_help(
+			"Only flush entries learned on this port.",
+			ec_node_dyn("IFACE", complete_iface_names, INT2PTR(GR_IFACE_TYPE_PORT))
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		FDB_CTX(root),
+		"[show] [bridge BRIDGE]",
+		fdb_list,
+		"Show forwarding database entries.",
+		with_help(
+			"Only show entries of this bridge.",
+			ec_node_dyn("BRIDGE", complete_iface_names, INT2PTR(GR_IFACE_TYPE_BRIDGE))
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		FDB_CONFIG_CTX(root),
+		"set max MAX",
+		config_set,
+		"Change the forwarding database configuration.",
+		with_help(
+			"Maximum number of entries for all bridges.",
+			ec_node_uint("MAX", 1, UINT32_MAX, 10)
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		FDB_CONFIG_CTX(root),
+		"[show]",
+		config_show,
+		"Show the current forwarding database configuration."
+	);
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+static struct cli_context ctx = {
+	.name = "bridge",
+	.init = ctx_init,
+};
+
+static void __attribute__((constructor, used)) init(void) {
+	cli_context_register(&ctx);
+	register_iface_type(&bridge_type);
+}
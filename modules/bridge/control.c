@@ -0,0 +1,228 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include "bridge_priv.h"
+
+#include <gr_bridge.h>
+#include <gr_event.h>
+#include <gr_iface.h>
+#include <gr_infra.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_rcu.h>
+#include <gr_vec.h>
+
+#include <rte_ether.h>
+#include <rte_malloc.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+static bool bridge_has_member(const struct gr_iface_info_bridge *br, uint16_t iface_id) {
+	for (uint16_t i = 0; i < br->n_members; i++) {
+		if (br->members[i] == iface_id)
+			return true;
+	}
+	return false;
+}
+
+static bool is_member(const struct iface *iface, const struct iface *bridge) {
+	return iface->mode == GR_IFACE_MODE_L2_BRIDGE && iface->domain_id == bridge->id;
+}
+
+void bridge_members_update(const struct iface *removed) {
+	gr_vec const struct bridge_members **old_members = NULL;
+	struct iface *bridge = NULL;
+
+	while ((bridge = iface_next(GR_IFACE_TYPE_BRIDGE, bridge)) != NULL) {
+		struct iface_info_bridge *br = iface_info_bridge(bridge);
+		const struct bridge_members *old = atomic_load(&br->flood);
+		struct gr_iface_info_bridge prev = br->base;
+		struct bridge_members *members;
+		struct iface *iface = NULL;
+
+		members = rte_zmalloc(__func__, sizeof(*members), RTE_CACHE_LINE_SIZE);
+		if (members == NULL) {
+			LOG(ERR, "%s: cannot allocate members: %s", bridge->name, strerror(ENOMEM));
+			continue;
+		}
+
+		while ((iface = iface_next(GR_IFACE_TYPE_PORT, iface)) != NULL) {
+			if (iface == removed || !is_member(iface, bridge))
+				continue;
+			if (members->count == ARRAY_DIM(members->ifaces)) {
+				LOG(ERR,
+				    "%s: too many members, ignoring %s",
+				    bridge->name,
+				    iface->name);
+				continue;
+			}
+			members->ifaces[members->count++] = iface;
+		}
+
+		if (old != NULL && old->count == members->count
+		    && memcmp(old->ifaces, members->ifaces, members->count * sizeof(void *)) == 0) {
+			rte_free(members);
+			continue;
+		}
+
+		br->n_members = members->count;
+		for (uint16_t i = 0; i < members->count; i++)
+			br->members[i] = members->ifaces[i]->id;
+
+		atomic_store(&br->flood, members);
+		if (old != NULL)
+			gr_vec_add(old_members, old);
+
+		// Leaving members.
+		for (uint16_t i = 0; i < prev.n_members; i++) {
+			if (bridge_has_member(&br->base, prev.members[i]))
+				continue;
+			fdb_flush(bridge->id, prev.members[i]);
+			if (removed == NULL || removed->id != prev.members[i])
+				iface_set_promisc(prev.members[i], false);
+		}
+		// Joining members. They must accept all unicast addresses.
+		for (uint16_t i = 0; i < br->n_members; i++) {
+			if (bridge_has_member(&prev, br->members[i]))
+				continue;
+			if (iface_set_promisc(br->members[i], true) < 0)
+				LOG(WARNING, "%s: promisc: %s", bridge->name, strerror(errno));
+		}
+	}
+
+	if (gr_vec_len(old_members) > 0) {
+		// Wait until all datapath workers have done a round of main loop before freeing.
+		rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+		gr_vec_foreach (const struct bridge_members *m, old_members)
+			rte_free((void *)m);
+	}
+	gr_vec_free(old_members);
+}
+
+static int iface_bridge_reconfig(
+	struct iface *iface,
+	uint64_t set_attrs,
+	const struct gr_iface *,
+	const void *api_info
+) {
+	struct iface_info_bridge *cur = iface_info_bridge(iface);
+	const struct gr_iface_info_bridge *next = api_info;
+
+	if (set_attrs & GR_BRIDGE_SET_AGEING_TIME) {
+		if (next->ageing_time == 0)
+			cur->ageing_time = GR_BRIDGE_AGEING_TIME_DEFAULT;
+		else
+			cur->ageing_time = next->ageing_time;
+	}
+
+	if (set_attrs & GR_BRIDGE_SET_MAC) {
+		if (rte_is_zero_ether_addr(&next->mac))
+			rte_eth_random_addr(cur->mac.addr_bytes);
+		else if (!rte_is_unicast_ether_addr(&next->mac))
+			return errno_set(EINVAL);
+		else
+			cur->mac = next->mac;
+	}
+
+	return 0;
+}
+
+static int iface_bridge_fini(struct iface *iface) {
+	struct iface_info_bridge *br = iface_info_bridge(iface);
+
+	fdb_flush(iface->id, GR_IFACE_ID_UNDEF);
+
+	// iface_destroy already waited for an RCU grace period.
+	rte_free((void *)atomic_load(&br->flood));
+	br->flood = NULL;
+
+	return 0;
+}
+
+static int iface_bridge_init(struct iface *iface, const void *api_info) {
+	struct gr_iface conf;
+	int ret;
+
+	if (iface->mtu == 0)
+		iface->mtu = 1500;
+
+	conf.base = iface->base;
+
+	ret = iface_bridge_reconfig(iface, IFACE_SET_ALL, &conf, api_info);
+	if (ret < 0) {
+		iface_bridge_fini(iface);
+		errno = -ret;
+	}
+
+	return ret;
+}
+
+static int iface_bridge_get_eth_addr(const struct iface *iface, struct rte_ether_addr *mac) {
+	const struct iface_info_bridge *br = iface_info_bridge(iface);
+	*mac = br->mac;
+	return 0;
+}
+
+static int iface_bridge_set_eth_addr(struct iface *iface, const struct rte_ether_addr *mac) {
+	struct iface_info_bridge *br = iface_info_bridge(iface);
+
+	if (!rte_is_unicast_ether_addr(mac))
+		return errno_set(EINVAL);
+
+	br->mac = *mac;
+
+	return 0;
+}
+
+static void bridge_to_api(void *info, const struct iface *iface) {
+	const struct iface_info_bridge *br = iface_info_bridge(iface);
+	struct gr_iface_info_bridge *api = info;
+
+	*api = br->base;
+}
+
+static struct iface_type iface_type_bridge = {
+	.id = GR_IFACE_TYPE_BRIDGE,
+	.name = "bridge",
+	.pub_size = sizeof(struct gr_iface_info_bridge),
+	.priv_size = sizeof(struct iface_info_bridge),
+	.init = iface_bridge_init,
+	.reconfig = iface_bridge_reconfig,
+	.fini = iface_bridge_fini,
+	.get_eth_addr = iface_bridge_get_eth_addr,
+	.set_eth_addr = iface_bridge_set_eth_addr,
+	.to_api = bridge_to_api,
+};
+
+static void iface_event(uint32_t event, const void *obj) {
+	const struct iface *iface = obj;
+
+	if (iface->type != GR_IFACE_TYPE_PORT)
+		return;
+
+	switch (event) {
+	case GR_EVENT_IFACE_POST_ADD:
+	case GR_EVENT_IFACE_POST_RECONFIG:
+		bridge_members_update(NULL);
+		break;
+	case GR_EVENT_IFACE_PRE_REMOVE:
+		bridge_members_update(iface);
+		break;
+	}
+}
+
+static struct gr_event_subscription iface_event_sub = {
+	.callback = iface_event,
+	.ev_count = 3,
+	.ev_types = {
+		GR_EVENT_IFACE_POST_ADD,
+		GR_EVENT_IFACE_POST_RECONFIG,
+		GR_EVENT_IFACE_PRE_REMOVE,
+	},
+};
+
+RTE_INIT(bridge_constructor) {
+	iface_type_register(&iface_type_bridge);
+	gr_event_subscribe(&iface_event_sub);
+}
@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include "bridge_priv.h"
+
+#include <gr_clock.h>
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_rxtx.h>
+#include <gr_trace.h>
+
+#include <rte_ether.h>
+#include <rte_hash.h>
+#include <rte_mbuf.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+enum {
+	OUTPUT = 0,
+	FLOOD,
+	ETH_INPUT,
+	FILTERED,
+	NO_BRIDGE,
+	IFACE_DOWN,
+	NO_HEADROOM,
+	EDGE_COUNT,
+};
+
+int trace_bridge_format(char *buf, size_t len, const void *data, size_t /*data_len*/) {
+	const struct trace_bridge_data *t = data;
+	const struct iface *bridge = iface_from_id(t->bridge_id);
+	const struct iface *iface = iface_from_id(t->iface_id);
+	return snprintf(
+		buf,
+		len,
+		"bridge=%s iface=%s",
+		bridge ? bridge->name : "[deleted]",
+		iface ? iface->name : "[unknown]"
+	);
+}
+
+// Source and destination addresses are looked up in bulk. Two separate lookups
+// are done for each chunk, both limited to RTE_HASH_LOOKUP_BULK_MAX keys.
+#define CHUNK_SIZE RTE_HASH_LOOKUP_BULK_MAX
+
+static uint16_t bridge_input_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs
+) {
+	struct fdb *fdb = atomic_load_explicit(&bridge_fdb, memory_order_acquire);
+	const void *src_keys[CHUNK_SIZE], *dst_keys[CHUNK_SIZE];
+	int32_t src_pos[CHUNK_SIZE], dst_pos[CHUNK_SIZE];
+	struct fdb_key src[CHUNK_SIZE], dst[CHUNK_SIZE];
+	const struct iface *bridge, *member, *out;
+	const struct iface_info_bridge *br;
+	rte_edge_t edges[CHUNK_SIZE];
+	struct iface_stats *stats;
+	struct rte_ether_hdr *eth;
+	clock_t now = gr_clock_us();
+	struct rte_mbuf *mbuf;
+	uint16_t n;
+
+	bridge = NULL;
+
+	for (uint16_t off = 0; off < nb_objs; off += n) {
+		n = RTE_MIN(nb_objs - off, CHUNK_SIZE);
+
+		for (uint16_t i = 0; i < n; i++) {
+			mbuf = objs[off + i];
+			member = mbuf_data(mbuf)->iface;
+			memset(&src[i], 0, sizeof(src[i]));
+			memset(&dst[i], 0, sizeof(dst[i]));
+			src_keys[i] = &src[i];
+			dst_keys[i] = &dst[i];
+
+			stats = iface_get_stats(rte_lcore_id(), member->id);
+			stats->rx_packets++;
+			stats->rx_bytes += rte_pktmbuf_pkt_len(mbuf);
+
+			if (bridge == NULL || bridge->id != member->domain_id)
+				bridge = iface_from_id(member->domain_id);
+			if (unlikely(bridge == NULL || bridge->type != GR_IFACE_TYPE_BRIDGE)) {
+				edges[i] = NO_BRIDGE;
+				continue;
+			}
+			if (!(bridge->flags & GR_IFACE_F_UP)) {
+				edges[i] = IFACE_DOWN;
+				continue;
+			}
+			// Frames are forwarded as they were received.
+			if (mbuf->ol_flags & RTE_MBUF_F_RX_VLAN_STRIPPED) {
+				if (rte_vlan_insert(&mbuf) < 0) {
+					edges[i] = NO_HEADROOM;
+					continue;
+				}
+				objs[off + i] = mbuf;
+			}
+			eth = rte_pktmbuf_mtod(mbuf, struct rte_ether_hdr *);
+			src[i].bridge_id = bridge->id;
+			src[i].mac = eth->src_addr;
+			dst[i].bridge_id = bridge->id;
+			dst[i].mac = eth->dst_addr;
+			edges[i] = OUTPUT;
+		}
+
+		rte_hash_lookup_bulk(fdb->hash, src_keys, n, src_pos);
+		rte_hash_lookup_bulk(fdb->hash, dst_keys, n, dst_pos);
+
+		for (uint16_t i = 0; i < n; i++) {
+			mbuf = objs[off + i];
+			member = mbuf_data(mbuf)->iface;
+			out = NULL;
+
+			if (edges[i] != OUTPUT)
+				goto next;
+
+			if (rte_is_unicast_ether_addr(&src[i].mac))
+				fdb_learn(fdb, &src[i], src_pos[i], member->id, now);
+
+			if (rte_is_multicast_ether_addr(&dst[i].mac)) {
+				edges[i] = FLOOD;
+				goto next;
+			}
+
+			if (bridge == NULL || bridge->id != dst[i].bridge_id)
+				bridge = iface_from_id(dst[i].bridge_id);
+			br = iface_info_bridge(bridge);
+			if (rte_is_same_ether_addr(&dst[i].mac, &br->mac)) {
+				// Integrated routing and bridging.
+				struct eth_input_mbuf_data *d = eth_input_mbuf_data(mbuf);
+				d->iface = bridge;
+				d->domain = ETH_DOMAIN_UNKNOWN;
+				edges[i] = ETH_INPUT;
+				goto next;
+			}
+
+			out = fdb_iface(fdb, dst_pos[i]);
+			if (out == NULL || out->mode != GR_IFACE_MODE_L2_BRIDGE
+			    || out->domain_id != bridge->id) {
+				edges[i] = FLOOD;
+				goto next;
+			}
+			if (out == member) {
+				edges[i] = FILTERED;
+				goto next;
+			}
+
+			mbuf_data(mbuf)->iface = out;
+			stats = iface_get_stats(rte_lcore_id(), out->id);
+			stats->tx_packets++;
+			stats->tx_bytes += rte_pktmbuf_pkt_len(mbuf);
+next:
+			if (gr_mbuf_is_traced(mbuf)) {
+				struct trace_bridge_data *t;
+				t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
+				t->bridge_id = member->domain_id;
+				t->iface_id = out ? out->id : GR_IFACE_ID_UNDEF;
+			}
+			rte_node_enqueue_x1(graph, node, edges[i], mbuf);
+		}
+	}
+
+	return nb_objs;
+}
+
+static void bridge_input_register(void) {
+	register_interface_mode(GR_IFACE_MODE_L2_BRIDGE, "bridge_input");
+}
+
+static struct rte_node_register bridge_input_node = {
+	.name = "bridge_input",
+
+	.process = bridge_input_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[OUTPUT] = "port_output",
+		[FLOOD] = "bridge_flood",
+		[ETH_INPUT] = "eth_input",
+		[FILTERED] = "bridge_input_filtered",
+		[NO_BRIDGE] = "bridge_input_no_bridge",
+		[IFACE_DOWN] = "iface_input_admin_down",
+		[NO_HEADROOM] = "error_no_headroom",
+	},
+};
+
+static struct gr_node_info bridge_input_info = {
+	.node = &bridge_input_node,
+	.register_callback = bridge_input_register,
+	.trace_format = trace_bridge_format,
+};
+
+GR_NODE_REGISTER(bridge_input_info);
+
+GR_DROP_REGISTER(bridge_input_filtered);
+GR_DROP_REGISTER(bridge_input_no_bridge);
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include "bridge_priv.h"
+
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_trace.h>
+
+#include <rte_ether.h>
+#include <rte_hash.h>
+#include <rte_mbuf.h>
+
+#include <stdatomic.h>
+
+enum {
+	OUTPUT = 0,
+	FLOOD,
+	EDGE_COUNT,
+};
+
+// Frames routed to a bridge interface (IRB) already have their ethernet header.
+// Forward them to the member port where the destination address was learned.
+static uint16_t bridge_output_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs
+) {
+	struct fdb *fdb = atomic_load_explicit(&bridge_fdb, memory_order_acquire);
+	const struct iface *bridge, *out;
+	const struct rte_ether_hdr *eth;
+	struct iface_stats *stats;
+	struct fdb_key key = {0};
+	struct rte_mbuf *mbuf;
+	rte_edge_t edge;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		mbuf = objs[i];
+		bridge = mbuf_data(mbuf)->iface;
+		eth = rte_pktmbuf_mtod(mbuf, const struct rte_ether_hdr *);
+		out = NULL;
+
+		if (rte_is_multicast_ether_addr(&eth->dst_addr)) {
+			edge = FLOOD;
+			goto next;
+		}
+
+		key.bridge_id = bridge->id;
+		key.mac = eth->dst_addr;
+		out = fdb_iface(fdb, rte_hash_lookup(fdb->hash, &key));
+		if (out == NULL || out->mode != GR_IFACE_MODE_L2_BRIDGE
+		    || out->domain_id != bridge->id) {
+			out = NULL;
+			edge = FLOOD;
+			goto next;
+		}
+
+		mbuf_data(mbuf)->iface = out;
+		stats = iface_get_stats(rte_lcore_id(), out->id);
+		stats->tx_packets++;
+		stats->tx_bytes += rte_pktmbuf_pkt_len(mbuf);
+		edge = OUTPUT;
+next:
+		if (gr_mbuf_is_traced(mbuf)) {
+			struct trace_bridge_data *t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
+			t->bridge_id = bridge->id;
+			t->iface_id = out ? out->id : GR_IFACE_ID_UNDEF;
+		}
+		rte_node_enqueue_x1(graph, node, edge, mbuf);
+	}
+
+	return nb_objs;
+}
+
+static void bridge_output_register(void) {
+	eth_output_register_interface_type(GR_IFACE_TYPE_BRIDGE, "bridge_output");
+}
+
+static struct rte_node_register bridge_output_node = {
+	.name = "bridge_output",
+
+	.process = bridge_output_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[OUTPUT] = "port_output",
+		[FLOOD] = "bridge_flood",
+	},
+};
+
+static struct gr_node_info bridge_output_info = {
+	.node = &bridge_output_node,
+	.register_callback = bridge_output_register,
+	.trace_format = trace_bridge_format,
+};
+
+GR_NODE_REGISTER(bridge_output_info);
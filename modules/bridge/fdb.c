@@ -0,0 +1,372 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include "bridge_priv.h"
+
+#include <gr_api.h>
+#include <gr_bridge.h>
+#include <gr_clock.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_rcu.h>
+#include <gr_vec.h>
+
+#include <event2/event.h>
+#include <rte_hash.h>
+#include <rte_malloc.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+#define DEFAULT_FDB_COUNT (128 * 1024)
+
+static struct gr_bridge_fdb_config conf = {.max_count = DEFAULT_FDB_COUNT};
+_Atomic(struct fdb *) bridge_fdb;
+static struct event *ageing_timer;
+
+static struct fdb *fdb_create(uint32_t max_count) {
+	struct rte_hash *h;
+	struct fdb *fdb;
+	char name[128];
+	int32_t n;
+
+	snprintf(name, sizeof(name), "fdb-%u", max_count);
+
+	// Without RCU configuration, lock-free hashes do not recycle the key
+	// slots on deletion. It is left to the control plane to do it in bulk
+	// with rte_hash_free_key_with_position after a grace period.
+	h = rte_hash_create(&(struct rte_hash_parameters) {
+		.name = name,
+		.entries = max_count,
+		.key_len = sizeof(struct fdb_key),
+		.socket_id = SOCKET_ID_ANY,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF
+			| RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD
+			| RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT,
+	});
+	if (h == NULL) {
+		errno_log_null(rte_errno, "rte_hash_create(fdb)");
+		return NULL;
+	}
+
+	// Multi-writer hashes cache free slots per lcore. Key positions may be
+	// higher than the number of entries.
+	n = rte_hash_max_key_id(h) + 1;
+	fdb = rte_zmalloc(__func__, sizeof(*fdb) + n * sizeof(fdb->entries[0]), 0);
+	if (fdb == NULL) {
+		rte_hash_free(h);
+		errno_log_null(ENOMEM, "rte_zmalloc(fdb)");
+		return NULL;
+	}
+	fdb->hash = h;
+	fdb->max_count = max_count;
+	fdb->n_entries = n;
+
+	return fdb;
+}
+
+static void fdb_destroy(struct fdb *fdb) {
+	if (fdb == NULL)
+		return;
+	rte_hash_free(fdb->hash);
+	rte_free(fdb);
+}
+
+typedef bool (*fdb_match_cb_t)(const struct fdb_key *, const struct fdb_entry *, const void *);
+
+// Delete all entries matching a filter and wait for a single RCU grace period
+// before recycling their key positions.
+static unsigned fdb_purge(struct fdb *fdb, fdb_match_cb_t match, const void *priv) {
+	gr_vec int32_t *positions = NULL;
+	const struct fdb_key *key;
+	struct fdb_entry *e;
+	uint32_t iter = 0;
+	unsigned count;
+	int32_t pos;
+	void *data;
+
+	while ((pos = rte_hash_iterate(fdb->hash, (const void **)&key, &data, &iter)) >= 0) {
+		e = &fdb->entries[pos];
+		if (!match(key, e, priv))
+			continue;
+		if (rte_hash_del_key(fdb->hash, key) == pos)
+			gr_vec_add(positions, pos);
+	}
+
+	count = gr_vec_len(positions);
+	if (count == 0)
+		return 0;
+
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+
+	gr_vec_foreach (pos, positions) {
+		e = &fdb->entries[pos];
+		atomic_store(&e->iface_id, GR_IFACE_ID_UNDEF);
+		atomic_store(&e->last_seen, 0);
+		e->flags = 0;
+		rte_hash_free_key_with_position(fdb->hash, pos);
+	}
+	gr_vec_free(positions);
+
+	return count;
+}
+
+static bool fdb_expired(const struct fdb_key *key, const struct fdb_entry *e, const void *priv) {
+	const struct iface *bridge = iface_from_id(key->bridge_id);
+	const clock_t *now = priv;
+	clock_t last, timeout;
+
+	if (e->flags & GR_FDB_F_STATIC)
+		return false;
+	if (bridge == NULL || bridge->type != GR_IFACE_TYPE_BRIDGE)
+		return true;
+
+	last = atomic_load(&e->last_seen);
+	if (last > *now)
+		return false;
+	timeout = iface_info_bridge(bridge)->ageing_time * CLOCKS_PER_SEC;
+
+	return *now - last > timeout;
+}
+
+static void do_ageing(evutil_socket_t, short /*what*/, void * /*priv*/) {
+	struct fdb *fdb = atomic_load(&bridge_fdb);
+	clock_t now = gr_clock_us();
+	unsigned count;
+
+	count = fdb_purge(fdb, fdb_expired, &now);
+	if (count > 0)
+		LOG(DEBUG, "%u fdb entries expired", count);
+}
+
+struct fdb_filter {
+	uint16_t bridge_id;
+	uint16_t iface_id;
+	bool with_static;
+};
+
+static bool fdb_match(const struct fdb_key *key, const struct fdb_entry *e, const void *priv) {
+	const struct fdb_filter *f = priv;
+
+	if (!f->with_static && e->flags & GR_FDB_F_STATIC)
+		return false;
+	if (f->bridge_id != GR_IFACE_ID_UNDEF && f->bridge_id != key->bridge_id)
+		return false;
+	if (f->iface_id != GR_IFACE_ID_UNDEF && f->iface_id != atomic_load(&e->iface_id))
+		return false;
+
+	return true;
+}
+
+void fdb_flush(uint16_t bridge_id, uint16_t iface_id) {
+	struct fdb_filter f = {bridge_id, iface_id, true};
+	fdb_purge(atomic_load(&bridge_fdb), fdb_match, &f);
+}
+
+static int config_update(const struct gr_bridge_fdb_config *new_conf) {
+	struct fdb *old = atomic_load(&bridge_fdb);
+	struct fdb *fdb;
+
+	if (old != NULL && (new_conf->max_count == 0 || new_conf->max_count == old->max_count))
+		return 0;
+
+	if (old != NULL && rte_hash_count(old->hash) > 0)
+		return errno_set(EBUSY);
+
+	if ((fdb = fdb_create(new_conf->max_count)) == NULL)
+		return -errno;
+
+	atomic_store(&bridge_fdb, fdb);
+
+	// Wait until all datapath workers have done a round of main loop before freeing.
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+	fdb_destroy(old);
+
+	conf.max_count = new_conf->max_count;
+
+	return 0;
+}
+
+static struct api_out fdb_add(const void *request, struct api_ctx *) {
+	const struct gr_bridge_fdb_add_req *req = request;
+	struct fdb *fdb = atomic_load(&bridge_fdb);
+	const struct iface *iface;
+	struct fdb_key key = {0};
+	struct fdb_entry *e;
+	int32_t pos;
+
+	if ((iface = iface_from_id(req->fdb.iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+	if (iface->mode != GR_IFACE_MODE_L2_BRIDGE)
+		return api_out(EMEDIUMTYPE, 0, NULL);
+	if (!rte_is_unicast_ether_addr(&req->fdb.mac))
+		return api_out(EINVAL, 0, NULL);
+
+	key.bridge_id = iface->domain_id;
+	key.mac = req->fdb.mac;
+
+	if (rte_hash_lookup(fdb->hash, &key) >= 0 && !req->exist_ok)
+		return api_out(EEXIST, 0, NULL);
+
+	if ((pos = rte_hash_add_key(fdb->hash, &key)) < 0)
+		return api_out(-pos, 0, NULL);
+
+	e = &fdb->entries[pos];
+	e->flags = GR_FDB_F_STATIC;
+	atomic_store(&e->last_seen, gr_clock_us());
+	atomic_store(&e->iface_id, iface->id);
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out fdb_del(const void *request, struct api_ctx *) {
+	const struct gr_bridge_fdb_del_req *req = request;
+	struct fdb *fdb = atomic_load(&bridge_fdb);
+	struct fdb_key key = {0};
+	int32_t pos;
+
+	key.bridge_id = req->bridge_id;
+	key.mac = req->mac;
+
+	if ((pos = rte_hash_del_key(fdb->hash, &key)) < 0) {
+		if (pos == -ENOENT && req->missing_ok)
+			return api_out(0, 0, NULL);
+		return api_out(-pos, 0, NULL);
+	}
+
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+
+	atomic_store(&fdb->entries[pos].iface_id, GR_IFACE_ID_UNDEF);
+	atomic_store(&fdb->entries[pos].last_seen, 0);
+	fdb->entries[pos].flags = 0;
+	rte_hash_free_key_with_position(fdb->hash, pos);
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out fdb_list(const void *request, struct api_ctx *ctx) {
+	const struct gr_bridge_fdb_list_req *req = request;
+	struct fdb *fdb = atomic_load(&bridge_fdb);
+	const struct fdb_key *key;
+	struct fdb_entry *e;
+	uint32_t iter = 0;
+	int32_t pos;
+	void *data;
+
+	while ((pos = rte_hash_iterate(fdb->hash, (const void **)&key, &data, &iter)) >= 0) {
+		if (req->bridge_id != GR_IFACE_ID_UNDEF && req->bridge_id != key->bridge_id)
+			continue;
+		e = &fdb->entries[pos];
+		struct gr_fdb_entry entry = {
+			.bridge_id = key->bridge_id,
+			.mac = key->mac,
+			.iface_id = atomic_load(&e->iface_id),
+			.flags = e->flags,
+			.last_seen = atomic_load(&e->last_seen),
+		};
+		if (entry.iface_id == GR_IFACE_ID_UNDEF)
+			continue;
+		api_send(ctx, sizeof(entry), &entry);
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out fdb_flush_api(const void *request, struct api_ctx *) {
+	const struct gr_bridge_fdb_flush_req *req = request;
+	struct fdb_filter f = {req->bridge_id, req->iface_id, false};
+
+	fdb_purge(atomic_load(&bridge_fdb), fdb_match, &f);
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out fdb_config_get(const void * /*request*/, struct api_ctx *) {
+	struct gr_bridge_fdb_config_get_resp *resp = malloc(sizeof(*resp));
+	struct fdb *fdb = atomic_load(&bridge_fdb);
+
+	if (resp == NULL)
+		return api_out(ENOMEM, 0, NULL);
+
+	resp->base = conf;
+	resp->used_count = rte_hash_count(fdb->hash);
+
+	return api_out(0, sizeof(*resp), resp);
+}
+
+static struct api_out fdb_config_set(const void *request, struct api_ctx *) {
+	const struct gr_bridge_fdb_config_set_req *req = request;
+
+	if (config_update(&req->base) < 0)
+		return api_out(errno, 0, NULL);
+
+	return api_out(0, 0, NULL);
+}
+
+static struct gr_api_handler fdb_add_handler = {
+	.name = "bridge fdb add",
+	.request_type = GR_BRIDGE_FDB_ADD,
+	.callback = fdb_add,
+};
+static struct gr_api_handler fdb_del_handler = {
+	.name = "bridge fdb del",
+	.request_type = GR_BRIDGE_FDB_DEL,
+	.callback = fdb_del,
+};
+static struct gr_api_handler fdb_list_handler = {
+	.name = "bridge fdb list",
+	.request_type = GR_BRIDGE_FDB_LIST,
+	.callback = fdb_list,
+};
+static struct gr_api_handler fdb_flush_handler = {
+	.name = "bridge fdb flush",
+	.request_type = GR_BRIDGE_FDB_FLUSH,
+	.callback = fdb_flush_api,
+};
+static struct gr_api_handler fdb_config_get_handler = {
+	.name = "bridge fdb config get",
+	.request_type = GR_BRIDGE_FDB_CONFIG_GET,
+	.callback = fdb_config_get,
+};
+static struct gr_api_handler fdb_config_set_handler = {
+	.name = "bridge fdb config set",
+	.request_type = GR_BRIDGE_FDB_CONFIG_SET,
+	.callback = fdb_config_set,
+};
+
+static void fdb_init(struct event_base *ev_base) {
+	if (config_update(&conf) < 0)
+		ABORT("fdb config_update");
+
+	ageing_timer = event_new(ev_base, -1, EV_PERSIST | EV_FINALIZE, do_ageing, NULL);
+	if (ageing_timer == NULL)
+		ABORT("event_new() failed");
+
+	if (event_add(ageing_timer, &(struct timeval) {.tv_sec = 1}) < 0)
+		ABORT("event_add() failed");
+}
+
+static void fdb_fini(struct event_base *) {
+	if (ageing_timer)
+		event_free(ageing_timer);
+	fdb_destroy(atomic_load(&bridge_fdb));
+	bridge_fdb = NULL;
+}
+
+static struct gr_module fdb_module = {
+	.name = "bridge fdb",
+	.depends_on = "rcu",
+	.init = fdb_init,
+	.fini = fdb_fini,
+};
+
+RTE_INIT(fdb_constructor) {
+	gr_register_module(&fdb_module);
+	gr_register_api_handler(&fdb_add_handler);
+	gr_register_api_handler(&fdb_del_handler);
+	gr_register_api_handler(&fdb_list_handler);
+	gr_register_api_handler(&fdb_flush_handler);
+	gr_register_api_handler(&fdb_config_get_handler);
+	gr_register_api_handler(&fdb_config_set_handler);
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include "bridge_priv.h"
+
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_trace.h>
+
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+
+#include <stdatomic.h>
+
+enum {
+	OUTPUT = 0,
+	ETH_INPUT,
+	NO_MEMBER,
+	NO_BRIDGE,
+	EDGE_COUNT,
+};
+
+static inline void flood_output(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	struct rte_mbuf *m,
+	const struct iface *bridge,
+	const struct iface *out,
+	bool traced
+) {
+	struct iface_stats *stats;
+
+	mbuf_data(m)->iface = out;
+	stats = iface_get_stats(rte_lcore_id(), out->id);
+	stats->tx_packets++;
+	stats->tx_bytes += rte_pktmbuf_pkt_len(m);
+
+	// Replicas do not share the trace items of the original mbuf.
+	if (traced) {
+		struct trace_bridge_data *t = gr_mbuf_trace_add(m, node, sizeof(*t));
+		t->bridge_id = bridge->id;
+		t->iface_id = out->id;
+	}
+	rte_node_enqueue_x1(graph, node, OUTPUT, m);
+}
+
+// Replicate broadcast, multicast and unknown unicast frames to all bridge
+// members except the one the frame was received on.
+//
+// Replicas are indirect mbufs that reference the original data. No header is
+// modified when bridging. The original mbuf is sent to the last member.
+static uint16_t bridge_flood_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs
+) {
+	const struct bridge_members *members;
+	const struct iface *in, *bridge, *out;
+	struct rte_ether_hdr *eth;
+	struct rte_mbuf *m, *c;
+	rte_edge_t edge;
+	bool traced;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		m = objs[i];
+		in = mbuf_data(m)->iface;
+		traced = gr_mbuf_is_traced(m);
+		bridge = NULL;
+
+		if (in->type == GR_IFACE_TYPE_BRIDGE) {
+			// Sent from the bridge interface itself (bridge_output).
+			bridge = in;
+		} else {
+			bridge = iface_from_id(in->domain_id);
+			if (unlikely(bridge == NULL || bridge->type != GR_IFACE_TYPE_BRIDGE)) {
+				edge = NO_BRIDGE;
+				goto drop;
+			}
+		}
+
+		eth = rte_pktmbuf_mtod(m, struct rte_ether_hdr *);
+		if (in != bridge && rte_is_multicast_ether_addr(&eth->dst_addr)) {
+			// The local stack may reply in place, give it a private copy.
+			c = rte_pktmbuf_copy(m, m->pool, 0, UINT32_MAX);
+			if (c != NULL) {
+				struct eth_input_mbuf_data *d = eth_input_mbuf_data(c);
+				d->iface = bridge;
+				d->domain = ETH_DOMAIN_UNKNOWN;
+				if (traced) {
+					struct trace_bridge_data *t;
+					t = gr_mbuf_trace_add(c, node, sizeof(*t));
+					t->bridge_id = bridge->id;
+					t->iface_id = bridge->id;
+				}
+				rte_node_enqueue_x1(graph, node, ETH_INPUT, c);
+			}
+		}
+
+		members = atomic_load_explicit(
+			&iface_info_bridge(bridge)->flood, memory_order_acquire
+		);
+		out = NULL;
+		for (uint16_t j = 0; members != NULL && j < members->count; j++) {
+			const struct iface *member = members->ifaces[j];
+			if (member == in || !(member->flags & GR_IFACE_F_UP))
+				continue;
+			if (out != NULL) {
+				c = rte_pktmbuf_clone(m, m->pool);
+				if (unlikely(c == NULL))
+					break;
+				flood_output(graph, node, c, bridge, out, traced);
+			}
+			out = member;
+		}
+		if (out != NULL) {
+			flood_output(graph, node, m, bridge, out, traced);
+			continue;
+		}
+		edge = NO_MEMBER;
+drop:
+		if (traced) {
+			struct trace_bridge_data *t = gr_mbuf_trace_add(m, node, sizeof(*t));
+			t->bridge_id = bridge ? bridge->id : in->domain_id;
+			t->iface_id = GR_IFACE_ID_UNDEF;
+		}
+		rte_node_enqueue_x1(graph, node, edge, m);
+	}
+
+	return nb_objs;
+}
+
+static struct rte_node_register bridge_flood_node = {
+	.name = "bridge_flood",
+
+	.process = bridge_flood_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[OUTPUT] = "port_output",
+		[ETH_INPUT] = "eth_input",
+		[NO_MEMBER] = "bridge_flood_no_member",
+		[NO_BRIDGE] = "bridge_input_no_bridge",
+	},
+};
+
+static struct gr_node_info bridge_flood_info = {
+	.node = &bridge_flood_node,
+	.trace_format = trace_bridge_format,
+};
+
+GR_NODE_REGISTER(bridge_flood_info);
+
+GR_DROP_REGISTER(bridge_flood_no_member);
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_api.h>
+#include <gr_bitops.h>
+#include <gr_clock.h>
+#include <gr_infra.h>
+#include <gr_macro.h>
+#include <gr_net_types.h>
+
+#include <rte_ether.h>
+
+#include <stdint.h>
+
+// Bridge reconfig attributes
+#define GR_BRIDGE_SET_AGEING_TIME GR_BIT64(32)
+#define GR_BRIDGE_SET_MAC GR_BIT64(33)
+
+#define GR_BRIDGE_AGEING_TIME_DEFAULT 300
+#define GR_BRIDGE_MAX_MEMBERS 64
+
+// Info for GR_IFACE_TYPE_BRIDGE interfaces.
+//
+// Ports are attached to a bridge by setting their mode to GR_IFACE_MODE_L2_BRIDGE
+// and their domain_id to the bridge interface id.
+//
+// The bridge interface itself is a regular L3 interface. When it has addresses,
+// it routes frames sent to its own mac address (IRB).
+struct gr_iface_info_bridge {
+	uint16_t ageing_time; //!< Seconds before learned addresses expire (0: default).
+	struct rte_ether_addr mac; //!< If zero on creation, a random address is generated.
+	uint16_t n_members; //!< Read-only.
+	uint16_t members[GR_BRIDGE_MAX_MEMBERS]; //!< Read-only.
+};
+
+#define GR_BRIDGE_MODULE 0xb21d
+
+// forwarding database /////////////////////////////////////////////////////////
+
+typedef enum : uint8_t {
+	GR_FDB_F_STATIC = GR_BIT8(0), //!< Configured by the user, never expires.
+} gr_fdb_flags_t;
+
+struct gr_fdb_entry {
+	uint16_t bridge_id;
+	struct rte_ether_addr mac;
+	uint16_t iface_id;
+	gr_fdb_flags_t flags;
+	clock_t last_seen;
+};
+
+#define GR_BRIDGE_FDB_ADD REQUEST_TYPE(GR_BRIDGE_MODULE, 0x0001)
+
+struct gr_bridge_fdb_add_req {
+	struct gr_fdb_entry fdb; // bridge_id is derived from iface_id
+	uint8_t exist_ok;
+};
+
+// struct gr_bridge_fdb_add_resp { };
+
+#define GR_BRIDGE_FDB_DEL REQUEST_TYPE(GR_BRIDGE_MODULE, 0x0002)
+
+struct gr_bridge_fdb_del_req {
+	uint16_t bridge_id;
+	struct rte_ether_addr mac;
+	uint8_t missing_ok;
+};
+
+// struct gr_bridge_fdb_del_resp { };
+
+#define GR_BRIDGE_FDB_LIST REQUEST_TYPE(GR_BRIDGE_MODULE, 0x0003)
+
+struct gr_bridge_fdb_list_req {
+	uint16_t bridge_id; // use GR_IFACE_ID_UNDEF for all
+};
+
+// STREAM(struct gr_fdb_entry);
+
+#define GR_BRIDGE_FDB_FLUSH REQUEST_TYPE(GR_BRIDGE_MODULE, 0x0004)
+
+// Remove all learned entries matching the request. Static entries are kept.
+struct gr_bridge_fdb_flush_req {
+	uint16_t bridge_id; // use GR_IFACE_ID_UNDEF for all
+	uint16_t iface_id; // use GR_IFACE_ID_UNDEF for all
+};
+
+// struct gr_bridge_fdb_flush_resp { };
+
+struct gr_bridge_fdb_config {
+	//! Maximum number of entries for all bridges (default: 128K).
+	uint32_t max_count;
+};
+
+#define GR_BRIDGE_FDB_CONFIG_GET REQUEST_TYPE(GR_BRIDGE_MODULE, 0x0005)
+
+// struct gr_bridge_fdb_config_get_req { };
+
+struct gr_bridge_fdb_config_get_resp {
+	BASE(gr_bridge_fdb_config);
+	uint32_t used_count;
+};
+
+#define GR_BRIDGE_FDB_CONFIG_SET REQUEST_TYPE(GR_BRIDGE_MODULE, 0x0006)
+
+struct gr_bridge_fdb_config_set_req {
+	BASE(gr_bridge_fdb_config);
+};
+
+// struct gr_bridge_fdb_config_set_resp { };
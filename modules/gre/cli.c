@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_cli.h>
+#include <gr_cli_iface.h>
+#include <gr_gre.h>
+#include <gr_net_types.h>
+
+#include <ecoli.h>
+
+#include <errno.h>
+
+static void gre_show(struct gr_api_client *, const struct gr_iface *iface) {
+	const struct gr_iface_info_gre *gre = (const struct gr_iface_info_gre *)iface->info;
+
+	printf("local: " IP4_F "\n", &gre->local);
+	printf("remote: " IP4_F "\n", &gre->remote);
+	if (gre->key_present)
+		printf("key: %u\n", gre->key);
+}
+
+static void
+gre_list_info(struct gr_api_client *, const struct gr_iface *iface, char *buf, size_t len) {
+	const struct gr_iface_info_gre *gre = (const struct gr_iface_info_gre *)iface->info;
+	size_t n = 0;
+
+	SAFE_BUF(snprintf, len, "local=" IP4_F " remote=" IP4_F, &gre->local, &gre->remote);
+	if (gre->key_present)
+		SAFE_BUF(snprintf, len, " key=%u", gre->key);
+err:
+	return;
+}
+
+static struct cli_iface_type gre_type = {
+	.type_id = GR_IFACE_TYPE_GRE,
+	.show = gre_show,
+	.list_info = gre_list_info,
+};
+
+static uint64_t parse_gre_args(
+	struct gr_api_client *c,
+	const struct ec_pnode *p,
+	struct gr_iface *iface,
+	bool update
+) {
+	struct gr_iface_info_gre *gre;
+	uint64_t set_attrs;
+
+	set_attrs = parse_iface_args(c, p, iface, sizeof(*gre), update);
+
+	gre = (struct gr_iface_info_gre *)iface->info;
+
+	if (arg_ip4(p, "LOCAL", &gre->local) < 0) {
+		if (errno != ENOENT)
+			return 0;
+	} else {
+		set_attrs |= GR_GRE_SET_LOCAL;
+	}
+
+	if (arg_ip4(p, "REMOTE", &gre->remote) < 0) {
+		if (errno != ENOENT)
+			return 0;
+	} else {
+		set_attrs |= GR_GRE_SET_REMOTE;
+	}
+
+	if (arg_u32(p, "KEY", &gre->key) < 0) {
+		if (errno != ENOENT)
+			return 0;
+	} else {
+		gre->key_present = true;
+		set_attrs |= GR_GRE_SET_KEY;
+	}
+	if (arg_str(p, "nokey")) {
+		gre->key_present = false;
+		gre->key = 0;
+		set_attrs |= GR_GRE_SET_KEY;
+	}
+
+	if (gre->local == gre->remote) {
+		errno = EADDRINUSE;
+		return 0;
+	}
+
+	if (set_attrs == 0)
+		errno = EINVAL;
+	return set_attrs;
+}
+
+static cmd_status_t gre_add(struct gr_api_client *c, const struct ec_pnode *p) {
+	const struct gr_infra_iface_add_resp *resp;
+	struct gr_infra_iface_add_req *req = NULL;
+	void *resp_ptr = NULL;
+	size_t len;
+
+	len = sizeof(*req) + sizeof(struct gr_iface_info_gre);
+	if ((req = calloc(1, len)) == NULL)
+		goto err;
+
+	req->iface.type = GR_IFACE_TYPE_GRE;
+	req->iface.flags = GR_IFACE_F_UP;
+
+	if (parse_gre_args(c, p, &req->iface, false) == 0)
+		goto err;
+
+	if (gr_api_client_send_recv(c, GR_INFRA_IFACE_ADD, len, req, &resp_ptr) < 0)
+		goto err;
+
+	free(req);
+	resp = resp_ptr;
+	printf("Created interface %u\n", resp->iface_id);
+	free(resp_ptr);
+	return CMD_SUCCESS;
+err:
+	free(req);
+	return CMD_ERROR;
+}
+
+static cmd_status_t gre_set(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_infra_iface_set_req *req = NULL;
+	cmd_status_t ret = CMD_ERROR;
+	size_t len;
+
+	len = sizeof(*req) + sizeof(struct gr_iface_info_gre);
+	if ((req = calloc(1, len)) == NULL)
+		goto out;
+
+	if ((req->set_attrs = parse_gre_args(c, p, &req->iface, true)) == 0)
+		goto out;
+
+	if (gr_api_client_send_recv(c, GR_INFRA_IFACE_SET, len, req, NULL) < 0)
+		goto out;
+
+	ret = CMD_SUCCESS;
+out:
+	free(req);
+	return ret;
+}
+
+#define GRE_ATTRS_ARGS                                                                             \
+	IFACE_ATTRS_ARGS,                                                                          \
+		with_help("Local tunnel endpoint address.", ec_node_re("LOCAL", IPV4_RE)),         \
+		with_help("Remote tunnel endpoint address.", ec_node_re("REMOTE", IPV4_RE)),       \
+		with_help("Tunnel key.", ec_node_uint("KEY", 0, UINT32_MAX, 10))
+
+static int ctx_init(struct ec_node *root) {
+	int ret;
+
+	ret = CLI_COMMAND(
+		INTERFACE_ADD_CTX(root),
+		"gre NAME local LOCAL remote REMOTE [(key KEY)," IFACE_ATTRS_CMD "]",
+		gre_add,
+		"Create a new GRE tunnel interface.",
+		with_help("Interface name.", ec_node("any", "NAME")),
+		GRE_ATTRS_ARGS
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		INTERFACE_SET_CTX(root),
+		"gre NAME (name NEW_NAME),(local LOCAL),(remote REMOTE),(key KEY|nokey),"
+		IFACE_ATTRS_CMD,
+		gre_set,
+		"Modify gre parameters.",
+		with_help(
+			"Interface name.",
+			ec_node_dyn("NAME", complete_iface_names, INT2PTR(GR_IFACE_TYPE_GRE))
+		),
+		with_help("New interface name.", ec_node("any", "NEW_NAME")),
+		GRE_ATTRS_ARGS
+	);
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+static struct cli_context ctx = {
+	.name = "gre",
+	.init = ctx_init,
+};
+
+static void __attribute__((constructor, used)) init(void) {
+	cli_context_register(&ctx);
+	register_iface_type(&gre_type);
+}
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#include "gre_priv.h"
+
+#include <gr_fib4.h>
+#include <gr_gre.h>
+#include <gr_iface.h>
+#include <gr_infra.h>
+#include <gr_ip4_datapath.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_rcu.h>
+
+#include <event2/event.h>
+#include <rte_hash.h>
+
+#include <netinet/in.h>
+#include <string.h>
+
+struct gre_key {
+	ip4_addr_t local;
+	ip4_addr_t remote;
+	uint32_t key;
+	// Both fields are 16 bits wide so that the compiler does not insert any
+	// padding with undetermined contents (see ipip_key).
+	uint16_t keyed;
+	uint16_t vrf_id;
+};
+
+static struct rte_hash *gre_hash;
+
+struct iface *
+gre_get_iface(ip4_addr_t local, ip4_addr_t remote, bool keyed, uint32_t key, uint16_t vrf_id) {
+	struct gre_key k = {local, remote, keyed ? key : 0, keyed, vrf_id};
+	void *data;
+
+	if (rte_hash_lookup_data(gre_hash, &k, &data) < 0)
+		return NULL;
+
+	return data;
+}
+
+static void gre_template_build(struct iface_info_gre *gre) {
+	struct gre_template *t = &gre->template;
+
+	memset(t, 0, sizeof(*t));
+
+	t->ip.version_ihl = IPV4_VERSION_IHL;
+	t->ip.time_to_live = IPV4_DEFAULT_TTL;
+	t->ip.next_proto_id = IPPROTO_GRE;
+	t->ip.src_addr = gre->local;
+	t->ip.dst_addr = gre->remote;
+	// total_length is left to zero, it is added incrementally in gre_output.
+	t->ip.hdr_checksum = rte_ipv4_cksum(&t->ip);
+
+	// The protocol type is filled per packet depending on the payload.
+	gre->template_len = sizeof(t->ip) + sizeof(t->gre);
+	if (gre->key_present) {
+		t->gre.flags = GRE_F_KEY;
+		t->key = rte_cpu_to_be_32(gre->key);
+		gre->template_len += sizeof(t->key);
+	}
+}
+
+static int iface_gre_reconfig(
+	struct iface *iface,
+	uint64_t set_attrs,
+	const struct gr_iface *conf,
+	const void *api_info
+) {
+	struct iface_info_gre *cur = iface_info_gre(iface);
+	const struct gr_iface_info_gre *next = api_info;
+	struct gre_key cur_key = {
+		cur->local, cur->remote, cur->key, cur->key_present, iface->vrf_id
+	};
+	struct gre_key next_key = {next->local, next->remote, 0, next->key_present, conf->vrf_id};
+	void *data;
+	int ret;
+
+	if (next->key_present)
+		next_key.key = next->key;
+
+	if (set_attrs
+	    & (GR_IFACE_SET_VRF | GR_GRE_SET_LOCAL | GR_GRE_SET_REMOTE | GR_GRE_SET_KEY)) {
+		if (conf->vrf_id >= GR_MAX_VRFS)
+			return errno_set(EOVERFLOW);
+
+		if (rte_hash_lookup_data(gre_hash, &next_key, &data) >= 0 && data != iface)
+			return errno_set(EADDRINUSE);
+
+		if (fib4_lookup(conf->vrf_id, next->local) == NULL)
+			return -errno;
+		if (fib4_lookup(conf->vrf_id, next->remote) == NULL)
+			return -errno;
+
+		if (memcmp(&cur_key, &next_key, sizeof(cur_key)) != 0)
+			rte_hash_del_key(gre_hash, &cur_key);
+
+		if ((ret = rte_hash_add_key_data(gre_hash, &next_key, iface)) < 0)
+			return errno_log(-ret, "rte_hash_add_key_data");
+
+		cur->local = next->local;
+		cur->remote = next->remote;
+		cur->key = next_key.key;
+		cur->key_present = next->key_present;
+		gre_template_build(cur);
+	}
+
+	return 0;
+}
+
+static int iface_gre_fini(struct iface *iface) {
+	struct iface_info_gre *gre = iface_info_gre(iface);
+	struct gre_key key = {gre->local, gre->remote, gre->key, gre->key_present, iface->vrf_id};
+
+	rte_hash_del_key(gre_hash, &key);
+
+	return 0;
+}
+
+static int iface_gre_init(struct iface *iface, const void *api_info) {
+	const struct gr_iface_info_gre *gre = api_info;
+	struct gr_iface conf;
+	int ret;
+
+	if (iface->mtu == 0) {
+		iface->mtu = 1500 - sizeof(struct rte_ipv4_hdr) - sizeof(struct gre_hdr);
+		if (gre->key_present)
+			iface->mtu -= sizeof(rte_be32_t);
+	}
+
+	conf.base = iface->base;
+
+	ret = iface_gre_reconfig(iface, IFACE_SET_ALL, &conf, api_info);
+	if (ret < 0) {
+		iface_gre_fini(iface);
+		errno = -ret;
+	}
+
+	return ret;
+}
+
+static void gre_to_api(void *info, const struct iface *iface) {
+	const struct iface_info_gre *gre = iface_info_gre(iface);
+	struct gr_iface_info_gre *api = info;
+
+	*api = gre->base;
+}
+
+static struct iface_type iface_type_gre = {
+	.id = GR_IFACE_TYPE_GRE,
+	.name = "gre",
+	.pub_size = sizeof(struct gr_iface_info_gre),
+	.priv_size = sizeof(struct iface_info_gre),
+	.init = iface_gre_init,
+	.reconfig = iface_gre_reconfig,
+	.fini = iface_gre_fini,
+	.to_api = gre_to_api,
+};
+
+static void gre_init(struct event_base *) {
+	struct rte_hash_parameters params = {
+		.name = "gre",
+		.entries = MAX_IFACES,
+		.key_len = sizeof(struct gre_key),
+		.socket_id = SOCKET_ID_ANY,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF
+			| RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT,
+	};
+	gre_hash = rte_hash_create(&params);
+	if (gre_hash == NULL)
+		ABORT("rte_hash_create(gre)");
+
+	struct rte_hash_rcu_config rcu_config = {
+		.v = gr_datapath_rcu(), .mode = RTE_HASH_QSBR_MODE_SYNC
+	};
+	rte_hash_rcu_qsbr_add(gre_hash, &rcu_config);
+}
+
+static void gre_fini(struct event_base *) {
+	rte_hash_free(gre_hash);
+	gre_hash = NULL;
+}
+
+static struct gr_module gre_module = {
+	.name = "gre",
+	.depends_on = "rcu",
+	.init = gre_init,
+	.fini = gre_fini,
+};
+
+RTE_INIT(gre_constructor) {
+	gr_register_module(&gre_module);
+	iface_type_register(&iface_type_gre);
+}
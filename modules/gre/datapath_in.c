@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#include "gre_priv.h"
+
+#include <gr_datapath.h>
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_ip4_datapath.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_trace.h>
+
+#include <rte_byteorder.h>
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+
+#include <netinet/in.h>
+
+enum {
+	IP_INPUT = 0,
+	IP6_INPUT,
+	NO_TUNNEL,
+	BAD_HEADER,
+	UNKNOWN_PROTO,
+	IFACE_DOWN,
+	EDGE_COUNT,
+};
+
+int trace_gre_format(char *buf, size_t len, const void *data, size_t /*data_len*/) {
+	const struct trace_gre_data *t = data;
+	const struct iface *iface = iface_from_id(t->iface_id);
+	return snprintf(
+		buf,
+		len,
+		"iface=%s proto=0x%04x key=%u",
+		iface ? iface->name : "[deleted]",
+		rte_be_to_cpu_16(t->proto),
+		t->key
+	);
+}
+
+static uint16_t
+gre_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	struct eth_input_mbuf_data *eth_data;
+	struct ip_local_mbuf_data *ip_data;
+	ip4_addr_t last_src, last_dst;
+	uint32_t key, last_key;
+	bool keyed, last_keyed;
+	struct iface_stats *stats;
+	const struct gre_hdr *gre;
+	struct rte_mbuf *mbuf;
+	struct iface *iface, *last_iface;
+	uint16_t last_vrf_id;
+	rte_be16_t proto;
+	uint16_t hdr_len;
+	rte_edge_t edge;
+
+	last_iface = NULL;
+	last_src = 0;
+	last_dst = 0;
+	last_key = 0;
+	last_keyed = false;
+	last_vrf_id = GR_VRF_ID_ALL;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		mbuf = objs[i];
+		ip_data = ip_local_mbuf_data(mbuf);
+		iface = NULL;
+		proto = 0;
+		key = 0;
+
+		// ip_input_local has already stripped the outer IPv4 header.
+		if (unlikely(rte_pktmbuf_data_len(mbuf) < sizeof(*gre))) {
+			edge = BAD_HEADER;
+			goto next;
+		}
+		gre = rte_pktmbuf_mtod(mbuf, const struct gre_hdr *);
+		proto = gre->proto;
+		if (unlikely(gre->flags & GRE_F_UNSUPPORTED)) {
+			edge = BAD_HEADER;
+			goto next;
+		}
+
+		// Optional fields are stored in this order: checksum, key, sequence.
+		// The checksum is not verified.
+		hdr_len = sizeof(*gre);
+		if (gre->flags & GRE_F_CSUM)
+			hdr_len += sizeof(rte_be32_t);
+		keyed = gre->flags & GRE_F_KEY;
+		if (keyed) {
+			if (unlikely(rte_pktmbuf_data_len(mbuf) < hdr_len + sizeof(rte_be32_t))) {
+				edge = BAD_HEADER;
+				goto next;
+			}
+			key = rte_be_to_cpu_32(*rte_pktmbuf_mtod_offset(mbuf, rte_be32_t *, hdr_len));
+			hdr_len += sizeof(rte_be32_t);
+		}
+		if (gre->flags & GRE_F_SEQ)
+			hdr_len += sizeof(rte_be32_t);
+
+		if (ip_data->dst != last_dst || ip_data->src != last_src
+		    || ip_data->vrf_id != last_vrf_id || keyed != last_keyed || key != last_key) {
+			last_iface = gre_get_iface(
+				ip_data->dst, ip_data->src, keyed, key, ip_data->vrf_id
+			);
+			last_dst = ip_data->dst;
+			last_src = ip_data->src;
+			last_vrf_id = ip_data->vrf_id;
+			last_keyed = keyed;
+			last_key = key;
+		}
+		iface = last_iface;
+		if (iface == NULL) {
+			edge = NO_TUNNEL;
+			goto next;
+		}
+		if (!(iface->flags & GR_IFACE_F_UP)) {
+			edge = IFACE_DOWN;
+			goto next;
+		}
+
+		switch (proto) {
+		case RTE_BE16(RTE_ETHER_TYPE_IPV4):
+			mbuf->packet_type = RTE_PTYPE_L3_IPV4;
+			edge = IP_INPUT;
+			break;
+		case RTE_BE16(RTE_ETHER_TYPE_IPV6):
+			mbuf->packet_type = RTE_PTYPE_L3_IPV6;
+			edge = IP6_INPUT;
+			break;
+		default:
+			edge = UNKNOWN_PROTO;
+			goto next;
+		}
+		if (unlikely(rte_pktmbuf_adj(mbuf, hdr_len) == NULL)) {
+			edge = BAD_HEADER;
+			goto next;
+		}
+
+		// The hw checksum offload only works on the outer IP.
+		// Clear the offload flag so that ip_input will check it in software.
+		mbuf->ol_flags |= RTE_MBUF_F_RX_IP_CKSUM_NONE | RTE_MBUF_F_RX_L4_CKSUM_NONE;
+		eth_data = eth_input_mbuf_data(mbuf);
+		eth_data->iface = iface;
+		eth_data->domain = ETH_DOMAIN_LOCAL;
+		stats = iface_get_stats(rte_lcore_id(), iface->id);
+		stats->rx_packets += 1;
+		stats->rx_bytes += rte_pktmbuf_pkt_len(mbuf);
+next:
+		if (gr_mbuf_is_traced(mbuf) || (iface && iface->flags & GR_IFACE_F_PACKET_TRACE)) {
+			struct trace_gre_data *t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
+			t->iface_id = iface ? iface->id : 0;
+			t->proto = proto;
+			t->key = key;
+		}
+		rte_node_enqueue_x1(graph, node, edge, mbuf);
+	}
+
+	return nb_objs;
+}
+
+static void gre_input_register(void) {
+	ip_input_local_add_proto(IPPROTO_GRE, "gre_input");
+}
+
+static struct rte_node_register gre_input_node = {
+	.name = "gre_input",
+
+	.process = gre_input_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[IP_INPUT] = "ip_input",
+		[IP6_INPUT] = "ip6_input",
+		[NO_TUNNEL] = "gre_input_no_tunnel",
+		[BAD_HEADER] = "gre_input_bad_header",
+		[UNKNOWN_PROTO] = "gre_input_unknown_proto",
+		[IFACE_DOWN] = "iface_input_admin_down",
+	},
+};
+
+static struct gr_node_info gre_input_info = {
+	.node = &gre_input_node,
+	.register_callback = gre_input_register,
+	.trace_format = trace_gre_format,
+};
+
+GR_NODE_REGISTER(gre_input_info);
+
+GR_DROP_REGISTER(gre_input_no_tunnel);
+GR_DROP_REGISTER(gre_input_bad_header);
+GR_DROP_REGISTER(gre_input_unknown_proto);
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#include "gre_priv.h"
+
+#include <gr_datapath.h>
+#include <gr_fib4.h>
+#include <gr_graph.h>
+#include <gr_ip4_datapath.h>
+#include <gr_ip6_datapath.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_trace.h>
+
+#include <rte_byteorder.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+
+#include <string.h>
+
+enum {
+	IP_OUTPUT = 0,
+	NO_TUNNEL,
+	NO_HEADROOM,
+	IFACE_DOWN,
+	EDGE_COUNT,
+};
+
+static uint16_t
+gre_output_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	const struct iface_info_gre *gre;
+	struct ip_output_mbuf_data *ip_data;
+	struct gre_template *outer;
+	const struct iface *iface;
+	struct iface_stats *stats;
+	struct rte_mbuf *mbuf;
+	rte_be16_t proto;
+	rte_edge_t edge;
+	uint32_t sum;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		mbuf = objs[i];
+		gre = NULL;
+		proto = 0;
+
+		// ip_output and ip6_output store the output interface before
+		// dispatching to this node.
+		iface = mbuf_data(mbuf)->iface;
+		if (iface == NULL || iface->type != GR_IFACE_TYPE_GRE) {
+			edge = NO_TUNNEL;
+			goto next;
+		}
+		if (!(iface->flags & GR_IFACE_F_UP)) {
+			edge = IFACE_DOWN;
+			goto next;
+		}
+		gre = iface_info_gre(iface);
+
+		if ((*rte_pktmbuf_mtod(mbuf, const uint8_t *) >> 4) == 6)
+			proto = RTE_BE16(RTE_ETHER_TYPE_IPV6);
+		else
+			proto = RTE_BE16(RTE_ETHER_TYPE_IPV4);
+
+		outer = (struct gre_template *)rte_pktmbuf_prepend(mbuf, gre->template_len);
+		if (unlikely(outer == NULL)) {
+			edge = NO_HEADROOM;
+			goto next;
+		}
+		memcpy(outer, &gre->template, gre->template_len);
+		outer->gre.proto = proto;
+		outer->ip.total_length = rte_cpu_to_be_16(rte_pktmbuf_pkt_len(mbuf));
+
+		// Incremental checksum update (RFC 1624) from the template which was
+		// computed with a zero total_length.
+		sum = (uint16_t)~outer->ip.hdr_checksum;
+		sum += outer->ip.total_length;
+		sum = (sum & 0xffff) + (sum >> 16);
+		outer->ip.hdr_checksum = (uint16_t)~sum;
+
+		stats = iface_get_stats(rte_lcore_id(), iface->id);
+		stats->tx_packets += 1;
+		stats->tx_bytes += rte_pktmbuf_pkt_len(mbuf) - gre->template_len;
+
+		// Resolve nexthop for the encapsulated packet.
+		ip_data = ip_output_mbuf_data(mbuf);
+		ip_data->nh = fib4_lookup(iface->vrf_id, gre->remote);
+		edge = IP_OUTPUT;
+next:
+		if (gr_mbuf_is_traced(mbuf)) {
+			struct trace_gre_data *t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
+			t->iface_id = iface ? iface->id : 0;
+			t->proto = proto;
+			t->key = gre ? gre->key : 0;
+		}
+		rte_node_enqueue_x1(graph, node, edge, mbuf);
+	}
+
+	return nb_objs;
+}
+
+static void gre_output_register(void) {
+	ip_output_register_interface_type(GR_IFACE_TYPE_GRE, "gre_output");
+	ip6_output_register_interface_type(GR_IFACE_TYPE_GRE, "gre_output");
+}
+
+static struct rte_node_register gre_output_node = {
+	.name = "gre_output",
+
+	.process = gre_output_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[IP_OUTPUT] = "ip_output",
+		[NO_TUNNEL] = "gre_output_no_tunnel",
+		[NO_HEADROOM] = "error_no_headroom",
+		[IFACE_DOWN] = "iface_input_admin_down",
+	},
+};
+
+static struct gr_node_info gre_output_info = {
+	.node = &gre_output_node,
+	.register_callback = gre_output_register,
+	.trace_format = trace_gre_format,
+};
+
+GR_NODE_REGISTER(gre_output_info);
+
+GR_DROP_REGISTER(gre_output_no_tunnel);
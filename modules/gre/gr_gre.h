@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#pragma once
+
+#include <gr_api.h>
+#include <gr_bitops.h>
+#include <gr_infra.h>
+#include <gr_macro.h>
+#include <gr_net_types.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// GRE reconfig attributes
+#define GR_GRE_SET_LOCAL GR_BIT64(32)
+#define GR_GRE_SET_REMOTE GR_BIT64(33)
+#define GR_GRE_SET_KEY GR_BIT64(34)
+
+// Info for GR_IFACE_TYPE_GRE interfaces
+struct gr_iface_info_gre {
+	ip4_addr_t local;
+	ip4_addr_t remote;
+	uint32_t key; // Only used when key_present is true.
+	bool key_present;
+};
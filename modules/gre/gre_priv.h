@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#pragma once
+
+#include <gr_gre.h>
+#include <gr_iface.h>
+#include <gr_macro.h>
+#include <gr_net_types.h>
+
+#include <rte_byteorder.h>
+#include <rte_common.h>
+#include <rte_ip.h>
+
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// GRE header flags (RFC 2784, RFC 2890).
+#define GRE_F_CSUM RTE_BE16(0x8000)
+#define GRE_F_KEY RTE_BE16(0x2000)
+#define GRE_F_SEQ RTE_BE16(0x1000)
+// Routing, strict source route, recursion control, reserved flags and version.
+#define GRE_F_UNSUPPORTED RTE_BE16(0x4fff)
+
+struct gre_hdr {
+	rte_be16_t flags;
+	rte_be16_t proto;
+} __rte_packed;
+
+// Outer headers prepended to every encapsulated packet. The key field is
+// only present when the tunnel has a key.
+struct gre_template {
+	struct rte_ipv4_hdr ip;
+	struct gre_hdr gre;
+	rte_be32_t key;
+} __rte_packed;
+
+GR_IFACE_INFO(GR_IFACE_TYPE_GRE, iface_info_gre, {
+	BASE(gr_iface_info_gre);
+
+	// Built once in the control plane whenever the tunnel parameters change.
+	// The IPv4 checksum is computed with a zero total_length so that the
+	// datapath only needs to add the actual length incrementally.
+	uint8_t template_len;
+	struct gre_template template;
+});
+
+struct iface *
+gre_get_iface(ip4_addr_t local, ip4_addr_t remote, bool keyed, uint32_t key, uint16_t vrf_id);
+
+struct trace_gre_data {
+	uint16_t iface_id;
+	rte_be16_t proto;
+	uint32_t key;
+};
+
+int trace_gre_format(char *buf, size_t len, const void *data, size_t data_len);
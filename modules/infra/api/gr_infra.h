@@ -19,6 +19,10 @@ typedef enum : uint8_t {
 	GR_IFACE_TYPE_PORT,
 	GR_IFACE_TYPE_VLAN,
 	GR_IFACE_TYPE_IPIP,
+	GR_IFACE_TYPE_VXLAN,
+	GR_IFACE_TYPE_GRE,
+	GR_IFACE_TYPE_BRIDGE,
+	GR_IFACE_TYPE_VHOST,
 	GR_IFACE_TYPE_COUNT
 } gr_iface_type_t;
 
@@ -30,8 +34,26 @@ typedef enum : uint16_t {
 	GR_IFACE_F_PACKET_TRACE = GR_BIT16(3),
 	GR_IFACE_F_SNAT_STATIC = GR_BIT16(4),
 	GR_IFACE_F_SNAT_DYNAMIC = GR_BIT16(5),
+	GR_IFACE_F_ACL_IN = GR_BIT16(6),
+	GR_IFACE_F_ACL_OUT = GR_BIT16(7),
+	// Unicast reverse path forwarding (RFC 3704). Strict mode requires the
+	// route to the source address to point to the input interface. Loose mode
+	// only requires a route to the source address. Mutually exclusive.
+	GR_IFACE_F_URPF_STRICT = GR_BIT16(8),
+	GR_IFACE_F_URPF_LOOSE = GR_BIT16(9),
+	GR_IFACE_F_PBR = GR_BIT16(10),
+	GR_IFACE_F_POLICE = GR_BIT16(11),
+	GR_IFACE_F_SCHED = GR_BIT16(12),
 } gr_iface_flags_t;
 
+#define GR_IFACE_F_URPF (GR_IFACE_F_URPF_STRICT | GR_IFACE_F_URPF_LOOSE)
+
+// Flags managed by the NAT, ACL, PBR and QoS modules. Ignored in interface
+// add and set requests.
+#define GR_IFACE_F_INTERNAL                                                                        \
+	(GR_IFACE_F_SNAT_STATIC | GR_IFACE_F_SNAT_DYNAMIC | GR_IFACE_F_ACL_IN                      \
+	 | GR_IFACE_F_ACL_OUT | GR_IFACE_F_PBR | GR_IFACE_F_POLICE | GR_IFACE_F_SCHED)
+
 // Interface state flags
 typedef enum : uint16_t {
 	GR_IFACE_S_RUNNING = GR_BIT16(0),
@@ -53,6 +75,8 @@ typedef enum : uint16_t {
 typedef enum : uint8_t {
 	GR_IFACE_MODE_L3 = 0,
 	GR_IFACE_MODE_L1_XC,
+	GR_IFACE_MODE_L2_BRIDGE,
+	GR_IFACE_MODE_SRV6_L2,
 	GR_IFACE_MODE_COUNT
 } gr_iface_mode_t;
 
@@ -66,7 +90,7 @@ struct __gr_iface_base {
 	uint16_t mtu; // Maximum transmission unit size (incl. headers).
 	union {
 		uint16_t vrf_id; // L3 addressing and routing domain
-		uint16_t domain_id; // L2 xconnect peer interface id
+		uint16_t domain_id; // L1 xconnect peer or L2 bridge interface id
 	};
 };
 
@@ -107,11 +131,17 @@ struct gr_iface_info_port {
 #define GR_VLAN_SET_PARENT GR_BIT64(32)
 #define GR_VLAN_SET_VLAN GR_BIT64(33)
 #define GR_VLAN_SET_MAC GR_BIT64(34)
+#define GR_VLAN_SET_OUTER_VLAN GR_BIT64(35)
 
 // Info for GR_IFACE_TYPE_VLAN interfaces
+//
+// When outer_vlan_id is set, the interface is an 802.1ad (QinQ) sub-interface.
+// Packets carry an outer service tag (0x88a8) with outer_vlan_id followed by
+// an inner customer tag (0x8100) with vlan_id.
 struct gr_iface_info_vlan {
 	uint16_t parent_id;
 	uint16_t vlan_id;
+	uint16_t outer_vlan_id; //!< 0 for single tagged 802.1Q sub-interfaces.
 	struct rte_ether_addr mac;
 };
 
@@ -230,6 +260,7 @@ struct gr_infra_rxq_set_req {
 #define GR_INFRA_STAT_F_SW GR_BIT16(0) //!< include software stats
 #define GR_INFRA_STAT_F_HW GR_BIT16(1) //!< include hardware stats
 #define GR_INFRA_STAT_F_ZERO GR_BIT16(2) //!< include zero value stats
+#define GR_INFRA_STAT_F_MBUF GR_BIT16(3) //!< include packet buffer accounting
 typedef uint16_t gr_infra_stats_flags_t;
 
 #define GR_INFRA_STATS_GET REQUEST_TYPE(GR_INFRA_MODULE, 0x0020)
@@ -331,6 +362,14 @@ static inline const char *gr_iface_type_name(gr_iface_type_t type) {
 		return "vlan";
 	case GR_IFACE_TYPE_IPIP:
 		return "ipip";
+	case GR_IFACE_TYPE_VXLAN:
+		return "vxlan";
+	case GR_IFACE_TYPE_GRE:
+		return "gre";
+	case GR_IFACE_TYPE_BRIDGE:
+		return "bridge";
+	case GR_IFACE_TYPE_VHOST:
+		return "vhost";
 	case GR_IFACE_TYPE_COUNT:
 		break;
 	}
@@ -344,6 +383,10 @@ static inline const char *gr_iface_mode_name(gr_iface_mode_t mode) {
 		return "l3";
 	case GR_IFACE_MODE_L1_XC:
 		return "l1-xc";
+	case GR_IFACE_MODE_L2_BRIDGE:
+		return "l2-bridge";
+	case GR_IFACE_MODE_SRV6_L2:
+		return "srv6-l2";
 	case GR_IFACE_MODE_COUNT:
 		break;
 	}
@@ -33,6 +33,7 @@ typedef enum : uint8_t {
 	GR_NH_T_BLACKHOLE,
 	GR_NH_T_REJECT,
 	GR_NH_T_GROUP, // ECMP
+	GR_NH_T_MPLS, // Label imposition/swap
 #define GR_NH_T_ALL UINT8_C(0xff)
 } gr_nh_type_t;
 
@@ -180,6 +181,8 @@ static inline const char *gr_nh_type_name(const gr_nh_type_t type) {
 		return "reject";
 	case GR_NH_T_GROUP:
 		return "group";
+	case GR_NH_T_MPLS:
+		return "MPLS";
 	}
 	return "?";
 }
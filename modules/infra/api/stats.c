@@ -2,19 +2,25 @@
 // Copyright (c) 2024 Robin Jarry
 
 #include <gr_api.h>
+#include <gr_control_input.h>
+#include <gr_control_output.h>
 #include <gr_graph.h>
 #include <gr_infra.h>
 #include <gr_log.h>
+#include <gr_mbuf_debug.h>
 #include <gr_module.h>
+#include <gr_nh_control.h>
 #include <gr_port.h>
 #include <gr_vec.h>
 #include <gr_worker.h>
 
 #include <rte_common.h>
 #include <rte_ethdev.h>
+#include <rte_mempool.h>
 #include <rte_telemetry.h>
 
 #include <fnmatch.h>
+#include <stdarg.h>
 
 static struct gr_infra_stat *find_stat(gr_vec struct gr_infra_stat *stats, const char *name) {
 	struct gr_infra_stat *s;
@@ -92,6 +98,60 @@ static gr_vec struct gr_infra_stat *graph_stats(uint16_t cpu_id) {
 	return stats;
 }
 
+static void count_add(gr_vec struct gr_infra_stat **stats, uint64_t count, const char *fmt, ...) {
+	struct gr_infra_stat stat = {.packets = count};
+	va_list ap;
+
+	va_start(ap, fmt);
+	vsnprintf(stat.name, sizeof(stat.name), fmt, ap);
+	va_end(ap);
+
+	gr_vec_add(*stats, stat);
+}
+
+static void mempool_stats(struct rte_mempool *mp, void *priv) {
+	gr_vec struct gr_infra_stat **stats = priv;
+
+	if (mp->private_data_size != sizeof(struct rte_pktmbuf_pool_private))
+		return; // not a packet buffer pool
+
+	count_add(stats, rte_mempool_avail_count(mp), "mempool.%s.avail", mp->name);
+	count_add(stats, rte_mempool_in_use_count(mp), "mempool.%s.in_use", mp->name);
+}
+
+static void held_pkts_count(struct nexthop *nh, void *priv) {
+	uint64_t *held_pkts = priv;
+
+	if (nh->type == GR_NH_T_L3)
+		*held_pkts += nexthop_info_l3(nh)->held_pkts;
+}
+
+static void mbuf_stats(gr_vec struct gr_infra_stat **stats) {
+	struct mbuf_debug_scan scan = {0};
+	uint64_t held_pkts = 0;
+
+	rte_mempool_walk(mempool_stats, stats);
+	nexthop_iter(held_pkts_count, &held_pkts);
+	count_add(stats, held_pkts, "held_pkts");
+	count_add(stats, control_input_count(), "ring.control_input");
+	count_add(stats, control_output_count(), "ring.control_output");
+
+	if (mbuf_debug_offset < 0)
+		return; // leak detection disabled
+
+	// packets outside of their pool, by last visited node
+	mbuf_debug_scan(&scan);
+	count_add(stats, scan.drivers, "inflight.drivers");
+	for (rte_node_t id = 0; id < gr_vec_len(scan.inflight); id++) {
+		const char *name = rte_node_id_to_name(id);
+		if (name == NULL)
+			continue;
+		count_add(stats, scan.inflight[id], "inflight.%s", name);
+		count_add(stats, scan.leaked[id], "leaked.%s", name);
+	}
+	mbuf_debug_scan_free(&scan);
+}
+
 static bool skip_stat(const struct gr_infra_stat *s, gr_infra_stats_flags_t flags) {
 	if (flags & GR_INFRA_STAT_F_ZERO)
 		return false;
@@ -121,6 +181,9 @@ static struct api_out stats_get(const void *request, struct api_ctx *) {
 			return api_out(ENODEV, 0, NULL);
 	}
 
+	if (req->flags & GR_INFRA_STAT_F_MBUF)
+		mbuf_stats(&stats);
+
 	if (req->flags & GR_INFRA_STAT_F_HW) {
 		struct rte_eth_xstat_name *names = NULL;
 		struct rte_eth_xstat *xstats = NULL;
@@ -237,7 +300,7 @@ static struct api_out stats_reset(const void * /*request*/, struct api_ctx *) {
 	iface = NULL;
 
 	// Reset software stats for all interfaces.
-	memset(iface_stats, 0, sizeof(iface_stats));
+	memset(iface_stats, 0, MAX_IFACES * sizeof(*iface_stats));
 
 	while ((iface = iface_next(GR_IFACE_TYPE_PORT, iface)) != NULL) {
 		struct iface_info_port *port = iface_info_port(iface);
@@ -51,7 +51,8 @@ int complete_iface_names(
 #define INTERFACE_SET_CTX(root)                                                                    \
 	CLI_CONTEXT(root, INTERFACE_ARG, CTX_ARG("set", "Modify an existing interface."))
 
-#define IFACE_ATTRS_CMD "(up|down),(promisc PROMISC),(allmulti ALLMULTI),(mtu MTU),(vrf VRF)"
+#define IFACE_ATTRS_CMD                                                                            \
+	"(up|down),(promisc PROMISC),(allmulti ALLMULTI),(mtu MTU),(vrf VRF),(urpf URPF)"
 
 #define IFACE_ATTRS_ARGS                                                                           \
 	with_help("Set the interface UP.", ec_node_str("up", "up")),                               \
@@ -65,6 +66,10 @@ int complete_iface_names(
 		with_help(                                                                         \
 			"L3 addressing/routing domain ID.",                                        \
 			ec_node_uint("VRF", 0, UINT16_MAX - 1, 10)                                 \
+		),                                                                                 \
+		with_help(                                                                         \
+			"Unicast reverse path forwarding check mode.",                             \
+			ec_node_re("URPF", "strict|loose|off")                                     \
 		)
 
 uint64_t parse_iface_args(
@@ -132,6 +132,18 @@ static ssize_t iface_flags_format(char *buf, size_t len, const struct gr_iface *
 		SAFE_BUF(snprintf, len, " tracing");
 	if (iface->flags & (GR_IFACE_F_SNAT_STATIC | GR_IFACE_F_SNAT_DYNAMIC))
 		SAFE_BUF(snprintf, len, " snat");
+	if (iface->flags & (GR_IFACE_F_ACL_IN | GR_IFACE_F_ACL_OUT))
+		SAFE_BUF(snprintf, len, " acl");
+	if (iface->flags & GR_IFACE_F_PBR)
+		SAFE_BUF(snprintf, len, " pbr");
+	if (iface->flags & GR_IFACE_F_POLICE)
+		SAFE_BUF(snprintf, len, " police");
+	if (iface->flags & GR_IFACE_F_SCHED)
+		SAFE_BUF(snprintf, len, " sched");
+	if (iface->flags & GR_IFACE_F_URPF_STRICT)
+		SAFE_BUF(snprintf, len, " urpf-strict");
+	if (iface->flags & GR_IFACE_F_URPF_LOOSE)
+		SAFE_BUF(snprintf, len, " urpf-loose");
 
 	return n;
 err:
@@ -145,7 +157,7 @@ uint64_t parse_iface_args(
 	size_t info_size,
 	bool update
 ) {
-	const char *name, *promisc, *allmulti;
+	const char *name, *promisc, *allmulti, *urpf;
 	uint64_t set_attrs = 0;
 
 	name = arg_str(p, "NAME");
@@ -192,6 +204,16 @@ uint64_t parse_iface_args(
 		set_attrs |= GR_IFACE_SET_FLAGS;
 	}
 
+	urpf = arg_str(p, "URPF");
+	if (urpf != NULL) {
+		iface->flags &= ~GR_IFACE_F_URPF;
+		if (strcmp(urpf, "strict") == 0)
+			iface->flags |= GR_IFACE_F_URPF_STRICT;
+		else if (strcmp(urpf, "loose") == 0)
+			iface->flags |= GR_IFACE_F_URPF_LOOSE;
+		set_attrs |= GR_IFACE_SET_FLAGS;
+	}
+
 	if (arg_u16(p, "MTU", &iface->mtu) == 0)
 		set_attrs |= GR_IFACE_SET_MTU;
 
@@ -264,6 +286,12 @@ static cmd_status_t iface_list(struct gr_api_client *c, const struct ec_pnode *p
 		case GR_IFACE_MODE_L1_XC:
 			scols_line_set_data(line, 3, "XC");
 			break;
+		case GR_IFACE_MODE_L2_BRIDGE:
+			scols_line_set_data(line, 3, "BR");
+			break;
+		case GR_IFACE_MODE_SRV6_L2:
+			scols_line_set_data(line, 3, "SR");
+			break;
 		case GR_IFACE_MODE_L3:
 			scols_line_set_data(line, 3, "L3");
 			break;
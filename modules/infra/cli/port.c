@@ -36,6 +36,13 @@ static void port_show(struct gr_api_client *c, const struct gr_iface *iface) {
 		else
 			printf("xc_peer: %u\n", iface->domain_id);
 		free(peer);
+	} else if (iface->mode == GR_IFACE_MODE_L2_BRIDGE) {
+		struct gr_iface *bridge = iface_from_id(c, iface->domain_id);
+		if (bridge != NULL)
+			printf("bridge: %s\n", bridge->name);
+		else
+			printf("bridge: %u\n", iface->domain_id);
+		free(bridge);
 	}
 }
 
@@ -51,6 +58,11 @@ port_list_info(struct gr_api_client *c, const struct gr_iface *iface, char *buf,
 			SAFE_BUF(snprintf, len, " xc_peer=%s", peer->name);
 		else
 			SAFE_BUF(snprintf, len, " xc_peer=%u", iface->domain_id);
+	} else if (iface->mode == GR_IFACE_MODE_L2_BRIDGE) {
+		if ((peer = iface_from_id(c, iface->domain_id)) != NULL)
+			SAFE_BUF(snprintf, len, " bridge=%s", peer->name);
+		else
+			SAFE_BUF(snprintf, len, " bridge=%u", iface->domain_id);
 	}
 err:
 	free(peer);
@@ -111,6 +123,18 @@ static uint64_t parse_port_args(
 		iface->mode = GR_IFACE_MODE_L1_XC;
 		iface->domain_id = peer->id;
 		free(peer);
+	} else if (arg_str(p, "bridge")) {
+		struct gr_iface *bridge = iface_from_name(c, arg_str(p, "BRIDGE"));
+		if (bridge == NULL) {
+			errno = ENODEV;
+			goto err;
+		}
+
+		set_attrs |= GR_IFACE_SET_MODE;
+		set_attrs |= GR_IFACE_SET_DOMAIN;
+		iface->mode = GR_IFACE_MODE_L2_BRIDGE;
+		iface->domain_id = bridge->id;
+		free(bridge);
 	}
 
 	if (set_attrs == 0)
@@ -171,17 +195,29 @@ out:
 }
 
 #define PORT_ATTRS_CMD                                                                             \
-	IFACE_ATTRS_CMD ",(mac MAC),(rxqs N_RXQ),(qsize Q_SIZE),(mode l3|(xconnect PEER))"
+	IFACE_ATTRS_CMD                                                                            \
+	",(mac MAC),(rxqs N_RXQ),(qsize Q_SIZE),(mode l3|(xconnect PEER)|(bridge BRIDGE))"
 
 #define PORT_ATTRS_ARGS                                                                            \
 	IFACE_ATTRS_ARGS, with_help("Set the ethernet address.", ec_node_re("MAC", ETH_ADDR_RE)),  \
 		with_help("Number of Rx queues.", ec_node_uint("N_RXQ", 0, UINT16_MAX - 1, 10)),   \
 		with_help("Rx/Tx queues size.", ec_node_uint("Q_SIZE", 0, UINT16_MAX - 1, 10)),    \
-		with_help("mode: \"l3\" or \"xconnect\"", ec_node_str("l3", "l3")),                \
-		with_help("mode: \"l3\" or \"xconnect\"", ec_node_str("xconnect", "xconnect")),    \
+		with_help("mode: \"l3\", \"xconnect\" or \"bridge\"", ec_node_str("l3", "l3")),    \
+		with_help(                                                                         \
+			"mode: \"l3\", \"xconnect\" or \"bridge\"",                                \
+			ec_node_str("xconnect", "xconnect")                                        \
+		),                                                                                 \
+		with_help(                                                                         \
+			"mode: \"l3\", \"xconnect\" or \"bridge\"",                                \
+			ec_node_str("bridge", "bridge")                                            \
+		),                                                                                 \
 		with_help(                                                                         \
 			"Peer interface for xconnect",                                             \
 			ec_node_dyn("PEER", complete_iface_names, INT2PTR(GR_IFACE_TYPE_PORT))     \
+		),                                                                                 \
+		with_help(                                                                         \
+			"Bridge interface to join",                                                \
+			ec_node_dyn("BRIDGE", complete_iface_names, INT2PTR(GR_IFACE_TYPE_BRIDGE)) \
 		)
 
 static int ctx_init(struct ec_node *root) {
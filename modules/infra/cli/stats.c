@@ -60,6 +60,8 @@ static cmd_status_t stats_get(struct gr_api_client *c, const struct ec_pnode *p)
 
 	if (arg_str(p, "hardware") != NULL)
 		req.flags |= GR_INFRA_STAT_F_HW;
+	else if (arg_str(p, "mbuf") != NULL)
+		req.flags |= GR_INFRA_STAT_F_MBUF;
 	else
 		req.flags |= GR_INFRA_STAT_F_SW;
 	if (arg_str(p, "zero") != NULL)
@@ -86,16 +88,16 @@ static cmd_status_t stats_get(struct gr_api_client *c, const struct ec_pnode *p)
 		sort_func = stats_order_packets;
 	else if (strcmp(order, "graph") == 0)
 		sort_func = stats_order_topo;
-	else if (req.flags & GR_INFRA_STAT_F_HW || brief)
+	else if (req.flags & (GR_INFRA_STAT_F_HW | GR_INFRA_STAT_F_MBUF) || brief)
 		sort_func = stats_order_name;
 	else
 		sort_func = stats_order_cycles;
 
-	if (req.flags & GR_INFRA_STAT_F_HW || brief) {
+	if (req.flags & (GR_INFRA_STAT_F_HW | GR_INFRA_STAT_F_MBUF) || brief) {
 		qsort(resp->stats, resp->n_stats, sizeof(*resp->stats), sort_func);
 		for (size_t i = 0; i < resp->n_stats; i++) {
 			const struct gr_infra_stat *s = &resp->stats[i];
-			if (req.flags & GR_INFRA_STAT_F_HW || brief)
+			if (req.flags & (GR_INFRA_STAT_F_HW | GR_INFRA_STAT_F_MBUF) || brief)
 				printf("%s %lu\n", s->name, s->packets);
 		}
 	} else {
@@ -149,6 +151,80 @@ static cmd_status_t stats_reset(struct gr_api_client *c, const struct ec_pnode *
 	return CMD_SUCCESS;
 }
 
+// Upper bound in microseconds of the bucket where the given percentile falls.
+static uint64_t latency_percentile(const struct gr_api_latency *l, unsigned pct) {
+	uint64_t sum = 0;
+
+	if (l->count == 0)
+		return 0;
+
+	for (unsigned i = 0; i < GR_API_LATENCY_BUCKETS; i++) {
+		sum += l->buckets[i];
+		if (sum * 100 >= l->count * pct)
+			return i == GR_API_LATENCY_BUCKETS - 1 ? l->max_us : UINT64_C(1) << i;
+	}
+
+	return l->max_us;
+}
+
+static void latency_columns(struct libscols_line *line, int col, const struct gr_api_latency *l) {
+	scols_line_sprintf(line, col, "%lu", l->count ? l->total_us / l->count : 0);
+	scols_line_sprintf(line, col + 1, "%lu", latency_percentile(l, 99));
+	scols_line_sprintf(line, col + 2, "%lu", l->max_us);
+}
+
+static int api_stat_order(const void *sa, const void *sb) {
+	const struct gr_api_stat *a = sa;
+	const struct gr_api_stat *b = sb;
+	return strncmp(a->name, b->name, sizeof(a->name));
+}
+
+static cmd_status_t stats_api(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_api_stats_get_req req = {.reset = arg_str(p, "reset") != NULL};
+	struct gr_api_stats_get_resp *resp;
+	struct libscols_table *table;
+	void *resp_ptr = NULL;
+
+	if (gr_api_client_send_recv(c, GR_MAIN_API_STATS_GET, sizeof(req), &req, &resp_ptr) < 0)
+		return CMD_ERROR;
+
+	resp = resp_ptr;
+	qsort(resp->stats, resp->n_stats, sizeof(*resp->stats), api_stat_order);
+
+	table = scols_new_table();
+	scols_table_new_column(table, "REQUEST", 0, 0);
+	scols_table_new_column(table, "COUNT", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "ERRORS", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "QUEUE_AVG", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "QUEUE_P99", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "QUEUE_MAX", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "HANDLER_AVG", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "HANDLER_P99", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "HANDLER_MAX", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "VISIBLE_AVG", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "VISIBLE_P99", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "VISIBLE_MAX", 0, SCOLS_FL_RIGHT);
+	scols_table_set_column_separator(table, "  ");
+
+	for (uint16_t i = 0; i < resp->n_stats; i++) {
+		struct libscols_line *line = scols_table_new_line(table, NULL);
+		const struct gr_api_stat *s = &resp->stats[i];
+
+		scols_line_sprintf(line, 0, "%s", s->name);
+		scols_line_sprintf(line, 1, "%lu", s->handler.count);
+		scols_line_sprintf(line, 2, "%lu", s->errors);
+		latency_columns(line, 3, &s->queue);
+		latency_columns(line, 6, &s->handler);
+		latency_columns(line, 9, &s->visible);
+	}
+
+	scols_print_table(table);
+	scols_unref_table(table);
+	free(resp_ptr);
+
+	return CMD_SUCCESS;
+}
+
 #define STATS_CTX(root) CLI_CONTEXT(root, CTX_ARG("stats", "Packet processing statistics."))
 
 static int ctx_init(struct ec_node *root) {
@@ -159,11 +235,22 @@ static int ctx_init(struct ec_node *root) {
 		return ret;
 	ret = CLI_COMMAND(
 		STATS_CTX(root),
-		"[show] [(software|hardware),brief,zero,(pattern PATTERN),(cpu CPU),(order ORDER)]",
+		"api [reset]",
+		stats_api,
+		"Print API request latencies in microseconds.",
+		with_help("Reset API stats after printing them.", ec_node_str("reset", "reset"))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		STATS_CTX(root),
+		"[show] [(software|hardware|mbuf),brief,zero,"
+		"(pattern PATTERN),(cpu CPU),(order ORDER)]",
 		stats_get,
 		"Print statistics.",
 		with_help("Print software stats (default).", ec_node_str("software", "software")),
 		with_help("Print hardware stats.", ec_node_str("hardware", "hardware")),
+		with_help("Print packet buffer accounting.", ec_node_str("mbuf", "mbuf")),
 		with_help("Only print packet counts.", ec_node_str("brief", "brief")),
 		with_help(
 			"Only return stats from one CPU.",
@@ -5,6 +5,7 @@
 #include <gr_cli.h>
 #include <gr_cli_iface.h>
 #include <gr_infra.h>
+#include <gr_macro.h>
 #include <gr_net_types.h>
 #include <gr_table.h>
 
@@ -22,6 +23,8 @@ static void vlan_show(struct gr_api_client *c, const struct gr_iface *iface) {
 		printf("parent: %u\n", vlan->parent_id);
 	else
 		printf("parent: %s\n", parent->name);
+	if (vlan->outer_vlan_id != 0)
+		printf("outer_vlan_id: %u\n", vlan->outer_vlan_id);
 	printf("vlan_id: %u\n", vlan->vlan_id);
 
 	free(parent);
@@ -31,12 +34,16 @@ static void
 vlan_list_info(struct gr_api_client *c, const struct gr_iface *iface, char *buf, size_t len) {
 	const struct gr_iface_info_vlan *vlan = PAYLOAD(iface);
 	struct gr_iface *parent = iface_from_id(c, vlan->parent_id);
+	ssize_t n = 0;
 
 	if (parent == NULL)
-		snprintf(buf, len, "parent=%u vlan_id=%u", vlan->parent_id, vlan->vlan_id);
+		SAFE_BUF(snprintf, len, "parent=%u", vlan->parent_id);
 	else
-		snprintf(buf, len, "parent=%s vlan_id=%u", parent->name, vlan->vlan_id);
-
+		SAFE_BUF(snprintf, len, "parent=%s", parent->name);
+	if (vlan->outer_vlan_id != 0)
+		SAFE_BUF(snprintf, len, " outer_vlan_id=%u", vlan->outer_vlan_id);
+	SAFE_BUF(snprintf, len, " vlan_id=%u", vlan->vlan_id);
+err:
 	free(parent);
 }
 
@@ -76,6 +83,9 @@ static uint64_t parse_vlan_args(
 	if (arg_u16(p, "VLAN", &vlan->vlan_id) == 0)
 		set_attrs |= GR_VLAN_SET_VLAN;
 
+	if (arg_u16(p, "OUTER", &vlan->outer_vlan_id) == 0)
+		set_attrs |= GR_VLAN_SET_OUTER_VLAN;
+
 	if (arg_eth_addr(p, "MAC", &vlan->mac) == 0) {
 		set_attrs |= GR_VLAN_SET_MAC;
 	} else if (!update) {
@@ -149,10 +159,14 @@ out:
 	return ret;
 }
 
-#define VLAN_ATTRS_CMD IFACE_ATTRS_CMD ",(mac MAC)"
+#define VLAN_ATTRS_CMD IFACE_ATTRS_CMD ",(mac MAC),(outer_vlan_id OUTER)"
 
 #define VLAN_ATTRS_ARGS                                                                            \
-	IFACE_ATTRS_ARGS, with_help("Set the ethernet address.", ec_node_re("MAC", ETH_ADDR_RE))
+	IFACE_ATTRS_ARGS, with_help("Set the ethernet address.", ec_node_re("MAC", ETH_ADDR_RE)),  \
+		with_help(                                                                         \
+			"802.1ad outer VLAN ID, 0 for single tagged.",                             \
+			ec_node_uint("OUTER", 0, 4095, 10)                                         \
+		)
 
 static int ctx_init(struct ec_node *root) {
 	int ret;
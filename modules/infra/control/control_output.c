@@ -21,6 +21,10 @@ int control_output_enqueue(struct rte_mbuf *m) {
 	return rte_ring_enqueue(ctrlout_ring, m);
 }
 
+unsigned control_output_count(void) {
+	return rte_ring_count(ctrlout_ring);
+}
+
 static void control_output_poll(evutil_socket_t, short, void *) {
 	struct control_output_mbuf_data *data;
 	struct rte_mbuf *mbuf;
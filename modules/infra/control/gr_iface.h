@@ -96,7 +96,8 @@ struct __rte_cache_aligned iface_stats {
 
 #define MAX_IFACES 1024
 
-extern struct iface_stats iface_stats[MAX_IFACES][RTE_MAX_LCORE];
+// Allocated in shared memory, see gr_shm.h.
+extern struct iface_stats (*iface_stats)[RTE_MAX_LCORE];
 static inline struct iface_stats *iface_get_stats(uint16_t lcore_id, uint16_t ifid) {
 	return &iface_stats[ifid][lcore_id];
 }
@@ -3,7 +3,18 @@
 
 #pragma once
 
+#include <rte_mbuf.h>
 #include <rte_mempool.h>
 
+// Size of mbuf data buffers, including RTE_PKTMBUF_HEADROOM. Frames that do
+// not fit in a single buffer are received in a chain of segments.
+#define GR_MBUF_DATA_ROOM RTE_MBUF_DEFAULT_BUF_SIZE
+
+// Largest ethernet frame that may be received according to --max-mtu.
+uint32_t gr_pktmbuf_frame_len_max(void);
+
 struct rte_mempool *gr_pktmbuf_pool_get(int8_t socket_id, uint32_t count);
+// Same as gr_pktmbuf_pool_get() but with buffers large enough to hold the
+// largest frame. Only needed for ports that do not support scattered RX.
+struct rte_mempool *gr_pktmbuf_jumbo_pool_get(int8_t socket_id, uint32_t count);
 void gr_pktmbuf_pool_release(struct rte_mempool *mp, uint32_t count);
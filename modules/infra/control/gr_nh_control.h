@@ -67,6 +67,33 @@ GR_NH_TYPE_INFO(GR_NH_T_GROUP, nexthop_info_group, {
 	struct nh_group_member *members;
 });
 
+// Unicast reverse path forwarding check (RFC 3704) of a packet received on
+// iface_id. nh is the result of the route lookup of the packet source address.
+static inline bool nexthop_urpf_check(const struct nexthop *nh, uint16_t iface_id, bool strict) {
+	const struct nexthop_info_group *g;
+
+	if (nh == NULL)
+		return false;
+
+	switch (nh->type) {
+	case GR_NH_T_BLACKHOLE:
+	case GR_NH_T_REJECT:
+		return false;
+	case GR_NH_T_GROUP:
+		if (!strict)
+			return true;
+		// Any ECMP path to the source is acceptable.
+		g = nexthop_info_group(nh);
+		for (uint32_t i = 0; i < g->n_members; i++) {
+			if (g->members[i].nh->iface_id == iface_id)
+				return true;
+		}
+		return false;
+	default:
+		return !strict || nh->iface_id == iface_id;
+	}
+}
+
 // Lookup a nexthop from the global pool that matches the specified criteria.
 struct nexthop *
 nexthop_lookup(addr_family_t af, uint16_t vrf_id, uint16_t iface_id, const void *addr);
@@ -35,6 +35,7 @@ GR_IFACE_INFO(GR_IFACE_TYPE_PORT, iface_info_port, {
 	struct rte_mempool *pool;
 	char *devargs;
 	uint32_t pool_size;
+	uint64_t tx_offloads;
 	struct mac_filter ucast_filter;
 	struct mac_filter mcast_filter;
 });
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_iface.h>
+#include <gr_infra.h>
+#include <gr_worker.h>
+
+#include <rte_graph.h>
+#include <rte_seqlock.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+// Memory zones exported to DPDK secondary processes. They can be looked up
+// with rte_memzone_lookup() once attached to a primary started with
+// --file-prefix. Secondary processes must treat them as read-only.
+#define GR_SHM_MZ_NAME "grout_shm"
+#define GR_SHM_IFACE_STATS_MZ_NAME "grout_iface_stats"
+
+#define GR_SHM_MAGIC 0x67727368 // "grsh"
+#define GR_SHM_VERSION 1
+#define GR_SHM_MAX_NODES 512
+
+struct gr_shm_iface {
+	BASE(__gr_iface_base);
+	char name[GR_IFACE_NAME_SIZE];
+};
+
+struct gr_shm {
+	uint32_t magic;
+	uint32_t version;
+	// Size of the exported arrays, must be checked by readers.
+	uint16_t max_ifaces;
+	uint16_t max_lcores;
+	uint16_t max_nodes;
+	uint16_t n_nodes;
+	uint64_t tsc_hz;
+	pid_t pid;
+
+	// Protects node_names and ifaces. Only the control plane thread
+	// writes. Readers must use rte_seqlock_read_begin/retry.
+	rte_seqlock_t lock;
+	char node_names[GR_SHM_MAX_NODES][RTE_NODE_NAMESIZE];
+	// Indexed by interface id. Unused entries have id = GR_IFACE_ID_UNDEF.
+	struct gr_shm_iface ifaces[MAX_IFACES];
+
+	// Indexed by lcore id, written by each datapath worker when it starts
+	// and stops. The worker structures live in shared huge page memory.
+	// Their stats pointer may change when a graph is reloaded.
+	_Atomic(const struct worker *) workers[RTE_MAX_LCORE];
+};
+
+// NULL until the infra shm module is initialized.
+extern struct gr_shm *gr_shm;
+
+// Export the names of graph nodes created since the last call.
+void gr_shm_nodes_update(void);
@@ -8,9 +8,42 @@
 #include <rte_ether.h>
 #include <rte_mempool.h>
 
+#include <stdatomic.h>
 #include <stdint.h>
 #include <sys/queue.h>
 
 GR_IFACE_INFO(GR_IFACE_TYPE_VLAN, iface_info_vlan, { BASE(gr_iface_info_vlan); });
 
 struct iface *vlan_get_iface(uint16_t port_id, uint16_t vlan_id);
+
+#define VLAN_ID_COUNT 4096
+
+// QinQ sub-interfaces of a parent port indexed by inner VLAN ID.
+struct qinq_inner {
+	_Atomic(struct iface *) ifaces[VLAN_ID_COUNT];
+	uint16_t count;
+};
+
+// Inner tables of a parent port indexed by outer VLAN ID. Both levels are
+// allocated on demand when the first QinQ sub-interface is created.
+struct qinq_outer {
+	_Atomic(struct qinq_inner *) inner[VLAN_ID_COUNT];
+	uint16_t count;
+};
+
+extern _Atomic(struct qinq_outer *) qinq_parents[MAX_IFACES];
+
+static inline struct iface *
+qinq_get_iface(uint16_t parent_id, uint16_t outer_vlan_id, uint16_t vlan_id) {
+	const struct qinq_outer *outer;
+	const struct qinq_inner *inner;
+
+	outer = atomic_load_explicit(&qinq_parents[parent_id], memory_order_acquire);
+	if (outer == NULL)
+		return NULL;
+	inner = atomic_load_explicit(&outer->inner[outer_vlan_id], memory_order_acquire);
+	if (inner == NULL)
+		return NULL;
+
+	return atomic_load_explicit(&inner->ifaces[vlan_id], memory_order_acquire);
+}
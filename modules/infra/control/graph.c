@@ -3,14 +3,17 @@
 
 #include "graph_priv.h"
 
+#include <gr_config.h>
 #include <gr_datapath.h>
 #include <gr_graph.h>
 #include <gr_infra.h>
 #include <gr_log.h>
+#include <gr_mbuf_debug.h>
 #include <gr_module.h>
 #include <gr_port.h>
 #include <gr_queue.h>
 #include <gr_rxtx.h>
+#include <gr_shm.h>
 #include <gr_string.h>
 #include <gr_vec.h>
 #include <gr_worker.h>
@@ -298,6 +301,9 @@ static gr_vec rte_node_t *worker_graph_nodes_add_missing(gr_vec struct iface_inf
 	gr_strvec_free(old_rx);
 	gr_strvec_free(old_tx);
 
+	// new port_rx and port_tx clones must be visible to secondary processes
+	gr_shm_nodes_update();
+
 	return unused_nodes;
 }
 
@@ -448,6 +454,7 @@ static struct gr_api_handler graph_dump_handler = {
 
 static void graph_init(struct event_base *) {
 	struct rte_node_register *reg;
+	rte_node_process_t process;
 	struct gr_node_info *info;
 
 	// register nodes first
@@ -455,10 +462,15 @@ static void graph_init(struct event_base *) {
 		if (info->node == NULL)
 			ABORT("info->node == NULL");
 		reg = info->node;
+		process = reg->process;
+		if (gr_config.mbuf_leak_timeout != 0)
+			reg->process = mbuf_debug_process;
 		reg->parent_id = RTE_NODE_ID_INVALID;
 		reg->id = __rte_node_register(reg);
 		if (reg->id == RTE_NODE_ID_INVALID)
 			ABORT("__rte_node_register(%s): %s", reg->name, rte_strerror(rte_errno));
+		if (gr_config.mbuf_leak_timeout != 0)
+			mbuf_debug_node_add(reg->id, process);
 
 		if (strcmp(reg->name, RX_NODE_BASE) == 0)
 			port_rx_node = reg->id;
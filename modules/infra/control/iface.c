@@ -9,11 +9,13 @@
 #include <gr_module.h>
 #include <gr_nh_control.h>
 #include <gr_rcu.h>
+#include <gr_shm.h>
 #include <gr_string.h>
 #include <gr_vec.h>
 
 #include <event2/event.h>
 #include <rte_malloc.h>
+#include <rte_memzone.h>
 
 #include <errno.h>
 #include <string.h>
@@ -23,7 +25,8 @@
 
 static STAILQ_HEAD(, iface_type) types = STAILQ_HEAD_INITIALIZER(types);
 
-struct iface_stats iface_stats[MAX_IFACES][RTE_MAX_LCORE];
+struct iface_stats (*iface_stats)[RTE_MAX_LCORE];
+static const struct rte_memzone *iface_stats_mz;
 
 const struct iface_type *iface_type_get(gr_iface_type_t type_id) {
 	struct iface_type *t;
@@ -72,6 +75,37 @@ static int next_ifid(uint16_t *ifid) {
 	return errno_set(ENOSPC);
 }
 
+// Validate the L3 or L2 domain of an interface according to its mode.
+static int iface_check_domain(gr_iface_type_t type, gr_iface_mode_t mode, uint16_t domain_id) {
+	const struct iface *domain;
+
+	switch (mode) {
+	case GR_IFACE_MODE_L3:
+		if (domain_id >= GR_MAX_VRFS)
+			return errno_set(EOVERFLOW);
+		break;
+	case GR_IFACE_MODE_L1_XC:
+		if (iface_from_id(domain_id) == NULL)
+			return -errno;
+		break;
+	case GR_IFACE_MODE_L2_BRIDGE:
+		if ((domain = iface_from_id(domain_id)) == NULL)
+			return -errno;
+		if (domain->type != GR_IFACE_TYPE_BRIDGE || type != GR_IFACE_TYPE_PORT)
+			return errno_set(EMEDIUMTYPE);
+		break;
+	case GR_IFACE_MODE_SRV6_L2:
+		// The encapsulation nexthop is managed by the srv6 module.
+		if (type != GR_IFACE_TYPE_PORT)
+			return errno_set(EMEDIUMTYPE);
+		break;
+	default:
+		return errno_set(EINVAL);
+	}
+
+	return 0;
+}
+
 struct iface *iface_create(const struct gr_iface *conf, const void *api_info) {
 	const struct iface_type *type = iface_type_get(conf->type);
 	struct iface *iface = NULL;
@@ -82,6 +116,10 @@ struct iface *iface_create(const struct gr_iface *conf, const void *api_info) {
 		goto fail;
 	if (charset_check(conf->name, GR_IFACE_NAME_SIZE) < 0)
 		goto fail;
+	if ((conf->flags & GR_IFACE_F_URPF) == GR_IFACE_F_URPF) {
+		errno = EINVAL;
+		goto fail;
+	}
 	while ((iface = iface_next(GR_IFACE_TYPE_UNDEF, iface)) != NULL) {
 		if (strcmp(conf->name, iface->name) == 0) {
 			iface = NULL;
@@ -96,8 +134,12 @@ struct iface *iface_create(const struct gr_iface *conf, const void *api_info) {
 		goto fail;
 	}
 	if (conf->type != GR_IFACE_TYPE_LOOPBACK) {
-		vrf_incref(conf->vrf_id);
-		vrf_ref = true;
+		if (iface_check_domain(conf->type, conf->mode, conf->domain_id) < 0)
+			goto fail;
+		if (conf->mode == GR_IFACE_MODE_L3) {
+			vrf_incref(conf->vrf_id);
+			vrf_ref = true;
+		}
 	}
 	if (conf->type == GR_IFACE_TYPE_LOOPBACK && conf->vrf_id) {
 		ifid = conf->vrf_id;
@@ -107,6 +149,8 @@ struct iface *iface_create(const struct gr_iface *conf, const void *api_info) {
 		goto fail;
 
 	iface->base = conf->base;
+	// Internal flags are only set by their owner modules.
+	iface->flags &= ~GR_IFACE_F_INTERNAL;
 	iface->id = ifid;
 	// this is only accessed by the API, no need to copy the name to DPDK memory (hugepages)
 	iface->name = strndup(conf->name, GR_IFACE_NAME_SIZE);
@@ -151,9 +195,10 @@ int iface_reconfig(
 	const struct gr_iface *conf,
 	const void *api_info
 ) {
+	uint16_t old_domain_id, domain_id;
+	gr_iface_mode_t old_mode, mode;
 	const struct iface_type *type;
 	struct iface *iface;
-	uint16_t old_vrf_id;
 	int ret;
 
 	if (set_attrs == 0)
@@ -161,6 +206,9 @@ int iface_reconfig(
 
 	if ((iface = iface_from_id(ifid)) == NULL)
 		return -errno;
+	if (set_attrs & GR_IFACE_SET_FLAGS
+	    && (conf->flags & GR_IFACE_F_URPF) == GR_IFACE_F_URPF)
+		return errno_set(EINVAL);
 	if (set_attrs & GR_IFACE_SET_NAME) {
 		if (charset_check(conf->name, GR_IFACE_NAME_SIZE) < 0)
 			return -errno;
@@ -180,27 +228,32 @@ int iface_reconfig(
 	type = iface_type_get(iface->type);
 	assert(type != NULL);
 
-	if (set_attrs & GR_IFACE_SET_VRF) {
-		if (conf->vrf_id >= GR_MAX_VRFS)
-			return errno_set(EOVERFLOW);
-		old_vrf_id = iface->vrf_id;
-		vrf_incref(conf->vrf_id);
+	old_mode = iface->mode;
+	old_domain_id = iface->domain_id;
+	mode = set_attrs & GR_IFACE_SET_MODE ? conf->mode : old_mode;
+	domain_id = set_attrs & GR_IFACE_SET_DOMAIN ? conf->domain_id : old_domain_id;
+
+	if (set_attrs & (GR_IFACE_SET_MODE | GR_IFACE_SET_DOMAIN)) {
+		if (iface_check_domain(iface->type, mode, domain_id) < 0)
+			return -errno;
+		// Only L3 interfaces hold a reference on their VRF.
+		if (mode == GR_IFACE_MODE_L3)
+			vrf_incref(domain_id);
 	}
 
 	ret = type->reconfig(iface, set_attrs, conf, api_info);
 	if (ret < 0) {
-		if (set_attrs & GR_IFACE_SET_VRF)
-			vrf_decref(conf->vrf_id);
+		if (set_attrs & (GR_IFACE_SET_MODE | GR_IFACE_SET_DOMAIN)
+		    && mode == GR_IFACE_MODE_L3)
+			vrf_decref(domain_id);
 		return ret;
 	}
 
-	if (set_attrs & GR_IFACE_SET_VRF) {
-		iface->vrf_id = conf->vrf_id;
-		vrf_decref(old_vrf_id);
-	}
-
-	if (set_attrs & GR_IFACE_SET_MODE) {
-		iface->mode = conf->mode;
+	if (set_attrs & (GR_IFACE_SET_MODE | GR_IFACE_SET_DOMAIN)) {
+		iface->mode = mode;
+		iface->domain_id = domain_id;
+		if (old_mode == GR_IFACE_MODE_L3)
+			vrf_decref(old_domain_id);
 	}
 
 	if (set_attrs & GR_IFACE_SET_MTU) {
@@ -209,12 +262,15 @@ int iface_reconfig(
 	}
 
 	if (set_attrs & GR_IFACE_SET_FLAGS) {
-		if ((ret = iface_set_promisc(iface->id, conf->flags & GR_IFACE_F_PROMISC)) < 0)
+		gr_iface_flags_t flags = conf->flags & ~GR_IFACE_F_INTERNAL;
+		if ((ret = iface_set_promisc(iface->id, flags & GR_IFACE_F_PROMISC)) < 0)
 			return ret;
-		if ((ret = iface_set_allmulti(iface->id, conf->flags & GR_IFACE_F_ALLMULTI)) < 0)
+		if ((ret = iface_set_allmulti(iface->id, flags & GR_IFACE_F_ALLMULTI)) < 0)
 			return ret;
-		if ((ret = iface_set_up_down(iface->id, conf->flags & GR_IFACE_F_UP)) < 0)
+		if ((ret = iface_set_up_down(iface->id, flags & GR_IFACE_F_UP)) < 0)
 			return ret;
+		iface->flags &= ~GR_IFACE_F_URPF;
+		iface->flags |= flags & GR_IFACE_F_URPF;
 	}
 
 	gr_event_push(GR_EVENT_IFACE_POST_RECONFIG, iface);
@@ -453,13 +509,21 @@ int iface_destroy(uint16_t ifid) {
 	if (gr_vec_len(iface->subinterfaces) != 0)
 		return errno_set(EBUSY);
 
+	// bridge members must be detached first
+	for (uint16_t i = IFACE_ID_FIRST; i < MAX_IFACES; i++) {
+		const struct iface *member = ifaces[i];
+		if (member != NULL && member->mode == GR_IFACE_MODE_L2_BRIDGE
+		    && member->domain_id == ifid)
+			return errno_set(EBUSY);
+	}
+
 	// interface is still up, send status down
 	if (iface->flags & GR_IFACE_F_UP) {
 		iface->flags &= ~GR_IFACE_F_UP;
 		gr_event_push(GR_EVENT_IFACE_STATUS_DOWN, iface);
 	}
 	gr_event_push(GR_EVENT_IFACE_PRE_REMOVE, iface);
-	if (iface->type != GR_IFACE_TYPE_LOOPBACK)
+	if (iface->type != GR_IFACE_TYPE_LOOPBACK && iface->mode == GR_IFACE_MODE_L3)
 		vrf_decref(iface->vrf_id);
 	nexthop_iface_cleanup(ifid);
 
@@ -481,6 +545,18 @@ static void iface_init(struct event_base *) {
 	ifaces = rte_calloc(__func__, MAX_IFACES, sizeof(struct iface *), RTE_CACHE_LINE_SIZE);
 	if (ifaces == NULL)
 		ABORT("rte_calloc(ifaces)");
+
+	// Stored in a named memory zone so that secondary processes can read them.
+	iface_stats_mz = rte_memzone_reserve(
+		GR_SHM_IFACE_STATS_MZ_NAME,
+		MAX_IFACES * sizeof(*iface_stats),
+		SOCKET_ID_ANY,
+		RTE_MEMZONE_SIZE_HINT_ONLY
+	);
+	if (iface_stats_mz == NULL)
+		ABORT("rte_memzone_reserve(iface_stats): %s", rte_strerror(rte_errno));
+	iface_stats = iface_stats_mz->addr;
+	memset(iface_stats, 0, iface_stats_mz->len);
 }
 
 static void iface_fini(struct event_base *) {
@@ -488,17 +564,28 @@ static void iface_fini(struct event_base *) {
 	uint16_t ifid;
 
 	// Destroy all virtual interface first before removing DPDK ports.
+	// Bridges are kept until their member ports are gone.
 	for (ifid = IFACE_ID_FIRST; ifid < MAX_IFACES; ifid++) {
 		iface = ifaces[ifid];
 		if (iface != NULL && iface->type != GR_IFACE_TYPE_PORT
-		    && iface->type != GR_IFACE_TYPE_LOOPBACK) {
+		    && iface->type != GR_IFACE_TYPE_LOOPBACK
+		    && iface->type != GR_IFACE_TYPE_BRIDGE) {
 			if (iface_destroy(ifid) < 0)
 				LOG(ERR, "iface_destroy: %s", strerror(errno));
 			ifaces[ifid] = NULL;
 		}
 	}
 
-	// Finally, destroy DPDK ports.
+	// Then, destroy DPDK ports.
+	for (ifid = IFACE_ID_FIRST; ifid < MAX_IFACES; ifid++) {
+		iface = ifaces[ifid];
+		if (iface == NULL || iface->type != GR_IFACE_TYPE_PORT)
+			continue;
+		if (iface_destroy(ifid) < 0)
+			LOG(ERR, "iface_destroy: %s", strerror(errno));
+	}
+
+	// Finally, destroy bridges.
 	for (ifid = IFACE_ID_FIRST; ifid < MAX_IFACES; ifid++) {
 		iface = ifaces[ifid];
 		if (iface == NULL || iface->type == GR_IFACE_TYPE_LOOPBACK)
@@ -509,6 +596,9 @@ static void iface_fini(struct event_base *) {
 
 	rte_free(ifaces);
 	ifaces = NULL;
+	iface_stats = NULL;
+	rte_memzone_free(iface_stats_mz);
+	iface_stats_mz = NULL;
 }
 
 static struct gr_module iface_module = {
@@ -9,6 +9,8 @@
 #include <gr_infra.h>
 #include <gr_log.h>
 #include <gr_loopback.h>
+#include <gr_macro.h>
+#include <gr_mbuf.h>
 #include <gr_mempool.h>
 #include <gr_module.h>
 
@@ -27,6 +29,7 @@
 #include <unistd.h>
 
 #define TUN_TAP_DEV_PATH "/dev/net/tun"
+#define LOOPBACK_MAX_SEGS 16
 
 static struct rte_mempool *loopback_pool;
 static struct event_base *ev_base;
@@ -107,13 +110,14 @@ end:
 static void iface_loopback_poll(evutil_socket_t, short reason, void *ev_iface) {
 	struct iface_info_loopback *lo;
 	struct iface *iface = ev_iface;
+	struct iovec iov[LOOPBACK_MAX_SEGS];
 	struct eth_input_mbuf_data *e;
+	struct rte_mbuf *mbuf, *seg;
 	struct rte_ether_hdr *eth;
 	struct iface_stats *stats;
-	struct rte_mbuf *mbuf;
-	size_t read_len;
-	size_t len;
-	char *data;
+	size_t read_len, seg_len;
+	unsigned n_iov = 0;
+	ssize_t len;
 
 	lo = iface_info_loopback(iface);
 
@@ -130,20 +134,40 @@ static void iface_loopback_poll(evutil_socket_t, short reason, void *ev_iface) {
 		goto err;
 	}
 
+	// Frames larger than the mbuf data room are read into a chain of segments.
 	read_len = iface->mtu + RTE_ETHER_HDR_LEN + RTE_VLAN_HLEN;
-	if ((data = rte_pktmbuf_append(mbuf, read_len)) == NULL) {
-		LOG(ERR, "rte_pktmbuf_alloc %s", rte_strerror(rte_errno));
-		goto err;
+	seg = mbuf;
+	while (read_len > 0) {
+		if (seg == NULL) {
+			LOG(ERR, "rte_pktmbuf_alloc %s", rte_strerror(rte_errno));
+			goto err;
+		}
+		assert(n_iov < ARRAY_DIM(iov));
+		seg_len = RTE_MIN(read_len, rte_pktmbuf_tailroom(seg));
+		iov[n_iov].iov_base = rte_pktmbuf_mtod(seg, char *);
+		iov[n_iov].iov_len = seg_len;
+		seg->data_len = seg_len;
+		if (seg != mbuf) {
+			mbuf->nb_segs++;
+			rte_pktmbuf_lastseg(mbuf)->next = seg;
+		}
+		mbuf->pkt_len += seg_len;
+		read_len -= seg_len;
+		n_iov++;
+		if (read_len > 0)
+			seg = rte_pktmbuf_alloc(loopback_pool);
 	}
 
-	if ((len = read(lo->fd, data, read_len)) <= 0) {
-		if (errno == EAGAIN || errno == EWOULDBLOCK)
+	if ((len = readv(lo->fd, iov, n_iov)) <= 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			rte_pktmbuf_free(mbuf);
 			return;
+		}
 		LOG(ERR, "read from tun device %s failed %s", iface->name, strerror(errno));
 		goto err;
 	}
 
-	rte_pktmbuf_trim(mbuf, read_len - len);
+	gr_mbuf_truncate(mbuf, len);
 	eth = rte_pktmbuf_mtod(mbuf, struct rte_ether_hdr *);
 
 	if (rte_is_unicast_ether_addr(&eth->dst_addr))
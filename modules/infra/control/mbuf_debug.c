@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_config.h>
+#include <gr_graph.h>
+#include <gr_log.h>
+#include <gr_mbuf_debug.h>
+#include <gr_module.h>
+#include <gr_vec.h>
+
+#include <event2/event.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_mempool.h>
+
+#include <stdalign.h>
+#include <string.h>
+
+// The leak detection mempool ops wrap the default ring based ops. Objects are
+// marked as not owned by the graph when they are put back into their pool.
+// Mempools must be created without per-lcore caches, otherwise freed objects
+// would not go through the ops enqueue callback.
+static const struct rte_mempool_ops *ring_ops;
+
+static int debug_alloc(struct rte_mempool *mp) {
+	return ring_ops->alloc(mp);
+}
+
+static void debug_free(struct rte_mempool *mp) {
+	ring_ops->free(mp);
+}
+
+static int debug_enqueue(struct rte_mempool *mp, void *const *objs, unsigned n) {
+	for (unsigned i = 0; i < n; i++)
+		mbuf_debug_reset(objs[i]);
+	return ring_ops->enqueue(mp, objs, n);
+}
+
+static int debug_dequeue(struct rte_mempool *mp, void **objs, unsigned n) {
+	return ring_ops->dequeue(mp, objs, n);
+}
+
+static unsigned debug_get_count(const struct rte_mempool *mp) {
+	return ring_ops->get_count(mp);
+}
+
+static struct rte_mempool_ops debug_ops = {
+	.name = MBUF_DEBUG_MEMPOOL_OPS,
+	.alloc = debug_alloc,
+	.free = debug_free,
+	.enqueue = debug_enqueue,
+	.dequeue = debug_dequeue,
+	.get_count = debug_get_count,
+};
+
+RTE_MEMPOOL_REGISTER_OPS(debug_ops);
+
+struct scan_ctx {
+	struct mbuf_debug_scan *scan;
+	uint64_t now;
+	uint64_t max_age;
+	unsigned owned;
+};
+
+static void scan_init(struct mbuf_debug_scan *scan, unsigned n_nodes) {
+	scan->drivers = 0;
+	gr_vec_free(scan->inflight);
+	gr_vec_free(scan->leaked);
+	for (unsigned i = 0; i < n_nodes; i++) {
+		gr_vec_add(scan->inflight, 0);
+		gr_vec_add(scan->leaked, 0);
+	}
+}
+
+static void scan_obj(struct rte_mempool *, void *priv, void *obj, unsigned /*idx*/) {
+	// The datapath may update the fields while we are reading them.
+	// This is only used for debugging, a few inconsistent values are fine.
+	const struct mbuf_debug *d = mbuf_debug(obj);
+	struct scan_ctx *ctx = priv;
+	rte_node_t node_id = d->node_id;
+	uint64_t ts = d->ts;
+
+	if (ts == 0 || node_id >= gr_vec_len(ctx->scan->inflight))
+		return;
+
+	ctx->owned++;
+	ctx->scan->inflight[node_id]++;
+	if (ctx->now > ts && ctx->now - ts > ctx->max_age)
+		ctx->scan->leaked[node_id]++;
+}
+
+static void scan_pool(struct rte_mempool *mp, void *priv) {
+	struct scan_ctx *ctx = priv;
+	unsigned in_use;
+
+	if (strcmp(rte_mempool_get_ops(mp->ops_index)->name, MBUF_DEBUG_MEMPOOL_OPS) != 0)
+		return;
+
+	ctx->owned = 0;
+	rte_mempool_obj_iter(mp, scan_obj, ctx);
+
+	// mbufs that are neither in the pool nor owned by the graph are
+	// sitting in the rx/tx rings of the drivers
+	in_use = rte_mempool_in_use_count(mp);
+	if (in_use > ctx->owned)
+		ctx->scan->drivers += in_use - ctx->owned;
+}
+
+void mbuf_debug_scan(struct mbuf_debug_scan *scan) {
+	struct scan_ctx ctx = {
+		.scan = scan,
+		.now = rte_rdtsc(),
+		.max_age = gr_config.mbuf_leak_timeout * rte_get_tsc_hz(),
+	};
+
+	scan_init(scan, rte_node_max_count());
+
+	if (mbuf_debug_offset >= 0)
+		rte_mempool_walk(scan_pool, &ctx);
+}
+
+void mbuf_debug_scan_free(struct mbuf_debug_scan *scan) {
+	gr_vec_free(scan->inflight);
+	gr_vec_free(scan->leaked);
+}
+
+static struct event *leak_timer;
+static struct mbuf_debug_scan last_scan;
+
+static void leak_check(evutil_socket_t, short, void *) {
+	struct mbuf_debug_scan scan = {0};
+
+	mbuf_debug_scan(&scan);
+
+	for (rte_node_t id = 0; id < gr_vec_len(scan.leaked); id++) {
+		uint32_t prev = id < gr_vec_len(last_scan.leaked) ? last_scan.leaked[id] : 0;
+		if (scan.leaked[id] > prev) {
+			LOG(WARNING,
+			    "%u mbufs held for more than %us, last processed by %s",
+			    scan.leaked[id],
+			    gr_config.mbuf_leak_timeout,
+			    rte_node_id_to_name(id));
+		}
+	}
+
+	mbuf_debug_scan_free(&last_scan);
+	last_scan = scan;
+}
+
+static void mbuf_debug_init(struct event_base *ev_base) {
+	static const struct rte_mbuf_dynfield desc = {
+		.name = "grout_mbuf_debug",
+		.size = sizeof(struct mbuf_debug),
+		.align = alignof(struct mbuf_debug),
+	};
+
+	if (gr_config.mbuf_leak_timeout == 0)
+		return;
+
+	for (unsigned i = 0; i < rte_mempool_ops_table.num_ops; i++) {
+		if (strcmp(rte_mempool_ops_table.ops[i].name, "ring_mp_mc") == 0)
+			ring_ops = &rte_mempool_ops_table.ops[i];
+	}
+	if (ring_ops == NULL)
+		ABORT("ring_mp_mc mempool ops not available");
+
+	mbuf_debug_offset = rte_mbuf_dynfield_register(&desc);
+	if (mbuf_debug_offset < 0)
+		ABORT("rte_mbuf_dynfield_register: %s", rte_strerror(rte_errno));
+
+	leak_timer = event_new(ev_base, -1, EV_PERSIST | EV_FINALIZE, leak_check, NULL);
+	if (leak_timer == NULL)
+		ABORT("event_new() failed");
+
+	if (event_add(leak_timer, &(struct timeval) {.tv_sec = gr_config.mbuf_leak_timeout}) < 0)
+		ABORT("event_add() failed");
+
+	LOG(NOTICE, "mbuf leak detection enabled, timeout %us", gr_config.mbuf_leak_timeout);
+}
+
+static void mbuf_debug_fini(struct event_base *) {
+	if (leak_timer)
+		event_free(leak_timer);
+	leak_timer = NULL;
+	mbuf_debug_scan_free(&last_scan);
+}
+
+static struct gr_module mbuf_debug_module = {
+	.name = "mbuf_debug",
+	.init = mbuf_debug_init,
+	.fini = mbuf_debug_fini,
+};
+
+RTE_INIT(mbuf_debug_module_init) {
+	gr_register_module(&mbuf_debug_module);
+}
+
+#ifdef __GROUT_UNIT_TEST__
+#include <gr_cmocka.h>
+
+int gr_rte_log_type;
+struct gr_config gr_config;
+void gr_register_module(struct gr_module *) { }
+
+#define LEAK_NODE 3
+
+// Deliberately forget about all received packets.
+static uint16_t leak_process(struct rte_graph *, struct rte_node *, void **, uint16_t n) {
+	return n;
+}
+
+static struct rte_mbuf mbufs[4];
+
+static void scan_mbufs(struct mbuf_debug_scan *scan, uint64_t now) {
+	struct scan_ctx ctx = {.scan = scan, .now = now, .max_age = 1000};
+
+	scan_init(scan, LEAK_NODE + 1);
+	for (unsigned i = 0; i < ARRAY_DIM(mbufs); i++)
+		scan_obj(NULL, &ctx, &mbufs[i], i);
+}
+
+static void leaking_node(void **) {
+	struct rte_node node = {.id = LEAK_NODE, .parent_id = RTE_NODE_ID_INVALID};
+	struct mbuf_debug_scan scan = {0};
+	struct rte_mbuf *m = &mbufs[0];
+	void *objs[ARRAY_DIM(mbufs)];
+	uint64_t ts;
+
+	mbuf_debug_offset = RTE_ALIGN_CEIL(offsetof(struct rte_mbuf, dynfield1), 8);
+	mbuf_debug_node_add(LEAK_NODE, leak_process);
+
+	for (unsigned i = 0; i < ARRAY_DIM(mbufs); i++) {
+		mbuf_debug_reset(&mbufs[i]);
+		objs[i] = &mbufs[i];
+	}
+
+	// the last mbuf stays in a driver rx ring
+	assert_int_equal(mbuf_debug_process(NULL, &node, objs, 3), 3);
+	ts = mbuf_debug(m)->ts;
+	assert_int_not_equal(ts, 0);
+	assert_int_equal(mbuf_debug(m)->node_id, LEAK_NODE);
+	assert_int_equal(mbuf_debug(&mbufs[3])->ts, 0);
+
+	scan_mbufs(&scan, ts);
+	assert_int_equal(scan.inflight[LEAK_NODE], 3);
+	assert_int_equal(scan.leaked[LEAK_NODE], 0);
+
+	scan_mbufs(&scan, ts + 1001);
+	assert_int_equal(scan.inflight[LEAK_NODE], 3);
+	assert_int_equal(scan.leaked[LEAK_NODE], 3);
+
+	// handed over to a driver for transmission
+	mbuf_debug_release(&m, 1);
+	scan_mbufs(&scan, ts + 1001);
+	assert_int_equal(scan.inflight[LEAK_NODE], 2);
+	assert_int_equal(scan.leaked[LEAK_NODE], 2);
+
+	// the entry timestamp is preserved when visiting other nodes
+	node.id = LEAK_NODE - 1;
+	node.parent_id = LEAK_NODE;
+	assert_int_equal(mbuf_debug_process(NULL, &node, &objs[1], 1), 1);
+	assert_int_equal(mbuf_debug(&mbufs[1])->ts, ts);
+	scan_mbufs(&scan, ts + 1001);
+	assert_int_equal(scan.inflight[LEAK_NODE], 1);
+	assert_int_equal(scan.leaked[LEAK_NODE - 1], 1);
+
+	mbuf_debug_scan_free(&scan);
+}
+
+int main(void) {
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(leaking_node),
+	};
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
+#endif
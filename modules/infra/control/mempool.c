@@ -4,6 +4,7 @@
 #include <gr_config.h>
 #include <gr_log.h>
 #include <gr_mbuf.h>
+#include <gr_mbuf_debug.h>
 #include <gr_mempool.h>
 
 #include <stdlib.h>
@@ -36,22 +37,24 @@ static int mt_sort(const void *p1, const void *p2) {
 static struct mempool_tracker trackers[MT_COUNT][MAX_MEMPOOL_PER_NUMA];
 static uint32_t mempool_default_size = MEMPOOL_DEFAULT_SIZE;
 
-struct rte_mempool *gr_pktmbuf_pool_get(int8_t socket_id, uint32_t count) {
+uint32_t gr_pktmbuf_frame_len_max(void) {
+	// QinQ frames have two VLAN tags
+	return ETHER_HDR_SIZE + 2 * VLAN_HDR_SIZE + gr_config.max_mtu;
+}
+
+static struct rte_mempool *pool_get(int8_t socket_id, uint32_t count, uint32_t mbuf_size) {
 	char mp_name[RTE_MEMPOOL_NAMESIZE];
 	struct rte_mempool *mp = NULL;
 	uint32_t alloc_size;
-	uint32_t mbuf_size;
 
 	if (socket_id < SOCKET_ID_ANY || socket_id >= RTE_MAX_NUMA_NODES)
 		return errno_set_null(EINVAL);
 
-	mbuf_size = rte_align32pow2(
-		RTE_PKTMBUF_HEADROOM + ETHER_HDR_SIZE + VLAN_HDR_SIZE + gr_config.max_mtu
-	);
-
 	for (int i = 0; i < MAX_MEMPOOL_PER_NUMA; i++) {
 		unsigned mt_index = socket_id == SOCKET_ID_ANY ? 0 : socket_id + 1;
 		struct mempool_tracker *mt = &trackers[mt_index][i];
+		if (mt->mp != NULL && rte_pktmbuf_data_room_size(mt->mp) != mbuf_size)
+			continue;
 		if (mt->mp == NULL) {
 			alloc_size = mempool_default_size;
 			if (count > mempool_default_size / 4) {
@@ -60,21 +63,36 @@ struct rte_mempool *gr_pktmbuf_pool_get(int8_t socket_id, uint32_t count) {
 				// For future mempools, increase default size;
 				mempool_default_size = alloc_size;
 			}
-			sprintf(mp_name, "mbuf_%d:%d", socket_id, i);
+			snprintf(
+				mp_name, sizeof(mp_name), "mbuf_%d:%d:%u", socket_id, i, mbuf_size
+			);
 			LOG(DEBUG,
 			    "allocate mempool %s reserved %u (size %u, mbuf_size %u)",
 			    mp_name,
 			    count,
 			    alloc_size,
 			    mbuf_size);
-			mt->mp = rte_pktmbuf_pool_create(
-				mp_name,
-				alloc_size,
-				RTE_MEMPOOL_CACHE_MAX_SIZE,
-				GR_MBUF_PRIV_MAX_SIZE,
-				mbuf_size,
-				socket_id
-			);
+			if (gr_config.mbuf_leak_timeout != 0) {
+				// per-lcore caches would hide freed mbufs from leak detection
+				mt->mp = rte_pktmbuf_pool_create_by_ops(
+					mp_name,
+					alloc_size,
+					0,
+					GR_MBUF_PRIV_MAX_SIZE,
+					mbuf_size,
+					socket_id,
+					MBUF_DEBUG_MEMPOOL_OPS
+				);
+			} else {
+				mt->mp = rte_pktmbuf_pool_create(
+					mp_name,
+					alloc_size,
+					RTE_MEMPOOL_CACHE_MAX_SIZE,
+					GR_MBUF_PRIV_MAX_SIZE,
+					mbuf_size,
+					socket_id
+				);
+			}
 			if (mt->mp == NULL)
 				return errno_set_null(rte_errno);
 			mt->reserved = count;
@@ -102,6 +120,19 @@ struct rte_mempool *gr_pktmbuf_pool_get(int8_t socket_id, uint32_t count) {
 	return mp;
 }
 
+struct rte_mempool *gr_pktmbuf_pool_get(int8_t socket_id, uint32_t count) {
+	return pool_get(socket_id, count, GR_MBUF_DATA_ROOM);
+}
+
+struct rte_mempool *gr_pktmbuf_jumbo_pool_get(int8_t socket_id, uint32_t count) {
+	uint32_t mbuf_size = rte_align32pow2(RTE_PKTMBUF_HEADROOM + gr_pktmbuf_frame_len_max());
+
+	if (mbuf_size < GR_MBUF_DATA_ROOM)
+		mbuf_size = GR_MBUF_DATA_ROOM;
+
+	return pool_get(socket_id, count, mbuf_size);
+}
+
 void gr_pktmbuf_pool_release(struct rte_mempool *mp, uint32_t count) {
 	if (mp == NULL)
 		return;
@@ -314,6 +314,7 @@ void nexthop_type_ops_register(gr_nh_type_t type, const struct nexthop_type_ops
 	case GR_NH_T_BLACKHOLE:
 	case GR_NH_T_REJECT:
 	case GR_NH_T_GROUP:
+	case GR_NH_T_MPLS:
 		if (ops == NULL)
 			ABORT("invalid type ops");
 		if (type_ops[type] != NULL)
@@ -337,6 +338,7 @@ struct nexthop *nexthop_new(const struct gr_nexthop_base *base, const void *info
 	case GR_NH_T_BLACKHOLE:
 	case GR_NH_T_REJECT:
 	case GR_NH_T_GROUP:
+	case GR_NH_T_MPLS:
 		break;
 	default:
 		ABORT("invalid nexthop type %hhu", base->type);
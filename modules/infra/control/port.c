@@ -76,19 +76,40 @@ static struct rte_eth_conf default_port_config = {
 	.rxmode = {
 		.offloads = RTE_ETH_RX_OFFLOAD_CHECKSUM | RTE_ETH_RX_OFFLOAD_VLAN,
 	},
+	.txmode = {
+		// Multicast replicas are made of a header segment chained to the
+		// shared payload of the original packet.
+		.offloads = RTE_ETH_TX_OFFLOAD_MULTI_SEGS
+			| RTE_ETH_TX_OFFLOAD_VLAN_INSERT
+			| RTE_ETH_TX_OFFLOAD_QINQ_INSERT,
+	},
 };
 
+static int port_socket_id(const struct iface_info_port *p) {
+	if (numa_available() != -1)
+		return rte_eth_dev_socket_id(p->port_id);
+	return SOCKET_ID_ANY;
+}
+
+static uint32_t port_mbuf_count(const struct iface_info_port *p) {
+	uint32_t mbuf_count;
+
+	mbuf_count = p->rxq_size * p->n_rxq;
+	mbuf_count += p->txq_size * p->n_txq;
+	mbuf_count += RTE_GRAPH_BURST_SIZE;
+
+	return rte_align32pow2(mbuf_count) - 1;
+}
+
 int port_configure(struct iface_info_port *p, uint16_t n_txq_min) {
 	struct rte_eth_conf conf = default_port_config;
-	int socket_id = SOCKET_ID_ANY;
+	int socket_id = port_socket_id(p);
 	struct rte_eth_dev_info info;
 	uint16_t rxq_size, txq_size;
 	uint32_t mbuf_count;
+	bool jumbo;
 	int ret;
 
-	if (numa_available() != -1)
-		socket_id = rte_eth_dev_socket_id(p->port_id);
-
 	// FIXME: deal with drivers that do not support more than 1 (or N) tx queues
 	p->n_txq = n_txq_min;
 	if (p->n_rxq == 0)
@@ -105,13 +126,22 @@ int port_configure(struct iface_info_port *p, uint16_t n_txq_min) {
 	rxq_size = get_rxq_size(p, &info);
 	txq_size = get_txq_size(p, &info);
 
-	mbuf_count = rxq_size * p->n_rxq;
-	mbuf_count += txq_size * p->n_txq;
-	mbuf_count += RTE_GRAPH_BURST_SIZE;
-	mbuf_count = rte_align32pow2(mbuf_count) - 1;
+	// Jumbo frames are received in chains of regular sized mbufs to avoid
+	// wasting memory on small packets. Drivers that do not support scattered
+	// RX need buffers large enough for the largest frame.
+	jumbo = gr_pktmbuf_frame_len_max() > GR_MBUF_DATA_ROOM - RTE_PKTMBUF_HEADROOM;
+	if (jumbo && info.rx_offload_capa & RTE_ETH_RX_OFFLOAD_SCATTER) {
+		conf.rxmode.offloads |= RTE_ETH_RX_OFFLOAD_SCATTER;
+		jumbo = false;
+	}
+
+	mbuf_count = port_mbuf_count(p);
 	if (mbuf_count != p->pool_size) {
 		gr_pktmbuf_pool_release(p->pool, p->pool_size);
-		p->pool = gr_pktmbuf_pool_get(socket_id, mbuf_count);
+		if (jumbo)
+			p->pool = gr_pktmbuf_jumbo_pool_get(socket_id, mbuf_count);
+		else
+			p->pool = gr_pktmbuf_pool_get(socket_id, mbuf_count);
 		p->pool_size = mbuf_count;
 	}
 
@@ -125,6 +155,7 @@ int port_configure(struct iface_info_port *p, uint16_t n_txq_min) {
 	else
 		conf.rxmode.mq_mode = RTE_ETH_MQ_RX_RSS;
 	conf.rxmode.offloads &= info.rx_offload_capa;
+	conf.txmode.offloads &= info.tx_offload_capa;
 	if (info.dev_flags != NULL && *info.dev_flags & RTE_ETH_DEV_INTR_LSC) {
 		conf.intr_conf.lsc = 1;
 	}
@@ -132,6 +163,22 @@ int port_configure(struct iface_info_port *p, uint16_t n_txq_min) {
 	if ((ret = rte_eth_dev_configure(p->port_id, p->n_rxq, p->n_txq, &conf)) < 0)
 		return errno_log(-ret, "rte_eth_dev_configure");
 
+	p->tx_offloads = conf.txmode.offloads;
+	if (conf.rxmode.offloads & RTE_ETH_RX_OFFLOAD_QINQ_STRIP
+	    || conf.txmode.offloads & RTE_ETH_TX_OFFLOAD_QINQ_INSERT) {
+		// QinQ offloads default to 0x8100 for the outer tag on some drivers.
+		ret = rte_eth_dev_set_vlan_ether_type(
+			p->port_id, RTE_ETH_VLAN_TYPE_OUTER, RTE_ETHER_TYPE_QINQ
+		);
+		if (ret < 0) {
+			LOG(INFO,
+			    "port %u: outer VLAN ether type: %s",
+			    p->port_id,
+			    rte_strerror(-ret));
+			p->tx_offloads &= ~RTE_ETH_TX_OFFLOAD_QINQ_INSERT;
+		}
+	}
+
 	// initialize rx/tx queues
 	for (size_t q = 0; q < p->n_rxq; q++) {
 		ret = rte_eth_rx_queue_setup(p->port_id, q, rxq_size, socket_id, NULL, p->pool);
@@ -248,14 +295,23 @@ static int port_allmulti_set(struct iface *iface, bool enabled) {
 
 static int port_mtu_set(struct iface *iface, uint16_t mtu) {
 	struct iface_info_port *p = iface_info_port(iface);
-	int ret;
+	int ret, start_ret;
 
 	if (mtu != 0) {
-		p->started = false;
-		rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
-		if ((ret = rte_eth_dev_stop(p->port_id)) < 0)
-			return errno_log(-ret, "rte_eth_dev_stop");
+		// Most drivers support changing the MTU while the port is running.
 		ret = rte_eth_dev_set_mtu(p->port_id, mtu);
+		if (ret == -EBUSY && p->started) {
+			// Last resort, the port must be stopped.
+			LOG(INFO, "port %u: restarting to change mtu", p->port_id);
+			p->started = false;
+			rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+			if ((ret = rte_eth_dev_stop(p->port_id)) < 0)
+				return errno_log(-ret, "rte_eth_dev_stop");
+			ret = rte_eth_dev_set_mtu(p->port_id, mtu);
+			if ((start_ret = rte_eth_dev_start(p->port_id)) < 0)
+				return errno_log(-start_ret, "rte_eth_dev_start");
+			p->started = true;
+		}
 		switch (ret) {
 		case 0:
 		case -ENOSYS:
@@ -264,9 +320,6 @@ static int port_mtu_set(struct iface *iface, uint16_t mtu) {
 		default:
 			return errno_log(-ret, "rte_eth_dev_set_mtu");
 		}
-		if ((ret = rte_eth_dev_start(p->port_id)) < 0)
-			return errno_log(-ret, "rte_eth_dev_start");
-		p->started = true;
 		iface->mtu = mtu;
 	} else {
 		if ((ret = rte_eth_dev_get_mtu(p->port_id, &iface->mtu)) < 0)
@@ -307,6 +360,48 @@ static int port_vlan_del(struct iface *iface, uint16_t vlan_id) {
 	return 0;
 }
 
+static int port_queue_resize(struct iface_info_port *p, uint16_t queue_id, bool rx) {
+	int socket_id = port_socket_id(p);
+	int ret;
+
+	if (rx) {
+		if ((ret = rte_eth_dev_rx_queue_stop(p->port_id, queue_id)) < 0)
+			return errno_log(-ret, "rte_eth_dev_rx_queue_stop");
+		ret = rte_eth_rx_queue_setup(
+			p->port_id, queue_id, p->rxq_size, socket_id, NULL, p->pool
+		);
+		if (ret < 0)
+			return errno_log(-ret, "rte_eth_rx_queue_setup");
+		if ((ret = rte_eth_dev_rx_queue_start(p->port_id, queue_id)) < 0)
+			return errno_log(-ret, "rte_eth_dev_rx_queue_start");
+	} else {
+		if ((ret = rte_eth_dev_tx_queue_stop(p->port_id, queue_id)) < 0)
+			return errno_log(-ret, "rte_eth_dev_tx_queue_stop");
+		ret = rte_eth_tx_queue_setup(p->port_id, queue_id, p->txq_size, socket_id, NULL);
+		if (ret < 0)
+			return errno_log(-ret, "rte_eth_tx_queue_setup");
+		if ((ret = rte_eth_dev_tx_queue_start(p->port_id, queue_id)) < 0)
+			return errno_log(-ret, "rte_eth_dev_tx_queue_start");
+	}
+
+	return 0;
+}
+
+// Ring sizes can be changed while the port is running if the driver supports
+// setting up queues at runtime. The mempool cannot be replaced while mbufs are
+// in flight, it must already be large enough for the new ring sizes.
+static bool port_queues_resizable(struct iface_info_port *p, const struct rte_eth_dev_info *info) {
+	const uint64_t capa = RTE_ETH_DEV_CAPA_RUNTIME_RX_QUEUE_SETUP
+		| RTE_ETH_DEV_CAPA_RUNTIME_TX_QUEUE_SETUP;
+
+	if (!p->started || p->pool == NULL || worker_count() == 0)
+		return false;
+	if ((info->dev_capa & capa) != capa)
+		return false;
+
+	return port_mbuf_count(p) <= p->pool_size;
+}
+
 static int iface_port_reconfig(
 	struct iface *iface,
 	uint64_t set_attrs,
@@ -316,25 +411,53 @@ static int iface_port_reconfig(
 	struct iface_info_port *p = iface_info_port(iface);
 	const struct gr_iface_info_port *api = api_info;
 	bool needs_configure = false;
+	struct rte_eth_dev_info info = {0};
+	bool needs_resize = false;
 	int ret;
 
 	if (!(set_attrs
 	      & (GR_PORT_SET_N_RXQS | GR_PORT_SET_N_TXQS | GR_PORT_SET_Q_SIZE | GR_PORT_SET_MAC)))
 		return 0;
 
-	if (set_attrs & GR_PORT_SET_N_RXQS) {
+	// Only stop the port when the queue configuration actually changes.
+	if (set_attrs & GR_PORT_SET_N_RXQS && (p->pool == NULL || api->n_rxq != p->n_rxq)) {
 		p->n_rxq = api->n_rxq;
 		needs_configure = true;
 	}
-	if (set_attrs & GR_PORT_SET_N_TXQS) {
+	if (set_attrs & GR_PORT_SET_N_TXQS && (p->pool == NULL || api->n_txq != p->n_txq)) {
 		p->n_txq = api->n_txq;
 		needs_configure = true;
 	}
 	if (set_attrs & GR_PORT_SET_Q_SIZE) {
+		uint16_t rxq_size = p->rxq_size;
+		uint16_t txq_size = p->txq_size;
+
+		if ((ret = rte_eth_dev_info_get(p->port_id, &info)) < 0)
+			return errno_log(-ret, "rte_eth_dev_info_get");
+
 		p->rxq_size = api->rxq_size;
 		p->txq_size = api->txq_size;
-		needs_configure = true;
+		get_rxq_size(p, &info);
+		get_txq_size(p, &info);
+
+		if (p->pool == NULL || p->rxq_size != rxq_size || p->txq_size != txq_size)
+			needs_resize = true;
+	}
+
+	if (needs_resize && !needs_configure && port_queues_resizable(p, &info)) {
+		if (port_queues_reconfigure(p, port_queue_resize) == 0) {
+			LOG(INFO,
+			    "port %u: rxq_size=%u txq_size=%u changed without restart",
+			    p->port_id,
+			    p->rxq_size,
+			    p->txq_size);
+			needs_resize = false;
+		} else {
+			LOG(WARNING, "port %u: queue resize failed, restarting port", p->port_id);
+		}
 	}
+	if (needs_resize)
+		needs_configure = true;
 
 	if (p->started && needs_configure) {
 		p->started = false;
@@ -350,22 +473,27 @@ static int iface_port_reconfig(
 		if ((ret = port_configure(p, CPU_COUNT(&gr_config.datapath_cpus))) < 0)
 			return ret;
 
-		// generate a list of ports including the one being configured/created
-		gr_vec struct iface_info_port **ports = NULL;
-		struct iface *i = NULL;
-		bool found = false;
-		while ((i = iface_next(GR_IFACE_TYPE_PORT, i)) != NULL) {
-			struct iface_info_port *port = iface_info_port(i);
-			if (port == p)
-				found = true;
-			gr_vec_add(ports, port);
-		}
-		if (!found) {
-			// port is being created, not present in the global list yet
-			gr_vec_add(ports, p);
+		if (worker_count() > 0) {
+			// leave the queues of other ports where they are
+			ret = port_queues_assign(p);
+		} else {
+			// generate a list of ports including the one being configured/created
+			gr_vec struct iface_info_port **ports = NULL;
+			struct iface *i = NULL;
+			bool found = false;
+			while ((i = iface_next(GR_IFACE_TYPE_PORT, i)) != NULL) {
+				struct iface_info_port *port = iface_info_port(i);
+				if (port == p)
+					found = true;
+				gr_vec_add(ports, port);
+			}
+			if (!found) {
+				// port is being created, not present in the global list yet
+				gr_vec_add(ports, p);
+			}
+			ret = worker_queue_distribute(&gr_config.datapath_cpus, ports);
+			gr_vec_free(ports);
 		}
-		ret = worker_queue_distribute(&gr_config.datapath_cpus, ports);
-		gr_vec_free(ports);
 		if (ret < 0)
 			return ret;
 
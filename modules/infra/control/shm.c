@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_event.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_shm.h>
+#include <gr_string.h>
+
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_graph.h>
+#include <rte_memzone.h>
+#include <rte_seqlock.h>
+
+#include <string.h>
+#include <unistd.h>
+
+struct gr_shm *gr_shm;
+
+static void shm_iface_set(const struct iface *iface) {
+	struct gr_shm_iface *s = &gr_shm->ifaces[iface->id];
+	s->base = iface->base;
+	memccpy(s->name, iface->name, 0, sizeof(s->name));
+	s->name[sizeof(s->name) - 1] = '\0';
+}
+
+void gr_shm_nodes_update(void) {
+	const char *name;
+	rte_node_t id;
+
+	if (gr_shm == NULL)
+		return;
+
+	rte_seqlock_write_lock(&gr_shm->lock);
+	for (id = gr_shm->n_nodes; id < rte_node_max_count() && id < GR_SHM_MAX_NODES; id++) {
+		if ((name = rte_node_id_to_name(id)) == NULL)
+			continue;
+		memccpy(gr_shm->node_names[id], name, 0, RTE_NODE_NAMESIZE);
+		gr_shm->node_names[id][RTE_NODE_NAMESIZE - 1] = '\0';
+	}
+	gr_shm->n_nodes = id;
+	rte_seqlock_write_unlock(&gr_shm->lock);
+
+	if (rte_node_max_count() > GR_SHM_MAX_NODES)
+		LOG(WARNING, "only %u graph nodes exported", GR_SHM_MAX_NODES);
+}
+
+static void shm_init(struct event_base *) {
+	const struct rte_memzone *mz;
+	struct iface *iface = NULL;
+
+	// Never released explicitly. Datapath workers may still be running
+	// when modules are finalized, rte_eal_cleanup() takes care of it.
+	mz = rte_memzone_reserve(GR_SHM_MZ_NAME, sizeof(*gr_shm), SOCKET_ID_ANY, 0);
+	if (mz == NULL)
+		ABORT("rte_memzone_reserve(%s): %s", GR_SHM_MZ_NAME, rte_strerror(rte_errno));
+
+	gr_shm = mz->addr;
+	memset(gr_shm, 0, sizeof(*gr_shm));
+	gr_shm->version = GR_SHM_VERSION;
+	gr_shm->max_ifaces = MAX_IFACES;
+	gr_shm->max_lcores = RTE_MAX_LCORE;
+	gr_shm->max_nodes = GR_SHM_MAX_NODES;
+	gr_shm->tsc_hz = rte_get_tsc_hz();
+	gr_shm->pid = getpid();
+	rte_seqlock_init(&gr_shm->lock);
+
+	// All base nodes have been registered by the graph module.
+	gr_shm_nodes_update();
+
+	rte_seqlock_write_lock(&gr_shm->lock);
+	while ((iface = iface_next(GR_IFACE_TYPE_UNDEF, iface)) != NULL)
+		shm_iface_set(iface);
+
+	rte_seqlock_write_unlock(&gr_shm->lock);
+
+	// Readers must only look at the contents once the magic is visible.
+	__atomic_store_n(&gr_shm->magic, GR_SHM_MAGIC, __ATOMIC_RELEASE);
+}
+
+static void shm_iface_event(uint32_t event, const void *obj) {
+	const struct iface *iface = obj;
+
+	if (gr_shm == NULL)
+		return;
+
+	rte_seqlock_write_lock(&gr_shm->lock);
+	if (event == GR_EVENT_IFACE_PRE_REMOVE)
+		memset(&gr_shm->ifaces[iface->id], 0, sizeof(gr_shm->ifaces[iface->id]));
+	else
+		shm_iface_set(iface);
+	rte_seqlock_write_unlock(&gr_shm->lock);
+}
+
+static struct gr_module shm_module = {
+	.name = "shm",
+	.depends_on = "graph",
+	.init = shm_init,
+};
+
+static struct gr_event_subscription shm_iface_subscription = {
+	.callback = shm_iface_event,
+	.ev_count = 5,
+	.ev_types = {
+		GR_EVENT_IFACE_POST_ADD,
+		GR_EVENT_IFACE_PRE_REMOVE,
+		GR_EVENT_IFACE_POST_RECONFIG,
+		GR_EVENT_IFACE_STATUS_UP,
+		GR_EVENT_IFACE_STATUS_DOWN,
+	},
+};
+
+RTE_INIT(shm_constructor) {
+	gr_register_module(&shm_module);
+	gr_event_subscribe(&shm_iface_subscription);
+}
@@ -14,7 +14,9 @@
 #include <rte_ethdev.h>
 #include <rte_ether.h>
 #include <rte_hash.h>
+#include <rte_malloc.h>
 
+#include <stdatomic.h>
 #include <string.h>
 
 struct vlan_key {
@@ -24,6 +26,8 @@ struct vlan_key {
 
 static struct rte_hash *vlan_hash;
 
+_Atomic(struct qinq_outer *) qinq_parents[MAX_IFACES];
+
 struct iface *vlan_get_iface(uint16_t parent_id, uint16_t vlan_id) {
 	void *data;
 
@@ -33,6 +37,130 @@ struct iface *vlan_get_iface(uint16_t parent_id, uint16_t vlan_id) {
 	return data;
 }
 
+static struct iface *vlan_lookup(uint16_t parent_id, uint16_t outer_vlan_id, uint16_t vlan_id) {
+	if (outer_vlan_id != 0)
+		return qinq_get_iface(parent_id, outer_vlan_id, vlan_id);
+	return vlan_get_iface(parent_id, vlan_id);
+}
+
+static int qinq_add(struct iface *iface) {
+	const struct iface_info_vlan *vlan = iface_info_vlan(iface);
+	struct qinq_outer *outer, *new_outer = NULL;
+	struct qinq_inner *inner;
+
+	outer = atomic_load_explicit(&qinq_parents[vlan->parent_id], memory_order_relaxed);
+	if (outer == NULL) {
+		new_outer = outer = rte_zmalloc(__func__, sizeof(*outer), RTE_CACHE_LINE_SIZE);
+		if (outer == NULL)
+			return errno_set(ENOMEM);
+	}
+	inner = atomic_load_explicit(&outer->inner[vlan->outer_vlan_id], memory_order_relaxed);
+	if (inner == NULL) {
+		inner = rte_zmalloc(__func__, sizeof(*inner), RTE_CACHE_LINE_SIZE);
+		if (inner == NULL) {
+			rte_free(new_outer);
+			return errno_set(ENOMEM);
+		}
+		atomic_store_explicit(
+			&outer->inner[vlan->outer_vlan_id], inner, memory_order_release
+		);
+		outer->count++;
+	}
+	atomic_store_explicit(&inner->ifaces[vlan->vlan_id], iface, memory_order_release);
+	inner->count++;
+
+	if (new_outer != NULL)
+		atomic_store_explicit(
+			&qinq_parents[vlan->parent_id], new_outer, memory_order_release
+		);
+
+	return 0;
+}
+
+static void qinq_del(const struct iface *iface) {
+	const struct iface_info_vlan *vlan = iface_info_vlan(iface);
+	struct qinq_outer *outer;
+	struct qinq_inner *inner;
+
+	outer = atomic_load_explicit(&qinq_parents[vlan->parent_id], memory_order_relaxed);
+	if (outer == NULL)
+		return;
+	inner = atomic_load_explicit(&outer->inner[vlan->outer_vlan_id], memory_order_relaxed);
+	if (inner == NULL)
+		return;
+	if (atomic_load_explicit(&inner->ifaces[vlan->vlan_id], memory_order_relaxed) != iface)
+		return;
+
+	atomic_store_explicit(&inner->ifaces[vlan->vlan_id], NULL, memory_order_release);
+	if (--inner->count == 0) {
+		atomic_store_explicit(
+			&outer->inner[vlan->outer_vlan_id], NULL, memory_order_release
+		);
+		outer->count--;
+	} else {
+		inner = NULL;
+	}
+	if (outer->count == 0)
+		atomic_store_explicit(&qinq_parents[vlan->parent_id], NULL, memory_order_release);
+	else
+		outer = NULL;
+
+	// the interface may be freed as soon as this function returns
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+	rte_free(inner);
+	rte_free(outer);
+}
+
+// Hardware VLAN filters are not reference counted. A filter is shared by the
+// single tagged sub-interface and all QinQ sub-interfaces using its VLAN ID.
+static bool vlan_filter_used(uint16_t parent_id, uint16_t vlan_id) {
+	const struct qinq_outer *outer;
+
+	if (vlan_get_iface(parent_id, vlan_id) != NULL)
+		return true;
+
+	outer = atomic_load_explicit(&qinq_parents[parent_id], memory_order_relaxed);
+
+	return outer != NULL
+		&& atomic_load_explicit(&outer->inner[vlan_id], memory_order_relaxed) != NULL;
+}
+
+static inline uint16_t vlan_filter_id(const struct iface_info_vlan *vlan) {
+	return vlan->outer_vlan_id ?: vlan->vlan_id;
+}
+
+static int vlan_register(struct iface *iface) {
+	const struct iface_info_vlan *vlan = iface_info_vlan(iface);
+	struct vlan_key key = {vlan->parent_id, vlan->vlan_id};
+	int ret;
+
+	if (iface_add_vlan(vlan->parent_id, vlan_filter_id(vlan)) < 0)
+		return -errno;
+
+	if (vlan->outer_vlan_id != 0)
+		return qinq_add(iface);
+
+	if ((ret = rte_hash_add_key_data(vlan_hash, &key, iface)) < 0)
+		return errno_log(-ret, "rte_hash_add_key_data");
+
+	return 0;
+}
+
+static int vlan_unregister(struct iface *iface) {
+	const struct iface_info_vlan *vlan = iface_info_vlan(iface);
+	struct vlan_key key = {vlan->parent_id, vlan->vlan_id};
+
+	if (vlan->outer_vlan_id != 0)
+		qinq_del(iface);
+	else if (vlan_get_iface(vlan->parent_id, vlan->vlan_id) == iface)
+		rte_hash_del_key(vlan_hash, &key);
+
+	if (vlan_filter_used(vlan->parent_id, vlan_filter_id(vlan)))
+		return 0;
+
+	return iface_del_vlan(vlan->parent_id, vlan_filter_id(vlan));
+}
+
 static int iface_vlan_reconfig(
 	struct iface *iface,
 	uint64_t set_attrs,
@@ -57,44 +185,51 @@ static int iface_vlan_reconfig(
 		cur_parent = NULL;
 	}
 
-	if (set_attrs & (GR_VLAN_SET_PARENT | GR_VLAN_SET_VLAN)) {
-		struct vlan_key next_key = {next->parent_id, next->vlan_id};
+	if (set_attrs & (GR_VLAN_SET_PARENT | GR_VLAN_SET_VLAN | GR_VLAN_SET_OUTER_VLAN)) {
+		uint16_t parent_id = cur->parent_id;
+		uint16_t vlan_id = cur->vlan_id;
+		uint16_t outer_vlan_id = cur->outer_vlan_id;
 
-		if ((next_parent = iface_from_id(next->parent_id)) == NULL)
+		if (set_attrs & GR_VLAN_SET_PARENT)
+			parent_id = next->parent_id;
+		if (set_attrs & GR_VLAN_SET_VLAN)
+			vlan_id = next->vlan_id;
+		if (set_attrs & GR_VLAN_SET_OUTER_VLAN)
+			outer_vlan_id = next->outer_vlan_id;
+
+		if (vlan_id == 0 || vlan_id >= VLAN_ID_COUNT || outer_vlan_id >= VLAN_ID_COUNT)
+			return errno_set(EINVAL);
+
+		if ((next_parent = iface_from_id(parent_id)) == NULL)
 			return -errno;
 
-		if (rte_hash_lookup(vlan_hash, &next_key) >= 0)
+		if (vlan_lookup(parent_id, outer_vlan_id, vlan_id) != NULL)
 			return errno_set(EADDRINUSE);
 
 		if (reconfig) {
 			// reconfig, *not initial config*
-			struct vlan_key cur_key = {cur->parent_id, cur->vlan_id};
-
-			rte_hash_del_key(vlan_hash, &cur_key);
-			iface_del_subinterface(cur_parent, iface);
-
 			// remove previous vlan filter (ignore errors)
-			iface_del_vlan(cur->parent_id, cur->vlan_id);
+			vlan_unregister(iface);
+			iface_del_subinterface(cur_parent, iface);
 		}
 
-		if (iface_add_vlan(next->parent_id, next->vlan_id) < 0)
-			return -errno;
-		cur->parent_id = next->parent_id;
-		cur->vlan_id = next->vlan_id;
+		cur->parent_id = parent_id;
+		cur->vlan_id = vlan_id;
+		cur->outer_vlan_id = outer_vlan_id;
 		iface_add_subinterface(next_parent, iface);
 		iface->state = next_parent->state;
 		iface->mtu = next_parent->mtu;
 
-		if ((ret = rte_hash_add_key_data(vlan_hash, &next_key, iface)) < 0)
-			return errno_log(-ret, "rte_hash_add_key_data");
+		if ((ret = vlan_register(iface)) < 0)
+			return ret;
 	}
 
 	if (set_attrs & GR_VLAN_SET_MAC) {
 		if (rte_is_zero_ether_addr(&next->mac)) {
-			if ((ret = iface_get_eth_addr(next->parent_id, &cur->mac)) < 0)
+			if ((ret = iface_get_eth_addr(cur->parent_id, &cur->mac)) < 0)
 				return ret;
 		} else {
-			if ((ret = iface_add_eth_addr(next->parent_id, &next->mac)) < 0)
+			if ((ret = iface_add_eth_addr(cur->parent_id, &next->mac)) < 0)
 				return ret;
 			cur->mac = next->mac;
 		}
@@ -108,9 +243,7 @@ static int iface_vlan_fini(struct iface *iface) {
 	struct iface *parent = iface_from_id(vlan->parent_id);
 	int ret, status = 0;
 
-	rte_hash_del_key(vlan_hash, &(struct vlan_key) {vlan->parent_id, vlan->vlan_id});
-
-	if ((ret = iface_del_vlan(vlan->parent_id, vlan->vlan_id)) < 0)
+	if ((ret = vlan_unregister(iface)) < 0)
 		status = ret;
 
 	if ((ret = iface_del_eth_addr(vlan->parent_id, &vlan->mac)) < 0)
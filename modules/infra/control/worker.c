@@ -28,6 +28,7 @@
 #include <pthread.h>
 #include <sched.h>
 #include <stdatomic.h>
+#include <stdbool.h>
 #include <sys/queue.h>
 #include <unistd.h>
 
@@ -234,6 +235,125 @@ static uint16_t worker_txq_id(const cpu_set_t *affinity, unsigned cpu_id) {
 	return txq;
 }
 
+static void worker_port_queues_del(struct worker *worker, uint16_t port_id) {
+	for (int i = gr_vec_len(worker->rxqs) - 1; i >= 0; i--) {
+		if (worker->rxqs[i].port_id == port_id)
+			gr_vec_del(worker->rxqs, i);
+	}
+	for (int i = gr_vec_len(worker->txqs) - 1; i >= 0; i--) {
+		if (worker->txqs[i].port_id == port_id)
+			gr_vec_del(worker->txqs, i);
+	}
+}
+
+int port_queues_assign(struct iface_info_port *p) {
+	int socket_id = SOCKET_ID_ANY;
+	struct worker *worker, *best;
+	bool local, best_local;
+
+	if (worker_count() == 0)
+		return errno_set(ENODEV);
+
+	if (numa_available() != -1)
+		socket_id = rte_eth_dev_socket_id(p->port_id);
+
+	STAILQ_FOREACH (worker, &workers, next)
+		worker_port_queues_del(worker, p->port_id);
+
+	// Assign each RXQ to the least loaded worker, preferably on the same
+	// NUMA node as the port. Queues of other ports are left untouched.
+	for (uint16_t rxq = 0; rxq < p->n_rxq; rxq++) {
+		best = NULL;
+		best_local = false;
+		STAILQ_FOREACH (worker, &workers, next) {
+			local = socket_id == SOCKET_ID_ANY
+				|| numa_node_of_cpu(worker->cpu_id) == socket_id;
+			if (best == NULL || (local && !best_local)
+			    || (local == best_local
+				&& gr_vec_len(worker->rxqs) < gr_vec_len(best->rxqs))) {
+				best = worker;
+				best_local = local;
+			}
+		}
+		struct queue_map q = {
+			.port_id = p->port_id,
+			.queue_id = rxq,
+			.enabled = p->started,
+		};
+		gr_vec_add(best->rxqs, q);
+	}
+
+	STAILQ_FOREACH (worker, &workers, next) {
+		struct queue_map txq = {
+			.port_id = p->port_id,
+			.queue_id = worker_txq_id(&gr_config.datapath_cpus, worker->cpu_id),
+			.enabled = p->started,
+		};
+		gr_vec_add(worker->txqs, txq);
+	}
+
+	return 0;
+}
+
+static unsigned worker_port_queues_enable(struct worker *worker, uint16_t port_id, bool enabled) {
+	struct queue_map *qmap;
+	unsigned changed = 0;
+
+	gr_vec_foreach_ref (qmap, worker->rxqs) {
+		if (qmap->port_id == port_id && qmap->enabled != enabled) {
+			qmap->enabled = enabled;
+			changed++;
+		}
+	}
+	gr_vec_foreach_ref (qmap, worker->txqs) {
+		if (qmap->port_id == port_id && qmap->enabled != enabled) {
+			qmap->enabled = enabled;
+			changed++;
+		}
+	}
+
+	return changed;
+}
+
+int port_queues_reconfigure(struct iface_info_port *p, port_queue_cb_t cb) {
+	gr_vec struct iface_info_port **ports = NULL;
+	struct iface *iface = NULL;
+	struct queue_map *qmap;
+	struct worker *worker;
+	int ret = 0;
+
+	while ((iface = iface_next(GR_IFACE_TYPE_PORT, iface)) != NULL)
+		gr_vec_add(ports, iface_info_port(iface));
+
+	// Only one worker at a time stops using the port. The other ones
+	// continue to receive and transmit on their own queues.
+	STAILQ_FOREACH (worker, &workers, next) {
+		if (worker_port_queues_enable(worker, p->port_id, false) == 0)
+			continue;
+		if ((ret = worker_graph_reload(worker, ports)) < 0)
+			goto end;
+
+		gr_vec_foreach_ref (qmap, worker->rxqs) {
+			if (qmap->port_id == p->port_id && (ret = cb(p, qmap->queue_id, true)) < 0)
+				goto end;
+		}
+		gr_vec_foreach_ref (qmap, worker->txqs) {
+			if (qmap->port_id == p->port_id && (ret = cb(p, qmap->queue_id, false)) < 0)
+				goto end;
+		}
+
+		worker_port_queues_enable(worker, p->port_id, true);
+		if ((ret = worker_graph_reload(worker, ports)) < 0)
+			goto end;
+	}
+
+end:
+	// On error, the queues of the current worker are left disabled. The
+	// caller must fall back to a full port restart which enables them again.
+	gr_vec_free(ports);
+	return ret;
+}
+
 int worker_rxq_assign(uint16_t port_id, uint16_t rxq_id, uint16_t cpu_id) {
 	struct worker *src_worker, *dst_worker;
 	struct queue_map *qmap;
@@ -10,6 +10,16 @@ int port_unplug(struct iface_info_port *);
 int port_plug(struct iface_info_port *);
 int port_configure(struct iface_info_port *, uint16_t n_txq_min);
 
+// Assign the queues of a single port to the existing workers.
+// Graphs are not reloaded.
+int port_queues_assign(struct iface_info_port *);
+
+typedef int (*port_queue_cb_t)(struct iface_info_port *, uint16_t queue_id, bool rx);
+
+// Call cb for every queue of a running port, one worker at a time. The
+// queues are not polled by their worker while cb is called on them.
+int port_queues_reconfigure(struct iface_info_port *, port_queue_cb_t cb);
+
 unsigned worker_count(void);
 int worker_create(unsigned cpu_id);
 struct worker *worker_find(unsigned cpu_id);
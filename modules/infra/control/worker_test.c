@@ -36,7 +36,11 @@ void gr_register_module(struct gr_module *) { }
 void iface_type_register(struct iface_type *) { }
 void gr_event_push(uint32_t, const void *) { }
 mock_func(struct rte_mempool *, gr_pktmbuf_pool_get(int8_t, uint32_t));
+mock_func(struct rte_mempool *, gr_pktmbuf_jumbo_pool_get(int8_t, uint32_t));
 void gr_pktmbuf_pool_release(struct rte_mempool *, uint32_t) { }
+uint32_t gr_pktmbuf_frame_len_max(void) {
+	return RTE_ETHER_MAX_LEN;
+}
 struct rte_rcu_qsbr *gr_datapath_rcu(void) {
 	static struct rte_rcu_qsbr rcu;
 	return &rcu;
@@ -53,6 +53,10 @@ int post_to_stack(control_input_t type, void *data) {
 	return 0;
 }
 
+unsigned control_input_count(void) {
+	return rte_ring_count(control_input_ring);
+}
+
 static uint16_t control_input_process(
 	struct rte_graph *graph,
 	struct rte_node *node,
@@ -23,6 +23,8 @@ enum {
 };
 
 static rte_edge_t l2l3_edges[1 << 16] = {UNKNOWN_ETHER_TYPE};
+static rte_edge_t acl_edges[1 << 16] = {UNKNOWN_ETHER_TYPE};
+static rte_edge_t police_edges[1 << 16] = {UNKNOWN_ETHER_TYPE};
 
 void gr_eth_input_add_type(rte_be16_t eth_type, const char *next_node) {
 	LOG(DEBUG, "eth_input: type=0x%04x -> %s", rte_be_to_cpu_16(eth_type), next_node);
@@ -32,9 +34,25 @@ void gr_eth_input_add_type(rte_be16_t eth_type, const char *next_node) {
 	l2l3_edges[eth_type] = gr_node_attach_parent("eth_input", next_node);
 }
 
+void gr_eth_input_add_acl_type(rte_be16_t eth_type, const char *next_node) {
+	LOG(DEBUG, "eth_input: acl type=0x%04x -> %s", rte_be_to_cpu_16(eth_type), next_node);
+	if (acl_edges[eth_type] != UNKNOWN_ETHER_TYPE)
+		ABORT("acl node already registered for ether type=0x%04x",
+		      rte_be_to_cpu_16(eth_type));
+	acl_edges[eth_type] = gr_node_attach_parent("eth_input", next_node);
+}
+
+void gr_eth_input_add_police_type(rte_be16_t eth_type, const char *next_node) {
+	LOG(DEBUG, "eth_input: police type=0x%04x -> %s", rte_be_to_cpu_16(eth_type), next_node);
+	if (police_edges[eth_type] != UNKNOWN_ETHER_TYPE)
+		ABORT("police node already registered for ether type=0x%04x",
+		      rte_be_to_cpu_16(eth_type));
+	police_edges[eth_type] = gr_node_attach_parent("eth_input", next_node);
+}
+
 static uint16_t
 eth_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
-	uint16_t vlan_id, last_iface_id, last_vlan_id;
+	uint16_t vlan_id, outer_vlan_id, last_iface_id, last_vlan_id, last_outer_vlan_id;
 	const struct iface *vlan_iface, *iface;
 	struct eth_input_mbuf_data *eth_in;
 	struct rte_ether_addr iface_mac;
@@ -50,6 +68,7 @@ eth_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, u
 	vlan_iface = NULL;
 	last_iface_id = UINT16_MAX;
 	last_vlan_id = UINT16_MAX;
+	last_outer_vlan_id = UINT16_MAX;
 
 	for (uint16_t i = 0; i < nb_objs; i++) {
 		m = objs[i];
@@ -59,25 +78,44 @@ eth_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, u
 		l2_hdr_size = sizeof(*eth);
 		eth_type = eth->ether_type;
 		vlan_id = 0;
+		outer_vlan_id = 0;
 
 		if (unlikely(rte_be_to_cpu_16(eth_type) < SNAP_MAX_LEN)) {
 			edge = SNAP;
 			goto snap;
 		}
 
-		if (m->ol_flags & RTE_MBUF_F_RX_VLAN_STRIPPED) {
+		if (m->ol_flags & RTE_MBUF_F_RX_QINQ_STRIPPED) {
+			// The inner tag is still in the packet unless both were stripped.
+			outer_vlan_id = m->vlan_tci_outer & 0xfff;
+			if (m->ol_flags & RTE_MBUF_F_RX_VLAN_STRIPPED)
+				vlan_id = m->vlan_tci & 0xfff;
+		} else if (m->ol_flags & RTE_MBUF_F_RX_VLAN_STRIPPED) {
 			vlan_id = m->vlan_tci & 0xfff;
-		} else if (eth_type == RTE_BE16(RTE_ETHER_TYPE_VLAN)) {
+		} else if (eth_type == RTE_BE16(RTE_ETHER_TYPE_QINQ)) {
+			vlan = rte_pktmbuf_mtod_offset(m, struct rte_vlan_hdr *, l2_hdr_size);
+			l2_hdr_size += sizeof(*vlan);
+			outer_vlan_id = rte_be_to_cpu_16(vlan->vlan_tci) & 0xfff;
+			eth_type = vlan->eth_proto;
+		}
+		if (vlan_id == 0 && eth_type == RTE_BE16(RTE_ETHER_TYPE_VLAN)) {
 			vlan = rte_pktmbuf_mtod_offset(m, struct rte_vlan_hdr *, l2_hdr_size);
 			l2_hdr_size += sizeof(*vlan);
 			vlan_id = rte_be_to_cpu_16(vlan->vlan_tci) & 0xfff;
 			eth_type = vlan->eth_proto;
 		}
-		if (vlan_id != 0) {
-			if (eth_in->iface->id != last_iface_id || vlan_id != last_vlan_id) {
-				vlan_iface = vlan_get_iface(eth_in->iface->id, vlan_id);
+		if (vlan_id != 0 || outer_vlan_id != 0) {
+			if (eth_in->iface->id != last_iface_id || vlan_id != last_vlan_id
+			    || outer_vlan_id != last_outer_vlan_id) {
+				if (outer_vlan_id != 0)
+					vlan_iface = qinq_get_iface(
+						eth_in->iface->id, outer_vlan_id, vlan_id
+					);
+				else
+					vlan_iface = vlan_get_iface(eth_in->iface->id, vlan_id);
 				last_iface_id = eth_in->iface->id;
 				last_vlan_id = vlan_id;
+				last_outer_vlan_id = outer_vlan_id;
 			}
 			if (vlan_iface == NULL) {
 				edge = UNKNOWN_VLAN;
@@ -90,6 +128,12 @@ eth_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, u
 			eth_in->iface = vlan_iface;
 		}
 		edge = l2l3_edges[eth_type];
+		if (unlikely(eth_in->iface->flags & GR_IFACE_F_ACL_IN)
+		    && acl_edges[eth_type] != UNKNOWN_ETHER_TYPE)
+			edge = acl_edges[eth_type];
+		if (unlikely(eth_in->iface->flags & GR_IFACE_F_POLICE)
+		    && police_edges[eth_type] != UNKNOWN_ETHER_TYPE)
+			edge = police_edges[eth_type];
 
 		if (iface == NULL || iface->id != eth_in->iface->id) {
 			if (iface_get_eth_addr(eth_in->iface->id, &iface_mac) < 0) {
@@ -123,6 +167,7 @@ next:
 			t->eth.dst_addr = eth->dst_addr;
 			t->eth.src_addr = eth->src_addr;
 			t->eth.ether_type = eth_type;
+			t->outer_vlan_id = outer_vlan_id;
 			t->vlan_id = vlan_id;
 			t->iface_id = eth_in->iface->id;
 		}
@@ -142,6 +187,8 @@ int eth_trace_format(char *buf, size_t len, const void *data, size_t /*data_len*
 	SAFE_BUF(snprintf, len, ETH_F " > " ETH_F " type=", &t->eth.src_addr, &t->eth.dst_addr);
 	SAFE_BUF(eth_type_format, len, t->eth.ether_type);
 
+	if (t->outer_vlan_id != 0)
+		SAFE_BUF(snprintf, len, " outer_vlan=%u", t->outer_vlan_id);
 	if (t->vlan_id != 0)
 		SAFE_BUF(snprintf, len, " vlan=%u", t->vlan_id);
 
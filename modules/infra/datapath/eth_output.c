@@ -10,6 +10,7 @@
 #include <gr_trace.h>
 #include <gr_vlan.h>
 
+#include <rte_ethdev.h>
 #include <rte_ether.h>
 
 #include <stdint.h>
@@ -19,6 +20,7 @@ enum {
 	NO_HEADROOM,
 	NO_MAC,
 	IFACE_DOWN,
+	SCHED,
 	NB_EDGES,
 };
 
@@ -33,13 +35,62 @@ void eth_output_register_interface_type(gr_iface_type_t type, const char *next_n
 	iface_type_edges[type] = gr_node_attach_parent("eth_output", next_node);
 }
 
+static inline int vlan_push(struct rte_mbuf *m, rte_be16_t *ether_type, uint16_t vlan_id) {
+	struct rte_vlan_hdr *vlan;
+
+	vlan = (struct rte_vlan_hdr *)rte_pktmbuf_prepend(m, sizeof(*vlan));
+	if (unlikely(vlan == NULL))
+		return -1;
+	vlan->vlan_tci = rte_cpu_to_be_16(vlan_id);
+	vlan->eth_proto = *ether_type;
+	*ether_type = RTE_BE16(RTE_ETHER_TYPE_VLAN);
+
+	return 0;
+}
+
+// Insert the VLAN tags of a sub-interface. Use the port offloads if available.
+static inline int vlan_insert(
+	struct rte_mbuf *m,
+	struct eth_output_mbuf_data *priv,
+	const struct iface_info_vlan *sub
+) {
+	uint64_t offloads = 0;
+
+	if (priv->iface->type == GR_IFACE_TYPE_PORT)
+		offloads = iface_info_port(priv->iface)->tx_offloads;
+
+	if (sub->outer_vlan_id == 0) {
+		if (offloads & RTE_ETH_TX_OFFLOAD_VLAN_INSERT) {
+			m->vlan_tci = sub->vlan_id;
+			m->ol_flags |= RTE_MBUF_F_TX_VLAN;
+			return 0;
+		}
+		return vlan_push(m, &priv->ether_type, sub->vlan_id);
+	}
+
+	if (offloads & RTE_ETH_TX_OFFLOAD_QINQ_INSERT) {
+		m->vlan_tci = sub->vlan_id;
+		m->vlan_tci_outer = sub->outer_vlan_id;
+		m->ol_flags |= RTE_MBUF_F_TX_VLAN | RTE_MBUF_F_TX_QINQ;
+		return 0;
+	}
+	if (vlan_push(m, &priv->ether_type, sub->vlan_id) < 0)
+		return -1;
+	if (vlan_push(m, &priv->ether_type, sub->outer_vlan_id) < 0)
+		return -1;
+	priv->ether_type = RTE_BE16(RTE_ETHER_TYPE_QINQ);
+
+	return 0;
+}
+
 static uint16_t
 eth_output_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	const struct iface_info_vlan *sub;
 	struct eth_output_mbuf_data *priv;
 	struct rte_ether_addr src_mac;
 	const struct iface *iface;
-	struct rte_vlan_hdr *vlan;
 	struct rte_ether_hdr *eth;
+	rte_be16_t ether_type;
 	struct rte_mbuf *mbuf;
 	rte_edge_t edge;
 
@@ -47,10 +98,11 @@ eth_output_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 		mbuf = objs[i];
 		priv = eth_output_mbuf_data(mbuf);
 		iface = priv->iface;
-		vlan = NULL;
+		ether_type = priv->ether_type;
+		sub = NULL;
 
 		if (priv->iface->type == GR_IFACE_TYPE_VLAN) {
-			const struct iface_info_vlan *sub = iface_info_vlan(priv->iface);
+			sub = iface_info_vlan(priv->iface);
 			priv->iface = iface_from_id(sub->parent_id);
 			if (priv->iface == NULL) {
 				edge = INVAL;
@@ -60,14 +112,10 @@ eth_output_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 				edge = IFACE_DOWN;
 				goto next;
 			}
-			vlan = (struct rte_vlan_hdr *)rte_pktmbuf_prepend(mbuf, sizeof(*vlan));
-			if (unlikely(vlan == NULL)) {
+			if (vlan_insert(mbuf, priv, sub) < 0) {
 				edge = NO_HEADROOM;
 				goto next;
 			}
-			vlan->vlan_tci = rte_cpu_to_be_16(sub->vlan_id);
-			vlan->eth_proto = priv->ether_type;
-			priv->ether_type = RTE_BE16(RTE_ETHER_TYPE_VLAN);
 			src_mac = sub->mac;
 		} else if (iface_get_eth_addr(priv->iface->id, &src_mac) < 0) {
 			edge = NO_MAC;
@@ -91,12 +139,16 @@ eth_output_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 		stats->tx_packets += 1;
 		stats->tx_bytes += rte_pktmbuf_pkt_len(mbuf);
 
+		if (unlikely(priv->iface->flags & GR_IFACE_F_SCHED))
+			edge = SCHED;
+
 		if (gr_mbuf_is_traced(mbuf)) {
 			struct eth_trace_data *t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
 			t->eth.dst_addr = eth->dst_addr;
 			t->eth.src_addr = eth->src_addr;
-			t->eth.ether_type = vlan ? vlan->eth_proto : eth->ether_type;
-			t->vlan_id = rte_be_to_cpu_16(vlan ? vlan->vlan_tci : 0);
+			t->eth.ether_type = ether_type;
+			t->outer_vlan_id = sub ? sub->outer_vlan_id : 0;
+			t->vlan_id = sub ? sub->vlan_id : 0;
 			t->iface_id = priv->iface->id;
 		}
 next:
@@ -117,6 +169,7 @@ static struct rte_node_register node = {
 		[NO_HEADROOM] = "error_no_headroom",
 		[NO_MAC] = "eth_output_no_mac",
 		[IFACE_DOWN] = "iface_input_admin_down",
+		[SCHED] = "port_sched",
 	},
 };
 
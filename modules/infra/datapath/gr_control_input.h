@@ -12,3 +12,6 @@ typedef uint8_t control_input_t;
 control_input_t gr_control_input_register_handler(const char *node_name, bool data_is_mbuf);
 
 int post_to_stack(control_input_t type, void *data);
+
+// Number of messages waiting to be processed by the control_input node.
+unsigned control_input_count(void);
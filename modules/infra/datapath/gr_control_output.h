@@ -26,6 +26,9 @@ GR_MBUF_PRIV_DATA_TYPE(control_output_mbuf_data, {
 // NB: control_output_done() must be called explicitly to wake up the control plane event loop.
 int control_output_enqueue(struct rte_mbuf *m);
 
+// Number of packets waiting to be processed by the control plane.
+unsigned control_output_count(void);
+
 // Wake up the control plane event loop so that it processes the pending packets.
 void control_output_done(void);
 
@@ -27,9 +27,16 @@ GR_MBUF_PRIV_DATA_TYPE(eth_output_mbuf_data, {
 });
 
 void gr_eth_input_add_type(rte_be16_t eth_type, const char *node_name);
+// Packets received on interfaces with GR_IFACE_F_ACL_IN are sent to this node
+// instead of the one registered with gr_eth_input_add_type.
+void gr_eth_input_add_acl_type(rte_be16_t eth_type, const char *node_name);
+// Packets received on interfaces with GR_IFACE_F_POLICE are sent to this node
+// before any other processing, including ACLs.
+void gr_eth_input_add_police_type(rte_be16_t eth_type, const char *node_name);
 
 struct eth_trace_data {
 	struct rte_ether_hdr eth;
+	uint16_t outer_vlan_id;
 	uint16_t vlan_id;
 	uint16_t iface_id;
 };
@@ -66,3 +66,28 @@ void *gr_mbuf_trace_add(struct rte_mbuf *m, struct rte_node *node, size_t data_l
 
 // Detach the trace items from an mbuf and store them in the trace buffer.
 void gr_mbuf_trace_finish(struct rte_mbuf *m);
+
+// Shorten a packet to len bytes, freeing the segments that become unused.
+//
+// Unlike rte_pktmbuf_trim(), this works when the bytes to remove span over
+// multiple segments. Does nothing if the packet is already shorter.
+static inline void gr_mbuf_truncate(struct rte_mbuf *m, uint32_t len) {
+	struct rte_mbuf *seg = m;
+	uint32_t remain = len;
+	uint16_t nb_segs = 1;
+
+	if (len >= rte_pktmbuf_pkt_len(m))
+		return;
+
+	while (remain > seg->data_len) {
+		remain -= seg->data_len;
+		seg = seg->next;
+		nb_segs++;
+	}
+
+	seg->data_len = remain;
+	rte_pktmbuf_free(seg->next);
+	seg->next = NULL;
+	m->nb_segs = nb_segs;
+	m->pkt_len = len;
+}
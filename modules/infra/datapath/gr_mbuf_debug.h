@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_graph.h>
+#include <gr_vec.h>
+
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+
+// Name of the mempool ops used for packet buffers when leak detection is enabled.
+#define MBUF_DEBUG_MEMPOOL_OPS "grout_mbuf_debug"
+
+// Leak detection metadata, stored in an mbuf dynamic field.
+struct mbuf_debug {
+	uint64_t ts; //!< TSC when the mbuf entered the graph, 0 if not owned by the graph
+	rte_node_t node_id; //!< last node that processed this mbuf
+};
+
+// Offset of the mbuf_debug dynamic field. Negative if leak detection is disabled.
+extern int mbuf_debug_offset;
+
+static inline struct mbuf_debug *mbuf_debug(struct rte_mbuf *m) {
+	return RTE_MBUF_DYNFIELD(m, mbuf_debug_offset, struct mbuf_debug *);
+}
+
+static inline void mbuf_debug_reset(struct rte_mbuf *m) {
+	struct mbuf_debug *d = mbuf_debug(m);
+	d->ts = 0;
+	d->node_id = RTE_NODE_ID_INVALID;
+}
+
+// Mark mbufs as no longer owned by the graph before handing them over to
+// a driver. They will be reported as held by drivers instead of leaked.
+static inline void mbuf_debug_release(struct rte_mbuf **mbufs, uint16_t n) {
+	if (likely(mbuf_debug_offset < 0))
+		return;
+	for (uint16_t i = 0; i < n; i++)
+		mbuf_debug_reset(mbufs[i]);
+}
+
+// Process function installed in all nodes when leak detection is enabled.
+// Records the node into each mbuf and invokes the original process function.
+uint16_t mbuf_debug_process(struct rte_graph *, struct rte_node *, void **objs, uint16_t n);
+
+// Remember the original process function of a node.
+void mbuf_debug_node_add(rte_node_t node_id, rte_node_process_t process);
+
+struct mbuf_debug_scan {
+	uint32_t drivers; //!< mbufs outside of the pools but not owned by the graph
+	gr_vec uint32_t *inflight; //!< mbufs owned by the graph, indexed by last node id
+	gr_vec uint32_t *leaked; //!< mbufs owned by the graph for too long, by last node id
+};
+
+// Walk all packet buffers and count the ones outside of their pool.
+void mbuf_debug_scan(struct mbuf_debug_scan *);
+
+void mbuf_debug_scan_free(struct mbuf_debug_scan *);
@@ -26,6 +26,10 @@ static int trace_vrf_format(char *buf, size_t len, const void *data, size_t /*da
 	return snprintf(buf, len, "vrf=%u", t->vrf_id);
 }
 
+// Re-inject packets routed to a loopback interface in the loopback VRF.
+// Routes leaked to plain L3 nexthops are resolved directly by ip_output and
+// ip6_output. Only local delivery, other nexthop types and loopbacks with uRPF
+// or PBR enabled end up here.
 static uint16_t
 loop_xvrf_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
 	struct eth_input_mbuf_data *eth_data;
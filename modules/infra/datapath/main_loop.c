@@ -7,6 +7,7 @@
 #include <gr_log.h>
 #include <gr_module.h>
 #include <gr_rcu.h>
+#include <gr_shm.h>
 #include <gr_sort.h>
 #include <gr_vec.h>
 #include <gr_worker.h>
@@ -213,6 +214,9 @@ void *gr_datapath_loop(void *priv) {
 
 	log(INFO, "lcore_id = %d", w->lcore_id);
 
+	if (gr_shm != NULL)
+		atomic_store(&gr_shm->workers[w->lcore_id], w);
+
 	rte_rcu_qsbr_thread_register(rcu, rte_lcore_id());
 
 	static_assert(atomic_is_lock_free(&w->shutdown));
@@ -291,6 +295,8 @@ shutdown:
 	rte_free(ctx.w_stats);
 	rte_free(ctx.node_to_index);
 	rte_rcu_qsbr_thread_unregister(rcu, rte_lcore_id());
+	if (gr_shm != NULL)
+		atomic_store(&gr_shm->workers[w->lcore_id], NULL);
 	rte_thread_unregister();
 	w->lcore_id = LCORE_ID_ANY;
 
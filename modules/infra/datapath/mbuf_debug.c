@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_graph.h>
+#include <gr_mbuf_debug.h>
+#include <gr_vec.h>
+
+#include <rte_cycles.h>
+
+int mbuf_debug_offset = -1;
+
+// original process functions, indexed by node id
+static gr_vec rte_node_process_t *node_process;
+
+void mbuf_debug_node_add(rte_node_t node_id, rte_node_process_t process) {
+	while (gr_vec_len(node_process) <= node_id)
+		gr_vec_add(node_process, NULL);
+	node_process[node_id] = process;
+}
+
+uint16_t
+mbuf_debug_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t n) {
+	// cloned nodes (e.g. port_rx-p0q0) share the process function of their parent
+	rte_node_t id = node->parent_id != RTE_NODE_ID_INVALID ? node->parent_id : node->id;
+	uint64_t now = rte_rdtsc();
+
+	for (uint16_t i = 0; i < n; i++) {
+		struct mbuf_debug *d = mbuf_debug(objs[i]);
+		if (d->ts == 0)
+			d->ts = now;
+		d->node_id = node->id;
+	}
+
+	return node_process[id](graph, node, objs, n);
+}
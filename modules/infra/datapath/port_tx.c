@@ -6,6 +6,7 @@
 #include <gr_iface.h>
 #include <gr_log.h>
 #include <gr_mbuf.h>
+#include <gr_mbuf_debug.h>
 #include <gr_rxtx.h>
 #include <gr_trace.h>
 #include <gr_worker.h>
@@ -53,6 +54,7 @@ tx_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t
 		}
 	}
 
+	mbuf_debug_release(mbufs, nb_objs);
 	tx_ok = rte_eth_tx_burst(ctx->port_id, ctx->queue_id, mbufs, nb_objs);
 	if (tx_ok < nb_objs)
 		rte_node_enqueue(graph, node, TX_ERROR, &objs[tx_ok], nb_objs - tx_ok);
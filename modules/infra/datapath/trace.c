@@ -410,6 +410,20 @@ void trace_log_packet(const struct rte_mbuf *m, const char *node, const char *if
 
 	SAFE_BUF(snprintf, sizeof(buf), ETH_F " > " ETH_F, &src, &dst);
 
+	if (m->ol_flags & RTE_MBUF_F_RX_QINQ_STRIPPED) {
+		uint16_t vlan_id = m->vlan_tci_outer & 0xfff;
+		SAFE_BUF(snprintf, sizeof(buf), " / QinQ id=%u", vlan_id);
+	} else if (ether_type == RTE_BE16(RTE_ETHER_TYPE_QINQ)) {
+		const struct rte_vlan_hdr *vlan;
+		uint16_t vlan_id;
+
+		vlan = rte_pktmbuf_mtod_offset(m, const struct rte_vlan_hdr *, offset);
+		offset += sizeof(*vlan);
+		vlan_id = rte_be_to_cpu_16(vlan->vlan_tci) & 0xfff;
+		ether_type = vlan->eth_proto;
+		SAFE_BUF(snprintf, sizeof(buf), " / QinQ id=%u", vlan_id);
+	}
+
 	if (m->ol_flags & RTE_MBUF_F_RX_VLAN_STRIPPED) {
 		uint16_t vlan_id = m->vlan_tci & 0xfff;
 		SAFE_BUF(snprintf, sizeof(buf), " / VLAN id=%u", vlan_id);
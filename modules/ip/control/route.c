@@ -19,6 +19,7 @@
 #include <rte_ethdev.h>
 #include <rte_malloc.h>
 #include <rte_rib.h>
+#include <rte_rwlock.h>
 #include <rte_telemetry.h>
 
 #include <arpa/inet.h>
@@ -29,6 +30,9 @@
 #include <sys/queue.h>
 
 static struct rte_rib **vrf_ribs;
+// RIB modifications are done on the main event loop. This lock serializes them
+// with routes listing from background API threads.
+static rte_rwlock_t rib_lock = RTE_RWLOCK_INITIALIZER;
 static struct rib4_stats stats[GR_MAX_VRFS];
 
 static struct rte_rib_conf rib_conf = {
@@ -64,7 +68,9 @@ static struct rte_rib *get_or_create_rib(uint16_t vrf_id) {
 		if (rib == NULL)
 			return errno_set_null(rte_errno);
 
+		rte_rwlock_write_lock(&rib_lock);
 		vrf_ribs[vrf_id] = rib;
+		rte_rwlock_write_unlock(&rib_lock);
 	}
 
 	return rib;
@@ -154,7 +160,9 @@ static int rib4_insert_or_replace(
 	}
 
 	if ((rn = rte_rib_lookup_exact(rib, rte_be_to_cpu_32(ip), prefixlen)) == NULL) {
+		rte_rwlock_write_lock(&rib_lock);
 		rn = rte_rib_insert(rib, rte_be_to_cpu_32(ip), prefixlen);
+		rte_rwlock_write_unlock(&rib_lock);
 		if (rn == NULL) {
 			ret = -rte_errno;
 			goto fail;
@@ -169,12 +177,14 @@ static int rib4_insert_or_replace(
 		}
 	}
 
+	rte_rwlock_write_lock(&rib_lock);
 	rte_rib_set_nh(rn, nh_ptr_to_id(nh));
 	o = rte_rib_get_ext(rn);
 	gr_nh_origin_t old_origin = origin;
 	if (existing)
 		old_origin = *o;
 	*o = origin;
+	rte_rwlock_write_unlock(&rib_lock);
 	fib4_insert(vrf_id, ip, prefixlen, nh);
 	if (origin != GR_NH_ORIGIN_INTERNAL) {
 		gr_event_push(
@@ -234,7 +244,9 @@ int rib4_delete(uint16_t vrf_id, ip4_addr_t ip, uint8_t prefixlen, gr_nh_type_t
 	if (nh->type != nh_type)
 		return errno_set(EINVAL);
 
+	rte_rwlock_write_lock(&rib_lock);
 	rte_rib_remove(rib, rte_be_to_cpu_32(ip), prefixlen);
+	rte_rwlock_write_unlock(&rib_lock);
 	fib4_remove(vrf_id, ip, prefixlen);
 
 	if (origin != GR_NH_ORIGIN_INTERNAL) {
@@ -413,11 +425,84 @@ static void route4_list_cb(
 	}
 }
 
+struct route4_entry {
+	ip4_addr_t ip;
+	uint8_t prefixlen;
+	gr_nh_origin_t origin;
+	const struct nexthop *nh;
+};
+
+static void route4_entry_add(gr_vec struct route4_entry **entries, struct rte_rib_node *rn) {
+	struct route4_entry e;
+	uintptr_t nh_id;
+	uint32_t ip;
+
+	e.origin = *(gr_nh_origin_t *)rte_rib_get_ext(rn);
+	if (e.origin == GR_NH_ORIGIN_INTERNAL)
+		return;
+	rte_rib_get_ip(rn, &ip);
+	rte_rib_get_depth(rn, &e.prefixlen);
+	rte_rib_get_nh(rn, &nh_id);
+	e.ip = rte_cpu_to_be_32(ip);
+	e.nh = nh_id_to_ptr(nh_id);
+	gr_vec_add(*entries, e);
+}
+
+// Copy the routes of one chunk of a VRF RIB. Chunk 0 holds all prefixes up to
+// /8. Chunk N holds the more specific prefixes of (N - 1).0.0.0/8.
+static void
+rib4_chunk_copy(struct rte_rib *rib, unsigned chunk, gr_vec struct route4_entry **entries) {
+	struct rte_rib_node *rn;
+	uint8_t depth;
+
+	if (chunk == 0) {
+		for (depth = 0; depth <= 8; depth++) {
+			for (uint32_t i = 0; i < (UINT32_C(1) << depth); i++) {
+				uint32_t ip = depth ? i << (32 - depth) : 0;
+				if ((rn = rte_rib_lookup_exact(rib, ip, depth)) != NULL)
+					route4_entry_add(entries, rn);
+			}
+		}
+		return;
+	}
+
+	rn = NULL;
+	while ((rn = rte_rib_get_nxt(rib, (chunk - 1) << 24, 8, rn, RTE_RIB_GET_NXT_ALL)) != NULL) {
+		rte_rib_get_depth(rn, &depth);
+		if (depth > 8)
+			route4_entry_add(entries, rn);
+	}
+}
+
+// Runs on a background API thread. The RIB is read in chunks so that route
+// updates on the main event loop only wait for one chunk to be copied.
+// Nexthops are protected by RCU until api_quiescent() is called.
 static struct api_out route4_list(const void *request, struct api_ctx *ctx) {
 	const struct gr_ip4_route_list_req *req = request;
 	struct route4_iterator iter = {.ctx = ctx, .ret = 0};
+	gr_vec struct route4_entry *entries = NULL;
+	const struct route4_entry *e;
+	struct rte_rib *rib;
+
+	for (uint16_t v = 0; v < GR_MAX_VRFS && iter.ret == 0; v++) {
+		if (v != req->vrf_id && req->vrf_id != GR_VRF_ID_ALL)
+			continue;
 
-	rib4_iter(req->vrf_id, route4_list_cb, &iter);
+		for (unsigned chunk = 0; chunk <= 256 && iter.ret == 0; chunk++) {
+			rte_rwlock_read_lock(&rib_lock);
+			rib = vrf_ribs[v];
+			if (rib != NULL)
+				rib4_chunk_copy(rib, chunk, &entries);
+			rte_rwlock_read_unlock(&rib_lock);
+			if (rib == NULL)
+				break;
+
+			gr_vec_foreach_ref (e, entries)
+				route4_list_cb(v, e->ip, e->prefixlen, e->origin, e->nh, &iter);
+			gr_vec_free(entries);
+			api_quiescent();
+		}
+	}
 
 	return api_out(iter.ret, 0, NULL);
 }
@@ -552,6 +637,7 @@ static struct gr_api_handler route4_list_handler = {
 	.name = "ipv4 route list",
 	.request_type = GR_IP4_ROUTE_LIST,
 	.callback = route4_list,
+	.background = true,
 };
 
 static struct gr_event_serializer route_serializer = {
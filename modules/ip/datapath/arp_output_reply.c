@@ -7,6 +7,7 @@
 #include <gr_iface.h>
 #include <gr_ip4_control.h>
 #include <gr_ip4_datapath.h>
+#include <gr_mbuf.h>
 #include <gr_trace.h>
 
 #include <rte_arp.h>
@@ -49,7 +50,7 @@ static uint16_t arp_output_reply_process(
 		l3 = nexthop_info_l3(local);
 
 		// Reuse mbuf to craft an ARP reply.
-		rte_pktmbuf_trim(mbuf, rte_pktmbuf_pkt_len(mbuf));
+		gr_mbuf_truncate(mbuf, 0);
 		arp = (struct rte_arp_hdr *)rte_pktmbuf_append(mbuf, sizeof(*arp));
 		arp->arp_hardware = RTE_BE16(RTE_ARP_HRD_ETHER);
 		arp->arp_protocol = RTE_BE16(RTE_ETHER_TYPE_IPV4);
@@ -102,6 +102,21 @@ const struct nexthop *fib4_lookup(uint16_t vrf_id, ip4_addr_t ip) {
 	return nh_id_to_ptr(nh_id);
 }
 
+void fib4_lookup_x2(uint16_t vrf_id, const ip4_addr_t ips[2], const struct nexthop *nhs[2]) {
+	uint32_t host_order_ips[2] = {rte_be_to_cpu_32(ips[0]), rte_be_to_cpu_32(ips[1])};
+	struct rte_fib *fib = get_fib(vrf_id);
+	uintptr_t nh_ids[2];
+
+	if (fib == NULL) {
+		nhs[0] = nhs[1] = NULL;
+		return;
+	}
+
+	rte_fib_lookup_bulk(fib, host_order_ips, nh_ids, 2);
+	nhs[0] = nh_id_to_ptr(nh_ids[0]);
+	nhs[1] = nh_id_to_ptr(nh_ids[1]);
+}
+
 int fib4_insert(uint16_t vrf_id, ip4_addr_t ip, uint8_t prefixlen, const struct nexthop *nh) {
 	struct rte_fib *fib;
 	int ret;
@@ -13,6 +13,10 @@
 
 // Only for datapath use
 const struct nexthop *fib4_lookup(uint16_t vrf_id, ip4_addr_t ip);
+// Lookup two addresses in a single bulk operation. Used to resolve the source
+// along with the destination address for unicast reverse path forwarding checks.
+// Missing routes are reported as NULL next hops.
+void fib4_lookup_x2(uint16_t vrf_id, const ip4_addr_t ips[2], const struct nexthop *nhs[2]);
 
 // Only for control plane use to update the fib
 int fib4_insert(uint16_t vrf_id, ip4_addr_t ip, uint8_t prefixlen, const struct nexthop *);
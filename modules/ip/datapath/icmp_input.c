@@ -40,7 +40,10 @@ icmp_input_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 		mbuf = objs[i];
 		icmp = rte_pktmbuf_mtod(mbuf, struct rte_icmp_hdr *);
 		ip_data = ip_local_mbuf_data(mbuf);
-		cksum = ~rte_raw_cksum(icmp, ip_data->len);
+		// jumbo echo requests may span over multiple segments
+		if (rte_raw_cksum_mbuf(mbuf, 0, ip_data->len, &cksum) < 0)
+			cksum = 0;
+		cksum = ~cksum;
 
 		if (ip_data->len < ICMP_MIN_SIZE || cksum) {
 			edge = INVALID;
@@ -31,6 +31,7 @@ icmp_output_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 	struct rte_ipv4_hdr *ip;
 	struct rte_mbuf *mbuf;
 	rte_edge_t edge;
+	uint16_t cksum;
 
 	for (uint16_t i = 0; i < nb_objs; i++) {
 		mbuf = objs[i];
@@ -38,7 +39,9 @@ icmp_output_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 
 		icmp = rte_pktmbuf_mtod(mbuf, struct rte_icmp_hdr *);
 		icmp->icmp_cksum = 0;
-		icmp->icmp_cksum = ~rte_raw_cksum(icmp, local_data->len);
+		cksum = 0;
+		rte_raw_cksum_mbuf(mbuf, 0, local_data->len, &cksum);
+		icmp->icmp_cksum = ~cksum;
 
 		ip = (struct rte_ipv4_hdr *)rte_pktmbuf_prepend(mbuf, sizeof(*ip));
 		if (unlikely(ip == NULL)) {
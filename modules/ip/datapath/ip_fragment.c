@@ -43,7 +43,6 @@ ip_fragment_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 	uint16_t ip_hdr_len;
 	uint16_t sent = 0;
 	rte_edge_t edge;
-	void *payload;
 
 	for (uint16_t j = 0; j < nb_objs; j++) {
 		mbuf = objs[j];
@@ -95,25 +94,25 @@ ip_fragment_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 
 		// Create and enqueue remaining fragments
 		for (i = 1; i < num_frags; i++) {
-			// Create new fragment, copying the original IPv4 header.
-			frag_mbuf = rte_pktmbuf_copy(mbuf, mbuf->pool, 0, ip_hdr_len);
+			offset = i * frag_size;
+			frag_data_len = RTE_MIN(frag_size, data_len - offset);
+
+			// Copy the fragment payload. The original packet and the
+			// fragment may both span over multiple segments.
+			frag_mbuf = rte_pktmbuf_copy(
+				mbuf, mbuf->pool, ip_hdr_len + offset, frag_data_len
+			);
 			if (unlikely(frag_mbuf == NULL)) {
 				break;
 			}
 
-			frag_ip = rte_pktmbuf_mtod(frag_mbuf, struct rte_ipv4_hdr *);
-			offset = i * frag_size;
-			frag_data_len = RTE_MIN(frag_size, data_len - offset);
-
-			payload = rte_pktmbuf_append(frag_mbuf, frag_data_len);
-			if (unlikely(payload == NULL)) {
+			// Prepend a copy of the original IPv4 header.
+			frag_ip = (struct rte_ipv4_hdr *)rte_pktmbuf_prepend(frag_mbuf, ip_hdr_len);
+			if (unlikely(frag_ip == NULL)) {
 				rte_pktmbuf_free(frag_mbuf);
 				break;
 			}
-
-			memcpy(payload,
-			       rte_pktmbuf_mtod_offset(mbuf, const void *, ip_hdr_len + offset),
-			       frag_data_len);
+			memcpy(frag_ip, ip, ip_hdr_len);
 
 			frag_ip->total_length = rte_cpu_to_be_16(ip_hdr_len + frag_data_len);
 			frag_ip->fragment_offset = rte_cpu_to_be_16(
@@ -138,7 +137,7 @@ ip_fragment_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 		}
 
 		// Trim first fragment to the right size
-		rte_pktmbuf_trim(mbuf, data_len - frag_size);
+		gr_mbuf_truncate(mbuf, ip_hdr_len + frag_size);
 
 		continue;
 
@@ -9,6 +9,7 @@
 #include <gr_ip4_datapath.h>
 #include <gr_log.h>
 #include <gr_loopback.h>
+#include <gr_mroute_datapath.h>
 #include <gr_trace.h>
 
 #include <rte_byteorder.h>
@@ -21,9 +22,13 @@
 enum edges {
 	FORWARD = 0,
 	DNAT44_DYNAMIC,
+	SNAT44_HAIRPIN,
+	MCAST_FORWARD,
+	PBR,
 	OUTPUT,
 	LOCAL,
 	NO_ROUTE,
+	URPF_FAIL,
 	BAD_CHECKSUM,
 	BAD_LENGTH,
 	BAD_VERSION,
@@ -42,13 +47,53 @@ void ip_input_register_nexthop_type(gr_nh_type_t type, const char *next_node) {
 	nh_type_edges[type] = gr_node_attach_parent("ip_input", next_node);
 }
 
+// Select the next node for a packet destined to a local address.
+static inline rte_edge_t snat44_local_edge(const struct iface *iface, struct rte_mbuf *mbuf) {
+	conn_flow_t flow = CONN_FLOW_REV;
+	struct conn_mbuf_data *cd;
+	struct conn_key key;
+	struct conn *conn;
+
+	if (!(iface->flags & GR_IFACE_F_SNAT_DYNAMIC)) {
+		// The destination may be the external endpoint of an internal host.
+		if (unlikely(snat44_eim_policies > 0))
+			return SNAT44_HAIRPIN;
+		return LOCAL;
+	}
+
+	// XXX: All returning IP fragments will go to LOCAL
+	// whether they are part of a conntrack or not.
+	// We need reassembly to fix this.
+	if (!gr_conn_parse_key(iface, GR_AF_IP4, mbuf, &key))
+		return LOCAL;
+
+	conn = gr_conn_lookup(&key, &flow);
+	if (conn == NULL && snat44_eim_policies > 0) {
+		// Endpoint independent filtering: accept new connections from
+		// any remote endpoint to an existing mapping.
+		conn = snat44_conntrack_create_inbound(&key);
+		flow = CONN_FLOW_FWD;
+	}
+	if (conn == NULL)
+		return LOCAL;
+
+	cd = conn_mbuf_data(mbuf);
+	cd->conn = conn;
+	cd->flow = flow;
+
+	return DNAT44_DYNAMIC;
+}
+
 static uint16_t
 ip_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
 	const struct nexthop_info_l3 *l3;
 	struct eth_input_mbuf_data *e;
+	const struct nexthop *nhs[2];
 	const struct iface *iface;
 	const struct nexthop *nh;
+	struct mroute_entry *mr;
 	struct rte_ipv4_hdr *ip;
+	ip4_addr_t addrs[2];
 	struct rte_mbuf *mbuf;
 	eth_domain_t domain;
 	rte_edge_t edge;
@@ -113,6 +158,15 @@ ip_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, ui
 			goto next;
 		}
 
+		if (unlikely(RTE_IS_IPV4_MCAST(rte_be_to_cpu_32(ip->dst_addr)))) {
+			mr = mroute4_lookup(iface->vrf_id, ip->src_addr, ip->dst_addr);
+			if (mr != NULL) {
+				mroute_mbuf_data(mbuf)->mr = mr;
+				edge = MCAST_FORWARD;
+				goto next;
+			}
+		}
+
 		switch (domain) {
 		case ETH_DOMAIN_LOOPBACK:
 		case ETH_DOMAIN_LOCAL:
@@ -130,15 +184,33 @@ ip_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, ui
 			goto next;
 		}
 
-		nh = fib4_lookup(iface->vrf_id, ip->dst_addr);
-		if (nh == NULL) {
-			edge = NO_ROUTE;
-			goto next;
+		if (unlikely(iface->flags & GR_IFACE_F_URPF)) {
+			// Resolve the source along with the destination address.
+			addrs[0] = ip->dst_addr;
+			addrs[1] = ip->src_addr;
+			fib4_lookup_x2(iface->vrf_id, addrs, nhs);
+			if (!nexthop_urpf_check(
+				    nhs[1], iface->id, iface->flags & GR_IFACE_F_URPF_STRICT
+			    )) {
+				edge = URPF_FAIL;
+				goto next;
+			}
+			nh = nhs[0];
+		} else {
+			nh = fib4_lookup(iface->vrf_id, ip->dst_addr);
 		}
-
 		// Store the resolved next hop for ip_output to avoid a second route lookup.
 		ip_output_mbuf_data(mbuf)->nh = nh;
 
+		if (nh == NULL) {
+			// Policy based routing may select a route.
+			if (unlikely(iface->flags & GR_IFACE_F_PBR))
+				edge = PBR;
+			else
+				edge = NO_ROUTE;
+			goto next;
+		}
+
 		edge = nh_type_edges[nh->type];
 		if (edge != FORWARD)
 			goto next;
@@ -149,26 +221,12 @@ ip_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, ui
 			edge = OUTPUT;
 		else if (nh->type == GR_NH_T_L3) {
 			l3 = nexthop_info_l3(nh);
-			if (l3->flags & GR_NH_F_LOCAL && ip->dst_addr == l3->ipv4) {
-				edge = LOCAL;
-				if (iface->flags & GR_IFACE_F_SNAT_DYNAMIC) {
-					conn_flow_t flow = CONN_FLOW_REV;
-					struct conn_key key;
-					struct conn *conn;
-
-					// XXX: All returning IP fragments will go to LOCAL
-					// whether they are part of a conntrack or not.
-					// We need reassembly to fix this.
-					if (gr_conn_parse_key(iface, GR_AF_IP4, mbuf, &key)
-					    && (conn = gr_conn_lookup(&key, &flow)) != NULL) {
-						struct conn_mbuf_data *cd = conn_mbuf_data(mbuf);
-						cd->conn = conn;
-						cd->flow = flow;
-						edge = DNAT44_DYNAMIC;
-					}
-				}
-			}
+			if (l3->flags & GR_NH_F_LOCAL && ip->dst_addr == l3->ipv4)
+				edge = snat44_local_edge(iface, mbuf);
 		}
+		// Policy based routing never applies to local packets.
+		if (unlikely(iface->flags & GR_IFACE_F_PBR) && edge == FORWARD)
+			edge = PBR;
 next:
 		if (gr_mbuf_is_traced(mbuf)) {
 			struct rte_ipv4_hdr *t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
@@ -195,9 +253,13 @@ static struct rte_node_register input_node = {
 	.next_nodes = {
 		[FORWARD] = "ip_forward",
 		[DNAT44_DYNAMIC] = "dnat44_dynamic",
+		[SNAT44_HAIRPIN] = "snat44_hairpin",
+		[MCAST_FORWARD] = "ip_mcast_forward",
+		[PBR] = "ip_pbr",
 		[OUTPUT] = "ip_output",
 		[LOCAL] = "ip_input_local",
 		[NO_ROUTE] = "ip_error_dest_unreach",
+		[URPF_FAIL] = "ip_input_urpf_fail",
 		[BAD_CHECKSUM] = "ip_input_bad_checksum",
 		[BAD_LENGTH] = "ip_input_bad_length",
 		[BAD_VERSION] = "ip_input_bad_version",
@@ -217,6 +279,7 @@ GR_DROP_REGISTER(ip_input_bad_checksum);
 GR_DROP_REGISTER(ip_input_bad_length);
 GR_DROP_REGISTER(ip_input_bad_version);
 GR_DROP_REGISTER(ip_input_other_host);
+GR_DROP_REGISTER(ip_input_urpf_fail);
 GR_DROP_REGISTER(ip_blackhole);
 
 #ifdef __GROUT_UNIT_TEST__
@@ -226,6 +289,10 @@ int gr_rte_log_type;
 struct node_infos node_infos = STAILQ_HEAD_INITIALIZER(node_infos);
 mock_func(rte_edge_t, gr_node_attach_parent(const char *, const char *));
 mock_func(const struct nexthop *, fib4_lookup(uint16_t, ip4_addr_t));
+void fib4_lookup_x2(uint16_t, const ip4_addr_t *, const struct nexthop **nhs) {
+	nhs[0] = mock_ptr_type(const struct nexthop *);
+	nhs[1] = mock_ptr_type(const struct nexthop *);
+}
 mock_func(void *, gr_mbuf_trace_add(struct rte_mbuf *, struct rte_node *, size_t));
 mock_func(uint16_t, drop_packets(struct rte_graph *, struct rte_node *, void **, uint16_t));
 mock_func(int, drop_format(char *, size_t, const void *, size_t));
@@ -241,6 +308,9 @@ mock_func(
 	)
 );
 mock_func(struct conn *, gr_conn_lookup(const struct conn_key *, conn_flow_t *));
+mock_func(struct conn *, snat44_conntrack_create_inbound(const struct conn_key *));
+unsigned snat44_eim_policies;
+mock_func(struct mroute_entry *, mroute4_lookup(uint16_t, ip4_addr_t, ip4_addr_t));
 
 struct fake_mbuf {
 	struct rte_ipv4_hdr ipv4_hdr;
@@ -359,6 +429,47 @@ static void ip_input_conntrack_dnat(void **) {
 	ip_input_process(NULL, NULL, &obj, 1);
 }
 
+static void ip_input_urpf(void **) {
+	struct fake_mbuf fake_mbuf;
+	void *obj = &fake_mbuf.mbuf;
+	struct nexthop dst = {.type = GR_NH_T_L3};
+	struct nexthop src = {.type = GR_NH_T_L3};
+
+	ipv4_init_default_mbuf(&fake_mbuf);
+	fake_mbuf.ipv4_hdr.hdr_checksum = rte_ipv4_cksum(&fake_mbuf.ipv4_hdr);
+	iface.id = 1;
+	iface.flags = GR_IFACE_F_URPF_STRICT;
+	src.iface_id = 2;
+	dst.iface_id = 2;
+
+	// no route to source
+	will_return(fib4_lookup_x2, &dst);
+	will_return(fib4_lookup_x2, NULL);
+	expect_value(rte_node_enqueue_x1, next, URPF_FAIL);
+	ip_input_process(NULL, NULL, &obj, 1);
+
+	// route to source via another interface
+	will_return(fib4_lookup_x2, &dst);
+	will_return(fib4_lookup_x2, &src);
+	expect_value(rte_node_enqueue_x1, next, URPF_FAIL);
+	ip_input_process(NULL, NULL, &obj, 1);
+
+	iface.flags = GR_IFACE_F_URPF_LOOSE;
+	will_return(fib4_lookup_x2, &dst);
+	will_return(fib4_lookup_x2, &src);
+	expect_value(rte_node_enqueue_x1, next, FORWARD);
+	ip_input_process(NULL, NULL, &obj, 1);
+
+	iface.flags = GR_IFACE_F_URPF_STRICT;
+	src.iface_id = 1;
+	will_return(fib4_lookup_x2, &dst);
+	will_return(fib4_lookup_x2, &src);
+	expect_value(rte_node_enqueue_x1, next, FORWARD);
+	ip_input_process(NULL, NULL, &obj, 1);
+
+	iface.flags = 0;
+}
+
 int main(void) {
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(ip_input_invalid_mbuf_len),
@@ -367,6 +478,7 @@ int main(void) {
 		cmocka_unit_test(ip_input_invalid_ihl),
 		cmocka_unit_test(ip_input_invalid_total_length),
 		cmocka_unit_test(ip_input_conntrack_dnat),
+		cmocka_unit_test(ip_input_urpf),
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
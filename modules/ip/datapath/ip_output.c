@@ -24,6 +24,7 @@
 enum {
 	ETH_OUTPUT = 0,
 	HOLD,
+	ACL_OUT,
 	NO_ROUTE,
 	ERROR,
 	FRAGMENT,
@@ -54,10 +55,32 @@ void ip_output_register_nexthop_type(gr_nh_type_t type, const char *next_node) {
 	nh_type_edges[type] = gr_node_attach_parent("ip_output", next_node);
 }
 
+// Resolve a route leaked into another VRF through its loopback interface.
+// Only plain L3 nexthops are handled here. Anything else (local delivery, no
+// route, other nexthop types) goes through loop_xvrf and a full ip_input pass.
+// This is also the case when the loopback interface has uRPF or PBR enabled,
+// since these features are only applied by ip_input.
+static inline const struct nexthop *
+vrf_leak_lookup(const struct iface *loop, const struct rte_ipv4_hdr *ip) {
+	const struct nexthop *nh;
+
+	if (loop->flags & (GR_IFACE_F_URPF | GR_IFACE_F_PBR))
+		return NULL;
+
+	nh = fib4_lookup(loop->vrf_id, ip->dst_addr);
+	if (nh == NULL || nh->type != GR_NH_T_L3)
+		return NULL;
+	if (nexthop_info_l3(nh)->flags & (GR_NH_F_LOCAL | GR_NH_F_MCAST))
+		return NULL;
+
+	return nh;
+}
+
 static uint16_t
 ip_output_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
 	struct eth_output_mbuf_data *eth_data;
 	const struct nexthop_info_l3 *l3;
+	struct iface_stats *stats;
 	const struct iface *iface;
 	const struct nexthop *nh;
 	struct rte_ipv4_hdr *ip;
@@ -83,12 +106,35 @@ ip_output_process(struct rte_graph *graph, struct rte_node *node, void **objs, u
 		if (edge != ETH_OUTPUT)
 			goto next;
 
-		iface = iface_from_id(nh->iface_id);
+		// Multicast nexthops are not bound to any interface.
+		if (nh->type == GR_NH_T_L3 && nexthop_info_l3(nh)->flags & GR_NH_F_MCAST)
+			iface = mbuf_data(mbuf)->iface;
+		else
+			iface = iface_from_id(nh->iface_id);
 		if (iface == NULL) {
 			edge = ERROR;
 			goto next;
 		}
 
+		if (iface->type == GR_IFACE_TYPE_LOOPBACK) {
+			// Leaked route: forward directly with the target VRF nexthop
+			// instead of re-entering ip_input via loop_xvrf.
+			const struct nexthop *leak = vrf_leak_lookup(iface, ip);
+			if (leak != NULL) {
+				// Account the packet as if it went through loop_xvrf.
+				stats = iface_get_stats(rte_lcore_id(), iface->id);
+				stats->rx_packets += 1;
+				stats->rx_bytes += rte_pktmbuf_pkt_len(mbuf);
+				nh = leak;
+				ip_output_mbuf_data(mbuf)->nh = nh;
+				iface = iface_from_id(nh->iface_id);
+				if (iface == NULL) {
+					edge = ERROR;
+					goto next;
+				}
+			}
+		}
+
 		mbuf_data(mbuf)->iface = iface;
 
 		if (rte_pktmbuf_pkt_len(mbuf) > iface->mtu) {
@@ -136,6 +182,8 @@ ip_output_process(struct rte_graph *graph, struct rte_node *node, void **objs, u
 		eth_data = eth_output_mbuf_data(mbuf);
 		eth_data->dst = l3->mac;
 		eth_data->ether_type = RTE_BE16(RTE_ETHER_TYPE_IPV4);
+		if (unlikely(iface->flags & GR_IFACE_F_ACL_OUT))
+			edge = ACL_OUT;
 		sent++;
 next:
 		if (gr_mbuf_is_traced(mbuf)) {
@@ -155,6 +203,7 @@ static struct rte_node_register output_node = {
 	.next_nodes = {
 		[ETH_OUTPUT] = "eth_output",
 		[HOLD] = "ip_hold",
+		[ACL_OUT] = "ip_acl_out",
 		[NO_ROUTE] = "ip_error_dest_unreach",
 		[ERROR] = "ip_output_error",
 		[FRAGMENT] = "ip_fragment",
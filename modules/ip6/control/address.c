@@ -80,40 +80,46 @@ struct nexthop *addr6_get_linklocal(uint16_t iface_id) {
 	return errno_set_null(EADDRNOTAVAIL);
 }
 
-static struct hoplist *iface_mcast_addrs;
+// Multicast group memberships of all interfaces, indexed by (iface, group).
+struct mcast6_key {
+	struct rte_ipv6_addr addr;
+	uint16_t iface_id;
+};
 
-struct nexthop *mcast6_get_member(uint16_t iface_id, const struct rte_ipv6_addr *mcast) {
-	const struct nexthop_info_l3 *l3;
-	struct hoplist *maddrs;
+struct mcast6_member {
 	struct nexthop *nh;
+	unsigned refcnt;
+};
 
-	if (iface_id >= MAX_IFACES)
-		return NULL;
+#define MCAST6_MAX_MEMBERS (MAX_IFACES * 16)
 
-	maddrs = &iface_mcast_addrs[iface_id];
-	gr_vec_foreach (nh, maddrs->nh) {
-		l3 = nexthop_info_l3(nh);
-		if (rte_ipv6_addr_eq(&l3->ipv6, mcast))
-			return nh;
-	}
+static struct rte_hash *mcast_members;
+
+struct nexthop *mcast6_get_member(uint16_t iface_id, const struct rte_ipv6_addr *mcast) {
+	const struct mcast6_key key = {.addr = *mcast, .iface_id = iface_id};
+	struct mcast6_member *m;
+
+	if (rte_hash_lookup_data(mcast_members, &key, (void **)&m) < 0)
+		return NULL;
 
-	return NULL;
+	return m->nh;
 }
 
 static int mcast6_addr_add(const struct iface *iface, const struct rte_ipv6_addr *ip) {
-	struct hoplist *maddrs = &iface_mcast_addrs[iface->id];
-	struct rte_ether_addr mac;
+	const struct mcast6_key key = {.addr = *ip, .iface_id = iface->id};
+	struct mcast6_member *m;
 	struct nexthop *nh;
+	int ret;
+
+	if (rte_hash_lookup_data(mcast_members, &key, (void **)&m) >= 0) {
+		m->refcnt++;
+		return errno_set(EEXIST);
+	}
 
 	LOG(INFO, "%s: joining multicast group " IP6_F, iface->name, ip);
 
-	gr_vec_foreach (nh, maddrs->nh) {
-		const struct nexthop_info_l3 *l3 = nexthop_info_l3(nh);
-		if (rte_ipv6_addr_eq(&l3->ipv6, ip)) {
-			nexthop_incref(nh);
-			return errno_set(EEXIST);
-		}
-	}
+	if ((m = rte_zmalloc(__func__, sizeof(*m), 0)) == NULL)
+		return errno_set(ENOMEM);
 
 	if ((nh = nh6_lookup(iface->vrf_id, GR_IFACE_ID_UNDEF, ip)) == NULL) {
 		struct gr_nexthop_base base = {
@@ -130,66 +136,89 @@ static int mcast6_addr_add(const struct iface *iface, const struct rte_ipv6_addr
 		};
 		rte_ether_mcast_from_ipv6(&l3.mac, ip);
 
-		if ((nh = nexthop_new(&base, &l3)) == NULL)
+		if ((nh = nexthop_new(&base, &l3)) == NULL) {
+			rte_free(m);
 			return errno_set(errno);
-
-		mac = l3.mac;
-	} else {
-		struct nexthop_info_l3 *l3 = nexthop_info_l3(nh);
-		mac = l3->mac;
+		}
 	}
 
 	nexthop_incref(nh);
+	m->nh = nh;
+	m->refcnt = 1;
 
-	// gr_vec_add may realloc() and free the old vector
-	// Duplicate the whole vector and append to the clone.
-	gr_vec struct nexthop **nhs_copy = NULL;
-	gr_vec struct nexthop **nhs_old = maddrs->nh;
-	gr_vec_cap_set(nhs_copy, gr_vec_len(nhs_old) + 1); // avoid malloc+realloc
-	gr_vec_extend(nhs_copy, nhs_old);
-	gr_vec_add(nhs_copy, nh);
-	maddrs->nh = nhs_copy;
-	if (nhs_old != NULL) {
-		// Once all datapath workers have seen the new clone, free the old one.
-		rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
-		gr_vec_free(nhs_old);
+	if ((ret = rte_hash_add_key_data(mcast_members, &key, m)) < 0) {
+		nexthop_decref(nh);
+		rte_free(m);
+		return errno_set(-ret);
 	}
 
 	// add ethernet filter
-	return iface_add_eth_addr(iface->id, &mac);
+	return iface_add_eth_addr(iface->id, &nexthop_info_l3(nh)->mac);
 }
 
 static int mcast6_addr_del(const struct iface *iface, const struct rte_ipv6_addr *ip) {
-	struct hoplist *maddrs = &iface_mcast_addrs[iface->id];
-	const struct nexthop_info_l3 *l3;
-	struct nexthop *nh = NULL;
-	unsigned i = 0;
-	int ret = 0;
+	const struct mcast6_key key = {.addr = *ip, .iface_id = iface->id};
+	struct mcast6_member *m;
+	int32_t pos;
+	int ret;
 
-	gr_vec_foreach (nh, maddrs->nh) {
-		l3 = nexthop_info_l3(nh);
-		if (rte_ipv6_addr_eq(&l3->ipv6, ip))
-			break;
-		nh = NULL;
-		i++;
-	}
-	if (nh == NULL)
+	if (rte_hash_lookup_data(mcast_members, &key, (void **)&m) < 0)
 		return errno_set(ENOENT);
 
-	// shift remaining addresses
-	gr_vec_del(maddrs->nh, i);
+	if (--m->refcnt > 0)
+		return 0;
 
-	if (nh->ref_count == 1) {
-		LOG(INFO, "%s: leaving multicast group " IP6_F, iface->name, ip);
-		// remove ethernet filter
-		l3 = nexthop_info_l3(nh);
-		ret = iface_del_eth_addr(iface->id, &l3->mac);
-	}
-	nexthop_decref(nh);
+	LOG(INFO, "%s: leaving multicast group " IP6_F, iface->name, ip);
+
+	pos = rte_hash_del_key(mcast_members, &key);
+	// Once all datapath workers have stopped using the member, free it.
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+	rte_hash_free_key_with_position(mcast_members, pos);
+
+	// remove ethernet filter
+	ret = iface_del_eth_addr(iface->id, &nexthop_info_l3(m->nh)->mac);
+	nexthop_decref(m->nh);
+	rte_free(m);
 
 	return ret;
 }
 
+// Leave all multicast groups of an interface with a single RCU grace period.
+static void mcast6_iface_flush(const struct iface *iface) {
+	gr_vec struct mcast6_member **members = NULL;
+	gr_vec struct mcast6_key *keys = NULL;
+	gr_vec int32_t *positions = NULL;
+	const struct mcast6_key *key;
+	uint32_t iter = 0;
+	void *data;
+
+	// Do not modify the table while iterating over it.
+	while (rte_hash_iterate(mcast_members, (const void **)&key, &data, &iter) >= 0) {
+		if (key->iface_id == iface->id) {
+			gr_vec_add(keys, *key);
+			gr_vec_add(members, data);
+		}
+	}
+	gr_vec_foreach_ref (key, keys)
+		gr_vec_add(positions, rte_hash_del_key(mcast_members, key));
+
+	if (gr_vec_len(positions) > 0)
+		rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+
+	gr_vec_foreach (int32_t pos, positions)
+		rte_hash_free_key_with_position(mcast_members, pos);
+
+	gr_vec_foreach (struct mcast6_member *m, members) {
+		iface_del_eth_addr(iface->id, &nexthop_info_l3(m->nh)->mac);
+		nexthop_decref(m->nh);
+		rte_free(m);
+	}
+
+	gr_vec_free(positions);
+	gr_vec_free(members);
+	gr_vec_free(keys);
+}
+
 static int
 iface6_addr_add(const struct iface *iface, const struct rte_ipv6_addr *ip, uint8_t prefixlen) {
 	struct rte_ipv6_addr solicited_node;
@@ -411,13 +440,7 @@ static void ip6_iface_event_handler(uint32_t event, const void *obj) {
 			iface6_addr_del(iface, &l3->ipv6, l3->prefixlen);
 		}
 		gr_vec_free(addrs->nh);
-		addrs = &iface_mcast_addrs[iface->id];
-		while (gr_vec_len(addrs->nh) > 0) {
-			nh = addrs->nh[0];
-			l3 = (const struct nexthop_info_l3 *)nh->info;
-			mcast6_addr_del(iface, &l3->ipv6);
-		}
-		gr_vec_free(addrs->nh);
+		mcast6_iface_flush(iface);
 		break;
 	case GR_EVENT_IFACE_STATUS_UP:
 		addrs = &iface_addrs[iface->id];
@@ -435,18 +458,22 @@ static void addr6_init(struct event_base *) {
 	iface_addrs = rte_calloc(__func__, MAX_IFACES, sizeof(*iface_addrs), RTE_CACHE_LINE_SIZE);
 	if (iface_addrs == NULL)
 		ABORT("rte_calloc(iface_addrs)");
-	iface_mcast_addrs = rte_calloc(
-		__func__, MAX_IFACES, sizeof(*iface_mcast_addrs), RTE_CACHE_LINE_SIZE
-	);
-	if (iface_mcast_addrs == NULL)
-		ABORT("rte_calloc(iface_mcast_addrs)");
+	mcast_members = rte_hash_create(&(struct rte_hash_parameters) {
+		.name = "mcast6_members",
+		.entries = MCAST6_MAX_MEMBERS,
+		.key_len = sizeof(struct mcast6_key),
+		.socket_id = SOCKET_ID_ANY,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF,
+	});
+	if (mcast_members == NULL)
+		ABORT("rte_hash_create(mcast6_members): %s", rte_strerror(rte_errno));
 }
 
 static void addr6_fini(struct event_base *) {
 	rte_free(iface_addrs);
 	iface_addrs = NULL;
-	rte_free(iface_mcast_addrs);
-	iface_mcast_addrs = NULL;
+	rte_hash_free(mcast_members);
+	mcast_members = NULL;
 }
 
 static struct gr_api_handler addr6_add_handler = {
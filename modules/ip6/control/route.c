@@ -19,6 +19,7 @@
 #include <rte_ethdev.h>
 #include <rte_malloc.h>
 #include <rte_rib6.h>
+#include <rte_rwlock.h>
 #include <rte_telemetry.h>
 
 #include <errno.h>
@@ -28,6 +29,9 @@
 #include <sys/queue.h>
 
 static struct rte_rib6 **vrf_ribs;
+// RIB modifications are done on the main event loop. This lock serializes them
+// with routes listing from background API threads.
+static rte_rwlock_t rib_lock = RTE_RWLOCK_INITIALIZER;
 static struct rib6_stats stats[GR_MAX_VRFS];
 
 static struct rte_rib6_conf rib6_conf = {
@@ -63,7 +67,9 @@ static struct rte_rib6 *get_or_create_rib6(uint16_t vrf_id) {
 		if (rib == NULL)
 			return errno_set_null(rte_errno);
 
+		rte_rwlock_write_lock(&rib_lock);
 		vrf_ribs[vrf_id] = rib;
+		rte_rwlock_write_unlock(&rib_lock);
 	}
 
 	return rib;
@@ -168,7 +174,9 @@ static int rib6_insert_or_replace(
 	}
 
 	if ((rn = rte_rib6_lookup_exact(rib, scoped_ip, prefixlen)) == NULL) {
+		rte_rwlock_write_lock(&rib_lock);
 		rn = rte_rib6_insert(rib, scoped_ip, prefixlen);
+		rte_rwlock_write_unlock(&rib_lock);
 		if (rn == NULL) {
 			ret = -rte_errno;
 			goto fail;
@@ -183,12 +191,14 @@ static int rib6_insert_or_replace(
 		}
 	}
 
+	rte_rwlock_write_lock(&rib_lock);
 	rte_rib6_set_nh(rn, nh_ptr_to_id(nh));
 	o = rte_rib6_get_ext(rn);
 	gr_nh_origin_t old_origin = origin;
 	if (existing)
 		old_origin = *o;
 	*o = origin;
+	rte_rwlock_write_unlock(&rib_lock);
 	fib6_insert(vrf_id, iface_id, scoped_ip, prefixlen, nh);
 	if (origin != GR_NH_ORIGIN_INTERNAL) {
 		gr_event_push(
@@ -258,7 +268,9 @@ int rib6_delete(
 	if (nh->type != nh_type)
 		return errno_set(EINVAL);
 
+	rte_rwlock_write_lock(&rib_lock);
 	rte_rib6_remove(rib, scoped_ip, prefixlen);
+	rte_rwlock_write_unlock(&rib_lock);
 	fib6_remove(vrf_id, iface_id, scoped_ip, prefixlen);
 
 	if (origin != GR_NH_ORIGIN_INTERNAL) {
@@ -451,11 +463,84 @@ static void route6_list_cb(
 	}
 }
 
+struct route6_entry {
+	struct rte_ipv6_addr ip;
+	uint8_t prefixlen;
+	gr_nh_origin_t origin;
+	const struct nexthop *nh;
+};
+
+static void route6_entry_add(gr_vec struct route6_entry **entries, struct rte_rib6_node *rn) {
+	struct route6_entry e;
+	uintptr_t nh_id;
+
+	e.origin = *(gr_nh_origin_t *)rte_rib6_get_ext(rn);
+	if (e.origin == GR_NH_ORIGIN_INTERNAL)
+		return;
+	rte_rib6_get_ip(rn, &e.ip);
+	rte_rib6_get_depth(rn, &e.prefixlen);
+	rte_rib6_get_nh(rn, &nh_id);
+	e.nh = nh_id_to_ptr(nh_id);
+	gr_vec_add(*entries, e);
+}
+
+// Copy the routes of one chunk of a VRF RIB. Chunk 0 holds all prefixes up to
+// /8. Chunk N holds the more specific prefixes of the (N - 1) first byte.
+static void
+rib6_chunk_copy(struct rte_rib6 *rib, unsigned chunk, gr_vec struct route6_entry **entries) {
+	struct rte_ipv6_addr ip = RTE_IPV6_ADDR_UNSPEC;
+	struct rte_rib6_node *rn;
+	uint8_t depth;
+
+	if (chunk == 0) {
+		for (depth = 0; depth <= 8; depth++) {
+			for (unsigned i = 0; i < (1U << depth); i++) {
+				ip.a[0] = depth ? i << (8 - depth) : 0;
+				if ((rn = rte_rib6_lookup_exact(rib, &ip, depth)) != NULL)
+					route6_entry_add(entries, rn);
+			}
+		}
+		return;
+	}
+
+	ip.a[0] = chunk - 1;
+	rn = NULL;
+	while ((rn = rte_rib6_get_nxt(rib, &ip, 8, rn, RTE_RIB6_GET_NXT_ALL)) != NULL) {
+		rte_rib6_get_depth(rn, &depth);
+		if (depth > 8)
+			route6_entry_add(entries, rn);
+	}
+}
+
+// Runs on a background API thread. The RIB is read in chunks so that route
+// updates on the main event loop only wait for one chunk to be copied.
+// Nexthops are protected by RCU until api_quiescent() is called.
 static struct api_out route6_list(const void *request, struct api_ctx *ctx) {
 	const struct gr_ip6_route_list_req *req = request;
 	struct route6_iterator iter = {.ctx = ctx, .ret = 0};
+	gr_vec struct route6_entry *entries = NULL;
+	const struct route6_entry *e;
+	struct rte_rib6 *rib;
+
+	for (uint16_t v = 0; v < GR_MAX_VRFS && iter.ret == 0; v++) {
+		if (v != req->vrf_id && req->vrf_id != GR_VRF_ID_ALL)
+			continue;
 
-	rib6_iter(req->vrf_id, route6_list_cb, &iter);
+		for (unsigned chunk = 0; chunk <= 256 && iter.ret == 0; chunk++) {
+			rte_rwlock_read_lock(&rib_lock);
+			rib = vrf_ribs[v];
+			if (rib != NULL)
+				rib6_chunk_copy(rib, chunk, &entries);
+			rte_rwlock_read_unlock(&rib_lock);
+			if (rib == NULL)
+				break;
+
+			gr_vec_foreach_ref (e, entries)
+				route6_list_cb(v, &e->ip, e->prefixlen, e->origin, e->nh, &iter);
+			gr_vec_free(entries);
+			api_quiescent();
+		}
+	}
 
 	return api_out(iter.ret, 0, NULL);
 }
@@ -594,6 +679,7 @@ static struct gr_api_handler route6_list_handler = {
 	.name = "ipv6 route list",
 	.request_type = GR_IP6_ROUTE_LIST,
 	.callback = route6_list,
+	.background = true,
 };
 
 static struct gr_event_serializer route6_serializer = {
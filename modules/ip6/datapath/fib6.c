@@ -99,6 +99,28 @@ fib6_lookup(uint16_t vrf_id, uint16_t iface_id, const struct rte_ipv6_addr *ip)
 	return nh_id_to_ptr(nh_id);
 }
 
+void fib6_lookup_x2(
+	uint16_t vrf_id,
+	uint16_t iface_id,
+	const struct rte_ipv6_addr *ips[2],
+	const struct nexthop *nhs[2]
+) {
+	struct rte_fib6 *fib6 = get_fib6(vrf_id);
+	struct rte_ipv6_addr scoped_ips[2], tmp;
+	uintptr_t nh_ids[2];
+
+	if (fib6 == NULL) {
+		nhs[0] = nhs[1] = NULL;
+		return;
+	}
+
+	for (unsigned i = 0; i < 2; i++)
+		scoped_ips[i] = *addr6_linklocal_scope(ips[i], &tmp, iface_id);
+	rte_fib6_lookup_bulk(fib6, scoped_ips, nh_ids, 2);
+	nhs[0] = nh_id_to_ptr(nh_ids[0]);
+	nhs[1] = nh_id_to_ptr(nh_ids[1]);
+}
+
 int fib6_insert(
 	uint16_t vrf_id,
 	uint16_t iface_id,
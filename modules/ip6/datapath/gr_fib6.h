@@ -14,6 +14,15 @@
 // Only for datapath use
 const struct nexthop *
 fib6_lookup(uint16_t vrf_id, uint16_t iface_id, const struct rte_ipv6_addr *ip);
+// Lookup two addresses in a single bulk operation. Used to resolve the source
+// along with the destination address for unicast reverse path forwarding checks.
+// Missing routes are reported as NULL next hops.
+void fib6_lookup_x2(
+	uint16_t vrf_id,
+	uint16_t iface_id,
+	const struct rte_ipv6_addr *ips[2],
+	const struct nexthop *nhs[2]
+);
 
 // Only for control plane use to update the fib
 int fib6_insert(
@@ -50,7 +50,7 @@ static uint16_t icmp6_output_process(
 		ip6_set_fields(ip, d->len, IPPROTO_ICMPV6, &d->src, &d->dst);
 		// Compute ICMP6 checksum with pseudo header
 		icmp6->cksum = 0;
-		icmp6->cksum = rte_ipv6_udptcp_cksum(ip, icmp6);
+		icmp6->cksum = rte_ipv6_udptcp_cksum_mbuf(mbuf, ip, sizeof(*ip));
 
 		if (gr_mbuf_is_traced(mbuf)) {
 			uint8_t trace_len = RTE_MIN(d->len, GR_TRACE_ITEM_MAX_LEN);
@@ -53,8 +53,7 @@ ip6_error_process(struct rte_graph *graph, struct rte_node *node, void **objs, u
 		// ICMPv6 error messages should contain "As much of invoking
 		// packet as possible without the ICMPv6 packet exceeding the
 		// minimum IPv6 MTU (1280)"
-		if (rte_pktmbuf_pkt_len(mbuf) > RTE_IPV6_MIN_MTU)
-			rte_pktmbuf_trim(mbuf, rte_pktmbuf_pkt_len(mbuf) - RTE_IPV6_MIN_MTU);
+		gr_mbuf_truncate(mbuf, RTE_IPV6_MIN_MTU);
 
 		switch (ctx->icmp_type) {
 		case ICMP6_ERR_DEST_UNREACH:
@@ -7,6 +7,7 @@
 #include <gr_ip6_datapath.h>
 #include <gr_log.h>
 #include <gr_loopback.h>
+#include <gr_mroute_datapath.h>
 #include <gr_trace.h>
 
 #include <rte_byteorder.h>
@@ -19,9 +20,12 @@
 
 enum edges {
 	FORWARD = 0,
+	MCAST_FORWARD,
+	PBR,
 	OUTPUT,
 	LOCAL,
 	DEST_UNREACH,
+	URPF_FAIL,
 	NOT_MEMBER,
 	OTHER_HOST,
 	BAD_VERSION,
@@ -43,11 +47,14 @@ void ip6_input_register_nexthop_type(gr_nh_type_t type, const char *next_node) {
 
 static uint16_t
 ip6_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	const struct rte_ipv6_addr *addrs[2];
 	const struct nexthop_info_l3 *l3;
 	struct ip6_output_mbuf_data *d;
 	struct eth_input_mbuf_data *e;
+	const struct nexthop *nhs[2];
 	const struct iface *iface;
 	const struct nexthop *nh;
+	struct mroute_entry *mr;
 	struct rte_ipv6_hdr *ip;
 	struct rte_mbuf *mbuf;
 	rte_edge_t edge;
@@ -92,12 +99,20 @@ ip6_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, u
 				// interface. For now, we do not have support for these.
 				edge = BAD_ADDR;
 				break;
+			case RTE_IPV6_MC_SCOPE_LINKLOCAL:
+				// Link-local groups are never forwarded.
+				nh = mcast6_get_member(iface->id, &ip->dst_addr);
+				edge = nh ? LOCAL : NOT_MEMBER;
+				break;
 			default:
+				mr = mroute6_lookup(iface->vrf_id, &ip->src_addr, &ip->dst_addr);
+				if (mr != NULL) {
+					mroute_mbuf_data(mbuf)->mr = mr;
+					edge = MCAST_FORWARD;
+					goto next_mcast;
+				}
 				nh = mcast6_get_member(iface->id, &ip->dst_addr);
-				if (nh == NULL)
-					edge = NOT_MEMBER;
-				else
-					edge = LOCAL;
+				edge = nh ? LOCAL : NOT_MEMBER;
 			}
 			goto next;
 		}
@@ -119,9 +134,27 @@ ip6_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, u
 			goto next;
 		}
 
-		nh = fib6_lookup(iface->vrf_id, iface->id, &ip->dst_addr);
+		if (unlikely(iface->flags & GR_IFACE_F_URPF)) {
+			// Resolve the source along with the destination address.
+			addrs[0] = &ip->dst_addr;
+			addrs[1] = &ip->src_addr;
+			fib6_lookup_x2(iface->vrf_id, iface->id, addrs, nhs);
+			if (!nexthop_urpf_check(
+				    nhs[1], iface->id, iface->flags & GR_IFACE_F_URPF_STRICT
+			    )) {
+				edge = URPF_FAIL;
+				goto next;
+			}
+			nh = nhs[0];
+		} else {
+			nh = fib6_lookup(iface->vrf_id, iface->id, &ip->dst_addr);
+		}
 		if (nh == NULL) {
-			edge = DEST_UNREACH;
+			// Policy based routing may select a route.
+			if (unlikely(iface->flags & GR_IFACE_F_PBR))
+				edge = PBR;
+			else
+				edge = DEST_UNREACH;
 			goto next;
 		}
 
@@ -138,14 +171,18 @@ ip6_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, u
 			if (l3->flags & GR_NH_F_LOCAL && rte_ipv6_addr_eq(&ip->dst_addr, &l3->ipv6))
 				edge = LOCAL;
 		}
+		// Policy based routing never applies to local packets.
+		if (unlikely(iface->flags & GR_IFACE_F_PBR) && edge == FORWARD)
+			edge = PBR;
 next:
+		// Store the resolved next hop for ip6_output to avoid a second route lookup.
+		d = ip6_output_mbuf_data(mbuf);
+		d->nh = nh;
+next_mcast:
 		if (gr_mbuf_is_traced(mbuf)) {
 			struct rte_ipv6_hdr *t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
 			*t = *ip;
 		}
-		// Store the resolved next hop for ip6_output to avoid a second route lookup.
-		d = ip6_output_mbuf_data(mbuf);
-		d->nh = nh;
 		rte_node_enqueue_x1(graph, node, edge, mbuf);
 	}
 
@@ -166,9 +203,12 @@ static struct rte_node_register input_node = {
 	.nb_edges = EDGE_COUNT,
 	.next_nodes = {
 		[FORWARD] = "ip6_forward",
+		[MCAST_FORWARD] = "ip6_mcast_forward",
+		[PBR] = "ip6_pbr",
 		[OUTPUT] = "ip6_output",
 		[LOCAL] = "ip6_input_local",
 		[DEST_UNREACH] = "ip6_error_dest_unreach",
+		[URPF_FAIL] = "ip6_input_urpf_fail",
 		[NOT_MEMBER] = "ip6_input_not_member",
 		[OTHER_HOST] = "ip6_input_other_host",
 		[BAD_VERSION] = "ip6_input_bad_version",
@@ -186,6 +226,7 @@ static struct gr_node_info info = {
 GR_NODE_REGISTER(info);
 
 GR_DROP_REGISTER(ip6_input_not_member);
+GR_DROP_REGISTER(ip6_input_urpf_fail);
 GR_DROP_REGISTER(ip6_input_other_host);
 GR_DROP_REGISTER(ip6_input_bad_version);
 GR_DROP_REGISTER(ip6_input_bad_addr);
@@ -200,12 +241,25 @@ struct node_infos node_infos = STAILQ_HEAD_INITIALIZER(node_infos);
 
 mock_func(rte_edge_t, gr_node_attach_parent(const char *, const char *));
 mock_func(const struct nexthop *, fib6_lookup(uint16_t, uint16_t, const struct rte_ipv6_addr *));
+void fib6_lookup_x2(
+	uint16_t,
+	uint16_t,
+	const struct rte_ipv6_addr **,
+	const struct nexthop **nhs
+) {
+	nhs[0] = mock_ptr_type(const struct nexthop *);
+	nhs[1] = mock_ptr_type(const struct nexthop *);
+}
 mock_func(void *, gr_mbuf_trace_add(struct rte_mbuf *, struct rte_node *, size_t));
 mock_func(uint16_t, drop_packets(struct rte_graph *, struct rte_node *, void **, uint16_t));
 mock_func(int, drop_format(char *, size_t, const void *, size_t));
 mock_func(int, trace_ip6_format(char *, size_t, const struct rte_ipv6_hdr *, size_t));
 mock_func(void, gr_eth_input_add_type(rte_be16_t, const char *));
 mock_func(struct nexthop *, mcast6_get_member(uint16_t, const struct rte_ipv6_addr *));
+mock_func(
+	struct mroute_entry *,
+	mroute6_lookup(uint16_t, const struct rte_ipv6_addr *, const struct rte_ipv6_addr *)
+);
 
 struct fake_mbuf {
 	struct rte_ipv6_hdr ipv6_hdr;
@@ -103,9 +103,7 @@ static uint16_t ip6_input_local_process(
 		switch (m->ol_flags & RTE_MBUF_F_RX_L4_CKSUM_MASK) {
 		case RTE_MBUF_F_RX_L4_CKSUM_NONE:
 		case RTE_MBUF_F_RX_L4_CKSUM_UNKNOWN:
-			if (rte_ipv6_udptcp_cksum_verify(
-				    ip, rte_pktmbuf_mtod_offset(m, void *, d->ext_offset)
-			    )) {
+			if (rte_ipv6_udptcp_cksum_mbuf_verify(m, ip, d->ext_offset)) {
 				edge = BAD_CHECKSUM;
 				goto next;
 			}
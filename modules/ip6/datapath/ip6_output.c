@@ -2,6 +2,7 @@
 // Copyright (c) 2024 Robin Jarry
 
 #include <gr_eth.h>
+#include <gr_fib6.h>
 #include <gr_graph.h>
 #include <gr_iface.h>
 #include <gr_ip6.h>
@@ -19,6 +20,7 @@
 enum {
 	ETH_OUTPUT = 0,
 	HOLD,
+	ACL_OUT,
 	DEST_UNREACH,
 	ERROR,
 	TOO_BIG,
@@ -47,10 +49,32 @@ void ip6_output_register_nexthop_type(gr_nh_type_t type, const char *next_node)
 	nh_type_edges[type] = gr_node_attach_parent("ip6_output", next_node);
 }
 
+// Resolve a route leaked into another VRF through its loopback interface.
+// Only plain L3 nexthops are handled here. Anything else (local delivery, no
+// route, other nexthop types) goes through loop_xvrf and a full ip6_input pass.
+// This is also the case when the loopback interface has uRPF or PBR enabled,
+// since these features are only applied by ip6_input.
+static inline const struct nexthop *
+vrf_leak_lookup(const struct iface *loop, const struct rte_ipv6_hdr *ip) {
+	const struct nexthop *nh;
+
+	if (loop->flags & (GR_IFACE_F_URPF | GR_IFACE_F_PBR))
+		return NULL;
+
+	nh = fib6_lookup(loop->vrf_id, loop->id, &ip->dst_addr);
+	if (nh == NULL || nh->type != GR_NH_T_L3)
+		return NULL;
+	if (nexthop_info_l3(nh)->flags & (GR_NH_F_LOCAL | GR_NH_F_MCAST))
+		return NULL;
+
+	return nh;
+}
+
 static uint16_t
 ip6_output_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
 	struct eth_output_mbuf_data *eth_data;
 	const struct nexthop_info_l3 *l3;
+	struct iface_stats *stats;
 	const struct iface *iface;
 	const struct nexthop *nh;
 	struct rte_ipv6_hdr *ip;
@@ -86,6 +110,26 @@ ip6_output_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 			goto next;
 		}
 
+		if (iface->type == GR_IFACE_TYPE_LOOPBACK
+		    && !rte_ipv6_addr_is_mcast(&ip->dst_addr)) {
+			// Leaked route: forward directly with the target VRF nexthop
+			// instead of re-entering ip6_input via loop_xvrf.
+			const struct nexthop *leak = vrf_leak_lookup(iface, ip);
+			if (leak != NULL) {
+				// Account the packet as if it went through loop_xvrf.
+				stats = iface_get_stats(rte_lcore_id(), iface->id);
+				stats->rx_packets += 1;
+				stats->rx_bytes += rte_pktmbuf_pkt_len(mbuf);
+				nh = leak;
+				ip6_output_mbuf_data(mbuf)->nh = nh;
+				iface = iface_from_id(nh->iface_id);
+				if (iface == NULL) {
+					edge = ERROR;
+					goto next;
+				}
+			}
+		}
+
 		if (rte_pktmbuf_pkt_len(mbuf) > iface->mtu) {
 			edge = TOO_BIG;
 			goto next;
@@ -115,6 +159,8 @@ ip6_output_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 		else
 			eth_data->dst = l3->mac;
 		eth_data->ether_type = RTE_BE16(RTE_ETHER_TYPE_IPV6);
+		if (unlikely(iface->flags & GR_IFACE_F_ACL_OUT))
+			edge = ACL_OUT;
 		sent++;
 next:
 		if (gr_mbuf_is_traced(mbuf)) {
@@ -134,6 +180,7 @@ static struct rte_node_register output_node = {
 	.next_nodes = {
 		[ETH_OUTPUT] = "eth_output",
 		[HOLD] = "ip6_hold",
+		[ACL_OUT] = "ip6_acl_out",
 		[ERROR] = "ip6_output_error",
 		[DEST_UNREACH] = "ip6_error_dest_unreach",
 		[TOO_BIG] = "ip6_output_too_big",
@@ -70,7 +70,7 @@ static uint16_t ndp_na_output_process(
 		free(ctx);
 		l3 = nexthop_info_l3(local);
 
-		rte_pktmbuf_trim(mbuf, rte_pktmbuf_pkt_len(mbuf));
+		gr_mbuf_truncate(mbuf, 0);
 
 		// Fill ICMP6 layer.
 		payload_len = sizeof(*icmp6) + sizeof(*na) + sizeof(*opt) + sizeof(*ll);
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_api.h>
+#include <gr_macro.h>
+#include <gr_net_types.h>
+#include <gr_nexthop.h>
+
+#include <stdint.h>
+
+#define GR_MPLS_MODULE 0x8847
+
+// Labels 0 to 15 are reserved (RFC 3032, RFC 7274).
+#define GR_MPLS_LABEL_IPV4_EXPLICIT_NULL 0
+#define GR_MPLS_LABEL_IPV6_EXPLICIT_NULL 2
+#define GR_MPLS_LABEL_IMPLICIT_NULL 3
+#define GR_MPLS_LABEL_RESERVED_MAX 15
+#define GR_MPLS_LABEL_MAX 0xfffff
+
+#define GR_MPLS_LABEL_STACK_MAX 8
+
+// Info for GR_NH_T_MPLS nexthops.
+//
+// The labels are pushed on top of the packet (outermost first) and it is sent
+// to the gateway address. Implicit null labels are ignored. If the resulting
+// stack is empty, the packet is forwarded without labels (penultimate hop pop).
+struct gr_nexthop_info_mpls {
+	addr_family_t af; //!< gateway address family
+	uint8_t n_labels;
+	union {
+		struct {
+		} addr;
+		ip4_addr_t ipv4;
+		struct rte_ipv6_addr ipv6;
+	};
+	uint32_t labels[GR_MPLS_LABEL_STACK_MAX];
+};
+
+// incoming label map (ILM) ////////////////////////////////////////////////////
+
+struct gr_mpls_route {
+	uint32_t in_label;
+	gr_nh_origin_t origin;
+	//! VRF in which the payload is looked up after disposition.
+	//! Only used when the route has no nexthop.
+	uint16_t vrf_id;
+	//! ID of an existing MPLS nexthop. If unset and nh.af is not GR_AF_UNSPEC,
+	//! an internal nexthop is created from iface_id and nh. Otherwise, the label
+	//! is popped and the payload is processed locally.
+	uint32_t nh_id;
+	uint16_t iface_id;
+	struct gr_nexthop_info_mpls nh;
+};
+
+#define GR_MPLS_ROUTE_ADD REQUEST_TYPE(GR_MPLS_MODULE, 0x0001)
+
+struct gr_mpls_route_add_req {
+	struct gr_mpls_route route;
+	uint8_t exist_ok;
+};
+
+// struct gr_mpls_route_add_resp { };
+
+#define GR_MPLS_ROUTE_DEL REQUEST_TYPE(GR_MPLS_MODULE, 0x0002)
+
+struct gr_mpls_route_del_req {
+	uint32_t in_label;
+	uint8_t missing_ok;
+};
+
+// struct gr_mpls_route_del_resp { };
+
+#define GR_MPLS_ROUTE_LIST REQUEST_TYPE(GR_MPLS_MODULE, 0x0003)
+
+// struct gr_mpls_route_list_req { };
+
+// STREAM(struct gr_mpls_route);
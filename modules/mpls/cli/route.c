@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_cli.h>
+#include <gr_cli_iface.h>
+#include <gr_cli_nexthop.h>
+#include <gr_mpls.h>
+#include <gr_net_types.h>
+#include <gr_table.h>
+
+#include <ecoli.h>
+#include <libsmartcols.h>
+
+#include <errno.h>
+
+static cmd_status_t mpls_nh_add(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_nexthop_info_mpls *mpls;
+	struct gr_nh_add_req *req = NULL;
+	cmd_status_t ret = CMD_ERROR;
+	const struct ec_pnode *n;
+	struct gr_iface *iface;
+	size_t len;
+
+	// get LABEL sequence node. it is the parent of the first LABEL node.
+	n = ec_pnode_find(p, "LABEL");
+	if (n == NULL || (n = ec_pnode_get_parent(n)) == NULL || ec_pnode_len(n) < 1) {
+		errno = EINVAL;
+		goto out;
+	}
+	if (ec_pnode_len(n) > GR_MPLS_LABEL_STACK_MAX) {
+		errno = E2BIG;
+		goto out;
+	}
+	len = sizeof(*req) + sizeof(*mpls);
+	if ((req = calloc(1, len)) == NULL)
+		goto out;
+
+	req->exist_ok = true;
+	req->nh.type = GR_NH_T_MPLS;
+	req->nh.origin = GR_NH_ORIGIN_USER;
+	req->nh.iface_id = GR_IFACE_ID_UNDEF;
+
+	if (arg_u32(p, "ID", &req->nh.nh_id) < 0 && errno != ENOENT)
+		goto out;
+	if (arg_u16(p, "VRF", &req->nh.vrf_id) < 0 && errno != ENOENT)
+		goto out;
+	if (arg_str(p, "IFACE") != NULL) {
+		if ((iface = iface_from_name(c, arg_str(p, "IFACE"))) == NULL)
+			goto out;
+		req->nh.iface_id = iface->id;
+		free(iface);
+	}
+
+	mpls = (struct gr_nexthop_info_mpls *)req->nh.info;
+
+	if (arg_ip4(p, "GW", &mpls->ipv4) == 0) {
+		mpls->af = GR_AF_IP4;
+	} else if (arg_ip6(p, "GW", &mpls->ipv6) == 0) {
+		mpls->af = GR_AF_IP6;
+	} else {
+		errno = EINVAL;
+		goto out;
+	}
+
+	// parse LABEL list.
+	for (n = ec_pnode_get_first_child(n); n != NULL; n = ec_pnode_next(n)) {
+		const char *str = ec_strvec_val(ec_pnode_get_strvec(n), 0);
+		unsigned long label;
+		char *end;
+
+		errno = 0;
+		label = strtoul(str, &end, 10);
+		if (errno != 0 || *end != '\0' || label > GR_MPLS_LABEL_MAX) {
+			errno = ERANGE;
+			goto out;
+		}
+		mpls->labels[mpls->n_labels++] = label;
+	}
+
+	if (gr_api_client_send_recv(c, GR_NH_ADD, len, req, NULL) < 0)
+		goto out;
+
+	ret = CMD_SUCCESS;
+
+out:
+	free(req);
+	return ret;
+}
+
+static ssize_t format_nexthop_info_mpls(char *buf, size_t len, const void *info) {
+	const struct gr_nexthop_info_mpls *mpls = info;
+	ssize_t n = 0;
+
+	SAFE_BUF(snprintf, len, "labels=");
+	for (uint8_t i = 0; i < mpls->n_labels; i++)
+		SAFE_BUF(snprintf, len, "%s%u", i > 0 ? "/" : "", mpls->labels[i]);
+	if (mpls->n_labels == 0)
+		SAFE_BUF(snprintf, len, "none");
+
+	if (mpls->af != GR_AF_UNSPEC)
+		SAFE_BUF(snprintf, len, " gw=" ADDR_F, ADDR_W(mpls->af), &mpls->addr);
+
+	return n;
+err:
+	return -1;
+}
+
+static struct cli_nexthop_formatter mpls_formatter = {
+	.name = "mpls",
+	.type = GR_NH_T_MPLS,
+	.format = format_nexthop_info_mpls,
+};
+
+static cmd_status_t mpls_route_add(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_mpls_route_add_req req = {
+		.route.origin = GR_NH_ORIGIN_USER,
+		.route.iface_id = GR_IFACE_ID_UNDEF,
+		.exist_ok = true,
+	};
+
+	if (arg_u32(p, "LABEL", &req.route.in_label) < 0)
+		return CMD_ERROR;
+	if (arg_u32(p, "ID", &req.route.nh_id) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+	if (arg_u16(p, "VRF", &req.route.vrf_id) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_MPLS_ROUTE_ADD, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t mpls_route_del(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_mpls_route_del_req req = {.missing_ok = true};
+
+	if (arg_u32(p, "LABEL", &req.in_label) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_MPLS_ROUTE_DEL, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t mpls_route_list(struct gr_api_client *c, const struct ec_pnode *) {
+	const struct gr_mpls_route *r;
+	char buf[128];
+	int ret;
+
+	struct libscols_table *table = scols_new_table();
+	scols_table_new_column(table, "LABEL", 0, 0);
+	scols_table_new_column(table, "ACTION", 0, 0);
+	scols_table_new_column(table, "ORIGIN", 0, 0);
+	scols_table_new_column(table, "NEXT_HOP", 0, 0);
+	scols_table_set_column_separator(table, "  ");
+
+	gr_api_client_stream_foreach (r, ret, c, GR_MPLS_ROUTE_LIST, 0, NULL) {
+		struct libscols_line *line = scols_table_new_line(table, NULL);
+		scols_line_sprintf(line, 0, "%u", r->in_label);
+		scols_line_sprintf(line, 2, "%s", gr_nh_origin_name(r->origin));
+		if (r->nh.af == GR_AF_UNSPEC) {
+			scols_line_sprintf(line, 1, "pop");
+			scols_line_sprintf(line, 3, "vrf=%u", r->vrf_id);
+			continue;
+		}
+		scols_line_sprintf(line, 1, "swap");
+		if (format_nexthop_info_mpls(buf, sizeof(buf), &r->nh) < 0)
+			continue;
+		if (r->nh_id != GR_NH_ID_UNSET)
+			scols_line_sprintf(line, 3, "id=%u %s", r->nh_id, buf);
+		else
+			scols_line_set_data(line, 3, buf);
+	}
+
+	scols_print_table(table);
+	scols_unref_table(table);
+
+	return ret < 0 ? CMD_ERROR : CMD_SUCCESS;
+}
+
+#define MPLS_ARG CTX_ARG("mpls", "Multi Protocol Label Switching.")
+#define MPLS_ROUTE_CTX(root) CLI_CONTEXT(root, MPLS_ARG, CTX_ARG("route", "Incoming label map."))
+
+static int ctx_init(struct ec_node *root) {
+	int ret;
+
+	ret = CLI_COMMAND(
+		NEXTHOP_ADD_CTX(root),
+		"mpls labels LABEL+ via GW [(iface IFACE),(vrf VRF),(id ID)]",
+		mpls_nh_add,
+		"Add MPLS label imposition nexthop.",
+		with_help("Label to push, outermost first.", ec_node_re("LABEL", "^[0-9]+$")),
+		with_help("Directly connected gateway address.", ec_node_re("GW", IP_ANY_RE)),
+		with_help(
+			"Output interface.",
+			ec_node_dyn("IFACE", complete_iface_names, INT2PTR(GR_IFACE_TYPE_UNDEF))
+		),
+		with_help("Nexthop ID.", ec_node_uint("ID", 1, UINT32_MAX - 1, 10)),
+		with_help("L3 routing domain ID.", ec_node_uint("VRF", 0, UINT16_MAX - 1, 10))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		MPLS_ROUTE_CTX(root),
+		"add LABEL (swap id ID)|(pop [vrf VRF])",
+		mpls_route_add,
+		"Add an incoming label route.",
+		with_help(
+			"Incoming label.",
+			ec_node_uint("LABEL", GR_MPLS_LABEL_RESERVED_MAX + 1, GR_MPLS_LABEL_MAX, 10)
+		),
+		with_help(
+			"Swap the label and forward to an MPLS nexthop.",
+			ec_node_str("swap", "swap")
+		),
+		with_help("MPLS nexthop ID.", ec_node_uint("ID", 1, UINT32_MAX - 1, 10)),
+		with_help("Pop the label and process the payload.", ec_node_str("pop", "pop")),
+		with_help(
+			"L3 routing domain ID used after the last label is popped.",
+			ec_node_uint("VRF", 0, UINT16_MAX - 1, 10)
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		MPLS_ROUTE_CTX(root),
+		"del LABEL",
+		mpls_route_del,
+		"Delete an incoming label route.",
+		with_help("Incoming label.", ec_node_uint("LABEL", 0, GR_MPLS_LABEL_MAX, 10))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		MPLS_ROUTE_CTX(root), "[show]", mpls_route_list, "Show incoming label routes."
+	);
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+static struct cli_context ctx = {
+	.name = "mpls_route",
+	.init = ctx_init,
+};
+
+static void __attribute__((constructor, used)) init(void) {
+	cli_context_register(&ctx);
+	cli_nexthop_formatter_register(&mpls_formatter);
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_mpls.h>
+#include <gr_nh_control.h>
+
+#include <rte_byteorder.h>
+#include <rte_mbuf.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MPLS_LSE_LABEL_SHIFT 12
+#define MPLS_LSE_TC_SHIFT 9
+#define MPLS_LSE_TC_MASK 0x7
+#define MPLS_LSE_BOS UINT32_C(0x100)
+#define MPLS_LSE_TTL_MASK 0xff
+
+GR_NH_TYPE_INFO(GR_NH_T_MPLS, nexthop_info_mpls, {
+	BASE(gr_nexthop_info_mpls);
+
+	// L3 nexthop of the gateway which holds the resolved ethernet address.
+	struct nexthop *gw;
+
+	// Pre-encoded label stack entries in network order (outermost first)
+	// without implicit null labels. TC, TTL and BoS are set per packet.
+	uint8_t n_lse;
+	rte_be32_t lse[GR_MPLS_LABEL_STACK_MAX];
+});
+
+// Incoming label map entry.
+struct ilm_entry {
+	const struct nexthop *nh; // NULL: pop and lookup the payload
+	uint16_t vrf_id;
+	gr_nh_origin_t origin;
+	bool active;
+};
+
+// Direct-indexed table of GR_MPLS_LABEL_MAX + 1 entries.
+// Allocated when the first route is added, NULL until then.
+extern struct ilm_entry *mpls_ilm;
+
+static inline const struct ilm_entry *mpls_ilm_lookup(uint32_t label) {
+	const struct ilm_entry *e;
+
+	if (unlikely(mpls_ilm == NULL))
+		return NULL;
+
+	e = &mpls_ilm[label];
+	if (!e->active)
+		return NULL;
+
+	return e;
+}
+
+// Called from control plane when an MPLS packet was sent to an unresolved gateway.
+void mpls_gw_unreachable_cb(struct rte_mbuf *);
@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_control_output.h>
+#include <gr_event.h>
+#include <gr_iface.h>
+#include <gr_ip4_control.h>
+#include <gr_ip4_datapath.h>
+#include <gr_ip6_control.h>
+#include <gr_ip6_datapath.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_mpls.h>
+#include <gr_mpls_control.h>
+#include <gr_rcu.h>
+
+#include <rte_mbuf.h>
+
+#include <string.h>
+
+void mpls_gw_unreachable_cb(struct rte_mbuf *m) {
+	struct nexthop_info_l3 *l3;
+	struct nexthop *gw;
+
+	memcpy(&gw, control_output_mbuf_data(m)->cb_data, sizeof(struct nexthop *));
+	l3 = nexthop_info_l3(gw);
+
+	// Labelled packets cannot be held in the L3 nexthop queue since they
+	// would be re-injected in ip_output once resolved. Only trigger address
+	// resolution and drop the packet.
+	if (l3->state != GR_NH_S_PENDING && l3->state != GR_NH_S_REACHABLE) {
+		switch (l3->af) {
+		case GR_AF_IP4:
+			arp_output_request_solicit(gw);
+			break;
+		case GR_AF_IP6:
+			nh6_solicit(gw);
+			break;
+		default:
+			goto free;
+		}
+		l3->state = GR_NH_S_PENDING;
+	}
+free:
+	rte_pktmbuf_free(m);
+}
+
+static struct nexthop *
+mpls_gw_get(addr_family_t af, uint16_t vrf_id, uint16_t iface_id, const void *addr) {
+	struct nexthop *gw, *r;
+
+	gw = nexthop_lookup(af, vrf_id, iface_id, addr);
+	if (gw != NULL) {
+		if (gw->type != GR_NH_T_L3)
+			return errno_set_null(EMEDIUMTYPE);
+		if (nexthop_info_l3(gw)->flags & GR_NH_F_LOCAL)
+			return errno_set_null(EADDRNOTAVAIL);
+		return gw;
+	}
+
+	if (iface_id == GR_IFACE_ID_UNDEF) {
+		// The gateway must be directly connected.
+		if (af == GR_AF_IP4)
+			r = rib4_lookup(vrf_id, *(const ip4_addr_t *)addr);
+		else
+			r = rib6_lookup(vrf_id, GR_IFACE_ID_UNDEF, addr);
+		if (r == NULL)
+			return NULL;
+		if (r->type != GR_NH_T_L3 || !(nexthop_info_l3(r)->flags & GR_NH_F_LINK))
+			return errno_set_null(ENETUNREACH);
+		iface_id = r->iface_id;
+	}
+
+	struct gr_nexthop_info_l3 l3 = {.af = af};
+	if (af == GR_AF_IP4)
+		l3.ipv4 = *(const ip4_addr_t *)addr;
+	else
+		l3.ipv6 = *(const struct rte_ipv6_addr *)addr;
+
+	return nexthop_new(
+		&(struct gr_nexthop_base) {
+			.type = GR_NH_T_L3,
+			.origin = GR_NH_ORIGIN_INTERNAL,
+			.iface_id = iface_id,
+			.vrf_id = vrf_id,
+		},
+		&l3
+	);
+}
+
+static bool mpls_nh_equal(const struct nexthop *a, const struct nexthop *b) {
+	const struct nexthop_info_mpls *ma = nexthop_info_mpls(a);
+	const struct nexthop_info_mpls *mb = nexthop_info_mpls(b);
+
+	if (ma->af != mb->af || ma->n_labels != mb->n_labels)
+		return false;
+
+	switch (ma->af) {
+	case GR_AF_IP4:
+		if (ma->ipv4 != mb->ipv4)
+			return false;
+		break;
+	case GR_AF_IP6:
+		if (!rte_ipv6_addr_eq(&ma->ipv6, &mb->ipv6))
+			return false;
+		break;
+	default:
+		return false;
+	}
+
+	return memcmp(ma->labels, mb->labels, ma->n_labels * sizeof(ma->labels[0])) == 0;
+}
+
+static void mpls_nh_free(struct nexthop *nh) {
+	struct nexthop_info_mpls *mpls = nexthop_info_mpls(nh);
+
+	if (mpls->gw != NULL) {
+		nexthop_decref(mpls->gw);
+		mpls->gw = NULL;
+	}
+}
+
+static int mpls_nh_import_info(struct nexthop *nh, const void *info) {
+	struct nexthop_info_mpls *priv = nexthop_info_mpls(nh);
+	const struct gr_nexthop_info_mpls *pub = info;
+	struct nexthop *gw, *old_gw;
+	uint8_t n_lse = 0;
+
+	switch (pub->af) {
+	case GR_AF_IP4:
+		if (pub->ipv4 == 0)
+			return errno_set(EDESTADDRREQ);
+		break;
+	case GR_AF_IP6:
+		if (rte_ipv6_addr_is_unspec(&pub->ipv6))
+			return errno_set(EDESTADDRREQ);
+		break;
+	default:
+		return errno_set(EAFNOSUPPORT);
+	}
+
+	if (pub->n_labels > GR_MPLS_LABEL_STACK_MAX)
+		return errno_set(E2BIG);
+
+	for (uint8_t i = 0; i < pub->n_labels; i++) {
+		if (pub->labels[i] > GR_MPLS_LABEL_MAX)
+			return errno_set(ERANGE);
+	}
+
+	gw = mpls_gw_get(pub->af, nh->vrf_id, nh->iface_id, &pub->addr);
+	if (gw == NULL)
+		return -errno;
+	nexthop_incref(gw);
+
+	// Disable the nexthop in datapath while updating the label stack.
+	old_gw = priv->gw;
+	priv->gw = NULL;
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+
+	priv->base = *pub;
+	for (uint8_t i = 0; i < pub->n_labels; i++) {
+		if (pub->labels[i] == GR_MPLS_LABEL_IMPLICIT_NULL)
+			continue;
+		priv->lse[n_lse++] = rte_cpu_to_be_32(pub->labels[i] << MPLS_LSE_LABEL_SHIFT);
+	}
+	priv->n_lse = n_lse;
+	priv->gw = gw;
+
+	if (old_gw != NULL)
+		nexthop_decref(old_gw);
+
+	return 0;
+}
+
+static struct gr_nexthop *mpls_nh_to_api(const struct nexthop *nh, size_t *len) {
+	const struct nexthop_info_mpls *mpls_priv = nexthop_info_mpls(nh);
+	struct gr_nexthop_info_mpls *mpls_pub;
+	struct gr_nexthop *pub;
+
+	pub = malloc(sizeof(*pub) + sizeof(*mpls_pub));
+	if (pub == NULL)
+		return errno_set_null(ENOMEM);
+
+	pub->base = nh->base;
+	mpls_pub = (struct gr_nexthop_info_mpls *)pub->info;
+	*mpls_pub = mpls_priv->base;
+
+	*len = sizeof(*pub) + sizeof(*mpls_pub);
+
+	return pub;
+}
+
+static void mpls_gw_cleanup_cb(struct nexthop *nh, void *priv) {
+	const struct iface *iface = priv;
+	struct nexthop_info_mpls *mpls;
+	struct nexthop *gw;
+
+	if (nh->type != GR_NH_T_MPLS)
+		return;
+
+	mpls = nexthop_info_mpls(nh);
+	gw = mpls->gw;
+	if (gw == NULL || gw->iface_id != iface->id)
+		return;
+
+	// The gateway nexthop will be destroyed along with the interface.
+	// Release it now, packets will be dropped until the nexthop is updated.
+	mpls->gw = NULL;
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+	nexthop_decref(gw);
+}
+
+static void iface_pre_remove_cb(uint32_t /*event*/, const void *obj) {
+	nexthop_iter(mpls_gw_cleanup_cb, (void *)obj);
+}
+
+static struct gr_event_subscription iface_pre_rm_subscription = {
+	.callback = iface_pre_remove_cb,
+	.ev_count = 1,
+	.ev_types = {GR_EVENT_IFACE_PRE_REMOVE},
+};
+
+static struct nexthop_type_ops nh_ops = {
+	.free = mpls_nh_free,
+	.equal = mpls_nh_equal,
+	.import_info = mpls_nh_import_info,
+	.to_api = mpls_nh_to_api,
+};
+
+RTE_INIT(mpls_nexthop_constructor) {
+	nexthop_type_ops_register(GR_NH_T_MPLS, &nh_ops);
+	gr_event_subscribe(&iface_pre_rm_subscription);
+}
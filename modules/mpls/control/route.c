@@ -0,0 +1,242 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_event.h>
+#include <gr_infra.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_mpls.h>
+#include <gr_mpls_control.h>
+#include <gr_rcu.h>
+#include <gr_vec.h>
+
+#include <event2/event.h>
+#include <rte_atomic.h>
+#include <rte_malloc.h>
+
+#include <string.h>
+
+struct ilm_entry *mpls_ilm;
+
+static int ilm_alloc(void) {
+	if (mpls_ilm != NULL)
+		return 0;
+
+	// 2^20 labels, 16 bytes each. Only allocated when MPLS is used.
+	mpls_ilm = rte_zmalloc(
+		__func__, (GR_MPLS_LABEL_MAX + 1) * sizeof(*mpls_ilm), RTE_CACHE_LINE_SIZE
+	);
+	if (mpls_ilm == NULL)
+		return errno_set(ENOMEM);
+
+	return 0;
+}
+
+static void ilm_clear(uint32_t label) {
+	struct ilm_entry *e = &mpls_ilm[label];
+	struct nexthop *nh = (struct nexthop *)e->nh;
+
+	e->active = false;
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+	if (nh != NULL)
+		nexthop_decref(nh);
+	memset(e, 0, sizeof(*e));
+}
+
+static struct nexthop *ilm_nh_new(const struct gr_mpls_route *r) {
+	return nexthop_new(
+		&(struct gr_nexthop_base) {
+			.type = GR_NH_T_MPLS,
+			.origin = GR_NH_ORIGIN_INTERNAL,
+			.iface_id = r->iface_id,
+			.vrf_id = r->vrf_id,
+		},
+		&r->nh
+	);
+}
+
+static struct api_out mpls_route_add(const void *request, struct api_ctx *) {
+	const struct gr_mpls_route_add_req *req = request;
+	const struct gr_mpls_route *r = &req->route;
+	struct nexthop *nh = NULL, *old;
+	struct ilm_entry *e;
+	int ret;
+
+	if (r->in_label <= GR_MPLS_LABEL_RESERVED_MAX || r->in_label > GR_MPLS_LABEL_MAX)
+		return api_out(ERANGE, 0, NULL);
+	if (r->vrf_id >= GR_MAX_VRFS)
+		return api_out(EOVERFLOW, 0, NULL);
+	if ((ret = ilm_alloc()) < 0)
+		return api_out(-ret, 0, NULL);
+
+	if (r->nh_id != GR_NH_ID_UNSET) {
+		nh = nexthop_lookup_by_id(r->nh_id);
+		if (nh == NULL)
+			return api_out(ENOENT, 0, NULL);
+		if (nh->type != GR_NH_T_MPLS)
+			return api_out(EMEDIUMTYPE, 0, NULL);
+	}
+
+	e = &mpls_ilm[r->in_label];
+	if (e->active) {
+		if (!req->exist_ok)
+			return api_out(EEXIST, 0, NULL);
+		if (nh != NULL && e->nh == nh && e->origin == r->origin)
+			return api_out(0, 0, NULL);
+	}
+
+	if (nh == NULL && r->nh.af != GR_AF_UNSPEC) {
+		if ((nh = ilm_nh_new(r)) == NULL)
+			return api_out(errno, 0, NULL);
+	}
+
+	if (nh != NULL)
+		nexthop_incref(nh);
+
+	if (e->active) {
+		// Replace the entry in place so that traffic for this label keeps
+		// flowing. Packets in flight may still use the previous nexthop,
+		// release it only after a grace period.
+		old = (struct nexthop *)e->nh;
+		e->vrf_id = r->vrf_id;
+		e->origin = r->origin;
+		__atomic_store_n(&e->nh, nh, __ATOMIC_RELEASE);
+		if (old != NULL) {
+			rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+			nexthop_decref(old);
+		}
+		return api_out(0, 0, NULL);
+	}
+
+	e->nh = nh;
+	e->vrf_id = r->vrf_id;
+	e->origin = r->origin;
+	// Make sure the datapath sees a complete entry.
+	rte_smp_wmb();
+	e->active = true;
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out mpls_route_del(const void *request, struct api_ctx *) {
+	const struct gr_mpls_route_del_req *req = request;
+
+	if (req->in_label > GR_MPLS_LABEL_MAX)
+		return api_out(ERANGE, 0, NULL);
+
+	if (mpls_ilm == NULL || !mpls_ilm[req->in_label].active) {
+		if (req->missing_ok)
+			return api_out(0, 0, NULL);
+		return api_out(ENOENT, 0, NULL);
+	}
+
+	ilm_clear(req->in_label);
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out mpls_route_list(const void * /*request*/, struct api_ctx *ctx) {
+	const struct ilm_entry *e;
+
+	if (mpls_ilm == NULL)
+		return api_out(0, 0, NULL);
+
+	for (uint32_t label = 0; label <= GR_MPLS_LABEL_MAX; label++) {
+		e = &mpls_ilm[label];
+		if (!e->active)
+			continue;
+
+		struct gr_mpls_route r = {
+			.in_label = label,
+			.origin = e->origin,
+			.vrf_id = e->vrf_id,
+		};
+		if (e->nh != NULL) {
+			if (e->nh->origin != GR_NH_ORIGIN_INTERNAL)
+				r.nh_id = e->nh->nh_id;
+			r.iface_id = e->nh->iface_id;
+			r.nh = nexthop_info_mpls(e->nh)->base;
+		}
+		api_send(ctx, sizeof(r), &r);
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+// Remove routes that reference a nexthop which is being destroyed.
+static void nh_delete_cb(uint32_t /*event*/, const void *obj) {
+	const struct nexthop *nh = obj;
+	gr_vec uint32_t *labels = NULL;
+	uint32_t label;
+
+	if (mpls_ilm == NULL || nh->type != GR_NH_T_MPLS)
+		return;
+
+	// Deactivate all matching entries first and wait for a single grace
+	// period before wiping them.
+	for (label = 0; label <= GR_MPLS_LABEL_MAX; label++) {
+		struct ilm_entry *e = &mpls_ilm[label];
+		if (e->active && e->nh == nh) {
+			// The reference has already been released by the caller.
+			e->active = false;
+			gr_vec_add(labels, label);
+		}
+	}
+
+	if (gr_vec_len(labels) == 0)
+		return;
+
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+	gr_vec_foreach (label, labels)
+		memset(&mpls_ilm[label], 0, sizeof(mpls_ilm[label]));
+	gr_vec_free(labels);
+}
+
+static void mpls_fini(struct event_base *) {
+	if (mpls_ilm == NULL)
+		return;
+
+	for (uint32_t label = 0; label <= GR_MPLS_LABEL_MAX; label++) {
+		if (mpls_ilm[label].active)
+			ilm_clear(label);
+	}
+	rte_free(mpls_ilm);
+	mpls_ilm = NULL;
+}
+
+static struct gr_api_handler route_add_handler = {
+	.name = "mpls route add",
+	.request_type = GR_MPLS_ROUTE_ADD,
+	.callback = mpls_route_add,
+};
+static struct gr_api_handler route_del_handler = {
+	.name = "mpls route del",
+	.request_type = GR_MPLS_ROUTE_DEL,
+	.callback = mpls_route_del,
+};
+static struct gr_api_handler route_list_handler = {
+	.name = "mpls route list",
+	.request_type = GR_MPLS_ROUTE_LIST,
+	.callback = mpls_route_list,
+};
+
+static struct gr_event_subscription nh_delete_subscription = {
+	.callback = nh_delete_cb,
+	.ev_count = 1,
+	.ev_types = {GR_EVENT_NEXTHOP_DELETE},
+};
+
+static struct gr_module mpls_module = {
+	.name = "mpls",
+	.depends_on = "nexthop",
+	.fini = mpls_fini,
+};
+
+RTE_INIT(mpls_constructor) {
+	gr_register_api_handler(&route_add_handler);
+	gr_register_api_handler(&route_del_handler);
+	gr_register_api_handler(&route_list_handler);
+	gr_event_subscribe(&nh_delete_subscription);
+	gr_register_module(&mpls_module);
+}
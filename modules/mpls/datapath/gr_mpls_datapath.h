@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_mbuf.h>
+#include <gr_mpls_control.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Set by mpls_input when a label was swapped. The packet type is also set to
+// RTE_PTYPE_L2_ETHER_MPLS so that mpls_output can tell these packets apart from
+// IP packets coming from ip_output and ip6_output.
+GR_MBUF_PRIV_DATA_TYPE(mpls_mbuf_data, {
+	const struct nexthop *nh;
+	uint8_t ttl;
+	uint8_t tc;
+	bool bos; // no labels left after the popped one
+});
+
+struct trace_mpls_data {
+	uint32_t label;
+	uint8_t tc;
+	uint8_t ttl;
+	bool bos;
+};
+
+int trace_mpls_format(char *buf, size_t len, const void *data, size_t data_len);
@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_datapath.h>
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_mpls.h>
+#include <gr_mpls_control.h>
+#include <gr_mpls_datapath.h>
+#include <gr_trace.h>
+
+#include <rte_byteorder.h>
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+
+enum {
+	MPLS_OUTPUT = 0,
+	IP_INPUT,
+	IP6_INPUT,
+	NO_ROUTE,
+	TTL_EXCEEDED,
+	BAD_HEADER,
+	EDGE_COUNT,
+};
+
+int trace_mpls_format(char *buf, size_t len, const void *data, size_t /*data_len*/) {
+	const struct trace_mpls_data *t = data;
+	return snprintf(
+		buf,
+		len,
+		"label=%u tc=%u s=%u ttl=%u",
+		t->label,
+		t->tc,
+		t->bos,
+		t->ttl
+	);
+}
+
+static uint16_t
+mpls_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	const struct ilm_entry *ilm;
+	const struct nexthop *nh;
+	struct mpls_mbuf_data *d;
+	const struct iface *iface;
+	struct rte_mbuf *mbuf;
+	uint8_t ttl, tc;
+	uint32_t label;
+	rte_edge_t edge;
+	uint32_t lse;
+	bool bos;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		mbuf = objs[i];
+		iface = eth_input_mbuf_data(mbuf)->iface;
+		label = 0;
+		ttl = 0;
+		tc = 0;
+		bos = false;
+
+		// Pop labels until a route with a nexthop is found or until the
+		// bottom of the stack has been reached.
+		do {
+			if (unlikely(rte_pktmbuf_data_len(mbuf) < sizeof(lse))) {
+				edge = BAD_HEADER;
+				goto next;
+			}
+			lse = rte_be_to_cpu_32(*rte_pktmbuf_mtod(mbuf, rte_be32_t *));
+			label = lse >> MPLS_LSE_LABEL_SHIFT;
+			tc = (lse >> MPLS_LSE_TC_SHIFT) & MPLS_LSE_TC_MASK;
+			ttl = lse & MPLS_LSE_TTL_MASK;
+			bos = lse & MPLS_LSE_BOS;
+
+			switch (label) {
+			case GR_MPLS_LABEL_IPV4_EXPLICIT_NULL:
+			case GR_MPLS_LABEL_IPV6_EXPLICIT_NULL:
+				ilm = NULL;
+				break;
+			default:
+				ilm = mpls_ilm_lookup(label);
+				if (ilm == NULL) {
+					edge = NO_ROUTE;
+					goto next;
+				}
+			}
+
+			rte_pktmbuf_adj(mbuf, sizeof(lse));
+
+			// The nexthop may be replaced concurrently, read it only once.
+			nh = ilm != NULL ? __atomic_load_n(&ilm->nh, __ATOMIC_ACQUIRE) : NULL;
+			if (nh != NULL) {
+				// Swap (or penultimate hop pop when the nexthop has no labels).
+				if (ttl <= 1) {
+					edge = TTL_EXCEEDED;
+					goto next;
+				}
+				d = mpls_mbuf_data(mbuf);
+				d->nh = nh;
+				d->ttl = ttl - 1;
+				d->tc = tc;
+				d->bos = bos;
+				mbuf->packet_type = RTE_PTYPE_L2_ETHER_MPLS;
+				edge = MPLS_OUTPUT;
+				goto next;
+			}
+
+			if (ilm != NULL && ilm->vrf_id != iface->vrf_id) {
+				iface = get_vrf_iface(ilm->vrf_id);
+				if (iface == NULL) {
+					edge = NO_ROUTE;
+					goto next;
+				}
+			}
+		} while (!bos);
+
+		// Disposition. Short pipe model: the IP header is left untouched.
+		if (unlikely(rte_pktmbuf_data_len(mbuf) == 0)) {
+			edge = BAD_HEADER;
+			goto next;
+		}
+		switch (*rte_pktmbuf_mtod(mbuf, const uint8_t *) >> 4) {
+		case 4:
+			mbuf->packet_type = RTE_PTYPE_L3_IPV4;
+			edge = IP_INPUT;
+			break;
+		case 6:
+			mbuf->packet_type = RTE_PTYPE_L3_IPV6;
+			edge = IP6_INPUT;
+			break;
+		default:
+			edge = BAD_HEADER;
+			goto next;
+		}
+		// Checksum offload flags are only relevant for the outer headers.
+		mbuf->ol_flags |= RTE_MBUF_F_RX_IP_CKSUM_NONE | RTE_MBUF_F_RX_L4_CKSUM_NONE;
+		eth_input_mbuf_data(mbuf)->iface = iface;
+next:
+		if (gr_mbuf_is_traced(mbuf)) {
+			struct trace_mpls_data *t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
+			t->label = label;
+			t->tc = tc;
+			t->ttl = ttl;
+			t->bos = bos;
+		}
+		rte_node_enqueue_x1(graph, node, edge, mbuf);
+	}
+
+	return nb_objs;
+}
+
+static void mpls_input_register(void) {
+	gr_eth_input_add_type(RTE_BE16(RTE_ETHER_TYPE_MPLS), "mpls_input");
+}
+
+static struct rte_node_register mpls_input_node = {
+	.name = "mpls_input",
+
+	.process = mpls_input_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[MPLS_OUTPUT] = "mpls_output",
+		[IP_INPUT] = "ip_input",
+		[IP6_INPUT] = "ip6_input",
+		[NO_ROUTE] = "mpls_input_no_route",
+		[TTL_EXCEEDED] = "mpls_input_ttl_exceeded",
+		[BAD_HEADER] = "mpls_input_bad_header",
+	},
+};
+
+static struct gr_node_info mpls_input_info = {
+	.node = &mpls_input_node,
+	.register_callback = mpls_input_register,
+	.trace_format = trace_mpls_format,
+};
+
+GR_NODE_REGISTER(mpls_input_info);
+
+GR_DROP_REGISTER(mpls_input_no_route);
+GR_DROP_REGISTER(mpls_input_ttl_exceeded);
+GR_DROP_REGISTER(mpls_input_bad_header);
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_control_output.h>
+#include <gr_datapath.h>
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_ip4_datapath.h>
+#include <gr_ip6_datapath.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_mpls.h>
+#include <gr_mpls_control.h>
+#include <gr_mpls_datapath.h>
+#include <gr_trace.h>
+
+#include <rte_byteorder.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+
+#include <string.h>
+
+enum {
+	ETH_OUTPUT = 0,
+	HOLD,
+	NO_ROUTE,
+	NO_HEADROOM,
+	TOO_BIG,
+	INVALID,
+	EDGE_COUNT,
+};
+
+// Called from ip_output and ip6_output for label imposition and from
+// mpls_input for label swap.
+static uint16_t
+mpls_output_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	const struct nexthop_info_mpls *mpls;
+	struct control_output_mbuf_data *c;
+	struct eth_output_mbuf_data *eth;
+	const struct nexthop_info_l3 *l3;
+	const struct iface *iface;
+	const struct nexthop *nh;
+	rte_be16_t ether_type;
+	struct rte_mbuf *mbuf;
+	uint8_t ttl, tc;
+	rte_be32_t *lse;
+	rte_edge_t edge;
+	rte_be32_t flags;
+	bool bos;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		mbuf = objs[i];
+		lse = NULL;
+
+		if ((mbuf->packet_type & RTE_PTYPE_L2_MASK) == RTE_PTYPE_L2_ETHER_MPLS) {
+			const struct mpls_mbuf_data *d = mpls_mbuf_data(mbuf);
+			nh = d->nh;
+			ttl = d->ttl;
+			tc = d->tc;
+			bos = d->bos;
+			if (!bos)
+				ether_type = RTE_BE16(RTE_ETHER_TYPE_MPLS);
+			else if ((*rte_pktmbuf_mtod(mbuf, const uint8_t *) >> 4) == 6)
+				ether_type = RTE_BE16(RTE_ETHER_TYPE_IPV6);
+			else
+				ether_type = RTE_BE16(RTE_ETHER_TYPE_IPV4);
+		} else if (mbuf->packet_type & RTE_PTYPE_L3_IPV4) {
+			const struct rte_ipv4_hdr *ip = rte_pktmbuf_mtod(mbuf, struct rte_ipv4_hdr *);
+			nh = ip_output_mbuf_data(mbuf)->nh;
+			ttl = ip->time_to_live;
+			tc = ip->type_of_service >> 5;
+			bos = true;
+			ether_type = RTE_BE16(RTE_ETHER_TYPE_IPV4);
+		} else if (mbuf->packet_type & RTE_PTYPE_L3_IPV6) {
+			const struct rte_ipv6_hdr *ip6 = rte_pktmbuf_mtod(mbuf, struct rte_ipv6_hdr *);
+			nh = ip6_output_mbuf_data(mbuf)->nh;
+			ttl = ip6->hop_limits;
+			tc = (rte_be_to_cpu_32(ip6->vtc_flow) >> 25) & MPLS_LSE_TC_MASK;
+			bos = true;
+			ether_type = RTE_BE16(RTE_ETHER_TYPE_IPV6);
+		} else {
+			edge = INVALID;
+			goto next;
+		}
+
+		mpls = nexthop_info_mpls(nh);
+		if (unlikely(mpls->gw == NULL)) {
+			edge = NO_ROUTE;
+			goto next;
+		}
+		iface = iface_from_id(mpls->gw->iface_id);
+		if (iface == NULL) {
+			edge = NO_ROUTE;
+			goto next;
+		}
+
+		if (mpls->n_lse > 0) {
+			lse = (rte_be32_t *)rte_pktmbuf_prepend(mbuf, mpls->n_lse * sizeof(*lse));
+			if (unlikely(lse == NULL)) {
+				edge = NO_HEADROOM;
+				goto next;
+			}
+			flags = rte_cpu_to_be_32((tc << MPLS_LSE_TC_SHIFT) | ttl);
+			for (uint8_t l = 0; l < mpls->n_lse; l++)
+				lse[l] = mpls->lse[l] | flags;
+			if (bos)
+				lse[mpls->n_lse - 1] |= RTE_BE32(MPLS_LSE_BOS);
+			ether_type = RTE_BE16(RTE_ETHER_TYPE_MPLS);
+		}
+
+		if (rte_pktmbuf_pkt_len(mbuf) > iface->mtu) {
+			edge = TOO_BIG;
+			goto next;
+		}
+
+		l3 = nexthop_info_l3(mpls->gw);
+		if (l3->state != GR_NH_S_REACHABLE) {
+			c = control_output_mbuf_data(mbuf);
+			c->callback = mpls_gw_unreachable_cb;
+			memcpy(c->cb_data, &mpls->gw, sizeof(struct nexthop *));
+			edge = HOLD;
+			goto next;
+		}
+
+		mbuf_data(mbuf)->iface = iface;
+		eth = eth_output_mbuf_data(mbuf);
+		eth->dst = l3->mac;
+		eth->ether_type = ether_type;
+		edge = ETH_OUTPUT;
+next:
+		if (gr_mbuf_is_traced(mbuf)) {
+			struct trace_mpls_data *t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
+			if (lse != NULL) {
+				uint32_t top = rte_be_to_cpu_32(lse[0]);
+				t->label = top >> MPLS_LSE_LABEL_SHIFT;
+				t->tc = (top >> MPLS_LSE_TC_SHIFT) & MPLS_LSE_TC_MASK;
+				t->ttl = top & MPLS_LSE_TTL_MASK;
+				t->bos = top & MPLS_LSE_BOS;
+			} else {
+				memset(t, 0, sizeof(*t));
+			}
+		}
+		rte_node_enqueue_x1(graph, node, edge, mbuf);
+	}
+
+	return nb_objs;
+}
+
+static void mpls_output_register(void) {
+	ip_output_register_nexthop_type(GR_NH_T_MPLS, "mpls_output");
+	ip6_output_register_nexthop_type(GR_NH_T_MPLS, "mpls_output");
+}
+
+static struct rte_node_register mpls_output_node = {
+	.name = "mpls_output",
+
+	.process = mpls_output_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[ETH_OUTPUT] = "eth_output",
+		[HOLD] = "control_output",
+		[NO_ROUTE] = "mpls_output_no_route",
+		[NO_HEADROOM] = "error_no_headroom",
+		[TOO_BIG] = "mpls_output_too_big",
+		[INVALID] = "mpls_output_invalid",
+	},
+};
+
+static struct gr_node_info mpls_output_info = {
+	.node = &mpls_output_node,
+	.register_callback = mpls_output_register,
+	.trace_format = trace_mpls_format,
+};
+
+GR_NODE_REGISTER(mpls_output_info);
+
+GR_DROP_REGISTER(mpls_output_no_route);
+GR_DROP_REGISTER(mpls_output_too_big);
+GR_DROP_REGISTER(mpls_output_invalid);
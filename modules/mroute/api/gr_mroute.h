@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_api.h>
+#include <gr_bitops.h>
+#include <gr_net_types.h>
+
+#include <stdint.h>
+
+#define GR_MROUTE_MODULE 0x01e0
+
+#define GR_MROUTE_MAX_OIFS 32
+
+typedef enum : uint8_t {
+	GR_MROUTE_F_LOCAL = GR_BIT8(0), //!< Also deliver a copy to the local stack.
+} gr_mroute_flags_t;
+
+union gr_mroute_addr {
+	ip4_addr_t ipv4;
+	struct rte_ipv6_addr ipv6;
+};
+
+// Multicast forwarding entry.
+//
+// Packets sent to group and received on iif are replicated to all output
+// interfaces. Entries with an unspecified source address are (*,G) entries
+// which are used when no (S,G) entry matches.
+struct gr_mroute {
+	uint16_t vrf_id;
+	addr_family_t af;
+	gr_mroute_flags_t flags;
+	union gr_mroute_addr src; //!< unspecified for (*,G)
+	union gr_mroute_addr group;
+	uint16_t iif; //!< RPF interface, GR_IFACE_ID_UNDEF to accept any
+	uint16_t n_oifs;
+	uint16_t oifs[GR_MROUTE_MAX_OIFS];
+	// Only filled in GR_MROUTE_LIST responses.
+	uint64_t packets;
+	uint64_t bytes;
+};
+
+#define GR_MROUTE_ADD REQUEST_TYPE(GR_MROUTE_MODULE, 0x0001)
+
+struct gr_mroute_add_req {
+	struct gr_mroute mroute;
+	uint8_t exist_ok;
+};
+
+// struct gr_mroute_add_resp { };
+
+#define GR_MROUTE_DEL REQUEST_TYPE(GR_MROUTE_MODULE, 0x0002)
+
+struct gr_mroute_del_req {
+	uint16_t vrf_id;
+	addr_family_t af;
+	union gr_mroute_addr src;
+	union gr_mroute_addr group;
+	uint8_t missing_ok;
+};
+
+// struct gr_mroute_del_resp { };
+
+#define GR_MROUTE_LIST REQUEST_TYPE(GR_MROUTE_MODULE, 0x0003)
+
+struct gr_mroute_list_req {
+	uint16_t vrf_id; //!< GR_VRF_ID_ALL for all VRFs
+	addr_family_t af; //!< GR_AF_UNSPEC for all address families
+};
+
+// STREAM(struct gr_mroute);
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_cli.h>
+#include <gr_cli_iface.h>
+#include <gr_mroute.h>
+#include <gr_net_types.h>
+#include <gr_table.h>
+
+#include <ecoli.h>
+#include <libsmartcols.h>
+
+#include <errno.h>
+#include <string.h>
+
+static int parse_group(
+	const struct ec_pnode *p,
+	addr_family_t *af,
+	union gr_mroute_addr *src,
+	union gr_mroute_addr *group
+) {
+	if (arg_ip4(p, "GROUP", &group->ipv4) == 0)
+		*af = GR_AF_IP4;
+	else if (arg_ip6(p, "GROUP", &group->ipv6) == 0)
+		*af = GR_AF_IP6;
+	else
+		return errno_set(EINVAL);
+
+	if (arg_ip(p, "SRC", src, *af) < 0 && errno != ENOENT)
+		return -errno;
+
+	return 0;
+}
+
+static cmd_status_t mroute_add(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_mroute_add_req req = {.exist_ok = true};
+	struct gr_mroute *r = &req.mroute;
+	const struct ec_pnode *n;
+	struct gr_iface *iface;
+
+	r->iif = GR_IFACE_ID_UNDEF;
+
+	if (parse_group(p, &r->af, &r->src, &r->group) < 0)
+		return CMD_ERROR;
+	if (arg_u16(p, "VRF", &r->vrf_id) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+	if (arg_str(p, "local") != NULL)
+		r->flags |= GR_MROUTE_F_LOCAL;
+
+	if (arg_str(p, "IIF") != NULL) {
+		if ((iface = iface_from_name(c, arg_str(p, "IIF"))) == NULL)
+			return CMD_ERROR;
+		r->iif = iface->id;
+		free(iface);
+	}
+
+	// get OIF sequence node. it is the parent of the first OIF node.
+	n = ec_pnode_find(p, "OIF");
+	if (n != NULL && (n = ec_pnode_get_parent(n)) != NULL) {
+		for (n = ec_pnode_get_first_child(n); n != NULL; n = ec_pnode_next(n)) {
+			const char *name = ec_strvec_val(ec_pnode_get_strvec(n), 0);
+			if (r->n_oifs == GR_MROUTE_MAX_OIFS) {
+				errno = E2BIG;
+				return CMD_ERROR;
+			}
+			if ((iface = iface_from_name(c, name)) == NULL)
+				return CMD_ERROR;
+			r->oifs[r->n_oifs++] = iface->id;
+			free(iface);
+		}
+	}
+
+	if (gr_api_client_send_recv(c, GR_MROUTE_ADD, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t mroute_del(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_mroute_del_req req = {.missing_ok = true};
+
+	if (parse_group(p, &req.af, &req.src, &req.group) < 0)
+		return CMD_ERROR;
+	if (arg_u16(p, "VRF", &req.vrf_id) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_MROUTE_DEL, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static int format_iface(struct gr_api_client *c, uint16_t iface_id, char *buf, size_t len) {
+	struct gr_iface *iface = iface_from_id(c, iface_id);
+	int n;
+
+	if (iface != NULL)
+		n = snprintf(buf, len, "%s", iface->name);
+	else
+		n = snprintf(buf, len, "%u", iface_id);
+	free(iface);
+
+	return n;
+}
+
+static cmd_status_t mroute_list(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_mroute_list_req req = {.vrf_id = GR_VRF_ID_ALL, .af = GR_AF_UNSPEC};
+	static const union gr_mroute_addr any;
+	const struct gr_mroute *r;
+	int ret;
+
+	if (arg_u16(p, "VRF", &req.vrf_id) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+	if (arg_str(p, "ip") != NULL)
+		req.af = GR_AF_IP4;
+	else if (arg_str(p, "ip6") != NULL)
+		req.af = GR_AF_IP6;
+
+	struct libscols_table *table = scols_new_table();
+	scols_table_new_column(table, "VRF", 0, 0);
+	scols_table_new_column(table, "SOURCE", 0, 0);
+	scols_table_new_column(table, "GROUP", 0, 0);
+	scols_table_new_column(table, "IIF", 0, 0);
+	scols_table_new_column(table, "OIFS", 0, 0);
+	scols_table_new_column(table, "FLAGS", 0, 0);
+	scols_table_new_column(table, "PACKETS", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "BYTES", 0, SCOLS_FL_RIGHT);
+	scols_table_set_column_separator(table, "  ");
+
+	gr_api_client_stream_foreach (r, ret, c, GR_MROUTE_LIST, sizeof(req), &req) {
+		struct libscols_line *line = scols_table_new_line(table, NULL);
+		char buf[512];
+		size_t len = 0;
+
+		scols_line_sprintf(line, 0, "%u", r->vrf_id);
+		if (memcmp(&r->src, &any, sizeof(any)) == 0)
+			scols_line_set_data(line, 1, "*");
+		else
+			scols_line_sprintf(line, 1, ADDR_F, ADDR_W(r->af), &r->src);
+		scols_line_sprintf(line, 2, ADDR_F, ADDR_W(r->af), &r->group);
+
+		if (r->iif == GR_IFACE_ID_UNDEF) {
+			scols_line_set_data(line, 3, "*");
+		} else {
+			format_iface(c, r->iif, buf, sizeof(buf));
+			scols_line_set_data(line, 3, buf);
+		}
+
+		buf[0] = '\0';
+		for (uint16_t i = 0; i < r->n_oifs && len < sizeof(buf); i++) {
+			if (i > 0)
+				len += snprintf(buf + len, sizeof(buf) - len, " ");
+			if (len < sizeof(buf))
+				len += format_iface(c, r->oifs[i], buf + len, sizeof(buf) - len);
+		}
+		scols_line_set_data(line, 4, buf);
+		scols_line_set_data(line, 5, r->flags & GR_MROUTE_F_LOCAL ? "local" : "");
+		scols_line_sprintf(line, 6, "%lu", r->packets);
+		scols_line_sprintf(line, 7, "%lu", r->bytes);
+	}
+
+	scols_print_table(table);
+	scols_unref_table(table);
+
+	return ret < 0 ? CMD_ERROR : CMD_SUCCESS;
+}
+
+#define MROUTE_CTX(root) CLI_CONTEXT(root, CTX_ARG("mroute", "Multicast forwarding entries."))
+
+static int ctx_init(struct ec_node *root) {
+	int ret;
+
+	ret = CLI_COMMAND(
+		MROUTE_CTX(root),
+		"add GROUP [(source SRC),(iif IIF),(vrf VRF),(local)] [oif OIF+]",
+		mroute_add,
+		"Add a multicast forwarding entry.",
+		with_help("Multicast group address.", ec_node_re("GROUP", IP_ANY_RE)),
+		with_help(
+			"Source address. If not specified, create a (*,G) entry.",
+			ec_node_re("SRC", IP_ANY_RE)
+		),
+		with_help(
+			"Expected input interface (RPF check).",
+			ec_node_dyn("IIF", complete_iface_names, INT2PTR(GR_IFACE_TYPE_UNDEF))
+		),
+		with_help("L3 routing domain ID.", ec_node_uint("VRF", 0, UINT16_MAX - 1, 10)),
+		with_help(
+			"Also deliver packets to the local stack.", ec_node_str("local", "local")
+		),
+		with_help(
+			"Output interface.",
+			ec_node_dyn("OIF", complete_iface_names, INT2PTR(GR_IFACE_TYPE_UNDEF))
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		MROUTE_CTX(root),
+		"del GROUP [(source SRC),(vrf VRF)]",
+		mroute_del,
+		"Delete a multicast forwarding entry.",
+		with_help("Multicast group address.", ec_node_re("GROUP", IP_ANY_RE)),
+		with_help("Source address.", ec_node_re("SRC", IP_ANY_RE)),
+		with_help("L3 routing domain ID.", ec_node_uint("VRF", 0, UINT16_MAX - 1, 10))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		MROUTE_CTX(root),
+		"[show] [(vrf VRF),(ip|ip6)]",
+		mroute_list,
+		"Show multicast forwarding entries.",
+		with_help("L3 routing domain ID.", ec_node_uint("VRF", 0, UINT16_MAX - 1, 10)),
+		with_help("Only show IPv4 entries.", ec_node_str("ip", "ip")),
+		with_help("Only show IPv6 entries.", ec_node_str("ip6", "ip6"))
+	);
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+static struct cli_context ctx = {
+	.name = "mroute",
+	.init = ctx_init,
+};
+
+static void __attribute__((constructor, used)) init(void) {
+	cli_context_register(&ctx);
+}
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_mroute.h>
+#include <gr_net_types.h>
+#include <gr_nh_control.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Multicast forwarding entry. Entries are never modified once published.
+// Updating an entry replaces it with a new one and frees the old one after
+// an RCU grace period.
+struct mroute_entry {
+	// Multicast nexthop of the group. Not bound to any interface.
+	struct nexthop *nh;
+	_Atomic(uint64_t) packets;
+	_Atomic(uint64_t) bytes;
+	gr_mroute_flags_t flags;
+	uint16_t iif;
+	uint16_t n_oifs;
+	uint16_t oifs[GR_MROUTE_MAX_OIFS];
+};
+
+// Lookup the (S,G) entry for a received packet and fallback to (*,G).
+struct mroute_entry *mroute4_lookup(uint16_t vrf_id, ip4_addr_t src, ip4_addr_t group);
+struct mroute_entry *mroute6_lookup(
+	uint16_t vrf_id,
+	const struct rte_ipv6_addr *src,
+	const struct rte_ipv6_addr *group
+);
@@ -0,0 +1,492 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_event.h>
+#include <gr_iface.h>
+#include <gr_infra.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_mroute.h>
+#include <gr_mroute_control.h>
+#include <gr_rcu.h>
+#include <gr_vec.h>
+
+#include <event2/event.h>
+#include <rte_errno.h>
+#include <rte_ether.h>
+#include <rte_hash.h>
+#include <rte_ip.h>
+#include <rte_malloc.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+#define MROUTE_MAX_ENTRIES (1 << 14)
+
+struct mroute_key {
+	union gr_mroute_addr src;
+	union gr_mroute_addr group;
+	uint16_t vrf_id;
+	addr_family_t af;
+	uint8_t _pad;
+};
+
+static struct rte_hash *mroutes;
+
+struct mroute_entry *mroute4_lookup(uint16_t vrf_id, ip4_addr_t src, ip4_addr_t group) {
+	struct mroute_key key;
+	void *data;
+
+	memset(&key, 0, sizeof(key));
+	key.vrf_id = vrf_id;
+	key.af = GR_AF_IP4;
+	key.src.ipv4 = src;
+	key.group.ipv4 = group;
+
+	if (rte_hash_lookup_data(mroutes, &key, &data) >= 0)
+		return data;
+
+	key.src.ipv4 = 0;
+	if (rte_hash_lookup_data(mroutes, &key, &data) >= 0)
+		return data;
+
+	return NULL;
+}
+
+struct mroute_entry *mroute6_lookup(
+	uint16_t vrf_id,
+	const struct rte_ipv6_addr *src,
+	const struct rte_ipv6_addr *group
+) {
+	struct mroute_key key;
+	void *data;
+
+	memset(&key, 0, sizeof(key));
+	key.vrf_id = vrf_id;
+	key.af = GR_AF_IP6;
+	key.src.ipv6 = *src;
+	key.group.ipv6 = *group;
+
+	if (rte_hash_lookup_data(mroutes, &key, &data) >= 0)
+		return data;
+
+	key.src.ipv6 = (struct rte_ipv6_addr)RTE_IPV6_ADDR_UNSPEC;
+	if (rte_hash_lookup_data(mroutes, &key, &data) >= 0)
+		return data;
+
+	return NULL;
+}
+
+static void mroute_key_init(
+	struct mroute_key *key,
+	uint16_t vrf_id,
+	addr_family_t af,
+	const union gr_mroute_addr *src,
+	const union gr_mroute_addr *group
+) {
+	memset(key, 0, sizeof(*key));
+	key->vrf_id = vrf_id;
+	key->af = af;
+	switch (af) {
+	case GR_AF_IP4:
+		key->src.ipv4 = src->ipv4;
+		key->group.ipv4 = group->ipv4;
+		break;
+	case GR_AF_IP6:
+		key->src.ipv6 = src->ipv6;
+		key->group.ipv6 = group->ipv6;
+		break;
+	case GR_AF_UNSPEC:
+		break;
+	}
+}
+
+static int mroute_iface_check(const struct gr_mroute *r, uint16_t iface_id) {
+	const struct iface *iface = iface_from_id(iface_id);
+
+	if (iface == NULL)
+		return -errno;
+	if (iface->mode != GR_IFACE_MODE_L3 || iface->vrf_id != r->vrf_id)
+		return errno_set(EXDEV);
+
+	return 0;
+}
+
+static int mroute_validate(const struct gr_mroute *r) {
+	uint32_t group;
+
+	if (r->vrf_id >= GR_MAX_VRFS)
+		return errno_set(EOVERFLOW);
+
+	switch (r->af) {
+	case GR_AF_IP4:
+		group = rte_be_to_cpu_32(r->group.ipv4);
+		if (!RTE_IS_IPV4_MCAST(group))
+			return errno_set(EINVAL);
+		// 224.0.0.0/24 is link-local and must never be forwarded (RFC 5771).
+		if ((group & 0xffffff00) == RTE_IPV4(224, 0, 0, 0))
+			return errno_set(EINVAL);
+		if (RTE_IS_IPV4_MCAST(rte_be_to_cpu_32(r->src.ipv4)))
+			return errno_set(EINVAL);
+		break;
+	case GR_AF_IP6:
+		if (!rte_ipv6_addr_is_mcast(&r->group.ipv6))
+			return errno_set(EINVAL);
+		if (rte_ipv6_mc_scope(&r->group.ipv6) <= RTE_IPV6_MC_SCOPE_LINKLOCAL)
+			return errno_set(EINVAL);
+		if (rte_ipv6_addr_is_mcast(&r->src.ipv6))
+			return errno_set(EINVAL);
+		break;
+	default:
+		return errno_set(EAFNOSUPPORT);
+	}
+
+	if (r->n_oifs > GR_MROUTE_MAX_OIFS)
+		return errno_set(E2BIG);
+
+	if (r->iif != GR_IFACE_ID_UNDEF && mroute_iface_check(r, r->iif) < 0)
+		return -errno;
+
+	for (uint16_t i = 0; i < r->n_oifs; i++) {
+		if (r->oifs[i] == r->iif)
+			return errno_set(EINVAL);
+		if (mroute_iface_check(r, r->oifs[i]) < 0)
+			return -errno;
+		for (uint16_t j = 0; j < i; j++) {
+			if (r->oifs[i] == r->oifs[j])
+				return errno_set(EINVAL);
+		}
+	}
+
+	return 0;
+}
+
+// Get the multicast nexthop of a group. It is shared with the IPv6 multicast
+// group memberships of the local interfaces.
+static struct nexthop *mroute_nh_get(const struct gr_mroute *r) {
+	struct nexthop *nh;
+	uint32_t group;
+
+	nh = nexthop_lookup(r->af, r->vrf_id, GR_IFACE_ID_UNDEF, &r->group);
+	if (nh != NULL)
+		return nh;
+
+	struct gr_nexthop_base base = {
+		.type = GR_NH_T_L3,
+		.iface_id = GR_IFACE_ID_UNDEF,
+		.vrf_id = r->vrf_id,
+		.origin = GR_NH_ORIGIN_INTERNAL,
+	};
+	struct gr_nexthop_info_l3 l3 = {
+		.af = r->af,
+		.state = GR_NH_S_REACHABLE,
+		.flags = GR_NH_F_STATIC | GR_NH_F_MCAST,
+	};
+	switch (r->af) {
+	case GR_AF_IP4:
+		// RFC 1112: 01:00:5e followed by the low-order 23 bits of the group.
+		group = rte_be_to_cpu_32(r->group.ipv4);
+		l3.ipv4 = r->group.ipv4;
+		l3.mac = (struct rte_ether_addr) {{
+			0x01,
+			0x00,
+			0x5e,
+			(group >> 16) & 0x7f,
+			(group >> 8) & 0xff,
+			group & 0xff,
+		}};
+		break;
+	case GR_AF_IP6:
+		l3.ipv6 = r->group.ipv6;
+		rte_ether_mcast_from_ipv6(&l3.mac, &r->group.ipv6);
+		break;
+	case GR_AF_UNSPEC:
+		return errno_set_null(EAFNOSUPPORT);
+	}
+
+	return nexthop_new(&base, &l3);
+}
+
+// Release the resources of entries that are no longer referenced by the hash
+// table. Key positions are recycled once all datapath workers have stopped
+// using them.
+static void mroute_free(gr_vec struct mroute_entry **entries, gr_vec int32_t *positions) {
+	const struct nexthop_info_l3 *l3;
+
+	if (gr_vec_len(entries) == 0 && gr_vec_len(positions) == 0)
+		return;
+
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+
+	gr_vec_foreach (int32_t pos, positions)
+		rte_hash_free_key_with_position(mroutes, pos);
+
+	gr_vec_foreach (struct mroute_entry *e, entries) {
+		l3 = nexthop_info_l3(e->nh);
+		if (e->iif != GR_IFACE_ID_UNDEF)
+			iface_del_eth_addr(e->iif, &l3->mac);
+		nexthop_decref(e->nh);
+		rte_free(e);
+	}
+}
+
+// Publish a new entry, replacing any existing one.
+static int mroute_publish(const struct mroute_key *key, struct mroute_entry *e) {
+	gr_vec struct mroute_entry **old = NULL;
+	const struct nexthop_info_l3 *l3;
+	void *data;
+	int ret;
+
+	if (rte_hash_lookup_data(mroutes, key, &data) >= 0) {
+		struct mroute_entry *prev = data;
+		atomic_init(&e->packets, atomic_load(&prev->packets));
+		atomic_init(&e->bytes, atomic_load(&prev->bytes));
+		gr_vec_add(old, prev);
+	}
+
+	// The input interface must accept frames sent to the group address.
+	l3 = nexthop_info_l3(e->nh);
+	if (e->iif != GR_IFACE_ID_UNDEF) {
+		ret = iface_add_eth_addr(e->iif, &l3->mac);
+		if (ret < 0 && ret != -EOPNOTSUPP) {
+			gr_vec_free(old);
+			return ret;
+		}
+	}
+
+	// Replacing the data of an existing key is atomic.
+	if ((ret = rte_hash_add_key_data(mroutes, key, e)) < 0) {
+		if (e->iif != GR_IFACE_ID_UNDEF)
+			iface_del_eth_addr(e->iif, &l3->mac);
+		gr_vec_free(old);
+		return errno_set(-ret);
+	}
+
+	mroute_free(old, NULL);
+	gr_vec_free(old);
+
+	return 0;
+}
+
+static struct api_out mroute_add(const void *request, struct api_ctx *) {
+	const struct gr_mroute_add_req *req = request;
+	const struct gr_mroute *r = &req->mroute;
+	struct mroute_entry *e;
+	struct mroute_key key;
+	struct nexthop *nh;
+
+	if (mroute_validate(r) < 0)
+		return api_out(errno, 0, NULL);
+
+	mroute_key_init(&key, r->vrf_id, r->af, &r->src, &r->group);
+	if (rte_hash_lookup(mroutes, &key) >= 0 && !req->exist_ok)
+		return api_out(EEXIST, 0, NULL);
+
+	e = rte_zmalloc(__func__, sizeof(*e), RTE_CACHE_LINE_SIZE);
+	if (e == NULL)
+		return api_out(ENOMEM, 0, NULL);
+
+	if ((nh = mroute_nh_get(r)) == NULL) {
+		rte_free(e);
+		return api_out(errno, 0, NULL);
+	}
+	nexthop_incref(nh);
+
+	e->nh = nh;
+	e->flags = r->flags;
+	e->iif = r->iif;
+	e->n_oifs = r->n_oifs;
+	memcpy(e->oifs, r->oifs, r->n_oifs * sizeof(*r->oifs));
+
+	if (mroute_publish(&key, e) < 0) {
+		nexthop_decref(nh);
+		rte_free(e);
+		return api_out(errno, 0, NULL);
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out mroute_del(const void *request, struct api_ctx *) {
+	const struct gr_mroute_del_req *req = request;
+	gr_vec struct mroute_entry **entries = NULL;
+	gr_vec int32_t *positions = NULL;
+	struct mroute_key key;
+	void *data;
+
+	mroute_key_init(&key, req->vrf_id, req->af, &req->src, &req->group);
+	if (rte_hash_lookup_data(mroutes, &key, &data) < 0) {
+		if (req->missing_ok)
+			return api_out(0, 0, NULL);
+		return api_out(ENOENT, 0, NULL);
+	}
+
+	gr_vec_add(positions, rte_hash_del_key(mroutes, &key));
+	gr_vec_add(entries, data);
+	mroute_free(entries, positions);
+	gr_vec_free(positions);
+	gr_vec_free(entries);
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out mroute_list(const void *request, struct api_ctx *ctx) {
+	const struct gr_mroute_list_req *req = request;
+	const struct mroute_key *key;
+	const struct mroute_entry *e;
+	uint32_t iter = 0;
+	void *data;
+
+	while (rte_hash_iterate(mroutes, (const void **)&key, &data, &iter) >= 0) {
+		if (req->vrf_id != GR_VRF_ID_ALL && key->vrf_id != req->vrf_id)
+			continue;
+		if (req->af != GR_AF_UNSPEC && key->af != req->af)
+			continue;
+
+		e = data;
+		struct gr_mroute r = {
+			.vrf_id = key->vrf_id,
+			.af = key->af,
+			.flags = e->flags,
+			.src = key->src,
+			.group = key->group,
+			.iif = e->iif,
+			.n_oifs = e->n_oifs,
+			.packets = atomic_load(&e->packets),
+			.bytes = atomic_load(&e->bytes),
+		};
+		memcpy(r.oifs, e->oifs, e->n_oifs * sizeof(*e->oifs));
+		api_send(ctx, sizeof(r), &r);
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+// Remove an interface from all entries that reference it. Entries for which
+// it is the input interface are deleted.
+static void iface_pre_remove_cb(uint32_t /*event*/, const void *obj) {
+	gr_vec struct mroute_key *del_keys = NULL, *upd_keys = NULL;
+	gr_vec struct mroute_entry **entries = NULL;
+	gr_vec int32_t *positions = NULL;
+	const struct iface *iface = obj;
+	const struct mroute_key *key;
+	struct mroute_entry *e, *n;
+	uint32_t iter = 0;
+	void *data;
+
+	// Do not modify the table while iterating over it.
+	while (rte_hash_iterate(mroutes, (const void **)&key, &data, &iter) >= 0) {
+		e = data;
+		if (e->iif == iface->id) {
+			gr_vec_add(del_keys, *key);
+			continue;
+		}
+		for (uint16_t i = 0; i < e->n_oifs; i++) {
+			if (e->oifs[i] == iface->id) {
+				gr_vec_add(upd_keys, *key);
+				break;
+			}
+		}
+	}
+
+	gr_vec_foreach_ref (key, del_keys) {
+		if (rte_hash_lookup_data(mroutes, key, &data) < 0)
+			continue;
+		gr_vec_add(positions, rte_hash_del_key(mroutes, key));
+		gr_vec_add(entries, data);
+	}
+
+	gr_vec_foreach_ref (key, upd_keys) {
+		if (rte_hash_lookup_data(mroutes, key, &data) < 0)
+			continue;
+		e = data;
+		n = rte_malloc(__func__, sizeof(*n), RTE_CACHE_LINE_SIZE);
+		if (n == NULL) {
+			LOG(ERR, "rte_malloc: %s", strerror(ENOMEM));
+			continue;
+		}
+		memcpy(n, e, sizeof(*n));
+		n->n_oifs = 0;
+		for (uint16_t i = 0; i < e->n_oifs; i++) {
+			if (e->oifs[i] != iface->id)
+				n->oifs[n->n_oifs++] = e->oifs[i];
+		}
+		nexthop_incref(n->nh);
+		if (mroute_publish(key, n) < 0) {
+			LOG(ERR, "mroute_publish: %s", strerror(errno));
+			nexthop_decref(n->nh);
+			rte_free(n);
+		}
+	}
+
+	mroute_free(entries, positions);
+
+	gr_vec_free(del_keys);
+	gr_vec_free(upd_keys);
+	gr_vec_free(positions);
+	gr_vec_free(entries);
+}
+
+static void mroute_init(struct event_base *) {
+	mroutes = rte_hash_create(&(struct rte_hash_parameters) {
+		.name = "mroute",
+		.entries = MROUTE_MAX_ENTRIES,
+		.key_len = sizeof(struct mroute_key),
+		.socket_id = SOCKET_ID_ANY,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF,
+	});
+	if (mroutes == NULL)
+		ABORT("rte_hash_create(mroute): %s", rte_strerror(rte_errno));
+}
+
+static void mroute_fini(struct event_base *) {
+	const void *key;
+	uint32_t iter = 0;
+	void *data;
+
+	while (rte_hash_iterate(mroutes, &key, &data, &iter) >= 0) {
+		struct mroute_entry *e = data;
+		nexthop_decref(e->nh);
+		rte_free(e);
+	}
+	rte_hash_free(mroutes);
+	mroutes = NULL;
+}
+
+static struct gr_api_handler mroute_add_handler = {
+	.name = "mroute add",
+	.request_type = GR_MROUTE_ADD,
+	.callback = mroute_add,
+};
+static struct gr_api_handler mroute_del_handler = {
+	.name = "mroute del",
+	.request_type = GR_MROUTE_DEL,
+	.callback = mroute_del,
+};
+static struct gr_api_handler mroute_list_handler = {
+	.name = "mroute list",
+	.request_type = GR_MROUTE_LIST,
+	.callback = mroute_list,
+};
+
+static struct gr_event_subscription iface_pre_remove_subscription = {
+	.callback = iface_pre_remove_cb,
+	.ev_count = 1,
+	.ev_types = {GR_EVENT_IFACE_PRE_REMOVE},
+};
+
+static struct gr_module mroute_module = {
+	.name = "mroute",
+	.depends_on = "nexthop",
+	.init = mroute_init,
+	.fini = mroute_fini,
+};
+
+RTE_INIT(mroute_constructor) {
+	gr_register_api_handler(&mroute_add_handler);
+	gr_register_api_handler(&mroute_del_handler);
+	gr_register_api_handler(&mroute_list_handler);
+	gr_event_subscribe(&iface_pre_remove_subscription);
+	gr_register_module(&mroute_module);
+}
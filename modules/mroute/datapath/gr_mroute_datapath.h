@@ -0,0 +1,10 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_mbuf.h>
+#include <gr_mroute_control.h>
+
+// Set by ip_input and ip6_input when a multicast forwarding entry matches.
+GR_MBUF_PRIV_DATA_TYPE(mroute_mbuf_data, { struct mroute_entry *mr; });
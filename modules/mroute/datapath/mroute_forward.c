@@ -0,0 +1,283 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_ip4_datapath.h>
+#include <gr_ip6_datapath.h>
+#include <gr_mbuf.h>
+#include <gr_mroute_datapath.h>
+#include <gr_trace.h>
+
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+#include <rte_tcp.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+enum {
+	OUTPUT = 0,
+	LOCAL,
+	RPF_FAIL,
+	TTL_EXCEEDED,
+	NO_OIF,
+	EDGE_COUNT,
+};
+
+struct trace_mroute_data {
+	uint16_t iif;
+	uint16_t oif;
+};
+
+static int trace_mroute_format(char *buf, size_t len, const void *data, size_t /*data_len*/) {
+	const struct trace_mroute_data *t = data;
+	const struct iface *iif = iface_from_id(t->iif);
+	const struct iface *oif = iface_from_id(t->oif);
+	return snprintf(
+		buf,
+		len,
+		"iif=%s oif=%s",
+		iif ? iif->name : "[deleted]",
+		oif ? oif->name : (t->oif == GR_IFACE_ID_UNDEF ? "[none]" : "[deleted]")
+	);
+}
+
+// Build a replica of a packet that shares its payload with the original.
+//
+// The network header and the start of the transport header are copied into
+// a new direct mbuf which is chained to an indirect mbuf that references the
+// rest of the original packet. Each replica can then have its own link layer
+// header prepended and its addresses or ports rewritten by source NAT in
+// ip_output without touching the data that is shared with the other replicas.
+static struct rte_mbuf *mcast_replicate(struct rte_mbuf *m, uint16_t hdr_len) {
+	struct rte_mbuf *hdr, *payload;
+	void *data;
+
+	// NAT only rewrites the TCP, UDP or ICMP header which all fit in the
+	// fixed part of a TCP header.
+	hdr_len = RTE_MIN(rte_pktmbuf_pkt_len(m), hdr_len + sizeof(struct rte_tcp_hdr));
+	if (unlikely(rte_pktmbuf_data_len(m) < hdr_len))
+		return NULL;
+
+	if ((hdr = rte_pktmbuf_alloc(m->pool)) == NULL)
+		return NULL;
+
+	data = rte_pktmbuf_append(hdr, hdr_len);
+	if (unlikely(data == NULL))
+		goto fail;
+	memcpy(data, rte_pktmbuf_mtod(m, void *), hdr_len);
+	hdr->packet_type = m->packet_type;
+
+	if (rte_pktmbuf_pkt_len(m) > hdr_len) {
+		if ((payload = rte_pktmbuf_clone(m, m->pool)) == NULL)
+			goto fail;
+		rte_pktmbuf_adj(payload, hdr_len);
+		if (rte_pktmbuf_chain(hdr, payload) < 0) {
+			rte_pktmbuf_free(payload);
+			goto fail;
+		}
+	}
+
+	return hdr;
+fail:
+	rte_pktmbuf_free(hdr);
+	return NULL;
+}
+
+static inline void mcast_output(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	struct rte_mbuf *m,
+	const struct nexthop *nh,
+	const struct iface *iif,
+	const struct iface *oif,
+	addr_family_t af,
+	bool traced
+) {
+	// Multicast nexthops are not bound to any interface. ip_output and
+	// ip6_output use the interface stored in the mbuf instead.
+	if (af == GR_AF_IP4) {
+		ip_output_mbuf_data(m)->iface = oif;
+		ip_output_mbuf_data(m)->nh = nh;
+	} else {
+		ip6_output_mbuf_data(m)->iface = oif;
+		ip6_output_mbuf_data(m)->nh = nh;
+	}
+
+	// Replicas do not share the trace items of the original mbuf.
+	if (traced) {
+		struct trace_mroute_data *t = gr_mbuf_trace_add(m, node, sizeof(*t));
+		t->iif = iif->id;
+		t->oif = oif->id;
+	}
+	rte_node_enqueue_x1(graph, node, OUTPUT, m);
+}
+
+static inline uint16_t mcast_forward(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs,
+	addr_family_t af
+) {
+	const struct iface *iif, *oif, *out;
+	struct rte_ipv4_hdr *ip4;
+	struct rte_ipv6_hdr *ip6;
+	struct mroute_entry *mr;
+	struct rte_mbuf *m, *c;
+	uint16_t hdr_len;
+	rte_edge_t edge;
+	bool traced;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		m = objs[i];
+		mr = mroute_mbuf_data(m)->mr;
+		iif = mroute_mbuf_data(m)->iface;
+		traced = gr_mbuf_is_traced(m);
+
+		// Reverse path forwarding check.
+		if (mr->iif != GR_IFACE_ID_UNDEF && mr->iif != iif->id) {
+			edge = RPF_FAIL;
+			goto drop;
+		}
+
+		atomic_fetch_add_explicit(&mr->packets, 1, memory_order_relaxed);
+		atomic_fetch_add_explicit(&mr->bytes, rte_pktmbuf_pkt_len(m), memory_order_relaxed);
+
+		if (mr->flags & GR_MROUTE_F_LOCAL) {
+			// The local stack may modify the packet, give it a private copy.
+			c = rte_pktmbuf_copy(m, m->pool, 0, UINT32_MAX);
+			if (c != NULL) {
+				mbuf_data(c)->iface = iif;
+				if (traced) {
+					struct trace_mroute_data *t;
+					t = gr_mbuf_trace_add(c, node, sizeof(*t));
+					t->iif = iif->id;
+					t->oif = GR_IFACE_ID_UNDEF;
+				}
+				rte_node_enqueue_x1(graph, node, LOCAL, c);
+			}
+		}
+
+		// The header is updated once and copied in all replicas.
+		if (af == GR_AF_IP4) {
+			rte_be32_t csum;
+			ip4 = rte_pktmbuf_mtod(m, struct rte_ipv4_hdr *);
+			if (ip4->time_to_live <= 1) {
+				edge = TTL_EXCEEDED;
+				goto drop;
+			}
+			ip4->time_to_live -= 1;
+			csum = ip4->hdr_checksum + RTE_BE16(0x0100);
+			csum += csum >= 0xffff;
+			ip4->hdr_checksum = csum;
+			hdr_len = rte_ipv4_hdr_len(ip4);
+		} else {
+			ip6 = rte_pktmbuf_mtod(m, struct rte_ipv6_hdr *);
+			if (ip6->hop_limits <= 1) {
+				edge = TTL_EXCEEDED;
+				goto drop;
+			}
+			ip6->hop_limits -= 1;
+			hdr_len = sizeof(*ip6);
+		}
+
+		// The original mbuf is sent to the last output interface.
+		out = NULL;
+		for (uint16_t j = 0; j < mr->n_oifs; j++) {
+			oif = iface_from_id(mr->oifs[j]);
+			if (oif == NULL || oif == iif || !(oif->flags & GR_IFACE_F_UP))
+				continue;
+			if (out != NULL) {
+				c = mcast_replicate(m, hdr_len);
+				if (unlikely(c == NULL))
+					break;
+				mcast_output(graph, node, c, mr->nh, iif, out, af, traced);
+			}
+			out = oif;
+		}
+		if (out != NULL) {
+			mcast_output(graph, node, m, mr->nh, iif, out, af, traced);
+			continue;
+		}
+		edge = NO_OIF;
+drop:
+		if (traced) {
+			struct trace_mroute_data *t = gr_mbuf_trace_add(m, node, sizeof(*t));
+			t->iif = iif->id;
+			t->oif = GR_IFACE_ID_UNDEF;
+		}
+		rte_node_enqueue_x1(graph, node, edge, m);
+	}
+
+	return nb_objs;
+}
+
+static uint16_t ip_mcast_forward_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs
+) {
+	return mcast_forward(graph, node, objs, nb_objs, GR_AF_IP4);
+}
+
+static uint16_t ip6_mcast_forward_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs
+) {
+	return mcast_forward(graph, node, objs, nb_objs, GR_AF_IP6);
+}
+
+static struct rte_node_register ip_mcast_forward_node = {
+	.name = "ip_mcast_forward",
+
+	.process = ip_mcast_forward_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[OUTPUT] = "ip_output",
+		[LOCAL] = "ip_input_local",
+		[RPF_FAIL] = "ip_mcast_forward_rpf_fail",
+		[TTL_EXCEEDED] = "ip_mcast_forward_ttl_exceeded",
+		[NO_OIF] = "ip_mcast_forward_no_oif",
+	},
+};
+
+static struct rte_node_register ip6_mcast_forward_node = {
+	.name = "ip6_mcast_forward",
+
+	.process = ip6_mcast_forward_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[OUTPUT] = "ip6_output",
+		[LOCAL] = "ip6_input_local",
+		[RPF_FAIL] = "ip6_mcast_forward_rpf_fail",
+		[TTL_EXCEEDED] = "ip6_mcast_forward_hop_limit_exceeded",
+		[NO_OIF] = "ip6_mcast_forward_no_oif",
+	},
+};
+
+static struct gr_node_info ip_mcast_forward_info = {
+	.node = &ip_mcast_forward_node,
+	.trace_format = trace_mroute_format,
+};
+
+static struct gr_node_info ip6_mcast_forward_info = {
+	.node = &ip6_mcast_forward_node,
+	.trace_format = trace_mroute_format,
+};
+
+GR_NODE_REGISTER(ip_mcast_forward_info);
+GR_NODE_REGISTER(ip6_mcast_forward_info);
+
+GR_DROP_REGISTER(ip_mcast_forward_rpf_fail);
+GR_DROP_REGISTER(ip_mcast_forward_ttl_exceeded);
+GR_DROP_REGISTER(ip_mcast_forward_no_oif);
+GR_DROP_REGISTER(ip6_mcast_forward_rpf_fail);
+GR_DROP_REGISTER(ip6_mcast_forward_hop_limit_exceeded);
+GR_DROP_REGISTER(ip6_mcast_forward_no_oif);
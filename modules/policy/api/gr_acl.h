@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_api.h>
+#include <gr_macro.h>
+#include <gr_net_types.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GR_ACL_MODULE 0xac1e
+
+// Maximum number of rules per interface and direction.
+#define GR_ACL_MAX_RULES 65536
+
+// Special DSCP value that matches all packets.
+#define GR_ACL_DSCP_ANY 0xff
+
+typedef enum : uint8_t {
+	GR_ACL_DIR_IN = 0,
+	GR_ACL_DIR_OUT,
+	GR_ACL_DIR_COUNT,
+} gr_acl_dir_t;
+
+typedef enum : uint8_t {
+	GR_ACL_PERMIT = 0,
+	GR_ACL_DENY,
+} gr_acl_action_t;
+
+static inline const char *gr_acl_dir_name(gr_acl_dir_t dir) {
+	switch (dir) {
+	case GR_ACL_DIR_IN:
+		return "in";
+	case GR_ACL_DIR_OUT:
+		return "out";
+	case GR_ACL_DIR_COUNT:
+		break;
+	}
+	return "?";
+}
+
+static inline const char *gr_acl_action_name(gr_acl_action_t action) {
+	switch (action) {
+	case GR_ACL_PERMIT:
+		return "permit";
+	case GR_ACL_DENY:
+		return "deny";
+	}
+	return "?";
+}
+
+union gr_acl_net {
+	struct ip4_net ip4;
+	struct ip6_net ip6;
+};
+
+// Packet match criteria, shared with policy based routing rules.
+//
+// IPv4 criteria are only evaluated against IPv4 packets and IPv6 criteria
+// against IPv6 packets.
+struct gr_acl_match {
+	addr_family_t af;
+	uint8_t proto; //!< IP protocol number, 0 matches any protocol.
+	uint8_t dscp; //!< GR_ACL_DSCP_ANY matches any value.
+	union gr_acl_net src;
+	union gr_acl_net dst;
+	//! Port ranges are only matched for TCP, UDP and SCTP packets. Use 0-65535
+	//! to match all packets, including non-first fragments.
+	uint16_t sport_min;
+	uint16_t sport_max;
+	uint16_t dport_min;
+	uint16_t dport_max;
+};
+
+// Stateless filtering rule.
+//
+// Rules are evaluated in ascending sequence number order and the first match
+// wins. Packets that do not match any rule are permitted.
+struct gr_acl_rule {
+	uint32_t seq; //!< Unique per interface and direction.
+	gr_acl_action_t action;
+	BASE(gr_acl_match);
+	uint64_t packets; //!< Number of matched packets (ignored on add).
+};
+
+// acl rules ///////////////////////////////////////////////////////////////////
+
+// Insert rules in the set of an interface for the given direction.
+//
+// The classifier is compiled once per request and replaces the previous one
+// atomically. Large rule sets should be sent in batches of as many rules as
+// a single message allows.
+#define GR_ACL_RULE_ADD REQUEST_TYPE(GR_ACL_MODULE, 0x0001)
+
+struct gr_acl_rule_add_req {
+	uint16_t iface_id;
+	gr_acl_dir_t dir;
+	bool exist_ok;
+	uint16_t n_rules;
+	struct gr_acl_rule rules[/* n_rules */];
+};
+
+// struct gr_acl_rule_add_resp { };
+
+#define GR_ACL_RULE_DEL REQUEST_TYPE(GR_ACL_MODULE, 0x0002)
+
+struct gr_acl_rule_del_req {
+	uint16_t iface_id;
+	gr_acl_dir_t dir;
+	uint32_t seq;
+	bool missing_ok;
+};
+
+// struct gr_acl_rule_del_resp { };
+
+// Remove all rules of an interface for the given direction.
+#define GR_ACL_FLUSH REQUEST_TYPE(GR_ACL_MODULE, 0x0003)
+
+struct gr_acl_flush_req {
+	uint16_t iface_id;
+	gr_acl_dir_t dir;
+};
+
+// struct gr_acl_flush_resp { };
+
+#define GR_ACL_LIST REQUEST_TYPE(GR_ACL_MODULE, 0x0004)
+
+struct gr_acl_list_req {
+	uint16_t iface_id; //!< GR_IFACE_ID_UNDEF for all interfaces.
+};
+
+struct gr_acl_entry {
+	uint16_t iface_id;
+	gr_acl_dir_t dir;
+	struct gr_acl_rule rule;
+};
+
+// STREAM(struct gr_acl_entry);
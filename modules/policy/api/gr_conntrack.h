@@ -104,6 +104,29 @@ struct gr_conntrack_config {
 	uint32_t timeout_half_close_sec;
 	//! TCP time-wait state. (default: 30 sec).
 	uint32_t timeout_time_wait_sec;
+	//! Maximum number of connections per source address (default: unlimited).
+	uint32_t max_per_source;
+	//! Maximum number of connections per interface (default: unlimited).
+	uint32_t max_per_iface;
+	//! Table usage percentage above which embryonic then idle connections
+	//! are evicted to make room for new ones (default: 90%).
+	uint32_t early_drop_threshold;
+};
+
+//! Use this value in set requests to remove a per-source or per-interface limit.
+#define GR_CONNTRACK_UNLIMITED UINT32_MAX
+
+struct gr_conntrack_stats {
+	//! New connections refused because of the per-source limit.
+	uint64_t source_limit_drops;
+	//! New connections refused because of the per-interface limit.
+	uint64_t iface_limit_drops;
+	//! New connections refused because the table was full.
+	uint64_t table_full_drops;
+	//! Embryonic connections evicted when the table was under pressure.
+	uint64_t early_drop_embryonic;
+	//! Idle connections evicted when the table was under pressure.
+	uint64_t early_drop_idle;
 };
 
 #define GR_CONNTRACK_CONF_GET REQUEST_TYPE(GR_CONNTRACK_MODULE, 0x0003)
@@ -113,6 +136,7 @@ struct gr_conntrack_config {
 struct gr_conntrack_conf_get_resp {
 	BASE(gr_conntrack_config);
 	uint32_t used_count;
+	struct gr_conntrack_stats stats;
 };
 
 #define GR_CONNTRACK_CONF_SET REQUEST_TYPE(GR_CONNTRACK_MODULE, 0x0004)
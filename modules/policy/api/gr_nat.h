@@ -59,6 +59,10 @@ struct gr_snat44_policy {
 	uint16_t iface_id;
 	struct ip4_net net;
 	ip4_addr_t replace;
+	//! Reuse the same external port for all destinations of an internal
+	//! endpoint and accept traffic from any remote endpoint (RFC 4787 full-cone).
+	//! Applies to TCP and UDP only.
+	bool endpoint_independent;
 };
 
 #define GR_SNAT44_ADD REQUEST_TYPE(GR_NAT_MODULE, 0x0011)
@@ -84,3 +88,74 @@ struct gr_snat44_del_req {
 // struct gr_snat44_list_req { };
 
 // STREAM(struct gr_snat44_policy);
+
+// snat44 session logging //////////////////////////////////////////////////////
+
+#define GR_SNAT44_LOG_PATH_SIZE 256
+
+struct gr_snat44_log_config {
+	bool enabled;
+	//! Path of the current log file. Rotated files get a .1, .2, ... suffix.
+	char path[GR_SNAT44_LOG_PATH_SIZE];
+	//! Rotate the current file when it exceeds this size (default: 64 MiB).
+	uint32_t max_file_size;
+	//! Number of rotated files to keep (default: 8).
+	uint16_t max_files;
+};
+
+struct gr_snat44_log_stats {
+	//! Records written to files.
+	uint64_t records;
+	//! Records lost because a worker ring was full or did not exist yet.
+	uint64_t lost;
+	//! Records lost because of file write errors.
+	uint64_t write_errors;
+	//! Number of file rotations.
+	uint64_t rotations;
+};
+
+#define GR_SNAT44_LOG_CONF_GET REQUEST_TYPE(GR_NAT_MODULE, 0x0021)
+
+// struct gr_snat44_log_conf_get_req { };
+
+struct gr_snat44_log_conf_get_resp {
+	BASE(gr_snat44_log_config);
+	struct gr_snat44_log_stats stats;
+};
+
+#define GR_SNAT44_LOG_CONF_SET REQUEST_TYPE(GR_NAT_MODULE, 0x0022)
+
+//! Empty path and zero values are left unchanged.
+struct gr_snat44_log_conf_set_req {
+	BASE(gr_snat44_log_config);
+};
+
+// struct gr_snat44_log_conf_set_resp { };
+
+// Log files start with this header, followed by fixed size records.
+#define GR_SNAT44_LOG_MAGIC 0x4c54414e // "NATL" on little endian hosts
+#define GR_SNAT44_LOG_VERSION 1
+
+struct gr_snat44_log_header {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t record_size;
+};
+
+typedef enum : uint8_t {
+	GR_SNAT44_LOG_BIND = 1,
+	GR_SNAT44_LOG_UNBIND,
+} gr_snat44_log_event_t;
+
+// Records are written in host byte order except addresses and ports.
+// Records of different workers are not interleaved in timestamp order.
+struct gr_snat44_log_record {
+	uint64_t timestamp; //!< Microseconds since the Unix epoch.
+	ip4_addr_t inside_addr;
+	ip4_addr_t outside_addr;
+	uint16_t inside_port; //!< Network byte order. ICMP identifier for ICMP.
+	uint16_t outside_port; //!< Network byte order.
+	uint16_t vrf_id;
+	uint8_t proto;
+	gr_snat44_log_event_t event;
+};
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_acl.h>
+#include <gr_api.h>
+#include <gr_macro.h>
+#include <gr_net_types.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GR_PBR_MODULE 0xb0b0
+
+// Maximum number of rules per interface.
+#define GR_PBR_MAX_RULES 65536
+
+typedef enum : uint8_t {
+	GR_PBR_ACTION_VRF = 1, //!< Lookup the destination address in another VRF.
+	GR_PBR_ACTION_NEXTHOP, //!< Forward to a nexthop (including SRv6 policies).
+} gr_pbr_action_t;
+
+static inline const char *gr_pbr_action_name(gr_pbr_action_t action) {
+	switch (action) {
+	case GR_PBR_ACTION_VRF:
+		return "vrf";
+	case GR_PBR_ACTION_NEXTHOP:
+		return "nexthop";
+	}
+	return "?";
+}
+
+// Policy based routing rule.
+//
+// Rules only apply to packets received on the interface they are attached to,
+// including packets for which there is no route. Packets destined to the
+// router itself are never affected.
+//
+// Rules are evaluated in ascending sequence number order and the first match
+// wins. Packets that do not match any rule are routed normally.
+struct gr_pbr_rule {
+	uint32_t seq; //!< Unique per interface.
+	gr_pbr_action_t action;
+	BASE(gr_acl_match);
+	union {
+		uint16_t vrf_id; //!< GR_PBR_ACTION_VRF
+		uint32_t nh_id; //!< GR_PBR_ACTION_NEXTHOP
+	};
+	uint64_t packets; //!< Number of matched packets (ignored on add).
+};
+
+// pbr rules ///////////////////////////////////////////////////////////////////
+
+// Insert rules in the set of an interface.
+//
+// The classifier is compiled once per request and replaces the previous one
+// atomically. Large rule sets should be sent in batches of as many rules as
+// a single message allows.
+#define GR_PBR_RULE_ADD REQUEST_TYPE(GR_PBR_MODULE, 0x0001)
+
+struct gr_pbr_rule_add_req {
+	uint16_t iface_id;
+	bool exist_ok;
+	uint16_t n_rules;
+	struct gr_pbr_rule rules[/* n_rules */];
+};
+
+// struct gr_pbr_rule_add_resp { };
+
+#define GR_PBR_RULE_DEL REQUEST_TYPE(GR_PBR_MODULE, 0x0002)
+
+struct gr_pbr_rule_del_req {
+	uint16_t iface_id;
+	uint32_t seq;
+	bool missing_ok;
+};
+
+// struct gr_pbr_rule_del_resp { };
+
+// Remove all rules of an interface.
+#define GR_PBR_FLUSH REQUEST_TYPE(GR_PBR_MODULE, 0x0003)
+
+struct gr_pbr_flush_req {
+	uint16_t iface_id;
+};
+
+// struct gr_pbr_flush_resp { };
+
+#define GR_PBR_LIST REQUEST_TYPE(GR_PBR_MODULE, 0x0004)
+
+struct gr_pbr_list_req {
+	uint16_t iface_id; //!< GR_IFACE_ID_UNDEF for all interfaces.
+};
+
+struct gr_pbr_entry {
+	uint16_t iface_id;
+	struct gr_pbr_rule rule;
+};
+
+// STREAM(struct gr_pbr_entry);
@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_api.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GR_QOS_MODULE 0x0c05
+
+typedef enum : uint8_t {
+	GR_COLOR_GREEN = 0,
+	GR_COLOR_YELLOW,
+	GR_COLOR_RED,
+	GR_COLOR_COUNT,
+} gr_color_t;
+
+static inline const char *gr_color_name(gr_color_t color) {
+	switch (color) {
+	case GR_COLOR_GREEN:
+		return "green";
+	case GR_COLOR_YELLOW:
+		return "yellow";
+	case GR_COLOR_RED:
+		return "red";
+	case GR_COLOR_COUNT:
+		break;
+	}
+	return "?";
+}
+
+typedef enum : uint8_t {
+	GR_POLICER_SRTCM = 1, //!< Single rate three color marker (RFC 2697).
+	GR_POLICER_TRTCM, //!< Two rate three color marker (RFC 2698).
+} gr_policer_mode_t;
+
+static inline const char *gr_policer_mode_name(gr_policer_mode_t mode) {
+	switch (mode) {
+	case GR_POLICER_SRTCM:
+		return "srtcm";
+	case GR_POLICER_TRTCM:
+		return "trtcm";
+	}
+	return "?";
+}
+
+typedef enum : uint8_t {
+	GR_POLICER_PASS = 0, //!< Let packets through unmodified.
+	GR_POLICER_DROP,
+	GR_POLICER_REMARK, //!< Rewrite the DSCP field of IP packets.
+} gr_policer_action_t;
+
+struct gr_policer_action {
+	gr_policer_action_t action;
+	uint8_t dscp; //!< GR_POLICER_REMARK
+};
+
+struct gr_policer_conf {
+	gr_policer_mode_t mode;
+	uint64_t cir; //!< Committed information rate in bits per second.
+	uint64_t cbs; //!< Committed burst size in bytes.
+	uint64_t ebs; //!< Excess burst size in bytes (srTCM only).
+	uint64_t pir; //!< Peak information rate in bits per second (trTCM only).
+	uint64_t pbs; //!< Peak burst size in bytes (trTCM only).
+	struct gr_policer_action actions[GR_COLOR_COUNT];
+};
+
+struct gr_color_stats {
+	uint64_t packets;
+	uint64_t bytes;
+};
+
+// policers ////////////////////////////////////////////////////////////////////
+
+// Attach an ingress policer to an interface or replace the existing one.
+//
+// IPv4 and IPv6 packets received on the interface are metered in color blind
+// mode and the action associated with their color is applied before any
+// other processing (including ACLs). Policers can be attached to VLAN
+// sub-interfaces to police each VLAN separately.
+#define GR_QOS_POLICER_SET REQUEST_TYPE(GR_QOS_MODULE, 0x0001)
+
+struct gr_qos_policer_set_req {
+	uint16_t iface_id;
+	struct gr_policer_conf conf;
+};
+
+// struct gr_qos_policer_set_resp { };
+
+#define GR_QOS_POLICER_DEL REQUEST_TYPE(GR_QOS_MODULE, 0x0002)
+
+struct gr_qos_policer_del_req {
+	uint16_t iface_id;
+	bool missing_ok;
+};
+
+// struct gr_qos_policer_del_resp { };
+
+#define GR_QOS_POLICER_LIST REQUEST_TYPE(GR_QOS_MODULE, 0x0003)
+
+struct gr_qos_policer_list_req {
+	uint16_t iface_id; //!< GR_IFACE_ID_UNDEF for all interfaces.
+};
+
+struct gr_qos_policer {
+	uint16_t iface_id;
+	struct gr_policer_conf conf;
+	struct gr_color_stats stats[GR_COLOR_COUNT];
+};
+
+// STREAM(struct gr_qos_policer);
+
+// egress scheduler ////////////////////////////////////////////////////////////
+
+// Maximum number of subscribers per port. Subscribers are VLAN
+// sub-interfaces, untagged traffic and VLANs without a subscriber
+// configuration share the default subscriber.
+#define GR_QOS_MAX_SUBSCRIBERS 4096
+
+// Maximum number of distinct subscriber rates per port.
+#define GR_QOS_MAX_PROFILES 256
+
+// Packets are assigned to a traffic class according to the class selector
+// bits of their DSCP field (dscp >> 3). Classes 7 to 2 are served in strict
+// priority order. Classes 1 and 0 share the remaining bandwidth with a 1:4
+// weighted round robin. Non-IP packets use class 0.
+#define GR_QOS_CLASS_COUNT 8
+
+struct gr_qos_sched_conf {
+	uint64_t rate; //!< Port rate in bits per second.
+	uint16_t n_subscribers; //!< Power of 2, including the default subscriber.
+	uint16_t qsize; //!< Power of 2, packets per class queue of each subscriber.
+};
+
+struct gr_qos_queue_stats {
+	uint64_t packets;
+	uint64_t bytes;
+	uint64_t dropped;
+};
+
+// Enable the hierarchical egress scheduler on a port or reconfigure it.
+//
+// Packets sent on the port and all its VLAN sub-interfaces are queued per
+// subscriber and traffic class and dequeued at the configured rate. All
+// queued packets are dropped on reconfiguration.
+#define GR_QOS_SCHED_SET REQUEST_TYPE(GR_QOS_MODULE, 0x0004)
+
+struct gr_qos_sched_set_req {
+	uint16_t iface_id;
+	struct gr_qos_sched_conf conf;
+};
+
+// struct gr_qos_sched_set_resp { };
+
+#define GR_QOS_SCHED_DEL REQUEST_TYPE(GR_QOS_MODULE, 0x0005)
+
+struct gr_qos_sched_del_req {
+	uint16_t iface_id;
+	bool missing_ok;
+};
+
+// struct gr_qos_sched_del_resp { };
+
+#define GR_QOS_SCHED_LIST REQUEST_TYPE(GR_QOS_MODULE, 0x0006)
+
+struct gr_qos_sched_list_req {
+	uint16_t iface_id; //!< GR_IFACE_ID_UNDEF for all ports.
+};
+
+struct gr_qos_sched {
+	uint16_t iface_id;
+	struct gr_qos_sched_conf conf;
+	struct gr_qos_queue_stats stats[GR_QOS_CLASS_COUNT];
+};
+
+// STREAM(struct gr_qos_sched);
+
+// Shape the egress traffic of a VLAN sub-interface.
+//
+// The configuration is kept when the scheduler of the parent port is
+// disabled and applied again when it is enabled.
+#define GR_QOS_SUBSCRIBER_SET REQUEST_TYPE(GR_QOS_MODULE, 0x0007)
+
+struct gr_qos_subscriber_set_req {
+	uint16_t iface_id;
+	uint64_t rate; //!< Bits per second.
+};
+
+// struct gr_qos_subscriber_set_resp { };
+
+#define GR_QOS_SUBSCRIBER_DEL REQUEST_TYPE(GR_QOS_MODULE, 0x0008)
+
+struct gr_qos_subscriber_del_req {
+	uint16_t iface_id;
+	bool missing_ok;
+};
+
+// struct gr_qos_subscriber_del_resp { };
+
+#define GR_QOS_SUBSCRIBER_LIST REQUEST_TYPE(GR_QOS_MODULE, 0x0009)
+
+struct gr_qos_subscriber_list_req {
+	uint16_t iface_id; //!< GR_IFACE_ID_UNDEF for all subscribers.
+};
+
+struct gr_qos_subscriber {
+	uint16_t iface_id;
+	uint64_t rate;
+	bool active; //!< The parent port scheduler is enabled.
+	struct gr_qos_queue_stats stats;
+};
+
+// STREAM(struct gr_qos_subscriber);
@@ -8,6 +8,9 @@
 #include <gr_nat_control.h>
 #include <gr_vec.h>
 
+#include <errno.h>
+#include <stdlib.h>
+
 static struct api_out snat44_add(const void *request, struct api_ctx *) {
 	const struct gr_snat44_add_req *req = request;
 	struct iface *iface;
@@ -51,6 +54,26 @@ static struct api_out snat44_list(const void * /*request*/, struct api_ctx *ctx)
 	return api_out(0, 0, NULL);
 }
 
+static struct api_out snat44_log_conf_get(const void * /*request*/, struct api_ctx *) {
+	struct gr_snat44_log_conf_get_resp *resp = calloc(1, sizeof(*resp));
+
+	if (resp == NULL)
+		return api_out(ENOMEM, 0, NULL);
+
+	snat44_log_config_get(resp);
+
+	return api_out(0, sizeof(*resp), resp);
+}
+
+static struct api_out snat44_log_conf_set(const void *request, struct api_ctx *) {
+	const struct gr_snat44_log_conf_set_req *req = request;
+	int ret;
+
+	ret = snat44_log_config_set(&req->base);
+
+	return api_out(-ret, 0, NULL);
+}
+
 static struct gr_api_handler add_handler = {
 	.name = "snat44 add",
 	.request_type = GR_SNAT44_ADD,
@@ -67,8 +90,21 @@ static struct gr_api_handler list_handler = {
 	.callback = snat44_list,
 };
 
+static struct gr_api_handler log_conf_get_handler = {
+	.name = "snat44 log config get",
+	.request_type = GR_SNAT44_LOG_CONF_GET,
+	.callback = snat44_log_conf_get,
+};
+static struct gr_api_handler log_conf_set_handler = {
+	.name = "snat44 log config set",
+	.request_type = GR_SNAT44_LOG_CONF_SET,
+	.callback = snat44_log_conf_set,
+};
+
 RTE_INIT(_init) {
 	gr_register_api_handler(&add_handler);
 	gr_register_api_handler(&del_handler);
 	gr_register_api_handler(&list_handler);
+	gr_register_api_handler(&log_conf_get_handler);
+	gr_register_api_handler(&log_conf_set_handler);
 }
@@ -0,0 +1,380 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_acl.h>
+#include <gr_api.h>
+#include <gr_cli.h>
+#include <gr_cli_acl.h>
+#include <gr_cli_iface.h>
+#include <gr_net_types.h>
+#include <gr_table.h>
+
+#include <ecoli.h>
+#include <libsmartcols.h>
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static int parse_iface_dir(
+	struct gr_api_client *c,
+	const struct ec_pnode *p,
+	uint16_t *iface_id,
+	gr_acl_dir_t *dir
+) {
+	struct gr_iface *iface = iface_from_name(c, arg_str(p, "IFACE"));
+
+	if (iface == NULL)
+		return -errno;
+	*iface_id = iface->id;
+	free(iface);
+
+	if (strcmp(arg_str(p, "DIR"), "out") == 0)
+		*dir = GR_ACL_DIR_OUT;
+	else
+		*dir = GR_ACL_DIR_IN;
+
+	return 0;
+}
+
+static int
+parse_port_range(const struct ec_pnode *p, const char *id, uint16_t *min, uint16_t *max) {
+	const char *str = arg_str(p, id);
+	unsigned lo, hi;
+
+	*min = 0;
+	*max = UINT16_MAX;
+	if (str == NULL)
+		return 0;
+
+	switch (sscanf(str, "%u-%u", &lo, &hi)) {
+	case 1:
+		hi = lo;
+		break;
+	case 2:
+		break;
+	default:
+		return errno_set(EINVAL);
+	}
+	if (lo > hi || hi > UINT16_MAX)
+		return errno_set(ERANGE);
+
+	*min = lo;
+	*max = hi;
+
+	return 0;
+}
+
+static int parse_proto(const struct ec_pnode *p, uint8_t *proto) {
+	const char *str = arg_str(p, "PROTO");
+	unsigned val;
+
+	*proto = 0;
+	if (str == NULL)
+		return 0;
+
+	if (strcmp(str, "tcp") == 0)
+		*proto = IPPROTO_TCP;
+	else if (strcmp(str, "udp") == 0)
+		*proto = IPPROTO_UDP;
+	else if (strcmp(str, "sctp") == 0)
+		*proto = IPPROTO_SCTP;
+	else if (strcmp(str, "icmp") == 0)
+		*proto = IPPROTO_ICMP;
+	else if (strcmp(str, "icmp6") == 0)
+		*proto = IPPROTO_ICMPV6;
+	else if (sscanf(str, "%u", &val) == 1 && val <= UINT8_MAX)
+		*proto = val;
+	else
+		return errno_set(EINVAL);
+
+	return 0;
+}
+
+static int parse_net(const struct ec_pnode *p, const char *id, addr_family_t *af, void *net) {
+	if (arg_str(p, id) == NULL)
+		return 0;
+
+	if (arg_ip_net(p, id, net, true, GR_AF_IP4) == 0) {
+		if (*af == GR_AF_IP6)
+			return errno_set(EAFNOSUPPORT);
+		*af = GR_AF_IP4;
+	} else if (arg_ip_net(p, id, net, true, GR_AF_IP6) == 0) {
+		if (*af == GR_AF_IP4)
+			return errno_set(EAFNOSUPPORT);
+		*af = GR_AF_IP6;
+	} else {
+		return -errno;
+	}
+
+	return 0;
+}
+
+int acl_match_parse(const struct ec_pnode *p, struct gr_acl_match *m) {
+	m->af = arg_str(p, "ip6") != NULL ? GR_AF_IP6 : GR_AF_UNSPEC;
+	if (parse_net(p, "SRC", &m->af, &m->src) < 0)
+		return -errno;
+	if (parse_net(p, "DST", &m->af, &m->dst) < 0)
+		return -errno;
+	if (m->af == GR_AF_UNSPEC)
+		m->af = GR_AF_IP4;
+
+	if (parse_proto(p, &m->proto) < 0)
+		return -errno;
+	if (arg_u8(p, "DSCP", &m->dscp) < 0) {
+		if (errno != ENOENT)
+			return -errno;
+		m->dscp = GR_ACL_DSCP_ANY;
+	}
+	if (parse_port_range(p, "SPORT", &m->sport_min, &m->sport_max) < 0)
+		return -errno;
+	if (parse_port_range(p, "DPORT", &m->dport_min, &m->dport_max) < 0)
+		return -errno;
+
+	return 0;
+}
+
+static cmd_status_t acl_add(struct gr_api_client *c, const struct ec_pnode *p) {
+	size_t len = sizeof(struct gr_acl_rule_add_req) + sizeof(struct gr_acl_rule);
+	struct gr_acl_rule_add_req *req = calloc(1, len);
+	struct gr_acl_rule *rule;
+	cmd_status_t ret = CMD_ERROR;
+
+	if (req == NULL)
+		return CMD_ERROR;
+
+	req->exist_ok = true;
+	req->n_rules = 1;
+	rule = &req->rules[0];
+
+	if (parse_iface_dir(c, p, &req->iface_id, &req->dir) < 0)
+		goto out;
+	if (arg_u32(p, "SEQ", &rule->seq) < 0)
+		goto out;
+	if (strcmp(arg_str(p, "ACTION"), "deny") == 0)
+		rule->action = GR_ACL_DENY;
+	else
+		rule->action = GR_ACL_PERMIT;
+
+	if (acl_match_parse(p, &rule->base) < 0)
+		goto out;
+
+	if (gr_api_client_send_recv(c, GR_ACL_RULE_ADD, len, req, NULL) < 0)
+		goto out;
+
+	ret = CMD_SUCCESS;
+out:
+	free(req);
+	return ret;
+}
+
+static cmd_status_t acl_del(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_acl_rule_del_req req = {.missing_ok = true};
+
+	if (parse_iface_dir(c, p, &req.iface_id, &req.dir) < 0)
+		return CMD_ERROR;
+	if (arg_u32(p, "SEQ", &req.seq) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_ACL_RULE_DEL, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t acl_flush(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_acl_flush_req req;
+
+	if (parse_iface_dir(c, p, &req.iface_id, &req.dir) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_ACL_FLUSH, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static void format_net(struct libscols_line *line, int col, addr_family_t af, const void *net) {
+	const struct ip4_net *n4 = net;
+	const struct ip6_net *n6 = net;
+
+	if (af == GR_AF_IP4 && n4->prefixlen > 0)
+		scols_line_sprintf(line, col, IP4_F "/%hhu", &n4->ip, n4->prefixlen);
+	else if (af == GR_AF_IP6 && n6->prefixlen > 0)
+		scols_line_sprintf(line, col, IP6_F "/%hhu", &n6->ip, n6->prefixlen);
+	else
+		scols_line_set_data(line, col, "*");
+}
+
+static void format_ports(struct libscols_line *line, int col, uint16_t min, uint16_t max) {
+	if (min == 0 && max == UINT16_MAX)
+		scols_line_set_data(line, col, "*");
+	else if (min == max)
+		scols_line_sprintf(line, col, "%u", min);
+	else
+		scols_line_sprintf(line, col, "%u-%u", min, max);
+}
+
+void acl_match_format(struct libscols_line *line, int col, const struct gr_acl_match *m) {
+	if (m->proto == 0)
+		scols_line_set_data(line, col, "*");
+	else
+		scols_line_sprintf(line, col, "%u", m->proto);
+	format_net(line, col + 1, m->af, &m->src);
+	format_net(line, col + 2, m->af, &m->dst);
+	format_ports(line, col + 3, m->sport_min, m->sport_max);
+	format_ports(line, col + 4, m->dport_min, m->dport_max);
+	if (m->dscp == GR_ACL_DSCP_ANY)
+		scols_line_set_data(line, col + 5, "*");
+	else
+		scols_line_sprintf(line, col + 5, "%u", m->dscp);
+}
+
+void acl_match_columns(struct libscols_table *table) {
+	scols_table_new_column(table, "PROTO", 0, 0);
+	scols_table_new_column(table, "SRC", 0, 0);
+	scols_table_new_column(table, "DST", 0, 0);
+	scols_table_new_column(table, "SPORT", 0, 0);
+	scols_table_new_column(table, "DPORT", 0, 0);
+	scols_table_new_column(table, "DSCP", 0, 0);
+}
+
+static cmd_status_t acl_list(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_acl_list_req req = {.iface_id = GR_IFACE_ID_UNDEF};
+	const struct gr_acl_entry *e;
+	struct gr_iface *iface;
+	int ret;
+
+	if (arg_str(p, "IFACE") != NULL) {
+		if ((iface = iface_from_name(c, arg_str(p, "IFACE"))) == NULL)
+			return CMD_ERROR;
+		req.iface_id = iface->id;
+		free(iface);
+	}
+
+	struct libscols_table *table = scols_new_table();
+	scols_table_new_column(table, "IFACE", 0, 0);
+	scols_table_new_column(table, "DIR", 0, 0);
+	scols_table_new_column(table, "SEQ", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "ACTION", 0, 0);
+	acl_match_columns(table);
+	scols_table_new_column(table, "PACKETS", 0, SCOLS_FL_RIGHT);
+	scols_table_set_column_separator(table, "  ");
+
+	gr_api_client_stream_foreach (e, ret, c, GR_ACL_LIST, sizeof(req), &req) {
+		struct libscols_line *line = scols_table_new_line(table, NULL);
+		const struct gr_acl_rule *r = &e->rule;
+
+		iface = iface_from_id(c, e->iface_id);
+		if (iface != NULL)
+			scols_line_sprintf(line, 0, "%s", iface->name);
+		else
+			scols_line_sprintf(line, 0, "%u", e->iface_id);
+		free(iface);
+
+		scols_line_set_data(line, 1, gr_acl_dir_name(e->dir));
+		scols_line_sprintf(line, 2, "%u", r->seq);
+		scols_line_set_data(line, 3, gr_acl_action_name(r->action));
+		acl_match_format(line, 4, &r->base);
+		scols_line_sprintf(line, 10, "%lu", r->packets);
+	}
+
+	scols_print_table(table);
+	scols_unref_table(table);
+
+	return ret < 0 ? CMD_ERROR : CMD_SUCCESS;
+}
+
+#define ACL_CTX(root) CLI_CONTEXT(root, CTX_ARG("acl", "Stateless packet filtering."))
+
+static int ctx_init(struct ec_node *root) {
+	int ret;
+
+	ret = CLI_COMMAND(
+		ACL_CTX(root),
+		"add iface IFACE DIR seq SEQ ACTION [" ACL_MATCH_CMD "]",
+		acl_add,
+		"Add or replace a filtering rule.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL)),
+		with_help(
+			"Traffic direction.",
+			EC_NODE_OR(
+				"DIR",
+				with_help("Received packets.", ec_node_str(EC_NO_ID, "in")),
+				with_help("Sent packets.", ec_node_str(EC_NO_ID, "out"))
+			)
+		),
+		with_help(
+			"Rule sequence number. Rules are evaluated in ascending order.",
+			ec_node_uint("SEQ", 0, UINT32_MAX, 10)
+		),
+		with_help(
+			"Action for matching packets.",
+			EC_NODE_OR(
+				"ACTION",
+				with_help("Let packets through.", ec_node_str(EC_NO_ID, "permit")),
+				with_help("Drop packets.", ec_node_str(EC_NO_ID, "deny"))
+			)
+		),
+		ACL_MATCH_ARGS
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		ACL_CTX(root),
+		"del iface IFACE DIR seq SEQ",
+		acl_del,
+		"Delete a filtering rule.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL)),
+		with_help(
+			"Traffic direction.",
+			EC_NODE_OR(
+				"DIR",
+				with_help("Received packets.", ec_node_str(EC_NO_ID, "in")),
+				with_help("Sent packets.", ec_node_str(EC_NO_ID, "out"))
+			)
+		),
+		with_help("Rule sequence number.", ec_node_uint("SEQ", 0, UINT32_MAX, 10))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		ACL_CTX(root),
+		"flush iface IFACE DIR",
+		acl_flush,
+		"Delete all filtering rules of an interface.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL)),
+		with_help(
+			"Traffic direction.",
+			EC_NODE_OR(
+				"DIR",
+				with_help("Received packets.", ec_node_str(EC_NO_ID, "in")),
+				with_help("Sent packets.", ec_node_str(EC_NO_ID, "out"))
+			)
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		ACL_CTX(root),
+		"[show] [iface IFACE]",
+		acl_list,
+		"Show filtering rules and their hit counters.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL))
+	);
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+static struct cli_context ctx = {
+	.name = "acl",
+	.init = ctx_init,
+};
+
+static void __attribute__((constructor, used)) init(void) {
+	cli_context_register(&ctx);
+}
@@ -110,6 +110,20 @@ static cmd_status_t config_show(struct gr_api_client *c, const struct ec_pnode *
 	printf("established-tcp-timeout %u\n", resp->timeout_tcp_established_sec);
 	printf("half-close-timeout %u\n", resp->timeout_half_close_sec);
 	printf("time-wait-timeout %u\n", resp->timeout_time_wait_sec);
+	if (resp->max_per_source == 0)
+		printf("max-per-source unlimited\n");
+	else
+		printf("max-per-source %u\n", resp->max_per_source);
+	if (resp->max_per_iface == 0)
+		printf("max-per-iface unlimited\n");
+	else
+		printf("max-per-iface %u\n", resp->max_per_iface);
+	printf("early-drop-threshold %u%%\n", resp->early_drop_threshold);
+	printf("source-limit-drops %lu\n", resp->stats.source_limit_drops);
+	printf("iface-limit-drops %lu\n", resp->stats.iface_limit_drops);
+	printf("table-full-drops %lu\n", resp->stats.table_full_drops);
+	printf("early-drop-embryonic %lu\n", resp->stats.early_drop_embryonic);
+	printf("early-drop-idle %lu\n", resp->stats.early_drop_idle);
 
 	free(resp_ptr);
 
@@ -133,6 +147,20 @@ static cmd_status_t config_set(struct gr_api_client *c, const struct ec_pnode *p
 		return CMD_ERROR;
 	if (arg_u32(p, "TIME_WAIT", &req.timeout_time_wait_sec) < 0 && errno != ENOENT)
 		return CMD_ERROR;
+	if (arg_u32(p, "MAX_SRC", &req.max_per_source) < 0) {
+		if (errno != ENOENT)
+			return CMD_ERROR;
+	} else if (req.max_per_source == 0) {
+		req.max_per_source = GR_CONNTRACK_UNLIMITED;
+	}
+	if (arg_u32(p, "MAX_IFACE", &req.max_per_iface) < 0) {
+		if (errno != ENOENT)
+			return CMD_ERROR;
+	} else if (req.max_per_iface == 0) {
+		req.max_per_iface = GR_CONNTRACK_UNLIMITED;
+	}
+	if (arg_u32(p, "EARLY_DROP", &req.early_drop_threshold) < 0 && errno != ENOENT)
+		return CMD_ERROR;
 
 	if (gr_api_client_send_recv(c, GR_CONNTRACK_CONF_SET, sizeof(req), &req, NULL) < 0)
 		return CMD_ERROR;
@@ -158,7 +186,9 @@ static int ctx_init(struct ec_node *root) {
 		CONNTRACK_CONFIG_CTX(root),
 		"set (max MAX),(closed-timeout CLOSED),(new-timeout NEW),"
 		"(established-udp-timeout EST_UDP),(established-tcp-timeout EST_TCP),"
-		"(half-close-timeout HALF_CLOSE),(time-wait-timeout TIME_WAIT)",
+		"(half-close-timeout HALF_CLOSE),(time-wait-timeout TIME_WAIT),"
+		"(max-per-source MAX_SRC),(max-per-iface MAX_IFACE),"
+		"(early-drop-threshold EARLY_DROP)",
 		config_set,
 		"Change the connection tracking configuration.",
 		with_help(
@@ -188,6 +218,19 @@ static int ctx_init(struct ec_node *root) {
 		with_help(
 			"Timeout after which idle & time-wait connections are destroyed.",
 			ec_node_uint("TIME_WAIT", 1, UINT32_MAX, 10)
+		),
+		with_help(
+			"Maximum number of connections per source address (0 for unlimited).",
+			ec_node_uint("MAX_SRC", 0, UINT32_MAX - 1, 10)
+		),
+		with_help(
+			"Maximum number of connections per interface (0 for unlimited).",
+			ec_node_uint("MAX_IFACE", 0, UINT32_MAX - 1, 10)
+		),
+		with_help(
+			"Table usage percentage above which embryonic and idle connections "
+			"are evicted.",
+			ec_node_uint("EARLY_DROP", 1, 100, 10)
 		)
 	);
 	if (ret < 0)
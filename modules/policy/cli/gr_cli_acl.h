@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_acl.h>
+#include <gr_cli.h>
+#include <gr_net_types.h>
+
+#include <ecoli.h>
+#include <libsmartcols.h>
+
+#define PORT_RANGE_RE "^[0-9]+(-[0-9]+)?$"
+#define PROTO_RE "^(tcp|udp|sctp|icmp|icmp6|[0-9]+)$"
+
+// Packet match criteria, shared by acl and pbr commands.
+#define ACL_MATCH_CMD                                                                              \
+	"(proto PROTO),(src SRC),(dst DST),(sport SPORT),(dport DPORT),(dscp DSCP),ip6"
+
+#define ACL_MATCH_ARGS                                                                             \
+	with_help("IP protocol name or number.", ec_node_re("PROTO", PROTO_RE)),                   \
+		with_help("Source network.", ec_node_re("SRC", IP_ANY_NET_RE)),                    \
+		with_help("Destination network.", ec_node_re("DST", IP_ANY_NET_RE)),               \
+		with_help("Source port or port range.", ec_node_re("SPORT", PORT_RANGE_RE)),       \
+		with_help(                                                                         \
+			"Destination port or port range.", ec_node_re("DPORT", PORT_RANGE_RE)      \
+		),                                                                                 \
+		with_help(                                                                         \
+			"Differentiated services code point.", ec_node_uint("DSCP", 0, 63, 10)     \
+		),                                                                                 \
+		with_help(                                                                         \
+			"Match IPv6 packets when no source or destination is specified.",          \
+			ec_node_str("ip6", "ip6")                                                  \
+		)
+
+// Parse the ACL_MATCH_CMD arguments.
+int acl_match_parse(const struct ec_pnode *, struct gr_acl_match *);
+
+// Add the PROTO, SRC, DST, SPORT, DPORT and DSCP columns to a table.
+void acl_match_columns(struct libscols_table *);
+
+// Fill the columns added by acl_match_columns, starting at index col.
+void acl_match_format(struct libscols_line *, int col, const struct gr_acl_match *);
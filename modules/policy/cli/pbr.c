@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_cli.h>
+#include <gr_cli_acl.h>
+#include <gr_cli_iface.h>
+#include <gr_net_types.h>
+#include <gr_pbr.h>
+#include <gr_table.h>
+
+#include <ecoli.h>
+#include <libsmartcols.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+
+static int parse_iface(struct gr_api_client *c, const struct ec_pnode *p, uint16_t *iface_id) {
+	struct gr_iface *iface = iface_from_name(c, arg_str(p, "IFACE"));
+
+	if (iface == NULL)
+		return -errno;
+	*iface_id = iface->id;
+	free(iface);
+
+	return 0;
+}
+
+static cmd_status_t pbr_add(struct gr_api_client *c, const struct ec_pnode *p) {
+	size_t len = sizeof(struct gr_pbr_rule_add_req) + sizeof(struct gr_pbr_rule);
+	struct gr_pbr_rule_add_req *req = calloc(1, len);
+	struct gr_pbr_rule *rule;
+	cmd_status_t ret = CMD_ERROR;
+
+	if (req == NULL)
+		return CMD_ERROR;
+
+	req->exist_ok = true;
+	req->n_rules = 1;
+	rule = &req->rules[0];
+
+	if (parse_iface(c, p, &req->iface_id) < 0)
+		goto out;
+	if (arg_u32(p, "SEQ", &rule->seq) < 0)
+		goto out;
+	if (arg_u16(p, "VRF", &rule->vrf_id) == 0) {
+		rule->action = GR_PBR_ACTION_VRF;
+	} else if (arg_u32(p, "ID", &rule->nh_id) == 0) {
+		rule->action = GR_PBR_ACTION_NEXTHOP;
+	} else {
+		errno = EINVAL;
+		goto out;
+	}
+
+	if (acl_match_parse(p, &rule->base) < 0)
+		goto out;
+
+	if (gr_api_client_send_recv(c, GR_PBR_RULE_ADD, len, req, NULL) < 0)
+		goto out;
+
+	ret = CMD_SUCCESS;
+out:
+	free(req);
+	return ret;
+}
+
+static cmd_status_t pbr_del(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_pbr_rule_del_req req = {.missing_ok = true};
+
+	if (parse_iface(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+	if (arg_u32(p, "SEQ", &req.seq) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_PBR_RULE_DEL, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t pbr_flush(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_pbr_flush_req req;
+
+	if (parse_iface(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_PBR_FLUSH, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t pbr_list(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_pbr_list_req req = {.iface_id = GR_IFACE_ID_UNDEF};
+	const struct gr_pbr_entry *e;
+	struct gr_iface *iface;
+	int ret;
+
+	if (arg_str(p, "IFACE") != NULL) {
+		if ((iface = iface_from_name(c, arg_str(p, "IFACE"))) == NULL)
+			return CMD_ERROR;
+		req.iface_id = iface->id;
+		free(iface);
+	}
+
+	struct libscols_table *table = scols_new_table();
+	scols_table_new_column(table, "IFACE", 0, 0);
+	scols_table_new_column(table, "SEQ", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "ACTION", 0, 0);
+	scols_table_new_column(table, "TARGET", 0, 0);
+	acl_match_columns(table);
+	scols_table_new_column(table, "PACKETS", 0, SCOLS_FL_RIGHT);
+	scols_table_set_column_separator(table, "  ");
+
+	gr_api_client_stream_foreach (e, ret, c, GR_PBR_LIST, sizeof(req), &req) {
+		struct libscols_line *line = scols_table_new_line(table, NULL);
+		const struct gr_pbr_rule *r = &e->rule;
+
+		iface = iface_from_id(c, e->iface_id);
+		if (iface != NULL)
+			scols_line_sprintf(line, 0, "%s", iface->name);
+		else
+			scols_line_sprintf(line, 0, "%u", e->iface_id);
+		free(iface);
+
+		scols_line_sprintf(line, 1, "%u", r->seq);
+		scols_line_set_data(line, 2, gr_pbr_action_name(r->action));
+		if (r->action == GR_PBR_ACTION_VRF)
+			scols_line_sprintf(line, 3, "%u", r->vrf_id);
+		else
+			scols_line_sprintf(line, 3, "%u", r->nh_id);
+		acl_match_format(line, 4, &r->base);
+		scols_line_sprintf(line, 10, "%lu", r->packets);
+	}
+
+	scols_print_table(table);
+	scols_unref_table(table);
+
+	return ret < 0 ? CMD_ERROR : CMD_SUCCESS;
+}
+
+#define PBR_CTX(root) CLI_CONTEXT(root, CTX_ARG("pbr", "Policy based routing."))
+
+static int ctx_init(struct ec_node *root) {
+	int ret;
+
+	ret = CLI_COMMAND(
+		PBR_CTX(root),
+		"add iface IFACE seq SEQ (vrf VRF)|(nexthop ID) [" ACL_MATCH_CMD "]",
+		pbr_add,
+		"Add or replace a policy based routing rule.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL)),
+		with_help(
+			"Rule sequence number. Rules are evaluated in ascending order.",
+			ec_node_uint("SEQ", 0, UINT32_MAX, 10)
+		),
+		with_help(
+			"Route matching packets in this VRF.",
+			ec_node_uint("VRF", 0, UINT16_MAX - 1, 10)
+		),
+		with_help(
+			"Forward matching packets to this nexthop.",
+			ec_node_uint("ID", 1, UINT32_MAX - 1, 10)
+		),
+		ACL_MATCH_ARGS
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		PBR_CTX(root),
+		"del iface IFACE seq SEQ",
+		pbr_del,
+		"Delete a policy based routing rule.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL)),
+		with_help("Rule sequence number.", ec_node_uint("SEQ", 0, UINT32_MAX, 10))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		PBR_CTX(root),
+		"flush iface IFACE",
+		pbr_flush,
+		"Delete all policy based routing rules of an interface.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		PBR_CTX(root),
+		"[show] [iface IFACE]",
+		pbr_list,
+		"Show policy based routing rules and their hit counters.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL))
+	);
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+static struct cli_context ctx = {
+	.name = "pbr",
+	.init = ctx_init,
+};
+
+static void __attribute__((constructor, used)) init(void) {
+	cli_context_register(&ctx);
+}
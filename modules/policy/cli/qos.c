@@ -0,0 +1,467 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_cli.h>
+#include <gr_cli_iface.h>
+#include <gr_qos.h>
+#include <gr_table.h>
+
+#include <ecoli.h>
+#include <libsmartcols.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POLICER_ACTION_RE "^(pass|drop|[0-9]+)$"
+
+static int parse_iface(struct gr_api_client *c, const struct ec_pnode *p, uint16_t *iface_id) {
+	struct gr_iface *iface = iface_from_name(c, arg_str(p, "IFACE"));
+
+	if (iface == NULL)
+		return -errno;
+	*iface_id = iface->id;
+	free(iface);
+
+	return 0;
+}
+
+static int parse_iface_filter(struct gr_api_client *c, const struct ec_pnode *p, uint16_t *id) {
+	*id = GR_IFACE_ID_UNDEF;
+	if (arg_str(p, "IFACE") == NULL)
+		return 0;
+	return parse_iface(c, p, id);
+}
+
+static void print_iface(struct gr_api_client *c, struct libscols_line *line, uint16_t iface_id) {
+	struct gr_iface *iface = iface_from_id(c, iface_id);
+	if (iface != NULL)
+		scols_line_sprintf(line, 0, "%s", iface->name);
+	else
+		scols_line_sprintf(line, 0, "%u", iface_id);
+	free(iface);
+}
+
+static int parse_policer_action(const char *s, struct gr_policer_action *action) {
+	unsigned long dscp;
+	char *end;
+
+	if (s == NULL)
+		return 0;
+	if (strcmp(s, "pass") == 0) {
+		action->action = GR_POLICER_PASS;
+	} else if (strcmp(s, "drop") == 0) {
+		action->action = GR_POLICER_DROP;
+	} else {
+		errno = 0;
+		dscp = strtoul(s, &end, 10);
+		if (errno != 0 || *end != '\0' || dscp > 63)
+			return errno_set(EINVAL);
+		action->action = GR_POLICER_REMARK;
+		action->dscp = dscp;
+	}
+
+	return 0;
+}
+
+static cmd_status_t policer_set(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_qos_policer_set_req req = {
+		.conf.actions = {
+			[GR_COLOR_GREEN] = {.action = GR_POLICER_PASS},
+			[GR_COLOR_YELLOW] = {.action = GR_POLICER_PASS},
+			[GR_COLOR_RED] = {.action = GR_POLICER_DROP},
+		},
+	};
+
+	if (parse_iface(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+
+	if (arg_str(p, "srtcm") != NULL)
+		req.conf.mode = GR_POLICER_SRTCM;
+	else
+		req.conf.mode = GR_POLICER_TRTCM;
+
+	if (arg_u64(p, "CIR", &req.conf.cir) < 0)
+		return CMD_ERROR;
+	if (arg_u64(p, "CBS", &req.conf.cbs) < 0)
+		return CMD_ERROR;
+	if (arg_u64(p, "EBS", &req.conf.ebs) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+	if (arg_u64(p, "PIR", &req.conf.pir) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+	if (arg_u64(p, "PBS", &req.conf.pbs) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+	if (parse_policer_action(arg_str(p, "YELLOW"), &req.conf.actions[GR_COLOR_YELLOW]) < 0)
+		return CMD_ERROR;
+	if (parse_policer_action(arg_str(p, "RED"), &req.conf.actions[GR_COLOR_RED]) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_QOS_POLICER_SET, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t policer_del(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_qos_policer_del_req req = {.missing_ok = true};
+
+	if (parse_iface(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_QOS_POLICER_DEL, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static void format_policer_action(char *buf, size_t len, const struct gr_policer_action *a) {
+	switch (a->action) {
+	case GR_POLICER_PASS:
+		snprintf(buf, len, "pass");
+		break;
+	case GR_POLICER_DROP:
+		snprintf(buf, len, "drop");
+		break;
+	case GR_POLICER_REMARK:
+		snprintf(buf, len, "dscp %u", a->dscp);
+		break;
+	default:
+		snprintf(buf, len, "?");
+		break;
+	}
+}
+
+static cmd_status_t policer_list(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_qos_policer_list_req req;
+	const struct gr_qos_policer *pol;
+	char action[32];
+	int ret;
+
+	if (parse_iface_filter(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+
+	struct libscols_table *table = scols_new_table();
+	scols_table_new_column(table, "IFACE", 0, 0);
+	scols_table_new_column(table, "MODE", 0, 0);
+	scols_table_new_column(table, "CIR", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "CBS", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "EBS", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "PIR", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "PBS", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "COLOR", 0, 0);
+	scols_table_new_column(table, "ACTION", 0, 0);
+	scols_table_new_column(table, "PACKETS", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "BYTES", 0, SCOLS_FL_RIGHT);
+	scols_table_set_column_separator(table, "  ");
+
+	gr_api_client_stream_foreach (pol, ret, c, GR_QOS_POLICER_LIST, sizeof(req), &req) {
+		const struct gr_policer_conf *conf = &pol->conf;
+
+		for (gr_color_t color = 0; color < GR_COLOR_COUNT; color++) {
+			struct libscols_line *line = scols_table_new_line(table, NULL);
+
+			if (color == GR_COLOR_GREEN) {
+				print_iface(c, line, pol->iface_id);
+				scols_line_set_data(line, 1, gr_policer_mode_name(conf->mode));
+				scols_line_sprintf(line, 2, "%lu", conf->cir);
+				scols_line_sprintf(line, 3, "%lu", conf->cbs);
+				if (conf->mode == GR_POLICER_SRTCM) {
+					scols_line_sprintf(line, 4, "%lu", conf->ebs);
+				} else {
+					scols_line_sprintf(line, 5, "%lu", conf->pir);
+					scols_line_sprintf(line, 6, "%lu", conf->pbs);
+				}
+			}
+			format_policer_action(action, sizeof(action), &conf->actions[color]);
+			scols_line_set_data(line, 7, gr_color_name(color));
+			scols_line_set_data(line, 8, action);
+			scols_line_sprintf(line, 9, "%lu", pol->stats[color].packets);
+			scols_line_sprintf(line, 10, "%lu", pol->stats[color].bytes);
+		}
+	}
+
+	scols_print_table(table);
+	scols_unref_table(table);
+
+	return ret < 0 ? CMD_ERROR : CMD_SUCCESS;
+}
+
+static cmd_status_t sched_set(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_qos_sched_set_req req = {
+		.conf = {
+			.n_subscribers = 1024,
+			.qsize = 64,
+		},
+	};
+
+	if (parse_iface(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+	if (arg_u64(p, "RATE", &req.conf.rate) < 0)
+		return CMD_ERROR;
+	if (arg_u16(p, "SUBSCRIBERS", &req.conf.n_subscribers) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+	if (arg_u16(p, "QSIZE", &req.conf.qsize) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_QOS_SCHED_SET, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t sched_del(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_qos_sched_del_req req = {.missing_ok = true};
+
+	if (parse_iface(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_QOS_SCHED_DEL, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t sched_list(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_qos_sched_list_req req;
+	const struct gr_qos_sched *s;
+	int ret;
+
+	if (parse_iface_filter(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+
+	struct libscols_table *table = scols_new_table();
+	scols_table_new_column(table, "IFACE", 0, 0);
+	scols_table_new_column(table, "RATE", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "SUBSCRIBERS", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "QSIZE", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "CLASS", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "PACKETS", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "BYTES", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "DROPPED", 0, SCOLS_FL_RIGHT);
+	scols_table_set_column_separator(table, "  ");
+
+	gr_api_client_stream_foreach (s, ret, c, GR_QOS_SCHED_LIST, sizeof(req), &req) {
+		for (int class = GR_QOS_CLASS_COUNT - 1; class >= 0; class--) {
+			struct libscols_line *line = scols_table_new_line(table, NULL);
+
+			if (class == GR_QOS_CLASS_COUNT - 1) {
+				print_iface(c, line, s->iface_id);
+				scols_line_sprintf(line, 1, "%lu", s->conf.rate);
+				scols_line_sprintf(line, 2, "%u", s->conf.n_subscribers);
+				scols_line_sprintf(line, 3, "%u", s->conf.qsize);
+			}
+			scols_line_sprintf(line, 4, "%d", class);
+			scols_line_sprintf(line, 5, "%lu", s->stats[class].packets);
+			scols_line_sprintf(line, 6, "%lu", s->stats[class].bytes);
+			scols_line_sprintf(line, 7, "%lu", s->stats[class].dropped);
+		}
+	}
+
+	scols_print_table(table);
+	scols_unref_table(table);
+
+	return ret < 0 ? CMD_ERROR : CMD_SUCCESS;
+}
+
+static cmd_status_t subscriber_set(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_qos_subscriber_set_req req;
+
+	if (parse_iface(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+	if (arg_u64(p, "RATE", &req.rate) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_QOS_SUBSCRIBER_SET, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t subscriber_del(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_qos_subscriber_del_req req = {.missing_ok = true};
+
+	if (parse_iface(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_QOS_SUBSCRIBER_DEL, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t subscriber_list(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_qos_subscriber_list_req req;
+	const struct gr_qos_subscriber *s;
+	int ret;
+
+	if (parse_iface_filter(c, p, &req.iface_id) < 0)
+		return CMD_ERROR;
+
+	struct libscols_table *table = scols_new_table();
+	scols_table_new_column(table, "IFACE", 0, 0);
+	scols_table_new_column(table, "RATE", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "ACTIVE", 0, 0);
+	scols_table_new_column(table, "PACKETS", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "BYTES", 0, SCOLS_FL_RIGHT);
+	scols_table_new_column(table, "DROPPED", 0, SCOLS_FL_RIGHT);
+	scols_table_set_column_separator(table, "  ");
+
+	gr_api_client_stream_foreach (s, ret, c, GR_QOS_SUBSCRIBER_LIST, sizeof(req), &req) {
+		struct libscols_line *line = scols_table_new_line(table, NULL);
+		print_iface(c, line, s->iface_id);
+		scols_line_sprintf(line, 1, "%lu", s->rate);
+		scols_line_set_data(line, 2, s->active ? "yes" : "no");
+		scols_line_sprintf(line, 3, "%lu", s->stats.packets);
+		scols_line_sprintf(line, 4, "%lu", s->stats.bytes);
+		scols_line_sprintf(line, 5, "%lu", s->stats.dropped);
+	}
+
+	scols_print_table(table);
+	scols_unref_table(table);
+
+	return ret < 0 ? CMD_ERROR : CMD_SUCCESS;
+}
+
+#define QOS_ARG CTX_ARG("qos", "Quality of service.")
+#define POLICER_CTX(root) CLI_CONTEXT(root, QOS_ARG, CTX_ARG("policer", "Ingress policers."))
+#define SCHED_CTX(root) CLI_CONTEXT(root, QOS_ARG, CTX_ARG("scheduler", "Egress schedulers."))
+#define SUBSCRIBER_CTX(root)                                                                       \
+	CLI_CONTEXT(root, QOS_ARG, CTX_ARG("subscriber", "Egress scheduler subscribers."))
+
+static int ctx_init(struct ec_node *root) {
+	int ret;
+
+	ret = CLI_COMMAND(
+		POLICER_CTX(root),
+		"set iface IFACE mode srtcm|trtcm cir CIR cbs CBS "
+		"[(ebs EBS),(pir PIR),(pbs PBS),(yellow YELLOW),(red RED)]",
+		policer_set,
+		"Attach an ingress policer to an interface or replace the existing one.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL)),
+		with_help("Single rate three color marker.", ec_node_str("srtcm", "srtcm")),
+		with_help("Two rate three color marker.", ec_node_str("trtcm", "trtcm")),
+		with_help(
+			"Committed information rate in bits/s.",
+			ec_node_uint("CIR", 1, UINT64_MAX, 10)
+		),
+		with_help("Committed burst size in bytes.", ec_node_uint("CBS", 0, UINT64_MAX, 10)),
+		with_help(
+			"Excess burst size in bytes (srtcm).",
+			ec_node_uint("EBS", 0, UINT64_MAX, 10)
+		),
+		with_help(
+			"Peak information rate in bits/s (trtcm).",
+			ec_node_uint("PIR", 1, UINT64_MAX, 10)
+		),
+		with_help(
+			"Peak burst size in bytes (trtcm).",
+			ec_node_uint("PBS", 0, UINT64_MAX, 10)
+		),
+		with_help(
+			"Yellow packets action: pass, drop or remark to DSCP (default: pass).",
+			ec_node_re("YELLOW", POLICER_ACTION_RE)
+		),
+		with_help(
+			"Red packets action: pass, drop or remark to DSCP (default: drop).",
+			ec_node_re("RED", POLICER_ACTION_RE)
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		POLICER_CTX(root),
+		"del iface IFACE",
+		policer_del,
+		"Detach the ingress policer of an interface.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		POLICER_CTX(root),
+		"[show] [iface IFACE]",
+		policer_list,
+		"Show ingress policers and their per color counters.",
+		with_help("Interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		SCHED_CTX(root),
+		"set iface IFACE rate RATE [(subscribers SUBSCRIBERS),(qsize QSIZE)]",
+		sched_set,
+		"Enable the egress scheduler of a port or reconfigure it.",
+		with_help("Port name.", ec_node_dyn("IFACE", complete_iface_names, NULL)),
+		with_help("Port rate in bits/s.", ec_node_uint("RATE", 8, UINT64_MAX, 10)),
+		with_help(
+			"Maximum number of subscribers, power of 2 (default: 1024).",
+			ec_node_uint("SUBSCRIBERS", 1, GR_QOS_MAX_SUBSCRIBERS, 10)
+		),
+		with_help(
+			"Packets per class queue of each subscriber, power of 2 (default: 64).",
+			ec_node_uint("QSIZE", 1, UINT16_MAX, 10)
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		SCHED_CTX(root),
+		"del iface IFACE",
+		sched_del,
+		"Disable the egress scheduler of a port.",
+		with_help("Port name.", ec_node_dyn("IFACE", complete_iface_names, NULL))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		SCHED_CTX(root),
+		"[show] [iface IFACE]",
+		sched_list,
+		"Show egress schedulers and their per class counters.",
+		with_help("Port name.", ec_node_dyn("IFACE", complete_iface_names, NULL))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		SUBSCRIBER_CTX(root),
+		"set iface IFACE rate RATE",
+		subscriber_set,
+		"Shape the egress traffic of a VLAN sub-interface.",
+		with_help("VLAN interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL)),
+		with_help("Subscriber rate in bits/s.", ec_node_uint("RATE", 8, UINT64_MAX, 10))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		SUBSCRIBER_CTX(root),
+		"del iface IFACE",
+		subscriber_del,
+		"Remove the shaping configuration of a VLAN sub-interface.",
+		with_help("VLAN interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		SUBSCRIBER_CTX(root),
+		"[show] [iface IFACE]",
+		subscriber_list,
+		"Show subscribers and their counters.",
+		with_help("VLAN interface name.", ec_node_dyn("IFACE", complete_iface_names, NULL))
+	);
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+static struct cli_context ctx = {
+	.name = "qos",
+	.init = ctx_init,
+};
+
+static void __attribute__((constructor, used)) init(void) {
+	cli_context_register(&ctx);
+}
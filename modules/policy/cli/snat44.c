@@ -11,7 +11,10 @@
 #include <ecoli.h>
 #include <libsmartcols.h>
 
+#include <errno.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 static cmd_status_t snat44_add(struct gr_api_client *c, const struct ec_pnode *p) {
 	struct gr_iface *iface = iface_from_name(c, arg_str(p, "IFACE"));
@@ -26,6 +29,7 @@ static cmd_status_t snat44_add(struct gr_api_client *c, const struct ec_pnode *p
 		return CMD_ERROR;
 	if (arg_ip4(p, "REPLACE", &req.policy.replace) < 0)
 		return CMD_ERROR;
+	req.policy.endpoint_independent = arg_str(p, "endpoint-independent") != NULL;
 
 	if (gr_api_client_send_recv(c, GR_SNAT44_ADD, sizeof(req), &req, NULL) < 0)
 		return CMD_ERROR;
@@ -62,6 +66,7 @@ static cmd_status_t snat44_list(struct gr_api_client *c, const struct ec_pnode *
 	scols_table_new_column(table, "INTERFACE", 0, 0);
 	scols_table_new_column(table, "SUBNET", 0, 0);
 	scols_table_new_column(table, "REPLACE", 0, 0);
+	scols_table_new_column(table, "MAPPING", 0, 0);
 	scols_table_set_column_separator(table, "  ");
 
 	gr_api_client_stream_foreach (policy, ret, c, GR_SNAT44_LIST, 0, NULL) {
@@ -76,6 +81,10 @@ static cmd_status_t snat44_list(struct gr_api_client *c, const struct ec_pnode *
 
 		scols_line_sprintf(line, 1, IP4_F "/%hhu", &policy->net.ip, policy->net.prefixlen);
 		scols_line_sprintf(line, 2, IP4_F, &policy->replace);
+		if (policy->endpoint_independent)
+			scols_line_set_data(line, 3, "endpoint-independent");
+		else
+			scols_line_set_data(line, 3, "address-and-port-dependent");
 	}
 
 	scols_print_table(table);
@@ -84,14 +93,62 @@ static cmd_status_t snat44_list(struct gr_api_client *c, const struct ec_pnode *
 	return ret < 0 ? CMD_ERROR : CMD_SUCCESS;
 }
 
-#define SNAT_CTX(root) CLI_CONTEXT(root, CTX_ARG("snat44", "Dynamic source NAT44."))
+static cmd_status_t log_set(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_snat44_log_conf_set_req req = {0};
+	const char *path;
+
+	req.enabled = arg_str(p, "enable") != NULL;
+
+	if ((path = arg_str(p, "PATH")) != NULL) {
+		if (strlen(path) >= sizeof(req.path)) {
+			errno = ENAMETOOLONG;
+			return CMD_ERROR;
+		}
+		memccpy(req.path, path, 0, sizeof(req.path));
+	}
+	if (arg_u32(p, "MAX_SIZE", &req.max_file_size) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+	if (arg_u16(p, "MAX_FILES", &req.max_files) < 0 && errno != ENOENT)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_SNAT44_LOG_CONF_SET, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t log_show(struct gr_api_client *c, const struct ec_pnode *) {
+	const struct gr_snat44_log_conf_get_resp *resp;
+	void *resp_ptr = NULL;
+
+	if (gr_api_client_send_recv(c, GR_SNAT44_LOG_CONF_GET, 0, NULL, &resp_ptr) < 0)
+		return CMD_ERROR;
+
+	resp = resp_ptr;
+	printf("enabled %s\n", resp->enabled ? "yes" : "no");
+	printf("path %s\n", resp->path[0] != '\0' ? resp->path : "none");
+	printf("max-file-size %u\n", resp->max_file_size);
+	printf("max-files %u\n", resp->max_files);
+	printf("records %lu\n", resp->stats.records);
+	printf("lost %lu\n", resp->stats.lost);
+	printf("write-errors %lu\n", resp->stats.write_errors);
+	printf("rotations %lu\n", resp->stats.rotations);
+
+	free(resp_ptr);
+
+	return CMD_SUCCESS;
+}
+
+#define SNAT_ARG CTX_ARG("snat44", "Dynamic source NAT44.")
+#define SNAT_CTX(root) CLI_CONTEXT(root, SNAT_ARG)
+#define SNAT_LOG_CTX(root) CLI_CONTEXT(root, SNAT_ARG, CTX_ARG("log", "Session logging."))
 
 static int ctx_init(struct ec_node *root) {
 	int ret;
 
 	ret = CLI_COMMAND(
 		SNAT_CTX(root),
-		"add interface IFACE subnet NET replace REPLACE",
+		"add interface IFACE subnet NET replace REPLACE [endpoint-independent]",
 		snat44_add,
 		"Create a SNAT44 policy.",
 		with_help("Output interface.", ec_node_dyn("IFACE", complete_iface_names, NULL)),
@@ -102,6 +159,11 @@ static int ctx_init(struct ec_node *root) {
 		with_help(
 			"Replace source address with this IPv4 address.",
 			ec_node_re("REPLACE", IPV4_RE)
+		),
+		with_help(
+			"Reuse the same external port for all destinations of an internal "
+			"endpoint and accept inbound traffic from any remote host.",
+			ec_node_str("endpoint-independent", "endpoint-independent")
 		)
 	);
 	if (ret < 0)
@@ -124,6 +186,30 @@ static int ctx_init(struct ec_node *root) {
 	if (ret < 0)
 		return ret;
 	ret = CLI_COMMAND(SNAT_CTX(root), "[show]", snat44_list, "Display SNAT44 policies.");
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		SNAT_LOG_CTX(root),
+		"set enable|disable [(path PATH),(max-file-size MAX_SIZE),(max-files MAX_FILES)]",
+		log_set,
+		"Configure the logging of NAT bindings creation and deletion.",
+		with_help("Start logging.", ec_node_str("enable", "enable")),
+		with_help("Stop logging.", ec_node_str("disable", "disable")),
+		with_help("Path of the current log file.", ec_node("file", "PATH")),
+		with_help(
+			"Size in bytes above which the current file is rotated.",
+			ec_node_uint("MAX_SIZE", 4096, UINT32_MAX, 10)
+		),
+		with_help(
+			"Number of rotated files to keep.",
+			ec_node_uint("MAX_FILES", 1, UINT16_MAX, 10)
+		)
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		SNAT_LOG_CTX(root), "[show]", log_show, "Show the session logging configuration."
+	);
 	if (ret < 0)
 		return ret;
 
@@ -0,0 +1,571 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_acl.h>
+#include <gr_acl_control.h>
+#include <gr_api.h>
+#include <gr_event.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_rcu.h>
+#include <gr_vec.h>
+
+#include <rte_acl.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct acl_iface acl_ifaces[MAX_IFACES][GR_ACL_DIR_COUNT];
+
+// Configured rules of each interface and direction, sorted by sequence number.
+static gr_vec struct gr_acl_rule *acl_rules[MAX_IFACES][GR_ACL_DIR_COUNT];
+
+#define ACL_FIELD(t, s, idx, input, off)                                                           \
+	{                                                                                          \
+		.type = RTE_ACL_FIELD_TYPE_##t,                                                    \
+		.size = s,                                                                         \
+		.field_index = idx,                                                                \
+		.input_index = input,                                                              \
+		.offset = off,                                                                     \
+	}
+
+// rte_acl requires the first field to be one byte long and the following ones
+// to be grouped in 4 bytes input words.
+enum {
+	ACL4_PROTO,
+	ACL4_DSCP,
+	ACL4_SRC,
+	ACL4_DST,
+	ACL4_SPORT,
+	ACL4_DPORT,
+	ACL4_NUM_FIELDS,
+};
+
+static const struct rte_acl_field_def acl4_defs[ACL4_NUM_FIELDS] = {
+	ACL_FIELD(BITMASK, 1, ACL4_PROTO, 0, offsetof(struct acl4_key, proto)),
+	ACL_FIELD(BITMASK, 1, ACL4_DSCP, 1, offsetof(struct acl4_key, dscp)),
+	ACL_FIELD(MASK, 4, ACL4_SRC, 2, offsetof(struct acl4_key, src)),
+	ACL_FIELD(MASK, 4, ACL4_DST, 3, offsetof(struct acl4_key, dst)),
+	ACL_FIELD(RANGE, 2, ACL4_SPORT, 4, offsetof(struct acl4_key, sport)),
+	ACL_FIELD(RANGE, 2, ACL4_DPORT, 4, offsetof(struct acl4_key, dport)),
+};
+
+// IPv6 addresses are split in four 32 bit words.
+enum {
+	ACL6_PROTO,
+	ACL6_DSCP,
+	ACL6_SRC,
+	ACL6_DST = ACL6_SRC + 4,
+	ACL6_SPORT = ACL6_DST + 4,
+	ACL6_DPORT,
+	ACL6_NUM_FIELDS,
+};
+
+#define ACL6_ADDR_FIELD(idx, member, word)                                                         \
+	ACL_FIELD(MASK, 4, idx + word, idx + word, offsetof(struct acl6_key, member) + 4 * word)
+
+static const struct rte_acl_field_def acl6_defs[ACL6_NUM_FIELDS] = {
+	ACL_FIELD(BITMASK, 1, ACL6_PROTO, 0, offsetof(struct acl6_key, proto)),
+	ACL_FIELD(BITMASK, 1, ACL6_DSCP, 1, offsetof(struct acl6_key, dscp)),
+	ACL6_ADDR_FIELD(ACL6_SRC, src, 0),
+	ACL6_ADDR_FIELD(ACL6_SRC, src, 1),
+	ACL6_ADDR_FIELD(ACL6_SRC, src, 2),
+	ACL6_ADDR_FIELD(ACL6_SRC, src, 3),
+	ACL6_ADDR_FIELD(ACL6_DST, dst, 0),
+	ACL6_ADDR_FIELD(ACL6_DST, dst, 1),
+	ACL6_ADDR_FIELD(ACL6_DST, dst, 2),
+	ACL6_ADDR_FIELD(ACL6_DST, dst, 3),
+	ACL_FIELD(RANGE, 2, ACL6_SPORT, ACL6_DST + 4, offsetof(struct acl6_key, sport)),
+	ACL_FIELD(RANGE, 2, ACL6_DPORT, ACL6_DST + 4, offsetof(struct acl6_key, dport)),
+};
+
+RTE_ACL_RULE_DEF(acl4_rule, ACL4_NUM_FIELDS);
+RTE_ACL_RULE_DEF(acl6_rule, ACL6_NUM_FIELDS);
+
+// Fields shared by both address families are at the same index.
+static void acl_rule_fill_common(struct rte_acl_field *f, const struct gr_acl_match *m) {
+	f[ACL4_PROTO].value.u8 = m->proto;
+	f[ACL4_PROTO].mask_range.u8 = m->proto != 0 ? UINT8_MAX : 0;
+	if (m->dscp != GR_ACL_DSCP_ANY) {
+		f[ACL4_DSCP].value.u8 = m->dscp;
+		f[ACL4_DSCP].mask_range.u8 = 0x3f;
+	}
+}
+
+static void acl_rule_fill_ports(struct rte_acl_field *f, const struct gr_acl_match *m) {
+	f[0].value.u16 = m->sport_min;
+	f[0].mask_range.u16 = m->sport_max;
+	f[1].value.u16 = m->dport_min;
+	f[1].mask_range.u16 = m->dport_max;
+}
+
+static void acl4_rule_fill(struct acl4_rule *r, const struct gr_acl_match *m) {
+	acl_rule_fill_common(r->field, m);
+	r->field[ACL4_SRC].value.u32 = rte_be_to_cpu_32(m->src.ip4.ip);
+	r->field[ACL4_SRC].mask_range.u32 = m->src.ip4.prefixlen;
+	r->field[ACL4_DST].value.u32 = rte_be_to_cpu_32(m->dst.ip4.ip);
+	r->field[ACL4_DST].mask_range.u32 = m->dst.ip4.prefixlen;
+	acl_rule_fill_ports(&r->field[ACL4_SPORT], m);
+}
+
+static void acl6_addr_fill(struct rte_acl_field *f, const struct ip6_net *net) {
+	const rte_be32_t *words = (const rte_be32_t *)net->ip.a;
+
+	for (int i = 0; i < 4; i++) {
+		int bits = (int)net->prefixlen - 32 * i;
+		f[i].value.u32 = rte_be_to_cpu_32(words[i]);
+		f[i].mask_range.u32 = RTE_MAX(0, RTE_MIN(32, bits));
+	}
+}
+
+static void acl6_rule_fill(struct acl6_rule *r, const struct gr_acl_match *m) {
+	acl_rule_fill_common(r->field, m);
+	acl6_addr_fill(&r->field[ACL6_SRC], &m->src.ip6);
+	acl6_addr_fill(&r->field[ACL6_DST], &m->dst.ip6);
+	acl_rule_fill_ports(&r->field[ACL6_SPORT], m);
+}
+
+struct rte_acl_ctx *acl_classifier_build(
+	const char *name,
+	addr_family_t af,
+	const struct gr_acl_match *const *matches,
+	uint32_t n
+) {
+	const struct rte_acl_field_def *defs;
+	struct rte_acl_config cfg = {0};
+	struct rte_acl_ctx *ctx = NULL;
+	unsigned n_fields, rule_size;
+	void *buf = NULL;
+	int ret;
+
+	if (af == GR_AF_IP4) {
+		defs = acl4_defs;
+		n_fields = ACL4_NUM_FIELDS;
+		rule_size = sizeof(struct acl4_rule);
+	} else {
+		defs = acl6_defs;
+		n_fields = ACL6_NUM_FIELDS;
+		rule_size = sizeof(struct acl6_rule);
+	}
+
+	buf = calloc(n, rule_size);
+	if (buf == NULL) {
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	for (uint32_t i = 0; i < n; i++) {
+		struct rte_acl_rule *r = RTE_PTR_ADD(buf, i * rule_size);
+		r->data.category_mask = 1;
+		r->data.priority = RTE_ACL_MAX_PRIORITY - i;
+		r->data.userdata = i + 1;
+		if (af == GR_AF_IP4)
+			acl4_rule_fill((struct acl4_rule *)r, matches[i]);
+		else
+			acl6_rule_fill((struct acl6_rule *)r, matches[i]);
+	}
+
+	ctx = rte_acl_create(&(struct rte_acl_param) {
+		.name = name,
+		.socket_id = SOCKET_ID_ANY,
+		.rule_size = rule_size,
+		.max_rule_num = n,
+	});
+	if (ctx == NULL) {
+		ret = -rte_errno;
+		goto err;
+	}
+	if ((ret = rte_acl_add_rules(ctx, buf, n)) < 0)
+		goto err;
+
+	cfg.num_categories = 1;
+	cfg.num_fields = n_fields;
+	memcpy(cfg.defs, defs, n_fields * sizeof(*defs));
+	if ((ret = rte_acl_build(ctx, &cfg)) < 0)
+		goto err;
+
+	free(buf);
+	return ctx;
+err:
+	free(buf);
+	rte_acl_free(ctx);
+	return errno_set_null(-ret);
+}
+
+static void acl_ruleset_free(struct acl_ruleset *rs) {
+	if (rs == NULL)
+		return;
+	rte_acl_free(rs->ctx);
+	rte_free(rs);
+}
+
+// Compile the rules of the given address family into a new classifier.
+// Counters of the rules that already existed in the old rule set are kept.
+static int acl_ruleset_build(
+	uint16_t iface_id,
+	gr_acl_dir_t dir,
+	addr_family_t af,
+	const struct gr_acl_rule *rules,
+	const struct acl_ruleset *old,
+	struct acl_ruleset **out
+) {
+	gr_vec const struct gr_acl_match **matches = NULL;
+	struct acl_ruleset *rs = NULL;
+	char name[RTE_ACL_NAMESIZE];
+	static unsigned generation;
+	uint32_t n, o = 0;
+
+	*out = NULL;
+
+	gr_vec_foreach_ref (const struct gr_acl_rule *rule, rules) {
+		if (rule->af == af)
+			gr_vec_add(matches, &rule->base);
+	}
+	n = gr_vec_len(matches);
+	if (n == 0)
+		return 0;
+
+	rs = rte_zmalloc(__func__, sizeof(*rs) + n * sizeof(rs->rules[0]), RTE_CACHE_LINE_SIZE);
+	if (rs == NULL) {
+		errno = ENOMEM;
+		goto err;
+	}
+
+	// The old and new rule sets share the same ordering.
+	gr_vec_foreach_ref (const struct gr_acl_rule *rule, rules) {
+		struct acl_rule_state *s;
+
+		if (rule->af != af)
+			continue;
+
+		s = &rs->rules[rs->n_rules];
+		s->seq = rule->seq;
+		s->action = rule->action;
+		while (old != NULL && o < old->n_rules && old->rules[o].seq < rule->seq)
+			o++;
+		if (old != NULL && o < old->n_rules && old->rules[o].seq == rule->seq)
+			atomic_init(&s->packets, atomic_load(&old->rules[o].packets));
+
+		rs->n_rules++;
+	}
+
+	snprintf(
+		name,
+		sizeof(name),
+		"acl%u_%s%u_%x",
+		iface_id,
+		gr_acl_dir_name(dir),
+		af,
+		generation++
+	);
+	rs->ctx = acl_classifier_build(name, af, matches, n);
+	if (rs->ctx == NULL)
+		goto err;
+
+	gr_vec_free(matches);
+	*out = rs;
+	return 0;
+err:
+	gr_vec_free(matches);
+	acl_ruleset_free(rs);
+	return -errno;
+}
+
+// Replace the classifiers of an interface for the given direction.
+static int acl_apply(struct iface *iface, gr_acl_dir_t dir, const struct gr_acl_rule *rules) {
+	gr_iface_flags_t flag = dir == GR_ACL_DIR_IN ? GR_IFACE_F_ACL_IN : GR_IFACE_F_ACL_OUT;
+	struct acl_iface *a = &acl_ifaces[iface->id][dir];
+	struct acl_ruleset *rs4, *rs6, *old4, *old6;
+
+	old4 = atomic_load(&a->ip4);
+	old6 = atomic_load(&a->ip6);
+
+	if (acl_ruleset_build(iface->id, dir, GR_AF_IP4, rules, old4, &rs4) < 0)
+		return -errno;
+	if (acl_ruleset_build(iface->id, dir, GR_AF_IP6, rules, old6, &rs6) < 0) {
+		acl_ruleset_free(rs4);
+		return -errno;
+	}
+
+	atomic_store_explicit(&a->ip4, rs4, memory_order_release);
+	atomic_store_explicit(&a->ip6, rs6, memory_order_release);
+	if (gr_vec_len(rules) > 0)
+		iface->flags |= flag;
+	else
+		iface->flags &= ~flag;
+
+	if (old4 != NULL || old6 != NULL) {
+		rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+		acl_ruleset_free(old4);
+		acl_ruleset_free(old6);
+	}
+
+	return 0;
+}
+
+int acl_match_validate(const struct gr_acl_match *m) {
+	switch (m->af) {
+	case GR_AF_IP4:
+		if (m->src.ip4.prefixlen > 32 || m->dst.ip4.prefixlen > 32)
+			return errno_set(EINVAL);
+		break;
+	case GR_AF_IP6:
+		if (m->src.ip6.prefixlen > 128 || m->dst.ip6.prefixlen > 128)
+			return errno_set(EINVAL);
+		break;
+	default:
+		return errno_set(EAFNOSUPPORT);
+	}
+
+	if (m->dscp > 63 && m->dscp != GR_ACL_DSCP_ANY)
+		return errno_set(EINVAL);
+	if (m->sport_min > m->sport_max || m->dport_min > m->dport_max)
+		return errno_set(ERANGE);
+
+	return 0;
+}
+
+static int acl_rule_validate(const struct gr_acl_rule *rule) {
+	switch (rule->action) {
+	case GR_ACL_PERMIT:
+	case GR_ACL_DENY:
+		break;
+	default:
+		return errno_set(EINVAL);
+	}
+
+	return acl_match_validate(&rule->base);
+}
+
+static int acl_rule_cmp(const void *a, const void *b) {
+	const struct gr_acl_rule *ra = a;
+	const struct gr_acl_rule *rb = b;
+	return (ra->seq > rb->seq) - (ra->seq < rb->seq);
+}
+
+static struct gr_acl_rule *acl_rule_find(const struct gr_acl_rule *rules, uint32_t seq) {
+	struct gr_acl_rule key = {.seq = seq};
+	return bsearch(&key, rules, gr_vec_len(rules), sizeof(key), acl_rule_cmp);
+}
+
+static struct api_out acl_rule_add(const void *request, struct api_ctx *ctx) {
+	const struct gr_acl_rule_add_req *req = request;
+	gr_vec struct gr_acl_rule *rules = NULL;
+	struct gr_acl_rule *existing;
+	size_t n_existing;
+	struct iface *iface;
+	int ret;
+
+	if (sizeof(*req) + req->n_rules * sizeof(req->rules[0]) > ctx->header.payload_len)
+		return api_out(EINVAL, 0, NULL);
+	if (req->dir >= GR_ACL_DIR_COUNT)
+		return api_out(EINVAL, 0, NULL);
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+
+	rules = gr_vec_clone(acl_rules[iface->id][req->dir]);
+	n_existing = gr_vec_len(rules);
+
+	for (uint16_t i = 0; i < req->n_rules; i++) {
+		struct gr_acl_rule rule = req->rules[i];
+
+		if (acl_rule_validate(&rule) < 0) {
+			ret = -errno;
+			goto out;
+		}
+		rule.packets = 0;
+
+		// Only the existing rules are sorted at this point.
+		existing = bsearch(&rule, rules, n_existing, sizeof(rule), acl_rule_cmp);
+		if (existing != NULL) {
+			if (!req->exist_ok) {
+				ret = -EEXIST;
+				goto out;
+			}
+			*existing = rule;
+		} else {
+			gr_vec_add(rules, rule);
+		}
+	}
+
+	if (gr_vec_len(rules) > GR_ACL_MAX_RULES) {
+		ret = -ENOSPC;
+		goto out;
+	}
+
+	qsort(rules, gr_vec_len(rules), sizeof(*rules), acl_rule_cmp);
+	for (size_t i = 1; i < gr_vec_len(rules); i++) {
+		if (rules[i].seq == rules[i - 1].seq) {
+			// Duplicate sequence number in the request.
+			ret = -EINVAL;
+			goto out;
+		}
+	}
+
+	if ((ret = acl_apply(iface, req->dir, rules)) < 0)
+		goto out;
+
+	gr_vec_free(acl_rules[iface->id][req->dir]);
+	acl_rules[iface->id][req->dir] = rules;
+	rules = NULL;
+out:
+	gr_vec_free(rules);
+	return api_out(-ret, 0, NULL);
+}
+
+static struct api_out acl_rule_del(const void *request, struct api_ctx *) {
+	const struct gr_acl_rule_del_req *req = request;
+	gr_vec struct gr_acl_rule *rules;
+	struct gr_acl_rule *rule;
+	struct iface *iface;
+	int ret;
+
+	if (req->dir >= GR_ACL_DIR_COUNT)
+		return api_out(EINVAL, 0, NULL);
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+
+	rule = acl_rule_find(acl_rules[iface->id][req->dir], req->seq);
+	if (rule == NULL)
+		return api_out(req->missing_ok ? 0 : ENOENT, 0, NULL);
+
+	rules = gr_vec_clone(acl_rules[iface->id][req->dir]);
+	gr_vec_del(rules, rule - acl_rules[iface->id][req->dir]);
+
+	if ((ret = acl_apply(iface, req->dir, rules)) < 0) {
+		gr_vec_free(rules);
+		return api_out(-ret, 0, NULL);
+	}
+
+	gr_vec_free(acl_rules[iface->id][req->dir]);
+	acl_rules[iface->id][req->dir] = rules;
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out acl_flush(const void *request, struct api_ctx *) {
+	const struct gr_acl_flush_req *req = request;
+	struct iface *iface;
+	int ret;
+
+	if (req->dir >= GR_ACL_DIR_COUNT)
+		return api_out(EINVAL, 0, NULL);
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+
+	if ((ret = acl_apply(iface, req->dir, NULL)) < 0)
+		return api_out(-ret, 0, NULL);
+
+	gr_vec_free(acl_rules[iface->id][req->dir]);
+
+	return api_out(0, 0, NULL);
+}
+
+static uint64_t acl_rule_packets(const struct acl_ruleset *rs, uint32_t *index, uint32_t seq) {
+	if (rs == NULL || *index >= rs->n_rules || rs->rules[*index].seq != seq)
+		return 0;
+	return atomic_load(&rs->rules[(*index)++].packets);
+}
+
+static struct api_out acl_list(const void *request, struct api_ctx *ctx) {
+	const struct gr_acl_list_req *req = request;
+	const struct gr_acl_rule *rule;
+	const struct acl_ruleset *rs4, *rs6;
+	uint32_t i4, i6;
+
+	for (uint16_t iface_id = 0; iface_id < MAX_IFACES; iface_id++) {
+		if (req->iface_id != GR_IFACE_ID_UNDEF && req->iface_id != iface_id)
+			continue;
+
+		for (gr_acl_dir_t dir = 0; dir < GR_ACL_DIR_COUNT; dir++) {
+			rs4 = acl_ruleset_get(iface_id, dir, GR_AF_IP4);
+			rs6 = acl_ruleset_get(iface_id, dir, GR_AF_IP6);
+			i4 = i6 = 0;
+
+			gr_vec_foreach_ref (rule, acl_rules[iface_id][dir]) {
+				struct gr_acl_entry e = {
+					.iface_id = iface_id,
+					.dir = dir,
+					.rule = *rule,
+				};
+				if (rule->af == GR_AF_IP4)
+					e.rule.packets = acl_rule_packets(rs4, &i4, rule->seq);
+				else
+					e.rule.packets = acl_rule_packets(rs6, &i6, rule->seq);
+				api_send(ctx, sizeof(e), &e);
+			}
+		}
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+static void iface_pre_remove_cb(uint32_t /*event*/, const void *obj) {
+	struct iface *iface = (struct iface *)obj;
+
+	for (gr_acl_dir_t dir = 0; dir < GR_ACL_DIR_COUNT; dir++) {
+		if (acl_rules[iface->id][dir] == NULL)
+			continue;
+		if (acl_apply(iface, dir, NULL) < 0)
+			LOG(ERR, "acl_apply(%s): %s", iface->name, strerror(errno));
+		gr_vec_free(acl_rules[iface->id][dir]);
+	}
+}
+
+static void acl_fini(struct event_base *) {
+	for (uint16_t iface_id = 0; iface_id < MAX_IFACES; iface_id++) {
+		for (gr_acl_dir_t dir = 0; dir < GR_ACL_DIR_COUNT; dir++) {
+			struct acl_iface *a = &acl_ifaces[iface_id][dir];
+			acl_ruleset_free(atomic_exchange(&a->ip4, NULL));
+			acl_ruleset_free(atomic_exchange(&a->ip6, NULL));
+			gr_vec_free(acl_rules[iface_id][dir]);
+		}
+	}
+}
+
+static struct gr_api_handler acl_rule_add_handler = {
+	.name = "acl rule add",
+	.request_type = GR_ACL_RULE_ADD,
+	.callback = acl_rule_add,
+};
+static struct gr_api_handler acl_rule_del_handler = {
+	.name = "acl rule del",
+	.request_type = GR_ACL_RULE_DEL,
+	.callback = acl_rule_del,
+};
+static struct gr_api_handler acl_flush_handler = {
+	.name = "acl flush",
+	.request_type = GR_ACL_FLUSH,
+	.callback = acl_flush,
+};
+static struct gr_api_handler acl_list_handler = {
+	.name = "acl list",
+	.request_type = GR_ACL_LIST,
+	.callback = acl_list,
+};
+
+static struct gr_event_subscription iface_pre_remove_subscription = {
+	.callback = iface_pre_remove_cb,
+	.ev_count = 1,
+	.ev_types = {GR_EVENT_IFACE_PRE_REMOVE},
+};
+
+static struct gr_module acl_module = {
+	.name = "acl",
+	.depends_on = "rcu",
+	.fini = acl_fini,
+};
+
+RTE_INIT(acl_constructor) {
+	gr_register_api_handler(&acl_rule_add_handler);
+	gr_register_api_handler(&acl_rule_del_handler);
+	gr_register_api_handler(&acl_flush_handler);
+	gr_register_api_handler(&acl_list_handler);
+	gr_event_subscribe(&iface_pre_remove_subscription);
+	gr_register_module(&acl_module);
+}
@@ -8,10 +8,14 @@
 #include <gr_module.h>
 #include <gr_net_types.h>
 #include <gr_rcu.h>
+#include <gr_vec.h>
 
+#include <event2/event.h>
 #include <rte_hash.h>
+#include <rte_hash_crc.h>
 #include <rte_icmp.h>
 #include <rte_ip.h>
+#include <rte_lcore.h>
 #include <rte_mempool.h>
 #include <rte_tcp.h>
 #include <rte_udp.h>
@@ -313,6 +317,7 @@ bool gr_conn_parse_key(
 #define DEFAULT_TIMEOUT_TCP_ESTABLISHED 300
 #define DEFAULT_TIMEOUT_HALF_CLOSE 120
 #define DEFAULT_TIMEOUT_TIME_WAIT 30
+#define DEFAULT_EARLY_DROP_THRESHOLD 90
 
 static struct gr_conntrack_config conf = {
 	.max_count = DEFAULT_CONN_COUNT,
@@ -322,10 +327,88 @@ static struct gr_conntrack_config conf = {
 	.timeout_tcp_established_sec = DEFAULT_TIMEOUT_TCP_ESTABLISHED,
 	.timeout_half_close_sec = DEFAULT_TIMEOUT_HALF_CLOSE,
 	.timeout_time_wait_sec = DEFAULT_TIMEOUT_TIME_WAIT,
+	.early_drop_threshold = DEFAULT_EARLY_DROP_THRESHOLD,
 };
 static _Atomic(struct rte_hash *) conn_hash;
 static _Atomic(struct rte_mempool *) conn_pool;
 static struct event *ageing_timer;
+static struct event *early_drop_event;
+static atomic_bool early_drop_pending;
+
+// Connections are counted per source address in a fixed array of buckets.
+// Sources sharing a bucket share the same limit. This can only make the
+// limit stricter and avoids any allocation in the datapath.
+#define CONN_SRC_BUCKETS 65536
+static _Atomic(uint32_t) src_counts[CONN_SRC_BUCKETS];
+static _Atomic(uint32_t) iface_counts[MAX_IFACES];
+static _Atomic(uint32_t) conn_count;
+
+// Evict connections until usage is this many percent below the threshold.
+#define EARLY_DROP_HYSTERESIS 5
+// Established connections without traffic for that long are considered idle.
+#define EARLY_DROP_IDLE_SEC 10
+// Maximum number of evictions per run to avoid stalling the event loop.
+// The datapath schedules another run while the table is above the threshold.
+#define EARLY_DROP_BATCH 4096
+
+struct __rte_cache_aligned conn_lcore_stats {
+	BASE(gr_conntrack_stats);
+};
+
+static struct conn_lcore_stats lcore_stats[RTE_MAX_LCORE];
+
+static inline struct gr_conntrack_stats *conn_stats(void) {
+	return &lcore_stats[rte_lcore_id() % RTE_MAX_LCORE].base;
+}
+
+static inline _Atomic(uint32_t) *src_count(const struct conn_key *key) {
+	return &src_counts[rte_hash_crc_4byte(key->src, 0) % CONN_SRC_BUCKETS];
+}
+
+static inline uint32_t early_drop_count(void) {
+	return (uint64_t)conf.max_count * conf.early_drop_threshold / 100;
+}
+
+// Called from datapath workers. Wake up the control plane to evict connections.
+static void early_drop_schedule(void) {
+	if (!atomic_exchange(&early_drop_pending, true))
+		event_active(early_drop_event, 0, 0);
+}
+
+// Enforce the per-source and per-interface limits.
+// Counters are incremented on success and must be released with conn_release().
+static bool conn_admit(const struct conn_key *key) {
+	_Atomic(uint32_t) *src = src_count(key);
+	_Atomic(uint32_t) *iface = &iface_counts[key->iface_id];
+	uint32_t count;
+
+	// Reserve first and roll back when over the limit so that concurrent
+	// workers cannot overshoot it.
+	count = atomic_fetch_add(src, 1);
+	if (conf.max_per_source != 0 && count >= conf.max_per_source) {
+		atomic_fetch_sub(src, 1);
+		conn_stats()->source_limit_drops++;
+		return false;
+	}
+	count = atomic_fetch_add(iface, 1);
+	if (conf.max_per_iface != 0 && count >= conf.max_per_iface) {
+		atomic_fetch_sub(iface, 1);
+		atomic_fetch_sub(src, 1);
+		conn_stats()->iface_limit_drops++;
+		return false;
+	}
+
+	if (atomic_fetch_add(&conn_count, 1) + 1 >= early_drop_count())
+		early_drop_schedule();
+
+	return true;
+}
+
+static void conn_release(const struct conn_key *key) {
+	atomic_fetch_sub(src_count(key), 1);
+	atomic_fetch_sub(&iface_counts[key->iface_id], 1);
+	atomic_fetch_sub(&conn_count, 1);
+}
 
 #define CONN_FLOW_FWD_BIT ((uintptr_t)0x1)
 
@@ -360,9 +443,12 @@ struct conn *gr_conn_insert(const struct conn_key *fwd_key, const struct conn_ke
 	struct conn *conn;
 	void *data;
 
+	if (!conn_admit(fwd_key))
+		return NULL;
+
 	// create a new connection object
 	if (rte_mempool_get(conn_pool, &data) < 0)
-		return NULL;
+		goto full;
 
 	conn = data;
 	memset(conn, 0, sizeof(*conn));
@@ -372,7 +458,7 @@ struct conn *gr_conn_insert(const struct conn_key *fwd_key, const struct conn_ke
 	if (rte_hash_add_key_data(conn_hash, fwd_key, conn_data(data, CONN_FLOW_FWD)) < 0) {
 		// hash full
 		rte_mempool_put(conn_pool, data);
-		return NULL;
+		goto full;
 	}
 
 	// Also reference the conntrack by its *reverse* key for replies.
@@ -380,10 +466,128 @@ struct conn *gr_conn_insert(const struct conn_key *fwd_key, const struct conn_ke
 		// hash full, remove forward key,
 		rte_hash_del_key(conn_hash, fwd_key);
 		rte_mempool_put(conn_pool, data);
-		return NULL;
+		goto full;
 	}
 
 	return conn;
+full:
+	conn_release(fwd_key);
+	conn_stats()->table_full_drops++;
+	early_drop_schedule();
+	return NULL;
+}
+
+static void conn_unlink(struct conn *conn) {
+	rte_hash_del_key(conn_hash, &conn->fwd_key);
+	rte_hash_del_key(conn_hash, &conn->rev_key);
+}
+
+// Must only be called after an RCU grace period following conn_unlink().
+static void conn_free(struct conn *conn) {
+	gr_conn_snat44_release(conn);
+	conn_release(&conn->fwd_key);
+	rte_mempool_put(rte_mempool_from_obj(conn), conn);
+}
+
+void gr_conn_destroy(struct conn *conn) {
+	conn_unlink(conn);
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+	conn_free(conn);
+}
+
+static inline bool conn_is_embryonic(gr_conn_state_t state) {
+	switch (state) {
+	case CONN_S_NEW:
+	case CONN_S_SIMSYN_SENT:
+	case CONN_S_SYN_RECEIVED:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Unlink at most max matching connections until the table usage goes below
+// target. The hash releases its key slots lazily (RTE_HASH_QSBR_MODE_DQ) and
+// all evicted connections are freed after a single RCU grace period.
+static unsigned early_drop_pass(uint32_t target, bool embryonic, unsigned max) {
+	gr_vec struct conn **evicted = NULL;
+	clock_t now = gr_clock_us(), last;
+	gr_conn_state_t state;
+	struct conn *conn;
+	const void *key;
+	uint32_t iter;
+	unsigned n;
+	void *data;
+
+	n = atomic_load(&conn_count);
+	iter = 0;
+	while (n > target && gr_vec_len(evicted) < max
+	       && rte_hash_iterate(conn_hash, &key, &data, &iter) >= 0) {
+		if (conn_flow(data) != CONN_FLOW_FWD)
+			continue;
+		conn = conn_ptr(data);
+		state = atomic_load(&conn->state);
+		if (embryonic != conn_is_embryonic(state))
+			continue;
+		if (!embryonic && state == CONN_S_ESTABLISHED) {
+			last = atomic_load(&conn->last_update);
+			if (last > now || (now - last) / 1000000ULL < EARLY_DROP_IDLE_SEC)
+				continue;
+		}
+		conn_unlink(conn);
+		gr_vec_add(evicted, conn);
+		n--;
+	}
+
+	if (gr_vec_len(evicted) > 0) {
+		rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+		gr_vec_foreach (conn, evicted)
+			conn_free(conn);
+	}
+	n = gr_vec_len(evicted);
+	gr_vec_free(evicted);
+
+	return n;
+}
+
+// Make room for new connections when the table is close to full.
+// Embryonic connections are evicted first, then idle and closing ones.
+// Active established connections are never evicted.
+static unsigned early_drop(void) {
+	uint32_t threshold = early_drop_count();
+	unsigned n, total;
+	uint32_t target;
+
+	if (atomic_load(&conn_count) < threshold)
+		return 0;
+
+	target = threshold - (uint64_t)conf.max_count * EARLY_DROP_HYSTERESIS / 100;
+	if (target > threshold)
+		target = 0;
+
+	n = early_drop_pass(target, true, EARLY_DROP_BATCH);
+	conn_stats()->early_drop_embryonic += n;
+	if (n > 0)
+		LOG(NOTICE, "evicted %u embryonic connections", n);
+	total = n;
+
+	if (atomic_load(&conn_count) <= target || total >= EARLY_DROP_BATCH)
+		return total;
+
+	n = early_drop_pass(target, false, EARLY_DROP_BATCH - total);
+	conn_stats()->early_drop_idle += n;
+	if (n > 0)
+		LOG(NOTICE, "evicted %u idle connections", n);
+
+	return total + n;
+}
+
+static void early_drop_cb(evutil_socket_t, short /*what*/, void * /*priv*/) {
+	// When nothing could be evicted, leave the flag set so that the datapath
+	// does not wake us up again for each new connection. The ageing timer
+	// will clear it on its next run.
+	if (early_drop() > 0)
+		atomic_store(&early_drop_pending, false);
 }
 
 static void do_ageing(evutil_socket_t, short /*what*/, void * /*priv*/) {
@@ -446,6 +650,9 @@ static void do_ageing(evutil_socket_t, short /*what*/, void * /*priv*/) {
 		if (age > timeout)
 			gr_conn_destroy(conn);
 	}
+
+	early_drop();
+	atomic_store(&early_drop_pending, false);
 }
 
 void gr_conn_snat44_purge(struct snat44_policy *policy) {
@@ -464,15 +671,10 @@ void gr_conn_snat44_purge(struct snat44_policy *policy) {
 	}
 }
 
-void gr_conn_destroy(struct conn *conn) {
-	rte_hash_del_key(conn_hash, &conn->fwd_key);
-	rte_hash_del_key(conn_hash, &conn->rev_key);
-	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
-	gr_conn_snat44_free_port(conn->nat.policy, conn->fwd_key.proto, conn->nat.tran_id);
-	rte_mempool_put(rte_mempool_from_obj(conn), conn);
-}
-
 static int config_update(const struct gr_conntrack_config *new_conf) {
+	if (new_conf->early_drop_threshold > 100)
+		return errno_set(ERANGE);
+
 	if ((new_conf->max_count != 0 && new_conf->max_count != conf.max_count)
 	    || conn_hash == NULL) {
 		uint32_t iter = 0;
@@ -514,9 +716,11 @@ static int config_update(const struct gr_conntrack_config *new_conf) {
 			return errno_log(rte_errno, "rte_hash_create(conn)");
 		}
 
+		// Deleted key slots are reclaimed lazily instead of waiting for
+		// a grace period on each deletion.
 		struct rte_hash_rcu_config ct_config = {
 			.v = gr_datapath_rcu(),
-			.mode = RTE_HASH_QSBR_MODE_SYNC,
+			.mode = RTE_HASH_QSBR_MODE_DQ,
 		};
 		if (rte_hash_rcu_qsbr_add(h, &ct_config) != 0) {
 			rte_mempool_free(p);
@@ -555,6 +759,19 @@ static int config_update(const struct gr_conntrack_config *new_conf) {
 	if (new_conf->timeout_time_wait_sec != 0)
 		conf.timeout_time_wait_sec = new_conf->timeout_time_wait_sec;
 
+	if (new_conf->max_per_source == GR_CONNTRACK_UNLIMITED)
+		conf.max_per_source = 0;
+	else if (new_conf->max_per_source != 0)
+		conf.max_per_source = new_conf->max_per_source;
+
+	if (new_conf->max_per_iface == GR_CONNTRACK_UNLIMITED)
+		conf.max_per_iface = 0;
+	else if (new_conf->max_per_iface != 0)
+		conf.max_per_iface = new_conf->max_per_iface;
+
+	if (new_conf->early_drop_threshold != 0)
+		conf.early_drop_threshold = new_conf->early_drop_threshold;
+
 	return 0;
 }
 
@@ -590,6 +807,7 @@ static struct api_out conntrack_list(const void * /*request*/, struct api_ctx *c
 			.last_update = atomic_load(&conn->last_update),
 		};
 		api_send(ctx, sizeof(ct), &ct);
+		api_quiescent();
 	}
 
 	return api_out(0, 0, NULL);
@@ -599,6 +817,7 @@ static struct gr_api_handler conn_list_handler = {
 	.name = "conntrack list",
 	.request_type = GR_CONNTRACK_LIST,
 	.callback = conntrack_list,
+	.background = true,
 };
 
 static struct api_out conntrack_flush(const void * /*request*/, struct api_ctx *) {
@@ -650,6 +869,16 @@ static struct api_out config_get(const void * /*request*/, struct api_ctx *) {
 
 	resp->base = conf;
 	resp->used_count = 0;
+	memset(&resp->stats, 0, sizeof(resp->stats));
+
+	for (unsigned i = 0; i < ARRAY_DIM(lcore_stats); i++) {
+		const struct gr_conntrack_stats *st = &lcore_stats[i].base;
+		resp->stats.source_limit_drops += st->source_limit_drops;
+		resp->stats.iface_limit_drops += st->iface_limit_drops;
+		resp->stats.table_full_drops += st->table_full_drops;
+		resp->stats.early_drop_embryonic += st->early_drop_embryonic;
+		resp->stats.early_drop_idle += st->early_drop_idle;
+	}
 
 	iter = 0;
 	while (rte_hash_iterate(conn_hash, &key, &data, &iter) >= 0) {
@@ -676,11 +905,17 @@ static void conntrack_init(struct event_base *ev_base) {
 
 	if (event_add(ageing_timer, &(struct timeval) {.tv_sec = 1}) < 0)
 		ABORT("event_add() failed");
+
+	early_drop_event = event_new(ev_base, -1, EV_FINALIZE, early_drop_cb, NULL);
+	if (early_drop_event == NULL)
+		ABORT("event_new() failed");
 }
 
 static void conntrack_fini(struct event_base *) {
 	if (ageing_timer)
 		event_free(ageing_timer);
+	if (early_drop_event)
+		event_free(early_drop_event);
 	rte_hash_free(conn_hash);
 	rte_mempool_free(conn_pool);
 }
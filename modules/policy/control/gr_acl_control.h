@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_acl.h>
+#include <gr_iface.h>
+#include <gr_net_types.h>
+
+#include <rte_acl.h>
+#include <rte_byteorder.h>
+#include <rte_ip6.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Classification keys built by the datapath from packet headers. The rte_acl
+// field definitions refer to offsets in these structures. All fields are in
+// network order, except dscp which is shifted to its 6 bit value.
+struct acl4_key {
+	uint8_t proto;
+	uint8_t dscp;
+	uint16_t _pad;
+	ip4_addr_t src;
+	ip4_addr_t dst;
+	rte_be16_t sport;
+	rte_be16_t dport;
+};
+
+struct acl6_key {
+	uint8_t proto;
+	uint8_t dscp;
+	uint16_t _pad;
+	struct rte_ipv6_addr src;
+	struct rte_ipv6_addr dst;
+	rte_be16_t sport;
+	rte_be16_t dport;
+};
+
+struct acl_rule_state {
+	_Atomic(uint64_t) packets;
+	uint32_t seq;
+	gr_acl_action_t action;
+};
+
+// Compiled classifier for one interface, direction and address family.
+// Rule sets are never modified once published. Changing the rules of an
+// interface builds a new rule set and frees the previous one after an RCU
+// grace period.
+struct acl_ruleset {
+	struct rte_acl_ctx *ctx;
+	uint32_t n_rules;
+	// The rte_acl userdata of a rule is its index in this array + 1.
+	struct acl_rule_state rules[];
+};
+
+struct acl_iface {
+	_Atomic(struct acl_ruleset *) ip4;
+	_Atomic(struct acl_ruleset *) ip6;
+};
+
+extern struct acl_iface acl_ifaces[MAX_IFACES][GR_ACL_DIR_COUNT];
+
+static inline struct acl_ruleset *
+acl_ruleset_get(uint16_t iface_id, gr_acl_dir_t dir, addr_family_t af) {
+	const struct acl_iface *a = &acl_ifaces[iface_id][dir];
+	if (af == GR_AF_IP4)
+		return atomic_load_explicit(&a->ip4, memory_order_acquire);
+	return atomic_load_explicit(&a->ip6, memory_order_acquire);
+}
+
+// Check the consistency of packet match criteria.
+int acl_match_validate(const struct gr_acl_match *);
+
+// Compile match criteria of one address family into a new classifier.
+// The rte_acl userdata of each rule is its index in the matches array + 1.
+// Earlier entries take precedence over later ones.
+struct rte_acl_ctx *acl_classifier_build(
+	const char *name,
+	addr_family_t af,
+	const struct gr_acl_match *const *matches,
+	uint32_t n
+);
@@ -58,7 +58,11 @@ void gr_conn_update(struct conn *, const conn_flow_t, const struct rte_tcp_hdr *
 void gr_conn_destroy(struct conn *);
 void gr_conn_snat44_purge(struct snat44_policy *);
 void gr_conn_snat44_free_port(struct snat44_policy *, uint8_t proto, rte_be16_t port);
+void gr_conn_snat44_release(struct conn *);
 struct conn *snat44_conntrack_create(const struct conn_key *);
+// Create a connection for a packet received from any remote endpoint on the
+// external side of an endpoint independent mapping. The packet is the forward flow.
+struct conn *snat44_conntrack_create_inbound(const struct conn_key *);
 
 GR_MBUF_PRIV_DATA_TYPE(conn_mbuf_data, {
 	struct conn *conn;
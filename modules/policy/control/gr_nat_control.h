@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <gr_clock.h>
 #include <gr_id_pool.h>
 #include <gr_iface.h>
 #include <gr_nat.h>
@@ -12,6 +13,10 @@
 
 #include <rte_byteorder.h>
 
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
 int snat44_static_policy_add(struct iface *, ip4_addr_t match, ip4_addr_t replace);
 int snat44_static_policy_del(struct iface *, ip4_addr_t match);
 bool snat44_static_lookup_translation(uint16_t iface_id, ip4_addr_t orig, ip4_addr_t *trans);
@@ -22,16 +27,91 @@ gr_vec struct gr_snat44_policy *snat44_dynamic_policy_export(void);
 
 struct snat44_policy {
 	BASE(gr_snat44_policy);
+	uint16_t vrf_id;
+	bool dead; //!< Being deleted, no new mapping can be created.
 	struct gr_id_pool *tcp_ports;
 	struct gr_id_pool *udp_ports;
 	struct gr_id_pool *icmp_ids;
 	STAILQ_ENTRY(snat44_policy) next;
 };
 
+// Endpoint independent mapping lookup key.
+struct snat44_mapping_key {
+	ip4_addr_t addr;
+	//! Output interface for internal endpoints, VRF for external endpoints.
+	uint16_t id;
+	rte_be16_t port;
+	uint8_t proto;
+	uint8_t __pad[3];
+};
+
+// One external endpoint reused for all destinations of an internal endpoint.
+// Mappings are referenced by connections and expire when they are unused.
+struct snat44_mapping {
+	struct snat44_mapping_key int_key;
+	struct snat44_mapping_key ext_key;
+	struct snat44_policy *policy;
+	_Atomic(uint32_t) refcnt; //!< Number of connections using this mapping.
+	_Atomic(clock_t) last_used;
+};
+
+// Number of endpoint independent policies. Read by the datapath to avoid
+// looking up mappings when the feature is not in use.
+extern unsigned snat44_eim_policies;
+
+// Lookup or create the mapping of an internal endpoint and take a reference.
+struct snat44_mapping *
+snat44_mapping_get(struct snat44_policy *, uint8_t proto, ip4_addr_t addr, rte_be16_t port);
+// Release a reference taken with snat44_mapping_get().
+void snat44_mapping_put(struct snat44_mapping *);
+// Lookup up to RTE_HASH_LOOKUP_BULK_MAX mappings by internal or external endpoint.
+// Return a bit mask of the keys which were found.
+uint64_t snat44_mapping_lookup_bulk(
+	bool external,
+	const struct snat44_mapping_key **keys,
+	unsigned n,
+	struct snat44_mapping **mappings
+);
+
 struct nat44 {
 	struct snat44_policy *policy;
+	struct snat44_mapping *mapping; //!< NULL for endpoint dependent policies.
 	ip4_addr_t orig_addr;
 	ip4_addr_t tran_addr;
 	rte_be16_t orig_id;
 	rte_be16_t tran_id;
 };
+
+// Session logging. Datapath workers queue records in per-worker rings which
+// are drained by the control plane. Records produced by the control plane
+// are written directly. The datapath never blocks on logging.
+extern atomic_bool snat44_log_enabled;
+
+void snat44_log_push(const struct gr_snat44_log_record *);
+int snat44_log_config_set(const struct gr_snat44_log_config *);
+void snat44_log_config_get(struct gr_snat44_log_conf_get_resp *);
+
+static inline void snat44_log(
+	gr_snat44_log_event_t event,
+	uint16_t vrf_id,
+	uint8_t proto,
+	ip4_addr_t inside_addr,
+	rte_be16_t inside_port,
+	ip4_addr_t outside_addr,
+	rte_be16_t outside_port
+) {
+	if (!atomic_load_explicit(&snat44_log_enabled, memory_order_relaxed))
+		return;
+
+	struct gr_snat44_log_record rec = {
+		.timestamp = gr_clock_us(),
+		.inside_addr = inside_addr,
+		.outside_addr = outside_addr,
+		.inside_port = inside_port,
+		.outside_port = outside_port,
+		.vrf_id = vrf_id,
+		.proto = proto,
+		.event = event,
+	};
+	snat44_log_push(&rec);
+}
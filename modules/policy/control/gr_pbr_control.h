@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_iface.h>
+#include <gr_net_types.h>
+#include <gr_nh_control.h>
+#include <gr_pbr.h>
+
+#include <rte_acl.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+struct pbr_rule_state {
+	_Atomic(uint64_t) packets;
+	uint32_t seq;
+	gr_pbr_action_t action;
+	uint16_t vrf_id;
+	const struct nexthop *nh;
+};
+
+// Compiled classifier for one interface and address family. Rule sets follow
+// the same lifecycle as ACL rule sets: they are never modified once published
+// and the previous one is freed after an RCU grace period.
+struct pbr_ruleset {
+	struct rte_acl_ctx *ctx;
+	uint32_t n_rules;
+	// The rte_acl userdata of a rule is its index in this array + 1.
+	struct pbr_rule_state rules[];
+};
+
+struct pbr_iface {
+	_Atomic(struct pbr_ruleset *) ip4;
+	_Atomic(struct pbr_ruleset *) ip6;
+};
+
+extern struct pbr_iface pbr_ifaces[MAX_IFACES];
+
+static inline struct pbr_ruleset *pbr_ruleset_get(uint16_t iface_id, addr_family_t af) {
+	const struct pbr_iface *p = &pbr_ifaces[iface_id];
+	if (af == GR_AF_IP4)
+		return atomic_load_explicit(&p->ip4, memory_order_acquire);
+	return atomic_load_explicit(&p->ip6, memory_order_acquire);
+}
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_iface.h>
+#include <gr_qos.h>
+
+#include <rte_build_config.h>
+#include <rte_meter.h>
+#include <rte_sched.h>
+#include <rte_spinlock.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Meters are not thread safe. Queues of the same port may be polled by
+// different workers, the lock serializes them.
+struct qos_policer {
+	rte_spinlock_t lock;
+	struct gr_policer_conf conf;
+	union {
+		struct rte_meter_srtcm srtcm;
+		struct rte_meter_trtcm trtcm;
+	};
+	union {
+		struct rte_meter_srtcm_profile srtcm_profile;
+		struct rte_meter_trtcm_profile trtcm_profile;
+	};
+	struct gr_color_stats stats[GR_COLOR_COUNT];
+};
+
+extern _Atomic(struct qos_policer *) qos_policers[MAX_IFACES];
+
+static inline struct qos_policer *qos_policer_get(uint16_t iface_id) {
+	return atomic_load_explicit(&qos_policers[iface_id], memory_order_acquire);
+}
+
+#define QOS_VLAN_COUNT 4096
+
+// Hierarchical scheduler of a port: one subport, one pipe per subscriber and
+// one queue per traffic class. Pipe 0 is the default subscriber.
+struct qos_sched {
+	// rte_sched ports are not thread safe. Every worker may transmit on
+	// the port, the lock serializes enqueue and dequeue operations.
+	rte_spinlock_t lock;
+	struct rte_sched_port *port;
+	uint16_t iface_id;
+	uint16_t port_id;
+	struct gr_qos_sched_conf conf;
+	// Subscriber pipe index for each VLAN ID of the port.
+	uint16_t vlan_pipes[QOS_VLAN_COUNT];
+};
+
+extern _Atomic(struct qos_sched *) qos_scheds[RTE_MAX_ETHPORTS];
+extern _Atomic(unsigned) qos_sched_count;
+
+static inline struct qos_sched *qos_sched_get(uint16_t port_id) {
+	return atomic_load_explicit(&qos_scheds[port_id], memory_order_acquire);
+}
+
+// Map a DSCP value to a traffic class and queue of an rte_sched pipe.
+static inline void qos_dscp_queue(uint8_t dscp, uint32_t *tc, uint32_t *queue) {
+	uint8_t cs = dscp >> 3;
+	if (cs >= 2) {
+		*tc = 7 - cs;
+		*queue = 0;
+	} else {
+		*tc = RTE_SCHED_TRAFFIC_CLASS_BE;
+		*queue = cs;
+	}
+}
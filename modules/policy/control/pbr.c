@@ -0,0 +1,454 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_acl_control.h>
+#include <gr_api.h>
+#include <gr_event.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_nh_control.h>
+#include <gr_pbr.h>
+#include <gr_pbr_control.h>
+#include <gr_rcu.h>
+#include <gr_vec.h>
+
+#include <rte_acl.h>
+#include <rte_malloc.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct pbr_iface pbr_ifaces[MAX_IFACES];
+
+// Configured rules of each interface, sorted by sequence number. Each rule
+// with a nexthop action holds a reference on its nexthop.
+static gr_vec struct gr_pbr_rule *pbr_rules[MAX_IFACES];
+
+static void pbr_ruleset_free(struct pbr_ruleset *rs) {
+	if (rs == NULL)
+		return;
+	rte_acl_free(rs->ctx);
+	rte_free(rs);
+}
+
+// Compile the rules of the given address family into a new classifier.
+// Counters of the rules that already existed in the old rule set are kept.
+static int pbr_ruleset_build(
+	uint16_t iface_id,
+	addr_family_t af,
+	const struct gr_pbr_rule *rules,
+	const struct pbr_ruleset *old,
+	struct pbr_ruleset **out
+) {
+	gr_vec const struct gr_acl_match **matches = NULL;
+	struct pbr_ruleset *rs = NULL;
+	char name[RTE_ACL_NAMESIZE];
+	static unsigned generation;
+	uint32_t n, o = 0;
+
+	*out = NULL;
+
+	gr_vec_foreach_ref (const struct gr_pbr_rule *rule, rules) {
+		if (rule->af == af)
+			gr_vec_add(matches, &rule->base);
+	}
+	n = gr_vec_len(matches);
+	if (n == 0)
+		return 0;
+
+	rs = rte_zmalloc(__func__, sizeof(*rs) + n * sizeof(rs->rules[0]), RTE_CACHE_LINE_SIZE);
+	if (rs == NULL) {
+		errno = ENOMEM;
+		goto err;
+	}
+
+	// The old and new rule sets share the same ordering.
+	gr_vec_foreach_ref (const struct gr_pbr_rule *rule, rules) {
+		struct pbr_rule_state *s;
+
+		if (rule->af != af)
+			continue;
+
+		s = &rs->rules[rs->n_rules];
+		s->seq = rule->seq;
+		s->action = rule->action;
+		if (rule->action == GR_PBR_ACTION_VRF) {
+			s->vrf_id = rule->vrf_id;
+		} else {
+			s->nh = nexthop_lookup_by_id(rule->nh_id);
+			if (s->nh == NULL)
+				goto err;
+		}
+		while (old != NULL && o < old->n_rules && old->rules[o].seq < rule->seq)
+			o++;
+		if (old != NULL && o < old->n_rules && old->rules[o].seq == rule->seq)
+			atomic_init(&s->packets, atomic_load(&old->rules[o].packets));
+
+		rs->n_rules++;
+	}
+
+	snprintf(name, sizeof(name), "pbr%u_%u_%x", iface_id, af, generation++);
+	rs->ctx = acl_classifier_build(name, af, matches, n);
+	if (rs->ctx == NULL)
+		goto err;
+
+	gr_vec_free(matches);
+	*out = rs;
+	return 0;
+err:
+	gr_vec_free(matches);
+	pbr_ruleset_free(rs);
+	return -errno;
+}
+
+// Replace the classifiers of an interface.
+static int pbr_apply(struct iface *iface, const struct gr_pbr_rule *rules) {
+	struct pbr_iface *p = &pbr_ifaces[iface->id];
+	struct pbr_ruleset *rs4, *rs6, *old4, *old6;
+
+	old4 = atomic_load(&p->ip4);
+	old6 = atomic_load(&p->ip6);
+
+	if (pbr_ruleset_build(iface->id, GR_AF_IP4, rules, old4, &rs4) < 0)
+		return -errno;
+	if (pbr_ruleset_build(iface->id, GR_AF_IP6, rules, old6, &rs6) < 0) {
+		pbr_ruleset_free(rs4);
+		return -errno;
+	}
+
+	atomic_store_explicit(&p->ip4, rs4, memory_order_release);
+	atomic_store_explicit(&p->ip6, rs6, memory_order_release);
+	if (gr_vec_len(rules) > 0)
+		iface->flags |= GR_IFACE_F_PBR;
+	else
+		iface->flags &= ~GR_IFACE_F_PBR;
+
+	if (old4 != NULL || old6 != NULL) {
+		rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+		pbr_ruleset_free(old4);
+		pbr_ruleset_free(old6);
+	}
+
+	return 0;
+}
+
+static void pbr_rules_incref(const struct gr_pbr_rule *rules) {
+	gr_vec_foreach_ref (const struct gr_pbr_rule *rule, rules) {
+		if (rule->action == GR_PBR_ACTION_NEXTHOP)
+			nexthop_incref(nexthop_lookup_by_id(rule->nh_id));
+	}
+}
+
+// Release the nexthop references of rules which have been replaced.
+// The rules must not be visible in pbr_rules anymore when this is called:
+// dropping the last reference of a nexthop triggers nh_delete_cb.
+static void pbr_rules_decref(const struct gr_pbr_rule *rules) {
+	gr_vec_foreach_ref (const struct gr_pbr_rule *rule, rules) {
+		if (rule->action == GR_PBR_ACTION_NEXTHOP)
+			nexthop_decref(nexthop_lookup_by_id(rule->nh_id));
+	}
+}
+
+static int pbr_rule_validate(const struct gr_pbr_rule *rule) {
+	const struct nexthop *nh;
+	addr_family_t af;
+
+	if (acl_match_validate(&rule->base) < 0)
+		return -errno;
+
+	switch (rule->action) {
+	case GR_PBR_ACTION_VRF:
+		if (rule->vrf_id >= GR_MAX_VRFS)
+			return errno_set(EOVERFLOW);
+		break;
+	case GR_PBR_ACTION_NEXTHOP:
+		if ((nh = nexthop_lookup_by_id(rule->nh_id)) == NULL)
+			return -errno;
+		switch (nh->type) {
+		case GR_NH_T_L3:
+			af = nexthop_info_l3(nh)->af;
+			if (af != GR_AF_UNSPEC && af != rule->af)
+				return errno_set(EAFNOSUPPORT);
+			break;
+		case GR_NH_T_GROUP:
+		case GR_NH_T_SR6_OUTPUT:
+		case GR_NH_T_MPLS:
+		case GR_NH_T_BLACKHOLE:
+		case GR_NH_T_REJECT:
+			break;
+		default:
+			return errno_set(EPROTOTYPE);
+		}
+		break;
+	default:
+		return errno_set(EINVAL);
+	}
+
+	return 0;
+}
+
+static int pbr_rule_cmp(const void *a, const void *b) {
+	const struct gr_pbr_rule *ra = a;
+	const struct gr_pbr_rule *rb = b;
+	return (ra->seq > rb->seq) - (ra->seq < rb->seq);
+}
+
+static struct gr_pbr_rule *pbr_rule_find(const struct gr_pbr_rule *rules, uint32_t seq) {
+	struct gr_pbr_rule key = {.seq = seq};
+	return bsearch(&key, rules, gr_vec_len(rules), sizeof(key), pbr_rule_cmp);
+}
+
+// Publish a new set of rules for an interface and release the previous one.
+static int pbr_replace(struct iface *iface, gr_vec struct gr_pbr_rule *rules) {
+	gr_vec struct gr_pbr_rule *old = pbr_rules[iface->id];
+	int ret;
+
+	if ((ret = pbr_apply(iface, rules)) < 0)
+		return ret;
+
+	pbr_rules_incref(rules);
+	pbr_rules[iface->id] = rules;
+	pbr_rules_decref(old);
+	gr_vec_free(old);
+
+	return 0;
+}
+
+static struct api_out pbr_rule_add(const void *request, struct api_ctx *ctx) {
+	const struct gr_pbr_rule_add_req *req = request;
+	gr_vec struct gr_pbr_rule *rules = NULL;
+	struct gr_pbr_rule *existing;
+	size_t n_existing;
+	struct iface *iface;
+	int ret;
+
+	if (sizeof(*req) + req->n_rules * sizeof(req->rules[0]) > ctx->header.payload_len)
+		return api_out(EINVAL, 0, NULL);
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+
+	rules = gr_vec_clone(pbr_rules[iface->id]);
+	n_existing = gr_vec_len(rules);
+
+	for (uint16_t i = 0; i < req->n_rules; i++) {
+		struct gr_pbr_rule rule = req->rules[i];
+
+		if (pbr_rule_validate(&rule) < 0) {
+			ret = -errno;
+			goto out;
+		}
+		rule.packets = 0;
+
+		// Only the existing rules are sorted at this point.
+		existing = bsearch(&rule, rules, n_existing, sizeof(rule), pbr_rule_cmp);
+		if (existing != NULL) {
+			if (!req->exist_ok) {
+				ret = -EEXIST;
+				goto out;
+			}
+			*existing = rule;
+		} else {
+			gr_vec_add(rules, rule);
+		}
+	}
+
+	if (gr_vec_len(rules) > GR_PBR_MAX_RULES) {
+		ret = -ENOSPC;
+		goto out;
+	}
+
+	qsort(rules, gr_vec_len(rules), sizeof(*rules), pbr_rule_cmp);
+	for (size_t i = 1; i < gr_vec_len(rules); i++) {
+		if (rules[i].seq == rules[i - 1].seq) {
+			// Duplicate sequence number in the request.
+			ret = -EINVAL;
+			goto out;
+		}
+	}
+
+	if ((ret = pbr_replace(iface, rules)) < 0)
+		goto out;
+	rules = NULL;
+out:
+	gr_vec_free(rules);
+	return api_out(-ret, 0, NULL);
+}
+
+static struct api_out pbr_rule_del(const void *request, struct api_ctx *) {
+	const struct gr_pbr_rule_del_req *req = request;
+	gr_vec struct gr_pbr_rule *rules;
+	struct gr_pbr_rule *rule;
+	struct iface *iface;
+	int ret;
+
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+
+	rule = pbr_rule_find(pbr_rules[iface->id], req->seq);
+	if (rule == NULL)
+		return api_out(req->missing_ok ? 0 : ENOENT, 0, NULL);
+
+	rules = gr_vec_clone(pbr_rules[iface->id]);
+	gr_vec_del(rules, rule - pbr_rules[iface->id]);
+
+	if ((ret = pbr_replace(iface, rules)) < 0) {
+		gr_vec_free(rules);
+		return api_out(-ret, 0, NULL);
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out pbr_flush(const void *request, struct api_ctx *) {
+	const struct gr_pbr_flush_req *req = request;
+	struct iface *iface;
+	int ret;
+
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+
+	if ((ret = pbr_replace(iface, NULL)) < 0)
+		return api_out(-ret, 0, NULL);
+
+	return api_out(0, 0, NULL);
+}
+
+static uint64_t pbr_rule_packets(const struct pbr_ruleset *rs, uint32_t *index, uint32_t seq) {
+	if (rs == NULL || *index >= rs->n_rules || rs->rules[*index].seq != seq)
+		return 0;
+	return atomic_load(&rs->rules[(*index)++].packets);
+}
+
+static struct api_out pbr_list(const void *request, struct api_ctx *ctx) {
+	const struct gr_pbr_list_req *req = request;
+	const struct pbr_ruleset *rs4, *rs6;
+	const struct gr_pbr_rule *rule;
+	uint32_t i4, i6;
+
+	for (uint16_t iface_id = 0; iface_id < MAX_IFACES; iface_id++) {
+		if (req->iface_id != GR_IFACE_ID_UNDEF && req->iface_id != iface_id)
+			continue;
+
+		rs4 = pbr_ruleset_get(iface_id, GR_AF_IP4);
+		rs6 = pbr_ruleset_get(iface_id, GR_AF_IP6);
+		i4 = i6 = 0;
+
+		gr_vec_foreach_ref (rule, pbr_rules[iface_id]) {
+			struct gr_pbr_entry e = {
+				.iface_id = iface_id,
+				.rule = *rule,
+			};
+			if (rule->af == GR_AF_IP4)
+				e.rule.packets = pbr_rule_packets(rs4, &i4, rule->seq);
+			else
+				e.rule.packets = pbr_rule_packets(rs6, &i6, rule->seq);
+			api_send(ctx, sizeof(e), &e);
+		}
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+static void iface_pre_remove_cb(uint32_t /*event*/, const void *obj) {
+	struct iface *iface = (struct iface *)obj;
+
+	if (pbr_rules[iface->id] == NULL)
+		return;
+	if (pbr_replace(iface, NULL) < 0)
+		LOG(ERR, "pbr_replace(%s): %s", iface->name, strerror(errno));
+}
+
+// Remove rules that reference a nexthop which is being destroyed.
+static void nh_delete_cb(uint32_t /*event*/, const void *obj) {
+	const struct nexthop *nh = obj;
+	gr_vec struct gr_pbr_rule *rules;
+	struct iface *iface;
+
+	for (uint16_t iface_id = 0; iface_id < MAX_IFACES; iface_id++) {
+		bool found = false;
+
+		if (pbr_rules[iface_id] == NULL)
+			continue;
+
+		rules = NULL;
+		gr_vec_foreach (struct gr_pbr_rule rule, pbr_rules[iface_id]) {
+			if (rule.action == GR_PBR_ACTION_NEXTHOP && rule.nh_id == nh->nh_id)
+				found = true;
+			else
+				gr_vec_add(rules, rule);
+		}
+		if (!found || (iface = iface_from_id(iface_id)) == NULL) {
+			gr_vec_free(rules);
+			continue;
+		}
+
+		// The reference has already been released by the caller.
+		if (pbr_apply(iface, rules) < 0) {
+			LOG(ERR, "pbr_apply(%s): %s", iface->name, strerror(errno));
+			gr_vec_free(rules);
+			continue;
+		}
+		gr_vec_free(pbr_rules[iface_id]);
+		pbr_rules[iface_id] = rules;
+	}
+}
+
+static void pbr_fini(struct event_base *) {
+	for (uint16_t iface_id = 0; iface_id < MAX_IFACES; iface_id++) {
+		struct pbr_iface *p = &pbr_ifaces[iface_id];
+		pbr_ruleset_free(atomic_exchange(&p->ip4, NULL));
+		pbr_ruleset_free(atomic_exchange(&p->ip6, NULL));
+		gr_vec_free(pbr_rules[iface_id]);
+	}
+}
+
+static struct gr_api_handler pbr_rule_add_handler = {
+	.name = "pbr rule add",
+	.request_type = GR_PBR_RULE_ADD,
+	.callback = pbr_rule_add,
+};
+static struct gr_api_handler pbr_rule_del_handler = {
+	.name = "pbr rule del",
+	.request_type = GR_PBR_RULE_DEL,
+	.callback = pbr_rule_del,
+};
+static struct gr_api_handler pbr_flush_handler = {
+	.name = "pbr flush",
+	.request_type = GR_PBR_FLUSH,
+	.callback = pbr_flush,
+};
+static struct gr_api_handler pbr_list_handler = {
+	.name = "pbr list",
+	.request_type = GR_PBR_LIST,
+	.callback = pbr_list,
+};
+
+static struct gr_event_subscription iface_pre_remove_subscription = {
+	.callback = iface_pre_remove_cb,
+	.ev_count = 1,
+	.ev_types = {GR_EVENT_IFACE_PRE_REMOVE},
+};
+
+static struct gr_event_subscription nh_delete_subscription = {
+	.callback = nh_delete_cb,
+	.ev_count = 1,
+	.ev_types = {GR_EVENT_NEXTHOP_DELETE},
+};
+
+static struct gr_module pbr_module = {
+	.name = "pbr",
+	.depends_on = "nexthop",
+	.fini = pbr_fini,
+};
+
+RTE_INIT(pbr_constructor) {
+	gr_register_api_handler(&pbr_rule_add_handler);
+	gr_register_api_handler(&pbr_rule_del_handler);
+	gr_register_api_handler(&pbr_flush_handler);
+	gr_register_api_handler(&pbr_list_handler);
+	gr_event_subscribe(&iface_pre_remove_subscription);
+	gr_event_subscribe(&nh_delete_subscription);
+	gr_register_module(&pbr_module);
+}
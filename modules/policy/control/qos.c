@@ -0,0 +1,742 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_event.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_port.h>
+#include <gr_qos.h>
+#include <gr_qos_control.h>
+#include <gr_rcu.h>
+#include <gr_vlan.h>
+
+#include <rte_common.h>
+#include <rte_ethdev.h>
+#include <rte_malloc.h>
+#include <rte_meter.h>
+#include <rte_sched.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+_Atomic(struct qos_policer *) qos_policers[MAX_IFACES];
+_Atomic(struct qos_sched *) qos_scheds[RTE_MAX_ETHPORTS];
+_Atomic(unsigned) qos_sched_count;
+
+// policers ////////////////////////////////////////////////////////////////////
+
+static int policer_conf_validate(const struct gr_policer_conf *conf) {
+	switch (conf->mode) {
+	case GR_POLICER_SRTCM:
+		if (conf->cir == 0 || (conf->cbs == 0 && conf->ebs == 0))
+			return errno_set(EINVAL);
+		break;
+	case GR_POLICER_TRTCM:
+		if (conf->cir == 0 || conf->pir < conf->cir || conf->cbs == 0 || conf->pbs == 0)
+			return errno_set(EINVAL);
+		break;
+	default:
+		return errno_set(EINVAL);
+	}
+
+	for (gr_color_t c = 0; c < GR_COLOR_COUNT; c++) {
+		switch (conf->actions[c].action) {
+		case GR_POLICER_PASS:
+		case GR_POLICER_DROP:
+			break;
+		case GR_POLICER_REMARK:
+			if (conf->actions[c].dscp > 63)
+				return errno_set(EINVAL);
+			break;
+		default:
+			return errno_set(EINVAL);
+		}
+	}
+
+	return 0;
+}
+
+static struct qos_policer *policer_new(const struct gr_policer_conf *conf) {
+	struct qos_policer *p;
+	int ret;
+
+	p = rte_zmalloc(__func__, sizeof(*p), RTE_CACHE_LINE_SIZE);
+	if (p == NULL)
+		return errno_set_null(ENOMEM);
+
+	rte_spinlock_init(&p->lock);
+	p->conf = *conf;
+
+	if (conf->mode == GR_POLICER_SRTCM) {
+		struct rte_meter_srtcm_params params = {
+			.cir = conf->cir / 8,
+			.cbs = conf->cbs,
+			.ebs = conf->ebs,
+		};
+		ret = rte_meter_srtcm_profile_config(&p->srtcm_profile, &params);
+		if (ret == 0)
+			ret = rte_meter_srtcm_config(&p->srtcm, &p->srtcm_profile);
+	} else {
+		struct rte_meter_trtcm_params params = {
+			.cir = conf->cir / 8,
+			.pir = conf->pir / 8,
+			.cbs = conf->cbs,
+			.pbs = conf->pbs,
+		};
+		ret = rte_meter_trtcm_profile_config(&p->trtcm_profile, &params);
+		if (ret == 0)
+			ret = rte_meter_trtcm_config(&p->trtcm, &p->trtcm_profile);
+	}
+	if (ret < 0) {
+		rte_free(p);
+		return errno_set_null(-ret);
+	}
+
+	return p;
+}
+
+static void policer_replace(struct iface *iface, struct qos_policer *p) {
+	struct qos_policer *old = atomic_exchange(&qos_policers[iface->id], p);
+
+	if (p != NULL)
+		iface->flags |= GR_IFACE_F_POLICE;
+	else
+		iface->flags &= ~GR_IFACE_F_POLICE;
+
+	if (old != NULL) {
+		rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+		rte_free(old);
+	}
+}
+
+static struct api_out policer_set(const void *request, struct api_ctx *) {
+	const struct gr_qos_policer_set_req *req = request;
+	struct qos_policer *p;
+	struct iface *iface;
+
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+	if (policer_conf_validate(&req->conf) < 0)
+		return api_out(errno, 0, NULL);
+	if ((p = policer_new(&req->conf)) == NULL)
+		return api_out(errno, 0, NULL);
+
+	policer_replace(iface, p);
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out policer_del(const void *request, struct api_ctx *) {
+	const struct gr_qos_policer_del_req *req = request;
+	struct iface *iface;
+
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+	if (qos_policer_get(iface->id) == NULL)
+		return api_out(req->missing_ok ? 0 : ENOENT, 0, NULL);
+
+	policer_replace(iface, NULL);
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out policer_list(const void *request, struct api_ctx *ctx) {
+	const struct gr_qos_policer_list_req *req = request;
+	struct qos_policer *p;
+
+	for (uint16_t iface_id = 0; iface_id < MAX_IFACES; iface_id++) {
+		if (req->iface_id != GR_IFACE_ID_UNDEF && req->iface_id != iface_id)
+			continue;
+		if ((p = qos_policer_get(iface_id)) == NULL)
+			continue;
+
+		struct gr_qos_policer pol = {.iface_id = iface_id, .conf = p->conf};
+		rte_spinlock_lock(&p->lock);
+		memcpy(pol.stats, p->stats, sizeof(pol.stats));
+		rte_spinlock_unlock(&p->lock);
+		api_send(ctx, sizeof(pol), &pol);
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+// egress scheduler ////////////////////////////////////////////////////////////
+
+// Token bucket period of the subport and pipes, in milliseconds.
+#define QOS_TC_PERIOD 10
+
+struct qos_subscriber {
+	bool configured;
+	uint64_t rate;
+	// Scheduler state, only valid when pipe != 0.
+	uint16_t parent_id;
+	uint16_t vlan_id;
+	uint32_t pipe;
+	struct gr_qos_queue_stats stats;
+};
+
+static struct qos_subscriber subscribers[MAX_IFACES];
+
+// Control plane state of each port scheduler.
+struct qos_sched_ctl {
+	uint32_t n_profiles;
+	uint64_t profile_rates[GR_QOS_MAX_PROFILES];
+	// Subscriber interface ID of each pipe, 0 if unused.
+	uint16_t pipe_ifaces[GR_QOS_MAX_SUBSCRIBERS];
+	struct gr_qos_queue_stats stats[GR_QOS_CLASS_COUNT];
+};
+
+static struct qos_sched_ctl *sched_ctls[RTE_MAX_ETHPORTS];
+
+static uint64_t qos_tb_size(uint64_t bytes_rate) {
+	// Allow bursts of one token bucket period with a lower bound of a few
+	// jumbo frames.
+	return RTE_MAX(bytes_rate * QOS_TC_PERIOD / 1000, UINT64_C(32768));
+}
+
+static void qos_pipe_params(struct rte_sched_pipe_params *p, uint64_t bytes_rate) {
+	memset(p, 0, sizeof(*p));
+	p->tb_rate = bytes_rate;
+	p->tb_size = qos_tb_size(bytes_rate);
+	p->tc_period = QOS_TC_PERIOD;
+	for (unsigned i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
+		p->tc_rate[i] = bytes_rate;
+	p->tc_ov_weight = 1;
+	// class 0 : class 1
+	p->wrr_weights[0] = 4;
+	for (unsigned i = 1; i < RTE_SCHED_BE_QUEUES_PER_PIPE; i++)
+		p->wrr_weights[i] = 1;
+}
+
+// Return the pipe profile for a subscriber rate, add it if needed.
+static int sched_profile(struct qos_sched *s, struct qos_sched_ctl *ctl, uint64_t rate) {
+	struct rte_sched_pipe_params params;
+	uint32_t profile_id;
+	int ret;
+
+	rate = RTE_MIN(rate, s->conf.rate);
+
+	for (uint32_t i = 0; i < ctl->n_profiles; i++) {
+		if (ctl->profile_rates[i] == rate)
+			return i;
+	}
+	if (ctl->n_profiles == GR_QOS_MAX_PROFILES)
+		return errno_set(ENOSPC);
+
+	qos_pipe_params(&params, rate / 8);
+	rte_spinlock_lock(&s->lock);
+	ret = rte_sched_subport_pipe_profile_add(s->port, 0, &params, &profile_id);
+	rte_spinlock_unlock(&s->lock);
+	if (ret < 0)
+		return errno_set(-ret);
+
+	ctl->profile_rates[ctl->n_profiles++] = rate;
+
+	return profile_id;
+}
+
+static void
+sched_pipe_stats_collect(struct qos_sched *s, struct qos_sched_ctl *ctl, uint32_t pipe) {
+	struct rte_sched_queue_stats qs;
+	struct gr_qos_queue_stats *sub;
+	uint32_t base, cs;
+	uint16_t qlen;
+
+	sub = ctl->pipe_ifaces[pipe] != 0 ? &subscribers[ctl->pipe_ifaces[pipe]].stats : NULL;
+	base = pipe * RTE_SCHED_QUEUES_PER_PIPE;
+
+	rte_spinlock_lock(&s->lock);
+	for (uint32_t q = 0; q < RTE_SCHED_QUEUES_PER_PIPE; q++) {
+		// Statistics are reset after each read.
+		if (rte_sched_queue_read_stats(s->port, base + q, &qs, &qlen) < 0)
+			continue;
+		if (q < RTE_SCHED_TRAFFIC_CLASS_BE)
+			cs = 7 - q;
+		else
+			cs = q - RTE_SCHED_TRAFFIC_CLASS_BE;
+		if (cs >= GR_QOS_CLASS_COUNT)
+			continue;
+		ctl->stats[cs].packets += qs.n_pkts;
+		ctl->stats[cs].bytes += qs.n_bytes;
+		ctl->stats[cs].dropped += qs.n_pkts_dropped;
+		if (sub != NULL) {
+			sub->packets += qs.n_pkts;
+			sub->bytes += qs.n_bytes;
+			sub->dropped += qs.n_pkts_dropped;
+		}
+	}
+	rte_spinlock_unlock(&s->lock);
+}
+
+static void sched_stats_collect(struct qos_sched *s) {
+	struct qos_sched_ctl *ctl = sched_ctls[s->port_id];
+
+	for (uint32_t pipe = 0; pipe < s->conf.n_subscribers; pipe++)
+		sched_pipe_stats_collect(s, ctl, pipe);
+}
+
+static int sched_pipe_config(struct qos_sched *s, uint32_t pipe, int32_t profile) {
+	int ret;
+
+	rte_spinlock_lock(&s->lock);
+	ret = rte_sched_pipe_config(s->port, 0, pipe, profile);
+	rte_spinlock_unlock(&s->lock);
+
+	return errno_set(-ret);
+}
+
+static int sched_subscriber_attach(struct qos_sched *s, const struct iface *iface) {
+	const struct iface_info_vlan *vlan = iface_info_vlan(iface);
+	struct qos_subscriber *sub = &subscribers[iface->id];
+	struct qos_sched_ctl *ctl = sched_ctls[s->port_id];
+	uint32_t pipe = sub->pipe;
+	int profile;
+
+	// Pipes are indexed by 802.1Q VLAN ID, QinQ is not supported.
+	if (vlan->outer_vlan_id != 0)
+		return errno_set(EOPNOTSUPP);
+
+	if (pipe == 0) {
+		for (uint32_t p = 1; p < s->conf.n_subscribers; p++) {
+			if (ctl->pipe_ifaces[p] == 0) {
+				pipe = p;
+				break;
+			}
+		}
+		if (pipe == 0)
+			return errno_set(ENOSPC);
+	}
+
+	if ((profile = sched_profile(s, ctl, sub->rate)) < 0)
+		return -errno;
+	if (sched_pipe_config(s, pipe, profile) < 0)
+		return -errno;
+
+	ctl->pipe_ifaces[pipe] = iface->id;
+	sub->parent_id = vlan->parent_id;
+	sub->vlan_id = vlan->vlan_id;
+	sub->pipe = pipe;
+	s->vlan_pipes[vlan->vlan_id] = pipe;
+
+	return 0;
+}
+
+static void sched_subscriber_detach(uint16_t iface_id) {
+	struct qos_subscriber *sub = &subscribers[iface_id];
+	const struct iface *parent;
+	struct qos_sched_ctl *ctl;
+	struct qos_sched *s;
+	uint16_t port_id;
+
+	if (sub->pipe == 0)
+		return;
+
+	if ((parent = iface_from_id(sub->parent_id)) == NULL)
+		goto out;
+	port_id = iface_info_port(parent)->port_id;
+	if ((s = qos_sched_get(port_id)) == NULL)
+		goto out;
+	ctl = sched_ctls[port_id];
+
+	// Packets still queued in the pipe are sent at the default rate.
+	s->vlan_pipes[sub->vlan_id] = 0;
+	sched_pipe_stats_collect(s, ctl, sub->pipe);
+	if (sched_pipe_config(s, sub->pipe, 0) < 0)
+		LOG(ERR, "rte_sched_pipe_config: %s", strerror(errno));
+	ctl->pipe_ifaces[sub->pipe] = 0;
+out:
+	sub->pipe = 0;
+}
+
+// Return the scheduler of the VLAN parent port if any.
+static struct qos_sched *subscriber_sched(const struct iface *iface) {
+	const struct iface_info_vlan *vlan = iface_info_vlan(iface);
+	const struct iface *parent = iface_from_id(vlan->parent_id);
+
+	if (parent == NULL || parent->type != GR_IFACE_TYPE_PORT)
+		return NULL;
+
+	return qos_sched_get(iface_info_port(parent)->port_id);
+}
+
+static int sched_conf_validate(const struct gr_qos_sched_conf *conf) {
+	if (conf->rate < 8)
+		return errno_set(EINVAL);
+	if (conf->n_subscribers == 0 || conf->n_subscribers > GR_QOS_MAX_SUBSCRIBERS
+	    || !rte_is_power_of_2(conf->n_subscribers))
+		return errno_set(EINVAL);
+	if (conf->qsize == 0 || !rte_is_power_of_2(conf->qsize))
+		return errno_set(EINVAL);
+	return 0;
+}
+
+static void sched_free(struct qos_sched *s) {
+	if (s == NULL)
+		return;
+	// Packets still queued are freed as well.
+	rte_sched_port_free(s->port);
+	rte_free(s);
+}
+
+static struct qos_sched *
+sched_new(const struct iface *iface, const struct gr_qos_sched_conf *conf) {
+	uint16_t port_id = iface_info_port(iface)->port_id;
+	uint64_t rate = conf->rate / 8;
+	struct rte_sched_subport_profile_params subport_profile = {
+		.tb_rate = rate,
+		.tb_size = qos_tb_size(rate),
+		.tc_period = QOS_TC_PERIOD,
+	};
+	struct rte_sched_pipe_params pipe_profile;
+	struct rte_sched_subport_params subport = {
+		.n_pipes_per_subport_enabled = conf->n_subscribers,
+		.pipe_profiles = &pipe_profile,
+		.n_pipe_profiles = 1,
+		.n_max_pipe_profiles = GR_QOS_MAX_PROFILES,
+	};
+	char name[64];
+	struct rte_sched_port_params params = {
+		.name = name,
+		.socket = rte_eth_dev_socket_id(port_id),
+		.rate = rate,
+		.mtu = iface->mtu ? iface->mtu : RTE_ETHER_MTU,
+		.frame_overhead = RTE_SCHED_FRAME_OVERHEAD_DEFAULT,
+		.n_subports_per_port = 1,
+		.n_subport_profiles = 1,
+		.subport_profiles = &subport_profile,
+		.n_max_subport_profiles = 1,
+		.n_pipes_per_subport = conf->n_subscribers,
+	};
+	struct qos_sched *s;
+	int ret;
+
+	snprintf(name, sizeof(name), "qos-%s", iface->name);
+	if (params.socket < 0)
+		params.socket = SOCKET_ID_ANY;
+	for (unsigned i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++) {
+		subport_profile.tc_rate[i] = rate;
+		subport.qsize[i] = conf->qsize;
+	}
+	qos_pipe_params(&pipe_profile, rate);
+
+	s = rte_zmalloc_socket(__func__, sizeof(*s), RTE_CACHE_LINE_SIZE, params.socket);
+	if (s == NULL)
+		return errno_set_null(ENOMEM);
+
+	rte_spinlock_init(&s->lock);
+	s->iface_id = iface->id;
+	s->port_id = port_id;
+	s->conf = *conf;
+
+	s->port = rte_sched_port_config(&params);
+	if (s->port == NULL) {
+		ret = -ENOMEM;
+		goto err;
+	}
+	if ((ret = rte_sched_subport_config(s->port, 0, &subport, 0)) < 0)
+		goto err;
+	for (uint32_t pipe = 0; pipe < conf->n_subscribers; pipe++) {
+		if ((ret = rte_sched_pipe_config(s->port, 0, pipe, 0)) < 0)
+			goto err;
+	}
+
+	return s;
+err:
+	sched_free(s);
+	return errno_set_null(-ret);
+}
+
+static int sched_replace(struct iface *iface, struct qos_sched *s) {
+	uint16_t port_id = iface_info_port(iface)->port_id;
+	struct qos_sched_ctl *ctl = NULL;
+	struct qos_sched *old;
+	struct iface *sub;
+
+	if (s != NULL) {
+		if ((ctl = calloc(1, sizeof(*ctl))) == NULL)
+			return errno_set(ENOMEM);
+		ctl->profile_rates[0] = s->conf.rate;
+		ctl->n_profiles = 1;
+	}
+
+	old = atomic_exchange(&qos_scheds[port_id], NULL);
+	if (old != NULL) {
+		atomic_fetch_sub(&qos_sched_count, 1);
+		rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+	}
+	free(sched_ctls[port_id]);
+	sched_ctls[port_id] = ctl;
+
+	if (s != NULL) {
+		// Pipes are not published to the datapath yet, assign them before.
+		sub = NULL;
+		while ((sub = iface_next(GR_IFACE_TYPE_VLAN, sub)) != NULL) {
+			if (iface_info_vlan(sub)->parent_id != iface->id)
+				continue;
+			subscribers[sub->id].pipe = 0;
+			if (!subscribers[sub->id].configured)
+				continue;
+			if (sched_subscriber_attach(s, sub) < 0)
+				LOG(ERR, "subscriber %s: %s", sub->name, strerror(errno));
+		}
+		atomic_store_explicit(&qos_scheds[port_id], s, memory_order_release);
+		atomic_fetch_add(&qos_sched_count, 1);
+		iface->flags |= GR_IFACE_F_SCHED;
+	} else {
+		sub = NULL;
+		while ((sub = iface_next(GR_IFACE_TYPE_VLAN, sub)) != NULL) {
+			if (iface_info_vlan(sub)->parent_id == iface->id)
+				subscribers[sub->id].pipe = 0;
+		}
+		iface->flags &= ~GR_IFACE_F_SCHED;
+	}
+
+	sched_free(old);
+
+	return 0;
+}
+
+static struct api_out sched_set(const void *request, struct api_ctx *) {
+	const struct gr_qos_sched_set_req *req = request;
+	struct qos_sched *s;
+	struct iface *iface;
+
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+	if (iface->type != GR_IFACE_TYPE_PORT)
+		return api_out(EMEDIUMTYPE, 0, NULL);
+	if (sched_conf_validate(&req->conf) < 0)
+		return api_out(errno, 0, NULL);
+	if ((s = sched_new(iface, &req->conf)) == NULL)
+		return api_out(errno, 0, NULL);
+
+	if (sched_replace(iface, s) < 0) {
+		sched_free(s);
+		return api_out(errno, 0, NULL);
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out sched_del(const void *request, struct api_ctx *) {
+	const struct gr_qos_sched_del_req *req = request;
+	struct iface *iface;
+
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+	if (iface->type != GR_IFACE_TYPE_PORT)
+		return api_out(EMEDIUMTYPE, 0, NULL);
+	if (qos_sched_get(iface_info_port(iface)->port_id) == NULL)
+		return api_out(req->missing_ok ? 0 : ENOENT, 0, NULL);
+
+	sched_replace(iface, NULL);
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out sched_list(const void *request, struct api_ctx *ctx) {
+	const struct gr_qos_sched_list_req *req = request;
+	struct qos_sched *s;
+
+	for (uint16_t port_id = 0; port_id < RTE_MAX_ETHPORTS; port_id++) {
+		if ((s = qos_sched_get(port_id)) == NULL)
+			continue;
+		if (req->iface_id != GR_IFACE_ID_UNDEF && req->iface_id != s->iface_id)
+			continue;
+
+		sched_stats_collect(s);
+
+		struct gr_qos_sched sched = {.iface_id = s->iface_id, .conf = s->conf};
+		memcpy(sched.stats, sched_ctls[port_id]->stats, sizeof(sched.stats));
+		api_send(ctx, sizeof(sched), &sched);
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out subscriber_set(const void *request, struct api_ctx *) {
+	const struct gr_qos_subscriber_set_req *req = request;
+	struct qos_subscriber *sub, old;
+	struct qos_sched *s;
+	struct iface *iface;
+
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+	if (iface->type != GR_IFACE_TYPE_VLAN)
+		return api_out(EMEDIUMTYPE, 0, NULL);
+	if (req->rate < 8)
+		return api_out(EINVAL, 0, NULL);
+
+	sub = &subscribers[iface->id];
+	old = *sub;
+	sub->configured = true;
+	sub->rate = req->rate;
+
+	if ((s = subscriber_sched(iface)) != NULL && sched_subscriber_attach(s, iface) < 0) {
+		int errsave = errno;
+		*sub = old;
+		return api_out(errsave, 0, NULL);
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+static void subscriber_clear(uint16_t iface_id) {
+	sched_subscriber_detach(iface_id);
+	memset(&subscribers[iface_id], 0, sizeof(subscribers[iface_id]));
+}
+
+static struct api_out subscriber_del(const void *request, struct api_ctx *) {
+	const struct gr_qos_subscriber_del_req *req = request;
+	struct iface *iface;
+
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+	if (!subscribers[iface->id].configured)
+		return api_out(req->missing_ok ? 0 : ENOENT, 0, NULL);
+
+	subscriber_clear(iface->id);
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out subscriber_list(const void *request, struct api_ctx *ctx) {
+	const struct gr_qos_subscriber_list_req *req = request;
+	const struct qos_subscriber *sub;
+	const struct iface *iface;
+	struct qos_sched *s;
+
+	for (uint16_t iface_id = 0; iface_id < MAX_IFACES; iface_id++) {
+		if (req->iface_id != GR_IFACE_ID_UNDEF && req->iface_id != iface_id)
+			continue;
+		sub = &subscribers[iface_id];
+		if (!sub->configured)
+			continue;
+
+		if (sub->pipe != 0 && (iface = iface_from_id(iface_id)) != NULL
+		    && (s = subscriber_sched(iface)) != NULL)
+			sched_pipe_stats_collect(s, sched_ctls[s->port_id], sub->pipe);
+
+		struct gr_qos_subscriber e = {
+			.iface_id = iface_id,
+			.rate = sub->rate,
+			.active = sub->pipe != 0,
+			.stats = sub->stats,
+		};
+		api_send(ctx, sizeof(e), &e);
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+static void iface_event_cb(uint32_t event, const void *obj) {
+	struct iface *iface = (struct iface *)obj;
+	struct qos_sched *s;
+
+	switch (event) {
+	case GR_EVENT_IFACE_PRE_REMOVE:
+		if (qos_policer_get(iface->id) != NULL)
+			policer_replace(iface, NULL);
+		if (iface->type == GR_IFACE_TYPE_PORT
+		    && qos_sched_get(iface_info_port(iface)->port_id) != NULL)
+			sched_replace(iface, NULL);
+		subscriber_clear(iface->id);
+		break;
+	case GR_EVENT_IFACE_POST_RECONFIG:
+		// The VLAN ID or the parent of the subscriber may have changed.
+		if (iface->type != GR_IFACE_TYPE_VLAN || !subscribers[iface->id].configured)
+			break;
+		sched_subscriber_detach(iface->id);
+		if ((s = subscriber_sched(iface)) != NULL && sched_subscriber_attach(s, iface) < 0)
+			LOG(ERR, "subscriber %s: %s", iface->name, strerror(errno));
+		break;
+	}
+}
+
+static void qos_fini(struct event_base *) {
+	for (uint16_t iface_id = 0; iface_id < MAX_IFACES; iface_id++)
+		rte_free(atomic_exchange(&qos_policers[iface_id], NULL));
+	for (uint16_t port_id = 0; port_id < RTE_MAX_ETHPORTS; port_id++) {
+		sched_free(atomic_exchange(&qos_scheds[port_id], NULL));
+		free(sched_ctls[port_id]);
+		sched_ctls[port_id] = NULL;
+	}
+}
+
+static struct gr_api_handler policer_set_handler = {
+	.name = "qos policer set",
+	.request_type = GR_QOS_POLICER_SET,
+	.callback = policer_set,
+};
+static struct gr_api_handler policer_del_handler = {
+	.name = "qos policer del",
+	.request_type = GR_QOS_POLICER_DEL,
+	.callback = policer_del,
+};
+static struct gr_api_handler policer_list_handler = {
+	.name = "qos policer list",
+	.request_type = GR_QOS_POLICER_LIST,
+	.callback = policer_list,
+};
+static struct gr_api_handler sched_set_handler = {
+	.name = "qos scheduler set",
+	.request_type = GR_QOS_SCHED_SET,
+	.callback = sched_set,
+};
+static struct gr_api_handler sched_del_handler = {
+	.name = "qos scheduler del",
+	.request_type = GR_QOS_SCHED_DEL,
+	.callback = sched_del,
+};
+static struct gr_api_handler sched_list_handler = {
+	.name = "qos scheduler list",
+	.request_type = GR_QOS_SCHED_LIST,
+	.callback = sched_list,
+};
+static struct gr_api_handler subscriber_set_handler = {
+	.name = "qos subscriber set",
+	.request_type = GR_QOS_SUBSCRIBER_SET,
+	.callback = subscriber_set,
+};
+static struct gr_api_handler subscriber_del_handler = {
+	.name = "qos subscriber del",
+	.request_type = GR_QOS_SUBSCRIBER_DEL,
+	.callback = subscriber_del,
+};
+static struct gr_api_handler subscriber_list_handler = {
+	.name = "qos subscriber list",
+	.request_type = GR_QOS_SUBSCRIBER_LIST,
+	.callback = subscriber_list,
+};
+
+static struct gr_event_subscription iface_event_subscription = {
+	.callback = iface_event_cb,
+	.ev_count = 2,
+	.ev_types = {
+		GR_EVENT_IFACE_PRE_REMOVE,
+		GR_EVENT_IFACE_POST_RECONFIG,
+	},
+};
+
+static struct gr_module qos_module = {
+	.name = "qos",
+	.depends_on = "rcu",
+	.fini = qos_fini,
+};
+
+RTE_INIT(qos_constructor) {
+	gr_register_api_handler(&policer_set_handler);
+	gr_register_api_handler(&policer_del_handler);
+	gr_register_api_handler(&policer_list_handler);
+	gr_register_api_handler(&sched_set_handler);
+	gr_register_api_handler(&sched_del_handler);
+	gr_register_api_handler(&sched_list_handler);
+	gr_register_api_handler(&subscriber_set_handler);
+	gr_register_api_handler(&subscriber_del_handler);
+	gr_register_api_handler(&subscriber_list_handler);
+	gr_event_subscribe(&iface_event_subscription);
+	gr_register_module(&qos_module);
+}
@@ -11,12 +11,261 @@
 #include <gr_rcu.h>
 #include <gr_vec.h>
 
+#include <event2/event.h>
+#include <rte_errno.h>
+#include <rte_hash.h>
 #include <rte_malloc.h>
+#include <rte_mempool.h>
+#include <rte_spinlock.h>
 
 #include <stdint.h>
 
+#define MAPPING_COUNT 16384
+// RFC 4787 REQ-5: a mapping must not expire in less than two minutes.
+#define MAPPING_TIMEOUT 120
+// Reference count of mappings which are being removed by the ageing timer.
+#define MAPPING_DEAD UINT32_MAX
+// Number of mappings examined by the ageing timer per mapping_lock hold.
+// Datapath workers creating new mappings wait on this lock.
+#define MAPPING_AGEING_BATCH 256
+
 static STAILQ_HEAD(, snat44_policy) policies = STAILQ_HEAD_INITIALIZER(policies);
 
+unsigned snat44_eim_policies;
+static struct rte_hash *mapping_int;
+static struct rte_hash *mapping_ext;
+static struct rte_mempool *mapping_pool;
+// Serializes mapping creation and removal. Lookups are lock-free.
+static rte_spinlock_t mapping_lock = RTE_SPINLOCK_INITIALIZER;
+static struct event *mapping_timer;
+
+static struct gr_id_pool *policy_ports(struct snat44_policy *p, uint8_t proto) {
+	switch (proto) {
+	case IPPROTO_TCP:
+		return p->tcp_ports;
+	case IPPROTO_UDP:
+		return p->udp_ports;
+	case IPPROTO_ICMP:
+		return p->icmp_ids;
+	}
+	return NULL;
+}
+
+// Must be called with mapping_lock held.
+static struct snat44_mapping *
+mapping_create(struct snat44_policy *p, const struct snat44_mapping_key *key) {
+	struct snat44_mapping *m;
+	rte_be16_t port;
+	void *data;
+
+	if (p->dead)
+		return NULL;
+
+	port = rte_cpu_to_be_16(gr_id_pool_get_random(policy_ports(p, key->proto)));
+	if (port == 0)
+		return NULL; // available ports exhausted
+
+	if (rte_mempool_get(mapping_pool, &data) < 0)
+		goto free_port;
+
+	m = data;
+	*m = (struct snat44_mapping) {
+		.int_key = *key,
+		.ext_key = {
+			.addr = p->replace,
+			.id = p->vrf_id,
+			.port = port,
+			.proto = key->proto,
+		},
+		.policy = p,
+		.refcnt = 1,
+		.last_used = gr_clock_us(),
+	};
+
+	if (rte_hash_add_key_data(mapping_int, &m->int_key, m) < 0)
+		goto free_mapping;
+	if (rte_hash_add_key_data(mapping_ext, &m->ext_key, m) < 0) {
+		rte_hash_del_key(mapping_int, &m->int_key);
+		goto free_mapping;
+	}
+
+	snat44_log(
+		GR_SNAT44_LOG_BIND,
+		p->vrf_id,
+		key->proto,
+		key->addr,
+		key->port,
+		m->ext_key.addr,
+		m->ext_key.port
+	);
+
+	return m;
+free_mapping:
+	rte_mempool_put(mapping_pool, m);
+free_port:
+	gr_conn_snat44_free_port(p, key->proto, port);
+	return NULL;
+}
+
+static bool mapping_hold(struct snat44_mapping *m) {
+	uint32_t ref = atomic_load(&m->refcnt);
+
+	do {
+		if (ref == MAPPING_DEAD)
+			return false;
+	} while (!atomic_compare_exchange_weak(&m->refcnt, &ref, ref + 1));
+
+	return true;
+}
+
+struct snat44_mapping *
+snat44_mapping_get(struct snat44_policy *p, uint8_t proto, ip4_addr_t addr, rte_be16_t port) {
+	struct snat44_mapping_key key = {
+		.addr = addr,
+		.id = p->iface_id,
+		.port = port,
+		.proto = proto,
+	};
+	struct snat44_mapping *m;
+	void *data;
+
+	if (rte_hash_lookup_data(mapping_int, &key, &data) >= 0 && mapping_hold(data))
+		return data;
+
+	rte_spinlock_lock(&mapping_lock);
+	if (rte_hash_lookup_data(mapping_int, &key, &data) >= 0) {
+		// Dead mappings are removed from the hash with the lock held.
+		m = data;
+		atomic_fetch_add(&m->refcnt, 1);
+	} else {
+		m = mapping_create(p, &key);
+	}
+	rte_spinlock_unlock(&mapping_lock);
+
+	return m;
+}
+
+void snat44_mapping_put(struct snat44_mapping *m) {
+	atomic_store(&m->last_used, gr_clock_us());
+	atomic_fetch_sub(&m->refcnt, 1);
+}
+
+uint64_t snat44_mapping_lookup_bulk(
+	bool external,
+	const struct snat44_mapping_key **keys,
+	unsigned n,
+	struct snat44_mapping **mappings
+) {
+	uint64_t hits = 0;
+
+	if (n == 0)
+		return 0;
+
+	if (rte_hash_lookup_bulk_data(
+		    external ? mapping_ext : mapping_int,
+		    (const void **)keys,
+		    n,
+		    &hits,
+		    (void **)mappings
+	    )
+	    < 0)
+		return 0;
+
+	return hits;
+}
+
+// Free mappings which have been removed from the hash tables.
+static void mappings_free(gr_vec struct snat44_mapping **dead) {
+	struct snat44_mapping *m;
+
+	if (gr_vec_len(dead) == 0)
+		return;
+
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+
+	gr_vec_foreach (m, dead) {
+		snat44_log(
+			GR_SNAT44_LOG_UNBIND,
+			m->policy->vrf_id,
+			m->int_key.proto,
+			m->int_key.addr,
+			m->int_key.port,
+			m->ext_key.addr,
+			m->ext_key.port
+		);
+		gr_conn_snat44_free_port(m->policy, m->int_key.proto, m->ext_key.port);
+		rte_mempool_put(mapping_pool, m);
+	}
+}
+
+static void mapping_unlink(struct snat44_mapping *m) {
+	rte_hash_del_key(mapping_int, &m->int_key);
+	rte_hash_del_key(mapping_ext, &m->ext_key);
+}
+
+static void mapping_ageing(evutil_socket_t, short /*what*/, void * /*priv*/) {
+	gr_vec struct snat44_mapping **dead = NULL;
+	clock_t now = gr_clock_us(), last;
+	struct snat44_mapping *m;
+	bool done = false;
+	const void *key;
+	uint32_t iter;
+	uint32_t ref;
+	void *data;
+
+	// Walk the table in chunks and release the lock in between. The
+	// iterator is a position in the key store, it stays valid when other
+	// mappings are added or removed while the lock is released.
+	iter = 0;
+	while (!done) {
+		rte_spinlock_lock(&mapping_lock);
+		for (unsigned n = 0; n < MAPPING_AGEING_BATCH; n++) {
+			if (rte_hash_iterate(mapping_int, &key, &data, &iter) < 0) {
+				done = true;
+				break;
+			}
+			m = data;
+			last = atomic_load(&m->last_used);
+			if (last > now || (now - last) / 1000000ULL < MAPPING_TIMEOUT)
+				continue;
+			// Only expire mappings which are not referenced by any connection.
+			ref = 0;
+			if (!atomic_compare_exchange_strong(&m->refcnt, &ref, MAPPING_DEAD))
+				continue;
+			mapping_unlink(m);
+			gr_vec_add(dead, m);
+		}
+		rte_spinlock_unlock(&mapping_lock);
+	}
+
+	mappings_free(dead);
+	gr_vec_free(dead);
+}
+
+// Prevent new mappings for a policy and unlink the existing ones.
+// The returned mappings must be freed once all connections are destroyed.
+static gr_vec struct snat44_mapping **mappings_unlink(struct snat44_policy *policy) {
+	gr_vec struct snat44_mapping **unlinked = NULL;
+	struct snat44_mapping *m;
+	const void *key;
+	uint32_t iter;
+	void *data;
+
+	rte_spinlock_lock(&mapping_lock);
+	policy->dead = true;
+	iter = 0;
+	while (rte_hash_iterate(mapping_int, &key, &data, &iter) >= 0) {
+		m = data;
+		if (m->policy != policy)
+			continue;
+		mapping_unlink(m);
+		gr_vec_add(unlinked, m);
+	}
+	rte_spinlock_unlock(&mapping_lock);
+
+	return unlinked;
+}
+
 int snat44_dynamic_policy_add(const struct gr_snat44_policy *p) {
 	struct iface *iface = iface_from_id(p->iface_id);
 	struct snat44_policy *policy;
@@ -29,6 +278,7 @@ int snat44_dynamic_policy_add(const struct gr_snat44_policy *p) {
 		return errno_set(ENOMEM);
 
 	policy->base = *p;
+	policy->vrf_id = iface->vrf_id;
 	policy->tcp_ports = gr_id_pool_create(1024, 65535);
 	if (policy->tcp_ports == NULL)
 		goto err;
@@ -41,6 +291,8 @@ int snat44_dynamic_policy_add(const struct gr_snat44_policy *p) {
 
 	STAILQ_INSERT_TAIL(&policies, policy, next);
 	iface->flags |= GR_IFACE_F_SNAT_DYNAMIC;
+	if (policy->endpoint_independent)
+		snat44_eim_policies++;
 
 	return 0;
 err:
@@ -51,8 +303,14 @@ err:
 	return errno_set(ENOMEM);
 }
 
+static bool policy_equal(const struct gr_snat44_policy *a, const struct gr_snat44_policy *b) {
+	return a->iface_id == b->iface_id && a->net.ip == b->net.ip
+		&& a->net.prefixlen == b->net.prefixlen && a->replace == b->replace;
+}
+
 int snat44_dynamic_policy_del(const struct gr_snat44_policy *policy) {
 	struct iface *iface = iface_from_id(policy->iface_id);
+	gr_vec struct snat44_mapping **mappings;
 	struct snat44_policy *p, *found;
 	unsigned iface_count;
 
@@ -63,7 +321,7 @@ int snat44_dynamic_policy_del(const struct gr_snat44_policy *policy) {
 	found = NULL;
 
 	STAILQ_FOREACH (p, &policies, next) {
-		if (memcmp(&p->base, policy, sizeof(*policy)) == 0)
+		if (policy_equal(&p->base, policy))
 			found = found ?: p;
 		else if (p->iface_id == iface->id)
 			iface_count++;
@@ -75,10 +333,16 @@ int snat44_dynamic_policy_del(const struct gr_snat44_policy *policy) {
 
 	if (iface_count == 0)
 		iface->flags &= ~GR_IFACE_F_SNAT_DYNAMIC;
+	if (found->endpoint_independent)
+		snat44_eim_policies--;
+
+	mappings = mappings_unlink(found);
 
 	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
 
 	gr_conn_snat44_purge(found);
+	mappings_free(mappings);
+	gr_vec_free(mappings);
 	gr_id_pool_destroy(found->tcp_ports);
 	gr_id_pool_destroy(found->udp_ports);
 	gr_id_pool_destroy(found->icmp_ids);
@@ -110,6 +374,44 @@ static struct snat44_policy *snat44_dynamic_policy_lookup(const struct conn_key
 	return NULL;
 }
 
+static struct conn *
+snat44_eim_conntrack_create(struct snat44_policy *policy, const struct conn_key *fwd_key) {
+	struct snat44_mapping *mapping;
+	struct conn_key rev_key;
+	struct conn *conn;
+
+	mapping = snat44_mapping_get(policy, fwd_key->proto, fwd_key->src, fwd_key->src_id);
+	if (mapping == NULL)
+		return NULL; // available ports exhausted
+
+	rev_key = (struct conn_key) {
+		.iface_id = fwd_key->iface_id,
+		.af = fwd_key->af,
+		.proto = fwd_key->proto,
+		.src = fwd_key->dst,
+		.dst = mapping->ext_key.addr,
+		.src_id = fwd_key->dst_id,
+		.dst_id = mapping->ext_key.port,
+	};
+
+	conn = gr_conn_insert(fwd_key, &rev_key);
+	if (conn == NULL) {
+		snat44_mapping_put(mapping);
+		return NULL; // connection pool exhausted
+	}
+
+	conn->nat = (struct nat44) {
+		.orig_addr = fwd_key->src,
+		.tran_addr = mapping->ext_key.addr,
+		.orig_id = fwd_key->src_id,
+		.tran_id = mapping->ext_key.port,
+		.policy = policy,
+		.mapping = mapping,
+	};
+
+	return conn;
+}
+
 struct conn *snat44_conntrack_create(const struct conn_key *fwd_key) {
 	struct snat44_policy *policy;
 	rte_be16_t trans_port = 0;
@@ -120,6 +422,10 @@ struct conn *snat44_conntrack_create(const struct conn_key *fwd_key) {
 	if (policy == NULL)
 		return NULL; // no policy found
 
+	if (policy->endpoint_independent
+	    && (fwd_key->proto == IPPROTO_TCP || fwd_key->proto == IPPROTO_UDP))
+		return snat44_eim_conntrack_create(policy, fwd_key);
+
 	rev_key.af = fwd_key->af;
 	rev_key.src = fwd_key->dst;
 	rev_key.dst = policy->replace;
@@ -161,9 +467,92 @@ struct conn *snat44_conntrack_create(const struct conn_key *fwd_key) {
 		.policy = policy,
 	};
 
+	snat44_log(
+		GR_SNAT44_LOG_BIND,
+		policy->vrf_id,
+		fwd_key->proto,
+		fwd_key->src,
+		fwd_key->src_id,
+		policy->replace,
+		trans_port
+	);
+
 	return conn;
 }
 
+struct conn *snat44_conntrack_create_inbound(const struct conn_key *fwd_key) {
+	const struct iface *iface = iface_from_id(fwd_key->iface_id);
+	struct snat44_mapping_key key;
+	struct snat44_mapping *mapping;
+	struct conn_key rev_key;
+	struct conn *conn;
+	void *data;
+
+	if (iface == NULL)
+		return NULL;
+	if (fwd_key->proto != IPPROTO_TCP && fwd_key->proto != IPPROTO_UDP)
+		return NULL;
+
+	key = (struct snat44_mapping_key) {
+		.addr = fwd_key->dst,
+		.id = iface->vrf_id,
+		.port = fwd_key->dst_id,
+		.proto = fwd_key->proto,
+	};
+	if (rte_hash_lookup_data(mapping_ext, &key, &data) < 0)
+		return NULL; // no mapping, filter
+	mapping = data;
+	if (mapping->policy->iface_id != fwd_key->iface_id || !mapping_hold(mapping))
+		return NULL;
+
+	// Replies are sent by the internal endpoint to the remote endpoint.
+	rev_key = (struct conn_key) {
+		.iface_id = fwd_key->iface_id,
+		.af = fwd_key->af,
+		.proto = fwd_key->proto,
+		.src = mapping->int_key.addr,
+		.dst = fwd_key->src,
+		.src_id = mapping->int_key.port,
+		.dst_id = fwd_key->src_id,
+	};
+
+	conn = gr_conn_insert(fwd_key, &rev_key);
+	if (conn == NULL) {
+		snat44_mapping_put(mapping);
+		return NULL;
+	}
+
+	conn->nat = (struct nat44) {
+		.orig_addr = mapping->int_key.addr,
+		.tran_addr = mapping->ext_key.addr,
+		.orig_id = mapping->int_key.port,
+		.tran_id = mapping->ext_key.port,
+		.policy = mapping->policy,
+		.mapping = mapping,
+	};
+
+	return conn;
+}
+
+void gr_conn_snat44_release(struct conn *conn) {
+	if (conn->nat.mapping != NULL) {
+		// Endpoint independent bindings are logged when the mapping expires.
+		snat44_mapping_put(conn->nat.mapping);
+		return;
+	}
+
+	snat44_log(
+		GR_SNAT44_LOG_UNBIND,
+		conn->nat.policy->vrf_id,
+		conn->fwd_key.proto,
+		conn->nat.orig_addr,
+		conn->nat.orig_id,
+		conn->nat.tran_addr,
+		conn->nat.tran_id
+	);
+	gr_conn_snat44_free_port(conn->nat.policy, conn->fwd_key.proto, conn->nat.tran_id);
+}
+
 void gr_conn_snat44_free_port(struct snat44_policy *p, uint8_t proto, rte_be16_t port) {
 	switch (proto) {
 	case IPPROTO_TCP:
@@ -177,3 +566,75 @@ void gr_conn_snat44_free_port(struct snat44_policy *p, uint8_t proto, rte_be16_t
 		break;
 	}
 }
+
+static void snat44_init(struct event_base *ev_base) {
+	mapping_pool = rte_mempool_create(
+		"snat44-mappings",
+		MAPPING_COUNT,
+		sizeof(struct snat44_mapping),
+		0, // cache size
+		0, // priv size
+		NULL, // mp_init
+		NULL, // mp_init_arg
+		NULL, // obj_init
+		NULL, // obj_init_arg
+		SOCKET_ID_ANY,
+		0 // flags
+	);
+	if (mapping_pool == NULL)
+		ABORT("rte_mempool_create(snat44-mappings): %s", rte_strerror(rte_errno));
+
+	struct rte_hash_parameters params = {
+		.entries = MAPPING_COUNT,
+		.key_len = sizeof(struct snat44_mapping_key),
+		.socket_id = SOCKET_ID_ANY,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF,
+	};
+	// Mappings are deleted with mapping_lock held, which datapath workers
+	// also take while online. Key slots must be reclaimed lazily: waiting for
+	// a grace period there would deadlock. Mapping objects are freed by
+	// mappings_free() after the lock is released.
+	struct rte_hash_rcu_config rcu_config = {
+		.v = gr_datapath_rcu(),
+		.mode = RTE_HASH_QSBR_MODE_DQ,
+	};
+
+	params.name = "snat44-int";
+	mapping_int = rte_hash_create(&params);
+	if (mapping_int == NULL)
+		ABORT("rte_hash_create(snat44-int): %s", rte_strerror(rte_errno));
+	if (rte_hash_rcu_qsbr_add(mapping_int, &rcu_config) < 0)
+		ABORT("rte_hash_rcu_qsbr_add(snat44-int): %s", rte_strerror(rte_errno));
+
+	params.name = "snat44-ext";
+	mapping_ext = rte_hash_create(&params);
+	if (mapping_ext == NULL)
+		ABORT("rte_hash_create(snat44-ext): %s", rte_strerror(rte_errno));
+	if (rte_hash_rcu_qsbr_add(mapping_ext, &rcu_config) < 0)
+		ABORT("rte_hash_rcu_qsbr_add(snat44-ext): %s", rte_strerror(rte_errno));
+
+	mapping_timer = event_new(ev_base, -1, EV_PERSIST | EV_FINALIZE, mapping_ageing, NULL);
+	if (mapping_timer == NULL)
+		ABORT("event_new() failed");
+	if (event_add(mapping_timer, &(struct timeval) {.tv_sec = 1}) < 0)
+		ABORT("event_add() failed");
+}
+
+static void snat44_fini(struct event_base *) {
+	if (mapping_timer)
+		event_free(mapping_timer);
+	rte_hash_free(mapping_int);
+	rte_hash_free(mapping_ext);
+	rte_mempool_free(mapping_pool);
+}
+
+static struct gr_module module = {
+	.name = "snat44",
+	.depends_on = "rcu",
+	.init = snat44_init,
+	.fini = snat44_fini,
+};
+
+RTE_INIT(_init) {
+	gr_register_module(&module);
+}
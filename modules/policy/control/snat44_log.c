@@ -0,0 +1,348 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_clock.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_nat.h>
+#include <gr_nat_control.h>
+#include <gr_rcu.h>
+#include <gr_worker.h>
+
+#include <event2/event.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_ring.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// Records queued by each thread between two drains. At 100k new sessions per
+// second on a single worker, this leaves more than 3x headroom.
+#define LOG_RING_SIZE 16384
+#define LOG_DRAIN_INTERVAL_US 50000
+#define LOG_BURST 512
+#define LOG_MIN_FILE_SIZE 4096
+
+struct __rte_cache_aligned log_lcore {
+	_Atomic(struct rte_ring *) ring;
+	_Atomic(uint64_t) lost;
+};
+
+static struct log_lcore lcores[RTE_MAX_LCORE];
+static _Atomic(uint64_t) lost_unregistered;
+
+atomic_bool snat44_log_enabled;
+
+static struct gr_snat44_log_config config = {
+	.max_file_size = 64 << 20,
+	.max_files = 8,
+};
+static struct gr_snat44_log_stats stats;
+static struct event *drain_timer;
+static unsigned ctrl_lcore = LCORE_ID_ANY;
+static uint64_t file_size;
+static FILE *file;
+
+static int ring_create(unsigned lcore_id) {
+	char name[RTE_RING_NAMESIZE];
+	struct rte_ring *ring;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return 0;
+	if (atomic_load_explicit(&lcores[lcore_id].ring, memory_order_relaxed) != NULL)
+		return 0;
+
+	snprintf(name, sizeof(name), "snat44-log-%u", lcore_id);
+	ring = rte_ring_create_elem(
+		name,
+		sizeof(struct gr_snat44_log_record),
+		LOG_RING_SIZE,
+		SOCKET_ID_ANY,
+		RING_F_SP_ENQ | RING_F_SC_DEQ
+	);
+	if (ring == NULL)
+		return errno_log(rte_errno, "rte_ring_create_elem");
+
+	atomic_store_explicit(&lcores[lcore_id].ring, ring, memory_order_release);
+
+	return 0;
+}
+
+// Rings are created by the control plane only. Workers started after logging
+// was enabled get theirs on the next drain.
+static int rings_create(void) {
+	struct worker *worker;
+
+	STAILQ_FOREACH (worker, &workers, next) {
+		if (ring_create(worker->lcore_id) < 0)
+			return -errno;
+	}
+
+	return 0;
+}
+
+static int file_open(void) {
+	struct gr_snat44_log_header header = {
+		.magic = GR_SNAT44_LOG_MAGIC,
+		.version = GR_SNAT44_LOG_VERSION,
+		.record_size = sizeof(struct gr_snat44_log_record),
+	};
+	struct stat st;
+
+	file = fopen(config.path, "a");
+	if (file == NULL)
+		return errno_log(errno, config.path);
+
+	if (fstat(fileno(file), &st) < 0) {
+		int ret = errno_log(errno, "fstat");
+		fclose(file);
+		file = NULL;
+		return ret;
+	}
+
+	file_size = st.st_size;
+	if (file_size == 0) {
+		if (fwrite(&header, sizeof(header), 1, file) != 1) {
+			int ret = errno_log(errno, "fwrite");
+			fclose(file);
+			file = NULL;
+			return ret;
+		}
+		file_size = sizeof(header);
+	}
+
+	return 0;
+}
+
+static void file_close(void) {
+	if (file != NULL && fclose(file) != 0)
+		LOG(ERR, "fclose(%s): %s", config.path, strerror(errno));
+	file = NULL;
+}
+
+// Shift path.N-1 to path.N, ..., path to path.1 and reopen path.
+static int file_rotate(void) {
+	char src[PATH_MAX], dst[PATH_MAX];
+
+	file_close();
+
+	for (unsigned i = config.max_files; i > 0; i--) {
+		if (i > 1)
+			snprintf(src, sizeof(src), "%s.%u", config.path, i - 1);
+		else
+			snprintf(src, sizeof(src), "%s", config.path);
+		snprintf(dst, sizeof(dst), "%s.%u", config.path, i);
+		if (rename(src, dst) < 0 && errno != ENOENT)
+			LOG(ERR, "rename(%s, %s): %s", src, dst, strerror(errno));
+	}
+	stats.rotations++;
+
+	return file_open();
+}
+
+static void log_write(struct gr_snat44_log_record *recs, unsigned n) {
+	const size_t len = sizeof(*recs);
+	size_t room, count, written;
+
+	while (n > 0) {
+		if (file != NULL && file_size + len > config.max_file_size)
+			file_rotate();
+
+		if (file == NULL) {
+			stats.write_errors += n;
+			return;
+		}
+
+		// Fill the current file up to its maximum size.
+		room = 0;
+		if (file_size < config.max_file_size)
+			room = (config.max_file_size - file_size) / len;
+		count = RTE_MIN(n, RTE_MAX(room, 1));
+
+		written = fwrite(recs, len, count, file);
+		stats.records += written;
+		file_size += written * len;
+		if (written < count) {
+			stats.write_errors += n - written;
+			return;
+		}
+		recs += count;
+		n -= count;
+	}
+}
+
+// Records are stamped with the monotonic clock, return the offset to wall time.
+static clock_t clock_offset(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+
+	return now.tv_sec * CLOCKS_PER_SEC + now.tv_nsec / 1000 - gr_clock_us();
+}
+
+void snat44_log_push(const struct gr_snat44_log_record *rec) {
+	unsigned lcore_id = rte_lcore_id();
+	struct gr_snat44_log_record r;
+	struct rte_ring *ring;
+
+	if (lcore_id == ctrl_lcore) {
+		// Conntrack ageing, early drop and mapping expiry may produce
+		// more records in one run than a ring can hold. Write them
+		// directly, the file is buffered and flushed on the next drain.
+		r = *rec;
+		r.timestamp += clock_offset();
+		log_write(&r, 1);
+		return;
+	}
+
+	if (unlikely(lcore_id >= RTE_MAX_LCORE)) {
+		atomic_fetch_add_explicit(&lost_unregistered, 1, memory_order_relaxed);
+		return;
+	}
+
+	// Datapath workers never block, records are counted as lost when
+	// their ring is full.
+	ring = atomic_load_explicit(&lcores[lcore_id].ring, memory_order_acquire);
+	if (unlikely(ring == NULL || rte_ring_sp_enqueue_elem(ring, rec, sizeof(*rec)) < 0))
+		atomic_fetch_add_explicit(&lcores[lcore_id].lost, 1, memory_order_relaxed);
+}
+
+static void drain(void) {
+	struct gr_snat44_log_record recs[LOG_BURST];
+	clock_t offset = clock_offset();
+	struct rte_ring *ring;
+	unsigned n;
+
+	for (unsigned lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		ring = atomic_load_explicit(&lcores[lcore_id].ring, memory_order_relaxed);
+		if (ring == NULL)
+			continue;
+		do {
+			n = rte_ring_sc_dequeue_burst_elem(
+				ring, recs, sizeof(*recs), LOG_BURST, NULL
+			);
+			for (unsigned i = 0; i < n; i++)
+				recs[i].timestamp += offset;
+			if (n > 0)
+				log_write(recs, n);
+		} while (n == LOG_BURST);
+	}
+
+	if (file != NULL && fflush(file) != 0)
+		LOG(ERR, "fflush(%s): %s", config.path, strerror(errno));
+}
+
+static void drain_cb(evutil_socket_t, short /*what*/, void * /*priv*/) {
+	if (rings_create() < 0)
+		LOG(ERR, "snat44 log rings: %s", strerror(errno));
+	drain();
+}
+
+static void log_stop(void) {
+	// Wait for all workers to see the flag before the last drain.
+	atomic_store(&snat44_log_enabled, false);
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+	evtimer_del(drain_timer);
+	drain();
+	file_close();
+}
+
+static int log_start(void) {
+	struct timeval interval = {.tv_usec = LOG_DRAIN_INTERVAL_US};
+	int ret;
+
+	if ((ret = rings_create()) < 0)
+		return ret;
+	if ((ret = file_open()) < 0)
+		return ret;
+	if (event_add(drain_timer, &interval) < 0) {
+		file_close();
+		return errno_log(EIO, "event_add");
+	}
+	atomic_store(&snat44_log_enabled, true);
+
+	return 0;
+}
+
+int snat44_log_config_set(const struct gr_snat44_log_config *c) {
+	struct gr_snat44_log_config new = config;
+	int ret;
+
+	if (c->path[0] != '\0') {
+		if (strnlen(c->path, sizeof(c->path)) == sizeof(c->path))
+			return errno_set(ENAMETOOLONG);
+		memccpy(new.path, c->path, 0, sizeof(new.path));
+	}
+	if (c->max_file_size != 0) {
+		if (c->max_file_size < LOG_MIN_FILE_SIZE)
+			return errno_set(ERANGE);
+		new.max_file_size = c->max_file_size;
+	}
+	if (c->max_files != 0)
+		new.max_files = c->max_files;
+	new.enabled = c->enabled;
+
+	if (new.enabled && new.path[0] == '\0')
+		return errno_set(EINVAL);
+
+	if (config.enabled && !new.enabled) {
+		log_stop();
+	} else if (config.enabled && strcmp(new.path, config.path) != 0) {
+		// Keep producing, queued records go to the new file.
+		drain();
+		file_close();
+	}
+
+	config = new;
+
+	if (config.enabled && file == NULL) {
+		if ((ret = log_start()) < 0) {
+			atomic_store(&snat44_log_enabled, false);
+			evtimer_del(drain_timer);
+			config.enabled = false;
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+void snat44_log_config_get(struct gr_snat44_log_conf_get_resp *resp) {
+	resp->base = config;
+	resp->stats = stats;
+	resp->stats.lost = atomic_load(&lost_unregistered);
+	for (unsigned i = 0; i < RTE_MAX_LCORE; i++)
+		resp->stats.lost += atomic_load_explicit(&lcores[i].lost, memory_order_relaxed);
+}
+
+static void snat44_log_init(struct event_base *ev_base) {
+	ctrl_lcore = rte_lcore_id();
+	drain_timer = event_new(ev_base, -1, EV_PERSIST | EV_FINALIZE, drain_cb, NULL);
+	if (drain_timer == NULL)
+		ABORT("event_new() failed");
+}
+
+static void snat44_log_fini(struct event_base *) {
+	if (config.enabled)
+		log_stop();
+	if (drain_timer)
+		event_free(drain_timer);
+	for (unsigned i = 0; i < RTE_MAX_LCORE; i++)
+		rte_ring_free(lcores[i].ring);
+}
+
+static struct gr_module module = {
+	.name = "snat44_log",
+	.depends_on = "rcu",
+	.init = snat44_log_init,
+	.fini = snat44_log_fini,
+};
+
+RTE_INIT(_init) {
+	gr_register_module(&module);
+}
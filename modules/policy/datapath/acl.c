@@ -0,0 +1,251 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_acl_control.h>
+#include <gr_acl_datapath.h>
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_mbuf.h>
+#include <gr_trace.h>
+
+#include <rte_acl.h>
+#include <rte_byteorder.h>
+#include <rte_ip.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+enum {
+	PERMIT = 0,
+	DENY,
+	EDGE_COUNT,
+};
+
+struct acl_trace_data {
+	uint32_t seq;
+	gr_acl_action_t action;
+	bool matched;
+};
+
+static int acl_trace_format(char *buf, size_t len, const void *data, size_t /*data_len*/) {
+	const struct acl_trace_data *t = data;
+	if (!t->matched)
+		return snprintf(buf, len, "no match");
+	return snprintf(buf, len, "seq=%u action=%s", t->seq, gr_acl_action_name(t->action));
+}
+
+struct acl_batch {
+	struct acl_ruleset *rs;
+	uint16_t count;
+	struct rte_mbuf *mbufs[RTE_GRAPH_BURST_SIZE];
+	const uint8_t *data[RTE_GRAPH_BURST_SIZE];
+	uint32_t results[RTE_GRAPH_BURST_SIZE];
+	union acl_key keys[RTE_GRAPH_BURST_SIZE];
+};
+
+// Classify all packets of a batch in a single call and enqueue them.
+static void acl_batch_flush(struct rte_graph *graph, struct rte_node *node, struct acl_batch *b) {
+	struct acl_rule_state *state, *last = NULL;
+	const struct acl_rule_state *s;
+	uint64_t last_count = 0;
+	struct rte_mbuf *m;
+	rte_edge_t edge;
+
+	if (b->count == 0)
+		return;
+
+	if (b->rs != NULL)
+		rte_acl_classify(b->rs->ctx, b->data, b->results, b->count, 1);
+	else
+		memset(b->results, 0, b->count * sizeof(b->results[0]));
+
+	for (uint16_t i = 0; i < b->count; i++) {
+		m = b->mbufs[i];
+		s = NULL;
+		edge = PERMIT;
+
+		if (b->results[i] != 0) {
+			state = &b->rs->rules[b->results[i] - 1];
+			if (state->action == GR_ACL_DENY)
+				edge = DENY;
+			// Consecutive packets usually hit the same rule.
+			if (state != last) {
+				if (last != NULL)
+					atomic_fetch_add_explicit(
+						&last->packets, last_count, memory_order_relaxed
+					);
+				last = state;
+				last_count = 0;
+			}
+			last_count++;
+			s = state;
+		}
+
+		if (gr_mbuf_is_traced(m)) {
+			struct acl_trace_data *t = gr_mbuf_trace_add(m, node, sizeof(*t));
+			t->matched = s != NULL;
+			t->seq = s ? s->seq : 0;
+			t->action = s ? s->action : GR_ACL_PERMIT;
+		}
+		rte_node_enqueue_x1(graph, node, edge, m);
+	}
+
+	if (last != NULL)
+		atomic_fetch_add_explicit(&last->packets, last_count, memory_order_relaxed);
+
+	b->count = 0;
+}
+
+static inline uint16_t acl_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs,
+	addr_family_t af,
+	gr_acl_dir_t dir
+) {
+	struct acl_batch *b = node->ctx_ptr;
+	const struct iface *iface;
+	struct acl_ruleset *rs;
+	struct rte_mbuf *m;
+
+	b->count = 0;
+	b->rs = NULL;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		m = objs[i];
+		iface = mbuf_data(m)->iface;
+		rs = acl_ruleset_get(iface->id, dir, af);
+
+		// Packets are grouped in batches that share the same classifier.
+		if (rs != b->rs || b->count == RTE_GRAPH_BURST_SIZE) {
+			acl_batch_flush(graph, node, b);
+			b->rs = rs;
+		}
+
+		if (af == GR_AF_IP4)
+			acl4_key_fill(&b->keys[b->count].ip4, m);
+		else
+			acl6_key_fill(&b->keys[b->count].ip6, m);
+		b->data[b->count] = (const uint8_t *)&b->keys[b->count];
+		b->mbufs[b->count] = m;
+		b->count++;
+	}
+
+	acl_batch_flush(graph, node, b);
+
+	return nb_objs;
+}
+
+static int acl_node_init(const struct rte_graph *graph, struct rte_node *node) {
+	node->ctx_ptr = rte_zmalloc_socket(
+		__func__, sizeof(struct acl_batch), RTE_CACHE_LINE_SIZE, graph->socket
+	);
+	if (node->ctx_ptr == NULL)
+		return -ENOMEM;
+	return 0;
+}
+
+static void acl_node_fini(const struct rte_graph *, struct rte_node *node) {
+	rte_free(node->ctx_ptr);
+	node->ctx_ptr = NULL;
+}
+
+#define ACL_NODE(name, af, dir)                                                                    \
+	static uint16_t name##_process(                                                            \
+		struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs      \
+	) {                                                                                        \
+		return acl_process(graph, node, objs, nb_objs, af, dir);                           \
+	}
+
+ACL_NODE(ip_acl_in, GR_AF_IP4, GR_ACL_DIR_IN)
+ACL_NODE(ip6_acl_in, GR_AF_IP6, GR_ACL_DIR_IN)
+ACL_NODE(ip_acl_out, GR_AF_IP4, GR_ACL_DIR_OUT)
+ACL_NODE(ip6_acl_out, GR_AF_IP6, GR_ACL_DIR_OUT)
+
+static void acl_in_register(void) {
+	gr_eth_input_add_acl_type(RTE_BE16(RTE_ETHER_TYPE_IPV4), "ip_acl_in");
+	gr_eth_input_add_acl_type(RTE_BE16(RTE_ETHER_TYPE_IPV6), "ip6_acl_in");
+}
+
+static struct rte_node_register ip_acl_in_node = {
+	.name = "ip_acl_in",
+	.process = ip_acl_in_process,
+	.init = acl_node_init,
+	.fini = acl_node_fini,
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[PERMIT] = "ip_input",
+		[DENY] = "ip_acl_in_deny",
+	},
+};
+
+static struct rte_node_register ip6_acl_in_node = {
+	.name = "ip6_acl_in",
+	.process = ip6_acl_in_process,
+	.init = acl_node_init,
+	.fini = acl_node_fini,
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[PERMIT] = "ip6_input",
+		[DENY] = "ip6_acl_in_deny",
+	},
+};
+
+static struct rte_node_register ip_acl_out_node = {
+	.name = "ip_acl_out",
+	.process = ip_acl_out_process,
+	.init = acl_node_init,
+	.fini = acl_node_fini,
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[PERMIT] = "eth_output",
+		[DENY] = "ip_acl_out_deny",
+	},
+};
+
+static struct rte_node_register ip6_acl_out_node = {
+	.name = "ip6_acl_out",
+	.process = ip6_acl_out_process,
+	.init = acl_node_init,
+	.fini = acl_node_fini,
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[PERMIT] = "eth_output",
+		[DENY] = "ip6_acl_out_deny",
+	},
+};
+
+static struct gr_node_info ip_acl_in_info = {
+	.node = &ip_acl_in_node,
+	.register_callback = acl_in_register,
+	.trace_format = acl_trace_format,
+};
+
+static struct gr_node_info ip6_acl_in_info = {
+	.node = &ip6_acl_in_node,
+	.trace_format = acl_trace_format,
+};
+
+static struct gr_node_info ip_acl_out_info = {
+	.node = &ip_acl_out_node,
+	.trace_format = acl_trace_format,
+};
+
+static struct gr_node_info ip6_acl_out_info = {
+	.node = &ip6_acl_out_node,
+	.trace_format = acl_trace_format,
+};
+
+GR_NODE_REGISTER(ip_acl_in_info);
+GR_NODE_REGISTER(ip6_acl_in_info);
+GR_NODE_REGISTER(ip_acl_out_info);
+GR_NODE_REGISTER(ip6_acl_out_info);
+
+GR_DROP_REGISTER(ip_acl_in_deny);
+GR_DROP_REGISTER(ip6_acl_in_deny);
+GR_DROP_REGISTER(ip_acl_out_deny);
+GR_DROP_REGISTER(ip6_acl_out_deny);
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_acl_control.h>
+
+#include <rte_byteorder.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+
+#include <netinet/in.h>
+#include <string.h>
+
+static inline bool acl_has_ports(uint8_t proto) {
+	return proto == IPPROTO_TCP || proto == IPPROTO_UDP || proto == IPPROTO_SCTP;
+}
+
+// Ingress packets have not been validated yet. Truncated headers produce
+// a zero key, ip_input and ip6_input will drop them anyway.
+static inline void acl4_key_fill(struct acl4_key *k, struct rte_mbuf *m) {
+	const struct rte_ipv4_hdr *ip = rte_pktmbuf_mtod(m, const struct rte_ipv4_hdr *);
+	const rte_be16_t *ports;
+	uint16_t hdr_len;
+
+	memset(k, 0, sizeof(*k));
+	if (unlikely(rte_pktmbuf_data_len(m) < sizeof(*ip)))
+		return;
+
+	k->proto = ip->next_proto_id;
+	k->dscp = ip->type_of_service >> 2;
+	k->src = ip->src_addr;
+	k->dst = ip->dst_addr;
+
+	// Ports are only available in first fragments.
+	hdr_len = rte_ipv4_hdr_len(ip);
+	if (acl_has_ports(k->proto)
+	    && !(ip->fragment_offset & RTE_BE16(RTE_IPV4_HDR_OFFSET_MASK))
+	    && rte_pktmbuf_data_len(m) >= hdr_len + 2 * sizeof(*ports)) {
+		ports = rte_pktmbuf_mtod_offset(m, const rte_be16_t *, hdr_len);
+		k->sport = ports[0];
+		k->dport = ports[1];
+	}
+}
+
+// Extension headers are not parsed, ports are only matched when the L4 header
+// immediately follows the IPv6 header.
+static inline void acl6_key_fill(struct acl6_key *k, struct rte_mbuf *m) {
+	const struct rte_ipv6_hdr *ip = rte_pktmbuf_mtod(m, const struct rte_ipv6_hdr *);
+	const rte_be16_t *ports;
+
+	memset(k, 0, sizeof(*k));
+	if (unlikely(rte_pktmbuf_data_len(m) < sizeof(*ip)))
+		return;
+
+	k->proto = ip->proto;
+	k->dscp = (rte_be_to_cpu_32(ip->vtc_flow) >> 22) & 0x3f;
+	k->src = ip->src_addr;
+	k->dst = ip->dst_addr;
+
+	if (acl_has_ports(k->proto)
+	    && rte_pktmbuf_data_len(m) >= sizeof(*ip) + 2 * sizeof(*ports)) {
+		ports = rte_pktmbuf_mtod_offset(m, const rte_be16_t *, sizeof(*ip));
+		k->sport = ports[0];
+		k->dport = ports[1];
+	}
+}
+
+union acl_key {
+	struct acl4_key ip4;
+	struct acl6_key ip6;
+};
@@ -0,0 +1,274 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_acl_datapath.h>
+#include <gr_fib4.h>
+#include <gr_fib6.h>
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_ip4_datapath.h>
+#include <gr_ip6_datapath.h>
+#include <gr_mbuf.h>
+#include <gr_pbr_control.h>
+#include <gr_trace.h>
+
+#include <rte_acl.h>
+#include <rte_ip.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+enum {
+	FORWARD = 0,
+	LOCAL,
+	NO_ROUTE,
+	BLACKHOLE,
+	EDGE_COUNT,
+};
+
+struct pbr_trace_data {
+	uint32_t seq;
+	gr_pbr_action_t action;
+	bool matched;
+	uint16_t vrf_id;
+	uint32_t nh_id;
+};
+
+static int pbr_trace_format(char *buf, size_t len, const void *data, size_t /*data_len*/) {
+	const struct pbr_trace_data *t = data;
+	if (!t->matched)
+		return snprintf(buf, len, "no match");
+	if (t->action == GR_PBR_ACTION_VRF)
+		return snprintf(buf, len, "seq=%u vrf=%u", t->seq, t->vrf_id);
+	return snprintf(buf, len, "seq=%u nh_id=%u", t->seq, t->nh_id);
+}
+
+struct pbr_batch {
+	struct pbr_ruleset *rs;
+	uint16_t count;
+	struct rte_mbuf *mbufs[RTE_GRAPH_BURST_SIZE];
+	const uint8_t *data[RTE_GRAPH_BURST_SIZE];
+	uint32_t results[RTE_GRAPH_BURST_SIZE];
+	union acl_key keys[RTE_GRAPH_BURST_SIZE];
+};
+
+// Resolve the next hop selected by a rule and the node that should handle it.
+static inline rte_edge_t
+pbr_resolve(const struct pbr_rule_state *s, struct rte_mbuf *m, addr_family_t af) {
+	const struct nexthop_info_l3 *l3;
+	const struct rte_ipv4_hdr *ip4 = NULL;
+	const struct rte_ipv6_hdr *ip6 = NULL;
+	const struct iface *iface;
+	const struct nexthop *nh;
+
+	if (af == GR_AF_IP4) {
+		ip4 = rte_pktmbuf_mtod(m, const struct rte_ipv4_hdr *);
+		if (s->action == GR_PBR_ACTION_VRF)
+			nh = fib4_lookup(s->vrf_id, ip4->dst_addr);
+		else
+			nh = s->nh;
+		ip_output_mbuf_data(m)->nh = nh;
+	} else {
+		ip6 = rte_pktmbuf_mtod(m, const struct rte_ipv6_hdr *);
+		iface = mbuf_data(m)->iface;
+		if (s->action == GR_PBR_ACTION_VRF)
+			nh = fib6_lookup(s->vrf_id, iface->id, &ip6->dst_addr);
+		else
+			nh = s->nh;
+		ip6_output_mbuf_data(m)->nh = nh;
+	}
+
+	if (nh == NULL)
+		return NO_ROUTE;
+
+	switch (nh->type) {
+	case GR_NH_T_L3:
+		l3 = nexthop_info_l3(nh);
+		if (!(l3->flags & GR_NH_F_LOCAL))
+			return FORWARD;
+		// The destination may be one of our addresses in the selected VRF.
+		if (af == GR_AF_IP4 && ip4->dst_addr == l3->ipv4)
+			return LOCAL;
+		if (af == GR_AF_IP6 && rte_ipv6_addr_eq(&ip6->dst_addr, &l3->ipv6))
+			return LOCAL;
+		return FORWARD;
+	case GR_NH_T_GROUP:
+	case GR_NH_T_SR6_OUTPUT:
+	case GR_NH_T_MPLS:
+		return FORWARD;
+	case GR_NH_T_BLACKHOLE:
+		return BLACKHOLE;
+	default:
+		return NO_ROUTE;
+	}
+}
+
+// Classify all packets of a batch in a single call and enqueue them.
+static void pbr_batch_flush(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	struct pbr_batch *b,
+	addr_family_t af
+) {
+	struct pbr_rule_state *state, *last = NULL;
+	const struct pbr_rule_state *s;
+	uint64_t last_count = 0;
+	struct rte_mbuf *m;
+	rte_edge_t edge;
+
+	if (b->count == 0)
+		return;
+
+	if (b->rs != NULL)
+		rte_acl_classify(b->rs->ctx, b->data, b->results, b->count, 1);
+	else
+		memset(b->results, 0, b->count * sizeof(b->results[0]));
+
+	for (uint16_t i = 0; i < b->count; i++) {
+		m = b->mbufs[i];
+		s = NULL;
+		// Unmatched packets use the route resolved by ip(6)_input, if any.
+		if (af == GR_AF_IP4)
+			edge = ip_output_mbuf_data(m)->nh != NULL ? FORWARD : NO_ROUTE;
+		else
+			edge = ip6_output_mbuf_data(m)->nh != NULL ? FORWARD : NO_ROUTE;
+
+		if (b->results[i] != 0) {
+			state = &b->rs->rules[b->results[i] - 1];
+			edge = pbr_resolve(state, m, af);
+			// Consecutive packets usually hit the same rule.
+			if (state != last) {
+				if (last != NULL)
+					atomic_fetch_add_explicit(
+						&last->packets, last_count, memory_order_relaxed
+					);
+				last = state;
+				last_count = 0;
+			}
+			last_count++;
+			s = state;
+		}
+
+		if (gr_mbuf_is_traced(m)) {
+			struct pbr_trace_data *t = gr_mbuf_trace_add(m, node, sizeof(*t));
+			t->matched = s != NULL;
+			t->seq = s ? s->seq : 0;
+			t->action = s ? s->action : 0;
+			t->vrf_id = s ? s->vrf_id : 0;
+			t->nh_id = s && s->nh ? s->nh->nh_id : 0;
+		}
+		rte_node_enqueue_x1(graph, node, edge, m);
+	}
+
+	if (last != NULL)
+		atomic_fetch_add_explicit(&last->packets, last_count, memory_order_relaxed);
+
+	b->count = 0;
+}
+
+static inline uint16_t pbr_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs,
+	addr_family_t af
+) {
+	struct pbr_batch *b = node->ctx_ptr;
+	const struct iface *iface;
+	struct pbr_ruleset *rs;
+	struct rte_mbuf *m;
+
+	b->count = 0;
+	b->rs = NULL;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		m = objs[i];
+		iface = mbuf_data(m)->iface;
+		rs = pbr_ruleset_get(iface->id, af);
+
+		// Packets are grouped in batches that share the same classifier.
+		if (rs != b->rs || b->count == RTE_GRAPH_BURST_SIZE) {
+			pbr_batch_flush(graph, node, b, af);
+			b->rs = rs;
+		}
+
+		if (af == GR_AF_IP4)
+			acl4_key_fill(&b->keys[b->count].ip4, m);
+		else
+			acl6_key_fill(&b->keys[b->count].ip6, m);
+		b->data[b->count] = (const uint8_t *)&b->keys[b->count];
+		b->mbufs[b->count] = m;
+		b->count++;
+	}
+
+	pbr_batch_flush(graph, node, b, af);
+
+	return nb_objs;
+}
+
+static uint16_t
+ip_pbr_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	return pbr_process(graph, node, objs, nb_objs, GR_AF_IP4);
+}
+
+static uint16_t
+ip6_pbr_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	return pbr_process(graph, node, objs, nb_objs, GR_AF_IP6);
+}
+
+static int pbr_node_init(const struct rte_graph *graph, struct rte_node *node) {
+	node->ctx_ptr = rte_zmalloc_socket(
+		__func__, sizeof(struct pbr_batch), RTE_CACHE_LINE_SIZE, graph->socket
+	);
+	if (node->ctx_ptr == NULL)
+		return -ENOMEM;
+	return 0;
+}
+
+static void pbr_node_fini(const struct rte_graph *, struct rte_node *node) {
+	rte_free(node->ctx_ptr);
+	node->ctx_ptr = NULL;
+}
+
+static struct rte_node_register ip_pbr_node = {
+	.name = "ip_pbr",
+	.process = ip_pbr_process,
+	.init = pbr_node_init,
+	.fini = pbr_node_fini,
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[FORWARD] = "ip_forward",
+		[LOCAL] = "ip_input_local",
+		[NO_ROUTE] = "ip_error_dest_unreach",
+		[BLACKHOLE] = "ip_blackhole",
+	},
+};
+
+static struct rte_node_register ip6_pbr_node = {
+	.name = "ip6_pbr",
+	.process = ip6_pbr_process,
+	.init = pbr_node_init,
+	.fini = pbr_node_fini,
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[FORWARD] = "ip6_forward",
+		[LOCAL] = "ip6_input_local",
+		[NO_ROUTE] = "ip6_error_dest_unreach",
+		[BLACKHOLE] = "ip6_blackhole",
+	},
+};
+
+static struct gr_node_info ip_pbr_info = {
+	.node = &ip_pbr_node,
+	.trace_format = pbr_trace_format,
+};
+
+static struct gr_node_info ip6_pbr_info = {
+	.node = &ip6_pbr_node,
+	.trace_format = pbr_trace_format,
+};
+
+GR_NODE_REGISTER(ip_pbr_info);
+GR_NODE_REGISTER(ip6_pbr_info);
@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_mbuf.h>
+#include <gr_nat_datapath.h>
+#include <gr_qos_control.h>
+#include <gr_trace.h>
+
+#include <rte_byteorder.h>
+#include <rte_cycles.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+#include <rte_meter.h>
+
+enum {
+	INPUT = 0,
+	ACL_IN,
+	DROP,
+	EDGE_COUNT,
+};
+
+static_assert((int)GR_COLOR_GREEN == (int)RTE_COLOR_GREEN);
+static_assert((int)GR_COLOR_YELLOW == (int)RTE_COLOR_YELLOW);
+static_assert((int)GR_COLOR_RED == (int)RTE_COLOR_RED);
+
+struct police_trace_data {
+	gr_color_t color;
+	gr_policer_action_t action;
+	uint8_t dscp;
+};
+
+static int police_trace_format(char *buf, size_t len, const void *data, size_t /*data_len*/) {
+	const struct police_trace_data *t = data;
+
+	switch (t->action) {
+	case GR_POLICER_PASS:
+		return snprintf(buf, len, "color=%s", gr_color_name(t->color));
+	case GR_POLICER_DROP:
+		return snprintf(buf, len, "color=%s drop", gr_color_name(t->color));
+	case GR_POLICER_REMARK:
+		return snprintf(buf, len, "color=%s dscp=%u", gr_color_name(t->color), t->dscp);
+	}
+	return 0;
+}
+
+static inline void police_remark(struct rte_mbuf *m, addr_family_t af, uint8_t dscp) {
+	if (af == GR_AF_IP4) {
+		struct rte_ipv4_hdr *ip = rte_pktmbuf_mtod(m, struct rte_ipv4_hdr *);
+		// version_ihl and type_of_service
+		rte_be16_t *word = (rte_be16_t *)ip;
+		rte_be16_t old;
+
+		if (unlikely(rte_pktmbuf_data_len(m) < sizeof(*ip)))
+			return;
+		old = *word;
+		ip->type_of_service = (dscp << 2) | (ip->type_of_service & 0x3);
+		ip->hdr_checksum = fixup_checksum_16(ip->hdr_checksum, old, *word);
+	} else {
+		struct rte_ipv6_hdr *ip = rte_pktmbuf_mtod(m, struct rte_ipv6_hdr *);
+		uint32_t vtc_flow;
+
+		if (unlikely(rte_pktmbuf_data_len(m) < sizeof(*ip)))
+			return;
+		vtc_flow = rte_be_to_cpu_32(ip->vtc_flow);
+		vtc_flow &= ~(UINT32_C(0x3f) << 22);
+		vtc_flow |= (uint32_t)dscp << 22;
+		ip->vtc_flow = rte_cpu_to_be_32(vtc_flow);
+	}
+}
+
+static inline uint16_t police_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs,
+	addr_family_t af
+) {
+	struct qos_policer *p, *locked = NULL;
+	struct gr_policer_action action;
+	uint64_t now = rte_rdtsc();
+	const struct iface *iface;
+	struct rte_mbuf *m;
+	enum rte_color color;
+	rte_edge_t edge;
+	uint32_t len;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		m = objs[i];
+		iface = mbuf_data(m)->iface;
+		p = qos_policer_get(iface->id);
+
+		if (p != NULL) {
+			// Consecutive packets usually come from the same interface.
+			if (p != locked) {
+				if (locked != NULL)
+					rte_spinlock_unlock(&locked->lock);
+				rte_spinlock_lock(&p->lock);
+				locked = p;
+			}
+			len = rte_pktmbuf_pkt_len(m);
+			if (p->conf.mode == GR_POLICER_SRTCM)
+				color = rte_meter_srtcm_color_blind_check(
+					&p->srtcm, &p->srtcm_profile, now, len
+				);
+			else
+				color = rte_meter_trtcm_color_blind_check(
+					&p->trtcm, &p->trtcm_profile, now, len
+				);
+			p->stats[color].packets++;
+			p->stats[color].bytes += len;
+			action = p->conf.actions[color];
+		} else {
+			color = RTE_COLOR_GREEN;
+			action = (struct gr_policer_action) {.action = GR_POLICER_PASS};
+		}
+
+		switch (action.action) {
+		case GR_POLICER_DROP:
+			edge = DROP;
+			break;
+		case GR_POLICER_REMARK:
+			police_remark(m, af, action.dscp);
+			// fallthrough
+		default:
+			edge = iface->flags & GR_IFACE_F_ACL_IN ? ACL_IN : INPUT;
+			break;
+		}
+
+		if (gr_mbuf_is_traced(m)) {
+			struct police_trace_data *t = gr_mbuf_trace_add(m, node, sizeof(*t));
+			t->color = (gr_color_t)color;
+			t->action = action.action;
+			t->dscp = action.dscp;
+		}
+		rte_node_enqueue_x1(graph, node, edge, m);
+	}
+
+	if (locked != NULL)
+		rte_spinlock_unlock(&locked->lock);
+
+	return nb_objs;
+}
+
+static uint16_t
+ip_police_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	return police_process(graph, node, objs, nb_objs, GR_AF_IP4);
+}
+
+static uint16_t
+ip6_police_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	return police_process(graph, node, objs, nb_objs, GR_AF_IP6);
+}
+
+static void police_register(void) {
+	gr_eth_input_add_police_type(RTE_BE16(RTE_ETHER_TYPE_IPV4), "ip_police");
+	gr_eth_input_add_police_type(RTE_BE16(RTE_ETHER_TYPE_IPV6), "ip6_police");
+}
+
+static struct rte_node_register ip_police_node = {
+	.name = "ip_police",
+	.process = ip_police_process,
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[INPUT] = "ip_input",
+		[ACL_IN] = "ip_acl_in",
+		[DROP] = "ip_police_drop",
+	},
+};
+
+static struct rte_node_register ip6_police_node = {
+	.name = "ip6_police",
+	.process = ip6_police_process,
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[INPUT] = "ip6_input",
+		[ACL_IN] = "ip6_acl_in",
+		[DROP] = "ip6_police_drop",
+	},
+};
+
+static struct gr_node_info ip_police_info = {
+	.node = &ip_police_node,
+	.register_callback = police_register,
+	.trace_format = police_trace_format,
+};
+
+static struct gr_node_info ip6_police_info = {
+	.node = &ip6_police_node,
+	.trace_format = police_trace_format,
+};
+
+GR_NODE_REGISTER(ip_police_info);
+GR_NODE_REGISTER(ip6_police_info);
+
+GR_DROP_REGISTER(ip_police_drop);
+GR_DROP_REGISTER(ip6_police_drop);
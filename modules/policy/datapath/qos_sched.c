@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_mbuf.h>
+#include <gr_port.h>
+#include <gr_qos_control.h>
+#include <gr_trace.h>
+
+#include <rte_byteorder.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+#include <rte_sched.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+enum {
+	OUTPUT = 0,
+	EDGE_COUNT,
+};
+
+struct sched_trace_data {
+	uint32_t pipe;
+	uint8_t tc;
+	uint8_t queue;
+};
+
+static int sched_trace_format(char *buf, size_t len, const void *data, size_t /*data_len*/) {
+	const struct sched_trace_data *t = data;
+	return snprintf(buf, len, "pipe=%u tc=%u queue=%u", t->pipe, t->tc, t->queue);
+}
+
+// Select the subscriber pipe, traffic class and queue of a packet.
+static inline void sched_classify(
+	const struct qos_sched *s,
+	const struct rte_mbuf *m,
+	uint32_t *pipe,
+	uint32_t *tc,
+	uint32_t *queue
+) {
+	const struct rte_ether_hdr *eth = rte_pktmbuf_mtod(m, const struct rte_ether_hdr *);
+	size_t l2_len = sizeof(*eth);
+	rte_be16_t eth_type = eth->ether_type;
+	const struct rte_vlan_hdr *vlan;
+	bool qinq = false;
+	uint8_t dscp = 0;
+
+	*pipe = 0;
+
+	// QinQ sub-interfaces use the default subscriber.
+	if (m->ol_flags & RTE_MBUF_F_TX_QINQ) {
+		qinq = true;
+	} else if (m->ol_flags & RTE_MBUF_F_TX_VLAN) {
+		*pipe = s->vlan_pipes[m->vlan_tci & 0xfff];
+	} else if (eth_type == RTE_BE16(RTE_ETHER_TYPE_QINQ)) {
+		vlan = rte_pktmbuf_mtod_offset(m, const struct rte_vlan_hdr *, l2_len);
+		eth_type = vlan->eth_proto;
+		l2_len += sizeof(*vlan);
+		qinq = true;
+	}
+	if (eth_type == RTE_BE16(RTE_ETHER_TYPE_VLAN)) {
+		vlan = rte_pktmbuf_mtod_offset(m, const struct rte_vlan_hdr *, l2_len);
+		if (!qinq)
+			*pipe = s->vlan_pipes[rte_be_to_cpu_16(vlan->vlan_tci) & 0xfff];
+		eth_type = vlan->eth_proto;
+		l2_len += sizeof(*vlan);
+	}
+
+	if (eth_type == RTE_BE16(RTE_ETHER_TYPE_IPV4)
+	    && rte_pktmbuf_data_len(m) >= l2_len + sizeof(struct rte_ipv4_hdr)) {
+		const struct rte_ipv4_hdr *ip = rte_pktmbuf_mtod_offset(
+			m, const struct rte_ipv4_hdr *, l2_len
+		);
+		dscp = ip->type_of_service >> 2;
+	} else if (eth_type == RTE_BE16(RTE_ETHER_TYPE_IPV6)
+		   && rte_pktmbuf_data_len(m) >= l2_len + sizeof(struct rte_ipv6_hdr)) {
+		const struct rte_ipv6_hdr *ip = rte_pktmbuf_mtod_offset(
+			m, const struct rte_ipv6_hdr *, l2_len
+		);
+		dscp = (rte_be_to_cpu_32(ip->vtc_flow) >> 22) & 0x3f;
+	}
+
+	qos_dscp_queue(dscp, tc, queue);
+}
+
+static void sched_run(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	struct qos_sched *s,
+	struct rte_mbuf **mbufs,
+	uint16_t n
+) {
+	struct rte_mbuf *out[RTE_GRAPH_BURST_SIZE];
+
+	rte_spinlock_lock(&s->lock);
+	// Packets that do not fit in their queue are freed by rte_sched.
+	rte_sched_port_enqueue(s->port, mbufs, n);
+	n = rte_sched_port_dequeue(s->port, out, RTE_GRAPH_BURST_SIZE);
+	rte_spinlock_unlock(&s->lock);
+
+	if (n > 0)
+		rte_node_enqueue(graph, node, OUTPUT, (void **)out, n);
+}
+
+static uint16_t
+port_sched_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	struct rte_mbuf **mbufs = (struct rte_mbuf **)objs;
+	struct qos_sched *s, *run_sched = NULL;
+	const struct iface *iface;
+	uint32_t pipe, tc, queue;
+	uint16_t run_start = 0;
+	struct rte_mbuf *m;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		m = mbufs[i];
+		iface = mbuf_data(m)->iface;
+		// Schedulers can only be attached to ports.
+		s = NULL;
+		if (iface->type == GR_IFACE_TYPE_PORT)
+			s = qos_sched_get(iface_info_port(iface)->port_id);
+
+		if (s != run_sched) {
+			if (run_sched != NULL)
+				sched_run(graph, node, run_sched, &mbufs[run_start], i - run_start);
+			run_sched = s;
+			run_start = i;
+		}
+
+		if (s == NULL) {
+			// The scheduler was removed, send the packet directly.
+			rte_node_enqueue_x1(graph, node, OUTPUT, m);
+			continue;
+		}
+
+		sched_classify(s, m, &pipe, &tc, &queue);
+		rte_sched_port_pkt_write(s->port, m, 0, pipe, tc, queue, RTE_COLOR_GREEN);
+
+		if (gr_mbuf_is_traced(m)) {
+			struct sched_trace_data *t = gr_mbuf_trace_add(m, node, sizeof(*t));
+			t->pipe = pipe;
+			t->tc = tc;
+			t->queue = queue;
+			// Packets may be dropped by the scheduler or dequeued by
+			// another worker. The trace ends here.
+			gr_mbuf_trace_finish(m);
+		}
+	}
+
+	if (run_sched != NULL)
+		sched_run(graph, node, run_sched, &mbufs[run_start], nb_objs - run_start);
+
+	return nb_objs;
+}
+
+// Drain the scheduler queues even when no new packets are sent.
+static uint16_t port_sched_poll_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void ** /*objs*/,
+	uint16_t /*nb_objs*/
+) {
+	struct rte_mbuf *out[RTE_GRAPH_BURST_SIZE];
+	struct qos_sched *s;
+	uint16_t total = 0;
+	int n;
+
+	if (atomic_load_explicit(&qos_sched_count, memory_order_relaxed) == 0)
+		return 0;
+
+	for (uint16_t port_id = 0; port_id < RTE_MAX_ETHPORTS; port_id++) {
+		if ((s = qos_sched_get(port_id)) == NULL)
+			continue;
+		// Another worker is already serving this port.
+		if (!rte_spinlock_trylock(&s->lock))
+			continue;
+		n = rte_sched_port_dequeue(s->port, out, RTE_GRAPH_BURST_SIZE);
+		rte_spinlock_unlock(&s->lock);
+		if (n > 0) {
+			rte_node_enqueue(graph, node, OUTPUT, (void **)out, n);
+			total += n;
+		}
+	}
+
+	return total;
+}
+
+static struct rte_node_register port_sched_node = {
+	.name = "port_sched",
+	.process = port_sched_process,
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[OUTPUT] = "port_output",
+	},
+};
+
+static struct rte_node_register port_sched_poll_node = {
+	.flags = RTE_NODE_SOURCE_F,
+	.name = "port_sched_poll",
+	.process = port_sched_poll_process,
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[OUTPUT] = "port_output",
+	},
+};
+
+static struct gr_node_info port_sched_info = {
+	.node = &port_sched_node,
+	.trace_format = sched_trace_format,
+};
+
+static struct gr_node_info port_sched_poll_info = {
+	.node = &port_sched_poll_node,
+};
+
+GR_NODE_REGISTER(port_sched_info);
+GR_NODE_REGISTER(port_sched_poll_info);
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_fib4.h>
+#include <gr_graph.h>
+#include <gr_ip4_datapath.h>
+#include <gr_mbuf.h>
+#include <gr_nat_control.h>
+#include <gr_nat_datapath.h>
+#include <gr_trace.h>
+
+#include <rte_hash.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+
+#include <stdatomic.h>
+
+enum edges {
+	FORWARD = 0,
+	LOCAL,
+	NO_ROUTE,
+	NO_PORT,
+	EDGE_COUNT,
+};
+
+// TCP and UDP headers both start with the source and destination ports.
+struct l4_ports {
+	rte_be16_t src;
+	rte_be16_t dst;
+};
+
+static inline struct l4_ports *l4_ports(struct rte_mbuf *m, const struct rte_ipv4_hdr *ip) {
+	if (ip->next_proto_id != IPPROTO_TCP && ip->next_proto_id != IPPROTO_UDP)
+		return NULL;
+	// Non first fragments don't have any L4 header.
+	if (rte_be_to_cpu_16(ip->fragment_offset) & RTE_IPV4_HDR_OFFSET_MASK)
+		return NULL;
+	return rte_pktmbuf_mtod_offset(m, struct l4_ports *, rte_ipv4_hdr_len(ip));
+}
+
+static inline rte_be16_t l4_cksum(
+	rte_be16_t cksum,
+	const struct rte_ipv4_hdr *ip,
+	const struct l4_ports *ports,
+	const struct snat44_mapping *src,
+	const struct snat44_mapping *dst
+) {
+	cksum = fixup_checksum_32(cksum, ip->src_addr, src->ext_key.addr);
+	cksum = fixup_checksum_32(cksum, ip->dst_addr, dst->int_key.addr);
+	cksum = fixup_checksum_16(cksum, ports->src, src->ext_key.port);
+	cksum = fixup_checksum_16(cksum, ports->dst, dst->int_key.port);
+	return cksum;
+}
+
+// Replace the source with the external endpoint of the sender and the destination
+// with the internal endpoint of the receiver (RFC 4787 REQ-9).
+static void hairpin_translate(
+	struct rte_mbuf *m,
+	const struct snat44_mapping *src,
+	const struct snat44_mapping *dst
+) {
+	struct rte_ipv4_hdr *ip = rte_pktmbuf_mtod(m, struct rte_ipv4_hdr *);
+	struct l4_ports *ports = l4_ports(m, ip);
+
+	switch (ip->next_proto_id) {
+	case IPPROTO_TCP: {
+		struct rte_tcp_hdr *tcp = (struct rte_tcp_hdr *)ports;
+		tcp->cksum = l4_cksum(tcp->cksum, ip, ports, src, dst);
+		break;
+	}
+	case IPPROTO_UDP: {
+		struct rte_udp_hdr *udp = (struct rte_udp_hdr *)ports;
+		if (udp->dgram_cksum != 0) {
+			udp->dgram_cksum = l4_cksum(udp->dgram_cksum, ip, ports, src, dst);
+			if (udp->dgram_cksum == RTE_BE16(0)) {
+				// Prevent UDP checksum from becoming 0 (RFC 768).
+				udp->dgram_cksum = RTE_BE16(0xffff);
+			}
+		}
+		break;
+	}
+	}
+	ports->src = src->ext_key.port;
+	ports->dst = dst->int_key.port;
+
+	// Modify the addresses *after* updating the TCP/UDP checksum.
+	ip->hdr_checksum = fixup_checksum_32(ip->hdr_checksum, ip->src_addr, src->ext_key.addr);
+	ip->hdr_checksum = fixup_checksum_32(ip->hdr_checksum, ip->dst_addr, dst->int_key.addr);
+	ip->src_addr = src->ext_key.addr;
+	ip->dst_addr = dst->int_key.addr;
+}
+
+static uint16_t snat44_hairpin_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs
+) {
+	struct snat44_mapping_key ext_keys[RTE_HASH_LOOKUP_BULK_MAX];
+	struct snat44_mapping_key int_keys[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct snat44_mapping_key *keys[RTE_HASH_LOOKUP_BULK_MAX];
+	struct snat44_mapping *dst[RTE_HASH_LOOKUP_BULK_MAX];
+	struct snat44_mapping *src[RTE_HASH_LOOKUP_BULK_MAX];
+	clock_t now = gr_clock_us();
+	const struct snat44_policy *policy;
+	const struct iface *iface;
+	uint64_t dst_hits, src_hits;
+	struct snat44_mapping *s;
+	struct l4_ports *ports;
+	struct rte_ipv4_hdr *ip;
+	const struct nexthop *nh;
+	struct rte_mbuf *m;
+	rte_edge_t edge;
+	uint16_t i, n;
+
+	for (uint16_t start = 0; start < nb_objs; start += n) {
+		n = RTE_MIN(nb_objs - start, RTE_HASH_LOOKUP_BULK_MAX);
+
+		// Lookup the destinations among the external endpoints of all mappings.
+		for (i = 0; i < n; i++) {
+			m = objs[start + i];
+			ip = rte_pktmbuf_mtod(m, struct rte_ipv4_hdr *);
+			ports = l4_ports(m, ip);
+			ext_keys[i] = (struct snat44_mapping_key) {0};
+			if (ports != NULL) {
+				ext_keys[i].addr = ip->dst_addr;
+				ext_keys[i].id = mbuf_data(m)->iface->vrf_id;
+				ext_keys[i].port = ports->dst;
+				ext_keys[i].proto = ip->next_proto_id;
+			}
+			keys[i] = &ext_keys[i];
+		}
+		dst_hits = snat44_mapping_lookup_bulk(true, keys, n, dst);
+
+		// Lookup the mappings of the internal sources of matching packets.
+		for (i = 0; i < n; i++) {
+			int_keys[i] = (struct snat44_mapping_key) {0};
+			if (dst_hits & GR_BIT64(i)) {
+				m = objs[start + i];
+				ip = rte_pktmbuf_mtod(m, struct rte_ipv4_hdr *);
+				int_keys[i].addr = ip->src_addr;
+				int_keys[i].id = dst[i]->policy->iface_id;
+				int_keys[i].port = l4_ports(m, ip)->src;
+				int_keys[i].proto = ip->next_proto_id;
+			}
+			keys[i] = &int_keys[i];
+		}
+		src_hits = snat44_mapping_lookup_bulk(false, keys, n, src);
+
+		for (i = 0; i < n; i++) {
+			m = objs[start + i];
+			ip = rte_pktmbuf_mtod(m, struct rte_ipv4_hdr *);
+			iface = mbuf_data(m)->iface;
+			edge = LOCAL;
+
+			if (!(dst_hits & GR_BIT64(i)))
+				goto next;
+
+			// Only internal hosts are hairpinned.
+			policy = dst[i]->policy;
+			if (!ip4_addr_same_subnet(
+				    ip->src_addr, policy->net.ip, policy->net.prefixlen
+			    ))
+				goto next;
+
+			if (src_hits & GR_BIT64(i)) {
+				s = src[i];
+				atomic_store(&s->last_used, now);
+			} else {
+				s = snat44_mapping_get(
+					dst[i]->policy,
+					int_keys[i].proto,
+					int_keys[i].addr,
+					int_keys[i].port
+				);
+				if (s == NULL) {
+					edge = NO_PORT;
+					goto next;
+				}
+				// Not referenced by any connection, the mapping will expire
+				// unless it is used again.
+				snat44_mapping_put(s);
+			}
+			atomic_store(&dst[i]->last_used, now);
+
+			hairpin_translate(m, s, dst[i]);
+
+			nh = fib4_lookup(iface->vrf_id, ip->dst_addr);
+			ip_output_mbuf_data(m)->nh = nh;
+			edge = nh != NULL ? FORWARD : NO_ROUTE;
+next:
+			if (gr_mbuf_is_traced(m)) {
+				struct rte_ipv4_hdr *t = gr_mbuf_trace_add(m, node, sizeof(*t));
+				*t = *ip;
+			}
+			rte_node_enqueue_x1(graph, node, edge, m);
+		}
+	}
+
+	return nb_objs;
+}
+
+static struct rte_node_register node = {
+	.name = "snat44_hairpin",
+
+	.process = snat44_hairpin_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[FORWARD] = "ip_forward",
+		[LOCAL] = "ip_input_local",
+		[NO_ROUTE] = "ip_error_dest_unreach",
+		[NO_PORT] = "snat44_hairpin_no_port",
+	},
+};
+
+static struct gr_node_info info = {
+	.node = &node,
+	.trace_format = (gr_trace_format_cb_t)trace_ip_format,
+};
+
+GR_NODE_REGISTER(info);
+
+GR_DROP_REGISTER(snat44_hairpin_no_port);
@@ -19,11 +19,21 @@
 typedef enum : uint8_t {
 	SR_H_ENCAPS,
 	SR_H_ENCAPS_RED,
+	SR_H_ENCAPS_L2,
 } gr_srv6_encap_behavior_t;
 
+// Default NEXT-CSID format (rfc9800 F3216): 32 bits locator block, 16 bits micro-SIDs.
+#define GR_SRV6_CSID_BLOCK_BITS 32
+#define GR_SRV6_CSID_BITS 16
+
 struct gr_nexthop_info_srv6 {
 	gr_srv6_encap_behavior_t encap_behavior;
 	uint8_t n_seglist;
+	// When not zero, consecutive segments sharing the same locator block are
+	// packed into NEXT-CSID containers (rfc9800). The resulting containers
+	// are reported instead of the original segments.
+	uint8_t csid_block_bits;
+	uint8_t csid_bits;
 	struct rte_ipv6_addr seglist[];
 };
 
@@ -44,6 +54,22 @@ struct gr_srv6_tunsrc_show_resp {
 	struct rte_ipv6_addr addr;
 };
 
+// sr l2 encap ///////////////////////////////////////////////////////
+
+// Encapsulate all ethernet frames received on a port with an h.encaps.l2
+// nexthop. The port is switched to GR_IFACE_MODE_SRV6_L2.
+#define GR_SRV6_L2_ENCAP_SET REQUEST_TYPE(GR_SRV6_MODULE, 0x0008)
+struct gr_srv6_l2_encap_set_req {
+	uint16_t iface_id;
+	uint32_t nh_id;
+};
+
+// Detach the nexthop from the port and switch it back to GR_IFACE_MODE_L3.
+#define GR_SRV6_L2_ENCAP_DEL REQUEST_TYPE(GR_SRV6_MODULE, 0x0009)
+struct gr_srv6_l2_encap_del_req {
+	uint16_t iface_id;
+};
+
 // localsid (tunnel transit and exit) /////////////////////////////////
 
 //
@@ -53,7 +79,11 @@ struct gr_srv6_tunsrc_show_resp {
 //
 typedef enum : uint16_t {
 	SR_BEHAVIOR_END = 0x0001,
+	SR_BEHAVIOR_END_X = 0x0005,
 	SR_BEHAVIOR_END_T = 0x0009,
+	SR_BEHAVIOR_END_DX2 = 0x000f,
+	SR_BEHAVIOR_END_DX6 = 0x0010,
+	SR_BEHAVIOR_END_DX4 = 0x0011,
 	SR_BEHAVIOR_END_DT6 = 0x0012,
 	SR_BEHAVIOR_END_DT4 = 0x0013,
 	SR_BEHAVIOR_END_DT46 = 0x0014,
@@ -63,8 +93,16 @@ static inline const char *gr_srv6_behavior_name(gr_srv6_behavior_t b) {
 	switch (b) {
 	case SR_BEHAVIOR_END:
 		return "end";
+	case SR_BEHAVIOR_END_X:
+		return "end.x";
 	case SR_BEHAVIOR_END_T:
 		return "end.t";
+	case SR_BEHAVIOR_END_DX2:
+		return "end.dx2";
+	case SR_BEHAVIOR_END_DX6:
+		return "end.dx6";
+	case SR_BEHAVIOR_END_DX4:
+		return "end.dx4";
 	case SR_BEHAVIOR_END_DT6:
 		return "end.dt6";
 	case SR_BEHAVIOR_END_DT4:
@@ -78,10 +116,22 @@ static inline const char *gr_srv6_behavior_name(gr_srv6_behavior_t b) {
 typedef enum : uint8_t {
 	GR_SR_FL_FLAVOR_PSP = GR_BIT8(0),
 	GR_SR_FL_FLAVOR_USD = GR_BIT8(1),
+	GR_SR_FL_FLAVOR_NEXT_CSID = GR_BIT8(2),
 } gr_srv6_flags_t;
 
 struct gr_nexthop_info_srv6_local {
 	uint16_t out_vrf_id;
 	gr_srv6_behavior_t behavior;
 	gr_srv6_flags_t flags;
+	// next-csid: locator block and micro-SID lengths in bits.
+	// Zero means GR_SRV6_CSID_BLOCK_BITS and GR_SRV6_CSID_BITS.
+	uint8_t csid_block_bits;
+	uint8_t csid_bits;
+	// end.x, end.dx4, end.dx6: L3 adjacency used without any FIB lookup.
+	uint32_t nh_id;
+	// end.dx2: port on which decapsulated frames are sent.
+	uint16_t out_iface_id;
+	// Per SID counters, ignored when adding.
+	uint64_t packets;
+	uint64_t bytes;
 };
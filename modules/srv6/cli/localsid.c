@@ -3,6 +3,7 @@
 
 #include <gr_api.h>
 #include <gr_cli.h>
+#include <gr_cli_iface.h>
 #include <gr_cli_nexthop.h>
 #include <gr_errno.h>
 #include <gr_net_types.h>
@@ -13,13 +14,18 @@
 #include <libsmartcols.h>
 
 #include <errno.h>
+#include <inttypes.h>
 
 static struct {
 	gr_srv6_behavior_t behavior;
 	const char *name;
 } behaviors[] = {
 	{SR_BEHAVIOR_END, "end"},
+	{SR_BEHAVIOR_END_X, "end.x"},
 	{SR_BEHAVIOR_END_T, "end.t"},
+	{SR_BEHAVIOR_END_DX2, "end.dx2"},
+	{SR_BEHAVIOR_END_DX6, "end.dx6"},
+	{SR_BEHAVIOR_END_DX4, "end.dx4"},
 	{SR_BEHAVIOR_END_DT6, "end.dt6"},
 	{SR_BEHAVIOR_END_DT4, "end.dt4"},
 	{SR_BEHAVIOR_END_DT46, "end.dt46"},
@@ -38,6 +44,7 @@ static int str_to_behavior(const char *str, gr_srv6_behavior_t *behavior) {
 static cmd_status_t srv6_localsid_add(struct gr_api_client *c, const struct ec_pnode *p) {
 	struct gr_nh_add_req *req = NULL;
 	struct gr_nexthop_info_srv6_local *sr6;
+	struct gr_iface *iface = NULL;
 	cmd_status_t ret = CMD_ERROR;
 	size_t len = sizeof(*req) + sizeof(*sr6);
 
@@ -72,8 +79,14 @@ static cmd_status_t srv6_localsid_add(struct gr_api_client *c, const struct ec_p
 				sr6->flags |= GR_SR_FL_FLAVOR_PSP;
 			if (!strcmp(str, "usd"))
 				sr6->flags |= GR_SR_FL_FLAVOR_USD;
+			if (!strcmp(str, "next-csid"))
+				sr6->flags |= GR_SR_FL_FLAVOR_NEXT_CSID;
 		}
 	}
+	if (arg_u8(p, "BLOCK_BITS", &sr6->csid_block_bits) < 0 && errno != ENOENT)
+		goto out;
+	if (arg_u8(p, "CSID_BITS", &sr6->csid_bits) < 0 && errno != ENOENT)
+		goto out;
 
 	n = ec_pnode_find(p, "BEHAVIOR");
 	if (n == NULL || ec_pnode_len(n) < 1)
@@ -83,12 +96,20 @@ static cmd_status_t srv6_localsid_add(struct gr_api_client *c, const struct ec_p
 
 	if (arg_u16(n, "TABLE", &sr6->out_vrf_id) < 0 && errno != ENOENT)
 		goto out;
+	if (arg_u32(n, "NH", &sr6->nh_id) < 0 && errno != ENOENT)
+		goto out;
+	if (arg_str(n, "IFACE") != NULL) {
+		if ((iface = iface_from_name(c, arg_str(n, "IFACE"))) == NULL)
+			goto out;
+		sr6->out_iface_id = iface->id;
+	}
 
 	if (gr_api_client_send_recv(c, GR_NH_ADD, len, req, NULL) < 0)
 		goto out;
 
 	ret = CMD_SUCCESS;
 out:
+	free(iface);
 	free(req);
 	return ret;
 }
@@ -107,15 +128,28 @@ static ssize_t format_nexthop_info_srv6_local(char *buf, size_t len, const void
 	case SR_BEHAVIOR_END:
 		SAFE_BUF(snprintf, len, " flavor=%#02x", sr6->flags);
 		break;
+	case SR_BEHAVIOR_END_X:
+		SAFE_BUF(snprintf, len, " flavor=%#02x nh=%u", sr6->flags, sr6->nh_id);
+		break;
 	case SR_BEHAVIOR_END_T:
 		SAFE_BUF(snprintf, len, " flavor=%#02x %s", sr6->flags, vrf);
 		break;
+	case SR_BEHAVIOR_END_DX6:
+	case SR_BEHAVIOR_END_DX4:
+		SAFE_BUF(snprintf, len, " nh=%u", sr6->nh_id);
+		break;
+	case SR_BEHAVIOR_END_DX2:
+		SAFE_BUF(snprintf, len, " oif=%u", sr6->out_iface_id);
+		break;
 	case SR_BEHAVIOR_END_DT6:
 	case SR_BEHAVIOR_END_DT4:
 	case SR_BEHAVIOR_END_DT46:
 		SAFE_BUF(snprintf, len, " %s", vrf);
 		break;
 	}
+	if (sr6->flags & GR_SR_FL_FLAVOR_NEXT_CSID)
+		SAFE_BUF(snprintf, len, " csid=%u/%u", sr6->csid_block_bits, sr6->csid_bits);
+	SAFE_BUF(snprintf, len, " packets=%" PRIu64 " bytes=%" PRIu64, sr6->packets, sr6->bytes);
 	return n;
 err:
 	return -1;
@@ -151,6 +185,14 @@ static int ctx_init(struct ec_node *root) {
 					"Ultimate Segment Decapsulation of the SRH",
 					ec_node_str("usd", "usd")
 				)
+			),
+			EC_NODE_CMD(
+				EC_NO_ID,
+				"next-csid",
+				with_help(
+					"Shift the next micro-SID of the destination address",
+					ec_node_str("next-csid", "next-csid")
+				)
 			)
 		)
 	);
@@ -162,6 +204,48 @@ static int ctx_init(struct ec_node *root) {
 			with_help("Transit endpoint.", ec_node_str("end", "end")),
 			with_help("Endpoint flavor(s).", ec_node_clone(flavor_node))
 		),
+		EC_NODE_CMD(
+			EC_NO_ID,
+			"end.x [flavor FLAVORS] via NH",
+			with_help(
+				"Transit endpoint with cross-connect to an IPv6 adjacency.",
+				ec_node_str("end.x", "end.x")
+			),
+			with_help(
+				"IPv6 adjacency nexthop ID.",
+				ec_node_uint("NH", 1, UINT32_MAX - 1, 10)
+			),
+			with_help("Endpoint flavor(s).", ec_node_clone(flavor_node))
+		),
+		EC_NODE_CMD(
+			EC_NO_ID,
+			"(end.dx4|end.dx6) via NH",
+			with_help(
+				"Endpoint with decapsulation and IPv4 cross-connect.",
+				ec_node_str("end.dx4", "end.dx4")
+			),
+			with_help(
+				"Endpoint with decapsulation and IPv6 cross-connect.",
+				ec_node_str("end.dx6", "end.dx6")
+			),
+			with_help(
+				"Adjacency nexthop ID.", ec_node_uint("NH", 1, UINT32_MAX - 1, 10)
+			)
+		),
+		EC_NODE_CMD(
+			EC_NO_ID,
+			"end.dx2 oif IFACE",
+			with_help(
+				"Endpoint with decapsulation and L2 cross-connect.",
+				ec_node_str("end.dx2", "end.dx2")
+			),
+			with_help(
+				"Output port.",
+				ec_node_dyn(
+					"IFACE", complete_iface_names, INT2PTR(GR_IFACE_TYPE_PORT)
+				)
+			)
+		),
 		EC_NODE_CMD(
 			EC_NO_ID,
 			"end.t [flavor FLAVORS] table TABLE",
@@ -198,12 +282,20 @@ static int ctx_init(struct ec_node *root) {
 	);
 	ret = CLI_COMMAND(
 		NEXTHOP_ADD_CTX(root),
-		"srv6-local behavior BEHAVIOR [(id ID),(vrf VRF)]",
+		"srv6-local behavior BEHAVIOR [(id ID),(vrf VRF),(csid BLOCK_BITS CSID_BITS)]",
 		srv6_localsid_add,
 		"Create a new local endpoint.",
 		with_help("Node behavior", beh_node),
 		with_help("Nexthop ID.", ec_node_uint("ID", 1, UINT32_MAX - 1, 10)),
-		with_help("L3 routing domain ID.", ec_node_uint("VRF", 0, UINT16_MAX - 1, 10))
+		with_help("L3 routing domain ID.", ec_node_uint("VRF", 0, UINT16_MAX - 1, 10)),
+		with_help(
+			"next-csid locator block length in bits (default 32).",
+			ec_node_uint("BLOCK_BITS", 8, 112, 10)
+		),
+		with_help(
+			"next-csid micro-SID length in bits (default 16).",
+			ec_node_uint("CSID_BITS", 8, 64, 10)
+		)
 	);
 	if (ret < 0)
 		return ret;
@@ -3,6 +3,7 @@
 
 #include <gr_api.h>
 #include <gr_cli.h>
+#include <gr_cli_iface.h>
 #include <gr_cli_nexthop.h>
 #include <gr_net_types.h>
 #include <gr_srv6.h>
@@ -56,9 +57,16 @@ static cmd_status_t srv6_nh_add(struct gr_api_client *c, const struct ec_pnode *
 
 	if (arg_str(p, "h.encaps.red") != NULL)
 		sr6->encap_behavior = SR_H_ENCAPS_RED;
+	else if (arg_str(p, "h.encaps.l2") != NULL)
+		sr6->encap_behavior = SR_H_ENCAPS_L2;
 	else
 		sr6->encap_behavior = SR_H_ENCAPS;
 
+	if (arg_u8(p, "BLOCK_BITS", &sr6->csid_block_bits) < 0 && errno != ENOENT)
+		goto out;
+	if (arg_u8(p, "CSID_BITS", &sr6->csid_bits) < 0 && errno != ENOENT)
+		goto out;
+
 	if (gr_api_client_send_recv(c, GR_NH_ADD, len, req, NULL) < 0)
 		goto out;
 
@@ -103,16 +111,58 @@ static cmd_status_t srv6_tunsrc_show(struct gr_api_client *c, const struct ec_pn
 	return CMD_SUCCESS;
 }
 
+static cmd_status_t srv6_l2_encap_set(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_srv6_l2_encap_set_req req;
+	struct gr_iface *iface;
+
+	if ((iface = iface_from_name(c, arg_str(p, "IFACE"))) == NULL)
+		return CMD_ERROR;
+	req.iface_id = iface->id;
+	free(iface);
+
+	if (arg_u32(p, "ID", &req.nh_id) < 0)
+		return CMD_ERROR;
+
+	if (gr_api_client_send_recv(c, GR_SRV6_L2_ENCAP_SET, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static cmd_status_t srv6_l2_encap_del(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_srv6_l2_encap_del_req req;
+	struct gr_iface *iface;
+
+	if ((iface = iface_from_name(c, arg_str(p, "IFACE"))) == NULL)
+		return CMD_ERROR;
+	req.iface_id = iface->id;
+	free(iface);
+
+	if (gr_api_client_send_recv(c, GR_SRV6_L2_ENCAP_DEL, sizeof(req), &req, NULL) < 0)
+		return CMD_ERROR;
+
+	return CMD_SUCCESS;
+}
+
+static const char *encap_behavior_name(gr_srv6_encap_behavior_t encap) {
+	switch (encap) {
+	case SR_H_ENCAPS:
+		return "h.encaps";
+	case SR_H_ENCAPS_RED:
+		return "h.encaps.red";
+	case SR_H_ENCAPS_L2:
+		return "h.encaps.l2";
+	}
+	return "?";
+}
+
 static ssize_t format_nexthop_info_srv6(char *buf, size_t len, const void *info) {
 	const struct gr_nexthop_info_srv6 *sr6 = info;
 	ssize_t n = 0;
 
-	SAFE_BUF(
-		snprintf,
-		len,
-		"%s",
-		sr6->encap_behavior == SR_H_ENCAPS_RED ? "h.encaps.red" : "h.encaps"
-	);
+	SAFE_BUF(snprintf, len, "%s", encap_behavior_name(sr6->encap_behavior));
+	if (sr6->csid_bits != 0)
+		SAFE_BUF(snprintf, len, " csid=%u/%u", sr6->csid_block_bits, sr6->csid_bits);
 	for (unsigned i = 0; i < sr6->n_seglist; i++) {
 		SAFE_BUF(snprintf, len, " " IP6_F, &sr6->seglist[i]);
 		if (len - n < 30) {
@@ -132,20 +182,31 @@ static struct cli_nexthop_formatter srv6_local_formatter = {
 };
 
 #define TUNSRC_CTX(root) CLI_CONTEXT(root, CTX_ARG("tunsrc", "SRv6 source address."))
+#define L2ENCAP_CTX(root) CLI_CONTEXT(root, CTX_ARG("l2encap", "SRv6 L2 encapsulation."))
 
 static int ctx_init(struct ec_node *root) {
 	int ret;
 
 	ret = CLI_COMMAND(
 		NEXTHOP_ADD_CTX(root),
-		"srv6 seglist SEGLIST+ [(encap h.encaps|h.encaps.red),(vrf VRF),(id ID)]",
+		"srv6 seglist SEGLIST+ "
+		"[(encap h.encaps|h.encaps.red|h.encaps.l2),(vrf VRF),(id ID),"
+		"(csid BLOCK_BITS CSID_BITS)]",
 		srv6_nh_add,
 		"Add SRv6 encap nexthop.",
 		with_help("Encaps.", ec_node_str("h.encaps", "h.encaps")),
 		with_help("Encaps Reduced.", ec_node_str("h.encaps.red", "h.encaps.red")),
+		with_help("Encaps L2 frames.", ec_node_str("h.encaps.l2", "h.encaps.l2")),
 		with_help("Next SID to visit.", ec_node_re("SEGLIST", IPV6_RE)),
 		with_help("Nexthop ID.", ec_node_uint("ID", 1, UINT32_MAX - 1, 10)),
-		with_help("L3 routing domain ID.", ec_node_uint("VRF", 0, UINT16_MAX - 1, 10))
+		with_help("L3 routing domain ID.", ec_node_uint("VRF", 0, UINT16_MAX - 1, 10)),
+		with_help(
+			"Pack segments in next-csid containers with this locator block length.",
+			ec_node_uint("BLOCK_BITS", 8, 112, 10)
+		),
+		with_help(
+			"next-csid micro-SID length in bits.", ec_node_uint("CSID_BITS", 8, 64, 10)
+		)
 	);
 	if (ret < 0)
 		return ret;
@@ -174,6 +235,31 @@ static int ctx_init(struct ec_node *root) {
 		srv6_tunsrc_show,
 		"Show Segment Routing SRv6 source address"
 	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		L2ENCAP_CTX(root),
+		"set IFACE via ID",
+		srv6_l2_encap_set,
+		"Encapsulate all frames received on a port with an h.encaps.l2 nexthop.",
+		with_help(
+			"Port name.",
+			ec_node_dyn("IFACE", complete_iface_names, INT2PTR(GR_IFACE_TYPE_PORT))
+		),
+		with_help("Nexthop ID.", ec_node_uint("ID", 1, UINT32_MAX - 1, 10))
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		L2ENCAP_CTX(root),
+		"del IFACE",
+		srv6_l2_encap_del,
+		"Stop L2 encapsulation on a port and put it back in L3 mode.",
+		with_help(
+			"Port name.",
+			ec_node_dyn("IFACE", complete_iface_names, INT2PTR(GR_IFACE_TYPE_PORT))
+		)
+	);
 	if (ret < 0)
 		return ret;
 
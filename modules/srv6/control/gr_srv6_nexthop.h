@@ -3,14 +3,28 @@
 
 #pragma once
 
+#include <gr_iface.h>
 #include <gr_ip6_control.h>
 #include <gr_nh_control.h>
 #include <gr_srv6.h>
 
+#include <stdatomic.h>
+
+struct __rte_cache_aligned srv6_localsid_stats {
+	uint64_t packets;
+	uint64_t bytes;
+};
+
 //
 // srv6 local data stored in nexthop priv
 //
-GR_NH_TYPE_INFO(GR_NH_T_SR6_LOCAL, nexthop_info_srv6_local, { BASE(gr_nexthop_info_srv6_local); });
+GR_NH_TYPE_INFO(GR_NH_T_SR6_LOCAL, nexthop_info_srv6_local, {
+	BASE(gr_nexthop_info_srv6_local);
+	// Resolved nh_id for end.x, end.dx4 and end.dx6 (holds a reference).
+	struct nexthop *adj;
+	// Per lcore counters, indexed by rte_lcore_id().
+	struct srv6_localsid_stats *stats;
+});
 
 //
 // srv6 encap data is allocated dynamically.
@@ -18,10 +32,26 @@ GR_NH_TYPE_INFO(GR_NH_T_SR6_LOCAL, nexthop_info_srv6_local, { BASE(gr_nexthop_in
 //
 GR_NH_TYPE_INFO(GR_NH_T_SR6_OUTPUT, nexthop_info_srv6_output, {
 	gr_srv6_encap_behavior_t encap;
+	uint8_t csid_block_bits;
+	uint8_t csid_bits;
 	uint16_t n_seglist;
 	struct rte_ipv6_addr *seglist;
 });
 
+// NEXT-CSID lengths are processed with byte granularity in the datapath.
+// Containers must have room for at least two micro-SIDs.
+static inline bool srv6_csid_format_valid(uint8_t block_bits, uint8_t csid_bits) {
+	return block_bits != 0 && csid_bits != 0 && block_bits % 8 == 0 && csid_bits % 8 == 0
+		&& block_bits + 2 * csid_bits <= RTE_IPV6_MAX_DEPTH;
+}
+
+// h.encaps.l2 nexthops indexed by the ID of the port in GR_IFACE_MODE_SRV6_L2.
+extern _Atomic(struct nexthop *) srv6_l2_encaps[MAX_IFACES];
+
+static inline const struct nexthop *srv6_l2_encap_get(uint16_t iface_id) {
+	return atomic_load_explicit(&srv6_l2_encaps[iface_id], memory_order_acquire);
+}
+
 extern struct nexthop *tunsrc_nh;
 static inline const struct nexthop *
 sr_tunsrc_get(uint16_t iface_id, const struct rte_ipv6_addr *dst) {
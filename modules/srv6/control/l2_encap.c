@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_event.h>
+#include <gr_iface.h>
+#include <gr_infra.h>
+#include <gr_module.h>
+#include <gr_srv6.h>
+#include <gr_srv6_nexthop.h>
+
+_Atomic(struct nexthop *) srv6_l2_encaps[MAX_IFACES];
+
+static void l2_encap_replace(uint16_t iface_id, struct nexthop *nh) {
+	struct nexthop *old = atomic_exchange(&srv6_l2_encaps[iface_id], nh);
+
+	// nexthop_decref() waits for the datapath to be done with it before freeing.
+	if (old != NULL)
+		nexthop_decref(old);
+}
+
+static struct api_out l2_encap_set(const void *request, struct api_ctx *) {
+	const struct gr_srv6_l2_encap_set_req *req = request;
+	struct gr_iface conf = {.mode = GR_IFACE_MODE_SRV6_L2};
+	const struct nexthop_info_srv6_output *sr6;
+	struct iface *iface;
+	struct nexthop *nh;
+	int ret;
+
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+	if (iface->type != GR_IFACE_TYPE_PORT)
+		return api_out(EMEDIUMTYPE, 0, NULL);
+	if ((nh = nexthop_lookup_by_id(req->nh_id)) == NULL)
+		return api_out(errno, 0, NULL);
+	if (nh->type != GR_NH_T_SR6_OUTPUT)
+		return api_out(EPROTOTYPE, 0, NULL);
+	sr6 = nexthop_info_srv6_output(nh);
+	if (sr6->encap != SR_H_ENCAPS_L2)
+		return api_out(EPROTOTYPE, 0, NULL);
+
+	nexthop_incref(nh);
+	l2_encap_replace(iface->id, nh);
+
+	if (iface->mode != GR_IFACE_MODE_SRV6_L2) {
+		ret = iface_reconfig(iface->id, GR_IFACE_SET_MODE, &conf, NULL);
+		if (ret < 0) {
+			l2_encap_replace(iface->id, NULL);
+			return api_out(-ret, 0, NULL);
+		}
+	}
+
+	return api_out(0, 0, NULL);
+}
+
+static struct api_out l2_encap_del(const void *request, struct api_ctx *) {
+	const struct gr_srv6_l2_encap_del_req *req = request;
+	struct gr_iface conf = {.mode = GR_IFACE_MODE_L3};
+	struct iface *iface;
+	int ret;
+
+	if ((iface = iface_from_id(req->iface_id)) == NULL)
+		return api_out(errno, 0, NULL);
+	if (iface->mode != GR_IFACE_MODE_SRV6_L2)
+		return api_out(ENOENT, 0, NULL);
+
+	ret = iface_reconfig(iface->id, GR_IFACE_SET_MODE, &conf, NULL);
+	if (ret < 0)
+		return api_out(-ret, 0, NULL);
+
+	l2_encap_replace(iface->id, NULL);
+
+	return api_out(0, 0, NULL);
+}
+
+static void iface_event(uint32_t event, const void *obj) {
+	const struct iface *iface = obj;
+
+	switch (event) {
+	case GR_EVENT_IFACE_PRE_REMOVE:
+		l2_encap_replace(iface->id, NULL);
+		break;
+	case GR_EVENT_IFACE_POST_RECONFIG:
+		// The port mode was changed with a regular interface update.
+		if (iface->mode != GR_IFACE_MODE_SRV6_L2)
+			l2_encap_replace(iface->id, NULL);
+		break;
+	}
+}
+
+static void nh_event(uint32_t /*event*/, const void *obj) {
+	const struct nexthop *nh = obj;
+
+	if (nh->type != GR_NH_T_SR6_OUTPUT)
+		return;
+
+	// The nexthop was forcibly deleted and our reference consumed.
+	// Forget about it and drop the frames until another one is set.
+	for (uint16_t iface_id = 0; iface_id < MAX_IFACES; iface_id++) {
+		if (srv6_l2_encap_get(iface_id) == nh)
+			atomic_store(&srv6_l2_encaps[iface_id], NULL);
+	}
+}
+
+static struct gr_api_handler l2_encap_set_handler = {
+	.name = "sr l2 encap set",
+	.request_type = GR_SRV6_L2_ENCAP_SET,
+	.callback = l2_encap_set,
+};
+static struct gr_api_handler l2_encap_del_handler = {
+	.name = "sr l2 encap del",
+	.request_type = GR_SRV6_L2_ENCAP_DEL,
+	.callback = l2_encap_del,
+};
+
+static struct gr_event_subscription iface_event_sub = {
+	.callback = iface_event,
+	.ev_count = 2,
+	.ev_types = {
+		GR_EVENT_IFACE_PRE_REMOVE,
+		GR_EVENT_IFACE_POST_RECONFIG,
+	},
+};
+static struct gr_event_subscription nh_event_sub = {
+	.callback = nh_event,
+	.ev_count = 1,
+	.ev_types = {GR_EVENT_NEXTHOP_DELETE},
+};
+
+RTE_INIT(srv6_l2_encap_constructor) {
+	gr_register_api_handler(&l2_encap_set_handler);
+	gr_register_api_handler(&l2_encap_del_handler);
+	gr_event_subscribe(&iface_event_sub);
+	gr_event_subscribe(&nh_event_sub);
+}
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 // Copyright (c) 2025 Olivier Gournet
 
+#include <gr_event.h>
 #include <gr_infra.h>
 #include <gr_ip4_control.h>
 #include <gr_ip6_control.h>
@@ -8,6 +9,21 @@
 #include <gr_module.h>
 #include <gr_srv6.h>
 #include <gr_srv6_nexthop.h>
+#include <gr_vec.h>
+
+#include <rte_malloc.h>
+
+// SRv6 local nexthops that hold a reference on an L3 adjacency.
+static gr_vec struct nexthop **adj_users;
+
+static void adj_users_del(const struct nexthop *nh) {
+	for (uint32_t i = 0; i < gr_vec_len(adj_users); i++) {
+		if (adj_users[i] == nh) {
+			gr_vec_del_swap(adj_users, i);
+			return;
+		}
+	}
+}
 
 static bool srv6_local_nh_equal(const struct nexthop *a, const struct nexthop *b) {
 	struct nexthop_info_srv6_local *ad, *bd;
@@ -19,14 +35,92 @@ static bool srv6_local_nh_equal(const struct nexthop *a, const struct nexthop *b
 	bd = nexthop_info_srv6_local(b);
 
 	return ad->behavior == bd->behavior && ad->out_vrf_id == bd->out_vrf_id
-		&& ad->flags == bd->flags;
+		&& ad->flags == bd->flags && ad->nh_id == bd->nh_id
+		&& ad->out_iface_id == bd->out_iface_id
+		&& ad->csid_block_bits == bd->csid_block_bits && ad->csid_bits == bd->csid_bits;
+}
+
+// Resolve the L3 adjacency of end.x, end.dx4 and end.dx6 behaviors.
+static struct nexthop *
+srv6_local_adj_get(const struct nexthop *nh, uint32_t nh_id, addr_family_t af) {
+	struct nexthop *adj;
+
+	if ((adj = nexthop_lookup_by_id(nh_id)) == NULL)
+		return NULL;
+	if (adj == nh || adj->type != GR_NH_T_L3)
+		return errno_set_null(EMEDIUMTYPE);
+	if (nexthop_info_l3(adj)->af != af)
+		return errno_set_null(EAFNOSUPPORT);
+
+	return adj;
 }
 
 static int srv6_local_nh_import_info(struct nexthop *nh, const void *info) {
 	struct nexthop_info_srv6_local *priv = nexthop_info_srv6_local(nh);
 	const struct gr_nexthop_info_srv6_local *pub = info;
+	struct nexthop *adj = NULL, *old_adj;
+	uint8_t csid_block_bits = 0;
+	const struct iface *iface;
+	uint8_t csid_bits = 0;
+
+	if (pub->flags & GR_SR_FL_FLAVOR_NEXT_CSID) {
+		switch (pub->behavior) {
+		case SR_BEHAVIOR_END:
+		case SR_BEHAVIOR_END_X:
+		case SR_BEHAVIOR_END_T:
+			break;
+		default:
+			return errno_set(EINVAL);
+		}
+		csid_block_bits = pub->csid_block_bits ?: GR_SRV6_CSID_BLOCK_BITS;
+		csid_bits = pub->csid_bits ?: GR_SRV6_CSID_BITS;
+		if (!srv6_csid_format_valid(csid_block_bits, csid_bits))
+			return errno_set(EINVAL);
+	}
+
+	switch (pub->behavior) {
+	case SR_BEHAVIOR_END_X:
+	case SR_BEHAVIOR_END_DX6:
+		if ((adj = srv6_local_adj_get(nh, pub->nh_id, GR_AF_IP6)) == NULL)
+			return -errno;
+		break;
+	case SR_BEHAVIOR_END_DX4:
+		if ((adj = srv6_local_adj_get(nh, pub->nh_id, GR_AF_IP4)) == NULL)
+			return -errno;
+		break;
+	case SR_BEHAVIOR_END_DX2:
+		if ((iface = iface_from_id(pub->out_iface_id)) == NULL)
+			return -errno;
+		if (iface->type != GR_IFACE_TYPE_PORT)
+			return errno_set(EMEDIUMTYPE);
+		break;
+	default:
+		break;
+	}
 
+	if (priv->stats == NULL) {
+		priv->stats = rte_calloc(
+			__func__, RTE_MAX_LCORE, sizeof(*priv->stats), RTE_CACHE_LINE_SIZE
+		);
+		if (priv->stats == NULL)
+			return errno_set(ENOMEM);
+	}
+
+	if (adj != NULL)
+		nexthop_incref(adj);
+
+	old_adj = priv->adj;
 	priv->base = *pub;
+	priv->csid_block_bits = csid_block_bits;
+	priv->csid_bits = csid_bits;
+	priv->adj = adj;
+
+	if (adj != NULL && old_adj == NULL)
+		gr_vec_add(adj_users, nh);
+	else if (adj == NULL && old_adj != NULL)
+		adj_users_del(nh);
+	if (old_adj != NULL)
+		nexthop_decref(old_adj);
 
 	return 0;
 }
@@ -43,18 +137,76 @@ static struct gr_nexthop *srv6_local_nh_to_api(const struct nexthop *nh, size_t
 	pub->base = nh->base;
 	sr6_pub = (struct gr_nexthop_info_srv6_local *)pub->info;
 	*sr6_pub = sr6_priv->base;
+	sr6_pub->packets = 0;
+	sr6_pub->bytes = 0;
+	for (unsigned i = 0; sr6_priv->stats != NULL && i < RTE_MAX_LCORE; i++) {
+		sr6_pub->packets += sr6_priv->stats[i].packets;
+		sr6_pub->bytes += sr6_priv->stats[i].bytes;
+	}
 
 	*len = sizeof(*pub) + sizeof(*sr6_pub);
 
 	return pub;
 }
 
+static void srv6_local_nh_free(struct nexthop *nh) {
+	struct nexthop_info_srv6_local *sr6 = nexthop_info_srv6_local(nh);
+
+	if (sr6->adj != NULL) {
+		adj_users_del(nh);
+		nexthop_decref(sr6->adj);
+		sr6->adj = NULL;
+	}
+	rte_free(sr6->stats);
+	sr6->stats = NULL;
+}
+
+static void nh_event(uint32_t /*event*/, const void *obj) {
+	const struct nexthop *nh = obj;
+	struct nexthop *user;
+
+	if (nh->type != GR_NH_T_L3)
+		return;
+
+	// An adjacency can be forcibly deleted while we still reference it.
+	// Forget about it since our reference has been consumed. The datapath
+	// will drop packets for this SID until the nexthop is updated.
+	for (uint32_t i = 0; i < gr_vec_len(adj_users);) {
+		user = adj_users[i];
+		if (user->type == GR_NH_T_SR6_LOCAL && nexthop_info_srv6_local(user)->adj == nh) {
+			nexthop_info_srv6_local(user)->adj = NULL;
+			gr_vec_del_swap(adj_users, i);
+		} else {
+			i++;
+		}
+	}
+}
+
 static struct nexthop_type_ops nh_ops = {
+	.free = srv6_local_nh_free,
 	.equal = srv6_local_nh_equal,
 	.import_info = srv6_local_nh_import_info,
 	.to_api = srv6_local_nh_to_api,
 };
 
+static struct gr_event_subscription nh_event_sub = {
+	.callback = nh_event,
+	.ev_count = 1,
+	.ev_types = {GR_EVENT_NEXTHOP_DELETE},
+};
+
+static void srv6_local_fini(struct event_base *) {
+	gr_vec_free(adj_users);
+}
+
+static struct gr_module module = {
+	.name = "srv6_local",
+	.depends_on = "nexthop",
+	.fini = srv6_local_fini,
+};
+
 RTE_INIT(srv6_constructor) {
+	gr_register_module(&module);
 	nexthop_type_ops_register(GR_NH_T_SR6_LOCAL, &nh_ops);
+	gr_event_subscribe(&nh_event_sub);
 }
@@ -9,6 +9,8 @@
 
 #include <rte_malloc.h>
 
+#include <limits.h>
+
 // routes ////////////////////////////////////////////////////////////////
 static bool srv6_output_nh_equal(const struct nexthop *a, const struct nexthop *b) {
 	struct nexthop_info_srv6_output *ad = nexthop_info_srv6_output(a);
@@ -17,6 +19,9 @@ static bool srv6_output_nh_equal(const struct nexthop *a, const struct nexthop *
 	if (ad->encap != bd->encap)
 		return false;
 
+	if (ad->csid_block_bits != bd->csid_block_bits || ad->csid_bits != bd->csid_bits)
+		return false;
+
 	if (ad->n_seglist != bd->n_seglist)
 		return false;
 
@@ -28,19 +33,84 @@ static bool srv6_output_nh_equal(const struct nexthop *a, const struct nexthop *
 	return true;
 }
 
+// A SID can be carried as a micro-SID if it only has a locator block and
+// a non-zero micro-SID. Anything after that would be lost.
+static bool csid_compressible(const struct rte_ipv6_addr *sid, unsigned block, unsigned csid) {
+	bool has_csid = false;
+
+	for (unsigned i = block; i < block + csid; i++)
+		has_csid |= sid->a[i] != 0;
+	for (unsigned i = block + csid; i < sizeof(sid->a); i++) {
+		if (sid->a[i] != 0)
+			return false;
+	}
+
+	return has_csid;
+}
+
+// Pack consecutive SIDs sharing the same locator block into NEXT-CSID
+// containers (rfc9800). The first SID of a container is the active one.
+// Other SIDs are copied as-is. Returns the number of written segments.
+static uint16_t csid_compress(
+	const struct rte_ipv6_addr *sids,
+	uint16_t n_sids,
+	uint8_t block_bits,
+	uint8_t csid_bits,
+	struct rte_ipv6_addr *out
+) {
+	unsigned block = block_bits / CHAR_BIT;
+	unsigned csid = csid_bits / CHAR_BIT;
+	unsigned pos = 0; // next free micro-SID slot in the current container
+	uint16_t n = 0;
+
+	for (uint16_t i = 0; i < n_sids; i++) {
+		const struct rte_ipv6_addr *sid = &sids[i];
+
+		if (!csid_compressible(sid, block, csid)) {
+			out[n++] = *sid;
+			pos = 0;
+		} else if (pos != 0 && pos + csid <= sizeof(sid->a)
+			   && memcmp(out[n - 1].a, sid->a, block) == 0) {
+			memcpy(&out[n - 1].a[pos], &sid->a[block], csid);
+			pos += csid;
+		} else {
+			out[n++] = *sid;
+			pos = block + csid;
+		}
+	}
+
+	return n;
+}
+
 static int srv6_output_nh_import_info(struct nexthop *nh, const void *info) {
 	struct nexthop_info_srv6_output *priv = nexthop_info_srv6_output(nh);
 	const struct gr_nexthop_info_srv6 *pub = info;
 	struct rte_ipv6_addr *seglist, *tmp;
+	uint16_t n_seglist;
+
+	if (pub->n_seglist == 0)
+		return errno_set(EINVAL);
+	if ((pub->csid_block_bits != 0 || pub->csid_bits != 0)
+	    && !srv6_csid_format_valid(pub->csid_block_bits, pub->csid_bits))
+		return errno_set(EINVAL);
 
 	seglist = rte_calloc(__func__, pub->n_seglist, sizeof(*seglist), RTE_CACHE_LINE_SIZE);
 	if (seglist == NULL)
 		return errno_set(ENOMEM);
 
-	memcpy(seglist, pub->seglist, sizeof(*seglist) * pub->n_seglist);
+	if (pub->csid_bits != 0) {
+		n_seglist = csid_compress(
+			pub->seglist, pub->n_seglist, pub->csid_block_bits, pub->csid_bits, seglist
+		);
+	} else {
+		memcpy(seglist, pub->seglist, sizeof(*seglist) * pub->n_seglist);
+		n_seglist = pub->n_seglist;
+	}
 
 	priv->encap = pub->encap_behavior;
-	priv->n_seglist = pub->n_seglist;
+	priv->csid_block_bits = pub->csid_block_bits;
+	priv->csid_bits = pub->csid_bits;
+	priv->n_seglist = n_seglist;
 	tmp = priv->seglist;
 	priv->seglist = seglist;
 	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
@@ -63,6 +133,8 @@ static struct gr_nexthop *srv6_output_nh_to_api(const struct nexthop *nh, size_t
 	sr6_pub = (struct gr_nexthop_info_srv6 *)pub->info;
 
 	sr6_pub->encap_behavior = sr6_priv->encap;
+	sr6_pub->csid_block_bits = sr6_priv->csid_block_bits;
+	sr6_pub->csid_bits = sr6_priv->csid_bits;
 	sr6_pub->n_seglist = sr6_priv->n_seglist;
 	memcpy(sr6_pub->seglist,
 	       sr6_priv->seglist,
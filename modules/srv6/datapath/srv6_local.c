@@ -3,12 +3,15 @@
 
 #include <gr_eth.h>
 #include <gr_graph.h>
+#include <gr_ip4_datapath.h>
 #include <gr_ip6_datapath.h>
 #include <gr_log.h>
 #include <gr_mbuf.h>
 #include <gr_srv6_nexthop.h>
 #include <gr_trace.h>
 
+#include <limits.h>
+
 //
 // references are to rfc8986
 //
@@ -17,11 +20,16 @@ enum {
 	IP_INPUT = 0,
 	IP6_INPUT,
 	IP6_LOCAL,
+	IP_FORWARD,
+	IP6_FORWARD,
+	PORT_OUTPUT,
 	INVALID_PACKET,
 	UNEXPECTED_UPPER,
 	NOT_ALLOWED_UPPER,
 	NO_TRANSIT,
 	DEST_UNREACH,
+	NO_ADJ,
+	NO_PORT,
 	EDGE_COUNT,
 };
 
@@ -274,6 +282,101 @@ static int process_behav_decap(
 	return edge;
 }
 
+//
+// Decapsulation behaviors with cross-connect to a precomputed adjacency
+//
+static int process_behav_decap_x(
+	struct rte_mbuf *m,
+	struct nexthop_info_srv6_local *sr_d,
+	struct ip6_info *ip6_info
+) {
+	struct rte_ipv6_routing_ext *sr = ip6_info->sr;
+	struct iface_stats *tx_stats;
+	const struct iface *iface;
+	rte_edge_t edge;
+
+	// transit is not allowed
+	if (sr != NULL && sr->segments_left > 0)
+		return NO_TRANSIT;
+
+	switch (ip6_info->proto) {
+	case IPPROTO_IPV6:
+		if (sr_d->behavior != SR_BEHAVIOR_END_DX6)
+			return UNEXPECTED_UPPER;
+		edge = IP6_FORWARD;
+		break;
+
+	case IPPROTO_IPIP:
+		if (sr_d->behavior != SR_BEHAVIOR_END_DX4)
+			return UNEXPECTED_UPPER;
+		edge = IP_FORWARD;
+		break;
+
+	case IPPROTO_ETHERNET:
+		if (sr_d->behavior != SR_BEHAVIOR_END_DX2)
+			return UNEXPECTED_UPPER;
+		edge = PORT_OUTPUT;
+		break;
+
+	default:
+		return process_upper_layer(m, ip6_info);
+	}
+
+	// remove tunnel ipv6 + ext headers
+	if (ip6_info->ext_offset && decap_outer(m, ip6_info) < 0)
+		return INVALID_PACKET;
+
+	switch (edge) {
+	case IP6_FORWARD:
+		if (sr_d->adj == NULL)
+			return NO_ADJ;
+		ip6_output_mbuf_data(m)->nh = sr_d->adj;
+		break;
+	case IP_FORWARD:
+		if (sr_d->adj == NULL)
+			return NO_ADJ;
+		ip_output_mbuf_data(m)->nh = sr_d->adj;
+		break;
+	case PORT_OUTPUT:
+		iface = iface_from_id(sr_d->out_iface_id);
+		if (iface == NULL || iface->type != GR_IFACE_TYPE_PORT)
+			return NO_PORT;
+		mbuf_data(m)->iface = iface;
+		tx_stats = iface_get_stats(rte_lcore_id(), iface->id);
+		tx_stats->tx_packets++;
+		tx_stats->tx_bytes += rte_pktmbuf_pkt_len(m);
+		break;
+	}
+
+	return edge;
+}
+
+//
+// rfc9800 4.1: NEXT-CSID flavor
+//
+// If the argument of the active container is not zero, shift it by one
+// micro-SID in place. The destination address then holds the next micro-SID
+// and the SRH is left untouched.
+//
+static inline bool
+csid_next(struct rte_ipv6_addr *dst, uint8_t block_bits, uint8_t csid_bits) {
+	unsigned block = block_bits / CHAR_BIT;
+	unsigned arg = block + csid_bits / CHAR_BIT;
+	unsigned i;
+
+	for (i = arg; i < sizeof(dst->a); i++) {
+		if (dst->a[i] != 0)
+			break;
+	}
+	if (i == sizeof(dst->a))
+		return false;
+
+	memmove(&dst->a[block], &dst->a[arg], sizeof(dst->a) - arg);
+	memset(&dst->a[sizeof(dst->a) - (arg - block)], 0, arg - block);
+
+	return true;
+}
+
 //
 // End behavior
 //
@@ -285,6 +388,10 @@ static int process_behav_end(
 	struct rte_ipv6_routing_ext *sr = ip6_info->sr;
 	const struct iface *iface;
 
+	if ((sr_d->flags & GR_SR_FL_FLAVOR_NEXT_CSID)
+	    && csid_next(&ip6_info->ip6_hdr->dst_addr, sr_d->csid_block_bits, sr_d->csid_bits))
+		goto forward;
+
 	// at the end of the tunnel
 	if (sr == NULL || sr->segments_left == 0) {
 		// 4.16.3 USD
@@ -307,6 +414,15 @@ static int process_behav_end(
 		ip6->dst_addr = ((struct rte_ipv6_addr *)(sr + 1))[sr->segments_left];
 	}
 
+forward:
+	// End.X: cross-connect to the adjacency, no FIB lookup
+	if (sr_d->behavior == SR_BEHAVIOR_END_X) {
+		if (sr_d->adj == NULL)
+			return NO_ADJ;
+		ip6_output_mbuf_data(m)->nh = sr_d->adj;
+		return IP6_FORWARD;
+	}
+
 	// change input interface to the vrf we wish to go
 	if (sr_d->out_vrf_id < GR_MAX_VRFS) {
 		iface = get_vrf_iface(sr_d->out_vrf_id);
@@ -326,9 +442,15 @@ static inline rte_edge_t srv6_local_process_pkt(
 ) {
 	switch (sr_d->behavior) {
 	case SR_BEHAVIOR_END:
+	case SR_BEHAVIOR_END_X:
 	case SR_BEHAVIOR_END_T:
 		return process_behav_end(m, sr_d, ip6_info);
 
+	case SR_BEHAVIOR_END_DX2:
+	case SR_BEHAVIOR_END_DX4:
+	case SR_BEHAVIOR_END_DX6:
+		return process_behav_decap_x(m, sr_d, ip6_info);
+
 	case SR_BEHAVIOR_END_DT4:
 	case SR_BEHAVIOR_END_DT6:
 	case SR_BEHAVIOR_END_DT46:
@@ -343,6 +465,7 @@ static inline rte_edge_t srv6_local_process_pkt(
 static uint16_t
 srv6_local_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
 	struct nexthop_info_srv6_local *sr_d;
+	struct srv6_localsid_stats *stats;
 	struct trace_srv6_data *t;
 	struct ip6_info ip6_info;
 	struct rte_mbuf *m;
@@ -358,6 +481,9 @@ srv6_local_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 		}
 
 		sr_d = nexthop_info_srv6_local(ip6_output_mbuf_data(m)->nh);
+		stats = &sr_d->stats[rte_lcore_id()];
+		stats->packets++;
+		stats->bytes += rte_pktmbuf_pkt_len(m);
 
 		if (gr_mbuf_is_traced(m)) {
 			t = gr_mbuf_trace_add(m, node, sizeof(*t));
@@ -390,11 +516,16 @@ static struct rte_node_register srv6_local_node = {
 		[IP_INPUT] = "ip_input",
 		[IP6_INPUT] = "ip6_input",
 		[IP6_LOCAL] = "ip6_input_local",
+		[IP_FORWARD] = "ip_forward",
+		[IP6_FORWARD] = "ip6_forward",
+		[PORT_OUTPUT] = "port_output",
 		[INVALID_PACKET] = "sr6_local_invalid",
 		[UNEXPECTED_UPPER] = "sr6_local_unexpected_upper",
 		[NOT_ALLOWED_UPPER] = "sr6_local_not_allowed_upper",
 		[NO_TRANSIT] = "sr6_local_no_transit",
 		[DEST_UNREACH] = "ip6_error_dest_unreach",
+		[NO_ADJ] = "sr6_local_no_adj",
+		[NO_PORT] = "sr6_local_no_port",
 	},
 };
 
@@ -410,6 +541,8 @@ GR_DROP_REGISTER(sr6_local_invalid);
 GR_DROP_REGISTER(sr6_local_unexpected_upper);
 GR_DROP_REGISTER(sr6_local_not_allowed_upper);
 GR_DROP_REGISTER(sr6_local_no_transit);
+GR_DROP_REGISTER(sr6_local_no_adj);
+GR_DROP_REGISTER(sr6_local_no_port);
 
 #ifdef __GROUT_UNIT_TEST__
 #include <gr_cmocka.h>
@@ -422,6 +555,8 @@ mock_func(uint16_t, drop_packets(struct rte_graph *, struct rte_node *, void **,
 mock_func(int, drop_format(char *, size_t, const void *, size_t));
 mock_func(void, ip6_input_register_nexthop_type(gr_nh_type_t, const char *));
 mock_func(struct iface *, get_vrf_iface(uint16_t));
+mock_func(struct iface *, iface_from_id(uint16_t));
+struct iface_stats (*iface_stats)[RTE_MAX_LCORE];
 
 struct ipv6_ext_base {
 	uint8_t next_hdr;
@@ -651,6 +786,39 @@ static void srv6_parse_ipv6_hop_srv6_dop(void **) {
 	assert_ip6_info_equal(&info, &expect);
 }
 
+static void srv6_csid_next_f3216(void **) {
+	struct rte_ipv6_addr dst = RTE_IPV6(0xfcbb, 0xbb00, 0x0100, 0x0200, 0x0300, 0, 0, 0);
+	struct rte_ipv6_addr exp;
+
+	assert_true(csid_next(&dst, 32, 16));
+	exp = (struct rte_ipv6_addr)RTE_IPV6(0xfcbb, 0xbb00, 0x0200, 0x0300, 0, 0, 0, 0);
+	assert_ipv6_equal(&dst, &exp);
+
+	assert_true(csid_next(&dst, 32, 16));
+	exp = (struct rte_ipv6_addr)RTE_IPV6(0xfcbb, 0xbb00, 0x0300, 0, 0, 0, 0, 0);
+	assert_ipv6_equal(&dst, &exp);
+
+	// last micro-SID of the container, nothing to shift
+	assert_false(csid_next(&dst, 32, 16));
+	assert_ipv6_equal(&dst, &exp);
+}
+
+static void srv6_csid_next_full_container(void **) {
+	struct rte_ipv6_addr dst = RTE_IPV6(0xfc00, 1, 2, 3, 4, 5, 6, 7);
+	struct rte_ipv6_addr exp = RTE_IPV6(0xfc00, 2, 3, 4, 5, 6, 7, 0);
+
+	assert_true(csid_next(&dst, 16, 16));
+	assert_ipv6_equal(&dst, &exp);
+}
+
+static void srv6_csid_next_48_8(void **) {
+	struct rte_ipv6_addr dst = RTE_IPV6(0xfc00, 0, 0xa, 0x0b0c, 0, 0, 0, 0x0d00);
+	struct rte_ipv6_addr exp = RTE_IPV6(0xfc00, 0, 0xa, 0x0c00, 0, 0, 0xd, 0);
+
+	assert_true(csid_next(&dst, 48, 8));
+	assert_ipv6_equal(&dst, &exp);
+}
+
 // ---- runner -----------------------------------------------------------------
 int main(void) {
 	const struct CMUnitTest tests[] = {
@@ -659,6 +827,9 @@ int main(void) {
 		cmocka_unit_test(srv6_parse_ipv6_hop_srv6),
 		cmocka_unit_test(srv6_parse_ipv6_srv6_dop),
 		cmocka_unit_test(srv6_parse_ipv6_hop_srv6_dop),
+		cmocka_unit_test(srv6_csid_next_f3216),
+		cmocka_unit_test(srv6_csid_next_full_container),
+		cmocka_unit_test(srv6_csid_next_48_8),
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
 }
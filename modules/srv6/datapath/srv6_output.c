@@ -5,6 +5,7 @@
 #include <gr_graph.h>
 #include <gr_ip4_datapath.h>
 #include <gr_ip6_datapath.h>
+#include <gr_rxtx.h>
 #include <gr_srv6.h>
 #include <gr_srv6_nexthop.h>
 #include <gr_trace.h>
@@ -38,19 +39,81 @@ static int trace_srv6_format(char *buf, size_t len, const void *data, size_t /*d
 		return snprintf(buf, len, "match=" IP4_F "/%hhu", &t->dest4.ip, t->dest4.prefixlen);
 }
 
+// Prepend the outer IPv6 header (and SRH if needed) and resolve the nexthop of
+// the first segment in the VRF of the srv6 nexthop.
+static inline rte_edge_t srv6_encap(
+	struct rte_mbuf *m,
+	const struct nexthop_info_srv6_output *d,
+	uint16_t vrf_id,
+	uint8_t proto,
+	uint32_t plen
+) {
+	struct rte_ipv6_routing_ext *srh;
+	const struct nexthop_info_l3 *l3;
+	struct rte_ipv6_hdr *outer_ip6;
+	const struct nexthop *nh;
+	uint32_t hdrlen;
+	uint8_t reduc;
+
+	// Encapsulate with another IPv6 header
+	hdrlen = sizeof(*outer_ip6);
+	reduc = d->encap == SR_H_ENCAPS_RED ? 1 : 0;
+	if (d->n_seglist > reduc)
+		hdrlen += sizeof(*srh) + (d->n_seglist * sizeof(d->seglist[0]));
+
+	outer_ip6 = (struct rte_ipv6_hdr *)rte_pktmbuf_prepend(m, hdrlen);
+	if (unlikely(outer_ip6 == NULL))
+		return NO_HEADROOM;
+
+	if (d->n_seglist > reduc) {
+		struct rte_ipv6_addr *segments;
+		uint16_t k;
+
+		srh = (struct rte_ipv6_routing_ext *)(outer_ip6 + 1);
+		srh->next_hdr = proto;
+		srh->hdr_len = (hdrlen - sizeof(*outer_ip6)) / 8 - 1;
+		srh->type = RTE_IPV6_SRCRT_TYPE_4;
+		srh->segments_left = d->n_seglist - 1;
+		srh->last_entry = d->n_seglist - 1;
+		srh->flags = 0;
+		srh->tag = 0;
+
+		segments = (struct rte_ipv6_addr *)(srh + 1);
+		for (k = reduc; k < d->n_seglist; k++)
+			segments[d->n_seglist - k - 1] = d->seglist[k];
+		proto = IPPROTO_ROUTING;
+		plen += hdrlen - sizeof(*outer_ip6);
+	}
+
+	// Resolve nexthop for the encapsulated packet.
+	nh = fib6_lookup(vrf_id, GR_IFACE_ID_UNDEF, d->seglist);
+	if (nh == NULL)
+		return NO_ROUTE;
+	ip6_output_mbuf_data(m)->nh = nh;
+
+	nh = sr_tunsrc_get(nh->iface_id, &d->seglist[0]);
+	if (nh == NULL) {
+		// cannot output packet on interface that does not have ip6 addr
+		return NO_ROUTE;
+	}
+	l3 = nexthop_info_l3(nh);
+
+	ip6_set_fields(outer_ip6, plen, proto, &l3->ipv6, &d->seglist[0]);
+
+	return IP6_OUTPUT;
+}
+
 // called from 'ip6_output' or 'ip_output' node
 static uint16_t
 srv6_output_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
 	const struct nexthop_info_srv6_output *d;
 	const struct nexthop_info_l3 *l3;
 	struct trace_srv6_data *t = NULL;
-	struct rte_ipv6_routing_ext *srh;
-	struct rte_ipv6_hdr *outer_ip6;
 	const struct nexthop *nh;
-	uint32_t hdrlen, plen;
 	struct rte_mbuf *m;
-	uint8_t proto, reduc;
 	rte_edge_t edge;
+	uint32_t plen;
+	uint8_t proto;
 
 	for (uint16_t i = 0; i < nb_objs; i++) {
 		m = objs[i];
@@ -92,67 +155,58 @@ srv6_output_process(struct rte_graph *graph, struct rte_node *node, void **objs,
 		}
 
 		d = nexthop_info_srv6_output(nh);
-		if (d == NULL) {
+		if (d == NULL || d->encap == SR_H_ENCAPS_L2) {
 			edge = INVALID;
 			goto next;
 		}
 
-		// Encapsulate with another IPv6 header
-		hdrlen = sizeof(*outer_ip6);
-		reduc = d->encap == SR_H_ENCAPS_RED ? 1 : 0;
-		if (d->n_seglist > reduc)
-			hdrlen += sizeof(*srh) + (d->n_seglist * sizeof(d->seglist[0]));
+		edge = srv6_encap(m, d, nh->vrf_id, proto, plen);
+next:
+		rte_node_enqueue_x1(graph, node, edge, m);
+	}
 
-		outer_ip6 = (struct rte_ipv6_hdr *)rte_pktmbuf_prepend(m, hdrlen);
-		if (unlikely(outer_ip6 == NULL)) {
-			edge = NO_HEADROOM;
-			goto next;
-		}
+	return nb_objs;
+}
 
-		if (d->n_seglist > reduc) {
-			struct rte_ipv6_addr *segments;
-			uint16_t k;
-
-			srh = (struct rte_ipv6_routing_ext *)(outer_ip6 + 1);
-			srh->next_hdr = proto;
-			srh->hdr_len = (hdrlen - sizeof(*outer_ip6)) / 8 - 1;
-			srh->type = RTE_IPV6_SRCRT_TYPE_4;
-			srh->segments_left = d->n_seglist - 1;
-			srh->last_entry = d->n_seglist - 1;
-			srh->flags = 0;
-			srh->tag = 0;
-
-			segments = (struct rte_ipv6_addr *)(srh + 1);
-			for (k = reduc; k < d->n_seglist; k++)
-				segments[d->n_seglist - k - 1] = d->seglist[k];
-			proto = IPPROTO_ROUTING;
-			plen += hdrlen - sizeof(*outer_ip6);
-		}
+// called from 'port_rx' for ports in GR_IFACE_MODE_SRV6_L2
+static uint16_t
+srv6_l2_encap_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb) {
+	const struct nexthop_info_srv6_output *d;
+	struct iface_stats *rx_stats;
+	const struct iface *iface;
+	const struct nexthop *nh;
+	struct rte_mbuf *m;
+	rte_edge_t edge;
+
+	for (uint16_t i = 0; i < nb; i++) {
+		m = objs[i];
+		iface = mbuf_data(m)->iface;
 
-		// Resolve nexthop for the encapsulated packet.
-		nh = fib6_lookup(nh->vrf_id, GR_IFACE_ID_UNDEF, d->seglist);
+		rx_stats = iface_get_stats(rte_lcore_id(), iface->id);
+		rx_stats->rx_packets++;
+		rx_stats->rx_bytes += rte_pktmbuf_pkt_len(m);
+
+		if (gr_mbuf_is_traced(m))
+			gr_mbuf_trace_add(m, node, 0);
+
+		nh = srv6_l2_encap_get(iface->id);
 		if (nh == NULL) {
 			edge = NO_ROUTE;
 			goto next;
 		}
-		ip6_output_mbuf_data(m)->nh = nh;
-
-		nh = sr_tunsrc_get(nh->iface_id, &d->seglist[0]);
-		if (nh == NULL) {
-			// cannot output packet on interface that does not have ip6 addr
-			edge = NO_ROUTE;
+		d = nexthop_info_srv6_output(nh);
+		if (d->encap != SR_H_ENCAPS_L2) {
+			edge = INVALID;
 			goto next;
 		}
-		l3 = nexthop_info_l3(nh);
-
-		ip6_set_fields(outer_ip6, plen, proto, &l3->ipv6, &d->seglist[0]);
-		edge = IP6_OUTPUT;
 
+		// H.Encaps.L2: the whole frame is the payload (FCS already stripped)
+		edge = srv6_encap(m, d, nh->vrf_id, IPPROTO_ETHERNET, rte_pktmbuf_pkt_len(m));
 next:
 		rte_node_enqueue_x1(graph, node, edge, m);
 	}
 
-	return nb_objs;
+	return nb;
 }
 
 static void srv6_output_register(void) {
@@ -182,5 +236,30 @@ static struct gr_node_info srv6_output_info = {
 
 GR_NODE_REGISTER(srv6_output_info);
 
+static void srv6_l2_encap_register(void) {
+	register_interface_mode(GR_IFACE_MODE_SRV6_L2, "sr6_l2_encap");
+}
+
+static struct rte_node_register srv6_l2_encap_node = {
+	.name = "sr6_l2_encap",
+
+	.process = srv6_l2_encap_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[IP6_OUTPUT] = "ip6_output",
+		[INVALID] = "sr6_pkt_invalid",
+		[NO_ROUTE] = "sr6_source_no_route",
+		[NO_HEADROOM] = "error_no_headroom",
+	},
+};
+
+static struct gr_node_info srv6_l2_encap_info = {
+	.node = &srv6_l2_encap_node,
+	.register_callback = srv6_l2_encap_register,
+};
+
+GR_NODE_REGISTER(srv6_l2_encap_info);
+
 GR_DROP_REGISTER(sr6_pkt_invalid);
 GR_DROP_REGISTER(sr6_source_no_route);
@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include <gr_api.h>
+#include <gr_cli.h>
+#include <gr_cli_iface.h>
+#include <gr_net_types.h>
+#include <gr_vhost.h>
+
+#include <ecoli.h>
+
+#include <errno.h>
+#include <string.h>
+
+static void vhost_show(struct gr_api_client *, const struct gr_iface *iface) {
+	const struct gr_iface_info_vhost *vhost = (const struct gr_iface_info_vhost *)iface->info;
+
+	printf("path: %s\n", vhost->path);
+	printf("mode: %s\n", vhost->client ? "client" : "server");
+	printf("dma: %s\n", vhost->dma[0] != '\0' ? vhost->dma : "none");
+	printf("n_queues: %u\n", vhost->n_queues);
+	printf("mac: " ETH_F "\n", &vhost->mac);
+}
+
+static void
+vhost_list_info(struct gr_api_client *, const struct gr_iface *iface, char *buf, size_t len) {
+	const struct gr_iface_info_vhost *vhost = (const struct gr_iface_info_vhost *)iface->info;
+	size_t n = 0;
+
+	SAFE_BUF(snprintf, len, "path=%s queues=%u", vhost->path, vhost->n_queues);
+	if (vhost->client)
+		SAFE_BUF(snprintf, len, " client");
+	if (vhost->dma[0] != '\0')
+		SAFE_BUF(snprintf, len, " dma=%s", vhost->dma);
+	SAFE_BUF(snprintf, len, " mac=" ETH_F, &vhost->mac);
+err:
+	return;
+}
+
+static struct cli_iface_type vhost_type = {
+	.type_id = GR_IFACE_TYPE_VHOST,
+	.show = vhost_show,
+	.list_info = vhost_list_info,
+};
+
+static uint64_t parse_vhost_args(
+	struct gr_api_client *c,
+	const struct ec_pnode *p,
+	struct gr_iface *iface,
+	bool update
+) {
+	struct gr_iface_info_vhost *vhost;
+	uint64_t set_attrs;
+	const char *arg;
+
+	set_attrs = parse_iface_args(c, p, iface, sizeof(*vhost), update);
+
+	vhost = (struct gr_iface_info_vhost *)iface->info;
+
+	if ((arg = arg_str(p, "PATH")) != NULL) {
+		if (strlen(arg) >= sizeof(vhost->path)) {
+			errno = ENAMETOOLONG;
+			return 0;
+		}
+		memccpy(vhost->path, arg, 0, sizeof(vhost->path));
+	}
+
+	if ((arg = arg_str(p, "DMA")) != NULL) {
+		if (strlen(arg) >= sizeof(vhost->dma)) {
+			errno = ENAMETOOLONG;
+			return 0;
+		}
+		memccpy(vhost->dma, arg, 0, sizeof(vhost->dma));
+	}
+
+	if (arg_u16(p, "N_QUEUES", &vhost->n_queues) < 0 && errno != ENOENT)
+		return 0;
+
+	if (arg_str(p, "client") != NULL)
+		vhost->client = true;
+
+	if (arg_eth_addr(p, "MAC", &vhost->mac) < 0) {
+		if (errno != ENOENT)
+			return 0;
+	} else {
+		set_attrs |= GR_VHOST_SET_MAC;
+	}
+
+	if (set_attrs == 0)
+		errno = EINVAL;
+	return set_attrs;
+}
+
+static cmd_status_t vhost_add(struct gr_api_client *c, const struct ec_pnode *p) {
+	const struct gr_infra_iface_add_resp *resp;
+	struct gr_infra_iface_add_req *req = NULL;
+	void *resp_ptr = NULL;
+	size_t len;
+
+	len = sizeof(*req) + sizeof(struct gr_iface_info_vhost);
+	if ((req = calloc(1, len)) == NULL)
+		goto err;
+
+	req->iface.type = GR_IFACE_TYPE_VHOST;
+	req->iface.flags = GR_IFACE_F_UP;
+
+	if (parse_vhost_args(c, p, &req->iface, false) == 0)
+		goto err;
+
+	if (gr_api_client_send_recv(c, GR_INFRA_IFACE_ADD, len, req, &resp_ptr) < 0)
+		goto err;
+
+	free(req);
+	resp = resp_ptr;
+	printf("Created interface %u\n", resp->iface_id);
+	free(resp_ptr);
+	return CMD_SUCCESS;
+err:
+	free(req);
+	return CMD_ERROR;
+}
+
+static cmd_status_t vhost_set(struct gr_api_client *c, const struct ec_pnode *p) {
+	struct gr_infra_iface_set_req *req = NULL;
+	cmd_status_t ret = CMD_ERROR;
+	size_t len;
+
+	len = sizeof(*req) + sizeof(struct gr_iface_info_vhost);
+	if ((req = calloc(1, len)) == NULL)
+		goto out;
+
+	if ((req->set_attrs = parse_vhost_args(c, p, &req->iface, true)) == 0)
+		goto out;
+
+	if (gr_api_client_send_recv(c, GR_INFRA_IFACE_SET, len, req, NULL) < 0)
+		goto out;
+
+	ret = CMD_SUCCESS;
+out:
+	free(req);
+	return ret;
+}
+
+static int ctx_init(struct ec_node *root) {
+	int ret;
+
+	ret = CLI_COMMAND(
+		INTERFACE_ADD_CTX(root),
+		"vhost NAME path PATH [(dma DMA),(queues N_QUEUES),(client),(mac MAC),"
+		IFACE_ATTRS_CMD "]",
+		vhost_add,
+		"Create a new vhost-user interface.",
+		with_help("Interface name.", ec_node("any", "NAME")),
+		with_help("Path to the vhost-user unix socket.", ec_node("file", "PATH")),
+		with_help(
+			"DMA device used to copy packets into the guest memory.",
+			ec_node("any", "DMA")
+		),
+		with_help(
+			"Maximum number of queue pairs.",
+			ec_node_uint("N_QUEUES", 1, GR_VHOST_MAX_QUEUES, 10)
+		),
+		with_help(
+			"Connect to the socket instead of listening on it.",
+			ec_node_str("client", "client")
+		),
+		with_help("Set the ethernet address.", ec_node_re("MAC", ETH_ADDR_RE)),
+		IFACE_ATTRS_ARGS
+	);
+	if (ret < 0)
+		return ret;
+	ret = CLI_COMMAND(
+		INTERFACE_SET_CTX(root),
+		"vhost NAME (name NEW_NAME),(mac MAC)," IFACE_ATTRS_CMD,
+		vhost_set,
+		"Modify vhost parameters.",
+		with_help(
+			"Interface name.",
+			ec_node_dyn("NAME", complete_iface_names, INT2PTR(GR_IFACE_TYPE_VHOST))
+		),
+		with_help("New interface name.", ec_node("any", "NEW_NAME")),
+		with_help("Set the ethernet address.", ec_node_re("MAC", ETH_ADDR_RE)),
+		IFACE_ATTRS_ARGS
+	);
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+static struct cli_context ctx = {
+	.name = "vhost",
+	.init = ctx_init,
+};
+
+static void __attribute__((constructor, used)) init(void) {
+	cli_context_register(&ctx);
+	register_iface_type(&vhost_type);
+}
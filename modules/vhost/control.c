@@ -0,0 +1,529 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include "vhost_priv.h"
+
+#include <gr_event.h>
+#include <gr_iface.h>
+#include <gr_infra.h>
+#include <gr_log.h>
+#include <gr_mempool.h>
+#include <gr_module.h>
+#include <gr_rcu.h>
+#include <gr_vec.h>
+#include <gr_vhost.h>
+#include <gr_worker.h>
+
+#include <event2/event.h>
+#include <rte_bus_vdev.h>
+#include <rte_dmadev.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_lcore.h>
+#include <rte_vhost.h>
+#include <rte_vhost_async.h>
+
+#include <linux/virtio_net.h>
+#include <string.h>
+
+_Atomic(struct iface *) vhost_ifaces[VHOST_MAX_IFACES];
+struct vhost_dma vhost_dmas[RTE_DMADEV_DEFAULT_MAX];
+
+static struct event *vhost_event;
+
+static void vhost_notify(void) {
+	// May be called from the vhost-events thread while shutting down.
+	if (vhost_event != NULL)
+		event_active(vhost_event, 0, 0);
+}
+
+// Offloads are not supported by the datapath. The guest must compute the checksums
+// and segment the packets itself.
+#define VHOST_DISABLED_FEATURES                                                                    \
+	((1ULL << VIRTIO_NET_F_CSUM) | (1ULL << VIRTIO_NET_F_GUEST_CSUM)                           \
+	 | (1ULL << VIRTIO_NET_F_HOST_TSO4) | (1ULL << VIRTIO_NET_F_HOST_TSO6)                     \
+	 | (1ULL << VIRTIO_NET_F_HOST_UFO) | (1ULL << VIRTIO_NET_F_HOST_ECN)                       \
+	 | (1ULL << VIRTIO_NET_F_GUEST_TSO4) | (1ULL << VIRTIO_NET_F_GUEST_TSO6)                   \
+	 | (1ULL << VIRTIO_NET_F_GUEST_UFO) | (1ULL << VIRTIO_NET_F_GUEST_ECN))
+
+static int vhost_dma_get(const char *name) {
+	struct rte_dma_vchan_conf vchan_conf = {.direction = RTE_DMA_DIR_MEM_TO_MEM};
+	struct rte_dma_conf conf = {.nb_vchans = 1};
+	struct rte_dma_info info;
+	bool created = false;
+	int dma_id, ret;
+
+	if ((dma_id = rte_dma_get_dev_id_by_name(name)) < 0) {
+		// Not probed on startup, try to create a virtual device (e.g. dma_skeleton0).
+		if ((ret = rte_vdev_init(name, NULL)) < 0)
+			return errno_log(-ret, "rte_vdev_init");
+		if ((dma_id = rte_dma_get_dev_id_by_name(name)) < 0) {
+			rte_vdev_uninit(name);
+			return errno_set(ENODEV);
+		}
+		created = true;
+	}
+
+	if (vhost_dmas[dma_id].refcnt > 0)
+		goto end;
+
+	if ((ret = rte_dma_info_get(dma_id, &info)) < 0) {
+		errno_log(-ret, "rte_dma_info_get");
+		goto err;
+	}
+	if (!(info.dev_capa & RTE_DMA_CAPA_MEM_TO_MEM)) {
+		errno = ENOTSUP;
+		goto err;
+	}
+	vchan_conf.nb_desc = RTE_MIN(info.max_desc, VHOST_RING_SIZE_MAX * 2);
+
+	if ((ret = rte_dma_configure(dma_id, &conf)) < 0) {
+		errno_log(-ret, "rte_dma_configure");
+		goto err;
+	}
+	if ((ret = rte_dma_vchan_setup(dma_id, 0, &vchan_conf)) < 0) {
+		errno_log(-ret, "rte_dma_vchan_setup");
+		goto err;
+	}
+	if ((ret = rte_dma_start(dma_id)) < 0) {
+		errno_log(-ret, "rte_dma_start");
+		goto err;
+	}
+	if (rte_vhost_async_dma_configure(dma_id, 0) < 0) {
+		rte_dma_stop(dma_id);
+		errno_log(EINVAL, "rte_vhost_async_dma_configure");
+		goto err;
+	}
+
+	rte_spinlock_init(&vhost_dmas[dma_id].lock);
+	vhost_dmas[dma_id].created = created;
+	LOG(INFO, "%s: dma device %d started", name, dma_id);
+end:
+	vhost_dmas[dma_id].refcnt++;
+	return dma_id;
+err:
+	if (created)
+		rte_vdev_uninit(name);
+	return -errno;
+}
+
+static void vhost_dma_put(int16_t dma_id, const char *name) {
+	struct vhost_dma *dma = &vhost_dmas[dma_id];
+
+	if (--dma->refcnt > 0)
+		return;
+
+	if (rte_vhost_async_dma_unconfigure(dma_id, 0) < 0)
+		LOG(ERR, "%s: rte_vhost_async_dma_unconfigure failed", name);
+	rte_dma_stop(dma_id);
+	if (dma->created) {
+		rte_dma_close(dma_id);
+		rte_vdev_uninit(name);
+	}
+	dma->created = false;
+}
+
+static struct iface *vhost_iface_from_vid(int vid) {
+	char path[GR_VHOST_PATH_SIZE];
+	struct iface *iface;
+
+	if (rte_vhost_get_ifname(vid, path, sizeof(path)) < 0)
+		return errno_set_null(ENODEV);
+
+	for (unsigned i = 0; i < VHOST_MAX_IFACES; i++) {
+		iface = atomic_load(&vhost_ifaces[i]);
+		if (iface != NULL && strcmp(iface_info_vhost(iface)->path, path) == 0)
+			return iface;
+	}
+
+	return errno_set_null(ENODEV);
+}
+
+// Only use the guest receive virtqueues which have been enabled by the guest driver.
+static void vhost_update_active(struct iface_info_vhost *vhost) {
+	uint16_t n = 0;
+
+	while (n < vhost->n_queues && vhost->vring_enabled & RTE_BIT32(VHOST_GUEST_RXQ(n)))
+		n++;
+
+	atomic_store(&vhost->n_active, n);
+}
+
+static void vhost_async_unregister(struct iface_info_vhost *vhost) {
+	struct rte_mbuf *pkts[RTE_GRAPH_BURST_SIZE];
+	struct vhost_dma *dma = &vhost_dmas[vhost->dma_id];
+	uint16_t queue_id, n;
+
+	for (uint16_t q = 0; q < vhost->n_async; q++) {
+		queue_id = VHOST_GUEST_RXQ(q);
+		// The guest is gone, drop the packets that are still being copied.
+		while (rte_vhost_async_get_inflight_thread_unsafe(vhost->vid, queue_id) > 0) {
+			rte_spinlock_lock(&dma->lock);
+			n = rte_vhost_clear_queue_thread_unsafe(
+				vhost->vid, queue_id, pkts, ARRAY_DIM(pkts), vhost->dma_id, 0
+			);
+			rte_spinlock_unlock(&dma->lock);
+			vhost_free_bulk(pkts, n);
+		}
+		if (rte_vhost_async_channel_unregister_thread_unsafe(vhost->vid, queue_id) < 0)
+			LOG(ERR, "%s: cannot unregister async queue %u", vhost->path, queue_id);
+	}
+
+	vhost->n_async = 0;
+}
+
+// The following callbacks are invoked from the vhost-events thread.
+// State changes are propagated to the event loop running in the main lcore.
+
+static int vhost_new_device(int vid) {
+	struct iface_info_vhost *vhost;
+	struct iface *iface;
+	uint16_t n_queues;
+
+	if ((iface = vhost_iface_from_vid(vid)) == NULL)
+		return -1;
+
+	vhost = iface_info_vhost(iface);
+	vhost->vid = vid;
+	n_queues = RTE_MIN(vhost->n_queues, rte_vhost_get_vring_num(vid) / 2);
+
+	if (vhost->dma_id >= 0) {
+		for (uint16_t q = 0; q < n_queues; q++) {
+			if (rte_vhost_async_channel_register_thread_unsafe(vid, VHOST_GUEST_RXQ(q))
+			    < 0) {
+				LOG(ERR, "%s: cannot register async queue %u", iface->name, q);
+				vhost_async_unregister(vhost);
+				vhost->vid = -1;
+				return -1;
+			}
+			vhost->n_async++;
+		}
+	}
+
+	// The first queue pair is always enabled when the device becomes ready.
+	vhost->vring_enabled |= RTE_BIT32(VHOST_GUEST_RXQ(0)) | RTE_BIT32(VHOST_GUEST_TXQ(0));
+	vhost_update_active(vhost);
+	atomic_store(&vhost->ready, true);
+	vhost_notify();
+
+	LOG(INFO, "%s: vhost device %d connected", iface->name, vid);
+
+	return 0;
+}
+
+static void vhost_destroy_device(int vid) {
+	struct iface_info_vhost *vhost;
+	struct iface *iface;
+
+	if ((iface = vhost_iface_from_vid(vid)) == NULL)
+		return;
+
+	vhost = iface_info_vhost(iface);
+	atomic_store(&vhost->ready, false);
+	atomic_store(&vhost->n_active, 0);
+
+	// Wait for all workers to stop using the virtqueues.
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+
+	if (vhost->dma_id >= 0)
+		vhost_async_unregister(vhost);
+
+	vhost->vid = -1;
+	vhost->vring_enabled = 0;
+	vhost_notify();
+
+	LOG(INFO, "%s: vhost device %d disconnected", iface->name, vid);
+}
+
+static int vhost_vring_state_changed(int vid, uint16_t queue_id, int enable) {
+	struct iface_info_vhost *vhost;
+	struct iface *iface;
+
+	if ((iface = vhost_iface_from_vid(vid)) == NULL)
+		return -1;
+
+	vhost = iface_info_vhost(iface);
+	if (queue_id >= VHOST_GUEST_RXQ(GR_VHOST_MAX_QUEUES))
+		return 0;
+
+	if (enable)
+		vhost->vring_enabled |= RTE_BIT32(queue_id);
+	else
+		vhost->vring_enabled &= ~RTE_BIT32(queue_id);
+
+	if (atomic_load(&vhost->ready))
+		vhost_update_active(vhost);
+
+	return 0;
+}
+
+static const struct rte_vhost_device_ops vhost_ops = {
+	.new_device = vhost_new_device,
+	.destroy_device = vhost_destroy_device,
+	.vring_state_changed = vhost_vring_state_changed,
+};
+
+// Distribute the guest transmit virtqueues of all interfaces over the workers.
+//
+// Workers without any port rx queue do not run a graph. They cannot poll vhost
+// interfaces.
+static void vhost_queues_assign(void) {
+	gr_vec unsigned *lcores = NULL;
+	struct iface_info_vhost *vhost;
+	struct queue_map *qmap;
+	struct worker *worker;
+	struct iface *iface;
+	unsigned lcore, n = 0;
+
+	STAILQ_FOREACH (worker, &workers, next) {
+		gr_vec_foreach_ref (qmap, worker->rxqs) {
+			if (qmap->enabled) {
+				gr_vec_add(lcores, worker->lcore_id);
+				break;
+			}
+		}
+	}
+
+	for (unsigned i = 0; i < VHOST_MAX_IFACES; i++) {
+		if ((iface = atomic_load(&vhost_ifaces[i])) == NULL)
+			continue;
+		vhost = iface_info_vhost(iface);
+		for (uint16_t q = 0; q < vhost->n_queues; q++) {
+			lcore = LCORE_ID_ANY;
+			if (gr_vec_len(lcores) > 0)
+				lcore = lcores[n++ % gr_vec_len(lcores)];
+			if (atomic_exchange(&vhost->queues[q].rx_lcore, lcore) == lcore)
+				continue;
+			LOG(DEBUG, "%s: queue %u polled by lcore %d", iface->name, q, lcore);
+		}
+	}
+
+	gr_vec_free(lcores);
+}
+
+static void vhost_event_cb(evutil_socket_t, short, void *) {
+	struct iface *iface;
+	bool ready;
+
+	for (unsigned i = 0; i < VHOST_MAX_IFACES; i++) {
+		if ((iface = atomic_load(&vhost_ifaces[i])) == NULL)
+			continue;
+		ready = atomic_load(&iface_info_vhost(iface)->ready);
+		if (ready && !(iface->state & GR_IFACE_S_RUNNING)) {
+			iface->state |= GR_IFACE_S_RUNNING;
+			gr_event_push(GR_EVENT_IFACE_STATUS_UP, iface);
+		} else if (!ready && iface->state & GR_IFACE_S_RUNNING) {
+			iface->state &= ~GR_IFACE_S_RUNNING;
+			gr_event_push(GR_EVENT_IFACE_STATUS_DOWN, iface);
+		}
+	}
+
+	vhost_queues_assign();
+}
+
+static int iface_vhost_reconfig(
+	struct iface *iface,
+	uint64_t set_attrs,
+	const struct gr_iface *,
+	const void *api_info
+) {
+	struct iface_info_vhost *vhost = iface_info_vhost(iface);
+	const struct gr_iface_info_vhost *next = api_info;
+
+	if (set_attrs & GR_VHOST_SET_MAC) {
+		if (rte_is_zero_ether_addr(&next->mac))
+			rte_eth_random_addr(vhost->mac.addr_bytes);
+		else if (!rte_is_unicast_ether_addr(&next->mac))
+			return errno_set(EINVAL);
+		else
+			vhost->mac = next->mac;
+	}
+
+	return 0;
+}
+
+static int iface_vhost_fini(struct iface *iface) {
+	struct iface_info_vhost *vhost = iface_info_vhost(iface);
+
+	// Disconnects the guest driver and invokes vhost_destroy_device.
+	if (vhost->registered && rte_vhost_driver_unregister(vhost->path) < 0)
+		LOG(ERR, "%s: rte_vhost_driver_unregister failed", iface->name);
+	vhost->registered = false;
+
+	for (unsigned i = 0; i < VHOST_MAX_IFACES; i++) {
+		if (atomic_load(&vhost_ifaces[i]) == iface)
+			atomic_store(&vhost_ifaces[i], NULL);
+	}
+	rte_rcu_qsbr_synchronize(gr_datapath_rcu(), RTE_QSBR_THRID_INVALID);
+
+	if (vhost->dma_id >= 0)
+		vhost_dma_put(vhost->dma_id, vhost->dma);
+	vhost->dma_id = -1;
+
+	gr_pktmbuf_pool_release(vhost->pool, vhost->pool_size);
+	vhost->pool = NULL;
+
+	return 0;
+}
+
+static int iface_vhost_init(struct iface *iface, const void *api_info) {
+	struct iface_info_vhost *vhost = iface_info_vhost(iface);
+	const struct gr_iface_info_vhost *api = api_info;
+	uint64_t flags = 0;
+	unsigned slot;
+	int ret;
+
+	vhost->vid = -1;
+	vhost->dma_id = -1;
+
+	if (api->path[0] == '\0' || strnlen(api->path, sizeof(api->path)) == sizeof(api->path))
+		return errno_set(EINVAL);
+	if (strnlen(api->dma, sizeof(api->dma)) == sizeof(api->dma))
+		return errno_set(EINVAL);
+	if (api->n_queues > GR_VHOST_MAX_QUEUES)
+		return errno_set(ERANGE);
+
+	for (slot = 0; slot < VHOST_MAX_IFACES; slot++) {
+		if (atomic_load(&vhost_ifaces[slot]) == NULL)
+			break;
+	}
+	if (slot == VHOST_MAX_IFACES)
+		return errno_set(ENOSPC);
+
+	for (unsigned i = 0; i < VHOST_MAX_IFACES; i++) {
+		struct iface *other = atomic_load(&vhost_ifaces[i]);
+		if (other != NULL && strcmp(iface_info_vhost(other)->path, api->path) == 0)
+			return errno_set(EADDRINUSE);
+	}
+
+	if (iface->mtu == 0)
+		iface->mtu = 1500;
+
+	memccpy(vhost->path, api->path, 0, sizeof(vhost->path));
+	memccpy(vhost->dma, api->dma, 0, sizeof(vhost->dma));
+	vhost->n_queues = api->n_queues ?: 1;
+	vhost->client = api->client;
+	for (uint16_t q = 0; q < GR_VHOST_MAX_QUEUES; q++) {
+		atomic_init(&vhost->queues[q].rx_lcore, LCORE_ID_ANY);
+		rte_spinlock_init(&vhost->queues[q].rx_lock);
+		rte_spinlock_init(&vhost->queues[q].tx_lock);
+	}
+
+	if ((ret = iface_vhost_reconfig(iface, GR_VHOST_SET_MAC, NULL, api_info)) < 0)
+		return ret;
+
+	// Buffers dequeued from the guest and buffers being copied to the guest.
+	vhost->pool_size = vhost->n_queues * VHOST_RING_SIZE_MAX * 2 + RTE_GRAPH_BURST_SIZE;
+	vhost->pool_size = rte_align32pow2(vhost->pool_size) - 1;
+	vhost->pool = gr_pktmbuf_pool_get(SOCKET_ID_ANY, vhost->pool_size);
+	if (vhost->pool == NULL)
+		return errno_log(errno, "gr_pktmbuf_pool_get");
+
+	if (vhost->dma[0] != '\0') {
+		if ((ret = vhost_dma_get(vhost->dma)) < 0)
+			goto err;
+		vhost->dma_id = ret;
+		flags |= RTE_VHOST_USER_ASYNC_COPY;
+	}
+	if (vhost->client)
+		flags |= RTE_VHOST_USER_CLIENT;
+
+	if (rte_vhost_driver_register(vhost->path, flags) < 0) {
+		errno_log(EINVAL, "rte_vhost_driver_register");
+		goto err;
+	}
+	vhost->registered = true;
+
+	if (rte_vhost_driver_set_max_queue_num(vhost->path, vhost->n_queues) < 0) {
+		errno_log(EINVAL, "rte_vhost_driver_set_max_queue_num");
+		goto err;
+	}
+	if (rte_vhost_driver_disable_features(vhost->path, VHOST_DISABLED_FEATURES) < 0) {
+		errno_log(EINVAL, "rte_vhost_driver_disable_features");
+		goto err;
+	}
+	if (rte_vhost_driver_callback_register(vhost->path, &vhost_ops) < 0) {
+		errno_log(EINVAL, "rte_vhost_driver_callback_register");
+		goto err;
+	}
+
+	// The callbacks look up the interface by socket path.
+	atomic_store(&vhost_ifaces[slot], iface);
+
+	if (rte_vhost_driver_start(vhost->path) < 0) {
+		errno_log(EINVAL, "rte_vhost_driver_start");
+		goto err;
+	}
+
+	vhost_notify();
+
+	return 0;
+err:
+	ret = -errno;
+	iface_vhost_fini(iface);
+	return errno_set(-ret);
+}
+
+static int iface_vhost_get_eth_addr(const struct iface *iface, struct rte_ether_addr *mac) {
+	const struct iface_info_vhost *vhost = iface_info_vhost(iface);
+	*mac = vhost->mac;
+	return 0;
+}
+
+static int iface_vhost_set_eth_addr(struct iface *iface, const struct rte_ether_addr *mac) {
+	struct iface_info_vhost *vhost = iface_info_vhost(iface);
+
+	if (!rte_is_unicast_ether_addr(mac))
+		return errno_set(EINVAL);
+
+	vhost->mac = *mac;
+
+	return 0;
+}
+
+static void vhost_to_api(void *info, const struct iface *iface) {
+	const struct iface_info_vhost *vhost = iface_info_vhost(iface);
+	struct gr_iface_info_vhost *api = info;
+
+	*api = vhost->base;
+}
+
+static struct iface_type iface_type_vhost = {
+	.id = GR_IFACE_TYPE_VHOST,
+	.name = "vhost",
+	.pub_size = sizeof(struct gr_iface_info_vhost),
+	.priv_size = sizeof(struct iface_info_vhost),
+	.init = iface_vhost_init,
+	.reconfig = iface_vhost_reconfig,
+	.fini = iface_vhost_fini,
+	.get_eth_addr = iface_vhost_get_eth_addr,
+	.set_eth_addr = iface_vhost_set_eth_addr,
+	.to_api = vhost_to_api,
+};
+
+static void vhost_init(struct event_base *ev_base) {
+	vhost_event = event_new(ev_base, -1, EV_PERSIST | EV_FINALIZE, vhost_event_cb, NULL);
+	if (vhost_event == NULL)
+		ABORT("event_new() failed");
+	// Port rx queues may be moved to other workers at any time.
+	// Ensure the vhost queues assignment is refreshed at least once every second.
+	if (event_add(vhost_event, &(struct timeval) {.tv_sec = 1}) < 0)
+		ABORT("event_add() failed");
+}
+
+static void vhost_fini(struct event_base *) {
+	event_free(vhost_event);
+	vhost_event = NULL;
+}
+
+static struct gr_module vhost_module = {
+	.name = "vhost",
+	.depends_on = "rcu",
+	.init = vhost_init,
+	.fini = vhost_fini,
+};
+
+RTE_INIT(vhost_constructor) {
+	gr_register_module(&vhost_module);
+	iface_type_register(&iface_type_vhost);
+}
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include "vhost_priv.h"
+
+#include <gr_config.h>
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_trace.h>
+
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_spinlock.h>
+#include <rte_vhost.h>
+
+#include <stdatomic.h>
+
+enum {
+	ETH_INPUT = 0,
+	EDGE_COUNT,
+};
+
+static uint16_t vhost_rx_queue(
+	struct rte_node *node,
+	const struct iface *iface,
+	uint16_t queue_id,
+	struct rte_mbuf **mbufs,
+	uint16_t count
+) {
+	struct iface_info_vhost *vhost = iface_info_vhost(iface);
+	struct vhost_queue *q = &vhost->queues[queue_id];
+	struct eth_input_mbuf_data *d;
+	uint16_t rx;
+
+	// Reap DMA completions even when nothing is transmitted to the guest.
+	if (vhost->dma_id >= 0 && rte_spinlock_trylock(&q->tx_lock)) {
+		vhost_dma_complete(vhost, queue_id);
+		rte_spinlock_unlock(&q->tx_lock);
+	}
+
+	if (!(iface->flags & GR_IFACE_F_UP) || count == 0)
+		return 0;
+
+	// Another worker may still be polling this queue after a reassignment.
+	if (!rte_spinlock_trylock(&q->rx_lock))
+		return 0;
+	rx = rte_vhost_dequeue_burst(
+		vhost->vid, VHOST_GUEST_TXQ(queue_id), vhost->pool, mbufs, count
+	);
+	rte_spinlock_unlock(&q->rx_lock);
+
+	for (uint16_t r = 0; r < rx; r++) {
+		d = eth_input_mbuf_data(mbufs[r]);
+		d->iface = iface;
+		d->domain = ETH_DOMAIN_UNKNOWN;
+	}
+
+	if (unlikely(iface->flags & GR_IFACE_F_PACKET_TRACE)) {
+		struct trace_vhost_data *t;
+		for (uint16_t r = 0; r < rx; r++) {
+			t = gr_mbuf_trace_add(mbufs[r], node, sizeof(*t));
+			t->iface_id = iface->id;
+			t->queue_id = queue_id;
+		}
+	}
+
+	if (unlikely(gr_config.log_packets)) {
+		for (uint16_t r = 0; r < rx; r++)
+			trace_log_packet(mbufs[r], "rx", iface->name);
+	}
+
+	return rx;
+}
+
+// Poll the guest transmit virtqueues assigned to the current worker.
+static uint16_t
+vhost_rx_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t /*count*/) {
+	struct rte_mbuf **mbufs = (struct rte_mbuf **)objs;
+	unsigned lcore_id = rte_lcore_id();
+	struct iface_info_vhost *vhost;
+	const struct iface *iface;
+	uint16_t n_active;
+	uint16_t rx = 0;
+
+	for (unsigned i = 0; i < VHOST_MAX_IFACES; i++) {
+		iface = atomic_load_explicit(&vhost_ifaces[i], memory_order_acquire);
+		if (iface == NULL)
+			continue;
+		vhost = iface_info_vhost(iface);
+		if (!atomic_load_explicit(&vhost->ready, memory_order_acquire))
+			continue;
+
+		n_active = atomic_load_explicit(&vhost->n_active, memory_order_relaxed);
+		for (uint16_t q = 0; q < n_active; q++) {
+			if (atomic_load_explicit(&vhost->queues[q].rx_lcore, memory_order_relaxed)
+			    != lcore_id)
+				continue;
+			rx += vhost_rx_queue(
+				node, iface, q, &mbufs[rx], RTE_GRAPH_BURST_SIZE - rx
+			);
+		}
+	}
+
+	rte_node_enqueue(graph, node, ETH_INPUT, objs, rx);
+
+	return rx;
+}
+
+static struct rte_node_register vhost_rx_node = {
+	.name = "vhost_rx",
+	.flags = RTE_NODE_SOURCE_F,
+
+	.process = vhost_rx_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[ETH_INPUT] = "eth_input",
+	},
+};
+
+static struct gr_node_info vhost_rx_info = {
+	.node = &vhost_rx_node,
+	.trace_format = trace_vhost_format,
+};
+
+GR_NODE_REGISTER(vhost_rx_info);
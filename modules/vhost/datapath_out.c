@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#include "vhost_priv.h"
+
+#include <gr_config.h>
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_iface.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_mbuf_debug.h>
+#include <gr_trace.h>
+
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_spinlock.h>
+#include <rte_vhost.h>
+#include <rte_vhost_async.h>
+
+#include <stdatomic.h>
+
+enum {
+	FULL = 0,
+	DOWN,
+	EDGE_COUNT,
+};
+
+int trace_vhost_format(char *buf, size_t len, const void *data, size_t /*data_len*/) {
+	const struct trace_vhost_data *t = data;
+	const struct iface *iface = iface_from_id(t->iface_id);
+	return snprintf(
+		buf, len, "iface=%s queue=%u", iface ? iface->name : "[deleted]", t->queue_id
+	);
+}
+
+void vhost_dma_complete(const struct iface_info_vhost *vhost, uint16_t queue_id) {
+	struct rte_mbuf *done[RTE_GRAPH_BURST_SIZE];
+	struct vhost_dma *dma = &vhost_dmas[vhost->dma_id];
+	uint16_t n;
+
+	rte_spinlock_lock(&dma->lock);
+	n = rte_vhost_poll_enqueue_completed(
+		vhost->vid, VHOST_GUEST_RXQ(queue_id), done, ARRAY_DIM(done), vhost->dma_id, 0
+	);
+	rte_spinlock_unlock(&dma->lock);
+
+	vhost_free_bulk(done, n);
+}
+
+static void vhost_xmit(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	const struct iface *iface,
+	struct rte_mbuf **mbufs,
+	uint16_t n
+) {
+	struct iface_info_vhost *vhost = iface_info_vhost(iface);
+	uint16_t queue_id, n_active, sent;
+	struct vhost_dma *dma;
+	struct vhost_queue *q;
+
+	n_active = atomic_load_explicit(&vhost->n_active, memory_order_relaxed);
+	if (!(iface->flags & GR_IFACE_F_UP) || n_active == 0
+	    || !atomic_load_explicit(&vhost->ready, memory_order_acquire)) {
+		queue_id = UINT16_MAX;
+	} else {
+		// Workers share the guest receive virtqueues.
+		// Spread them according to the lcore to limit contention.
+		queue_id = rte_lcore_id() % n_active;
+	}
+
+	for (uint16_t i = 0; i < n; i++) {
+		if (gr_mbuf_is_traced(mbufs[i]) || iface->flags & GR_IFACE_F_PACKET_TRACE) {
+			struct trace_vhost_data *t = gr_mbuf_trace_add(mbufs[i], node, sizeof(*t));
+			t->iface_id = iface->id;
+			t->queue_id = queue_id;
+		}
+	}
+
+	if (queue_id == UINT16_MAX) {
+		rte_node_enqueue(graph, node, DOWN, (void **)mbufs, n);
+		return;
+	}
+
+	if (unlikely(gr_config.log_packets)) {
+		for (uint16_t i = 0; i < n; i++)
+			trace_log_packet(mbufs[i], "tx", iface->name);
+	}
+
+	q = &vhost->queues[queue_id];
+	rte_spinlock_lock(&q->tx_lock);
+	if (vhost->dma_id < 0) {
+		sent = rte_vhost_enqueue_burst(vhost->vid, VHOST_GUEST_RXQ(queue_id), mbufs, n);
+		// The copies are complete, the mbufs can be freed right away.
+		vhost_free_bulk(mbufs, sent);
+	} else {
+		// Submitted mbufs are owned by the vhost library until the copy is complete.
+		dma = &vhost_dmas[vhost->dma_id];
+		mbuf_debug_release(mbufs, n);
+		rte_spinlock_lock(&dma->lock);
+		sent = rte_vhost_submit_enqueue_burst(
+			vhost->vid, VHOST_GUEST_RXQ(queue_id), mbufs, n, vhost->dma_id, 0
+		);
+		rte_spinlock_unlock(&dma->lock);
+		vhost_dma_complete(vhost, queue_id);
+	}
+	rte_spinlock_unlock(&q->tx_lock);
+
+	if (sent < n)
+		rte_node_enqueue(graph, node, FULL, (void **)&mbufs[sent], n - sent);
+}
+
+static uint16_t vhost_output_process(
+	struct rte_graph *graph,
+	struct rte_node *node,
+	void **objs,
+	uint16_t nb_objs
+) {
+	struct rte_mbuf **mbufs = (struct rte_mbuf **)objs;
+	const struct iface *iface, *run = NULL;
+	uint16_t start = 0;
+
+	// Consecutive packets usually go to the same interface.
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		iface = mbuf_data(mbufs[i])->iface;
+		if (iface != run) {
+			if (run != NULL)
+				vhost_xmit(graph, node, run, &mbufs[start], i - start);
+			run = iface;
+			start = i;
+		}
+	}
+
+	if (run != NULL)
+		vhost_xmit(graph, node, run, &mbufs[start], nb_objs - start);
+
+	return nb_objs;
+}
+
+static void vhost_output_register(void) {
+	eth_output_register_interface_type(GR_IFACE_TYPE_VHOST, "vhost_output");
+}
+
+static struct rte_node_register vhost_output_node = {
+	.name = "vhost_output",
+
+	.process = vhost_output_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[FULL] = "vhost_output_full",
+		[DOWN] = "vhost_output_down",
+	},
+};
+
+static struct gr_node_info vhost_output_info = {
+	.node = &vhost_output_node,
+	.register_callback = vhost_output_register,
+	.trace_format = trace_vhost_format,
+};
+
+GR_NODE_REGISTER(vhost_output_info);
+
+GR_DROP_REGISTER(vhost_output_full);
+GR_DROP_REGISTER(vhost_output_down);
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_api.h>
+#include <gr_bitops.h>
+#include <gr_infra.h>
+#include <gr_macro.h>
+
+#include <rte_ether.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Vhost reconfig attributes
+#define GR_VHOST_SET_MAC GR_BIT64(32)
+
+#define GR_VHOST_PATH_SIZE 108 // sizeof(struct sockaddr_un.sun_path)
+#define GR_VHOST_DMA_SIZE 64
+#define GR_VHOST_MAX_QUEUES 8
+
+// Info for GR_IFACE_TYPE_VHOST interfaces.
+//
+// The interface is exposed to a virtual machine as a vhost-user unix socket.
+// Each queue pair is made of a guest transmit virtqueue, polled by a datapath
+// worker, and a guest receive virtqueue, filled by all workers in turn.
+//
+// The interface is in running state when a guest driver is connected.
+struct gr_iface_info_vhost {
+	char path[GR_VHOST_PATH_SIZE]; //!< Socket path. Cannot be changed.
+	//! Optional DMA device used to offload copies into the guest receive
+	//! virtqueues (e.g. "dma_skeleton0"). Virtual devices are created when
+	//! they do not exist. Cannot be changed.
+	char dma[GR_VHOST_DMA_SIZE];
+	uint16_t n_queues; //!< Max number of queue pairs (0: default to 1). Cannot be changed.
+	bool client; //!< Connect to the socket instead of listening. Cannot be changed.
+	struct rte_ether_addr mac; //!< If zero on creation, a random address is generated.
+};
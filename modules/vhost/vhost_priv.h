@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+#pragma once
+
+#include <gr_iface.h>
+#include <gr_mbuf.h>
+#include <gr_vhost.h>
+
+#include <rte_common.h>
+#include <rte_dmadev.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_spinlock.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define VHOST_MAX_IFACES 64
+// Largest virtqueue size supported by QEMU.
+#define VHOST_RING_SIZE_MAX 1024
+
+// Virtqueue indexes from the host point of view.
+#define VHOST_GUEST_RXQ(q) ((q) * 2)
+#define VHOST_GUEST_TXQ(q) ((q) * 2 + 1)
+
+struct vhost_queue {
+	// Guest transmit virtqueue, only polled by the worker running on this lcore.
+	// The lock protects against overlaps while the queues are being reassigned.
+	atomic_uint rx_lcore;
+	rte_spinlock_t rx_lock;
+	// Guest receive virtqueue, shared by all workers.
+	rte_spinlock_t tx_lock;
+};
+
+GR_IFACE_INFO(GR_IFACE_TYPE_VHOST, iface_info_vhost, {
+	BASE(gr_iface_info_vhost);
+
+	atomic_bool ready; //!< A guest driver is connected and the virtqueues can be used.
+	int vid; //!< vhost device id, -1 when disconnected.
+	int16_t dma_id; //!< -1 when copies are done by the CPU.
+	_Atomic uint16_t n_active; //!< Number of guest receive virtqueues enabled.
+	uint16_t n_async; //!< Number of virtqueues registered for async copies.
+	uint16_t vring_enabled; //!< Bit mask of virtqueues enabled by the guest driver.
+	bool registered; //!< The socket is registered in the vhost library.
+	struct rte_mempool *pool;
+	uint32_t pool_size;
+	struct vhost_queue queues[GR_VHOST_MAX_QUEUES];
+});
+
+// Interfaces polled by vhost_rx. Updated by the control plane, NULL slots are skipped.
+extern _Atomic(struct iface *) vhost_ifaces[VHOST_MAX_IFACES];
+
+// A DMA virtual channel must not be used concurrently by several workers.
+// Only one vchan is configured per DMA device and shared by all vhost interfaces.
+struct __rte_cache_aligned vhost_dma {
+	rte_spinlock_t lock;
+	unsigned refcnt;
+	bool created;
+};
+
+extern struct vhost_dma vhost_dmas[RTE_DMADEV_DEFAULT_MAX];
+
+// Free mbufs which have been copied into a guest virtqueue.
+static inline void vhost_free_bulk(struct rte_mbuf **mbufs, uint16_t n) {
+	for (uint16_t i = 0; i < n; i++) {
+		if (gr_mbuf_is_traced(mbufs[i]))
+			gr_mbuf_trace_finish(mbufs[i]);
+	}
+	rte_pktmbuf_free_bulk(mbufs, n);
+}
+
+// Free the mbufs which have been copied by the DMA device.
+// Must be called with the tx_lock of the queue held.
+void vhost_dma_complete(const struct iface_info_vhost *, uint16_t queue_id);
+
+struct trace_vhost_data {
+	uint16_t iface_id;
+	uint16_t queue_id;
+};
+
+int trace_vhost_format(char *buf, size_t len, const void *data, size_t data_len);
@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#include "vxlan_priv.h"
+
+#include <gr_fib4.h>
+#include <gr_iface.h>
+#include <gr_infra.h>
+#include <gr_ip4_datapath.h>
+#include <gr_log.h>
+#include <gr_module.h>
+#include <gr_rcu.h>
+#include <gr_vxlan.h>
+
+#include <event2/event.h>
+#include <rte_ether.h>
+#include <rte_hash.h>
+
+#include <netinet/in.h>
+#include <string.h>
+
+struct vxlan_key {
+	ip4_addr_t local;
+	ip4_addr_t remote;
+	uint32_t vni;
+	// uint32_t to avoid padding bytes with undetermined contents (see ipip_key).
+	uint32_t vrf_id;
+};
+
+static struct rte_hash *vxlan_hash;
+
+struct iface *vxlan_get_iface(ip4_addr_t local, ip4_addr_t remote, uint32_t vni, uint16_t vrf_id) {
+	struct vxlan_key key = {local, remote, vni, vrf_id};
+	void *data;
+
+	if (rte_hash_lookup_data(vxlan_hash, &key, &data) < 0)
+		return NULL;
+
+	return data;
+}
+
+static void vxlan_template_build(struct iface_info_vxlan *vxlan) {
+	struct vxlan_template *t = &vxlan->template;
+
+	memset(t, 0, sizeof(*t));
+
+	t->ip.version_ihl = IPV4_VERSION_IHL;
+	t->ip.time_to_live = IPV4_DEFAULT_TTL;
+	t->ip.next_proto_id = IPPROTO_UDP;
+	t->ip.src_addr = vxlan->local;
+	t->ip.dst_addr = vxlan->remote;
+	// total_length is left to zero, it is added incrementally in vxlan_output.
+	t->ip.hdr_checksum = rte_ipv4_cksum(&t->ip);
+
+	// The source port is filled per packet from the inner flow hash.
+	t->udp.dst_port = RTE_BE16(GR_VXLAN_PORT);
+	// Checksum is optional for IPv4 outer headers (RFC 7348, section 5).
+	t->udp.dgram_cksum = 0;
+
+	t->vxlan.vx_flags = VXLAN_FLAGS_VNI;
+	t->vxlan.vx_vni = rte_cpu_to_be_32(vxlan->vni << 8);
+}
+
+static int iface_vxlan_reconfig(
+	struct iface *iface,
+	uint64_t set_attrs,
+	const struct gr_iface *conf,
+	const void *api_info
+) {
+	struct iface_info_vxlan *cur = iface_info_vxlan(iface);
+	const struct gr_iface_info_vxlan *next = api_info;
+	struct vxlan_key cur_key = {cur->local, cur->remote, cur->vni, iface->vrf_id};
+	struct vxlan_key next_key = {next->local, next->remote, next->vni, conf->vrf_id};
+	void *data;
+	int ret;
+
+	if (set_attrs
+	    & (GR_IFACE_SET_VRF | GR_VXLAN_SET_VNI | GR_VXLAN_SET_LOCAL | GR_VXLAN_SET_REMOTE)) {
+		if (conf->vrf_id >= GR_MAX_VRFS)
+			return errno_set(EOVERFLOW);
+		if (next->vni > GR_VXLAN_VNI_MAX)
+			return errno_set(ERANGE);
+
+		if (rte_hash_lookup_data(vxlan_hash, &next_key, &data) >= 0 && data != iface)
+			return errno_set(EADDRINUSE);
+
+		if (fib4_lookup(conf->vrf_id, next->local) == NULL)
+			return -errno;
+		if (fib4_lookup(conf->vrf_id, next->remote) == NULL)
+			return -errno;
+
+		if (memcmp(&cur_key, &next_key, sizeof(cur_key)) != 0)
+			rte_hash_del_key(vxlan_hash, &cur_key);
+
+		if ((ret = rte_hash_add_key_data(vxlan_hash, &next_key, iface)) < 0)
+			return errno_log(-ret, "rte_hash_add_key_data");
+
+		cur->vni = next->vni;
+		cur->local = next->local;
+		cur->remote = next->remote;
+		vxlan_template_build(cur);
+	}
+
+	if (set_attrs & GR_VXLAN_SET_MAC) {
+		if (rte_is_zero_ether_addr(&next->mac))
+			rte_eth_random_addr(cur->mac.addr_bytes);
+		else if (!rte_is_unicast_ether_addr(&next->mac))
+			return errno_set(EINVAL);
+		else
+			cur->mac = next->mac;
+	}
+
+	return 0;
+}
+
+static int iface_vxlan_fini(struct iface *iface) {
+	struct iface_info_vxlan *vxlan = iface_info_vxlan(iface);
+	struct vxlan_key key = {vxlan->local, vxlan->remote, vxlan->vni, iface->vrf_id};
+
+	rte_hash_del_key(vxlan_hash, &key);
+
+	return 0;
+}
+
+static int iface_vxlan_init(struct iface *iface, const void *api_info) {
+	struct gr_iface conf;
+	int ret;
+
+	if (iface->mtu == 0) {
+		// Leave room for the outer IPv4, UDP, VXLAN and inner Ethernet headers.
+		iface->mtu = 1500 - sizeof(struct vxlan_template) - sizeof(struct rte_ether_hdr);
+	}
+
+	conf.base = iface->base;
+
+	ret = iface_vxlan_reconfig(iface, IFACE_SET_ALL, &conf, api_info);
+	if (ret < 0) {
+		iface_vxlan_fini(iface);
+		errno = -ret;
+	}
+
+	return ret;
+}
+
+static int iface_vxlan_get_eth_addr(const struct iface *iface, struct rte_ether_addr *mac) {
+	const struct iface_info_vxlan *vxlan = iface_info_vxlan(iface);
+	*mac = vxlan->mac;
+	return 0;
+}
+
+static int iface_vxlan_set_eth_addr(struct iface *iface, const struct rte_ether_addr *mac) {
+	struct iface_info_vxlan *vxlan = iface_info_vxlan(iface);
+
+	if (!rte_is_unicast_ether_addr(mac))
+		return errno_set(EINVAL);
+
+	vxlan->mac = *mac;
+
+	return 0;
+}
+
+static void vxlan_to_api(void *info, const struct iface *iface) {
+	const struct iface_info_vxlan *vxlan = iface_info_vxlan(iface);
+	struct gr_iface_info_vxlan *api = info;
+
+	*api = vxlan->base;
+}
+
+static struct iface_type iface_type_vxlan = {
+	.id = GR_IFACE_TYPE_VXLAN,
+	.name = "vxlan",
+	.pub_size = sizeof(struct gr_iface_info_vxlan),
+	.priv_size = sizeof(struct iface_info_vxlan),
+	.init = iface_vxlan_init,
+	.reconfig = iface_vxlan_reconfig,
+	.fini = iface_vxlan_fini,
+	.get_eth_addr = iface_vxlan_get_eth_addr,
+	.set_eth_addr = iface_vxlan_set_eth_addr,
+	.to_api = vxlan_to_api,
+};
+
+static void vxlan_init(struct event_base *) {
+	struct rte_hash_parameters params = {
+		.name = "vxlan",
+		.entries = MAX_IFACES,
+		.key_len = sizeof(struct vxlan_key),
+		.socket_id = SOCKET_ID_ANY,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF
+			| RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT,
+	};
+	vxlan_hash = rte_hash_create(&params);
+	if (vxlan_hash == NULL)
+		ABORT("rte_hash_create(vxlan)");
+
+	struct rte_hash_rcu_config rcu_config = {
+		.v = gr_datapath_rcu(), .mode = RTE_HASH_QSBR_MODE_SYNC
+	};
+	rte_hash_rcu_qsbr_add(vxlan_hash, &rcu_config);
+}
+
+static void vxlan_fini(struct event_base *) {
+	rte_hash_free(vxlan_hash);
+	vxlan_hash = NULL;
+}
+
+static struct gr_module vxlan_module = {
+	.name = "vxlan",
+	.depends_on = "rcu",
+	.init = vxlan_init,
+	.fini = vxlan_fini,
+};
+
+RTE_INIT(vxlan_constructor) {
+	gr_register_module(&vxlan_module);
+	iface_type_register(&iface_type_vxlan);
+}
@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#include "vxlan_priv.h"
+
+#include <gr_datapath.h>
+#include <gr_eth.h>
+#include <gr_graph.h>
+#include <gr_ip4_datapath.h>
+#include <gr_l4.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_trace.h>
+
+#include <rte_byteorder.h>
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+
+#include <netinet/in.h>
+
+enum {
+	ETH_INPUT = 0,
+	NO_TUNNEL,
+	BAD_HEADER,
+	IFACE_DOWN,
+	EDGE_COUNT,
+};
+
+int trace_vxlan_format(char *buf, size_t len, const void *data, size_t /*data_len*/) {
+	const struct trace_vxlan_data *t = data;
+	const struct iface *iface = iface_from_id(t->iface_id);
+	return snprintf(
+		buf,
+		len,
+		"iface=%s vni=%u src_port=%u",
+		iface ? iface->name : "[deleted]",
+		t->vni,
+		rte_be_to_cpu_16(t->src_port)
+	);
+}
+
+static uint16_t
+vxlan_input_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	const struct rte_ether_hdr *inner_eth;
+	struct eth_input_mbuf_data *eth_data;
+	struct ip_local_mbuf_data *ip_data;
+	const struct rte_vxlan_hdr *vxh;
+	const struct rte_udp_hdr *udp;
+	ip4_addr_t last_src, last_dst;
+	uint32_t vni, last_vni;
+	struct rte_mbuf *mbuf;
+	struct iface *vxlan, *last_vxlan;
+	uint16_t last_vrf_id;
+	rte_be16_t src_port;
+	rte_edge_t edge;
+
+	last_vxlan = NULL;
+	last_src = 0;
+	last_dst = 0;
+	last_vni = UINT32_MAX;
+	last_vrf_id = GR_VRF_ID_ALL;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		mbuf = objs[i];
+		ip_data = ip_local_mbuf_data(mbuf);
+		vxlan = NULL;
+		vni = 0;
+		src_port = 0;
+
+		if (!(mbuf->packet_type & RTE_PTYPE_L3_IPV4)) {
+			// Only IPv4 underlay is supported.
+			edge = NO_TUNNEL;
+			goto next;
+		}
+		if (unlikely(
+			    rte_pktmbuf_data_len(mbuf)
+			    < sizeof(*udp) + sizeof(*vxh) + sizeof(struct rte_ether_hdr)
+		    )) {
+			edge = BAD_HEADER;
+			goto next;
+		}
+		// ip_input_local has already stripped the outer IPv4 header.
+		udp = rte_pktmbuf_mtod(mbuf, const struct rte_udp_hdr *);
+		vxh = (const struct rte_vxlan_hdr *)(udp + 1);
+		if (unlikely(!(vxh->vx_flags & VXLAN_FLAGS_VNI))) {
+			edge = BAD_HEADER;
+			goto next;
+		}
+		src_port = udp->src_port;
+		vni = rte_be_to_cpu_32(vxh->vx_vni) >> 8;
+
+		// Consecutive packets usually belong to the same tunnel.
+		// Only perform an exact-match lookup when the tuple changes.
+		if (vni != last_vni || ip_data->dst != last_dst || ip_data->src != last_src
+		    || ip_data->vrf_id != last_vrf_id) {
+			last_vxlan = vxlan_get_iface(
+				ip_data->dst, ip_data->src, vni, ip_data->vrf_id
+			);
+			last_vni = vni;
+			last_dst = ip_data->dst;
+			last_src = ip_data->src;
+			last_vrf_id = ip_data->vrf_id;
+		}
+		vxlan = last_vxlan;
+		if (vxlan == NULL) {
+			edge = NO_TUNNEL;
+			goto next;
+		}
+		if (!(vxlan->flags & GR_IFACE_F_UP)) {
+			edge = IFACE_DOWN;
+			goto next;
+		}
+
+		rte_pktmbuf_adj(mbuf, sizeof(*udp) + sizeof(*vxh));
+
+		// Offload flags and packet type only describe the outer headers.
+		// Reset them so that the following nodes do not use stale info.
+		mbuf->ol_flags &= ~RTE_MBUF_F_RX_VLAN_STRIPPED;
+		mbuf->ol_flags |= RTE_MBUF_F_RX_IP_CKSUM_NONE | RTE_MBUF_F_RX_L4_CKSUM_NONE;
+		inner_eth = rte_pktmbuf_mtod(mbuf, const struct rte_ether_hdr *);
+		switch (inner_eth->ether_type) {
+		case RTE_BE16(RTE_ETHER_TYPE_IPV4):
+			mbuf->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4;
+			break;
+		case RTE_BE16(RTE_ETHER_TYPE_IPV6):
+			mbuf->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV6;
+			break;
+		default:
+			mbuf->packet_type = RTE_PTYPE_L2_ETHER;
+			break;
+		}
+
+		eth_data = eth_input_mbuf_data(mbuf);
+		eth_data->iface = vxlan;
+		eth_data->domain = ETH_DOMAIN_UNKNOWN;
+		edge = ETH_INPUT;
+next:
+		if (gr_mbuf_is_traced(mbuf) || (vxlan && vxlan->flags & GR_IFACE_F_PACKET_TRACE)) {
+			struct trace_vxlan_data *t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
+			t->vni = vni;
+			t->iface_id = vxlan ? vxlan->id : 0;
+			t->src_port = src_port;
+		}
+		rte_node_enqueue_x1(graph, node, edge, mbuf);
+	}
+
+	return nb_objs;
+}
+
+static void vxlan_input_register(void) {
+	l4_input_register_port(IPPROTO_UDP, RTE_BE16(GR_VXLAN_PORT), "vxlan_input");
+}
+
+static struct rte_node_register vxlan_input_node = {
+	.name = "vxlan_input",
+
+	.process = vxlan_input_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[ETH_INPUT] = "eth_input",
+		[NO_TUNNEL] = "vxlan_input_no_tunnel",
+		[BAD_HEADER] = "vxlan_input_bad_header",
+		[IFACE_DOWN] = "iface_input_admin_down",
+	},
+};
+
+static struct gr_node_info vxlan_input_info = {
+	.node = &vxlan_input_node,
+	.register_callback = vxlan_input_register,
+	.trace_format = trace_vxlan_format,
+};
+
+GR_NODE_REGISTER(vxlan_input_info);
+
+GR_DROP_REGISTER(vxlan_input_no_tunnel);
+GR_DROP_REGISTER(vxlan_input_bad_header);
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#include "vxlan_priv.h"
+
+#include <gr_datapath.h>
+#include <gr_eth.h>
+#include <gr_fib4.h>
+#include <gr_graph.h>
+#include <gr_ip4_datapath.h>
+#include <gr_log.h>
+#include <gr_mbuf.h>
+#include <gr_trace.h>
+#include <gr_vxlan.h>
+
+#include <rte_byteorder.h>
+#include <rte_ether.h>
+#include <rte_hash_crc.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+
+enum {
+	IP_OUTPUT = 0,
+	NO_TUNNEL,
+	NO_HEADROOM,
+	IFACE_DOWN,
+	EDGE_COUNT,
+};
+
+// Compute a hash of the inner flow. Reuse the NIC RSS hash when available.
+static inline uint32_t vxlan_flow_hash(const struct rte_mbuf *mbuf) {
+	const struct rte_ether_hdr *eth;
+	const struct rte_ipv4_hdr *ip;
+	uint32_t hash;
+
+	if (mbuf->ol_flags & RTE_MBUF_F_RX_RSS_HASH)
+		return mbuf->hash.rss;
+
+	eth = rte_pktmbuf_mtod(mbuf, const struct rte_ether_hdr *);
+	hash = rte_hash_crc(eth, 2 * sizeof(struct rte_ether_addr), 0);
+
+	if (eth->ether_type == RTE_BE16(RTE_ETHER_TYPE_IPV4)
+	    && rte_pktmbuf_data_len(mbuf) >= sizeof(*eth) + sizeof(*ip)) {
+		ip = (const struct rte_ipv4_hdr *)(eth + 1);
+		hash = rte_hash_crc_4byte(ip->src_addr, hash);
+		hash = rte_hash_crc_4byte(ip->dst_addr, hash);
+		hash = rte_hash_crc_1byte(ip->next_proto_id, hash);
+	}
+
+	return hash;
+}
+
+static uint16_t
+vxlan_output_process(struct rte_graph *graph, struct rte_node *node, void **objs, uint16_t nb_objs) {
+	const struct iface_info_vxlan *vxlan;
+	struct ip_output_mbuf_data *ip_data;
+	struct vxlan_template *outer;
+	const struct iface *iface;
+	struct rte_mbuf *mbuf;
+	uint16_t inner_len;
+	uint32_t hash;
+	rte_edge_t edge;
+	uint32_t sum;
+
+	for (uint16_t i = 0; i < nb_objs; i++) {
+		mbuf = objs[i];
+		vxlan = NULL;
+
+		// eth_output has already prepended the inner ethernet header.
+		iface = mbuf_data(mbuf)->iface;
+		if (iface == NULL || iface->type != GR_IFACE_TYPE_VXLAN) {
+			edge = NO_TUNNEL;
+			goto next;
+		}
+		if (!(iface->flags & GR_IFACE_F_UP)) {
+			edge = IFACE_DOWN;
+			goto next;
+		}
+		vxlan = iface_info_vxlan(iface);
+		inner_len = rte_pktmbuf_pkt_len(mbuf);
+		hash = vxlan_flow_hash(mbuf);
+
+		outer = (struct vxlan_template *)rte_pktmbuf_prepend(mbuf, sizeof(*outer));
+		if (unlikely(outer == NULL)) {
+			edge = NO_HEADROOM;
+			goto next;
+		}
+		*outer = vxlan->template;
+
+		// Use the dynamic port range for source port entropy (RFC 7348).
+		outer->udp.src_port = rte_cpu_to_be_16(0xc000 | (hash & 0x3fff));
+		outer->udp.dgram_len = rte_cpu_to_be_16(
+			inner_len + sizeof(outer->udp) + sizeof(outer->vxlan)
+		);
+		outer->ip.total_length = rte_cpu_to_be_16(inner_len + sizeof(*outer));
+
+		// Incremental checksum update (RFC 1624) from the template which was
+		// computed with a zero total_length.
+		sum = (uint16_t)~outer->ip.hdr_checksum;
+		sum += outer->ip.total_length;
+		sum = (sum & 0xffff) + (sum >> 16);
+		outer->ip.hdr_checksum = (uint16_t)~sum;
+
+		// Resolve nexthop for the encapsulated packet.
+		ip_data = ip_output_mbuf_data(mbuf);
+		ip_data->nh = fib4_lookup(iface->vrf_id, vxlan->remote);
+		edge = IP_OUTPUT;
+next:
+		if (gr_mbuf_is_traced(mbuf)) {
+			struct trace_vxlan_data *t = gr_mbuf_trace_add(mbuf, node, sizeof(*t));
+			t->vni = vxlan ? vxlan->vni : 0;
+			t->iface_id = iface ? iface->id : 0;
+			t->src_port = 0;
+			if (edge == IP_OUTPUT) {
+				outer = rte_pktmbuf_mtod(mbuf, struct vxlan_template *);
+				t->src_port = outer->udp.src_port;
+			}
+		}
+		rte_node_enqueue_x1(graph, node, edge, mbuf);
+	}
+
+	return nb_objs;
+}
+
+static void vxlan_output_register(void) {
+	eth_output_register_interface_type(GR_IFACE_TYPE_VXLAN, "vxlan_output");
+}
+
+static struct rte_node_register vxlan_output_node = {
+	.name = "vxlan_output",
+
+	.process = vxlan_output_process,
+
+	.nb_edges = EDGE_COUNT,
+	.next_nodes = {
+		[IP_OUTPUT] = "ip_output",
+		[NO_TUNNEL] = "vxlan_output_no_tunnel",
+		[NO_HEADROOM] = "error_no_headroom",
+		[IFACE_DOWN] = "iface_input_admin_down",
+	},
+};
+
+static struct gr_node_info vxlan_output_info = {
+	.node = &vxlan_output_node,
+	.register_callback = vxlan_output_register,
+	.trace_format = trace_vxlan_format,
+};
+
+GR_NODE_REGISTER(vxlan_output_info);
+
+GR_DROP_REGISTER(vxlan_output_no_tunnel);
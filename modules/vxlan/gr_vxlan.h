@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#pragma once
+
+#include <gr_api.h>
+#include <gr_bitops.h>
+#include <gr_infra.h>
+#include <gr_macro.h>
+#include <gr_net_types.h>
+
+#include <rte_ether.h>
+
+#include <stdint.h>
+
+// VXLAN reconfig attributes
+#define GR_VXLAN_SET_VNI GR_BIT64(32)
+#define GR_VXLAN_SET_LOCAL GR_BIT64(33)
+#define GR_VXLAN_SET_REMOTE GR_BIT64(34)
+#define GR_VXLAN_SET_MAC GR_BIT64(35)
+
+// IANA assigned destination UDP port (RFC 7348).
+#define GR_VXLAN_PORT 4789
+// VXLAN network identifiers are 24 bits wide.
+#define GR_VXLAN_VNI_MAX 0xffffff
+
+// Info for GR_IFACE_TYPE_VXLAN interfaces
+struct gr_iface_info_vxlan {
+	uint32_t vni;
+	ip4_addr_t local;
+	ip4_addr_t remote;
+	struct rte_ether_addr mac; // If zero on creation, a random address is generated.
+};
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2024 Robin Jarry
+
+#pragma once
+
+#include <gr_iface.h>
+#include <gr_macro.h>
+#include <gr_net_types.h>
+#include <gr_vxlan.h>
+
+#include <rte_common.h>
+#include <rte_ip.h>
+#include <rte_udp.h>
+#include <rte_vxlan.h>
+
+#include <stdalign.h>
+#include <stdint.h>
+
+// "I" flag, indicates that the VNI field is valid (RFC 7348).
+#define VXLAN_FLAGS_VNI RTE_BE32(0x08000000)
+
+// Outer headers prepended to every encapsulated frame.
+struct vxlan_template {
+	struct rte_ipv4_hdr ip;
+	struct rte_udp_hdr udp;
+	struct rte_vxlan_hdr vxlan;
+} __rte_packed;
+
+GR_IFACE_INFO(GR_IFACE_TYPE_VXLAN, iface_info_vxlan, {
+	BASE(gr_iface_info_vxlan);
+
+	// Built once in the control plane whenever the tunnel parameters change.
+	// The IPv4 checksum is computed with a zero total_length so that the
+	// datapath only needs to add the actual length incrementally.
+	struct vxlan_template template;
+});
+
+struct iface *vxlan_get_iface(ip4_addr_t local, ip4_addr_t remote, uint32_t vni, uint16_t vrf_id);
+
+struct trace_vxlan_data {
+	uint32_t vni;
+	uint16_t iface_id;
+	rte_be16_t src_port;
+};
+
+int trace_vxlan_format(char *buf, size_t len, const void *data, size_t data_len);
@@ -100,7 +100,9 @@ install -D -m 0644 -t %{buildroot}%{_datadir}/dpdk/telemetry-endpoints subprojec
 %attr(644, root, root) %{_datadir}/bash-completion/completions/grcli
 %attr(755, root, root) %{_bindir}/grcli
 %attr(755, root, root) %{_bindir}/grout
+%attr(755, root, root) %{_bindir}/grstat
 %attr(644, root, root) %{_mandir}/man1/grcli.1*
+%attr(644, root, root) %{_mandir}/man1/grstat.1*
 %attr(644, root, root) %{_mandir}/man8/grout.8*
 
 %files devel
@@ -154,6 +154,9 @@ if [ -n "${builddir}" ]; then
 fi
 
 grout_extra_options=""
+if [ -n "${grout_max_mtu-}" ]; then
+	grout_extra_options+=" -u $grout_max_mtu"
+fi
 if [ "$test_frr" = true ] && [ "$run_frr" = true ]; then
 	chmod 0755 $tmp # to access on tmp
 	grout_extra_options+="-m 0666"
@@ -165,6 +168,7 @@ fi
 
 cat >> $tmp/cleanup <<EOF
 grcli stats show software
+grcli stats api
 grcli trace show count 50
 EOF
 
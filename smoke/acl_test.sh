@@ -0,0 +1,52 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+grcli address add 172.16.0.1/24 iface p0
+grcli address add 172.16.1.1/24 iface p1
+grcli address add 2001:db8:0::1/64 iface p0
+grcli address add 2001:db8:1::1/64 iface p1
+
+for n in 0 1; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+	ip -n $ns addr add 172.16.$n.2/24 dev $p
+	ip -n $ns addr add 2001:db8:$n::2/64 dev $p
+	ip -n $ns route add default via 172.16.$n.1
+	ip -n $ns -6 route add default via 2001:db8:$n::1
+done
+sleep 3 # wait for DAD
+
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
+ip netns exec n0 ping6 -i0.01 -c3 -n 2001:db8:1::2
+
+# ingress
+grcli acl add iface p0 in seq 10 deny proto icmp dst 172.16.1.2/32
+grcli acl add iface p0 in seq 20 permit
+grcli acl add iface p0 in seq 11 deny proto icmp6 dst 2001:db8:1::2/128
+grcli interface show name p0 | grep -w acl
+grcli acl show
+! ip netns exec n0 ping -i0.01 -c3 -W1 -n 172.16.1.2 || fail "ping should be denied"
+! ip netns exec n0 ping6 -i0.01 -c3 -W1 -n 2001:db8:1::2 || fail "ping6 should be denied"
+# other destinations are still reachable
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.0.1
+grcli acl show iface p0 | grep -E "^p0\s+in\s+10\s+deny\s+1\s+\*\s+172\.16\.1\.2/32.*\s3$"
+grcli acl flush iface p0 in
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
+
+# egress
+grcli acl add iface p1 out seq 1 deny proto udp dport 1000-2000
+grcli acl add iface p1 out seq 2 deny src 2001:db8::/48 dscp 46
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
+ip netns exec n0 ping6 -i0.01 -c3 -n 2001:db8:1::2
+! ip netns exec n0 ping6 -i0.01 -c3 -W1 -Q 0xb8 -n 2001:db8:1::2 || fail "ping6 should be denied"
+grcli acl del iface p1 out seq 2
+ip netns exec n0 ping6 -i0.01 -c3 -Q 0xb8 -n 2001:db8:1::2
+grcli acl show iface p1 | grep -E "^p1\s+out\s+1\s+deny\s+17\s.*\s1000-2000\s"
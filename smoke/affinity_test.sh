@@ -24,6 +24,16 @@ grcli affinity qmap set p1 rxq 0 cpu 2
 grcli affinity qmap set p1 rxq 1 cpu 2
 grcli affinity qmap show
 
+# reconfiguring one port must not move the queues of other ports
+grcli affinity qmap show > $tmp/qmap_before
+grcli interface set port p1 rxqs 3
+grcli interface set port p1 qsize 512
+grcli interface set port p1 mtu 2000
+grcli affinity qmap show
+grcli affinity qmap show | grep -w p0 | diff -u <(grep -w p0 $tmp/qmap_before) - \
+	|| fail "p0 queues were moved"
+grcli interface set port p1 rxqs 2
+
 grcli affinity cpus set datapath 2,3
 grcli affinity qmap show
 
@@ -0,0 +1,32 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+grcli interface add bridge br0 mac d2:f0:0c:ba:a5:20
+port_add p0 mode bridge br0
+port_add p1 mode bridge br0
+grcli address add 10.0.0.1/24 iface br0
+
+for n in 0 1; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p address ba:d0:ca:ca:00:0$n
+	ip -n $ns link set $p up
+	ip -n $ns addr add 10.0.0.$((n+2))/24 dev $p
+done
+
+# bridged traffic between members
+ip netns exec n0 ping -i0.01 -c3 -n 10.0.0.3
+ip netns exec n1 ping -i0.01 -c3 -n 10.0.0.2
+
+# routed traffic to the bridge interface
+ip netns exec n0 ping -i0.01 -c3 -n 10.0.0.1
+ip netns exec n1 ping -i0.01 -c3 -n 10.0.0.1
+
+grcli bridge fdb show bridge br0
+grcli bridge fdb show | grep -q "ba:d0:ca:ca:00:00.*p0"
+grcli bridge fdb show | grep -q "ba:d0:ca:ca:00:01.*p1"
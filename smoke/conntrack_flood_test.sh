@@ -0,0 +1,78 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+grcli address add 172.16.0.1/24 iface p0
+grcli address add 10.99.0.1/24 iface p1
+grcli snat44 add interface p0 subnet 10.99.0.0/24 replace 172.16.0.1
+grcli conntrack config set max 1024 max-per-source 200 early-drop-threshold 80
+
+# SYNs sent to this destination are never answered
+grcli nexthop add l3 iface p0 id 99 address 172.16.0.3 mac ba:d0:ca:ca:00:99
+grcli route add 172.16.99.0/24 via id 99
+
+for n in 0 1; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+done
+
+ip -n n0 addr add 172.16.0.2/24 dev x-p0
+ip -n n1 addr add 10.99.0.99/24 dev x-p1
+ip -n n1 route add default via 10.99.0.1
+
+# established connection which must survive the flood
+mkfifo $tmp/in
+ip netns exec n0 socat -4 TCP4-LISTEN:1234,reuseaddr EXEC:/bin/cat &
+sleep 0.2
+ip netns exec n1 socat - TCP4:172.16.0.2:1234 < $tmp/in > $tmp/out &
+exec 3> $tmp/in
+echo before >&3
+sleep 0.5
+grep -qx before $tmp/out || fail "no response before flood"
+
+# flood SYNs from 20 different sources, 300 SYNs each
+ip netns exec n1 python3 - <<'PY'
+import socket
+import struct
+
+def csum(data):
+    if len(data) % 2:
+        data += b"\0"
+    s = sum(struct.unpack("!%dH" % (len(data) // 2), data))
+    s = (s >> 16) + (s & 0xFFFF)
+    s += s >> 16
+    return ~s & 0xFFFF
+
+sock = socket.socket(socket.AF_INET, socket.SOCK_RAW, socket.IPPROTO_RAW)
+dst = socket.inet_aton("172.16.99.1")
+for host in range(100, 120):
+    src = socket.inet_aton("10.99.0.%d" % host)
+    for sport in range(20000, 20300):
+        tcp = struct.pack("!HHIIBBHHH", sport, 80, 1, 0, 5 << 4, 0x02, 1024, 0, 0)
+        pseudo = src + dst + struct.pack("!BBH", 0, 6, len(tcp))
+        tcp = tcp[:16] + struct.pack("!H", csum(pseudo + tcp)) + tcp[18:]
+        ip = struct.pack("!BBHHHBBH4s4s", 0x45, 0, 40, 0, 0, 64, 6, 0, src, dst)
+        sock.sendto(ip + tcp, ("172.16.99.1", 0))
+PY
+
+sleep 2
+grcli conntrack config show | tee $tmp/config
+
+counter() {
+	awk -v name=$1 '$1 == name {print $2}' $tmp/config
+}
+[ "$(counter source-limit-drops)" -gt 0 ] || fail "per-source limit was not enforced"
+[ "$(counter early-drop-embryonic)" -gt 0 ] || fail "embryonic connections were not evicted"
+grcli conntrack show | grep -qw established || fail "established connection was evicted"
+
+echo after >&3
+sleep 0.5
+grep -qx after $tmp/out || fail "established connection did not survive the flood"
+exec 3>&-
@@ -14,9 +14,12 @@ grcli nexthop add l3 iface p1 id 2 address 172.16.1.2
 grcli route add 16.1.0.0/16 via id 2 vrf 1
 grcli route add 16.1.0.0/16 via id 2 vrf 2 # required for ARP resolution
 
-# from 16.1.0.1 to 16.0.0.1, two route lookup are done
+# from 16.1.0.1 to 16.0.0.1, the route leaked to gr-loop1 is resolved directly
+# in vrf 1 by ip_output without going through loop_xvrf
 grcli nexthop add l3 iface gr-loop1 id 1
 grcli route add 16.0.0.0/16 via id 1 vrf 2
+# local delivery in vrf 1 still goes through loop_xvrf and ip_input
+grcli route add 172.16.0.1/32 via id 1 vrf 2
 grcli route add 16.0.0.0/16 via 172.16.0.2 vrf 1
 
 for n in 0 1; do
@@ -32,3 +35,17 @@ done
 
 ip netns exec n0 ping -i0.01 -c3 -I 16.0.0.1 -n 16.1.0.1
 ip netns exec n1 ping -i0.01 -c3 -I 16.1.0.1 -n 16.0.0.1
+
+# direct leaking
+grcli stats reset
+ip netns exec n1 ping -i0.001 -c1000 -q -I 16.1.0.1 -n 16.0.0.1
+grcli stats show software
+if grcli stats show software | grep -qw loop_xvrf; then
+	fail "leaked route was not resolved directly"
+fi
+
+# loopback re-entry
+grcli stats reset
+ip netns exec n1 ping -i0.001 -c1000 -q -I 16.1.0.1 -n 172.16.0.1
+grcli stats show software
+grcli stats show software | grep -w loop_xvrf
@@ -0,0 +1,40 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2024 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+grcli address add 10.99.0.1/24 iface p0
+grcli address add 172.16.1.1/24 iface p1
+grcli interface add gre tun1 local 172.16.1.1 remote 172.16.1.2 key 1234
+grcli address add 10.98.0.1/24 iface tun1
+
+netns_add n0
+ip link set x-p0 netns n0
+ip -n n0 link set x-p0 up
+ip -n n0 addr add 10.99.0.2/24 dev x-p0
+ip -n n0 route add default via 10.99.0.1
+
+netns_add n1
+ip link set x-p1 netns n1
+ip -n n1 link set x-p1 up
+ip -n n1 addr add 172.16.1.2/24 dev x-p1
+ip -n n1 tunnel add tun1 mode gre local 172.16.1.2 remote 172.16.1.1 key 1234
+ip -n n1 link set tun1 up
+ip -n n1 addr add 10.98.0.2/24 dev tun1
+ip -n n1 route add default via 10.98.0.1
+
+ip netns exec n0 ping -i0.01 -c3 -n 10.98.0.2
+ip netns exec n1 ping -i0.01 -c3 -n 10.99.0.2
+
+grcli address add 2001:db8:98::1/64 iface tun1
+grcli address add 2001:db8:99::1/64 iface p0
+ip -n n0 addr add 2001:db8:99::2/64 dev x-p0
+ip -n n0 route add default via 2001:db8:99::1
+ip -n n1 addr add 2001:db8:98::2/64 dev tun1
+ip -n n1 route add default via 2001:db8:98::1
+
+ip netns exec n0 ping6 -i0.01 -c3 -n 2001:db8:98::2
+ip netns exec n1 ping6 -i0.01 -c3 -n 2001:db8:99::2
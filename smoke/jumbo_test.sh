@@ -0,0 +1,37 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+# Jumbo frames are received in chains of mbuf segments.
+grout_max_mtu=9000
+
+. $(dirname $0)/_init.sh
+
+port_add p0 mtu 9000
+port_add p1 mtu 9000
+port_add p2 mtu 1500
+grcli address add 172.16.0.1/24 iface p0
+grcli address add 172.16.1.1/24 iface p1
+grcli address add 172.16.2.1/24 iface p2
+
+for n in 0 1 2; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	if [ $n -eq 2 ]; then
+		ip link set $p mtu 1500
+	else
+		ip link set $p mtu 9000
+	fi
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+	ip -n $ns addr add 172.16.$n.2/24 dev $p
+	ip -n $ns route add default via 172.16.$n.1
+done
+
+# local ICMP checksum over multiple segments
+ip netns exec n0 ping -i0.01 -c3 -s 8000 -M do -n 172.16.0.1
+# jumbo forwarding
+ip netns exec n0 ping -i0.01 -c3 -s 8000 -M do -n 172.16.1.2
+# fragmentation of a segmented packet
+ip netns exec n0 ping -i0.01 -c3 -s 8000 -M dont -n 172.16.2.2
@@ -0,0 +1,47 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+modprobe mpls_router || fail "mpls_router kernel module not available"
+modprobe mpls_iptunnel || fail "mpls_iptunnel kernel module not available"
+
+port_add p0
+port_add p1
+grcli address add 10.99.0.1/24 iface p0
+grcli address add 172.16.1.1/24 iface p1
+
+netns_add n0
+ip link set x-p0 netns n0
+ip -n n0 link set x-p0 up
+ip -n n0 addr add 10.99.0.2/24 dev x-p0
+ip -n n0 route add default via 10.99.0.1
+
+netns_add n1
+ip link set x-p1 netns n1
+ip -n n1 link set x-p1 up
+ip -n n1 addr add 172.16.1.2/24 dev x-p1
+ip -n n1 addr add 10.98.0.2/32 dev lo
+ip netns exec n1 sysctl -w net.mpls.platform_labels=1000
+ip netns exec n1 sysctl -w net.mpls.conf.x-p1.input=1
+
+#
+# network layout:
+#  x-p0(n0) <--ipv4--> p0 <grout> p1 <--mpls--> x-p1(n1) (10.98.0.2 on lo)
+#
+# grout pushes label 100 towards n1 which pops it and delivers locally.
+# n1 replies with label 200 which grout pops before routing to n0.
+#
+
+grcli nexthop add mpls labels 100 via 172.16.1.2 iface p1 id 100
+grcli route add 10.98.0.0/24 via id 100
+grcli mpls route add 200 pop
+
+ip -n n1 -f mpls route add 100 dev lo
+ip -n n1 route add 10.99.0.0/24 encap mpls 200 via 172.16.1.1 dev x-p1
+
+grcli nexthop show
+grcli mpls route show
+
+ip netns exec n0 ping -i0.01 -c3 -n 10.98.0.2
@@ -0,0 +1,55 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+port_add p2
+grcli address add 172.16.0.1/24 iface p0
+grcli address add 172.16.1.1/24 iface p1
+grcli address add 172.16.2.1/24 iface p2
+
+for n in 0 1 2; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+	ip -n $ns addr add 172.16.$n.2/24 dev $p
+	ip -n $ns route add default via 172.16.$n.1
+done
+ip -n n0 route add 239.0.0.0/8 dev x-p0
+
+grcli mroute add 239.1.1.1 source 172.16.0.2 iif p0 oif p1 p2
+grcli mroute add 239.2.2.2 iif p0 oif p1
+
+rx_packets() {
+	ip netns exec $1 cat /sys/class/net/$2/statistics/rx_packets
+}
+
+rx1=$(rx_packets n1 x-p1)
+rx2=$(rx_packets n2 x-p2)
+
+# (S,G) entry replicated to both receivers
+ip netns exec n0 ping -i0.01 -c3 -t8 -w1 -n 239.1.1.1 || true
+# (*,G) entry
+ip netns exec n0 ping -i0.01 -c3 -t8 -w1 -n 239.2.2.2 || true
+
+grcli mroute show
+grcli mroute show | grep -E "172\.16\.0\.2\s+239\.1\.1\.1\s+p0\s+p1 p2\s+3\s"
+grcli mroute show | grep -E "\*\s+239\.2\.2\.2\s+p0\s+p1\s+3\s"
+
+[ $(($(rx_packets n1 x-p1) - rx1)) -ge 6 ]
+[ $(($(rx_packets n2 x-p2) - rx2)) -ge 3 ]
+
+# packets received on the wrong interface are dropped
+grcli mroute add 239.3.3.3 iif p1 oif p2
+ip netns exec n0 ping -i0.01 -c3 -t8 -w1 -n 239.3.3.3 || true
+grcli mroute show | grep -E "\*\s+239\.3\.3\.3\s+p1\s+p2\s+0\s"
+
+grcli mroute del 239.1.1.1 source 172.16.0.2
+grcli mroute del 239.2.2.2
+grcli mroute del 239.3.3.3
+[ -z "$(grcli mroute show | tail -n +2)" ]
@@ -0,0 +1,52 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+port_add p2 vrf 1
+grcli address add 172.16.0.1/24 iface p0
+grcli address add 172.16.1.1/24 iface p1
+grcli address add 172.16.2.1/24 iface p2
+
+# return traffic from vrf 1 is routed in the default vrf
+grcli nexthop add l3 iface gr-loop0 id 1
+grcli route add 172.16.0.0/24 via id 1 vrf 1
+grcli route add 16.2.0.0/16 via 172.16.2.2 vrf 1
+grcli nexthop add l3 iface p1 id 2 address 172.16.1.2
+
+for n in 0 1 2; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+	ip -n $ns addr add 172.16.$n.2/24 dev $p
+	ip -n $ns addr add 16.$n.0.1/16 dev lo
+	ip -n $ns route add default via 172.16.$n.1
+done
+
+# no route to 16.1.0.0/16 nor 16.2.0.0/16 in the default vrf
+! ip netns exec n0 ping -i0.01 -c3 -W1 -I 16.0.0.1 -n 16.1.0.1 || fail "ping should fail"
+! ip netns exec n0 ping -i0.01 -c3 -W1 -I 16.0.0.1 -n 16.2.0.1 || fail "ping should fail"
+
+grcli pbr add iface p0 seq 10 nexthop 2 src 16.0.0.0/16 dst 16.1.0.0/16
+grcli pbr add iface p0 seq 20 vrf 1 proto icmp src 16.0.0.0/16
+grcli interface show name p0 | grep -w pbr
+grcli pbr show
+
+ip netns exec n0 ping -i0.01 -c3 -I 16.0.0.1 -n 16.1.0.1
+ip netns exec n0 ping -i0.01 -c3 -I 16.0.0.1 -n 16.2.0.1
+# packets not matching any rule are routed normally
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
+
+grcli pbr show iface p0 | grep -E "^p0\s+10\s+nexthop\s+2\s.*\s3$"
+grcli pbr show iface p0 | grep -E "^p0\s+20\s+vrf\s+1\s+1\s.*\s3$"
+
+grcli pbr del iface p0 seq 10
+! ip netns exec n0 ping -i0.01 -c3 -W1 -I 16.0.0.1 -n 16.1.0.1 || fail "ping should fail"
+grcli pbr flush iface p0
+! grcli interface show name p0 | grep -w pbr || fail "pbr flag should be cleared"
+! ip netns exec n0 ping -i0.01 -c3 -W1 -I 16.0.0.1 -n 16.2.0.1 || fail "ping should fail"
@@ -0,0 +1,53 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+grcli interface add vlan p0.100.42 parent p0 vlan_id 42 outer_vlan_id 100
+grcli interface add vlan p1.200.43 parent p1 vlan_id 43 outer_vlan_id 200
+# single tagged sub-interface sharing the outer VLAN ID
+grcli interface add vlan p0.100 parent p0 vlan_id 100
+grcli address add 172.16.0.1/24 iface p0.100.42
+grcli address add 172.16.1.1/24 iface p1.200.43
+grcli address add 172.16.2.1/24 iface p0.100
+grcli interface show name p0.100.42 | grep -E "^outer_vlan_id: 100$"
+
+for n in 0 1; do
+	p=x-p$n
+	ns=n$n
+	s=$p.$((n+1))00
+	c=$s.$((n+42))
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link add $s link $p type vlan proto 802.1ad id $((n+1))00
+	ip -n $ns link add $c link $s type vlan id $((n+42))
+	ip -n $ns link set $p up
+	ip -n $ns link set $s up
+	ip -n $ns link set $c up
+	ip -n $ns addr add 172.16.$n.2/24 dev $c
+	ip -n $ns route add default via 172.16.$n.1
+done
+
+ip -n n0 link add x-p0.100q link x-p0 type vlan id 100
+ip -n n0 link set x-p0.100q up
+ip -n n0 addr add 172.16.2.2/24 dev x-p0.100q
+
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
+ip netns exec n1 ping -i0.01 -c3 -n 172.16.0.2
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.2.1
+
+# move the inner tag, the old one must not match anymore
+grcli interface set vlan p1.200.43 vlan_id 44
+! ip netns exec n0 ping -i0.01 -c3 -W1 -n 172.16.1.2 || fail "ping should fail"
+ip -n n1 link add x-p1.200.44 link x-p1.200 type vlan id 44
+ip -n n1 link set x-p1.200.44 up
+ip -n n1 addr del 172.16.1.2/24 dev x-p1.200.43
+ip -n n1 addr add 172.16.1.2/24 dev x-p1.200.44
+ip -n n1 route add default via 172.16.1.1
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
+
+grcli interface del p0.100.42
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.2.1
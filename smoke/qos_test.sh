@@ -0,0 +1,49 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+grcli address add 172.16.0.1/24 iface p0
+grcli address add 172.16.1.1/24 iface p1
+
+for n in 0 1; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+	ip -n $ns addr add 172.16.$n.2/24 dev $p
+	ip -n $ns route add default via 172.16.$n.1
+done
+
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
+
+# 8kbit/s with a single packet burst, most of the flood must be dropped
+grcli qos policer set iface p0 mode srtcm cir 8000 cbs 1500 yellow 10 red drop
+grcli interface show name p0 | grep -w police
+ip netns exec n0 ping -i0.01 -c50 -s1000 -n 172.16.1.2 || true
+grcli qos policer show iface p0
+grcli qos policer show iface p0 | grep -E "\sred\s+drop\s+[1-9][0-9]*\s"
+grcli qos policer del iface p0
+! grcli interface show name p0 | grep -w police || fail "policer flag should be cleared"
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
+
+grcli qos scheduler set iface p1 rate 100000000 subscribers 16 qsize 64
+grcli interface show name p1 | grep -w sched
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
+ip netns exec n0 ping -i0.01 -c3 -Q 0xb8 -n 172.16.1.2
+grcli qos scheduler show iface p1
+grcli qos scheduler show iface p1 | grep -E "^\s*5\s+[1-9][0-9]*\s"
+grcli qos scheduler show iface p1 | grep -E "^\s*0\s+[1-9][0-9]*\s"
+
+grcli interface add vlan p1.42 parent p1 vlan_id 42
+grcli qos subscriber set iface p1.42 rate 1000000
+grcli qos subscriber show | grep -E "^p1\.42\s+1000000\s+yes\s"
+grcli qos subscriber del iface p1.42
+
+grcli qos scheduler del iface p1
+! grcli interface show name p1 | grep -w sched || fail "scheduler flag should be cleared"
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
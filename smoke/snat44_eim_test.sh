@@ -0,0 +1,89 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+grcli address add 172.16.0.1/24 iface p0
+grcli address add 10.99.0.1/24 iface p1
+grcli snat44 add interface p0 subnet 10.99.0.0/24 replace 172.16.0.1 endpoint-independent
+grcli snat44 show
+
+for n in 0 1; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+done
+
+ip -n n0 addr add 172.16.0.2/24 dev x-p0
+ip -n n1 addr add 10.99.0.99/24 dev x-p1
+ip -n n1 addr add 10.99.0.98/24 dev x-p1
+ip -n n1 route add default via 10.99.0.1
+
+ip netns exec n1 ping -i0.01 -c3 -n 172.16.0.2
+
+# Remote server listening on 10 ports. Report the external endpoints seen for
+# the internal client and reach it back from an unrelated remote port.
+ip netns exec n0 python3 - > $tmp/server <<PYEOF &
+import select, socket
+socks = []
+for port in range(6001, 6011):
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.bind(("172.16.0.2", port))
+    socks.append(s)
+peers = set()
+while len(peers) < 10:
+    r, _, _ = select.select(socks, [], [], 5)
+    if not r:
+        break
+    for s in r:
+        _, peer = s.recvfrom(64)
+        peers.add((s.getsockname()[1], peer))
+ports = {p for _, p in peers}
+print("mappings", len(ports), flush=True)
+addr, port = ports.pop()
+print("mapped", addr, port, flush=True)
+s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+s.bind(("172.16.0.2", 7000))
+s.sendto(b"eif", (addr, port))
+PYEOF
+server=$!
+sleep 0.5
+
+ip netns exec n1 python3 - > $tmp/client <<PYEOF &
+import socket
+s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+s.bind(("10.99.0.99", 5000))
+s.settimeout(5)
+for port in range(6001, 6011):
+    s.sendto(b"hello", ("172.16.0.2", port))
+for _ in range(2):
+    data, peer = s.recvfrom(64)
+    print(data.decode(), *peer, flush=True)
+PYEOF
+client=$!
+
+wait $server
+cat $tmp/server
+grep -qx "mappings 1" $tmp/server || fail "external port is not reused across destinations"
+read -r _ mapped_addr mapped_port < <(grep ^mapped $tmp/server)
+[ "$mapped_addr" = 172.16.0.1 ] || fail "unexpected external address $mapped_addr"
+
+# Another internal host reaches the client through its external endpoint.
+ip netns exec n1 python3 - <<PYEOF
+import socket
+s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+s.bind(("10.99.0.98", 5001))
+s.sendto(b"hairpin", ("$mapped_addr", $mapped_port))
+PYEOF
+
+wait $client
+cat $tmp/client
+grep -qx "eif 172.16.0.2 7000" $tmp/client || fail "inbound from another remote endpoint dropped"
+grep -q "^hairpin 172.16.0.1 " $tmp/client || fail "hairpinned packet not received"
+
+grcli conntrack show
@@ -0,0 +1,68 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+grcli address add 172.16.0.1/24 iface p0
+grcli address add 10.99.0.1/24 iface p1
+grcli snat44 add interface p0 subnet 10.99.0.0/24 replace 172.16.0.1
+grcli snat44 log set enable path $tmp/snat44.log max-file-size 4096 max-files 4
+grcli snat44 log show
+
+for n in 0 1; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+done
+
+ip -n n0 addr add 172.16.0.2/24 dev x-p0
+ip -n n1 addr add 10.99.0.99/24 dev x-p1
+ip -n n1 route add default via 10.99.0.1
+
+ip netns exec n1 ping -i0.01 -c3 -n 172.16.0.2
+
+# 200 UDP sessions, each one creates a binding.
+ip netns exec n1 python3 - <<PYEOF
+import socket
+for port in range(20000, 20200):
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.bind(("10.99.0.99", port))
+    s.sendto(b"x", ("172.16.0.2", 9))
+    s.close()
+PYEOF
+
+sleep 0.5
+grcli conntrack flush
+# Disabling logging writes all queued records.
+grcli snat44 log set disable
+grcli snat44 log show
+
+python3 - $tmp/snat44.log* > $tmp/records <<PYEOF
+import ipaddress, socket, struct, sys
+HDR = struct.Struct("=IHH")
+REC = struct.Struct("=Q4s4sHHHBB")
+for path in sys.argv[1:]:
+    with open(path, "rb") as f:
+        magic, version, size = HDR.unpack(f.read(HDR.size))
+        assert magic == $((0x4c54414e)), hex(magic)
+        assert version == 1 and size == REC.size, (version, size)
+        while chunk := f.read(REC.size):
+            ts, ia, oa, ip, op, vrf, proto, event = REC.unpack(chunk)
+            print("bind" if event == 1 else "unbind", proto, vrf,
+                  ipaddress.ip_address(ia), socket.ntohs(ip),
+                  ipaddress.ip_address(oa), socket.ntohs(op))
+PYEOF
+
+ls -l $tmp/snat44.log*
+[ -f $tmp/snat44.log.1 ] || fail "log file was not rotated"
+binds=$(grep -c "^bind 17 0 10.99.0.99 [0-9]* 172.16.0.1 " $tmp/records) || true
+unbinds=$(grep -c "^unbind 17 0 10.99.0.99 [0-9]* 172.16.0.1 " $tmp/records) || true
+[ "$binds" -eq 200 ] || fail "expected 200 UDP bind records, got $binds"
+[ "$unbinds" -eq 200 ] || fail "expected 200 UDP unbind records, got $unbinds"
+grep -q "^bind 1 0 10.99.0.99 " $tmp/records || fail "missing ICMP bind record"
+grcli snat44 log show | grep -qx "lost 0" || fail "records were lost"
@@ -0,0 +1,67 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+grcli address add 192.168.61.1/24 iface p0
+grcli address add fd00:102::1/64 iface p1
+
+for n in 0 1; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+done
+ip -n n0 addr add 192.168.61.2/24 dev x-p0
+ip -n n1 addr add fd00:102::2/64 dev x-p1
+
+sleep 3
+
+#
+# network layout:
+#  (client) x-p0(netns) <--> p0 <grout> p1 <---> x-p1(netns) (public: 192.168.70.1/24)
+#       ipv4 ---------------|     srv6 usid      |-- ipv4
+#
+# micro-SIDs (F3216 format, block fcbb:bb00::/32):
+#   - x-p1: 0001 (uN, next-csid) and 0002 (uDX4)
+#   - grout: 0100 (uN, next-csid) and 0200 (uDT4)
+#
+# test case:
+#   - grout packs both x-p1 micro-SIDs in a single DA (fcbb:bb00:1:2::), no SRH
+#   - linux x-p1 shifts the DA to fcbb:bb00:2::, then decaps it
+#   - linux x-p1 replies with DA fcbb:bb00:100:200::
+#   - grout shifts the DA to fcbb:bb00:200::, then decaps it
+#
+
+ip netns exec n1 sysctl -w net.ipv6.conf.all.seg6_enabled=1
+ip netns exec n1 sysctl -w net.ipv6.conf.x-p1.seg6_enabled=1
+ip netns exec n1 sysctl -w net.ipv6.conf.all.forwarding=1
+
+ip -n n0 route add default via 192.168.61.1 dev x-p0
+ip -n n1 addr add 192.168.70.1/24 dev x-p1
+
+# headend
+grcli nexthop add srv6 seglist fcbb:bb00:1:: fcbb:bb00:2:: \
+	encap h.encaps.red csid 32 16 id 42
+grcli nexthop show | grep -F 'fcbb:bb00:1:2::'
+grcli route add 192.168.70.0/24 via id 42
+grcli route add fcbb:bb00::/32 via fd00:102::2
+
+ip -n n1 -6 route add fcbb:bb00:1::/48 encap seg6local action End \
+	flavors next-csid lblen 32 nflen 16 dev x-p1
+ip -n n1 -6 route add fcbb:bb00:2::/48 encap seg6local action End.DX4 nh4 192.168.70.1 dev x-p1
+
+# return path
+ip -n n1 route add 192.168.61.0/24 encap seg6 mode encap segs fcbb:bb00:100:200:: dev x-p1
+ip -n n1 -6 route add fcbb:bb00:100::/48 via fd00:102::1 dev x-p1
+ip -n n1 -6 route add fcbb:bb00:200::/48 via fd00:102::1 dev x-p1
+grcli nexthop add srv6-local behavior end flavor next-csid id 666
+grcli nexthop add srv6-local behavior end.dt4 id 667
+grcli route add fcbb:bb00:100::/48 via id 666
+grcli route add fcbb:bb00:200::/48 via id 667
+
+ip netns exec n0 ping -i0.01 -c3 -n 192.168.70.1
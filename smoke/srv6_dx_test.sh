@@ -0,0 +1,106 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+port_add p2
+port_add p3
+grcli address add 192.168.61.1/24 iface p0
+grcli address add fd00:101::1/64 iface p0
+grcli address add fd00:102::1/64 iface p1
+
+for n in 0 1 2 3; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+done
+ip -n n0 addr add 192.168.61.2/24 dev x-p0
+ip -n n0 addr add fd00:101::2/64 dev x-p0
+ip -n n1 addr add fd00:102::2/64 dev x-p1
+ip -n n2 addr add 10.0.0.1/24 dev x-p2
+ip -n n3 addr add 10.0.0.2/24 dev x-p3
+
+sleep 3
+
+#
+# network layout:
+#  (client) x-p0(netns) <--> p0 <grout> p1 <---> x-p1(netns) (srv6 peer)
+#                            p2 <grout> p3
+#                            |          |
+#  (l2 site a) x-p2(netns) --'          '-- x-p3(netns) (l2 site b)
+#
+# test cases:
+#   - end.dx4: x-p1 encaps ipv4 to fd00:202::104, grout decaps to the p0 adjacency
+#   - end.dx6: x-p1 encaps ipv6 to fd00:202::106, grout decaps to the p0 adjacency
+#   - end.x: x-p1 sends an srh to fd00:202::10, grout forwards to the p0 adjacency
+#   - h.encaps.l2/end.dx2: frames received on p2/p3 are encapsulated to x-p1 which
+#     bounces them back to the end.dx2 sid of the other port.
+#
+
+ip netns exec n0 sysctl -w net.ipv6.conf.all.seg6_enabled=1
+ip netns exec n0 sysctl -w net.ipv6.conf.x-p0.seg6_enabled=1
+ip netns exec n1 sysctl -w net.ipv6.conf.all.seg6_enabled=1
+ip netns exec n1 sysctl -w net.ipv6.conf.x-p1.seg6_enabled=1
+ip netns exec n1 sysctl -w net.ipv6.conf.all.forwarding=1
+
+ip -n n0 route add default via 192.168.61.1 dev x-p0
+ip -n n0 -6 route add default via fd00:101::1 dev x-p0
+ip -n n1 -6 route add fd00:202::/64 via fd00:102::1 dev x-p1
+ip -n n1 addr add 192.168.60.1/24 dev x-p1
+ip -n n1 addr add fd00:160::1/64 dev x-p1
+
+# adjacencies towards x-p0
+grcli nexthop add l3 iface p0 id 44 address 192.168.61.2
+grcli nexthop add l3 iface p0 id 66 address fd00:101::2
+
+# end.dx4
+grcli nexthop add srv6 seglist fd00:202::2 id 42
+grcli route add 192.168.60.0/24 via id 42
+grcli route add fd00:202::/64 via fd00:102::2
+ip -n n1 -6 route add fd00:202::2 encap seg6local action End.DX4 nh4 192.168.60.1 dev x-p1
+ip -n n1 route add 192.168.61.0/24 encap seg6 mode encap segs fd00:202::104 dev x-p1
+grcli nexthop add srv6-local behavior end.dx4 via 44 id 604
+grcli route add fd00:202::104/128 via id 604
+
+ip netns exec n0 ping -i0.01 -c3 -n 192.168.60.1
+
+# end.dx6
+grcli nexthop add srv6 seglist fd00:202::6 id 46
+grcli route add fd00:160::/64 via id 46
+ip -n n1 -6 route add fd00:202::6 encap seg6local action End.DT6 table 254 dev x-p1
+ip -n n1 -6 route add fd00:101::/64 encap seg6 mode encap segs fd00:202::106 dev x-p1
+grcli nexthop add srv6-local behavior end.dx6 via 66 id 606
+grcli route add fd00:202::106/128 via id 606
+
+ip netns exec n0 ping6 -i0.01 -c3 -n fd00:160::1
+
+# end.x
+ip -n n0 -6 route add fd00:101::100 encap seg6local action End.DT6 table 254 dev x-p0
+ip -n n1 -6 route add fd00:101::2/128 encap seg6 mode encap \
+	segs fd00:202::10,fd00:101::100 dev x-p1
+grcli nexthop add srv6-local behavior end.x via 66 id 610
+grcli route add fd00:202::10/128 via id 610
+
+ip netns exec n1 ping6 -i0.01 -c3 -n fd00:101::2
+
+# h.encaps.l2 and end.dx2
+ip -n n1 -6 route add fd00:202::2e encap seg6local action End dev x-p1
+grcli nexthop add srv6 seglist fd00:202::2e fd00:202::23 encap h.encaps.l2 id 72
+grcli nexthop add srv6 seglist fd00:202::2e fd00:202::22 encap h.encaps.l2 id 73
+grcli nexthop add srv6-local behavior end.dx2 oif p3 id 622
+grcli nexthop add srv6-local behavior end.dx2 oif p2 id 623
+grcli route add fd00:202::22/128 via id 622
+grcli route add fd00:202::23/128 via id 623
+grcli l2encap set p2 via 73
+grcli l2encap set p3 via 72
+
+ip netns exec n2 ping -i0.01 -c3 -n 10.0.0.2
+
+grcli nexthop show
+grcli l2encap del p2
+grcli l2encap del p3
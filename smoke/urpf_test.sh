@@ -0,0 +1,65 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+port_add p0
+port_add p1
+grcli address add 172.16.0.1/24 iface p0
+grcli address add 172.16.1.1/24 iface p1
+grcli address add 2001:db8:0::1/64 iface p0
+grcli address add 2001:db8:1::1/64 iface p1
+grcli route add 16.0.0.0/16 via 172.16.0.2
+grcli route add 16.1.0.0/16 via 172.16.1.2
+grcli route add 2001:db8:10::/64 via 2001:db8:0::2
+grcli route add 2001:db8:11::/64 via 2001:db8:1::2
+
+for n in 0 1; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+	ip -n $ns addr add 172.16.$n.2/24 dev $p
+	ip -n $ns addr add 2001:db8:$n::2/64 dev $p
+	ip -n $ns route add default via 172.16.$n.1
+	ip -n $ns -6 route add default via 2001:db8:$n::1
+done
+# legitimate source addresses
+ip -n n0 addr add 16.0.0.1/32 dev lo
+ip -n n0 addr add 2001:db8:10::1/128 dev lo
+# reachable via p1 on the router
+ip -n n0 addr add 16.1.0.1/32 dev lo
+ip -n n0 addr add 2001:db8:11::1/128 dev lo
+# no route on the router
+ip -n n0 addr add 10.99.0.1/32 dev lo
+sleep 3 # wait for DAD
+
+grcli interface set port p0 urpf strict
+grcli interface show name p0 | grep -w urpf-strict
+
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.1.2
+ip netns exec n0 ping -i0.01 -c3 -n -I 16.0.0.1 172.16.1.2
+ip netns exec n0 ping6 -i0.01 -c3 -n 2001:db8:1::2
+ip netns exec n0 ping6 -i0.01 -c3 -n -I 2001:db8:10::1 2001:db8:1::2
+! ip netns exec n0 ping -i0.01 -c3 -W1 -n -I 16.1.0.1 172.16.1.2 || fail "strict uRPF"
+! ip netns exec n0 ping6 -i0.01 -c3 -W1 -n -I 2001:db8:11::1 2001:db8:1::2 || fail "strict uRPF"
+! ip netns exec n0 ping -i0.01 -c3 -W1 -n -I 10.99.0.1 172.16.1.2 || fail "strict uRPF"
+grcli stats show software | grep -w ip_input_urpf_fail
+grcli stats show software | grep -w ip6_input_urpf_fail
+
+grcli stats reset
+grcli interface set port p0 urpf loose
+grcli interface show name p0 | grep -w urpf-loose
+
+ip netns exec n0 ping -i0.01 -c3 -n -I 16.0.0.1 172.16.1.2
+ip netns exec n0 ping6 -i0.01 -c3 -n -I 2001:db8:10::1 2001:db8:1::2
+! ip netns exec n0 ping -i0.01 -c3 -W1 -n -I 10.99.0.1 172.16.1.2 || fail "loose uRPF"
+grcli stats show software | grep -w ip_input_urpf_fail
+
+grcli stats reset
+grcli interface set port p0 urpf off
+grcli interface show name p0 | grep -w urpf && fail "uRPF should be disabled"
+ip netns exec n0 ping -i0.01 -c3 -n -I 16.0.0.1 172.16.1.2
+! grcli stats show software | grep -w ip_input_urpf_fail || fail "uRPF should be disabled"
@@ -0,0 +1,39 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright (c) 2025 Robin Jarry
+
+. $(dirname $0)/_init.sh
+
+# network layout:
+#  x-p0(netns n0) <--> p0 <grout vrf 0> v0 <==vhost-user==> vu0 <grout vrf 1> p1 <--> x-p1(netns n1)
+#
+# v0 is a native vhost-user interface with DMA offloaded copies.
+# vu0 is a virtio-user port connected to the same socket, it plays the role of a guest.
+
+port_add p0
+grcli interface add vhost v0 path $tmp/v0.sock dma dma_skeleton0
+grcli interface show name v0 | grep -F "dma: dma_skeleton0"
+grcli interface add port vu0 devargs net_virtio_user0,path=$tmp/v0.sock,queues=1 vrf 1
+port_add p1 vrf 1
+
+grcli address add 172.16.0.1/24 iface p0
+grcli address add 172.16.1.1/24 iface v0
+grcli address add 172.16.1.2/24 iface vu0
+grcli address add 172.16.2.1/24 iface p1
+grcli route add 172.16.2.0/24 via 172.16.1.2
+grcli route add 172.16.0.0/24 via 172.16.1.1 vrf 1
+
+for n in 0 1; do
+	p=x-p$n
+	ns=n$n
+	netns_add $ns
+	ip link set $p netns $ns
+	ip -n $ns link set $p up
+	ip -n $ns addr add 172.16.$((n * 2)).2/24 dev $p
+	ip -n $ns route add default via 172.16.$((n * 2)).1
+done
+
+ip netns exec n0 ping -i0.01 -c3 -n 172.16.2.2
+ip netns exec n1 ping -i0.01 -c3 -n 172.16.0.2
+
+grcli interface show name v0 | grep -w running
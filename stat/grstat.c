@@ -0,0 +1,278 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 Robin Jarry
+
+// Read-only statistics viewer attached as a DPDK secondary process to a grout
+// instance started with --file-prefix. It reads the memory zones described in
+// gr_shm.h directly and never talks to the API socket.
+
+#include <gr_iface.h>
+#include <gr_shm.h>
+#include <gr_worker.h>
+
+#include <rte_eal.h>
+#include <rte_errno.h>
+#include <rte_memzone.h>
+#include <rte_seqlock.h>
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void usage(void) {
+	puts("Usage: grstat [-h] [-i SECONDS] -p PREFIX [ifaces|graph]...");
+	puts("");
+	puts("  Read grout statistics from shared memory.");
+	puts("");
+	puts("options:");
+	puts("  -h, --help                     Display this help message and exit.");
+	puts("  -i, --interval SECONDS         Print statistics every SECONDS.");
+	puts("  -p, --file-prefix PREFIX       File prefix passed to grout --file-prefix.");
+}
+
+static const struct gr_shm *shm;
+static const struct iface_stats (*iface_stats)[RTE_MAX_LCORE];
+
+static int shm_attach(const char *prefix) {
+	const struct rte_memzone *mz;
+	char *eal_args[] = {
+		"grstat",
+		"--proc-type=secondary",
+		"--file-prefix",
+		(char *)prefix,
+		"--no-pci",
+		"--no-telemetry",
+		"--log-level=*:error",
+	};
+
+	if (rte_eal_init(RTE_DIM(eal_args), eal_args) < 0) {
+		fprintf(stderr, "error: rte_eal_init: %s\n", rte_strerror(rte_errno));
+		fprintf(stderr, "error: is grout running with --file-prefix %s?\n", prefix);
+		return -1;
+	}
+
+	if ((mz = rte_memzone_lookup(GR_SHM_MZ_NAME)) == NULL) {
+		fprintf(stderr, "error: %s: %s\n", GR_SHM_MZ_NAME, rte_strerror(rte_errno));
+		return -1;
+	}
+	shm = mz->addr;
+	if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != GR_SHM_MAGIC) {
+		fprintf(stderr, "error: %s: not initialized\n", GR_SHM_MZ_NAME);
+		return -1;
+	}
+	if (shm->version != GR_SHM_VERSION || shm->max_ifaces != MAX_IFACES
+	    || shm->max_lcores != RTE_MAX_LCORE || shm->max_nodes != GR_SHM_MAX_NODES) {
+		fprintf(stderr, "error: %s: incompatible layout\n", GR_SHM_MZ_NAME);
+		return -1;
+	}
+
+	if ((mz = rte_memzone_lookup(GR_SHM_IFACE_STATS_MZ_NAME)) == NULL) {
+		fprintf(stderr,
+			"error: %s: %s\n",
+			GR_SHM_IFACE_STATS_MZ_NAME,
+			rte_strerror(rte_errno));
+		return -1;
+	}
+	iface_stats = mz->addr;
+
+	return 0;
+}
+
+static void ifaces_print(void) {
+	static struct gr_shm_iface ifaces[MAX_IFACES];
+	unsigned sn;
+
+	do {
+		sn = rte_seqlock_read_begin(&shm->lock);
+		memcpy(ifaces, shm->ifaces, sizeof(ifaces));
+	} while (rte_seqlock_read_retry(&shm->lock, sn));
+
+	printf("%-20s %16s %16s %16s %16s\n",
+	       "IFACE",
+	       "RX_PACKETS",
+	       "RX_BYTES",
+	       "TX_PACKETS",
+	       "TX_BYTES");
+
+	for (uint16_t ifid = 0; ifid < MAX_IFACES; ifid++) {
+		const struct gr_shm_iface *iface = &ifaces[ifid];
+		struct iface_stats sum = {0};
+
+		if (iface->id == GR_IFACE_ID_UNDEF)
+			continue;
+
+		for (unsigned i = 0; i < RTE_MAX_LCORE; i++) {
+			const struct iface_stats *s = &iface_stats[ifid][i];
+			sum.rx_packets += s->rx_packets;
+			sum.rx_bytes += s->rx_bytes;
+			sum.tx_packets += s->tx_packets;
+			sum.tx_bytes += s->tx_bytes;
+		}
+
+		printf("%-20s %16lu %16lu %16lu %16lu\n",
+		       iface->name,
+		       sum.rx_packets,
+		       sum.rx_bytes,
+		       sum.tx_packets,
+		       sum.tx_bytes);
+	}
+}
+
+struct node_sum {
+	uint64_t packets;
+	uint64_t batches;
+	uint64_t cycles;
+};
+
+// Copy the stats of a worker. The datapath may replace them at any time when
+// its graph is reloaded. Discard the copy if this happened while reading.
+static int worker_stats_add(const struct worker *w, struct node_sum *sums) {
+	const struct worker_stats *stats;
+	struct node_stats s;
+	size_t n_stats;
+
+	stats = atomic_load(&w->stats);
+	if (stats == NULL)
+		return 0;
+
+	n_stats = RTE_MIN(stats->n_stats, (size_t)GR_SHM_MAX_NODES);
+	for (size_t i = 0; i < n_stats; i++) {
+		s = stats->stats[i];
+		if (s.node_id >= GR_SHM_MAX_NODES)
+			continue;
+		sums[s.node_id].packets += s.packets;
+		sums[s.node_id].batches += s.batches;
+		sums[s.node_id].cycles += s.cycles;
+	}
+
+	return atomic_load(&w->stats) == stats ? 0 : -EAGAIN;
+}
+
+static void graph_print(void) {
+	static struct node_sum sums[GR_SHM_MAX_NODES];
+	static struct node_sum worker_sums[GR_SHM_MAX_NODES];
+	const struct worker *w;
+	unsigned sn;
+
+	memset(sums, 0, sizeof(sums));
+
+	for (unsigned i = 0; i < RTE_MAX_LCORE; i++) {
+		if ((w = atomic_load(&shm->workers[i])) == NULL)
+			continue;
+		for (int retry = 0; retry < 3; retry++) {
+			memset(worker_sums, 0, sizeof(worker_sums));
+			if (worker_stats_add(w, worker_sums) == 0)
+				break;
+		}
+		for (unsigned n = 0; n < GR_SHM_MAX_NODES; n++) {
+			sums[n].packets += worker_sums[n].packets;
+			sums[n].batches += worker_sums[n].batches;
+			sums[n].cycles += worker_sums[n].cycles;
+		}
+	}
+
+	printf("%-32s %16s %16s %10s %10s\n",
+	       "NODE",
+	       "CALLS",
+	       "PACKETS",
+	       "PKTS/CALL",
+	       "CYCLES/PKT");
+
+	for (unsigned n = 0; n < shm->n_nodes; n++) {
+		char name[RTE_NODE_NAMESIZE];
+		const struct node_sum *s = &sums[n];
+
+		if (s->batches == 0)
+			continue;
+
+		do {
+			sn = rte_seqlock_read_begin(&shm->lock);
+			memcpy(name, shm->node_names[n], sizeof(name));
+		} while (rte_seqlock_read_retry(&shm->lock, sn));
+		name[sizeof(name) - 1] = '\0';
+
+		printf("%-32s %16lu %16lu %10.1f %10.1f\n",
+		       name,
+		       s->batches,
+		       s->packets,
+		       (double)s->packets / (double)s->batches,
+		       s->packets ? (double)s->cycles / (double)s->packets : 0.0);
+	}
+}
+
+int main(int argc, char **argv) {
+	bool ifaces = false, graph = false;
+	const char *prefix = NULL;
+	unsigned interval = 0;
+	char *end;
+	int c;
+
+	static struct option long_options[] = {
+		{"file-prefix", required_argument, NULL, 'p'},
+		{"help", no_argument, NULL, 'h'},
+		{"interval", required_argument, NULL, 'i'},
+		{0},
+	};
+
+	while ((c = getopt_long(argc, argv, "hi:p:", long_options, NULL)) != -1) {
+		switch (c) {
+		case 'h':
+			usage();
+			return EXIT_SUCCESS;
+		case 'i':
+			errno = 0;
+			interval = strtoul(optarg, &end, 10);
+			if (errno != 0 || *end != '\0' || interval == 0) {
+				fprintf(stderr, "error: --interval: invalid value\n");
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'p':
+			prefix = optarg;
+			break;
+		default:
+			usage();
+			return EXIT_FAILURE;
+		}
+	}
+	if (prefix == NULL) {
+		fprintf(stderr, "error: --file-prefix is required\n");
+		return EXIT_FAILURE;
+	}
+	for (int i = optind; i < argc; i++) {
+		if (strcmp(argv[i], "ifaces") == 0) {
+			ifaces = true;
+		} else if (strcmp(argv[i], "graph") == 0) {
+			graph = true;
+		} else {
+			fprintf(stderr, "error: %s: unknown statistics\n", argv[i]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (!ifaces && !graph)
+		ifaces = graph = true;
+
+	if (shm_attach(prefix) < 0)
+		return EXIT_FAILURE;
+
+	for (;;) {
+		if (ifaces)
+			ifaces_print();
+		if (ifaces && graph)
+			puts("");
+		if (graph)
+			graph_print();
+		if (interval == 0)
+			break;
+		fflush(stdout);
+		sleep(interval);
+		puts("");
+	}
+
+	rte_eal_cleanup();
+
+	return EXIT_SUCCESS;
+}